@@ -173,11 +173,6 @@ int main(int argc, char *argv[]) {
 
   string errMsg;
 
-  //    srand(time(0));
-  // For the random number generator
-  std::random_device rd;
-  std::mt19937 randomGen(rd());
-
   //***********************************************************************************
   //****READ INPUT DATA
   //***************************************************************
@@ -200,112 +195,42 @@ int main(int argc, char *argv[]) {
   auto begin = std::chrono::high_resolution_clock::now();
 
   if (whetherToAddData) {
+
+    // the pages are built and sent by many threads, blocksize is the size of a page
+    PDBBulkLoadOptions options;
+    options.pageSize = (size_t) blocksize * 1024 * 1024;
+
     if (randomData) {
 
-      int addedData = 0;
-      while (addedData < numData) {
-
-        pdb::makeObjectAllocatorBlock(blocksize * 1024 * 1024, true);
-
-        pdb::Handle<pdb::Vector<pdb::Handle<DoubleVector>>> storeMe =
-            pdb::makeObject<pdb::Vector<pdb::Handle<DoubleVector>>>();
-        try {
-          double bias = 0;
-          for (int i = addedData; i < numData; i++) {
-            pdb::Handle<DoubleVector> myData =
-                pdb::makeObject<DoubleVector>(dim);
-            for (int j = 0; j < dim; j++) {
-
-              std::uniform_real_distribution<> unif(0, 1);
-              bias = unif(randomGen) * 0.01;
-              myData->setDouble(j, i % k * 3 + bias);
-            }
-            storeMe->push_back(myData);
-            addedData += 1;
-          }
-
-          std::cout << "Added " << storeMe->size() << " Total: " << addedData
-               << std::endl;
-
-          pdbClient.sendData<DoubleVector>("gmm_input_set", "gmm_db", storeMe);
-        } catch (pdb::NotEnoughSpace &n) {
-          std::cout << "Added " << storeMe->size() << " Total: " << addedData
-               << std::endl;
-          pdbClient.sendData<DoubleVector>("gmm_input_set","gmm_db", storeMe);
-        }
-        std::cout << blocksize << "MB data sent to dispatcher server~~" << std::endl;
+      // each data point gets its own generator so that the points can be made in parallel
+      pdbClient.bulkLoad<DoubleVector>("gmm_db", "gmm_input_set", numData, [&](size_t i) {
 
-      } // End while
+        std::default_random_engine pointGen(i);
+        std::uniform_real_distribution<> unif(0, 1);
+
+        pdb::Handle<DoubleVector> myData = pdb::makeObject<DoubleVector>(dim);
+        for (int j = 0; j < dim; j++) {
+          double bias = unif(pointGen) * 0.01;
+          myData->setDouble(j, i % k * 3 + bias);
+        }
+        return myData;
+      }, options);
 
     } else { // Load from file
 
-      std::ifstream inFile(fileName.c_str());
-      std::string line;
-      bool rollback = false;
-      bool end = false;
-
-      numData = 0;
-      while (!end) {
-        pdb::makeObjectAllocatorBlock(blocksize * 1024 * 1024, true);
-        pdb::Handle<pdb::Vector<pdb::Handle<DoubleVector>>> storeMe =
-            pdb::makeObject<pdb::Vector<pdb::Handle<DoubleVector>>>();
-        try {
-
-          while (true) {
-            if (!rollback) {
-              //      std::istringstream iss(line);
-              if (!std::getline(inFile, line)) {
-                break;
-              } else {
-                pdb::Handle<DoubleVector> myData =
-                    pdb::makeObject<DoubleVector>(dim);
-                std::stringstream lineStream(line);
-                double value;
-                int index = 0;
-                while (lineStream >> value) {
-                  myData->setDouble(index, value);
-                  index++;
-                }
-                storeMe->push_back(myData);
-              }
-            } else {
-              rollback = false;
-              pdb::Handle<DoubleVector> myData =
-                  pdb::makeObject<DoubleVector>(dim);
-              std::stringstream lineStream(line);
-              double value;
-              int index = 0;
-              while (lineStream >> value) {
-                //(*myData)[index] = value;
-                myData->setDouble(index, value);
-                index++;
-              }
-              storeMe->push_back(myData);
-            }
-          }
-
-          end = true;
-
-          // send the rest of data at the end, it can happen that the exception
-          // never
-          // happens.
-          pdbClient.sendData<DoubleVector>("gmm_input_set", "gmm_db", storeMe);
-
-          numData += storeMe->size();
-          std::cout << "Added " << storeMe->size() << " Total: " << numData << std::endl;
-
-        } catch (pdb::NotEnoughSpace &n) {
-          pdbClient.sendData<DoubleVector>("gmm_input_set", "gmm_db", storeMe);
-
-          numData += storeMe->size();
-          std::cout << "Added " << storeMe->size() << " Total: " << numData << std::endl;
-
-          rollback = true;
-        }
-        std::cout << blocksize << "MB data sent to dispatcher server~~" << std::endl;
+      // each line is a data point
+      pdbClient.bulkLoadTextFile<DoubleVector>("gmm_db", "gmm_input_set", fileName, [&](const std::string &line) {
 
-      } // while not end
-      inFile.close();
+        pdb::Handle<DoubleVector> myData = pdb::makeObject<DoubleVector>(dim);
+        std::stringstream lineStream(line);
+        double value;
+        int index = 0;
+        while (lineStream >> value) {
+          myData->setDouble(index, value);
+          index++;
+        }
+        return myData;
+      }, options);
     } // End load data!!
 
   } // End if - whetherToAddData = true
@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+
+#include "Handle.h"
+#include "PDBVector.h"
+#include "InterfaceFunctions.h"
+#include "UseTemporaryAllocationBlock.h"
+#include "PDBCodec.h"
+#include "Employee.h"
+
+using namespace pdb;
+
+/**
+ * Compares the codecs we were built with on a page of employees, the same kind of page the storage and the shuffles
+ * compress. The ratio counter is how many times smaller the page gets, the bytes per second are the uncompressed bytes.
+ * Pick the codec for a set, a shuffle or a type of request from this, zstd at a high level is worth it for pages that
+ * are stored once and read many times, the cheaper codecs for the pages that are compressed on every send.
+ */
+namespace {
+
+// the size of the page in the benchmark
+const size_t pageSize = 16 * 1024 * 1024;
+
+/**
+ * A page full of employees
+ */
+struct Page {
+
+  Page() : bytes(new char[pageSize]) {
+
+    const UseTemporaryAllocationBlock tempBlock{bytes.get(), pageSize};
+    Handle<Vector<Handle<Employee>>> employees = makeObject<Vector<Handle<Employee>>>();
+    try {
+      for(int i = 0; true; ++i) {
+        Handle<Employee> employee = makeObject<Employee>("Frank" + std::to_string(i), i % 100, "myDept", 123.45 * (i % 7));
+        employees->push_back(employee);
+      }
+    } catch (NotEnoughSpace &n) {}
+    numBytes = getRecord(employees)->numBytes();
+    employees.emptyOutContainingBlock();
+  }
+
+  // the bytes of the page and the size of the record on it
+  std::unique_ptr<char[]> bytes;
+  size_t numBytes;
+};
+
+Page &getPage() {
+  static Page page;
+  return page;
+}
+
+// returns the codec with the index from the available ones
+PDBCodecPtr getCodec(benchmark::State &state) {
+
+  auto name = PDBCodec::getAvailable()[state.range(0)];
+  state.SetLabel(name);
+
+  std::string error;
+  return PDBCodec::get(name, error);
+}
+
+// a benchmark for each codec we were built with
+void forEachCodec(benchmark::internal::Benchmark *benchmark) {
+  for(size_t i = 0; i < PDBCodec::getAvailable().size(); ++i) {
+    benchmark->Arg((int64_t) i);
+  }
+}
+
+}
+
+static void BenchCompress(benchmark::State& state) {
+
+  auto &page = getPage();
+  auto codec = getCodec(state);
+  auto maxFrameSize = codec->getMaxFrameSize(page.numBytes);
+  std::unique_ptr<char[]> frame(new char[maxFrameSize]);
+
+  // compress the page
+  size_t frameSize = 0;
+  for (auto _ : state) {
+    frameSize = codec->compressFrame(page.bytes.get(), page.numBytes, frame.get(), maxFrameSize);
+    benchmark::DoNotOptimize(frameSize);
+  }
+
+  state.SetBytesProcessed(state.iterations() * page.numBytes);
+  state.counters["ratio"] = (double) page.numBytes / frameSize;
+}
+
+static void BenchDecompress(benchmark::State& state) {
+
+  auto &page = getPage();
+  auto codec = getCodec(state);
+  auto maxFrameSize = codec->getMaxFrameSize(page.numBytes);
+  std::unique_ptr<char[]> frame(new char[maxFrameSize]);
+  std::unique_ptr<char[]> decompressed(new char[page.numBytes]);
+
+  // compress it once
+  auto frameSize = codec->compressFrame(page.bytes.get(), page.numBytes, frame.get(), maxFrameSize);
+
+  // decompress it like a receiver would, it only looks at the frame
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(PDBCodec::decompressFrame(frame.get(), frameSize, decompressed.get(), page.numBytes));
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * page.numBytes);
+  state.counters["ratio"] = (double) page.numBytes / frameSize;
+}
+
+BENCHMARK(BenchCompress)->Apply(forEachCodec);
+BENCHMARK(BenchDecompress)->Apply(forEachCodec);
+
+// create the main function
+BENCHMARK_MAIN();
@@ -0,0 +1,139 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+
+#include "Handle.h"
+#include "PDBVector.h"
+#include "InterfaceFunctions.h"
+#include "UseTemporaryAllocationBlock.h"
+#include "PDBCompressedPage.h"
+#include "Employee.h"
+
+using namespace pdb;
+
+/**
+ * Compares the set pages that are stored as they are with the ones that are compressed once when they are stored.
+ * The counters tell how large each page is on disk, the served page benchmarks how much work it is to send it to a
+ * client and the scan benchmarks how fast a computation can go through the records once the page is pinned.
+ */
+namespace {
+
+// the size of the pages in the benchmark
+const size_t pageSize = 16 * 1024 * 1024;
+
+/**
+ * A page full of employees in both of its stored forms
+ */
+struct StoredPages {
+
+  StoredPages() : raw(new char[pageSize]), compressed(new char[pageSize]) {
+
+    // fill the raw page with employees
+    {
+      const UseTemporaryAllocationBlock tempBlock{raw.get(), pageSize};
+      Handle<Vector<Handle<Employee>>> employees = makeObject<Vector<Handle<Employee>>>();
+      try {
+        for(int i = 0; true; ++i) {
+          Handle<Employee> employee = makeObject<Employee>("Frank" + std::to_string(i), i % 100, "myDept", 123.45 * (i % 7));
+          employees->push_back(employee);
+        }
+      } catch (NotEnoughSpace &n) {}
+      rawSize = getRecord(employees)->numBytes();
+      employees.emptyOutContainingBlock();
+    }
+
+    // compress it like the storage does when the set has a codec
+    compressedSize = PDBCompressedPage::compress(PDBCodec::get(PDB_SNAPPY_CODEC), raw.get(), rawSize, compressed.get(), pageSize);
+  }
+
+  // the page stored as it is and its size
+  std::unique_ptr<char[]> raw;
+  size_t rawSize;
+
+  // the page stored compressed and its size
+  std::unique_ptr<char[]> compressed;
+  size_t compressedSize;
+};
+
+StoredPages &getPages() {
+  static StoredPages pages;
+  return pages;
+}
+
+// goes through the employees of a page like a scan would
+int64_t scan(void *bytes) {
+
+  auto employees = ((Record<Vector<Handle<Employee>>>*) bytes)->getRootObject();
+
+  int64_t sum = 0;
+  for(size_t i = 0; i < employees->size(); ++i) {
+    sum += (*employees)[i]->getAge();
+  }
+  return sum;
+}
+
+}
+
+static void BenchServeRawPage(benchmark::State& state) {
+
+  auto &pages = getPages();
+  auto codec = PDBCodec::get(PDB_SNAPPY_CODEC);
+  std::unique_ptr<char[]> wire(new char[codec->getMaxFrameSize(pages.rawSize)]);
+
+  // a page stored as it is has to be compressed each time it is served
+  for (auto _ : state) {
+    auto wireSize = codec->compressFrame(pages.raw.get(), pages.rawSize, wire.get(), codec->getMaxFrameSize(pages.rawSize));
+    benchmark::DoNotOptimize(wireSize);
+  }
+
+  state.SetBytesProcessed(state.iterations() * pages.rawSize);
+  state.counters["diskBytes"] = pages.rawSize;
+}
+
+static void BenchServeCompressedPage(benchmark::State& state) {
+
+  auto &pages = getPages();
+  std::unique_ptr<char[]> wire(new char[pages.compressedSize]);
+
+  // a compressed page is sent as it is, we copy it so that both benchmarks end with the bytes in a buffer
+  for (auto _ : state) {
+    memcpy(wire.get(), PDBCompressedPage::getFrame(pages.compressed.get()), PDBCompressedPage::getFrameSize(pages.compressed.get()));
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * pages.rawSize);
+  state.counters["diskBytes"] = pages.compressedSize;
+}
+
+static void BenchScanRawPage(benchmark::State& state) {
+
+  auto &pages = getPages();
+
+  // the page is pinned as it is
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(scan(pages.raw.get()));
+  }
+
+  state.SetBytesProcessed(state.iterations() * pages.rawSize);
+}
+
+static void BenchScanCompressedPage(benchmark::State& state) {
+
+  auto &pages = getPages();
+  std::unique_ptr<char[]> pinned(new char[pageSize]);
+
+  // the page is decompressed when it is pinned
+  for (auto _ : state) {
+    PDBCompressedPage::decompress(pages.compressed.get(), pinned.get(), pageSize);
+    benchmark::DoNotOptimize(scan(pinned.get()));
+  }
+
+  state.SetBytesProcessed(state.iterations() * pages.rawSize);
+}
+
+BENCHMARK(BenchServeRawPage);
+BENCHMARK(BenchServeCompressedPage);
+BENCHMARK(BenchScanRawPage);
+BENCHMARK(BenchScanCompressedPage);
+
+// create the main function
+BENCHMARK_MAIN();
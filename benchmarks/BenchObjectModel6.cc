@@ -0,0 +1,133 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "Handle.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+#include "InterfaceFunctions.h"
+
+using namespace pdb;
+
+// the number of live objects we keep around while churning
+const int NUM_LIVE_OBJECTS = 10000;
+
+// the number of objects we replace in each iteration
+const int NUM_REPLACED = 100000;
+
+/**
+ * Keeps a vector of strings with different lengths alive and keeps replacing random ones,
+ * the argument is the allocator policy to use
+ */
+static void BenchPDBStringChurn(benchmark::State& state) {
+
+  // the strings we are going to use
+  std::vector<std::string> values;
+  for (int i = 0; i < 64; ++i) {
+    values.emplace_back(1 + i * 3, 'a' + (i % 26));
+  }
+
+  // bench
+  for (auto _ : state) {
+
+    // load up the allocator with RAM and set the policy
+    makeObjectAllocatorBlock(1024 * 1024 * 24, true);
+    getAllocator().setPolicy((AllocatorPolicy) state.range(0));
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> which(0, NUM_LIVE_OBJECTS - 1);
+    std::uniform_int_distribution<int> value(0, (int) values.size() - 1);
+
+    try {
+
+      // make the live objects
+      Handle<Vector<Handle<String>>> strings = makeObject<Vector<Handle<String>>>(NUM_LIVE_OBJECTS);
+      for (int i = 0; i < NUM_LIVE_OBJECTS; i++) {
+        strings->push_back(makeObject<String>(values[value(gen)]));
+      }
+
+      // keep replacing them, the old one is freed once we overwrite the handle
+      for (int i = 0; i < NUM_REPLACED; i++) {
+        (*strings)[which(gen)] = makeObject<String>(values[value(gen)]);
+      }
+
+      // do not optimize out the value
+      benchmark::DoNotOptimize(strings);
+
+    } catch (NotEnoughSpace& e) {
+
+      // without reuse we can run out of memory
+      state.SkipWithError("Run out of memory in the allocation block.");
+    }
+  }
+
+  getAllocator().setPolicy(AllocatorPolicy::defaultAllocator);
+}
+
+/**
+ * Keeps a vector of small vectors of doubles alive and keeps replacing random ones with ones of a different size,
+ * the argument is the allocator policy to use
+ */
+static void BenchPDBVectorChurn(benchmark::State& state) {
+
+  // bench
+  for (auto _ : state) {
+
+    // load up the allocator with RAM and set the policy
+    makeObjectAllocatorBlock(1024 * 1024 * 64, true);
+    getAllocator().setPolicy((AllocatorPolicy) state.range(0));
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> which(0, NUM_LIVE_OBJECTS - 1);
+    std::uniform_int_distribution<int> size(1, 200);
+
+    try {
+
+      // make the live objects
+      Handle<Vector<Handle<Vector<double>>>> vectors = makeObject<Vector<Handle<Vector<double>>>>(NUM_LIVE_OBJECTS);
+      for (int i = 0; i < NUM_LIVE_OBJECTS; i++) {
+        vectors->push_back(makeObject<Vector<double>>(size(gen), size(gen)));
+      }
+
+      // keep replacing them, the old one is freed once we overwrite the handle
+      for (int i = 0; i < NUM_REPLACED; i++) {
+        auto s = size(gen);
+        (*vectors)[which(gen)] = makeObject<Vector<double>>(s, s);
+      }
+
+      // do not optimize out the value
+      benchmark::DoNotOptimize(vectors);
+
+    } catch (NotEnoughSpace& e) {
+
+      // without reuse we can run out of memory
+      state.SkipWithError("Run out of memory in the allocation block.");
+    }
+  }
+
+  getAllocator().setPolicy(AllocatorPolicy::defaultAllocator);
+}
+
+// Register the function as a benchmark
+BENCHMARK(BenchPDBStringChurn)->Arg(AllocatorPolicy::defaultAllocator)->Arg(AllocatorPolicy::sizeClassAllocator);
+BENCHMARK(BenchPDBVectorChurn)->Arg(AllocatorPolicy::defaultAllocator)->Arg(AllocatorPolicy::sizeClassAllocator);
+
+// create the main function
+BENCHMARK_MAIN();
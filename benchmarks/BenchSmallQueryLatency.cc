@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+
+#include <PDBClient.h>
+#include <SharedEmployee.h>
+#include <ScanSupervisorSet.h>
+#include <SillyQuery.h>
+#include <SillyAgg.h>
+#include <FinalQuery.h>
+#include <WriteSalaries.h>
+
+using namespace pdb;
+
+/**
+ * Measures the end to end latency of a small aggregation against a cluster that is already running on localhost:8108
+ * with the shared libraries built. Run it once against a cluster started with the default --smallQueryThreshold,
+ * where the aggregation runs on a single node, and once with --smallQueryThreshold 0, where it runs on all the nodes
+ * and shuffles, to compare the two.
+ */
+namespace {
+
+/**
+ * The client, the sets with a couple of pages of supervisors spread over the nodes and the query graph
+ */
+struct SmallQuery {
+
+  SmallQuery() : client(8108, "localhost") {
+
+    // register the classes
+    client.registerType("libraries/libScanSupervisorSet.so");
+    client.registerType("libraries/libSillyQuery.so");
+    client.registerType("libraries/libSillyAgg.so");
+    client.registerType("libraries/libFinalQuery.so");
+    client.registerType("libraries/libWriteSalaries.so");
+
+    // create the sets
+    client.createDatabase("bench_db");
+    client.createSet<Supervisor>("bench_db", "small_query_set");
+    client.createSet<double>("bench_db", "small_query_output");
+
+    // fill in a small amount of data
+    std::string departmentPrefix(4, 'a');
+    int numRecords = 0;
+    for(int j = 0; j < 4; j++) {
+
+      // make the allocation block
+      const UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+
+      // write a bunch of supervisors to it
+      Handle<Vector<Handle<Supervisor>>> supers = makeObject<Vector<Handle<Supervisor>>>();
+      try {
+
+        for (int i = 0; true; i++) {
+
+          Handle<Supervisor> super = makeObject<Supervisor>("Steve Stevens", numRecords, departmentPrefix + std::to_string(numRecords), 1);
+          numRecords++;
+
+          supers->push_back(super);
+          for (int k = 0; k < 10; k++) {
+
+            Handle<Employee> temp = makeObject<Employee>("Steve Stevens", numRecords, departmentPrefix + std::to_string(numRecords), 1);
+            (*supers)[i]->addEmp(temp);
+          }
+        }
+
+      } catch (NotEnoughSpace &e) {
+
+        // remove the last supervisor and send the rest
+        supers->pop_back();
+        client.sendData<Supervisor>("bench_db", "small_query_set", supers);
+      }
+    }
+
+    // make the query graph
+    Handle<Computation> myScanSet = makeObject<ScanSupervisorSet>("bench_db", "small_query_set");
+
+    Handle<Computation> myFilter = makeObject<SillyQuery>();
+    myFilter->setInput(myScanSet);
+
+    Handle<Computation> myAgg = makeObject<SillyAgg>();
+    myAgg->setInput(myFilter);
+
+    Handle<Computation> myFinalFilter = makeObject<FinalQuery>();
+    myFinalFilter->setInput(myAgg);
+
+    sink = makeObject<WriteSalaries>("bench_db", "small_query_output");
+    sink->setInput(myFinalFilter);
+  }
+
+  ~SmallQuery() {
+
+    // remove the sets we made
+    client.removeSet("bench_db", "small_query_set");
+    client.removeSet("bench_db", "small_query_output");
+  }
+
+  // the allocation block the query graph lives in
+  const UseTemporaryAllocationBlock tempBlock{1024 * 1024 * 128};
+
+  // the client connected to the manager
+  PDBClient client;
+
+  // the computation that writes the result
+  Handle<Computation> sink;
+};
+
+SmallQuery &getQuery() {
+  static SmallQuery query;
+  return query;
+}
+
+}
+
+static void BenchSmallQueryLatency(benchmark::State& state) {
+
+  auto &query = getQuery();
+
+  for (auto _ : state) {
+
+    // start from an empty output set
+    state.PauseTiming();
+    query.client.clearSet("bench_db", "small_query_output");
+    state.ResumeTiming();
+
+    query.client.executeComputations({ query.sink });
+  }
+}
+
+BENCHMARK(BenchSmallQueryLatency)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// create the main function
+BENCHMARK_MAIN();
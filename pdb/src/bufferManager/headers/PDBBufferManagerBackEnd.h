@@ -30,6 +30,8 @@
 #include <condition_variable>
 #include "PDBBufferManagerInterface.h"
 #include "PDBPageCompare.h"
+#include "PDBMappedFiles.h"
+#include "PDBPinQuotas.h"
 
 // this is needed so we can declare friend tests here
 #include <gtest/gtest_prod.h>
@@ -70,6 +72,16 @@ public:
    */
   PDBPageHandle getPage(PDBSetPtr whichSet, uint64_t i) override;
 
+  /**
+   * Returns a handle to a page of the specified set that points into the file of the set mapped read-only.
+   * The frontend tells us where the page is in the file, if it has the page buffered or never wrote it we
+   * grab it like any other page, @see PDBBufferManagerInterface::getMappedPage
+   * @param whichSet - the set of the page
+   * @param i - the number of the page
+   * @return - the page handle, it is guaranteed to be pinned
+   */
+  PDBPageHandle getMappedPage(PDBSetPtr whichSet, uint64_t i) override;
+
   /**
    * Returns a page that will be guaranteed to have at least minBytes size
    * Calling this method is thread safe.
@@ -92,6 +104,19 @@ public:
    */
   size_t getMaxPageSize() override;
 
+  /**
+   * Limits how many bytes the anonymous pages pinned on the threads of an owner can take, @see PDBPinQuotas
+   * @param owner - the owner, the id of the computation
+   * @param numBytes - the quota
+   */
+  void registerPinOwner(uint64_t owner, uint64_t numBytes) override;
+
+  /**
+   * Removes the quota of an owner once everyone that registered it is done
+   * @param owner - the owner
+   */
+  void unregisterPinOwner(uint64_t owner) override;
+
   void registerHandlers(PDBServer &forMe) override;
 
 protected:
@@ -148,6 +173,18 @@ protected:
   // this is where we store all the backend pages
   map <pair <PDBSetPtr, size_t>, PDBPagePtr, PDBPageCompare> allPages;
 
+  // the set files we have mapped to hand out mapped pages
+  PDBMappedFiles mappedFiles;
+
+  // the quotas of the owners of the pinned anonymous pages
+  PDBPinQuotas pinQuotas;
+
+  // marks a page we could not pin as not loaded again, so the ones that wait for it don't wait forever
+  void failRepin(pdb::PDBPagePtr me);
+
+  // returns what the owner is charged for an anonymous page of at least this size, the size the frontend gives it
+  static uint64_t getPinCharge(size_t minBytes);
+
   // the shared memory with the frontend
   PDBSharedMemory sharedMemory {};
 
@@ -7,6 +7,8 @@
 #include <SimpleRequestResult.h>
 #include <BufForwardPageRequest.h>
 #include <BufGetPageResult.h>
+#include <BufGetMappedPageRequest.h>
+#include <BufGetMappedPageResult.h>
 #include <BufGetAnonymousPageRequest.h>
 #include <BufReturnPageRequest.h>
 #include <BufReturnAnonPageRequest.h>
@@ -16,6 +18,7 @@
 #include <BufPinPageResult.h>
 #include <mutex>
 #include <BufFreezeRequestResult.h>
+#include <AllocationBlockPool.h>
 
 namespace pdb {
 
@@ -150,6 +153,54 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(pdb::PDBSetPtr which
   return std::move(res);
 }
 
+template <class T>
+pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getMappedPage(pdb::PDBSetPtr whichSet, uint64_t i) {
+
+  /// 1. If we already have the page, or someone is working on it, we grab it like any other page
+
+  {
+    // lock the pages
+    unique_lock<std::mutex> lock(m);
+
+    // find the page
+    if (whichSet == nullptr || allPages.find(std::make_pair(whichSet, i)) != allPages.end()) {
+      lock.unlock();
+      return getPage(whichSet, i);
+    }
+  }
+
+  /// 2. Ask the frontend where the page is on disk
+
+  // grab the address of the frontend
+  auto port = getConfiguration()->port;
+  auto address = getConfiguration()->address;
+
+  std::string path;
+  PDBPageInfo location;
+  auto res = T::template heapRequest<BufGetMappedPageRequest, BufGetMappedPageResult, bool>(
+      myLogger, port, address, false, 1024,
+      [&](Handle<BufGetMappedPageResult> result) {
+
+        // if the page can not be mapped we are done
+        if (result == nullptr || !result->success) {
+          return false;
+        }
+
+        // copy where it is
+        path = result->path;
+        location.startPos = result->startPos;
+        location.numBytes = result->numBytes;
+
+        return true;
+      },
+      whichSet->getSetName(), whichSet->getDBName(), i);
+
+  /// 3. Point into the mapped file, if we can't we grab it like any other page
+
+  auto page = res ? mappedFiles.getPage(*this, whichSet, i, path, location) : nullptr;
+  return page != nullptr ? page : getPage(whichSet, i);
+}
+
 template <class T>
 pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage() {
   return getPage(getConfiguration()->pageSize);
@@ -170,7 +221,16 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(size_t minBytes) {
   // somewhere to put the message.
   std::string errMsg;
 
-  /// 1. We simply request the page it is safe since it is a new anonymous page
+  /// 1. Charge the owner of this thread for the page, this blocks if the owner has used up its quota
+
+  auto owner = PDBPinQuotas::getOwner();
+  auto charge = getPinCharge(minBytes);
+  if (!pinQuotas.acquire(owner, charge)) {
+    throw std::runtime_error("The pages pinned by the computation " + std::to_string(owner) +
+                             " stayed over its memory budget, could not get an anonymous page.");
+  }
+
+  /// 2. We simply request the page it is safe since it is a new anonymous page
 
   // make a request
   auto res = T::template heapRequest<BufGetAnonymousPageRequest, BufGetPageResult, pdb::PDBPageHandle>(
@@ -188,6 +248,8 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(size_t minBytes) {
           returnVal->location.startPos = result->startPos;
           returnVal->location.numBytes = result->numBytes;
           returnVal->bytes = (char *) this->sharedMemory.memory + result->offset;
+          returnVal->pinOwner = owner;
+          returnVal->pinCharge = charge;
 
           // this an anonymous page if it is not set the database and set name
           if (!result->isAnonymous) {
@@ -220,6 +282,12 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(size_t minBytes) {
       },
       minBytes);
 
+  // we did not get the page so the owner is not charged for it, the frontend could not find space for it
+  if (res == nullptr) {
+    pinQuotas.release(owner, charge);
+    throw std::runtime_error("Could not get an anonymous page of size " + std::to_string(minBytes) + " from the frontend.");
+  }
+
   // return the page
   return std::move(res);
 }
@@ -239,7 +307,7 @@ PDBPageHandle PDBBufferManagerBackEnd<T>::expectPage(std::shared_ptr<PDBCommunic
   }
 
   // allocate the memory
-  std::unique_ptr<char[]> memory(new char[objectSize]);
+  PooledBuffer memory(objectSize);
 
   // block to get the response
   bool success;
@@ -370,6 +438,11 @@ void pdb::PDBBufferManagerBackEnd<T>::freeAnonymousPage(pdb::PDBPagePtr me) {
 
   /// 1. Since the count of references for the anon page has hit zero we simply remove it from the allPages
 
+  // the page is gone, if it was pinned the owner is not charged for it anymore
+  pinQuotas.release(me->pinOwner, me->pinCharge);
+  me->pinOwner = PDB_NO_PIN_OWNER;
+  me->pinCharge = 0;
+
   PDBPageHandle pageHandle;
   {
     // lock the pages
@@ -613,6 +686,7 @@ void pdb::PDBBufferManagerBackEnd<T>::unpin(pdb::PDBPagePtr me) {
         // return the result
         if (result != nullptr && result->getRes().first) {
 
+          uint64_t owner, charge;
           {
             // lock the page
             unique_lock<std::mutex> lck(m);
@@ -620,9 +694,16 @@ void pdb::PDBBufferManagerBackEnd<T>::unpin(pdb::PDBPagePtr me) {
             // invalidate the page
             me->bytes = nullptr;
             me->status = PDB_PAGE_NOT_LOADED;
+
+            // the owner is not charged for the page anymore
+            owner = me->pinOwner;
+            charge = me->pinCharge;
+            me->pinOwner = PDB_NO_PIN_OWNER;
+            me->pinCharge = 0;
           }
 
-          // notify all threads that the state has changed
+          // give back the quota and notify all threads that the state has changed
+          pinQuotas.release(owner, charge);
           cv.notify_all();
 
           // so it worked
@@ -670,6 +751,15 @@ void pdb::PDBBufferManagerBackEnd<T>::repin(pdb::PDBPagePtr me) {
     }
   }
 
+  // charge the owner of this thread for the anonymous pages, this blocks if the owner has used up its quota
+  auto owner = me->isAnon ? PDBPinQuotas::getOwner() : PDB_NO_PIN_OWNER;
+  auto charge = (uint64_t) MIN_PAGE_SIZE << me->location.numBytes;
+  if (!pinQuotas.acquire(owner, charge)) {
+    failRepin(me);
+    throw std::runtime_error("The pages pinned by the computation " + std::to_string(owner) +
+                             " stayed over its memory budget, could not pin the page " + std::to_string(me->pageNum) + ".");
+  }
+
   // grab the address of the frontend
   auto port = getConfiguration()->port;
   auto address = getConfiguration()->address;
@@ -692,6 +782,8 @@ void pdb::PDBBufferManagerBackEnd<T>::repin(pdb::PDBPagePtr me) {
             // figure out the pointer for the offset and update status
             me->bytes = (void *) ((uint64_t) this->sharedMemory.memory + (uint64_t) result->offset);
             me->status = PDB_PAGE_LOADED;
+            me->pinOwner = owner;
+            me->pinCharge = charge;
           }
 
           // notify all threads that the state has changed
@@ -701,13 +793,22 @@ void pdb::PDBBufferManagerBackEnd<T>::repin(pdb::PDBPagePtr me) {
           return true;
         }
 
-        // set the error since we failed
-        errMsg = "Could not return the requested page";
+        // the frontend could not find space for the page
+        if (result != nullptr) {
+          errMsg = "The frontend could not find space for the page " + std::to_string(me->pageNum) + ".";
+        }
 
         return false;
       },
       me->whichSet, me->pageNum);
 
+  // the buffer pool stayed full so the page is not pinned, the owner is not charged for it
+  if (!res && !errMsg.empty()) {
+    pinQuotas.release(owner, charge);
+    failRepin(me);
+    throw std::runtime_error(errMsg);
+  }
+
   // did we succeed in returning the page
   if (!res) {
 
@@ -716,6 +817,40 @@ void pdb::PDBBufferManagerBackEnd<T>::repin(pdb::PDBPagePtr me) {
   }
 }
 
+template <class T>
+void pdb::PDBBufferManagerBackEnd<T>::failRepin(pdb::PDBPagePtr me) {
+
+  {
+    // the page is not loaded, the ones that wait for it can try themselves
+    unique_lock<std::mutex> lck(m);
+    me->status = PDB_PAGE_NOT_LOADED;
+  }
+
+  cv.notify_all();
+}
+
+template <class T>
+uint64_t pdb::PDBBufferManagerBackEnd<T>::getPinCharge(size_t minBytes) {
+
+  // the frontend rounds the page up to a power of two, the same size the page has when it is repinned
+  auto charge = (uint64_t) MIN_PAGE_SIZE;
+  while (charge < minBytes) {
+    charge <<= 1;
+  }
+
+  return charge;
+}
+
+template <class T>
+void pdb::PDBBufferManagerBackEnd<T>::registerPinOwner(uint64_t owner, uint64_t numBytes) {
+  pinQuotas.registerOwner(owner, numBytes);
+}
+
+template <class T>
+void pdb::PDBBufferManagerBackEnd<T>::unregisterPinOwner(uint64_t owner) {
+  pinQuotas.unregisterOwner(owner);
+}
+
 template <class T>
 void pdb::PDBBufferManagerBackEnd<T>::registerHandlers(pdb::PDBServer &forMe) {}
 
@@ -8,6 +8,7 @@
 #include "SimpleRequestResult.h"
 #include "BufFreezeRequestResult.h"
 #include "BufPinPageResult.h"
+#include "BufGetMappedPageResult.h"
 #include "PDBPageHandle.h"
 #include "PDBSharedMemory.h"
 #include "PDBBufferManagerBackEnd.h"
@@ -213,6 +214,31 @@ public:
                                                                               request);
   }
 
+  // get mapped page, the page does not go through the buffer pool so we don't log it
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::BufGetMappedPageResult>)> &processResponse,
+                          const std::string &setName,
+                          const std::string &dbName,
+                          uint64_t pageNum) {
+
+    // init the request
+    Handle<RequestType> request = makeObject<RequestType>(setName, dbName, pageNum);
+
+    // make a request
+    return RequestFactory::heapRequest<RequestType, ResponseType, ReturnType>(myLogger,
+                                                                              port,
+                                                                              address,
+                                                                              onErr,
+                                                                              bytesForRequest,
+                                                                              processResponse,
+                                                                              request);
+  }
+
   static PDBBufferManagerInterface* instance;
 };
 
@@ -12,6 +12,7 @@
 #include <set>
 #include <PDBBufferManagerImpl.h>
 #include <BufGetPageRequest.h>
+#include <BufGetMappedPageRequest.h>
 #include <BufGetAnonymousPageRequest.h>
 #include <BufReturnPageRequest.h>
 #include <BufReturnAnonPageRequest.h>
@@ -100,6 +101,10 @@ protected:
   template <class T>
   std::pair<bool, std::string> handleGetPageRequest(pdb::Handle<pdb::BufGetPageRequest> &request, std::shared_ptr<T> &sendUsingMe);
 
+  // handles the request of the backend to find where a page is on disk so it can map it
+  template <class T>
+  std::pair<bool, std::string> handleGetMappedPageRequest(pdb::Handle<pdb::BufGetMappedPageRequest> &request, std::shared_ptr<T> &sendUsingMe);
+
   // handles the get anonymous page request from the backend
   template <class T>
   std::pair<bool, std::string> handleGetAnonymousPageRequest(pdb::Handle<pdb::BufGetAnonymousPageRequest> &request, std::shared_ptr<T> &sendUsingMe);
@@ -8,15 +8,23 @@
 #include <SimpleRequestResult.h>
 #include <BufPinPageResult.h>
 #include <BufGetPageResult.h>
+#include <BufGetMappedPageResult.h>
 #include <BufFreezeRequestResult.h>
 #include <BufForwardPageRequest.h>
+#include <AllocationBlockPool.h>
 #include "assert.h"
 
 template <class T>
 std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetPageRequest(pdb::Handle<pdb::BufGetPageRequest> &request, std::shared_ptr<T> &sendUsingMe) {
 
-  // grab the page
-  auto page = this->getPage(make_shared<pdb::PDBSet>(request->dbName, request->setName), request->pageNumber);
+  // grab the page, if the buffer pool stays full we don't respond so the backend knows we failed
+  PDBPageHandle page;
+  try {
+    page = this->getPage(make_shared<pdb::PDBSet>(request->dbName, request->setName), request->pageNumber);
+  }
+  catch (std::runtime_error &e) {
+    return make_pair(false, std::string(e.what()));
+  }
 
   // send the page to the backend
   string error;
@@ -25,11 +33,39 @@ std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetPageRequest
   return make_pair(res, error);
 }
 
+template <class T>
+std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetMappedPageRequest(pdb::Handle<pdb::BufGetMappedPageRequest> &request, std::shared_ptr<T> &sendUsingMe) {
+
+  // find where the page is on disk
+  std::string path;
+  PDBPageInfo location;
+  bool res = this->getMappedPageLocation(make_shared<pdb::PDBSet>(request->dbName, request->setName), request->pageNumber, path, location);
+
+  // create an allocation block to hold the response
+  const UseTemporaryAllocationBlock tempBlock{1024 + path.size()};
+
+  // create the response
+  Handle<BufGetMappedPageResult> response = makeObject<BufGetMappedPageResult>(res, path, location.startPos, location.numBytes);
+
+  // sends result to requester
+  std::string errMsg;
+  res = sendUsingMe->sendObject(response, errMsg);
+
+  // return
+  return make_pair(res, errMsg);
+}
+
 template <class T>
 std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetAnonymousPageRequest(pdb::Handle<pdb::BufGetAnonymousPageRequest> &request, std::shared_ptr<T> &sendUsingMe) {
 
-  // grab an anonymous page
-  auto page = getPage(request->size);
+  // grab an anonymous page, if the buffer pool stays full we don't respond so the backend knows we failed
+  PDBPageHandle page;
+  try {
+    page = getPage(request->size);
+  }
+  catch (std::runtime_error &e) {
+    return make_pair(false, std::string(e.what()));
+  }
 
   // send the page to the backend
   std::string error;
@@ -211,10 +247,17 @@ std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handlePinPageRequest
   }
 
   // if we did find it, if so pin it
+  std::string errMsg;
   if(res) {
 
-    // pin it
-    handle->repin();
+    // pin it, this fails if the buffer pool stays full
+    try {
+      handle->repin();
+    }
+    catch (std::runtime_error &e) {
+      errMsg = e.what();
+      res = false;
+    }
   }
 
   // create an allocation block to hold the response
@@ -224,7 +267,6 @@ std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handlePinPageRequest
   Handle<BufPinPageResult> response = makeObject<BufPinPageResult>((uint64_t) handle->page->bytes - (uint64_t) sharedMemory.memory, res);
 
   // sends result to requester
-  std::string errMsg;
   res = sendUsingMe->sendObject(response, errMsg) && res;
 
   // return
@@ -355,16 +397,7 @@ bool pdb::PDBBufferManagerFrontEnd::handleForwardPage(pdb::PDBPageHandle &page,
   }
 
   // allocate the memory
-  std::unique_ptr<char[]> memory(new char[objectSize]);
-  if (memory == nullptr) {
-
-    errMsg = "FATAL ERROR in heapRequest: Can't allocate memory";
-    logger->error(errMsg);
-
-    /// TODO this needs to be an exception or something
-    // this is a fatal error we should not be running out of memory
-    exit(-1);
-  }
+  PooledBuffer memory(objectSize);
 
   // grab the result
   bool success;
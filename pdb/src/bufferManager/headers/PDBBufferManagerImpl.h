@@ -11,11 +11,13 @@
 #include "PDBSetCompare.h"
 #include "PDBSharedMemory.h"
 #include "PDBBufferManagerInterface.h"
+#include "PDBMappedFiles.h"
 #include "NodeConfig.h"
 
 #include <map>
 #include <memory>
 #include <condition_variable>
+#include <chrono>
 #include <queue>
 #include <set>
 
@@ -129,6 +131,32 @@ class PDBBufferManagerImpl : public PDBBufferManagerInterface {
    */
   PDBPageHandle getPage(PDBSetPtr whichSet, uint64_t i) override;
 
+  /**
+   * gets the i-th page of a set without copying it into the buffer pool. If the page is on disk and
+   * not buffered the handle points straight into the file of the set mapped read-only, otherwise this
+   * is the same as @see getPage
+   * @param whichSet - this is the set identifier to which the page belongs to (databaseName, setName)
+   * @param i - the i-th page of the set
+   * @return - a page handle to the requested page, it is guaranteed to be pinned
+   */
+  PDBPageHandle getMappedPage(PDBSetPtr whichSet, uint64_t i) override;
+
+  /**
+   * Finds where a page of a set is on disk, so that it can be mapped
+   * @param whichSet - the set of the page
+   * @param i - the i-th page of the set
+   * @param path - the path of the file of the set
+   * @param location - where the page is in the file
+   * @return true if the page is on disk and not buffered, false if it has to be grabbed with @see getPage
+   */
+  bool getMappedPageLocation(const PDBSetPtr &whichSet, uint64_t i, std::string &path, PDBPageInfo &location);
+
+  /**
+   * Returns the set files we have mapped to hand out mapped pages
+   * @return the mapped files
+   */
+  PDBMappedFiles &getMappedFiles();
+
   /**
    * gets a temporary page that will no longer exist (1) after the buffer manager
    * has been destroyed, or (2) there are no more references to it anywhere in the
@@ -175,6 +203,13 @@ protected:
    */
   void checkIfOpen(PDBSetPtr &whichSet);
 
+  /**
+   * Returns the path of the file of a set
+   * @param whichSet - the set
+   * @return - the path
+   */
+  std::string getSetFilePath(const PDBSetPtr &whichSet);
+
   /**
    * Returns the file descriptor for a particular set
    * @param whichSet - the set we are looking up the file descriptor
@@ -206,7 +241,8 @@ protected:
    * is anonymous, then if it is dirty, we get a spot for it in the temp file and kick it out.
    * If the page is not anonymous, it is written back (it must already have a spot to be
    * written to, because it has to have been unpinned) and then if there are no references to
-   * it, it is destroyed.
+   * it, it is destroyed. If every page is pinned it waits for one to be unpinned, at most maxSpaceWait, then it
+   * throws a runtime error.
    * @param whichSize
    * @param lock
    */
@@ -338,6 +374,11 @@ protected:
    */
   map<PDBSetPtr, int, PDBSetCompare> fds;
 
+  /**
+   * the set files we have mapped to hand out mapped pages
+   */
+  PDBMappedFiles mappedFiles;
+
   /**
    * all of the full pages that are currently not being used
    */
@@ -438,6 +479,11 @@ protected:
    */
   std::vector<bool> isCreatingSpace;
 
+  /**
+   * the longest a request waits for a page to be unpinned when every page in the buffer pool is pinned
+   */
+  std::chrono::milliseconds maxSpaceWait = std::chrono::seconds(60);
+
   /**
    * this vector holds all the free page numbers we can assign to an anonymous page.
    */
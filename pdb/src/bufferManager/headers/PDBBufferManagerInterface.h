@@ -86,6 +86,15 @@ public:
   // bytes to store the page and return that.
   virtual PDBPageHandle getPage(PDBSetPtr whichSet, uint64_t i) = 0;
 
+  // gets the i^th page in the table whichSet without copying it into the buffer pool, if the page
+  // is on disk and not buffered the handle points straight into the file of the set mapped read-only.
+  // Such a page can not be modified and is never written back, pinning and unpinning it is only
+  // counted. This is meant for scanning sets that are not modified while they are scanned, if the
+  // page can not be mapped it is simply grabbed with getPage
+  virtual PDBPageHandle getMappedPage(PDBSetPtr whichSet, uint64_t i) {
+    return getPage(std::move(whichSet), i);
+  }
+
   // gets a temporary page that will no longer exist (1) after the buffer manager
   // has been destroyed, or (2) there are no more references to it anywhere in the
   // program.  Typically such a temporary page will be used as buffer memory.
@@ -102,6 +111,14 @@ public:
   // gets the page size
   virtual size_t getMaxPageSize() = 0;
 
+  // limits how many bytes the temporary pages pinned on the threads of an owner can take, once the
+  // owner uses up its quota the pins block until it unpins some pages @see PDBPinQuotas. Only the
+  // backend enforces the quotas, since that is where the jobs run
+  virtual void registerPinOwner(uint64_t owner, uint64_t numBytes) {}
+
+  // removes the quota of an owner once everyone that registered it is done
+  virtual void unregisterPinOwner(uint64_t owner) {}
+
   // simply loop through and write back any dirty pages.  
   virtual ~PDBBufferManagerInterface () = default;
 
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "PDBSet.h"
+#include "PDBPage.h"
+#include "PDBPageHandle.h"
+
+namespace pdb {
+
+class PDBMappedFile;
+using PDBMappedFilePtr = std::shared_ptr<PDBMappedFile>;
+
+/**
+ * A set file mapped into memory read-only, with a hint that it is going to be read sequentially. The file is mapped in
+ * fixed chunks that are mapped once and reused for every page that starts in them, since the mappings are shared the
+ * bytes the file grows by show up in the chunks we already have. A chunk maps two chunk sizes so that a page starting
+ * in it always fits, a page larger than a chunk gets a mapping of its own. The mappings stay until the file is gone,
+ * since the pages we handed out point into them.
+ */
+class PDBMappedFile {
+ public:
+
+  /**
+   * Maps a file
+   * @param path - the path of the file
+   */
+  explicit PDBMappedFile(std::string path);
+
+  ~PDBMappedFile();
+
+  /**
+   * Did we manage to open the file
+   */
+  bool isOpen() const;
+
+  /**
+   * Returns the bytes of the file at some position, tells the kernel to start reading them in
+   * @param startPos - where the bytes start in the file
+   * @param numBytes - how many bytes we need
+   * @return a pointer to the bytes or null if the file is not that large or we can not map it
+   */
+  void *getBytes(uint64_t startPos, uint64_t numBytes);
+
+  /**
+   * Returns the path of the file
+   */
+  const std::string &getPath() const;
+
+  /**
+   * Returns the inode of the file we have open, if the file was replaced it does not match the one on the path
+   */
+  uint64_t getInode() const;
+
+  /**
+   * Returns the number of pages of this file that are pinned
+   */
+  uint64_t getNumPinned() const;
+
+  /**
+   * Returns the number of mappings we made of this file
+   */
+  size_t getNumMappings();
+
+  // the size of the chunks we map the file in, a multiple of the os page
+  static const uint64_t chunkSize;
+
+ private:
+
+  /**
+   * Maps a part of the file
+   * @param offset - where it starts in the file, aligned to the os page
+   * @param size - how many bytes we map
+   * @return the mapping or null if we can not map it
+   */
+  char *map(uint64_t offset, size_t size);
+
+  // the path of the file
+  std::string path;
+
+  // the descriptor of the file
+  int fd = -1;
+
+  // the inode of the file
+  uint64_t inode = 0;
+
+  // the chunks we mapped by their number, each one maps two chunk sizes
+  std::map<uint64_t, char *> chunks;
+
+  // the pages larger than a chunk by their position in the file, the mapping starts at the os page of the position
+  std::map<uint64_t, std::pair<char *, size_t>> largePages;
+
+  // the number of pinned pages, only kept for accounting
+  std::atomic<uint64_t> numPinned{0};
+
+  // locks the mappings
+  std::mutex m;
+
+  friend class PDBPage;
+  friend class PDBMappedFiles;
+};
+
+/**
+ * Keeps the set files a buffer manager has mapped into memory and makes pages that point straight into them. A mapped
+ * page is read-only, it is never written back, pinning and unpinning it only updates the count of pinned pages of its
+ * file. It is used to scan sets that are not modified while they are scanned without copying the pages into the
+ * buffer pool @see PDBBufferManagerInterface::getMappedPage
+ */
+class PDBMappedFiles {
+ public:
+
+  /**
+   * Makes a page that points into a mapped set file
+   * @param parent - the buffer manager the page belongs to
+   * @param whichSet - the set of the page
+   * @param i - the number of the page
+   * @param path - the path of the file of the set
+   * @param location - where the page is in the file
+   * @return the page handle or null if we can not map the page
+   */
+  PDBPageHandle getPage(PDBBufferManagerInterface &parent, const PDBSetPtr &whichSet, uint64_t i,
+                        const std::string &path, const PDBPageInfo &location);
+
+  /**
+   * Forgets a file, the pages we handed out keep it mapped until they are gone
+   * @param path - the path of the file
+   */
+  void forget(const std::string &path);
+
+  /**
+   * Returns the number of mapped pages we made
+   */
+  uint64_t getNumMappedPages() const;
+
+  /**
+   * Returns the number of bytes on the mapped pages we made
+   */
+  uint64_t getNumMappedBytes() const;
+
+  /**
+   * Returns the number of mapped pages that are currently pinned
+   */
+  uint64_t getNumPinnedPages();
+
+ private:
+
+  // the files we have mapped
+  std::map<std::string, PDBMappedFilePtr> files;
+
+  // the number of pages we made
+  std::atomic<uint64_t> numMappedPages{0};
+
+  // the number of bytes on those pages
+  std::atomic<uint64_t> numMappedBytes{0};
+
+  // locks the files
+  std::mutex m;
+};
+
+}
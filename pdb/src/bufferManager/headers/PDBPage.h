@@ -2,6 +2,7 @@
 
 #include <memory>
 #include "PDBSet.h"
+#include "PDBPinQuotas.h"
 #include <string>
 #include <mutex>
 #include <atomic>
@@ -39,6 +40,7 @@ enum PDBPageStatus {
 
 // forward definition to handle circular dependencies
 class PDBBufferManagerInterface;
+class PDBMappedFile;
 
 class PDBPage {
 
@@ -81,6 +83,10 @@ class PDBPage {
   // RAM may have changed
   void repin ();
 
+  // a mapped page points straight into a set file mapped read-only, it can not be modified and
+  // pinning or unpinning it does not move it @see PDBMappedFiles
+  bool isMapped ();
+
   // create a page
   explicit PDBPage (PDBBufferManagerInterface &);
 
@@ -122,6 +128,13 @@ class PDBPage {
   PDBSetPtr whichSet = nullptr;
   PDBPageWeakPtr me;
 
+  // the file the page points into if it is mapped
+  shared_ptr <PDBMappedFile> mappedFile;
+
+  // the owner the pin of the page is charged to and how many bytes, @see PDBPinQuotas
+  uint64_t pinOwner = PDB_NO_PIN_OWNER;
+  uint64_t pinCharge = 0;
+
   // pointer to the parent buffer manager
   PDBBufferManagerInterface& parent;
 
@@ -131,6 +144,7 @@ class PDBPage {
   friend class PDBPageHandleBase;
   friend class PDBBufferManagerImpl;
   friend class PDBBufferManagerFrontEnd;
+  friend class PDBMappedFiles;
 
   template <class T>
   friend class PDBBufferManagerBackEnd;
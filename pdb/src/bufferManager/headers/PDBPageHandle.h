@@ -78,6 +78,11 @@ class PDBPageHandleBase {
     page->repin();
   }
 
+  // tells us whether the page points straight into a mapped set file, such a page is read-only
+  bool isMapped() {
+    return page->isMapped();
+  }
+
   // returns the size of the page. If this is frozen it will return the frozen size, if not it will return
   size_t getSize() {
     return page->getSize();
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <condition_variable>
+
+namespace pdb {
+
+// the owner of the pages pinned by threads that do not run a job, they are never limited
+const uint64_t PDB_NO_PIN_OWNER = std::numeric_limits<uint64_t>::max();
+
+/**
+ * Limits how many bytes the pages pinned by an owner can take, the owner is the computation that runs on the thread.
+ * A thread that would go over the quota of its owner blocks until the owner unpins enough pages, instead of the
+ * buffer manager running out of memory. An owner can always pin one page, so it can not block itself. If the quota
+ * stays used up for longer than the maximum wait the pin fails, the job goes over its budget.
+ */
+class PDBPinQuotas {
+ public:
+
+  /**
+   * Creates the quotas
+   * @param maxWait - the longest a pin waits for the owner to unpin enough pages
+   */
+  explicit PDBPinQuotas(std::chrono::milliseconds maxWait = std::chrono::milliseconds(30000));
+
+  /**
+   * Registers an owner with a quota, an owner can be registered more than once, for example by two jobs of the same
+   * computation running at the same time, the quota is the largest one any of them asked for
+   * @param owner - the owner
+   * @param numBytes - the number of bytes the pages of the owner can take, 0 if they are not limited
+   */
+  void registerOwner(uint64_t owner, uint64_t numBytes);
+
+  /**
+   * Unregisters an owner, the quota is removed once everyone that registered it unregistered it
+   * @param owner - the owner
+   */
+  void unregisterOwner(uint64_t owner);
+
+  /**
+   * Charges the owner for a pin, blocks if the owner would go over its quota. The owners without a quota are never blocked.
+   * @param owner - the owner
+   * @param numBytes - the size of the page we pin
+   * @return true if the owner was charged, false if it stayed over its quota for the maximum wait, it is not charged then
+   */
+  bool acquire(uint64_t owner, uint64_t numBytes);
+
+  /**
+   * Gives back what a pin was charged
+   * @param owner - the owner
+   * @param numBytes - the size of the page we unpinned
+   */
+  void release(uint64_t owner, uint64_t numBytes);
+
+  /**
+   * Returns the number of bytes the pages pinned by an owner take
+   * @param owner - the owner
+   */
+  uint64_t getPinnedBytes(uint64_t owner);
+
+  /**
+   * Returns the owner the pins made on this thread are charged to
+   */
+  static uint64_t getOwner();
+
+  /**
+   * Sets the owner the pins made on this thread are charged to
+   * @param owner - the owner, PDB_NO_PIN_OWNER if they are not charged to anyone
+   */
+  static void setOwner(uint64_t owner);
+
+ private:
+
+  struct PDBPinQuota {
+
+    // how many bytes the pinned pages of the owner can take
+    uint64_t quota = 0;
+
+    // how many bytes they take
+    uint64_t pinned = 0;
+
+    // how many times was the owner registered
+    uint64_t numRegistered = 0;
+  };
+
+  // the quota of each owner
+  std::map<uint64_t, PDBPinQuota> quotas;
+
+  // the longest a pin waits
+  std::chrono::milliseconds maxWait;
+
+  // protects the quotas, the threads that wait for their owner wait on the condition variable
+  std::mutex m;
+  std::condition_variable cv;
+};
+
+/**
+ * Charges the pins made on this thread to an owner while it is in scope, works like @see UseTemporaryAllocationBlock
+ */
+class PDBPinOwnerScope {
+ public:
+
+  explicit PDBPinOwnerScope(uint64_t owner) : previous(PDBPinQuotas::getOwner()) {
+    PDBPinQuotas::setOwner(owner);
+  }
+
+  ~PDBPinOwnerScope() {
+    PDBPinQuotas::setOwner(previous);
+  }
+
+  PDBPinOwnerScope(const PDBPinOwnerScope &) = delete;
+  PDBPinOwnerScope &operator=(const PDBPinOwnerScope &) = delete;
+
+ private:
+
+  // the owner of the thread before the scope
+  uint64_t previous;
+};
+
+}
@@ -433,6 +433,14 @@ void PDBBufferManagerDebugFrontend::registerHandlers(PDBServer &forMe) {
             return ret;
           }));
 
+  forMe.registerHandler(BufGetMappedPageRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufGetMappedPageRequest>>(
+          [&](Handle<BufGetMappedPageRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+            // call the method to handle it, the page does not go through the buffer pool so there is nothing to log
+            return handleGetMappedPageRequest(request, sendUsingMe);
+          }));
+
   forMe.registerHandler(BufGetAnonymousPageRequest_TYPEID,
       make_shared<pdb::HeapRequestHandler<BufGetAnonymousPageRequest>>(
           [&](Handle<BufGetAnonymousPageRequest> request, PDBCommunicatorPtr sendUsingMe) {
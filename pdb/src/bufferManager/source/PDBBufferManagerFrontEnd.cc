@@ -72,6 +72,14 @@ void pdb::PDBBufferManagerFrontEnd::registerHandlers(pdb::PDBServer &forMe) {
         return handleGetPageRequest(request, sendUsingMe);
       }));
 
+  forMe.registerHandler(BufGetMappedPageRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufGetMappedPageRequest>>(
+          [&](Handle<BufGetMappedPageRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+        // call the method to handle it
+        return handleGetMappedPageRequest(request, sendUsingMe);
+      }));
+
   forMe.registerHandler(BufGetAnonymousPageRequest_TYPEID,
       make_shared<pdb::HeapRequestHandler<BufGetAnonymousPageRequest>>(
           [&](Handle<BufGetAnonymousPageRequest> request, PDBCommunicatorPtr sendUsingMe) {
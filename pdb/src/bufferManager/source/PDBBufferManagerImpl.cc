@@ -28,6 +28,8 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <PDBBufferManagerImpl.h>
+#include <Tracing.h>
+#include <PDBMetrics.h>
 
 namespace pdb {
 
@@ -346,6 +348,7 @@ void PDBBufferManagerImpl::clearSet(const PDBSetPtr &set) {
 
     // decrease the number of pinned pages
     numPinned[memLoc]--;
+    PDBMetrics::get().bufferPinnedPages.dec();
     if(numPinned[memLoc] == 0) {
 
       // if by removing the page the constituent pages are empty we can return the whole page back
@@ -409,8 +412,14 @@ void PDBBufferManagerImpl::clearSet(const PDBSetPtr &set) {
   // remove the end of files
   endOfFiles.erase(set);
 
+  // forget the mapped file, the pages that point into it keep it mapped
+  mappedFiles.forget(getSetFilePath(set));
+
   // log the clear set
   logClearSet(set);
+
+  // we might have freed some pages, so notify the ones that wait for space
+  spaceCV.notify_all();
 }
 
 void PDBBufferManagerImpl::registerMiniPage(const PDBPagePtr& registerMe) {
@@ -468,6 +477,7 @@ void PDBBufferManagerImpl::freeAnonymousPage(PDBPagePtr me) {
 
   // reduce the number of pinned pages if pinned
   numPinned[parent] -= me->pinned ? 1 : 0;
+  PDBMetrics::get().bufferPinnedPages.dec(me->pinned ? 1 : 0);
 
   // if we don't have any mini pages on the parent page, we can kill the page
   if(miniPages.empty()) {
@@ -497,6 +507,9 @@ void PDBBufferManagerImpl::freeAnonymousPage(PDBPagePtr me) {
     // log free anonymous page set
     logFreeAnonymousPage(me->whichPage());
 
+    // notify that we have created space
+    spaceCV.notify_all();
+
     // finish this
     return;
   }
@@ -585,15 +598,38 @@ void PDBBufferManagerImpl::createAdditionalMiniPages(int64_t whichSize, unique_l
   // mark that we are creating the page of the requested size
   isCreatingSpace[whichSize] = true;
 
+  // if every page is pinned we wait for one to be unpinned or freed, the pin quotas of the jobs make sure that they
+  // give back their pages. If none is we fail the request instead of waiting forever
+  if (emptyFullPages.empty() && lastUsed.empty()) {
+
+    getLogger()->warn("All the pages in the buffer pool are pinned, waiting for one to be unpinned.");
+    auto gotSpace = spaceCV.wait_for(lock, maxSpaceWait, [&] {
+      return !emptyFullPages.empty() || !lastUsed.empty() || !emptyMiniPages[whichSize].empty();
+    });
+
+    // nothing was unpinned, let the others that wait for this size try again and fail
+    if (!gotSpace) {
+      isCreatingSpace[whichSize] = false;
+      spaceCV.notify_all();
+      getLogger()->error("All the pages in the buffer pool stayed pinned, failing the request.");
+      throw std::runtime_error("All the pages in the buffer pool stayed pinned for " +
+                               std::to_string(maxSpaceWait.count()) + "ms, could not get a page.");
+    }
+
+    // somebody freed a mini page of the size we need, so we don't need to make any
+    if (!emptyMiniPages[whichSize].empty()) {
+      isCreatingSpace[whichSize] = false;
+      spaceCV.notify_all();
+      return;
+    }
+  }
+
   // first, we see if there is a page that we can break up; if not, then make one
   if (emptyFullPages.empty()) {
 
-    // if there are no pages, give a fatal error
-    if (lastUsed.empty()) {
-      std::cerr << "This is really bad.  We seem to have run out of RAM in the storage manager.\n";
-      std::cerr << "I suspect that there are too many pages pinned.\n";
-      exit(1);
-    }
+    // evicting a page is one event on the timeline
+    PDB_TRACE_SCOPE("buffer manager evict");
+    PDBMetrics::get().bufferEvictions.inc();
 
     // find the LRU
     auto pageIt = lastUsed.begin();
@@ -642,6 +678,7 @@ void PDBBufferManagerImpl::createAdditionalMiniPages(int64_t whichSize, unique_l
         // the page is not unloading unlock the buffer manager so we don't stall
         lock.unlock();
 
+        PDBMetrics::get().bufferWritebacks.inc();
         ssize_t write_bytes = pwrite(tempFileFD, a->getBytes(), MIN_PAGE_SIZE << a->getLocation().numBytes, a->getLocation().startPos);
         if (write_bytes == -1) {
           std::cerr << "error in createAdditionalMiniPages when writing anonymous page to disk with errno: "
@@ -661,6 +698,7 @@ void PDBBufferManagerImpl::createAdditionalMiniPages(int64_t whichSize, unique_l
 
           PDBPageInfo myInfo = a->getLocation();
 
+          PDBMetrics::get().bufferWritebacks.inc();
           ssize_t write_bytes = pwrite(fds[a->getSet()], a->getBytes(), MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos);
           if (write_bytes == -1) {
             std::cerr << "error in createAdditionalMiniPages when writing page to disk with errno: " << strerror(errno)
@@ -816,6 +854,7 @@ void PDBBufferManagerImpl::unpin(PDBPagePtr me, unique_lock<mutex> &lock) {
   // and decrement the number of pinned minipages
   if (numPinned[memLoc] > 0) {
     numPinned[memLoc]--;
+    PDBMetrics::get().bufferPinnedPages.dec();
   }
 
   // if the number of pinned minipages is now zero, put into the LRU structure
@@ -829,6 +868,9 @@ void PDBBufferManagerImpl::unpin(PDBPagePtr me, unique_lock<mutex> &lock) {
 
     // increment the time tick
     lastTimeTick++;
+
+    // the page can be evicted now, so notify the ones that wait for space
+    spaceCV.notify_all();
   }
 
   // now that the page is unpinned, we find a physical location for it
@@ -859,10 +901,15 @@ void PDBBufferManagerImpl::pinParent(const PDBPagePtr &me) {
   } else {
     numPinned[whichPage]++;
   }
+
+  // one more page is pinned
+  PDBMetrics::get().bufferPinnedPages.inc();
 }
 
 void PDBBufferManagerImpl::repin(PDBPagePtr me) {
 
+  PDB_TRACE_SCOPE("buffer manager pin");
+
   // lock the buffer manager
   unique_lock<mutex> lock(m);
 
@@ -895,8 +942,15 @@ void PDBBufferManagerImpl::repin(PDBPagePtr me, unique_lock<mutex> &lock) {
   // set the status to loading
   me->status = PDB_PAGE_LOADING;
 
-  // grab space from an empty page
-  me->setBytes(getEmptyMemory(myInfo.numBytes, lock));
+  // grab space from an empty page, if we can not the page stays where it is
+  try {
+    me->setBytes(getEmptyMemory(myInfo.numBytes, lock));
+  }
+  catch (std::runtime_error &) {
+    me->status = PDB_PAGE_NOT_LOADED;
+    pagesCV.notify_all();
+    throw;
+  }
 
   registerMiniPage(me);
   me->setPinned();
@@ -1012,6 +1066,8 @@ PDBPageHandle PDBBufferManagerImpl::getPage(size_t maxBytes) {
 
 PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
 
+  PDB_TRACE_SCOPE_ARG("buffer manager get page", i);
+
   if (!initialized) {
     cerr << "Can't call getMaxPageSize () without initializing the storage manager\n";
     exit(1);
@@ -1033,6 +1089,9 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
   pair<PDBSetPtr, size_t> whichPage = make_pair(whichSet, i);
   if (allPages.find(whichPage) == allPages.end()) {
 
+    // it is not in the buffer pool
+    PDBMetrics::get().bufferPageMisses.inc();
+
     // it is not there, so see if we have previously created it
     if (pageLocations.find(whichPage) == pageLocations.end()) {
 
@@ -1059,8 +1118,16 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
       // mark that we are loading the page
       page->status = PDB_PAGE_LOADING;
 
-      // set the physical address of the page
-      page->setBytes(getEmptyMemory(myInfo.numBytes, lock));
+      // set the physical address of the page, if we can not get any we forget about the page
+      try {
+        page->setBytes(getEmptyMemory(myInfo.numBytes, lock));
+      }
+      catch (std::runtime_error &) {
+        allPages.erase(whichPage);
+        page->status = PDB_PAGE_NOT_LOADED;
+        pagesCV.notify_all();
+        throw;
+      }
 
       // and now that we have the physical we can simply register the page (add it to the constituent pages and pin the parent)
       registerMiniPage(page);
@@ -1107,8 +1174,17 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
       // make a return value
       auto pagerHandle = make_shared<PDBPageHandleBase>(page);
 
-      // grab space from an empty page
-      void *space = getEmptyMemory(myInfo.numBytes, lock);
+      // grab space from an empty page, if we can not get any we forget about the page
+      void *space;
+      try {
+        space = getEmptyMemory(myInfo.numBytes, lock);
+      }
+      catch (std::runtime_error &) {
+        allPages.erase(whichPage);
+        page->status = PDB_PAGE_NOT_LOADED;
+        pagesCV.notify_all();
+        throw;
+      }
 
       // set the physical address of the page
       page->setBytes(space);
@@ -1160,6 +1236,13 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
   // log the get page
   logGetPage(whichSet, i);
 
+  // it is a hit if the page still has its memory, otherwise repin reads it from disk
+  if (page->getBytes() != nullptr) {
+    PDBMetrics::get().bufferPageHits.inc();
+  } else {
+    PDBMetrics::get().bufferPageMisses.inc();
+  }
+
   // it is there, so return it
   repin(page, lock);
 
@@ -1189,6 +1272,54 @@ void *PDBBufferManagerImpl::getEmptyMemory(int64_t pageSize, unique_lock<mutex>
   return space;
 }
 
+PDBPageHandle PDBBufferManagerImpl::getMappedPage(PDBSetPtr whichSet, uint64_t i) {
+
+  // find the page on disk, if it is buffered or was never written we grab it like any other page
+  std::string path;
+  PDBPageInfo location;
+  if (!getMappedPageLocation(whichSet, i, path, location)) {
+    return getPage(whichSet, i);
+  }
+
+  // point into the mapped file, if we can't we grab it like any other page
+  auto page = mappedFiles.getPage(*this, whichSet, i, path, location);
+  return page != nullptr ? page : getPage(whichSet, i);
+}
+
+bool PDBBufferManagerImpl::getMappedPageLocation(const PDBSetPtr &whichSet, uint64_t i, std::string &path, PDBPageInfo &location) {
+
+  if (!initialized || whichSet == nullptr) {
+    return false;
+  }
+
+  // lock the buffer manager
+  std::unique_lock<std::mutex> lock(m);
+
+  // if the page is buffered the file might not have the latest bytes
+  auto whichPage = make_pair(whichSet, i);
+  if (allPages.find(whichPage) != allPages.end()) {
+    return false;
+  }
+
+  // if we never wrote it there is nothing to map
+  auto it = pageLocations.find(whichPage);
+  if (it == pageLocations.end()) {
+    return false;
+  }
+
+  path = getSetFilePath(whichSet);
+  location = it->second;
+  return true;
+}
+
+PDBMappedFiles &PDBBufferManagerImpl::getMappedFiles() {
+  return mappedFiles;
+}
+
+std::string PDBBufferManagerImpl::getSetFilePath(const PDBSetPtr &whichSet) {
+  return storageLoc + "/" + whichSet->getSetName() + "." + whichSet->getDBName();
+}
+
 int PDBBufferManagerImpl::getFileDescriptor(const PDBSetPtr &whichSet) {
 
   // lock the file descriptors structure to grab a descriptor
@@ -1206,7 +1337,7 @@ void PDBBufferManagerImpl::checkIfOpen(PDBSetPtr &whichSet) {
   if (fds.find(whichSet) == fds.end()) {
 
     // open the file
-    string fileLoc = storageLoc + "/" + whichSet->getSetName() + "." + whichSet->getDBName();
+    string fileLoc = getSetFilePath(whichSet);
     int fd = open(fileLoc.c_str(), O_CREAT | O_RDWR, 0666);
     if (fd != -1) {
       fds[whichSet] = fd;
@@ -0,0 +1,208 @@
+#include "PDBMappedFiles.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace pdb {
+
+const uint64_t PDBMappedFile::chunkSize = 64u * 1024u * 1024u;
+
+PDBMappedFile::PDBMappedFile(std::string path) : path(std::move(path)) {
+
+  // open the file for reading
+  fd = open(this->path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return;
+  }
+
+  // remember what file it is
+  struct stat fileInfo{};
+  if (fstat(fd, &fileInfo) == 0) {
+    inode = fileInfo.st_ino;
+  }
+}
+
+PDBMappedFile::~PDBMappedFile() {
+
+  // unmap everything
+  for (auto &chunk : chunks) {
+    munmap(chunk.second, 2 * chunkSize);
+  }
+  for (auto &page : largePages) {
+    munmap(page.second.first, page.second.second);
+  }
+
+  // close the file
+  if (fd != -1) {
+    close(fd);
+  }
+}
+
+bool PDBMappedFile::isOpen() const {
+  return fd != -1;
+}
+
+void *PDBMappedFile::getBytes(uint64_t startPos, uint64_t numBytes) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // check that the file has the bytes, we never hand out bytes past its end
+  struct stat fileInfo{};
+  if (fd == -1 || fstat(fd, &fileInfo) != 0 || (uint64_t) fileInfo.st_size < startPos + numBytes) {
+    return nullptr;
+  }
+
+  // the os page the bytes start at, mappings have to start there
+  auto osPageSize = (uint64_t) sysconf(_SC_PAGESIZE);
+  auto alignedStart = startPos - startPos % osPageSize;
+
+  char *bytes;
+  if (numBytes <= chunkSize) {
+
+    // the page fits into the chunk it starts in, map the chunk if this is the first page in it
+    auto chunk = startPos / chunkSize;
+    auto it = chunks.find(chunk);
+    if (it == chunks.end()) {
+      auto mapping = map(chunk * chunkSize, 2 * chunkSize);
+      if (mapping == nullptr) {
+        return nullptr;
+      }
+      it = chunks.emplace(chunk, mapping).first;
+    }
+    bytes = it->second + (startPos - chunk * chunkSize);
+  } else {
+
+    // the page is too large for a chunk, it gets its own mapping that we reuse every time it is asked for
+    auto size = (size_t) (numBytes + (startPos - alignedStart));
+    auto it = largePages.find(startPos);
+    if (it == largePages.end()) {
+      auto mapping = map(alignedStart, size);
+      if (mapping == nullptr) {
+        return nullptr;
+      }
+      it = largePages.emplace(startPos, std::make_pair(mapping, size)).first;
+    }
+
+    // a larger page at the same position, we can not move the mapping since there could be pages that point into it
+    if (it->second.second < size) {
+      return nullptr;
+    }
+    bytes = it->second.first + (startPos - alignedStart);
+  }
+
+  // tell the kernel to start reading the page, the start has to be aligned to the os page
+  madvise(bytes - (startPos - alignedStart), numBytes + (startPos - alignedStart), MADV_WILLNEED);
+
+  return bytes;
+}
+
+char *PDBMappedFile::map(uint64_t offset, size_t size) {
+
+  // map it read-only, the mapping can go past the end of the file, those bytes show up when the file grows
+  auto bytes = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, (off_t) offset);
+  if (bytes == MAP_FAILED) {
+    return nullptr;
+  }
+
+  // the scans read the pages one after another
+  madvise(bytes, size, MADV_SEQUENTIAL);
+  return (char *) bytes;
+}
+
+size_t PDBMappedFile::getNumMappings() {
+  std::unique_lock<std::mutex> lck(m);
+  return chunks.size() + largePages.size();
+}
+
+const std::string &PDBMappedFile::getPath() const {
+  return path;
+}
+
+uint64_t PDBMappedFile::getInode() const {
+  return inode;
+}
+
+uint64_t PDBMappedFile::getNumPinned() const {
+  return numPinned;
+}
+
+PDBPageHandle PDBMappedFiles::getPage(PDBBufferManagerInterface &parent, const PDBSetPtr &whichSet, uint64_t i,
+                                      const std::string &path, const PDBPageInfo &location) {
+
+  /// 1. Find the mapped file, if the file on the path was replaced we map the new one
+
+  PDBMappedFilePtr file;
+  {
+    std::unique_lock<std::mutex> lck(m);
+
+    struct stat fileInfo{};
+    if (stat(path.c_str(), &fileInfo) != 0) {
+      return nullptr;
+    }
+
+    auto it = files.find(path);
+    if (it == files.end() || it->second->getInode() != (uint64_t) fileInfo.st_ino) {
+      files[path] = std::make_shared<PDBMappedFile>(path);
+      it = files.find(path);
+    }
+    file = it->second;
+  }
+
+  /// 2. Grab the bytes of the page
+
+  auto numBytes = (uint64_t) MIN_PAGE_SIZE << location.numBytes;
+  auto bytes = file->isOpen() ? file->getBytes((uint64_t) location.startPos, numBytes) : nullptr;
+  if (bytes == nullptr) {
+    return nullptr;
+  }
+
+  /// 3. Make a page that points into the file, it is pinned and clean
+
+  auto page = make_shared<PDBPage>(parent);
+  page->setMe(page);
+  page->setSet(whichSet);
+  page->setPageNum(i);
+  page->setAnonymous(false);
+  page->setPinned();
+  page->setClean();
+  page->freezeSize();
+  page->getLocation() = location;
+  page->setBytes(bytes);
+  page->status = PDB_PAGE_LOADED;
+  page->mappedFile = file;
+
+  // count it
+  file->numPinned++;
+  numMappedPages++;
+  numMappedBytes += numBytes;
+
+  return make_shared<PDBPageHandleBase>(page);
+}
+
+void PDBMappedFiles::forget(const std::string &path) {
+  std::unique_lock<std::mutex> lck(m);
+  files.erase(path);
+}
+
+uint64_t PDBMappedFiles::getNumMappedPages() const {
+  return numMappedPages;
+}
+
+uint64_t PDBMappedFiles::getNumMappedBytes() const {
+  return numMappedBytes;
+}
+
+uint64_t PDBMappedFiles::getNumPinnedPages() {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // sum up the pinned pages of every file
+  uint64_t numPinned = 0;
+  for (auto &file : files) {
+    numPinned += file.second->getNumPinned();
+  }
+  return numPinned;
+}
+
+}
@@ -17,6 +17,7 @@
 #include "PDBBufferManagerImpl.h"
 #include "PDBPage.h"
 #include "PDBSet.h"
+#include "PDBMappedFiles.h"
 
 namespace pdb {
 
@@ -45,6 +46,15 @@ void PDBPage :: decRefCount () {
 	// did the reference count fall to zero
 	if (refCount == 0) {
 
+		// a mapped page is not known to the buffer manager, we just stop counting it as pinned
+		if (mappedFile != nullptr) {
+			if (pinned) {
+				pinned = false;
+				mappedFile->numPinned--;
+			}
+			return;
+		}
+
 		// unlock the reference count
 		blockLck.unlock();
 
@@ -64,6 +74,12 @@ size_t PDBPage :: whichPage () {
 }
 
 void PDBPage :: freezeSize (size_t numBytes) {
+
+	// a mapped page is read-only, its size is what it is
+	if (mappedFile != nullptr) {
+		return;
+	}
+
 	auto spMe = me.lock();
 	parent.freezeSize (spMe, numBytes);
 }
@@ -89,15 +105,41 @@ void PDBPage :: setMe (PDBPagePtr toMe) {
 }
 
 void PDBPage :: unpin () {
+
+	// a mapped page stays where it is, we only count it
+	if (mappedFile != nullptr) {
+		unique_lock<mutex> blockLck(lk);
+		if (pinned) {
+			pinned = false;
+			mappedFile->numPinned--;
+		}
+		return;
+	}
+
 	auto spMe = me.lock();
 	parent.unpin (spMe);
 }
 
 void PDBPage :: repin () {
+
+	// a mapped page stays where it is, we only count it
+	if (mappedFile != nullptr) {
+		unique_lock<mutex> blockLck(lk);
+		if (!pinned) {
+			pinned = true;
+			mappedFile->numPinned++;
+		}
+		return;
+	}
+
 	auto spMe = me.lock();
 	parent.repin (spMe);
 }
 
+bool PDBPage :: isMapped () {
+	return mappedFile != nullptr;
+}
+
 void PDBPage :: setSet (PDBSetPtr inPtr) {
 	whichSet = std::move(inPtr);
 }
@@ -0,0 +1,109 @@
+#include "PDBPinQuotas.h"
+#include <algorithm>
+
+namespace pdb {
+
+namespace {
+
+// the owner of the pins made on this thread
+thread_local uint64_t pinOwner = PDB_NO_PIN_OWNER;
+
+}
+
+PDBPinQuotas::PDBPinQuotas(std::chrono::milliseconds maxWait) : maxWait(maxWait) {}
+
+void PDBPinQuotas::registerOwner(uint64_t owner, uint64_t numBytes) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // the largest quota wins
+  auto &quota = quotas[owner];
+  quota.quota = std::max(quota.quota, numBytes);
+  quota.numRegistered++;
+
+  // a larger quota might let somebody through
+  cv.notify_all();
+}
+
+void PDBPinQuotas::unregisterOwner(uint64_t owner) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // find the owner
+  auto it = quotas.find(owner);
+  if (it == quotas.end()) {
+    return;
+  }
+
+  // remove it if nobody needs it anymore
+  if (--it->second.numRegistered == 0) {
+    quotas.erase(it);
+  }
+
+  // the ones that wait for it are not limited anymore
+  cv.notify_all();
+}
+
+bool PDBPinQuotas::acquire(uint64_t owner, uint64_t numBytes) {
+
+  // nobody to charge
+  if (owner == PDB_NO_PIN_OWNER) {
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // wait until the owner has space for the page or it has no quota, a quota of 0 is no limit
+  auto fits = [&] {
+    auto it = quotas.find(owner);
+    return it == quotas.end() || it->second.quota == 0 || it->second.pinned == 0 || it->second.pinned + numBytes <= it->second.quota;
+  };
+  if (!cv.wait_for(lck, maxWait, fits)) {
+    return false;
+  }
+
+  // charge the owner if it has a quota
+  auto it = quotas.find(owner);
+  if (it != quotas.end()) {
+    it->second.pinned += numBytes;
+  }
+
+  return true;
+}
+
+void PDBPinQuotas::release(uint64_t owner, uint64_t numBytes) {
+
+  // nobody was charged
+  if (owner == PDB_NO_PIN_OWNER) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // give back the bytes if the owner is still there
+  auto it = quotas.find(owner);
+  if (it != quotas.end()) {
+    it->second.pinned -= std::min(it->second.pinned, numBytes);
+  }
+
+  // somebody might fit now
+  cv.notify_all();
+}
+
+uint64_t PDBPinQuotas::getPinnedBytes(uint64_t owner) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  auto it = quotas.find(owner);
+  return it == quotas.end() ? 0 : it->second.pinned;
+}
+
+uint64_t PDBPinQuotas::getOwner() {
+  return pinOwner;
+}
+
+void PDBPinQuotas::setOwner(uint64_t owner) {
+  pinOwner = owner;
+}
+
+}
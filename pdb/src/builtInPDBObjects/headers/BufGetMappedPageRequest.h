@@ -0,0 +1,71 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef BUF_GET_MAPPED_PAGE_REQ_H
+#define BUF_GET_MAPPED_PAGE_REQ_H
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "BufManagerRequestBase.h"
+
+// PRELOAD %BufGetMappedPageRequest%
+
+namespace pdb {
+
+// encapsulates a request to find where a page of a set is on disk so that the backend can map it
+class BufGetMappedPageRequest : public BufManagerRequestBase {
+
+public:
+
+  BufGetMappedPageRequest() = default;
+
+  ~BufGetMappedPageRequest() = default;
+
+  BufGetMappedPageRequest(const std::string &setName, const std::string &dbName, uint64_t pageNumber) : setName(setName),
+                                                                                                       dbName(dbName),
+                                                                                                       pageNumber(pageNumber) {}
+
+  explicit BufGetMappedPageRequest(const pdb::Handle<BufGetMappedPageRequest>& copyMe) : BufManagerRequestBase(*copyMe) {
+
+    // copy stuff
+    setName = copyMe->setName;
+    dbName = copyMe->dbName;
+    pageNumber = copyMe->pageNumber;
+  }
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * The name of the set we are requesting the page for
+   */
+  String setName;
+
+  /**
+   * The name of the database we are requesting the page for
+   */
+  String dbName;
+
+  /**
+   * The page number
+   */
+  uint64_t pageNumber = 0;
+};
+}
+
+#endif
@@ -0,0 +1,62 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef BUF_GET_MAPPED_PAGE_RESULT_H
+#define BUF_GET_MAPPED_PAGE_RESULT_H
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "DeepCopy.h"
+
+// PRELOAD %BufGetMappedPageResult%
+
+namespace pdb {
+
+// tells the backend where a page of a set is on disk, if it can be mapped
+class BufGetMappedPageResult : public Object {
+
+public:
+
+  BufGetMappedPageResult() = default;
+
+  BufGetMappedPageResult(bool success, const std::string &path, const uint64_t &startPos, const int64_t &numBytes)
+      : success(success),
+        path(path),
+        startPos(startPos),
+        numBytes(numBytes) {}
+
+  ~BufGetMappedPageResult() = default;
+
+  ENABLE_DEEP_COPY
+
+  // is the page on disk and not buffered, if not it has to be grabbed like any other page
+  bool success = false;
+
+  // the path of the file of the set
+  pdb::String path;
+
+  // the start position in the file
+  uint64_t startPos = 0;
+
+  // the size of the page
+  int64_t numBytes = 0;
+};
+}
+
+#endif
@@ -35,11 +35,19 @@ public:
     CSExecuteComputation() = default;
     ~CSExecuteComputation() = default;
 
-    CSExecuteComputation(Handle<Vector<Handle<Computation>>> &computations, const String &tcapString, size_t numBytes) {
+    CSExecuteComputation(Handle<Vector<Handle<Computation>>> &computations, const String &tcapString, size_t numBytes,
+                         int32_t priority = 0, uint64_t memoryBudget = 0, uint64_t preparedID = 0) {
 
       // set the num bytes
       this->numBytes = numBytes;
 
+      // the query the manager already has the TCAP of, if any
+      this->preparedID = preparedID;
+
+      // set how the computation is scheduled
+      this->priority = priority;
+      this->memoryBudget = memoryBudget;
+
       // store the string
       this->tcapString = tcapString;
 
@@ -55,10 +63,15 @@ public:
     ENABLE_DEEP_COPY
 
     /**
-     * The tcap string associated with the computations
+     * The tcap string associated with the computations, empty if the query was prepared
      */
     String tcapString;
 
+    /**
+     * The id of the prepared query whose TCAP we run, 0 if the TCAP is in the request @see CSPrepareComputation
+     */
+    uint64_t preparedID = 0;
+
     /**
      * The computations
      */
@@ -68,6 +81,16 @@ public:
      * How large should the allocation block be to store the computations
      */
     size_t numBytes;
+
+    /**
+     * The computations with a higher priority are admitted first
+     */
+    int32_t priority = 0;
+
+    /**
+     * How many bytes of the buffer pool of each node the computation can pin, 0 for an equal share
+     */
+    uint64_t memoryBudget = 0;
 };
 }
 
@@ -0,0 +1,43 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "PDBString.h"
+
+// PRELOAD %CSPrepareComputation%
+
+namespace pdb {
+
+// a request to keep the TCAP of a query on the manager, so it can be run many times by its id
+class CSPrepareComputation : public Object {
+
+public:
+
+  CSPrepareComputation() = default;
+
+  explicit CSPrepareComputation(const std::string &tcapString) : tcapString(tcapString) {}
+
+  ENABLE_DEEP_COPY
+
+  // the TCAP of the query
+  pdb::String tcapString;
+};
+
+}
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "PDBString.h"
+
+// PRELOAD %CSPrepareComputationResult%
+
+namespace pdb {
+
+// the result of preparing a query, the id the query is run by @see CSExecuteComputation::preparedID
+class CSPrepareComputationResult : public Object {
+
+public:
+
+  CSPrepareComputationResult() = default;
+
+  CSPrepareComputationResult(bool success, const std::string &error, uint64_t preparedID) : success(success),
+                                                                                             error(error),
+                                                                                             preparedID(preparedID) {}
+
+  ENABLE_DEEP_COPY
+
+  // did we succeed
+  bool success = false;
+
+  // the error if we did not, the TCAP does not parse for example
+  pdb::String error;
+
+  // the id of the prepared query, 0 if we failed
+  uint64_t preparedID = 0;
+};
+
+}
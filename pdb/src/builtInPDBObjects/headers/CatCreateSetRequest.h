@@ -22,6 +22,7 @@
 #include "Object.h"
 #include "PDBString.h"
 #include "Handle.h"
+#include "PDBCatalogSet.h"
 
 // PRELOAD %CatCreateSetRequest%
 
@@ -39,11 +40,37 @@ class CatCreateSetRequest : public Object {
                       const std::string &typeName,
                       int16_t typeID) : dbName(dbName), setName(setName), typeName(typeName), typeID(typeID) {}
 
+  CatCreateSetRequest(const std::string &dbName,
+                      const std::string &setName,
+                      const std::string &typeName,
+                      int16_t typeID,
+                      PDBCatalogSetPartitionType partitionType,
+                      int32_t numPartitions,
+                      const std::string &partitionKey,
+                      const std::string &partitionGroup,
+                      const std::string &partitionBoundaries,
+                      const std::string &storageCodec = "none") : dbName(dbName),
+                                                                setName(setName),
+                                                                typeName(typeName),
+                                                                typeID(typeID),
+                                                                partitionType(partitionType),
+                                                                numPartitions(numPartitions),
+                                                                partitionKey(partitionKey),
+                                                                partitionGroup(partitionGroup),
+                                                                partitionBoundaries(partitionBoundaries),
+                                                                storageCodec(storageCodec) {}
+
   explicit CatCreateSetRequest(const Handle<CatCreateSetRequest> &requestToCopy) {
     dbName = requestToCopy->dbName;
     setName = requestToCopy->setName;
     typeName = requestToCopy->typeName;
     typeID = requestToCopy->typeID;
+    partitionType = requestToCopy->partitionType;
+    numPartitions = requestToCopy->numPartitions;
+    partitionKey = requestToCopy->partitionKey;
+    partitionGroup = requestToCopy->partitionGroup;
+    partitionBoundaries = requestToCopy->partitionBoundaries;
+    storageCodec = requestToCopy->storageCodec;
   }
 
   ENABLE_DEEP_COPY
@@ -67,6 +94,36 @@ class CatCreateSetRequest : public Object {
    * The type id
    */
   int16_t typeID = -1;
+
+  /**
+   * How the records of the set are placed on the workers
+   */
+  PDBCatalogSetPartitionType partitionType = PDB_CATALOG_SET_NO_PARTITIONING;
+
+  /**
+   * The number of partitions
+   */
+  int32_t numPartitions = 0;
+
+  /**
+   * The attribute or method the records are partitioned on
+   */
+  String partitionKey;
+
+  /**
+   * The co-partitioning group of the set
+   */
+  String partitionGroup;
+
+  /**
+   * The upper boundaries of the ranges, separated by a comma
+   */
+  String partitionBoundaries;
+
+  /**
+   * The codec the pages of the set are stored with
+   */
+  String storageCodec;
 };
 
 }
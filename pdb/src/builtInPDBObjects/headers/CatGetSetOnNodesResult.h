@@ -0,0 +1,82 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+#include "PDBCatalogSetOnNode.h"
+
+// PRELOAD %CatGetSetOnNodesResult%
+
+namespace pdb {
+
+/**
+ * How much of a set is stored on each node, the nodes that never stored any of the set are not included
+ */
+class CatGetSetOnNodesResult : public Object {
+
+ public:
+
+  CatGetSetOnNodesResult() = default;
+  ~CatGetSetOnNodesResult() = default;
+
+  explicit CatGetSetOnNodesResult(const std::vector<PDBCatalogSetOnNodePtr> &setOnNodes) {
+
+    // copy the stuff
+    for(const auto &setOnNode : setOnNodes) {
+      nodeIDs.push_back(setOnNode->nodeID);
+      setSizes.push_back(setOnNode->setSize);
+      numPages.push_back(setOnNode->numPages);
+    }
+  }
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * Converts the result into the catalog objects
+   * @param setIdentifier - the identifier of the set "dbName:setName"
+   * @return the size of the set on each node
+   */
+  std::vector<PDBCatalogSetOnNodePtr> toSetOnNodes(const std::string &setIdentifier) {
+
+    std::vector<PDBCatalogSetOnNodePtr> ret;
+    for(int i = 0; i < nodeIDs.size(); ++i) {
+      ret.emplace_back(std::make_shared<PDBCatalogSetOnNode>(setIdentifier, nodeIDs[i], setSizes[i], numPages[i]));
+    }
+
+    return std::move(ret);
+  }
+
+  /**
+   * The ids of the nodes
+   */
+  Vector<String> nodeIDs;
+
+  /**
+   * For each node the number of bytes of the set it has
+   */
+  Vector<uint64_t> setSizes;
+
+  /**
+   * For each node the number of pages of the set it has
+   */
+  Vector<uint64_t> numPages;
+};
+}
@@ -54,6 +54,37 @@ class CatGetSetResult : public Object {
                                                                               containerType(containerType),
                                                                               setSize(setSize) {}
 
+  /**
+   * Creates the result from the set in the catalog
+   * @param set - the set
+   */
+  explicit CatGetSetResult(const PDBCatalogSet &set) : CatGetSetResult(set.database,
+                                                                       set.name,
+                                                                       *set.type,
+                                                                       *set.type,
+                                                                       set.setSize,
+                                                                       (PDBCatalogSetContainerType) set.containerType) {
+    partitionType = (PDBCatalogSetPartitionType) set.partitionType;
+    numPartitions = set.numPartitions;
+    partitionKey = set.partitionKey;
+    partitionGroup = set.partitionGroup;
+    partitionBoundaries = set.partitionBoundaries;
+    partitionNodes = set.partitionNodes;
+    storageCodec = set.storageCodec;
+  }
+
+  /**
+   * Converts the result back to a catalog set
+   * @return the set
+   */
+  PDBCatalogSetPtr toCatalogSet() {
+    auto set = std::make_shared<PDBCatalogSet>(databaseName, setName, type, setSize, containerType);
+    set->setPartitioning(partitionType, numPartitions, partitionKey, partitionGroup, partitionBoundaries);
+    set->partitionNodes = partitionNodes;
+    set->storageCodec = storageCodec;
+    return set;
+  }
+
   ENABLE_DEEP_COPY
 
   /**
@@ -86,6 +117,41 @@ class CatGetSetResult : public Object {
    * The type of the container that are stored on the pages of this set
    */
   PDBCatalogSetContainerType containerType;
+
+  /**
+   * How the records of the set are placed on the workers
+   */
+  PDBCatalogSetPartitionType partitionType = PDB_CATALOG_SET_NO_PARTITIONING;
+
+  /**
+   * The number of partitions
+   */
+  int32_t numPartitions = 0;
+
+  /**
+   * The attribute or method the records are partitioned on
+   */
+  String partitionKey;
+
+  /**
+   * The co-partitioning group of the set
+   */
+  String partitionGroup;
+
+  /**
+   * The upper boundaries of the ranges, separated by a comma
+   */
+  String partitionBoundaries;
+
+  /**
+   * The ids of the nodes the partitions are placed on separated by a comma
+   */
+  String partitionNodes;
+
+  /**
+   * The codec the pages of the set are stored with
+   */
+  String storageCodec;
 };
 }
 
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include <PDBCatalogSet.h>
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+
+// PRELOAD %CatSetUpdatePartitionNodesRequest%
+
+namespace pdb {
+
+/**
+ * Encapsulates a request to update the nodes the partitions of a set are placed on
+ */
+class CatSetUpdatePartitionNodesRequest : public Object {
+
+ public:
+
+  CatSetUpdatePartitionNodesRequest() = default;
+  ~CatSetUpdatePartitionNodesRequest() = default;
+
+  /**
+   * Creates a request to update the partition nodes of a set
+   * @param database - the name of database
+   * @param set - the name of the set
+   * @param partitionNodes - the ids of the nodes separated by a comma
+   */
+  explicit CatSetUpdatePartitionNodesRequest(const std::string &database,
+                                             const std::string &set,
+                                             const std::string &partitionNodes) : databaseName(database),
+                                                                                  setName(set),
+                                                                                  partitionNodes(partitionNodes) {}
+
+  /**
+   * Copy the request this is needed by the broadcast
+   * @param pdbItemToCopy - the request to copy
+   */
+  explicit CatSetUpdatePartitionNodesRequest(const Handle<CatSetUpdatePartitionNodesRequest>& pdbItemToCopy) {
+
+    // copy the thing
+    databaseName = pdbItemToCopy->databaseName;
+    setName = pdbItemToCopy->setName;
+    partitionNodes = pdbItemToCopy->partitionNodes;
+  }
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * The name of the database
+   */
+  String databaseName;
+
+  /**
+   * The name of the set
+   */
+  String setName;
+
+  /**
+   * The ids of the nodes the partitions are placed on separated by a comma
+   */
+  String partitionNodes;
+};
+}
\ No newline at end of file
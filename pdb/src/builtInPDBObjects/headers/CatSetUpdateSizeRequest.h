@@ -43,6 +43,17 @@ class CatSetUpdateSizeRequest : public Object {
   explicit CatSetUpdateSizeRequest(const std::string &database, const std::string &set, size_t sizeUpdate) :
                                    databaseName(database), setName(set), sizeUpdate(sizeUpdate) {}
 
+  /**
+   * Creates a request to update the size of the set that also says what node stored the data
+   * @param database - the name of database
+   * @param set - the name of the set
+   * @param sizeUpdate - the size of the update in bytes
+   * @param nodeID - the node that stored the data
+   * @param pageUpdate - the number of pages the node stored
+   */
+  CatSetUpdateSizeRequest(const std::string &database, const std::string &set, size_t sizeUpdate, const std::string &nodeID, size_t pageUpdate) :
+                          databaseName(database), setName(set), sizeUpdate(sizeUpdate), nodeID(nodeID), pageUpdate(pageUpdate) {}
+
   /**
    * Copy the request this is needed by the broadcast
    * @param pdbItemToCopy - the request to copy
@@ -53,6 +64,8 @@ class CatSetUpdateSizeRequest : public Object {
     databaseName = pdbItemToCopy->databaseName;
     setName = pdbItemToCopy->setName;
     sizeUpdate = pdbItemToCopy->sizeUpdate;
+    nodeID = pdbItemToCopy->nodeID;
+    pageUpdate = pdbItemToCopy->pageUpdate;
   }
 
   ENABLE_DEEP_COPY
@@ -71,5 +84,15 @@ class CatSetUpdateSizeRequest : public Object {
    * The size of the update in bytes
    */
   size_t sizeUpdate;
+
+  /**
+   * The node that stored the data, empty if we don't know it
+   */
+  String nodeID;
+
+  /**
+   * The number of pages the node stored
+   */
+  size_t pageUpdate = 0;
 };
 }
\ No newline at end of file
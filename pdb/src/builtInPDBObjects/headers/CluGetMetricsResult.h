@@ -0,0 +1,54 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+
+// PRELOAD %CluGetMetricsResult%
+
+namespace pdb {
+
+/**
+ * The metrics of a node @see PDBMetrics
+ */
+class CluGetMetricsResult : public Object {
+public:
+
+  CluGetMetricsResult() = default;
+
+  ~CluGetMetricsResult() = default;
+
+  explicit CluGetMetricsResult(const std::vector<double> &values, const std::string &text) : values(values.size(), values.size()), text(text) {
+    for(size_t i = 0; i < values.size(); ++i) {
+      this->values[i] = values[i];
+    }
+  }
+
+  ENABLE_DEEP_COPY
+
+  // the sample of the metrics of the process that handled the request
+  pdb::Vector<double> values;
+
+  // the metrics of the whole node in the prometheus text format, only the frontend fills this in
+  pdb::String text;
+};
+
+}
@@ -0,0 +1,74 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+
+// PRELOAD %DisGetIngestLease%
+
+namespace pdb {
+
+// encapsulates a request for the workers a client can send the pages of a set to directly, without going through the manager
+class DisGetIngestLease : public Object {
+
+public:
+
+  DisGetIngestLease() = default;
+  ~DisGetIngestLease() = default;
+
+  DisGetIngestLease(const std::string &databaseName, const std::string &setName, const std::string &typeName, const std::vector<uint64_t> &sizes)
+      : databaseName(databaseName), setName(setName), typeName(typeName), numPages(sizes.size()) {
+
+    // copy the sizes of the pages
+    for(auto size : sizes) {
+      pageSizes.push_back(size);
+    }
+  }
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * The name of the database the set belongs to
+   */
+  String databaseName;
+
+  /**
+   * The name of the set we are adding the data to
+   */
+  String setName;
+
+  /**
+   * The name of the type we are adding
+   */
+  String typeName;
+
+  /**
+   * The number of pages the client wants to send
+   */
+  uint64_t numPages = 0;
+
+  /**
+   * The uncompressed size of each page the client wants to send, so that the pages can be placed by their size
+   */
+  Vector<uint64_t> pageSizes;
+};
+
+}
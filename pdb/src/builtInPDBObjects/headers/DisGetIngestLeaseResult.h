@@ -0,0 +1,127 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+#include "PDBCatalogSet.h"
+
+// PRELOAD %DisGetIngestLeaseResult%
+
+namespace pdb {
+
+// the workers a client is allowed to send the pages of a set to and how many pages each of them takes
+class DisGetIngestLeaseResult : public Object {
+
+public:
+
+  DisGetIngestLeaseResult() = default;
+  ~DisGetIngestLeaseResult() = default;
+
+  DisGetIngestLeaseResult(bool success, const std::string &error) : success(success), error(error) {}
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * Adds a node to the lease
+   * @param address - the address of the node
+   * @param port - the port of the node
+   * @param quota - the number of pages the node takes
+   */
+  void addNode(const std::string &address, int32_t port, uint64_t quota) {
+    nodeAddresses.push_back(address);
+    nodePorts.push_back(port);
+    quotas.push_back(quota);
+  }
+
+  /**
+   * The addresses of the nodes
+   */
+  Vector<String> nodeAddresses;
+
+  /**
+   * The ports of the nodes
+   */
+  Vector<int32_t> nodePorts;
+
+  /**
+   * For each node the number of pages it takes
+   */
+  Vector<uint64_t> quotas;
+
+  /**
+   * For each page in the request the index of the node it goes to
+   */
+  Vector<uint32_t> pageNodes;
+
+  /**
+   * If the set is partitioned the client places each record by its key, the partitions are assigned to the nodes in
+   * the order they are in the lease and the quotas do not matter
+   */
+  PDBCatalogSetPartitionType partitionType = PDB_CATALOG_SET_NO_PARTITIONING;
+
+  /**
+   * The number of partitions of the set
+   */
+  int32_t numPartitions = 0;
+
+  /**
+   * The name of the attribute or method the records of the set are partitioned on, the key the client extracts has to
+   * be the same
+   */
+  String partitionKey;
+
+  /**
+   * The upper boundaries of the ranges separated by a comma, if the set is range partitioned
+   */
+  String partitionBoundaries;
+
+  /**
+   * The container type of the set, if it is columnar the client writes the pages column by column @see PDBColumnarPage
+   */
+  PDBCatalogSetContainerType containerType = PDB_CATALOG_SET_VECTOR_CONTAINER;
+
+  /**
+   * The name of the codec the client compresses the pages with @see PDBCodec
+   */
+  String codec;
+
+  /**
+   * The id of the lease, the client sends it with every page and returns the lease with it once it is done
+   */
+  uint64_t leaseID = 0;
+
+  /**
+   * The number of seconds after which the lease expires if the client does not return it
+   */
+  uint64_t timeout = 0;
+
+  /**
+   * Did we get the lease
+   */
+  bool success = false;
+
+  /**
+   * The error if we did not
+   */
+  String error;
+};
+
+}
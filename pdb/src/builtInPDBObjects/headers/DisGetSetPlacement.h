@@ -0,0 +1,52 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+
+// PRELOAD %DisGetSetPlacement%
+
+namespace pdb {
+
+// encapsulates a request to get the nodes and pages of a set, so that they can be grabbed from the workers directly
+class DisGetSetPlacement : public Object {
+
+public:
+
+  DisGetSetPlacement() = default;
+  ~DisGetSetPlacement() = default;
+
+  DisGetSetPlacement(const std::string &databaseName, const std::string &setName) : databaseName(databaseName), setName(setName) {}
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * The name of the database the set belongs to
+   */
+  String databaseName;
+
+  /**
+   * The name of the set we want the placement for
+   */
+  String setName;
+};
+
+}
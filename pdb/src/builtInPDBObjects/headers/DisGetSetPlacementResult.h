@@ -0,0 +1,91 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+
+// PRELOAD %DisGetSetPlacementResult%
+
+namespace pdb {
+
+// the nodes a set is stored on and the pages each of them has
+class DisGetSetPlacementResult : public Object {
+
+public:
+
+  DisGetSetPlacementResult() = default;
+  ~DisGetSetPlacementResult() = default;
+
+  explicit DisGetSetPlacementResult(bool success) : success(success) {}
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * Reserves the space for the nodes and the pages, so that adding them does not grow the vectors in the
+   * allocation block
+   * @param numNodes - the number of nodes we are going to add
+   * @param numPages - the number of pages we are going to add
+   */
+  void reserve(uint32_t numNodes, uint32_t numPages) {
+    nodeAddresses.reserve(numNodes);
+    nodePorts.reserve(numNodes);
+    pageNodes.reserve(numPages);
+    pages.reserve(numPages);
+  }
+
+  /**
+   * Adds a page that is stored on a node
+   * @param node - the index of the node in nodeAddresses and nodePorts
+   * @param page - the number of the page on that node
+   */
+  void addPage(uint32_t node, uint64_t page) {
+    pageNodes.push_back(node);
+    pages.push_back(page);
+  }
+
+  /**
+   * The addresses of the nodes
+   */
+  Vector<String> nodeAddresses;
+
+  /**
+   * The ports of the nodes
+   */
+  Vector<int32_t> nodePorts;
+
+  /**
+   * For each page the index of the node it is stored on
+   */
+  Vector<uint32_t> pageNodes;
+
+  /**
+   * For each page the number of the page on its node
+   */
+  Vector<uint64_t> pages;
+
+  /**
+   * Did we succeed in getting the placement
+   */
+  bool success = false;
+};
+
+}
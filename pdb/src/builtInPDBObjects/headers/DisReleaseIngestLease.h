@@ -0,0 +1,46 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+
+// PRELOAD %DisReleaseIngestLease%
+
+namespace pdb {
+
+// sent by the client once it is done sending the pages of an ingest lease, so the manager can unlock the set
+class DisReleaseIngestLease : public Object {
+
+public:
+
+  DisReleaseIngestLease() = default;
+  ~DisReleaseIngestLease() = default;
+
+  explicit DisReleaseIngestLease(uint64_t leaseID) : leaseID(leaseID) {}
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * The id of the lease we are returning
+   */
+  uint64_t leaseID = 0;
+};
+
+}
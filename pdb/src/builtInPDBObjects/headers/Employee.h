@@ -81,6 +81,20 @@ public:
     bool operator==(Employee& me) const {
         return name == me.name;
     }
+
+    // the columns an employee has when it is stored in a columnar set @see PDBColumns
+    template<class Columns>
+    static void getColumns(Columns& columns) {
+        columns.add("name", &Employee::name);
+        columns.add("age", &Employee::age);
+        columns.add("salary", &Employee::salary);
+        columns.add("department", &Employee::department);
+        columns.method("hash", { "name" });
+        columns.method("getName", { "name" });
+        columns.method("isFrank", { "name" });
+        columns.method("getAge", { "age" });
+        columns.method("getSalary", { "salary" });
+    }
 };
 }
 
@@ -59,11 +59,29 @@ public:
    */
   uint64_t numberOfProcessingThreads;
 
+  /**
+   * How many bytes of the buffer pool the computation can pin on each node
+   */
+  uint64_t memoryBudget;
+
   /**
    * The number of nodes
    */
   uint64_t numberOfNodes;
 
+  /**
+   * True if the computation is small enough to run on a single node, the scans then gather the pages of the sets
+   * from all the workers instead of reading only the ones stored on this node
+   */
+  bool gatherSets;
+
+  /**
+   * If the job runs an incremental aggregation this is the generation of the output it makes, 0 otherwise. The first
+   * generation is computed from the whole input, every one after it aggregates just the pages that were added to the
+   * input and merges them into the output of the generation before it. Either way the output replaces the one before.
+   */
+  uint64_t incrementalGeneration = 0;
+
   /**
    * Nodes that are used for this job, just a bunch of IP
    */
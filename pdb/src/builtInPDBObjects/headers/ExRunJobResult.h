@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+#include "PDBProfileEntry.h"
+#include "PDBTrace.h"
+
+// PRELOAD %ExRunJobResult%
+
+namespace pdb {
+
+// the result of running a job on a node, with the profile of the operators that ran on it
+class ExRunJobResult : public Object {
+
+public:
+
+  ExRunJobResult() = default;
+
+  ExRunJobResult(bool success, const std::string &error) : success(success), error(error) {}
+
+  ENABLE_DEEP_COPY
+
+  // did we succeed
+  bool success = false;
+
+  // the error if we did not
+  pdb::String error;
+
+  // the operators in tree order @see PDBProfile
+  pdb::Vector<pdb::Handle<PDBProfileEntry>> profile;
+
+  // the events the processes of the node recorded while running the job, empty if tracing is disabled
+  pdb::Vector<pdb::Handle<PDBTrace>> traces;
+
+  // the size of the page set the job produced on the node
+  uint64_t pageSetSize = 0;
+};
+
+}
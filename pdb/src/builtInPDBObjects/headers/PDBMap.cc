@@ -135,6 +135,14 @@ size_t Map<KeyType, ValueType>::size() const {
     return myArray->numUsedSlots();
 }
 
+template <class KeyType, class ValueType>
+void Map<KeyType, ValueType>::reserve(uint32_t numItems) {
+    Handle<PairArray<KeyType, ValueType>> temp = myArray->growToFit(numItems);
+    if (temp != nullptr) {
+        myArray = temp;
+    }
+}
+
 template <class KeyType, class ValueType>
 PDBMapIterator<KeyType, ValueType> Map<KeyType, ValueType>::begin() {
     PDBMapIterator<KeyType, ValueType> returnVal(myArray, true);
@@ -61,6 +61,10 @@ public:
     // returns the number of elements in the map
     size_t size() const;
 
+    // makes sure that the map can hold numItems elements without growing, so that the next
+    // inserts do not need to allocate a new array of slots
+    void reserve(uint32_t numItems);
+
     // returns 0 if this entry is undefined; 1 if it is defined
     int count(const KeyType& which);
 
@@ -0,0 +1,96 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "PDBString.h"
+
+// PRELOAD %PDBProfileEntry%
+
+namespace pdb {
+
+/**
+ * An operator of the profile of a computation as it is sent over the wire @see PDBProfile. The entries are sent in tree
+ * order, an entry is a child of the last entry before it with a smaller depth.
+ */
+class PDBProfileEntry : public Object {
+public:
+
+  ENABLE_DEEP_COPY
+
+  PDBProfileEntry() = default;
+
+  PDBProfileEntry(const std::string &name, uint32_t depth) : name(name), depth(depth) {}
+
+  // the name of the operator
+  pdb::String name;
+
+  // how deep it is in the tree, the roots are at zero
+  uint32_t depth = 0;
+
+  // how many threads or nodes the stats were collected on
+  uint64_t numInstances = 0;
+
+  // the wall time summed up over all the instances (ns)
+  uint64_t wallTime = 0;
+
+  // the wall time of the slowest instance (ns)
+  uint64_t maxWallTime = 0;
+
+  // the cpu time (ns)
+  uint64_t cpuTime = 0;
+
+  // the number of rows that went in
+  uint64_t numRowsIn = 0;
+
+  // the number of rows that came out
+  uint64_t numRowsOut = 0;
+
+  // the number of bytes
+  uint64_t numBytes = 0;
+
+  // the number of pages
+  uint64_t numPages = 0;
+
+  // the number of bytes on the pages a source went through
+  uint64_t numPageBytes = 0;
+
+  // the number of times the operator ran out of space
+  uint64_t numRetries = 0;
+
+  // the number of rows a pipeline processed again
+  uint64_t numRetriedTuples = 0;
+
+  // the number of tuple sets a pipeline processed and failed to process
+  uint64_t numChunks = 0;
+  uint64_t numChunkFailures = 0;
+
+  // the smallest and the largest tuple set size a pipeline chose
+  uint64_t minChunkSize = 0;
+  uint64_t maxChunkSize = 0;
+
+  // the tuple set sizes a pipeline started and ended with, summed up over all the instances
+  uint64_t initialChunkSize = 0;
+  uint64_t finalChunkSize = 0;
+
+  // how many instances started from a learned tuple set size
+  uint64_t numLearnedChunkSizes = 0;
+};
+
+}
@@ -0,0 +1,55 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+
+// PRELOAD %PDBTrace%
+
+namespace pdb {
+
+/**
+ * The events one process recorded while running a job, as they are sent over the wire @see PDBTracer
+ */
+class PDBTrace : public Object {
+public:
+
+  ENABLE_DEEP_COPY
+
+  PDBTrace() = default;
+
+  explicit PDBTrace(const std::string &process) : process(process) {}
+
+  // the process that recorded the events, like the frontend or the backend
+  pdb::String process;
+
+  // how much the system clock of the node was ahead of the steady clock (ns)
+  int64_t clockOffset = 0;
+
+  // the names of the events
+  pdb::Vector<pdb::String> names;
+
+  // six numbers per event : the index of the name, the thread, the begin (steady clock ns), the duration (ns), the arg and
+  // the job, PDB_NO_TRACE_JOB if the event was not recorded while running one
+  pdb::Vector<uint64_t> events;
+};
+
+}
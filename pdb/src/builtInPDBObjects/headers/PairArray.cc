@@ -489,8 +489,35 @@ PairArray<KeyType, ValueType>::~PairArray() {
 
 template <class KeyType, class ValueType>
 Handle<PairArray<KeyType, ValueType>> PairArray<KeyType, ValueType>::doubleArray() {
+    return resize(numSlots * 2);
+}
+
+template <class KeyType, class ValueType>
+Handle<PairArray<KeyType, ValueType>> PairArray<KeyType, ValueType>::growToFit(uint32_t numItems) {
+
+    // an array with no slots can not be doubled
+    if (numSlots == 0) {
+        return nullptr;
+    }
+
+    // double the slots until the items fit, the map doubles once usedSlots reaches maxSlots
+    uint64_t howMany = numSlots;
+    uint64_t max = maxSlots;
+    while (numItems > max) {
+        howMany *= 2;
+        max = (uint64_t) (howMany * FILL_FACTOR);
+    }
 
-    uint32_t howMany = numSlots * 2;
+    // if they already fit we are done
+    if (howMany == numSlots) {
+        return nullptr;
+    }
+
+    return resize((uint32_t) howMany);
+}
+
+template <class KeyType, class ValueType>
+Handle<PairArray<KeyType, ValueType>> PairArray<KeyType, ValueType>::resize(uint32_t howMany) {
 
     // allocate the new Array
     Handle<PairArray<KeyType, ValueType>> tempArray =
@@ -523,6 +550,51 @@ uint32_t PairArray<KeyType, ValueType>::numUsedSlots() {
     return usedSlots;
 }
 
+template <class KeyType, class ValueType>
+size_t PairArray<KeyType, ValueType>::bytesNeededToInsert(uint32_t numNewItems) {
+
+    // an array with no slots can not be doubled
+    if (numSlots == 0) {
+        return 0;
+    }
+
+    // every time we go over the max number of slots we double the array
+    size_t numBytes = 0;
+    uint64_t slots = numSlots;
+    uint64_t max = maxSlots;
+    while ((uint64_t) usedSlots + numNewItems > max) {
+        slots *= 2;
+        max = (uint64_t) (slots * FILL_FACTOR);
+        numBytes += getAllocatedSizeForObject(sizeof(PairArray<KeyType, ValueType>) + objSize * slots);
+    }
+
+    return numBytes;
+}
+
+template <class KeyType, class ValueType>
+size_t PairArray<KeyType, ValueType>::bytesNeededToGrowToFit(uint32_t numItems) {
+
+    // an array with no slots can not be doubled
+    if (numSlots == 0) {
+        return 0;
+    }
+
+    // figure out how many slots the new array has
+    uint64_t slots = numSlots;
+    uint64_t max = maxSlots;
+    while (numItems > max) {
+        slots *= 2;
+        max = (uint64_t) (slots * FILL_FACTOR);
+    }
+
+    // if it already fits nothing is allocated, otherwise we allocate just the one array
+    if (slots == numSlots) {
+        return 0;
+    }
+
+    return getAllocatedSizeForObject(sizeof(PairArray<KeyType, ValueType>) + objSize * slots);
+}
+
 template <class KeyType, class ValueType>
 void PairArray<KeyType, ValueType>::deleteObject(void* deleteMe) {
     deleter(deleteMe, this);
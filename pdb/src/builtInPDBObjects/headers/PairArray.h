@@ -115,10 +115,18 @@ private:
     // delete flag to avoid to run destructor if the flag is set to true
     bool disableDestructor;
 
+    // create a new PairArray with howMany slots and move everything over to it
+    Handle<PairArray<KeyType, ValueType>> resize(uint32_t howMany);
+
 public:
     // create a new PairArray via doubling
     Handle<PairArray<KeyType, ValueType>> doubleArray();
 
+    // create a new PairArray that can hold numItems items without doubling, the number of slots
+    // is doubled as many times as needed but the array is allocated only once... returns a null
+    // handle if this one can already hold them
+    Handle<PairArray<KeyType, ValueType>> growToFit(uint32_t numItems);
+
     // access the value at which; if this is undefined, define it and return a reference
     // to a newly-creaated value
     ValueType& operator[](const KeyType& which);
@@ -129,6 +137,13 @@ public:
     // returns the number of items in this PairArray
     uint32_t numUsedSlots();
 
+    // returns how many bytes inserting numNewItems new items is going to allocate in the
+    // worst case, that is the size of all the arrays we create by doubling
+    size_t bytesNeededToInsert(uint32_t numNewItems);
+
+    // returns how many bytes growToFit (numItems) is going to allocate
+    size_t bytesNeededToGrowToFit(uint32_t numItems);
+
     // returns 0 if this entry is undefined; 1 if it is defined
     int count(const KeyType& which);
 
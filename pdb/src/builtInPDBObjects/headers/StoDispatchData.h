@@ -29,7 +29,8 @@
 namespace pdb {
 
 /**
- * This one looks exactly like the add data but it is sent by the @see PDBDistributedStorage
+ * This one looks exactly like the add data but it is sent by the @see PDBDistributedStorage or by a client that got an
+ * ingest lease from it
  */
 class StoDispatchData : public Object {
 
@@ -38,8 +39,8 @@ public:
   StoDispatchData() = default;
   ~StoDispatchData() = default;
 
-  StoDispatchData(const std::string &databaseName, const std::string &setName, const std::string &typeName, uint64_t compressedSize)
-      : databaseName(databaseName), setName(setName), typeName(typeName), compressedSize(compressedSize) {
+  StoDispatchData(const std::string &databaseName, const std::string &setName, const std::string &typeName, uint64_t compressedSize, bool updateCatalog = false, uint64_t leaseID = 0)
+      : databaseName(databaseName), setName(setName), typeName(typeName), compressedSize(compressedSize), updateCatalog(updateCatalog), leaseID(leaseID) {
   }
 
   ENABLE_DEEP_COPY
@@ -63,6 +64,18 @@ public:
    * The size of the compressed stuff
    */
   uint64_t compressedSize;
+
+  /**
+   * True if the data was sent directly by a client, in that case the worker has to update the size of the set in the
+   * catalog of the manager since the manager never saw the data
+   */
+  bool updateCatalog = false;
+
+  /**
+   * The ingest lease the client got from the manager, the worker only stores the data sent directly by a client if
+   * the manager told it about the lease and the lease has not expired
+   */
+  uint64_t leaseID = 0;
 };
 
 }
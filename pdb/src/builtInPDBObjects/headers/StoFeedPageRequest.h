@@ -36,6 +36,10 @@ public:
 
   StoFeedPageRequest(uint64_t pageSize, bool hasNextPage) : pageSize(pageSize), hasNextPage(hasNextPage) {}
 
+  StoFeedPageRequest(uint64_t pageSize, uint64_t compressedSize, bool hasNextPage) : pageSize(pageSize),
+                                                                                     compressedSize(compressedSize),
+                                                                                     hasNextPage(hasNextPage) {}
+
   ENABLE_DEEP_COPY
 
   /**
@@ -43,6 +47,11 @@ public:
    */
   uint64_t pageSize = 0;
 
+  /**
+   * The size of the frame the page is compressed into @see PDBCodec, 0 if the page is sent as it is
+   */
+  uint64_t compressedSize = 0;
+
   /**
    * Do we have the next page?
    */
@@ -0,0 +1,70 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+
+// PRELOAD %StoIngestLease%
+
+namespace pdb {
+
+// sent by the manager to the workers of an ingest lease, so that they accept the pages a client sends them directly
+// with this lease, or to revoke the lease once the client returned it
+class StoIngestLease : public Object {
+
+public:
+
+  StoIngestLease() = default;
+  ~StoIngestLease() = default;
+
+  StoIngestLease(uint64_t leaseID, const std::string &databaseName, const std::string &setName, uint64_t timeout, bool revoke)
+      : leaseID(leaseID), databaseName(databaseName), setName(setName), timeout(timeout), revoke(revoke) {
+  }
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * The id of the lease
+   */
+  uint64_t leaseID = 0;
+
+  /**
+   * The name of the database the set belongs to
+   */
+  String databaseName;
+
+  /**
+   * The name of the set the lease is for
+   */
+  String setName;
+
+  /**
+   * The number of seconds after which the lease expires
+   */
+  uint64_t timeout = 0;
+
+  /**
+   * True if the lease was returned and the worker should not accept any more pages for it
+   */
+  bool revoke = false;
+};
+
+}
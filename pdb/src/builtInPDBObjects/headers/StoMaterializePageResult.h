@@ -34,8 +34,8 @@ public:
   StoMaterializePageResult() = default;
   ~StoMaterializePageResult() = default;
 
-  StoMaterializePageResult(const std::string &db, const std::string &set, size_t materializeSize, bool success, bool hasNext) :
-                           materializeSize(materializeSize), databaseName(db), setName(set), success(success), hasNext(hasNext) {}
+  StoMaterializePageResult(const std::string &db, const std::string &set, size_t materializeSize, size_t setSize, bool success, bool hasNext) :
+                           materializeSize(materializeSize), setSize(setSize), databaseName(db), setName(set), success(success), hasNext(hasNext) {}
 
   ENABLE_DEEP_COPY
 
@@ -54,6 +54,12 @@ public:
    */
   size_t materializeSize = 0;
 
+  /**
+   * The number of bytes the page adds to the size of the set, if the page is stored compressed it is more than what
+   * we wrote to it
+   */
+  size_t setSize = 0;
+
   /**
    * Did we succeed in writing the stuff to the page
    */
@@ -0,0 +1,77 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+
+// PRELOAD %StoRemoveSetPagesRequest%
+
+namespace pdb {
+
+// encapsulates a request to remove some of the pages of a set on a node
+class StoRemoveSetPagesRequest : public Object {
+
+public:
+
+  StoRemoveSetPagesRequest() = default;
+  ~StoRemoveSetPagesRequest() = default;
+
+  StoRemoveSetPagesRequest(const std::string &databaseName,
+                           const std::string &setName,
+                           const std::vector<uint64_t> &pages,
+                           bool keepPages,
+                           uint64_t size) : databaseName(databaseName), setName(setName), pages(pages.size(), 0), keepPages(keepPages), size(size) {
+
+    // copy the stuff
+    for(auto page : pages) { this->pages.push_back(page);}
+  }
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * The name of the database the set belongs to
+   */
+  String databaseName;
+
+  /**
+   * The name of the set we are removing the pages from
+   */
+  String setName;
+
+  /**
+   * The pages we remove, or the ones we keep if keepPages is true
+   */
+  Vector<uint64_t> pages;
+
+  /**
+   * If true we remove every page of the set but the pages
+   */
+  bool keepPages = false;
+
+  /**
+   * The bytes the pages take, if we keep them this is what the set takes on the node afterwards, otherwise it is
+   * what it takes less
+   */
+  uint64_t size = 0;
+};
+
+}
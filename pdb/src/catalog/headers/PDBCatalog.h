@@ -122,6 +122,16 @@ class PDBCatalog {
    */
   bool updateSetContainer(const std::string &dbName, const std::string &setName, PDBCatalogSetContainerType type, std::string &error);
 
+  /**
+   * Update the nodes the partitions of a set are placed on
+   * @param dbName - the name of the database the set belongs to
+   * @param setName - the name of the set
+   * @param partitionNodes - the ids of the nodes separated by a comma
+   * @param error - error string if any
+   * @return true if we succeed false otherwise
+   */
+  bool updateSetPartitionNodes(const std::string &dbName, const std::string &setName, const std::string &partitionNodes, std::string &error);
+
   /**
    * Check if the database with the provided name exists
    * @param name - the name of the database
@@ -170,6 +180,27 @@ class PDBCatalog {
    */
   bool incrementSetSize(const std::string &dbName, const std::string &setName, size_t increment, std::string &error);
 
+  /**
+   * Same as @see incrementSetSize, but also increments the number of bytes and pages the set has on a particular node.
+   * @param dbName - the name of database
+   * @param setName - the name of the set
+   * @param nodeID - the node that stored the data, if empty only the size of the set is incremented
+   * @param increment - how much should we increment it
+   * @param numPages - how many pages the node stored
+   * @param error - error string if any
+   * @return true if the set exists false otherwise
+   */
+  bool incrementSetSize(const std::string &dbName, const std::string &setName, const std::string &nodeID,
+                        size_t increment, size_t numPages, std::string &error);
+
+  /**
+   * Returns how much of the set is on each node, the nodes that never stored any of the set are not included
+   * @param dbName - the name of database
+   * @param setName - the name of the set
+   * @return - the size of the set on each node
+   */
+  std::vector<PDBCatalogSetOnNodePtr> getSetOnNodes(const std::string &dbName, const std::string &setName);
+
   /**
    * Get the database with the name provided
    * @param dbName - the name of the database
@@ -31,7 +31,25 @@ enum PDBCatalogSetContainerType {
   PDB_CATALOG_SET_VECTOR_CONTAINER,
 
   // this means that the root object is pdb::Map
-  PDB_CATALOG_SET_MAP_CONTAINER
+  PDB_CATALOG_SET_MAP_CONTAINER,
+
+  // this means that the pages store the records column by column @see PDBColumnarPage
+  PDB_CATALOG_SET_COLUMNAR_CONTAINER
+};
+
+/**
+ * How the records of this set are placed on the workers
+ */
+enum PDBCatalogSetPartitionType {
+
+  // the pages go wherever the dispatch policy of the manager wants them
+  PDB_CATALOG_SET_NO_PARTITIONING,
+
+  // the records are placed by the hash of their key
+  PDB_CATALOG_SET_HASH_PARTITIONING,
+
+  // the records are placed by the range their key falls into
+  PDB_CATALOG_SET_RANGE_PARTITIONING
 };
 
 /**
@@ -59,6 +77,62 @@ public:
                 setSize(setSize),
                 containerType(containerType) {}
 
+  /**
+   * Declares how the set is partitioned
+   * @param type - the partitioning scheme
+   * @param partitions - the number of partitions
+   * @param key - the name of the attribute or method the records are partitioned on, "self" if it is the record itself
+   * @param group - the co-partitioning group, sets in the same group of a database get the same placement
+   * @param boundaries - the upper boundaries of the ranges separated by a comma, only used by the range partitioning
+   */
+  void setPartitioning(PDBCatalogSetPartitionType type,
+                       int32_t partitions,
+                       const std::string &key,
+                       const std::string &group,
+                       const std::string &boundaries) {
+    partitionType = type;
+    numPartitions = partitions;
+    partitionKey = key;
+    partitionGroup = group;
+    partitionBoundaries = boundaries;
+  }
+
+  /**
+   * Returns true if the records of the set are placed by their key
+   * @return true if it is, false otherwise
+   */
+  bool isPartitioned() const {
+    return partitionType != PDB_CATALOG_SET_NO_PARTITIONING && numPartitions > 0;
+  }
+
+  /**
+   * Checks if the records of this set and the other set are mapped to the partitions the same way.
+   * That is the case if both sets are in the same co-partitioning group of the same database.
+   * @param other - the other set
+   * @return true if they are, false otherwise
+   */
+  bool isPartitionedLike(const PDBCatalogSet &other) const {
+    return isPartitioned() && other.isPartitioned() &&
+           !partitionGroup.empty() &&
+           database == other.database &&
+           partitionGroup == other.partitionGroup &&
+           partitionType == other.partitionType &&
+           numPartitions == other.numPartitions &&
+           partitionBoundaries == other.partitionBoundaries;
+  }
+
+  /**
+   * Checks if a record with the same key is on the same node in this set and the other set.
+   * That is the case if the sets are partitioned the same way and their partitions were placed on the same nodes.
+   * @param other - the other set
+   * @return true if they are, false otherwise
+   */
+  bool isCoPartitionedWith(const PDBCatalogSet &other) const {
+    return isPartitionedLike(other) &&
+           !partitionNodes.empty() &&
+           partitionNodes == other.partitionNodes;
+  }
+
   /**
    * The set is a string of the form "dbName:setName"
    */
@@ -89,6 +163,42 @@ public:
    */
    int containerType = PDB_CATALOG_SET_NO_CONTAINER;
 
+  /**
+   * How the records of the set are placed on the workers
+   */
+  int partitionType = PDB_CATALOG_SET_NO_PARTITIONING;
+
+  /**
+   * The number of partitions, the partition i goes to the i-th node of the partition nodes (modulo the number of nodes)
+   */
+  int32_t numPartitions = 0;
+
+  /**
+   * The name of the attribute or method the records are partitioned on, "self" if it is the record itself
+   */
+  std::string partitionKey;
+
+  /**
+   * The co-partitioning group of the set, sets in the same group of a database get the same placement
+   */
+  std::string partitionGroup;
+
+  /**
+   * The upper boundaries of the ranges, separated by a comma, only used by the range partitioning
+   */
+  std::string partitionBoundaries;
+
+  /**
+   * The ids of the nodes the partitions are placed on separated by a comma, empty until the first data is added.
+   * The sets of a co-partitioning group get the nodes of the first set of the group that got them.
+   */
+  std::string partitionNodes;
+
+  /**
+   * The name of the codec the pages of the set are compressed with when they are stored @see PDBCodec
+   */
+  std::string storageCodec = "none";
+
   /**
    * Return the schema of the database object
    * @return the schema
@@ -102,6 +212,13 @@ public:
                                            sqlite_orm::make_column("setSize", &PDBCatalogSet::setSize),
                                            sqlite_orm::make_column("setType", &PDBCatalogSet::type),
                                            sqlite_orm::make_column("setContainerType", &PDBCatalogSet::containerType),
+                                           sqlite_orm::make_column("setPartitionType", &PDBCatalogSet::partitionType, sqlite_orm::default_value((int) PDB_CATALOG_SET_NO_PARTITIONING)),
+                                           sqlite_orm::make_column("setNumPartitions", &PDBCatalogSet::numPartitions, sqlite_orm::default_value(0)),
+                                           sqlite_orm::make_column("setPartitionKey", &PDBCatalogSet::partitionKey, sqlite_orm::default_value(std::string())),
+                                           sqlite_orm::make_column("setPartitionGroup", &PDBCatalogSet::partitionGroup, sqlite_orm::default_value(std::string())),
+                                           sqlite_orm::make_column("setPartitionBoundaries", &PDBCatalogSet::partitionBoundaries, sqlite_orm::default_value(std::string())),
+                                           sqlite_orm::make_column("setPartitionNodes", &PDBCatalogSet::partitionNodes, sqlite_orm::default_value(std::string())),
+                                           sqlite_orm::make_column("setStorageCodec", &PDBCatalogSet::storageCodec, sqlite_orm::default_value(std::string("none"))),
                                            sqlite_orm::foreign_key(&PDBCatalogSet::database).references(&PDBCatalogDatabase::name),
                                            sqlite_orm::foreign_key(&PDBCatalogSet::type).references(&PDBCatalogType::name),
                                            sqlite_orm::primary_key(&PDBCatalogSet::setIdentifier));
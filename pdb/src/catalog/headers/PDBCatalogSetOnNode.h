@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <sqlite_orm.h>
+#include "PDBCatalogSet.h"
+#include "PDBCatalogNode.h"
+
+namespace pdb {
+
+/**
+ * This is just a definition for the shared pointer on the type
+ */
+class PDBCatalogSetOnNode;
+typedef std::shared_ptr<PDBCatalogSetOnNode> PDBCatalogSetOnNodePtr;
+
+/**
+ * How much of a set is stored on a particular node. The workers report this together with the size of the set
+ * every time they store some pages of it.
+ */
+class PDBCatalogSetOnNode {
+
+ public:
+
+  /**
+   * The default constructor needed by the orm
+   */
+  PDBCatalogSetOnNode() = default;
+
+  /**
+   * The initialization constructor
+   * @param setIdentifier - the identifier of the set "dbName:setName"
+   * @param nodeID - the identifier of the node "ip:port"
+   * @param setSize - the number of bytes of the set on the node
+   * @param numPages - the number of pages of the set on the node
+   */
+  PDBCatalogSetOnNode(std::string setIdentifier, std::string nodeID, size_t setSize, size_t numPages) :
+                      setIdentifier(std::move(setIdentifier)),
+                      nodeID(std::move(nodeID)),
+                      setSize(setSize),
+                      numPages(numPages) {}
+
+  /**
+   * Returns how unevenly the set is spread, that is the ratio between the size on the most loaded node and the
+   * average size per node. 1.0 means that the set is perfectly balanced.
+   * @param setOnNodes - the size of the set on each node
+   * @param numNodes - the number of nodes the set could be on, the nodes without any data count as empty
+   * @return the imbalance, 0 if the set is empty
+   */
+  static double getImbalance(const std::vector<PDBCatalogSetOnNodePtr> &setOnNodes, size_t numNodes) {
+
+    // sum up the sizes and find the largest one
+    size_t total = 0;
+    size_t largest = 0;
+    for(const auto &setOnNode : setOnNodes) {
+      total += setOnNode->setSize;
+      largest = std::max(largest, setOnNode->setSize);
+    }
+
+    // if there is nothing there is no imbalance
+    numNodes = std::max(numNodes, setOnNodes.size());
+    if(total == 0 || numNodes == 0) {
+      return 0;
+    }
+
+    return (double) largest * numNodes / total;
+  }
+
+  /**
+   * The set is a string of the form "dbName:setName"
+   */
+  std::string setIdentifier;
+
+  /**
+   * The id of the node is a combination of the ip address and the port concatenated by a column
+   */
+  std::string nodeID;
+
+  /**
+   * The number of bytes of the set on the node
+   */
+  size_t setSize = 0;
+
+  /**
+   * The number of pages of the set on the node
+   */
+  size_t numPages = 0;
+
+  /**
+   * Return the schema of the database object
+   * @return the schema
+   */
+  static auto getSchema() {
+
+    // return the schema
+    return sqlite_orm::make_table("setsOnNodes", sqlite_orm::make_column("setIdentifier", &PDBCatalogSetOnNode::setIdentifier),
+                                                 sqlite_orm::make_column("nodeID", &PDBCatalogSetOnNode::nodeID),
+                                                 sqlite_orm::make_column("setSize", &PDBCatalogSetOnNode::setSize),
+                                                 sqlite_orm::make_column("numPages", &PDBCatalogSetOnNode::numPages),
+                                                 sqlite_orm::foreign_key(&PDBCatalogSetOnNode::setIdentifier).references(&PDBCatalogSet::setIdentifier),
+                                                 sqlite_orm::primary_key(&PDBCatalogSetOnNode::setIdentifier, &PDBCatalogSetOnNode::nodeID));
+  }
+
+};
+
+}
@@ -11,6 +11,7 @@
 #include "PDBCatalogDatabase.h"
 #include "PDBCatalogType.h"
 #include "PDBCatalogSet.h"
+#include "PDBCatalogSetOnNode.h"
 
 namespace pdb {
 
@@ -26,7 +27,8 @@ namespace pdb {
     return sqlite_orm::make_storage(*location, PDBCatalogDatabase::getSchema(),
                                                PDBCatalogSet::getSchema(),
                                                PDBCatalogNode::getSchema(),
-                                               PDBCatalogType::getSchema());
+                                               PDBCatalogType::getSchema(),
+                                               PDBCatalogSetOnNode::getSchema());
   }
 
   /**
@@ -26,6 +26,7 @@
 #include "CatalogServer.h"
 #include <CatGetWorkersRequest.h>
 #include <CatSetUpdateContainerTypeRequest.h>
+#include <CatSetUpdatePartitionNodesRequest.h>
 
 #include "BuiltInObjectTypeIDs.h"
 #include "CatSyncWorkerRequest.h"
@@ -45,12 +46,15 @@
 #include "CatGetSetRequest.h"
 #include "CatUpdateNodeStatusRequest.h"
 #include "CatGetSetResult.h"
+#include "CatGetSetOnNodesRequest.h"
+#include "CatGetSetOnNodesResult.h"
 #include "CatGetWorkersResult.h"
 #include "CatUserTypeMetadata.h"
 #include "CatPrintCatalogRequest.h"
 #include "CatPrintCatalogResult.h"
 #include "CatSetUpdateSizeRequest.h"
 #include "CatalogServer.h"
+#include "PDBCodec.h"
 #include "HeapRequestHandler.h"
 #include "VTableMap.h"
 
@@ -536,7 +540,7 @@ void CatalogServer::registerHandlers(PDBServer &forMe) {
 
             // invokes the increment
             std::string errMsg;
-            bool res = pdbCatalog->incrementSetSize(request->databaseName, request->setName, request->sizeUpdate, errMsg);
+            bool res = pdbCatalog->incrementSetSize(request->databaseName, request->setName, request->nodeID, request->sizeUpdate, request->pageUpdate, errMsg);
 
             // after we incremented the size of the set in the local catalog, if this is the
             // manager catalog iterate over all nodes in the cluster and broadcast the
@@ -625,6 +629,78 @@ void CatalogServer::registerHandlers(PDBServer &forMe) {
             return make_pair(res, errMsg);
           }));
 
+  forMe.registerHandler(
+      CatSetUpdatePartitionNodesRequest_TYPEID,
+      make_shared<HeapRequestHandler<CatSetUpdatePartitionNodesRequest>>(
+          [&](Handle<CatSetUpdatePartitionNodesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+            // lock the catalog server
+            std::lock_guard<std::mutex> guard(serverMutex);
+
+            // the manager only assigns the nodes once, the sets of a co-partitioning group get the nodes of the first set
+            // in the group that got them, so that the records with the same key end up on the same node
+            std::string partitionNodes = request->partitionNodes;
+            auto set = pdbCatalog->getSet(request->databaseName, request->setName);
+            if (getConfiguration()->isManager && set != nullptr) {
+
+              if (!set->partitionNodes.empty()) {
+                partitionNodes = set->partitionNodes;
+              }
+              else {
+                for (const auto &other : pdbCatalog->getSetsInDatabase(set->database)) {
+                  if (other.name != set->name && !other.partitionNodes.empty() && set->isPartitionedLike(other)) {
+                    partitionNodes = other.partitionNodes;
+                    break;
+                  }
+                }
+              }
+            }
+
+            // update the partition nodes
+            std::string errMsg;
+            bool res = pdbCatalog->updateSetPartitionNodes(request->databaseName, request->setName, partitionNodes, errMsg);
+
+            // after we updated the partition nodes of the set in the local catalog, if this is the
+            // manager catalog iterate over all nodes in the cluster and broadcast the
+            // nodes we picked to the distributed copies of the catalog
+            if (getConfiguration()->isManager) {
+
+              // get the results of each broadcast
+              map<string, pair<bool, string>> updateResults;
+
+              // broadcast the update
+              const UseTemporaryAllocationBlock broadcastBlock{1024 + partitionNodes.size()};
+              Handle<CatSetUpdatePartitionNodesRequest> update = makeObject<CatSetUpdatePartitionNodesRequest>(request->databaseName,
+                                                                                                              request->setName,
+                                                                                                              partitionNodes);
+              broadcastRequest(update, 1024 + partitionNodes.size(), updateResults, errMsg);
+
+              for (auto &item : updateResults) {
+
+                // if we failed res would be set to false
+                res = item.second.first && res;
+
+                // log what is happening
+                PDB_COUT << "Node IP: " << item.first + (item.second.first ? " updated correctly!" : " couldn't be updated due to error: ") << item.second.second << "\n";
+              }
+
+            } else {
+
+              // log what happened
+              PDB_COUT << "This is not Manager Catalog Node, thus metadata was only registered locally!\n";
+            }
+
+            // create an allocation block to hold the response
+            const UseTemporaryAllocationBlock tempBlock{1024};
+
+            // create the response
+            Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(res, errMsg);
+
+            // sends result to requester
+            res = sendUsingMe->sendObject(response, errMsg) && res;
+            return make_pair(res, errMsg);
+          }));
+
   // handles a request to retrieve the name of a Type, if it's not registered returns -1
   forMe.registerHandler(
       CatSetObjectTypeRequest_TYPEID,
@@ -745,13 +821,38 @@ void CatalogServer::registerHandlers(PDBServer &forMe) {
           res = pdbCatalog->registerType(make_shared<PDBCatalogType>(typeID, "built-in", type, vector<char>()), errMsg);
         }
 
+        // make the set and set the partitioning if there is any
+        auto set = make_shared<PDBCatalogSet>(dbName, setName, internalTypeName, 0, PDBCatalogSetContainerType::PDB_CATALOG_SET_NO_CONTAINER);
+        set->setPartitioning(request->partitionType,
+                             request->numPartitions,
+                             request->partitionKey,
+                             request->partitionGroup,
+                             request->partitionBoundaries);
+        set->storageCodec = request->storageCodec.c_str();
+
+        // the sets in a co-partitioning group must be partitioned the same way otherwise they would not have the same placement
+        bool validSet = true;
+        if(set->isPartitioned() && !set->partitionGroup.empty()) {
+          for(const auto &other : pdbCatalog->getSetsInDatabase(dbName)) {
+            if(other.partitionGroup == set->partitionGroup && !set->isPartitionedLike(other)) {
+              errMsg = "The set " + other.name + " in the co-partitioning group " + set->partitionGroup + " is partitioned differently!";
+              validSet = false;
+            }
+          }
+        }
+
+        // the pages of the set can only be stored with a codec we know
+        if(PDBCodec::get(set->storageCodec, errMsg) == nullptr) {
+          validSet = false;
+        }
+
         // register the set with the catalog
-        res = pdbCatalog->registerSet(make_shared<PDBCatalogSet>(dbName, setName, internalTypeName, 0, PDBCatalogSetContainerType::PDB_CATALOG_SET_NO_CONTAINER), errMsg) && res;
+        res = validSet && pdbCatalog->registerSet(set, errMsg) && res;
 
         // after we added the set to the local catalog, if this is the
         // manager catalog iterate over all nodes in the cluster and broadcast the
         // request to the distributed copies of the catalog
-        if (getConfiguration()->isManager) {
+        if (getConfiguration()->isManager && validSet) {
 
           // get the results of each broadcast
           map<string, pair<bool, string>> updateResults;
@@ -1009,7 +1110,7 @@ void CatalogServer::registerHandlers(PDBServer &forMe) {
             if(res) {
 
               // create the response object
-              response = makeObject<CatGetSetResult>(set->database, set->name, *set->type, *set->type, set->setSize, (PDBCatalogSetContainerType) set->containerType);
+              response = makeObject<CatGetSetResult>(*set);
 
             } else {
 
@@ -1025,6 +1126,28 @@ void CatalogServer::registerHandlers(PDBServer &forMe) {
             return make_pair(res, errMsg);
           }));
 
+  // handles a request for how much of a set is on each node
+  forMe.registerHandler(
+      CatGetSetOnNodesRequest_TYPEID,
+      make_shared<HeapRequestHandler<CatGetSetOnNodesRequest>>(
+          [&](Handle<CatGetSetOnNodesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+            // lock the catalog server
+            std::lock_guard<std::mutex> guard(serverMutex);
+
+            // grab the sizes
+            auto setOnNodes = pdbCatalog->getSetOnNodes(request->databaseName, request->setName);
+
+            // allocate a block for the response
+            const UseTemporaryAllocationBlock tempBlock{1024 + setOnNodes.size() * 1024};
+            Handle<CatGetSetOnNodesResult> response = pdb::makeObject<CatGetSetOnNodesResult>(setOnNodes);
+
+            // sends result to requester
+            std::string errMsg;
+            bool res = sendUsingMe->sendObject(response, errMsg);
+            return make_pair(res, errMsg);
+          }));
+
   // handles a request to register a shared library
   forMe.registerHandler(
       CatGetWorkersRequest_TYPEID,
@@ -257,6 +257,42 @@ bool pdb::PDBCatalog::updateSetContainer(const std::string &dbName, const std::s
   }
 }
 
+bool pdb::PDBCatalog::updateSetPartitionNodes(const std::string &dbName, const std::string &setName, const std::string &partitionNodes, std::string &error) {
+
+  try {
+
+    // grab the set we want to update
+    auto set = getSet(dbName, setName);
+
+    // if the set does not exist we can not update it
+    if(set == nullptr) {
+
+      // set the error
+      error = "The set with the name (" + dbName + "," + setName + ") does not exist\n";
+
+      // we failed return false
+      return false;
+    }
+
+    // ok the set exists set the nodes
+    set->partitionNodes = partitionNodes;
+
+    // insert the the set
+    storage.replace(*set);
+
+    // return true
+    return true;
+
+  } catch(std::system_error &e) {
+
+    // set the error we failed
+    error = "The set with the name (" + dbName + "," + setName + ") count not be updated! The SQL error is : "  + std::string(e.what());
+
+    // we failed
+    return false;
+  }
+}
+
 bool pdb::PDBCatalog::databaseExists(const std::string &name) {
 
   // try to find the database
@@ -295,6 +331,15 @@ pdb::PDBCatalogSetPtr pdb::PDBCatalog::getSet(const std::string &dbName, const s
 }
 
 bool pdb::PDBCatalog::incrementSetSize(const std::string &dbName, const std::string &setName, size_t increment, std::string &error) {
+  return incrementSetSize(dbName, setName, "", increment, 0, error);
+}
+
+bool pdb::PDBCatalog::incrementSetSize(const std::string &dbName,
+                                       const std::string &setName,
+                                       const std::string &nodeID,
+                                       size_t increment,
+                                       size_t numPages,
+                                       std::string &error) {
 
   try {
 
@@ -317,6 +362,23 @@ bool pdb::PDBCatalog::incrementSetSize(const std::string &dbName, const std::str
     // insert the the set
     storage.replace(*set);
 
+    // if we know the node increment the size of the set on it
+    if(!nodeID.empty()) {
+
+      // grab what the node has so far
+      auto rows = storage.get_all<PDBCatalogSetOnNode>(where(c(&PDBCatalogSetOnNode::setIdentifier) == set->setIdentifier &&
+                                                             c(&PDBCatalogSetOnNode::nodeID) == nodeID));
+      PDBCatalogSetOnNode setOnNode(set->setIdentifier, nodeID, 0, 0);
+      if(!rows.empty()) {
+        setOnNode = rows.front();
+      }
+
+      // increment it
+      setOnNode.setSize += increment;
+      setOnNode.numPages += numPages;
+      storage.replace(setOnNode);
+    }
+
     // return true
     return true;
 
@@ -414,7 +476,10 @@ int32_t pdb::PDBCatalog::numRegisteredTypes() {
 std::vector<pdb::PDBCatalogSet> pdb::PDBCatalog::getSetsInDatabase(const std::string &dbName) {
 
   // select all the sets
-  auto rows = storage.select(columns(&PDBCatalogSet::name, &PDBCatalogSet::database, &PDBCatalogSet::type, &PDBCatalogSet::setSize, &PDBCatalogSet::containerType),
+  auto rows = storage.select(columns(&PDBCatalogSet::name, &PDBCatalogSet::database, &PDBCatalogSet::type, &PDBCatalogSet::setSize, &PDBCatalogSet::containerType,
+                                     &PDBCatalogSet::partitionType, &PDBCatalogSet::numPartitions, &PDBCatalogSet::partitionKey,
+                                     &PDBCatalogSet::partitionGroup, &PDBCatalogSet::partitionBoundaries, &PDBCatalogSet::storageCodec,
+                                     &PDBCatalogSet::partitionNodes),
                              where(c(&PDBCatalogSet::database) == dbName));
 
   // create a return value
@@ -426,6 +491,9 @@ std::vector<pdb::PDBCatalogSet> pdb::PDBCatalog::getSetsInDatabase(const std::st
   // create the objects
   for(auto &r : rows) {
     ret.emplace_back(pdb::PDBCatalogSet(std::get<1>(r), std::get<0>(r), *std::get<2>(r), std::get<3>(r), (PDBCatalogSetContainerType) std::get<4>(r)));
+    ret.back().setPartitioning((PDBCatalogSetPartitionType) std::get<5>(r), std::get<6>(r), std::get<7>(r), std::get<8>(r), std::get<9>(r));
+    ret.back().storageCodec = std::get<10>(r);
+    ret.back().partitionNodes = std::get<11>(r);
   }
 
   return std::move(ret);
@@ -534,6 +602,11 @@ bool pdb::PDBCatalog::removeDatabase(const std::string &dbName, std::string &err
   // remove each set from every node
   auto setIdentifiers = storage.select(columns(&PDBCatalogSet::setIdentifier), where(c(&PDBCatalogSet::database) == dbName));
 
+  // remove what we know about the sets on the nodes
+  for(const auto &setIdentifier : setIdentifiers) {
+    storage.remove_all<PDBCatalogSetOnNode>(where(c(&PDBCatalogSetOnNode::setIdentifier) == std::get<0>(setIdentifier)));
+  }
+
   // remove all the sets
   storage.remove_all<PDBCatalogSet>(where(c(&PDBCatalogSet::database) == dbName));
 
@@ -542,6 +615,20 @@ bool pdb::PDBCatalog::removeDatabase(const std::string &dbName, std::string &err
 
   return true;
 }
+std::vector<pdb::PDBCatalogSetOnNodePtr> pdb::PDBCatalog::getSetOnNodes(const std::string &dbName, const std::string &setName) {
+
+  // grab the rows of the set
+  auto rows = storage.get_all<PDBCatalogSetOnNode>(where(c(&PDBCatalogSetOnNode::setIdentifier) == dbName + ":" + setName));
+
+  // copy the stuff
+  std::vector<pdb::PDBCatalogSetOnNodePtr> ret;
+  for(const auto &row : rows) {
+    ret.push_back(std::make_shared<pdb::PDBCatalogSetOnNode>(row));
+  }
+
+  return std::move(ret);
+}
+
 bool pdb::PDBCatalog::removeSet(const std::string &dbName, const std::string &setName, std::string &error) {
 
   // get the set
@@ -556,6 +643,9 @@ bool pdb::PDBCatalog::removeSet(const std::string &dbName, const std::string &se
     return false;
   }
 
+  // remove what we know about the set on the nodes
+  storage.remove_all<PDBCatalogSetOnNode>(where(c(&PDBCatalogSetOnNode::setIdentifier) == setIdentifier));
+
   // remove the set
   storage.remove_all<PDBCatalogSet>(where(c(&PDBCatalogSet::setIdentifier) == setIdentifier));
 
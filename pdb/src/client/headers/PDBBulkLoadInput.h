@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace pdb {
+
+/**
+ * A part of the input of a bulk load. Each call gives the next item of the part, once there are no items left it
+ * returns false. A part is only ever read by one thread, but different parts are read at the same time.
+ */
+template<class Item>
+using PDBBulkLoadPart = std::function<bool(Item &item)>;
+
+/**
+ * Splits the input of a bulk load into parts that can be read in parallel @see PDBBulkLoader
+ */
+class PDBBulkLoadInput {
+ public:
+
+  /**
+   * Splits the indices [0, numRecords) into ranges of about the same size
+   * @param numRecords - the number of records we are generating
+   * @param numParts - the number of parts we want
+   * @return the parts, each one gives the indices of its range
+   */
+  static std::vector<PDBBulkLoadPart<size_t>> splitRange(size_t numRecords, size_t numParts);
+
+  /**
+   * Splits a text file into parts of about partSize bytes. A part starts at the first line that starts within its
+   * range of bytes, so that each line is read by exactly one part. The line breaks are not part of the lines.
+   * @param path - the path to the file
+   * @param partSize - the number of bytes in each part
+   * @param parts - the parts, each one gives the lines of its range
+   * @param errMsg - the error if we fail
+   * @return true if we could open the file, false otherwise
+   */
+  static bool splitTextFile(const std::string &path,
+                            size_t partSize,
+                            std::vector<PDBBulkLoadPart<std::string>> &parts,
+                            std::string &errMsg);
+
+  /**
+   * Splits a file of fixed size records into parts of about partSize bytes, a part always has whole records
+   * @param path - the path to the file
+   * @param recordSize - the size of each record in the file
+   * @param partSize - the number of bytes in each part
+   * @param parts - the parts, each one gives a pointer to the bytes of the next record, valid until the next call
+   * @param errMsg - the error if we fail
+   * @return true if we could open the file and it has whole records, false otherwise
+   */
+  static bool splitBinaryFile(const std::string &path,
+                              size_t recordSize,
+                              size_t partSize,
+                              std::vector<PDBBulkLoadPart<const char*>> &parts,
+                              std::string &errMsg);
+
+  /**
+   * How many bytes of a binary file we read at once
+   */
+  static const size_t binaryReadSize = 1024 * 1024;
+
+ private:
+
+  /**
+   * Returns the size of the file
+   * @param path - the path to the file
+   * @param fileSize - the size of the file
+   * @param errMsg - the error if we fail
+   * @return true if the file is there, false otherwise
+   */
+  static bool getFileSize(const std::string &path, size_t &fileSize, std::string &errMsg);
+};
+
+}
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include <PDBWork.h>
+#include <PDBStoragePageSender.h>
+#include <PDBBulkLoadInput.h>
+#include "Handle.h"
+#include "PDBVector.h"
+
+namespace pdb {
+
+/**
+ * The knobs of a bulk load
+ */
+struct PDBBulkLoadOptions {
+
+  /**
+   * The number of threads that make the records and build the pages, 0 means one for each core
+   */
+  size_t numBuilders = 0;
+
+  /**
+   * The number of batches of pages that are compressed and sent at the same time
+   */
+  size_t numSenders = 2;
+
+  /**
+   * The size of the pages we build, a page has to fit on a page of the storage
+   */
+  size_t pageSize = 64 * 1024 * 1024;
+
+  /**
+   * The most pages we send in one batch
+   */
+  size_t pagesPerSend = 4;
+
+  /**
+   * The most pages that are built but not sent yet, 0 means two batches for each sender. Once there are that many
+   * the builders wait for the senders, this bounds the memory the load is using.
+   */
+  size_t maxPendingPages = 0;
+
+  /**
+   * The number of bytes of an input file each part of it has, the parts are read in parallel
+   */
+  size_t partSize = 64 * 1024 * 1024;
+};
+
+/**
+ * A page that was built and is waiting to be sent
+ */
+struct PDBBulkLoadPage {
+
+  // the memory of the page, the record starts at the beginning of it
+  std::unique_ptr<char[]> bytes;
+
+  // the size of the record
+  size_t numBytes = 0;
+
+  // the index of the node in the lease the page goes to, if the set is partitioned
+  size_t node = 0;
+
+  // true if the page has to go to that node
+  bool assigned = false;
+};
+
+/**
+ * The part of the bulk loader that does not depend on the type of the records. It runs the builders and the senders on
+ * the workers of the loader, the builders put the pages into a bounded queue and the senders take them out in batches
+ * and send each batch directly to the workers of the cluster @see PDBStoragePageSender.
+ */
+class PDBBulkLoaderBase {
+ public:
+
+  /**
+   * Initializes the loader
+   * @param address - the address of the manager
+   * @param port - the port of the manager
+   * @param maxRetries - how many times should we retry to connect to a node if we fail
+   * @param db - the database the set belongs to
+   * @param set - the set we are loading the records into
+   * @param typeName - the type of the records
+   * @param options - the knobs of the load
+   */
+  PDBBulkLoaderBase(const std::string &address,
+                    int port,
+                    int maxRetries,
+                    std::string db,
+                    std::string set,
+                    const std::string &typeName,
+                    const PDBBulkLoadOptions &options);
+
+  /**
+   * Returns the number of records we loaded so far
+   */
+  size_t getNumRecords() const;
+
+  /**
+   * Returns the number of pages we built so far
+   */
+  size_t getNumPages() const;
+
+  /**
+   * Returns the number of bytes of the pages we built so far
+   */
+  size_t getNumBytes() const;
+
+  /**
+   * The most batches we send at the same time
+   */
+  static const size_t maxSenders = 4;
+
+ protected:
+
+  /**
+   * Asks the manager for the lease of the set, so we know if the set is partitioned
+   * @param errMsg - the error if we fail
+   * @return true if we got the lease, false otherwise
+   */
+  bool requestLease(std::string &errMsg);
+
+  /**
+   * Builds the parts of the input on the builders and sends the pages they put into the queue
+   * @param numParts - the number of parts of the input
+   * @param buildPart - builds the pages of a part and adds them with @see addPage, returns false if it fails
+   * @param errMsg - the first error we got if we fail
+   * @return true if every page was stored, false otherwise
+   */
+  bool run(size_t numParts, const std::function<bool(size_t, std::string &)> &buildPart, std::string &errMsg);
+
+  /**
+   * Puts a page into the queue, waits if the queue is full
+   * @param page - the page
+   * @return true if we added it, false if the load failed
+   */
+  bool addPage(PDBBulkLoadPage page);
+
+  /**
+   * Returns the number of builders we are going to use
+   */
+  size_t getNumBuilders() const;
+
+  /**
+   * The lease of the set
+   */
+  PDBStoragePageSender lease;
+
+  /**
+   * The knobs of the load
+   */
+  PDBBulkLoadOptions options;
+
+  /**
+   * The number of records we loaded so far
+   */
+  std::atomic<size_t> numRecords;
+
+ private:
+
+  /**
+   * Takes batches of pages from the queue and sends them until there are no pages left
+   * @param errMsg - the error if we fail
+   * @return true if every batch was stored, false otherwise
+   */
+  bool sendPages(std::string &errMsg);
+
+  /**
+   * Marks that the load failed, the first error wins
+   * @param error - the error
+   */
+  void fail(const std::string &error);
+
+  /**
+   * Returns the workers the loaders use, they are started the first time we need them. A process can only have one
+   * worker queue, so this fails if it already has one.
+   * @param errMsg - the error if we fail
+   * @return the workers or null if we fail
+   */
+  static PDBWorkerQueuePtr getWorkers(std::string &errMsg);
+
+  /**
+   * Returns the most builders we use
+   */
+  static size_t getMaxBuilders();
+
+  /**
+   * The address and port of the manager
+   */
+  std::string address;
+  int port;
+
+  /**
+   * How many times should we retry to connect to a node if we fail
+   */
+  int maxRetries;
+
+  /**
+   * The set, the database and the type of the records
+   */
+  std::string db;
+  std::string set;
+  std::string typeName;
+
+  /**
+   * The pages that are built but not sent yet
+   */
+  std::deque<PDBBulkLoadPage> pending;
+
+  /**
+   * True while the builders are still running
+   */
+  bool building = false;
+
+  /**
+   * True if the load failed and the error
+   */
+  std::atomic<bool> failed;
+  std::string error;
+
+  /**
+   * The number of pages and bytes we built so far
+   */
+  std::atomic<size_t> numPages;
+  std::atomic<size_t> numBytes;
+
+  /**
+   * Protects the queue and signals that it changed
+   */
+  std::mutex m;
+  std::condition_variable cv;
+
+  /**
+   * The workers all the loaders use, and the lock that makes sure only one load uses them at a time
+   */
+  static PDBWorkerQueuePtr workers;
+  static std::mutex loadMutex;
+};
+
+/**
+ * Loads records into a set on many threads. The records are made by a function, from the lines of a text file or from
+ * the records of a binary file. The input is split into parts and a couple of builders make the records of each part
+ * and put them on pages, each builder in its own allocation block. The pages are then compressed and sent directly to
+ * the workers by the senders, while the builders keep building, so that the load is not bound by a single core.
+ *
+ * The builders run on the workers of the loader, they have their own allocators, therefore the functions that make the
+ * records can use makeObject, they are called from many threads at the same time and should not share any state.
+ */
+template<class DataType>
+class PDBBulkLoader : public PDBBulkLoaderBase {
+ public:
+
+  /**
+   * Initializes the loader
+   * @param address - the address of the manager
+   * @param port - the port of the manager
+   * @param maxRetries - how many times should we retry to connect to a node if we fail
+   * @param db - the database the set belongs to
+   * @param set - the set we are loading the records into
+   * @param key - returns the key of a record if the set is partitioned, can be null if it is not
+   * @param keyName - the name of the attribute or method the key function extracts
+   * @param options - the knobs of the load
+   */
+  PDBBulkLoader(const std::string &address,
+                int port,
+                int maxRetries,
+                const std::string &db,
+                const std::string &set,
+                std::function<int64_t(Handle<DataType>&)> key,
+                const std::string &keyName,
+                const PDBBulkLoadOptions &options);
+
+  /**
+   * Loads the records a function makes
+   * @param numRecords - the number of records
+   * @param makeRecord - makes the record with the index
+   * @param errMsg - the error if we fail
+   * @return true if every record was stored, false otherwise
+   */
+  bool loadRecords(size_t numRecords, const std::function<Handle<DataType>(size_t)> &makeRecord, std::string &errMsg);
+
+  /**
+   * Loads the records of a text file, one record per line
+   * @param path - the path to the file
+   * @param parseLine - makes the record of a line
+   * @param errMsg - the error if we fail
+   * @return true if every record was stored, false otherwise
+   */
+  bool loadTextFile(const std::string &path,
+                    const std::function<Handle<DataType>(const std::string&)> &parseLine,
+                    std::string &errMsg);
+
+  /**
+   * Loads the records of a file of fixed size records
+   * @param path - the path to the file
+   * @param recordSize - the size of a record in the file
+   * @param parseRecord - makes the record from its bytes
+   * @param errMsg - the error if we fail
+   * @return true if every record was stored, false otherwise
+   */
+  bool loadBinaryFile(const std::string &path,
+                      size_t recordSize,
+                      const std::function<Handle<DataType>(const char*)> &parseRecord,
+                      std::string &errMsg);
+
+  /**
+   * Loads the records of some input that was split into parts
+   * @param parts - the parts of the input
+   * @param makeRecord - makes the record of an item of the input
+   * @param errMsg - the error if we fail
+   * @return true if every record was stored, false otherwise
+   */
+  template<class Item>
+  bool load(std::vector<PDBBulkLoadPart<Item>> &parts,
+            const std::function<Handle<DataType>(Item&)> &makeRecord,
+            std::string &errMsg);
+
+  /**
+   * Splits the records of a page by the node their key is placed on and builds the page for each node
+   * @param sender - the sender that has the lease for the set
+   * @param page - the page we are splitting
+   * @param key - returns the key of a record
+   * @param splits - the page for each node that gets some of the records
+   */
+  static void splitPage(const PDBStoragePageSender &sender,
+                        Handle<Vector<Handle<DataType>>> &page,
+                        const std::function<int64_t(Handle<DataType>&)> &key,
+                        std::vector<PDBBulkLoadPage> &splits);
+
+ private:
+
+  /**
+   * Makes the records of a part, puts them on pages and adds the pages to the queue
+   * @param part - the part
+   * @param makeRecord - makes the record of an item of the input
+   * @param errMsg - the error if we fail
+   * @return true if we built the whole part, false otherwise
+   */
+  template<class Item>
+  bool buildPart(PDBBulkLoadPart<Item> &part, const std::function<Handle<DataType>(Item&)> &makeRecord, std::string &errMsg);
+
+  /**
+   * Replaces the record of a page with a columnar page that has the same records, used for columnar sets
+   * @param page - the page
+   * @param errMsg - the error if we fail
+   * @return true if we succeeded, false if the type has no columns
+   */
+  static bool makeColumnar(PDBBulkLoadPage &page, std::string &errMsg);
+
+  /**
+   * Returns the key of a record if the set is partitioned
+   */
+  std::function<int64_t(Handle<DataType>&)> key;
+
+  /**
+   * The name of the attribute or method the key function extracts, it has to be the one the set is partitioned on
+   */
+  std::string keyName;
+};
+
+}
+
+#include "PDBBulkLoaderTemplate.cc"
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "PDBBulkLoader.h"
+#include "InterfaceFunctions.h"
+#include "UseTemporaryAllocationBlock.h"
+#include "PDBColumns.h"
+
+namespace pdb {
+
+template<class DataType>
+PDBBulkLoader<DataType>::PDBBulkLoader(const std::string &address,
+                                       int port,
+                                       int maxRetries,
+                                       const std::string &db,
+                                       const std::string &set,
+                                       std::function<int64_t(Handle<DataType>&)> key,
+                                       const std::string &keyName,
+                                       const PDBBulkLoadOptions &options) : PDBBulkLoaderBase(address,
+                                                                                              port,
+                                                                                              maxRetries,
+                                                                                              db,
+                                                                                              set,
+                                                                                              getTypeName<DataType>(),
+                                                                                              options),
+                                                                            key(std::move(key)),
+                                                                            keyName(keyName) {}
+
+template<class DataType>
+bool PDBBulkLoader<DataType>::loadRecords(size_t numRecords,
+                                          const std::function<Handle<DataType>(size_t)> &makeRecord,
+                                          std::string &errMsg) {
+
+  // we make a couple of parts for each builder so that they finish at about the same time
+  auto parts = PDBBulkLoadInput::splitRange(numRecords, getNumBuilders() * 4);
+  return load<size_t>(parts, [&](size_t &idx) { return makeRecord(idx); }, errMsg);
+}
+
+template<class DataType>
+bool PDBBulkLoader<DataType>::loadTextFile(const std::string &path,
+                                           const std::function<Handle<DataType>(const std::string&)> &parseLine,
+                                           std::string &errMsg) {
+
+  // split the file
+  std::vector<PDBBulkLoadPart<std::string>> parts;
+  if(!PDBBulkLoadInput::splitTextFile(path, options.partSize, parts, errMsg)) {
+    return false;
+  }
+
+  return load<std::string>(parts, [&](std::string &line) { return parseLine(line); }, errMsg);
+}
+
+template<class DataType>
+bool PDBBulkLoader<DataType>::loadBinaryFile(const std::string &path,
+                                             size_t recordSize,
+                                             const std::function<Handle<DataType>(const char*)> &parseRecord,
+                                             std::string &errMsg) {
+
+  // split the file
+  std::vector<PDBBulkLoadPart<const char*>> parts;
+  if(!PDBBulkLoadInput::splitBinaryFile(path, recordSize, options.partSize, parts, errMsg)) {
+    return false;
+  }
+
+  return load<const char*>(parts, [&](const char *&record) { return parseRecord(record); }, errMsg);
+}
+
+template<class DataType>
+template<class Item>
+bool PDBBulkLoader<DataType>::load(std::vector<PDBBulkLoadPart<Item>> &parts,
+                                   const std::function<Handle<DataType>(Item&)> &makeRecord,
+                                   std::string &errMsg) {
+
+  // get the lease so we know if the set is partitioned
+  if(!requestLease(errMsg)) {
+    return false;
+  }
+
+  // if it is we need the key of the records
+  if(lease.isPartitioned() && key == nullptr) {
+    std::string releaseError;
+    lease.releaseLease(releaseError);
+    errMsg = "The set is partitioned, but the partition key was not provided.";
+    return false;
+  }
+
+  // and it has to be the key the set is partitioned on, otherwise the records would end up on the wrong nodes
+  if(lease.isPartitioned() && keyName != lease.getPartitionKey()) {
+    std::string releaseError;
+    lease.releaseLease(releaseError);
+    errMsg = "The set is partitioned on " + lease.getPartitionKey() + ", but the provided key is " + keyName + ".";
+    return false;
+  }
+
+  // build the parts and send the pages
+  bool success = run(parts.size(), [&](size_t part, std::string &error) {
+    return buildPart<Item>(parts[part], makeRecord, error);
+  }, errMsg);
+
+  // return the lease, so the set is unlocked
+  std::string releaseError;
+  if(!lease.releaseLease(releaseError) && success) {
+    errMsg = releaseError;
+    return false;
+  }
+
+  return success;
+}
+
+template<class DataType>
+template<class Item>
+bool PDBBulkLoader<DataType>::buildPart(PDBBulkLoadPart<Item> &part,
+                                        const std::function<Handle<DataType>(Item&)> &makeRecord,
+                                        std::string &errMsg) {
+  // get the first item
+  Item item;
+  bool hasItem = part(item);
+  while(hasItem) {
+
+    // we build the page in place, so that we don't have to copy it
+    PDBBulkLoadPage page;
+    page.bytes = std::unique_ptr<char[]>(new char[options.pageSize]);
+
+    size_t numOnPage;
+    std::vector<PDBBulkLoadPage> splits;
+    {
+      const UseTemporaryAllocationBlock tempBlock{page.bytes.get(), options.pageSize};
+
+      // make the vector
+      Handle<Vector<Handle<DataType>>> records = makeObject<Vector<Handle<DataType>>>();
+      if(records == nullptr) {
+        errMsg = "The pages of the bulk load are too small.";
+        return false;
+      }
+
+      // add records until the page is full, the item of the record that did not fit goes on the next page
+      try {
+        while(hasItem) {
+
+          // make the record
+          Handle<DataType> record = makeRecord(item);
+          if(record == nullptr) {
+            throw NotEnoughSpace();
+          }
+
+          // add it and get the next item
+          records->push_back(record);
+          hasItem = part(item);
+        }
+      } catch (NotEnoughSpace &n) {}
+
+      // if not even one record fits we can not load it
+      numOnPage = records->size();
+      if(numOnPage == 0) {
+        errMsg = "A record of the type " + getTypeName<DataType>() + " does not fit on a page of " +
+                 std::to_string(options.pageSize) + " bytes.";
+        return false;
+      }
+
+      // if the set is partitioned we split the page by the node each record goes to, otherwise we send the page as is
+      if(lease.isPartitioned()) {
+        splitPage(lease, records, key, splits);
+      }
+      else {
+        page.numBytes = getRecord(records)->numBytes();
+      }
+
+      // the page is done, we don't want the records destroyed when the handle goes away
+      records.emptyOutContainingBlock();
+    }
+
+    // add the page or its splits to the queue
+    if(splits.empty()) {
+      splits.emplace_back(std::move(page));
+    }
+    for(auto &split : splits) {
+
+      // columnar sets get the records column by column
+      if(lease.isColumnar() && !makeColumnar(split, errMsg)) {
+        return false;
+      }
+
+      if(!addPage(std::move(split))) {
+        errMsg = "The bulk load failed.";
+        return false;
+      }
+    }
+
+    // we loaded them
+    numRecords += numOnPage;
+  }
+
+  return true;
+}
+
+template<class DataType>
+bool PDBBulkLoader<DataType>::makeColumnar(PDBBulkLoadPage &page, std::string &errMsg) {
+
+  // write the records of the page column by column, the handle has to be gone before we free the page
+  std::vector<char> columnar;
+  {
+    Handle<Vector<Handle<DataType>>> records = ((Record<Vector<Handle<DataType>>>*) page.bytes.get())->getRootObject();
+    if(!encodeColumnarPage<DataType>(records, page.numBytes, columnar, errMsg)) {
+      return false;
+    }
+  }
+
+  // and replace the record with them
+  page.bytes = std::unique_ptr<char[]>(new char[columnar.size()]);
+  memcpy(page.bytes.get(), columnar.data(), columnar.size());
+  page.numBytes = columnar.size();
+
+  return true;
+}
+
+template<class DataType>
+void PDBBulkLoader<DataType>::splitPage(const PDBStoragePageSender &sender,
+                                        Handle<Vector<Handle<DataType>>> &page,
+                                        const std::function<int64_t(Handle<DataType>&)> &key,
+                                        std::vector<PDBBulkLoadPage> &splits) {
+
+  // figure out the node of each record and how many records each node gets
+  auto &records = *page;
+  std::vector<size_t> recordNodes(records.size());
+  std::vector<size_t> counts(sender.getNumNodes(), 0);
+  for(size_t i = 0; i < records.size(); ++i) {
+    recordNodes[i] = sender.getNodeForKey(key(records[i]));
+    counts[recordNodes[i]]++;
+  }
+
+  // make the part for each node, a part is never larger than the page so we start with that
+  for(size_t node = 0; node < counts.size(); ++node) {
+
+    // skip the nodes that don't get anything
+    if(counts[node] == 0) {
+      continue;
+    }
+
+    // if we run out of space we try again with a larger block
+    size_t blockSize = getRecord(page)->numBytes() + 1024;
+    while(true) {
+
+      // the page of this node
+      PDBBulkLoadPage split;
+      split.bytes = std::unique_ptr<char[]>(new char[blockSize]);
+      split.node = node;
+      split.assigned = true;
+
+      try {
+
+        // copy the records of this node
+        const UseTemporaryAllocationBlock tempBlock{split.bytes.get(), blockSize};
+        Handle<Vector<Handle<DataType>>> part = makeObject<Vector<Handle<DataType>>>(counts[node]);
+        if(part == nullptr) {
+          throw NotEnoughSpace();
+        }
+        for(size_t i = 0; i < records.size(); ++i) {
+          if(recordNodes[i] == node) {
+            part->push_back(records[i]);
+          }
+        }
+
+        // the part is done, keep the records
+        split.numBytes = getRecord(part)->numBytes();
+        part.emptyOutContainingBlock();
+
+      } catch (NotEnoughSpace &n) {
+        blockSize *= 2;
+        continue;
+      }
+
+      splits.emplace_back(std::move(split));
+      break;
+    }
+  }
+}
+
+}
@@ -19,6 +19,8 @@
 #define CATALOG_CLIENT_H
 
 #include <PDBCatalogSet.h>
+#include <PDBCatalogSetOnNode.h>
+#include <PDBSetPartitioning.h>
 #include "CatSharedLibraryByNameRequest.h"
 #include "CatSyncRequest.h"
 #include "CatPrintCatalogRequest.h"
@@ -109,6 +111,24 @@ public:
   template <class DataType>
   bool createSet(std::string databaseName, std::string setName, std::string &errMsg);
 
+  /**
+   * Same as above, but the records of the set are placed on the workers by their key
+   * @param partitioning - how the set is partitioned
+   */
+  template <class DataType>
+  bool createSet(std::string databaseName, std::string setName, const PDBSetPartitioning &partitioning, std::string &errMsg);
+
+  /**
+   * Same as above, but the pages of the set are compressed with a codec when they are stored
+   * @param storageCodec - the name of the codec of the pages @see PDBCodec
+   */
+  template <class DataType>
+  bool createSet(std::string databaseName,
+                 std::string setName,
+                 const PDBSetPartitioning &partitioning,
+                 const std::string &storageCodec,
+                 std::string &errMsg);
+
   /* same as above, but here we use the type code */
   bool createSet(const std::string &typeName, int16_t typeID, const std::string &databaseName,
                  const std::string &setName, std::string &errMsg);
@@ -135,6 +155,34 @@ public:
                         size_t sizeToAdd,
                         std::string &errMsg);
 
+  /**
+   * Increments the size of a set and the size of the set on the node that stored the data
+   * @param databaseName - the database the set belongs to
+   * @param setName - the name of the set
+   * @param nodeID - the node that stored the data
+   * @param sizeToAdd - the size we want to add to the current size
+   * @param pagesToAdd - the number of pages the node stored
+   * @param errMsg - the error message if any
+   * @return - true if we succeed
+   */
+  bool incrementSetSize(const std::string &databaseName,
+                        const std::string &setName,
+                        const std::string &nodeID,
+                        size_t sizeToAdd,
+                        size_t pagesToAdd,
+                        std::string &errMsg);
+
+  /**
+   * Returns how much of the set is on each node, the nodes that never stored any of the set are not included
+   * @param databaseName - the database the set belongs to
+   * @param setName - the name of the set
+   * @param errMsg - the error message if any
+   * @return - the size of the set on each node
+   */
+  std::vector<PDBCatalogSetOnNodePtr> getSetOnNodes(const std::string &databaseName,
+                                                    const std::string &setName,
+                                                    std::string &errMsg);
+
   /**
    * Update the container type of a set for a particular set by size
    * @param databaseName - the database the set belongs to
@@ -148,6 +196,20 @@ public:
                               PDBCatalogSetContainerType containerType,
                               std::string &errMsg);
 
+  /**
+   * Assigns the nodes the partitions of a set are placed on. The manager keeps the nodes the set already has and gives
+   * the set the nodes of its co-partitioning group if the group has them, the set has to be fetched again to see them.
+   * @param databaseName - the database the set belongs to
+   * @param setName - the name of the set
+   * @param partitionNodes - the ids of the nodes separated by a comma
+   * @param errMsg - the error message if any
+   * @return - true if we succeed
+   */
+  bool updateSetPartitionNodes(const std::string &databaseName,
+                               const std::string &setName,
+                               const std::string &partitionNodes,
+                               std::string &errMsg);
+
   /* Sends a request to the Catalog Server to delete a database; returns true on
    * success, false on
    * fail
@@ -190,6 +252,9 @@ public:
   /* Lists the user-defined types registered in the catalog. */
   string listUserDefinedTypes(std::string &errMsg);
 
+  /* Lists how many bytes and pages of a set each worker has and how unevenly the set is spread. */
+  string listSetStorageImbalance(const std::string &databaseName, const std::string &setName, std::string &errMsg);
+
 
 private:
 
@@ -30,6 +30,25 @@ template <class DataType>
 bool PDBCatalogClient::createSet(std::string databaseName, std::string setName,
                               std::string &errMsg) {
 
+  // the set is not partitioned
+  return createSet<DataType>(databaseName, setName, PDBSetPartitioning(), errMsg);
+}
+
+template <class DataType>
+bool PDBCatalogClient::createSet(std::string databaseName, std::string setName,
+                                 const PDBSetPartitioning &partitioning, std::string &errMsg) {
+
+  // the pages of the set are stored as they are
+  return createSet<DataType>(databaseName, setName, partitioning, "none", errMsg);
+}
+
+template <class DataType>
+bool PDBCatalogClient::createSet(std::string databaseName,
+                                 std::string setName,
+                                 const PDBSetPartitioning &partitioning,
+                                 const std::string &storageCodec,
+                                 std::string &errMsg) {
+
   // figure out the type name
   std::string typeName = VTableMap::getInternalTypeName(getTypeName<DataType>());
 
@@ -55,7 +74,8 @@ bool PDBCatalogClient::createSet(std::string databaseName, std::string setName,
         errMsg = "Error getting type name: got nothing back from catalog";
         return false;
       },
-      databaseName, setName, typeName, typeID);
+      databaseName, setName, typeName, typeID, partitioning.type, partitioning.numPartitions,
+      partitioning.key, partitioning.group, partitioning.boundaries, storageCodec);
 }
 }
 
@@ -26,6 +26,7 @@
 #include "PDBVector.h"
 #include "HeapRequest.h"
 #include "PDBComputationClient.h"
+#include "PDBPreparedComputation.h"
 
 /**
  * This class provides functionality so users can connect and access
@@ -89,6 +90,66 @@ class PDBClient : public ServerFunctionality {
   template<class DataType>
   bool createSet(const std::string &databaseName, const std::string &setName);
 
+  /**
+   * Creates a set whose pages are compressed once when they are stored and stay compressed on disk. They are
+   * decompressed when a computation reads them and are sent to the clients without compressing them again.
+   *
+   * @tparam DataType - the type of the data the set stores
+   * @param databaseName - the name of the database
+   * @param setName - the name of the set we want to create
+   * @param storageCodec - the name of the codec of the pages, for example "snappy" or "zstd:9" @see PDBCodec
+   * @return - true if we succeed
+   */
+  template<class DataType>
+  bool createSet(const std::string &databaseName, const std::string &setName, const std::string &storageCodec);
+
+  /**
+   * Creates a set whose records are placed on the workers by their key. Sets in the same co-partitioning group get
+   * the same placement, so the joins and aggregations on the partitioning key can run without a shuffle.
+   *
+   * @tparam DataType - the type of the data the set stores
+   * @param databaseName - the name of the database
+   * @param setName - the name of the set we want to create
+   * @param partitioning - how the set is partitioned @see PDBSetPartitioning
+   * @param key - returns the key of a record, it has to match the attribute or method named by the partitioning
+   * @param storageCodec - the codec the pages of the set are stored with
+   * @return - true if we succeed
+   */
+  template<class DataType>
+  bool createSet(const std::string &databaseName,
+                 const std::string &setName,
+                 const PDBSetPartitioning &partitioning,
+                 std::function<int64_t(Handle<DataType>&)> key,
+                 const std::string &storageCodec = "none");
+
+  /**
+   * Creates a set whose pages store the records column by column, each column is encoded with whatever makes it the
+   * smallest (dictionary, run length, delta or bit-packing). A scan that only accesses the members of the records
+   * does not make the records at all. The type has to describe its columns @see PDBColumns.
+   *
+   * @tparam DataType - the type of the data the set stores
+   * @param databaseName - the name of the database
+   * @param setName - the name of the set we want to create
+   * @param storageCodec - the codec the pages of the set are stored with
+   * @return - true if we succeed
+   */
+  template<class DataType>
+  bool createColumnarSet(const std::string &databaseName, const std::string &setName, const std::string &storageCodec = "none");
+
+  /**
+   * Sets the function that extracts the key of a record for a partitioned set that was created by another client
+   * @tparam DataType - the type of the data the set stores
+   * @param databaseName - the name of the database
+   * @param setName - the name of the set
+   * @param keyName - the name of the attribute or method the key is, it has to be the one the set is partitioned on
+   * @param key - returns the key of a record
+   */
+  template<class DataType>
+  void setPartitionKey(const std::string &databaseName,
+                       const std::string &setName,
+                       const std::string &keyName,
+                       std::function<int64_t(Handle<DataType>&)> key);
+
   /**
    * Sends a request to the Catalog Server to register a user-defined type defined in a shared library.
    * @param fileContainingSharedLib - the file that contains the library
@@ -114,6 +175,16 @@ class PDBClient : public ServerFunctionality {
    */
   bool executeComputations(Handle<Vector<Handle<Computation>>> &computations, const pdb::String &tcap);
 
+  /**
+   * Runs the query with the provided computations and TCAP string and returns the profile of the query, the time, rows,
+   * bytes, pages and retries of every operator of every job summed up over all the threads and nodes
+   * @param computations - the computations asocciated with the TACP
+   * @param tcap - the TCAP string we are running
+   * @param profile - the profile, @see PDBProfile::toString to print it
+   * @return true if we succeed in executing
+   */
+  bool executeComputations(Handle<Vector<Handle<Computation>>> &computations, const pdb::String &tcap, PDBProfile &profile);
+
   /**
    * Runs the query by specifying just the sinks, the tcap will be automatically generated
    * @param computations - the computations
@@ -121,6 +192,46 @@ class PDBClient : public ServerFunctionality {
    */
   bool executeComputations(const std::vector<Handle<Computation>> &sinks);
 
+  /**
+   * Runs the query by specifying just the sinks and returns the profile of the query
+   * @param sinks - the computations
+   * @param profile - the profile, @see PDBProfile::toString to print it
+   * @return true if we succeed false otherwise
+   */
+  bool executeComputations(const std::vector<Handle<Computation>> &sinks, PDBProfile &profile);
+
+  /**
+   * Generates the TCAP of the query once and keeps it on the manager, so it can be run many times with
+   * @see executeComputations by sending just its id. The manager and the workers cache the parsed TCAP and what they
+   * make from it, so only the first run pays for parsing and planning it.
+   * @param sinks - the sinks of the query
+   * @return the prepared computation, null if the manager could not prepare it, @see getErrorMessage for why
+   */
+  PDBPreparedComputationPtr prepareComputations(const std::vector<Handle<Computation>> &sinks);
+
+  /**
+   * Runs a prepared query with the parameters set by @see PDBPreparedComputation::setParameters
+   * @param prepared - the prepared query
+   * @return true if we succeed false otherwise
+   */
+  bool executeComputations(const PDBPreparedComputationPtr &prepared);
+
+  /**
+   * Runs a prepared query and returns the profile of the query, the planning on the manager and the setup of the
+   * jobs on the workers are in it, so the startup time of each run can be seen
+   * @param prepared - the prepared query
+   * @param profile - the profile, @see PDBProfile::toString to print it
+   * @return true if we succeed false otherwise
+   */
+  bool executeComputations(const PDBPreparedComputationPtr &prepared, PDBProfile &profile);
+
+  /**
+   * Sets how the computations we run from now on are scheduled by the manager
+   * @param priority - the computations with a higher priority are admitted first
+   * @param memoryBudget - how many bytes of the buffer pool of each node a computation can pin, 0 for an equal share
+   */
+  void setComputationScheduling(int32_t priority, uint64_t memoryBudget);
+
   /**
    * Lists all metadata registered in the catalog.
    */
@@ -147,6 +258,13 @@ class PDBClient : public ServerFunctionality {
    */
   void listUserDefinedTypes();
 
+  /**
+   * Lists how many bytes and pages of a set each worker has and how unevenly the set is spread.
+   * @param databaseName - the name of the database
+   * @param setName - the name of the set
+   */
+  void listSetStorageImbalance(const std::string &databaseName, const std::string &setName);
+
   /**
    * Send the data to be stored in a set
    * @param setAndDatabase - the database name and set name
@@ -155,6 +273,66 @@ class PDBClient : public ServerFunctionality {
   template<class DataType>
   bool sendData(const std::string &database, const std::string &set, Handle<Vector<Handle<DataType>>> dataToSend);
 
+  /**
+   * Send multiple pages of data to be stored in a set, the pages are sent to the workers in parallel
+   * @param database - the database name
+   * @param set - the set name
+   * @param dataToSend - the pages, each one has to be the root object of its own allocation block
+   * @return true if every page was stored, false otherwise, the error can be grabbed with @see getErrorMessage
+   */
+  template<class DataType>
+  bool sendData(const std::string &database, const std::string &set, std::vector<Handle<Vector<Handle<DataType>>>> &dataToSend);
+
+  /**
+   * Loads the records a function makes into a set, the records are built and sent by many threads @see PDBBulkLoader
+   * @param database - the database name
+   * @param set - the set name
+   * @param numRecords - the number of records
+   * @param makeRecord - makes the record with the index, it is called by many threads at the same time
+   * @param options - the knobs of the load
+   * @return true if we succeed false otherwise
+   */
+  template<class DataType>
+  bool bulkLoad(const std::string &database,
+                const std::string &set,
+                size_t numRecords,
+                const std::function<Handle<DataType>(size_t)> &makeRecord,
+                const PDBBulkLoadOptions &options = PDBBulkLoadOptions());
+
+  /**
+   * Loads the records of a text file into a set, one record per line
+   * @param database - the database name
+   * @param set - the set name
+   * @param path - the path to the file
+   * @param parseLine - makes the record of a line, it is called by many threads at the same time
+   * @param options - the knobs of the load
+   * @return true if we succeed false otherwise
+   */
+  template<class DataType>
+  bool bulkLoadTextFile(const std::string &database,
+                        const std::string &set,
+                        const std::string &path,
+                        const std::function<Handle<DataType>(const std::string&)> &parseLine,
+                        const PDBBulkLoadOptions &options = PDBBulkLoadOptions());
+
+  /**
+   * Loads the records of a file of fixed size records into a set
+   * @param database - the database name
+   * @param set - the set name
+   * @param path - the path to the file
+   * @param recordSize - the size of a record in the file
+   * @param parseRecord - makes the record from its bytes, it is called by many threads at the same time
+   * @param options - the knobs of the load
+   * @return true if we succeed false otherwise
+   */
+  template<class DataType>
+  bool bulkLoadBinaryFile(const std::string &database,
+                          const std::string &set,
+                          const std::string &path,
+                          size_t recordSize,
+                          const std::function<Handle<DataType>(const char*)> &parseRecord,
+                          const PDBBulkLoadOptions &options = PDBBulkLoadOptions());
+
   bool clearSet(const std::string &dbName, const std::string &setName);
 
   bool removeSet(const std::string &dbName, const std::string &setName);
@@ -174,6 +352,10 @@ class PDBClient : public ServerFunctionality {
   // Error Message (if an error occurred)
   std::string errorMsg;
 
+  // the priority and the memory budget of the computations we run
+  int32_t computationPriority = 0;
+  uint64_t computationMemoryBudget = 0;
+
   // Message returned by a PlinyCompute function
   std::string returnedMsg;
 
@@ -19,6 +19,7 @@
 #define PDB_CLIENT_TEMPLATE_CC
 
 #include "PDBClient.h"
+#include "PDBColumns.h"
 
 namespace pdb {
 
@@ -37,6 +38,65 @@ namespace pdb {
     return result;
   }
 
+  template <class DataType>
+  bool PDBClient::createSet(const std::string &databaseName, const std::string &setName, const std::string &storageCodec) {
+
+    bool result = catalogClient->template createSet<DataType>(databaseName, setName, PDBSetPartitioning(), storageCodec, returnedMsg);
+
+    if (!result) {
+        errorMsg = "Not able to create set: " + returnedMsg;
+    } else {
+        cout << "Created set.\n";
+    }
+
+    return result;
+  }
+
+  template <class DataType>
+  bool PDBClient::createSet(const std::string &databaseName,
+                            const std::string &setName,
+                            const PDBSetPartitioning &partitioning,
+                            std::function<int64_t(Handle<DataType>&)> key,
+                            const std::string &storageCodec) {
+
+    bool result = catalogClient->template createSet<DataType>(databaseName, setName, partitioning, storageCodec, returnedMsg);
+
+    if (!result) {
+        errorMsg = "Not able to create set: " + returnedMsg;
+    } else {
+        distributedStorage->template setPartitionKey<DataType>(databaseName, setName, partitioning.key, std::move(key));
+        cout << "Created set.\n";
+    }
+
+    return result;
+  }
+
+  template <class DataType>
+  bool PDBClient::createColumnarSet(const std::string &databaseName, const std::string &setName, const std::string &storageCodec) {
+
+    static_assert(hasColumns<DataType>::value, "The type of a columnar set has to describe its columns.");
+
+    // create the set and mark it as columnar before anything is added to it
+    bool result = catalogClient->template createSet<DataType>(databaseName, setName, PDBSetPartitioning(), storageCodec, returnedMsg) &&
+                  catalogClient->updateSetContainerType(databaseName, setName, PDB_CATALOG_SET_COLUMNAR_CONTAINER, returnedMsg);
+
+    if (!result) {
+        errorMsg = "Not able to create set: " + returnedMsg;
+    } else {
+        cout << "Created set.\n";
+    }
+
+    return result;
+  }
+
+  template <class DataType>
+  void PDBClient::setPartitionKey(const std::string &databaseName,
+                                  const std::string &setName,
+                                  const std::string &keyName,
+                                  std::function<int64_t(Handle<DataType>&)> key) {
+    distributedStorage->template setPartitionKey<DataType>(databaseName, setName, keyName, std::move(key));
+  }
+
   template <class DataType>
   bool PDBClient::sendData(const std::string &database, const std::string &set, Handle<Vector<Handle<DataType>>> dataToSend) {
 
@@ -51,6 +111,70 @@ namespace pdb {
     return result;
   }
 
+  template <class DataType>
+  bool PDBClient::sendData(const std::string &database, const std::string &set, std::vector<Handle<Vector<Handle<DataType>>>> &dataToSend) {
+
+    bool result = distributedStorage->sendData<DataType>(database, set, dataToSend, returnedMsg);
+
+    // the caller gets the error through getErrorMessage
+    if (!result) {
+        errorMsg = "Not able to send data: " + returnedMsg;
+    }
+    return result;
+  }
+
+  template <class DataType>
+  bool PDBClient::bulkLoad(const std::string &database,
+                           const std::string &set,
+                           size_t numRecords,
+                           const std::function<Handle<DataType>(size_t)> &makeRecord,
+                           const PDBBulkLoadOptions &options) {
+
+    bool result = distributedStorage->bulkLoad<DataType>(database, set, numRecords, makeRecord, options, returnedMsg);
+
+    if (!result) {
+        errorMsg = "Not able to load data: " + returnedMsg;
+    } else {
+        cout << "Data loaded.\n";
+    }
+    return result;
+  }
+
+  template <class DataType>
+  bool PDBClient::bulkLoadTextFile(const std::string &database,
+                                   const std::string &set,
+                                   const std::string &path,
+                                   const std::function<Handle<DataType>(const std::string&)> &parseLine,
+                                   const PDBBulkLoadOptions &options) {
+
+    bool result = distributedStorage->bulkLoadTextFile<DataType>(database, set, path, parseLine, options, returnedMsg);
+
+    if (!result) {
+        errorMsg = "Not able to load data: " + returnedMsg;
+    } else {
+        cout << "Data loaded.\n";
+    }
+    return result;
+  }
+
+  template <class DataType>
+  bool PDBClient::bulkLoadBinaryFile(const std::string &database,
+                                     const std::string &set,
+                                     const std::string &path,
+                                     size_t recordSize,
+                                     const std::function<Handle<DataType>(const char*)> &parseRecord,
+                                     const PDBBulkLoadOptions &options) {
+
+    bool result = distributedStorage->bulkLoadBinaryFile<DataType>(database, set, path, recordSize, parseRecord, options, returnedMsg);
+
+    if (!result) {
+        errorMsg = "Not able to load data: " + returnedMsg;
+    } else {
+        cout << "Data loaded.\n";
+    }
+    return result;
+  }
+
   template<class DataType>
   PDBStorageIteratorPtr<DataType> PDBClient::getSetIterator(const std::string& dbName, const std::string& setName) {
 
@@ -64,9 +188,10 @@ namespace pdb {
     }
 
     // check what kind of set we are dealing with
-    if(set->containerType == PDBCatalogSetContainerType::PDB_CATALOG_SET_VECTOR_CONTAINER) {
+    if(set->containerType == PDBCatalogSetContainerType::PDB_CATALOG_SET_VECTOR_CONTAINER ||
+       set->containerType == PDBCatalogSetContainerType::PDB_CATALOG_SET_COLUMNAR_CONTAINER) {
 
-      // returns the vector iterator
+      // returns the vector iterator, it turns the columnar pages back into vectors
       return distributedStorage->getVectorIterator<DataType>(dbName, setName);
     }
     else if(set->containerType == PDBCatalogSetContainerType::PDB_CATALOG_SET_MAP_CONTAINER) {
@@ -77,7 +202,7 @@ namespace pdb {
     else {
 
       // ok we can only handle vector and map sets this is a problem
-      throw runtime_error("The iterator can only be obtained for vector sets or map sets.");
+      throw runtime_error("The iterator can only be obtained for vector, columnar or map sets.");
     }
   }
 
@@ -7,6 +7,7 @@
 
 #include <ServerFunctionality.h>
 #include <Computation.h>
+#include <PDBProfile.h>
 
 namespace pdb {
 
@@ -22,9 +23,23 @@ public:
    * @param computations
    * @param tcap
    * @param error
+   * @param profile - if not null the profile of the operators the computation ran is added to it
+   * @param priority - the computations with a higher priority are admitted first
+   * @param memoryBudget - how many bytes of the buffer pool of each node the computation can pin, 0 for an equal share
+   * @param preparedID - the id of the prepared query whose TCAP we run instead of the one we send, 0 if none
    * @return
    */
-  bool executeComputations(Handle<Vector<Handle<Computation>>> &computations, const pdb::String &tcap, std::string &error);
+  bool executeComputations(Handle<Vector<Handle<Computation>>> &computations, const pdb::String &tcap, std::string &error,
+                           PDBProfile *profile = nullptr, int32_t priority = 0, uint64_t memoryBudget = 0,
+                           uint64_t preparedID = 0);
+
+  /**
+   * Keeps the TCAP of a query on the manager, so it can be run by its id
+   * @param tcap - the TCAP of the query
+   * @param error - the error if the manager could not prepare it
+   * @return the id of the prepared query, 0 if we failed
+   */
+  uint64_t prepareComputations(const std::string &tcap, std::string &error);
 
   /**
    *
@@ -25,6 +25,10 @@
 #include "Handle.h"
 #include "PDBVector.h"
 #include "PDBCatalogClient.h"
+#include "PDBStoragePageSender.h"
+#include "PDBBulkLoader.h"
+#include <functional>
+#include <map>
 
 namespace pdb {
 
@@ -56,13 +60,94 @@ public:
   void registerHandlers(PDBServer &forMe) override {};
 
   /**
-   * Send the data to the distributed storage
+   * Send the data to the distributed storage. The data does not go through the manager, the manager just tells us
+   * what worker to send it to @see PDBStoragePageSender
    * @param setAndDatabase - the set and database pair where we want to
    * @return true if we succeed false otherwise
    */
   template<class DataType>
   bool sendData(const std::string &db, const std::string &set, Handle<Vector<Handle<DataType>>> dataToSend, std::string &errMsg);
 
+  /**
+   * Send multiple pages of data to the distributed storage. The pages are sent directly to the workers in parallel,
+   * each vector must be the root object of its own allocation block and has to fit on a single page.
+   * @param db - the database the set belongs to
+   * @param set - the set we are sending the data to
+   * @param dataToSend - the pages we are sending
+   * @param errMsg - the error if we fail
+   * @return true if we succeed false otherwise
+   */
+  template<class DataType>
+  bool sendData(const std::string &db, const std::string &set, std::vector<Handle<Vector<Handle<DataType>>>> &dataToSend, std::string &errMsg);
+
+  /**
+   * Sets the function that extracts the key of a record for a partitioned set. The records sent to the set are split
+   * by this key and each part is sent to the worker the partitioning of the set places it on.
+   * @param db - the database the set belongs to
+   * @param set - the set
+   * @param keyName - the name of the attribute or method the function extracts, it has to be the one the set is partitioned on
+   * @param key - returns the key of a record
+   */
+  template<class DataType>
+  void setPartitionKey(const std::string &db, const std::string &set, const std::string &keyName, std::function<int64_t(Handle<DataType>&)> key);
+
+  /**
+   * Loads the records a function makes into the set, the records are made and put on pages by many threads and the
+   * pages are sent while the next ones are built @see PDBBulkLoader
+   * @param db - the database the set belongs to
+   * @param set - the set we are loading the records into
+   * @param numRecords - the number of records
+   * @param makeRecord - makes the record with the index, it is called by many threads at the same time
+   * @param options - the knobs of the load
+   * @param errMsg - the error if we fail
+   * @return true if we succeed false otherwise
+   */
+  template<class DataType>
+  bool bulkLoad(const std::string &db,
+                const std::string &set,
+                size_t numRecords,
+                const std::function<Handle<DataType>(size_t)> &makeRecord,
+                const PDBBulkLoadOptions &options,
+                std::string &errMsg);
+
+  /**
+   * Loads the records of a text file into the set, one record per line. The parts of the file are read in parallel.
+   * @param db - the database the set belongs to
+   * @param set - the set we are loading the records into
+   * @param path - the path to the file
+   * @param parseLine - makes the record of a line, it is called by many threads at the same time
+   * @param options - the knobs of the load
+   * @param errMsg - the error if we fail
+   * @return true if we succeed false otherwise
+   */
+  template<class DataType>
+  bool bulkLoadTextFile(const std::string &db,
+                        const std::string &set,
+                        const std::string &path,
+                        const std::function<Handle<DataType>(const std::string&)> &parseLine,
+                        const PDBBulkLoadOptions &options,
+                        std::string &errMsg);
+
+  /**
+   * Loads the records of a file of fixed size records into the set. The parts of the file are read in parallel.
+   * @param db - the database the set belongs to
+   * @param set - the set we are loading the records into
+   * @param path - the path to the file
+   * @param recordSize - the size of a record in the file
+   * @param parseRecord - makes the record from its bytes, it is called by many threads at the same time
+   * @param options - the knobs of the load
+   * @param errMsg - the error if we fail
+   * @return true if we succeed false otherwise
+   */
+  template<class DataType>
+  bool bulkLoadBinaryFile(const std::string &db,
+                          const std::string &set,
+                          const std::string &path,
+                          size_t recordSize,
+                          const std::function<Handle<DataType>(const char*)> &parseRecord,
+                          const PDBBulkLoadOptions &options,
+                          std::string &errMsg);
+
   /**
    * Removes all the data from a set
    * @param dbName - the name of the database
@@ -97,6 +182,43 @@ public:
 
 private:
 
+  /**
+   * Returns the function that extracts the key of a record for a set
+   * @param db - the database the set belongs to
+   * @param set - the set
+   * @return the function or null if we don't have one
+   */
+  template<class DataType>
+  std::function<int64_t(Handle<DataType>&)> getPartitionKey(const std::string &db, const std::string &set);
+
+  /**
+   * Returns the name of the attribute or method the key function of a set extracts
+   * @param db - the database the set belongs to
+   * @param set - the set
+   * @return the name, empty if we don't have a key function for the set
+   */
+  std::string getPartitionKeyName(const std::string &db, const std::string &set);
+
+  /**
+   * Checks that the key function we have for a partitioned set extracts the key the set is partitioned on
+   * @param db - the database the set belongs to
+   * @param set - the set
+   * @param sender - the sender that has the lease of the set
+   * @param errMsg - the error if the keys don't match
+   * @return true if the set is not partitioned or the keys match, false otherwise
+   */
+  bool checkPartitionKey(const std::string &db, const std::string &set, const PDBStoragePageSender &sender, std::string &errMsg);
+
+  /**
+   * The functions that extract the keys of the records for each partitioned set (database, set)
+   */
+  std::map<std::pair<std::string, std::string>, std::shared_ptr<void>> partitionKeys;
+
+  /**
+   * The names of the keys the functions in partitionKeys extract
+   */
+  std::map<std::pair<std::string, std::string>, std::string> partitionKeyNames;
+
   /**
    * The port of the manager
    */
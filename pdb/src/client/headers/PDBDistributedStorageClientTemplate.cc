@@ -26,6 +26,8 @@
 #include "SimpleRequestResult.h"
 #include "PDBStorageVectorIterator.h"
 #include "PDBStorageMapIterator.h"
+#include "PDBStoragePageSender.h"
+#include "PDBColumns.h"
 
 
 namespace pdb {
@@ -34,20 +36,146 @@ template<class DataType>
 bool PDBDistributedStorageClient::sendData(const std::string &db, const std::string &set,
                                    Handle<Vector<Handle<DataType>>> dataToSend, std::string &errMsg) {
 
+  // send it as a single page
+  std::vector<Handle<Vector<Handle<DataType>>>> pages = { dataToSend };
+  return sendData<DataType>(db, set, pages, errMsg);
+}
+
+template<class DataType>
+bool PDBDistributedStorageClient::sendData(const std::string &db, const std::string &set,
+                                           std::vector<Handle<Vector<Handle<DataType>>>> &dataToSend, std::string &errMsg) {
+
+  // if there is nothing to send we are done
+  if(dataToSend.empty()) {
+    return true;
+  }
+
+  // the sender that is going to send the pages directly to the workers
+  PDBStoragePageSender sender(address, port, 5, set, db, getTypeName<DataType>());
+
+  // get the lease so we know if the set is partitioned
+  if(!sender.requestLease(errMsg)) {
+    return false;
+  }
+
+  // if the set is columnar the records are sent column by column, the pages have to stay around until they are sent
+  std::vector<std::vector<char>> columnarPages;
+  auto addPage = [&](Handle<Vector<Handle<DataType>>> records, const char *bytes, size_t numBytes, int64_t node) {
+
+    // write the records column by column if we need to
+    if(sender.isColumnar()) {
+      columnarPages.emplace_back();
+      if(!encodeColumnarPage<DataType>(records, numBytes, columnarPages.back(), errMsg)) {
+        return false;
+      }
+      bytes = columnarPages.back().data();
+      numBytes = columnarPages.back().size();
+    }
+
+    // add it to the sender
+    if(node < 0) {
+      sender.addPage(bytes, numBytes);
+    } else {
+      sender.addPage(bytes, numBytes, (size_t) node);
+    }
+    return true;
+  };
+
+  // if the set is not partitioned we just add the records of the pages
+  if(!sender.isPartitioned()) {
+    columnarPages.reserve(dataToSend.size());
+    for(auto &page : dataToSend) {
+      auto* record = getRecord(page);
+      if(!addPage(page, (char*) record, record->numBytes(), -1)) {
+        return false;
+      }
+    }
+    return sender.send(errMsg);
+  }
+
+  // the set is partitioned, we need the key of the records and it has to be the one the set is partitioned on
+  auto key = getPartitionKey<DataType>(db, set);
+  if(key == nullptr) {
+    errMsg = "The set (" + db + "," + set + ") is partitioned, but the partition key was not provided.";
+    return false;
+  }
+  if(!checkPartitionKey(db, set, sender, errMsg)) {
+    return false;
+  }
+
+  // split each page by the node the records go to
+  std::vector<PDBBulkLoadPage> splits;
+  for(auto &page : dataToSend) {
+    PDBBulkLoader<DataType>::splitPage(sender, page, key, splits);
+  }
+
+  // add the parts to the sender and send them
+  columnarPages.reserve(splits.size());
+  for(auto &split : splits) {
+    auto records = ((Record<Vector<Handle<DataType>>>*) split.bytes.get())->getRootObject();
+    if(!addPage(records, split.bytes.get(), split.numBytes, (int64_t) split.node)) {
+      return false;
+    }
+  }
+  return sender.send(errMsg);
+}
 
-  return RequestFactory::dataHeapRequest<DisAddData, DataType, SimpleRequestResult, bool>(
-      logger, port, address, false, 1024, [&](Handle<SimpleRequestResult> result) {
+template<class DataType>
+bool PDBDistributedStorageClient::bulkLoad(const std::string &db,
+                                           const std::string &set,
+                                           size_t numRecords,
+                                           const std::function<Handle<DataType>(size_t)> &makeRecord,
+                                           const PDBBulkLoadOptions &options,
+                                           std::string &errMsg) {
+
+  PDBBulkLoader<DataType> loader(address, port, 5, db, set, getPartitionKey<DataType>(db, set), getPartitionKeyName(db, set), options);
+  return loader.loadRecords(numRecords, makeRecord, errMsg);
+}
+
+template<class DataType>
+bool PDBDistributedStorageClient::bulkLoadTextFile(const std::string &db,
+                                                   const std::string &set,
+                                                   const std::string &path,
+                                                   const std::function<Handle<DataType>(const std::string&)> &parseLine,
+                                                   const PDBBulkLoadOptions &options,
+                                                   std::string &errMsg) {
+
+  PDBBulkLoader<DataType> loader(address, port, 5, db, set, getPartitionKey<DataType>(db, set), getPartitionKeyName(db, set), options);
+  return loader.loadTextFile(path, parseLine, errMsg);
+}
 
-        // check the response
-        if (result != nullptr && !result->getRes().first) {
+template<class DataType>
+bool PDBDistributedStorageClient::bulkLoadBinaryFile(const std::string &db,
+                                                     const std::string &set,
+                                                     const std::string &path,
+                                                     size_t recordSize,
+                                                     const std::function<Handle<DataType>(const char*)> &parseRecord,
+                                                     const PDBBulkLoadOptions &options,
+                                                     std::string &errMsg) {
+
+  PDBBulkLoader<DataType> loader(address, port, 5, db, set, getPartitionKey<DataType>(db, set), getPartitionKeyName(db, set), options);
+  return loader.loadBinaryFile(path, recordSize, parseRecord, errMsg);
+}
+
+template<class DataType>
+void PDBDistributedStorageClient::setPartitionKey(const std::string &db,
+                                                  const std::string &set,
+                                                  const std::string &keyName,
+                                                  std::function<int64_t(Handle<DataType>&)> key) {
+  partitionKeys[std::make_pair(db, set)] = std::make_shared<std::function<int64_t(Handle<DataType>&)>>(std::move(key));
+  partitionKeyNames[std::make_pair(db, set)] = keyName;
+}
+
+template<class DataType>
+std::function<int64_t(Handle<DataType>&)> PDBDistributedStorageClient::getPartitionKey(const std::string &db, const std::string &set) {
 
-          logger->error("Error sending data: " + result->getRes().second);
-          errMsg = "Error sending data: " + result->getRes().second;
-        }
+  // do we have it
+  auto it = partitionKeys.find(std::make_pair(db, set));
+  if(it == partitionKeys.end()) {
+    return nullptr;
+  }
 
-        return true;
-      },
-      dataToSend, db, set, getTypeName<DataType>());
+  return *std::static_pointer_cast<std::function<int64_t(Handle<DataType>&)>>(it->second);
 }
 
 template<class DataType>
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "Handle.h"
+#include "PDBVector.h"
+#include "Computation.h"
+
+namespace pdb {
+
+class PDBPreparedComputation;
+using PDBPreparedComputationPtr = std::shared_ptr<PDBPreparedComputation>;
+
+/**
+ * A query whose TCAP was generated once so it can be run many times, like the iterations of an iterative algorithm.
+ * The manager keeps the TCAP under the id of the query, so a run only sends the id and the computations. The manager
+ * and the workers cache the parsed TCAP and what they make from it, so running the same TCAP again skips that work.
+ * The parameters of a run are set by replacing the computations that hold them, @see setParameters
+ */
+class PDBPreparedComputation {
+ public:
+
+  /**
+   * Makes the prepared computation, @see PDBClient::prepareComputations
+   * @param preparedID - the id the manager keeps the TCAP under
+   * @param tcap - the TCAP of the query
+   * @param computations - the computations of the query in the order of their labels in the TCAP
+   */
+  PDBPreparedComputation(uint64_t preparedID, std::string tcap, Handle<Vector<Handle<Computation>>> computations)
+      : preparedID(preparedID), tcap(std::move(tcap)), computations(std::move(computations)) {}
+
+  /**
+   * Returns the id the manager keeps the TCAP under
+   */
+  uint64_t getPreparedID() const { return preparedID; }
+
+  /**
+   * Returns the TCAP of the query
+   */
+  const std::string &getTCAP() const { return tcap; }
+
+  /**
+   * Returns the computations of the query
+   */
+  Handle<Vector<Handle<Computation>>> &getComputations() { return computations; }
+
+  /**
+   * Replaces a computation of the query with one of the same type that has the parameters for the next run, for
+   * example an aggregation made with the model of the next iteration. The replacement does not need its inputs set,
+   * the TCAP already says where its inputs come from.
+   * @param computation - the computation we are replacing, the one we prepared the query with or a replacement
+   * @param replacement - the computation with the new parameters
+   * @return true if we found the computation and the replacement has the same type, false otherwise
+   */
+  bool setParameters(const Handle<Computation> &computation, const Handle<Computation> &replacement) {
+
+    for (int i = 0; i < computations->size(); ++i) {
+
+      // is this the computation we are replacing, we compare the objects not their values
+      auto &current = (*computations)[i];
+      if (&*current != &*computation) {
+        continue;
+      }
+
+      // the lambdas of the replacement have to match the ones in the TCAP
+      if (current->getComputationType() != replacement->getComputationType() ||
+          current->getOutputType() != replacement->getOutputType()) {
+        return false;
+      }
+
+      current = replacement;
+      return true;
+    }
+
+    return false;
+  }
+
+ private:
+
+  /**
+   * The id the manager keeps the TCAP under
+   */
+  uint64_t preparedID;
+
+  /**
+   * The TCAP of the query
+   */
+  std::string tcap;
+
+  /**
+   * The computations of the query
+   */
+  Handle<Vector<Handle<Computation>>> computations;
+};
+
+}
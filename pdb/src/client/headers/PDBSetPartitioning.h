@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <PDBCatalogSet.h>
+#include <PDBDispatchRangePolicy.h>
+
+namespace pdb {
+
+/**
+ * Describes how the records of a set are placed on the workers, it is provided when the set is created.
+ * The key the records are partitioned on is extracted on the client, the name of the key only tells the
+ * physical optimizer what attribute or method of the record the key is, so that it can run the joins and
+ * aggregations on that key locally.
+ */
+struct PDBSetPartitioning {
+
+  /**
+   * Partitions the records by the hash of their key
+   * @param numPartitions - the number of partitions
+   * @param key - the name of the attribute or method the records are partitioned on, "self" if it is the record itself
+   * @param group - the co-partitioning group, sets in the same group of a database get the same placement
+   * @return the partitioning
+   */
+  static PDBSetPartitioning hash(int32_t numPartitions, const std::string &key, const std::string &group = "") {
+    return PDBSetPartitioning { PDB_CATALOG_SET_HASH_PARTITIONING, numPartitions, key, group, "" };
+  }
+
+  /**
+   * Partitions the records by the range their key falls into
+   * @param boundaries - the largest key of each range, sorted, the larger keys go to an extra last range
+   * @param key - the name of the attribute or method the records are partitioned on, "self" if it is the record itself
+   * @param group - the co-partitioning group, sets in the same group of a database get the same placement
+   * @return the partitioning
+   */
+  static PDBSetPartitioning range(const std::vector<int64_t> &boundaries, const std::string &key, const std::string &group = "") {
+    return PDBSetPartitioning { PDB_CATALOG_SET_RANGE_PARTITIONING,
+                                (int32_t) boundaries.size() + 1,
+                                key,
+                                group,
+                                PDBDispatchRangePolicy::formatBoundaries(boundaries) };
+  }
+
+  /**
+   * The partitioning scheme
+   */
+  PDBCatalogSetPartitionType type = PDB_CATALOG_SET_NO_PARTITIONING;
+
+  /**
+   * The number of partitions
+   */
+  int32_t numPartitions = 0;
+
+  /**
+   * The name of the attribute or method the records are partitioned on
+   */
+  std::string key;
+
+  /**
+   * The co-partitioning group
+   */
+  std::string group;
+
+  /**
+   * The upper boundaries of the ranges separated by a comma
+   */
+  std::string boundaries;
+};
+
+}
@@ -0,0 +1,217 @@
+#include <PDBBulkLoadInput.h>
+#include <fstream>
+#include <memory>
+#include <algorithm>
+#include <sys/stat.h>
+
+const size_t pdb::PDBBulkLoadInput::binaryReadSize;
+
+namespace {
+
+/**
+ * Reads the lines that start in [start, end) of a text file, the file is opened by the thread that reads the part
+ */
+struct TextFilePart {
+
+  bool operator()(std::string &line) {
+
+    // open the file if this is the first line
+    if(file == nullptr) {
+
+      file = std::make_shared<std::ifstream>(path, std::ios::binary);
+      position = start;
+
+      // if the part does not start at the beginning of a line, that line belongs to the previous part
+      if(start != 0) {
+        std::string skipped;
+        file->seekg(start - 1);
+        std::getline(*file, skipped);
+        position = start + skipped.size();
+      }
+    }
+
+    // the lines that start after the end of the part belong to the next part
+    if(position >= end || !std::getline(*file, line)) {
+      return false;
+    }
+    position += line.size() + 1;
+
+    // we don't want the carriage return of a windows line break
+    if(!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+
+    return true;
+  }
+
+  // the path to the file
+  std::string path;
+
+  // the range of bytes of the part
+  size_t start;
+  size_t end;
+
+  // the file and the position of the next line
+  std::shared_ptr<std::ifstream> file;
+  size_t position = 0;
+};
+
+/**
+ * Reads the records in [start, end) of a file of fixed size records, binaryReadSize bytes at a time
+ */
+struct BinaryFilePart {
+
+  bool operator()(const char *&record) {
+
+    // open the file if this is the first record
+    if(file == nullptr) {
+      file = std::make_shared<std::ifstream>(path, std::ios::binary);
+      file->seekg(start);
+      buffer = std::make_shared<std::vector<char>>();
+      position = start;
+    }
+
+    // read the next couple of records if we are out of them
+    if(next == buffer->size()) {
+
+      // are we done
+      if(position >= end) {
+        return false;
+      }
+
+      // read them
+      auto toRead = std::min(readSize, end - position);
+      buffer->resize(toRead);
+      if(!file->read(buffer->data(), toRead)) {
+        return false;
+      }
+      position += toRead;
+      next = 0;
+    }
+
+    // give the next record
+    record = buffer->data() + next;
+    next += recordSize;
+
+    return true;
+  }
+
+  // the path to the file
+  std::string path;
+
+  // the range of bytes of the part, the size of a record and how much we read at once
+  size_t start;
+  size_t end;
+  size_t recordSize;
+  size_t readSize;
+
+  // the file, the records we read and the position of the next record in the file and in the buffer
+  std::shared_ptr<std::ifstream> file;
+  std::shared_ptr<std::vector<char>> buffer;
+  size_t position = 0;
+  size_t next = 0;
+};
+
+}
+
+std::vector<pdb::PDBBulkLoadPart<size_t>> pdb::PDBBulkLoadInput::splitRange(size_t numRecords, size_t numParts) {
+
+  // we need at least one record per part
+  numParts = std::max<size_t>(std::min(numParts, numRecords), 1);
+
+  // make the parts, the first numRecords % numParts parts get one record more
+  std::vector<PDBBulkLoadPart<size_t>> parts;
+  size_t start = 0;
+  for(size_t i = 0; i < numParts; ++i) {
+
+    size_t end = start + numRecords / numParts + (i < numRecords % numParts ? 1 : 0);
+    parts.emplace_back([start, end](size_t &item) mutable {
+
+      // are we done
+      if(start == end) {
+        return false;
+      }
+
+      // give the next index
+      item = start++;
+      return true;
+    });
+
+    start = end;
+  }
+
+  return parts;
+}
+
+bool pdb::PDBBulkLoadInput::splitTextFile(const std::string &path,
+                                          size_t partSize,
+                                          std::vector<PDBBulkLoadPart<std::string>> &parts,
+                                          std::string &errMsg) {
+  // get the size of the file
+  size_t fileSize;
+  if(!getFileSize(path, fileSize, errMsg)) {
+    return false;
+  }
+
+  // make the parts
+  partSize = std::max<size_t>(partSize, 1);
+  for(size_t start = 0; start < fileSize; start += partSize) {
+
+    TextFilePart part;
+    part.path = path;
+    part.start = start;
+    part.end = std::min(start + partSize, fileSize);
+    parts.emplace_back(part);
+  }
+
+  return true;
+}
+
+bool pdb::PDBBulkLoadInput::splitBinaryFile(const std::string &path,
+                                            size_t recordSize,
+                                            size_t partSize,
+                                            std::vector<PDBBulkLoadPart<const char *>> &parts,
+                                            std::string &errMsg) {
+  // get the size of the file
+  size_t fileSize;
+  if(!getFileSize(path, fileSize, errMsg)) {
+    return false;
+  }
+
+  // the file has to have whole records
+  if(recordSize == 0 || fileSize % recordSize != 0) {
+    errMsg = "The size of the file " + path + " is not a multiple of the record size " + std::to_string(recordSize) + ".";
+    return false;
+  }
+
+  // a part and a read always have whole records
+  partSize = std::max<size_t>(partSize / recordSize, 1) * recordSize;
+  auto readSize = std::max<size_t>(binaryReadSize / recordSize, 1) * recordSize;
+
+  // make the parts
+  for(size_t start = 0; start < fileSize; start += partSize) {
+
+    BinaryFilePart part;
+    part.path = path;
+    part.start = start;
+    part.end = std::min(start + partSize, fileSize);
+    part.recordSize = recordSize;
+    part.readSize = readSize;
+    parts.emplace_back(part);
+  }
+
+  return true;
+}
+
+bool pdb::PDBBulkLoadInput::getFileSize(const std::string &path, size_t &fileSize, std::string &errMsg) {
+
+  // check if the file is there
+  struct stat fileStat{};
+  if(stat(path.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+    errMsg = "Could not open the file " + path + ".";
+    return false;
+  }
+
+  fileSize = (size_t) fileStat.st_size;
+  return true;
+}
@@ -0,0 +1,282 @@
+#include <PDBBulkLoader.h>
+#include <GenericWork.h>
+#include <thread>
+#include <algorithm>
+
+namespace pdb {
+
+extern void* stackBase;
+
+const size_t PDBBulkLoaderBase::maxSenders;
+PDBWorkerQueuePtr PDBBulkLoaderBase::workers = nullptr;
+std::mutex PDBBulkLoaderBase::loadMutex;
+
+PDBBulkLoaderBase::PDBBulkLoaderBase(const std::string &address,
+                                     int port,
+                                     int maxRetries,
+                                     std::string db,
+                                     std::string set,
+                                     const std::string &typeName,
+                                     const PDBBulkLoadOptions &options) : lease(address, port, maxRetries, set, db, typeName),
+                                                                          options(options),
+                                                                          address(address),
+                                                                          port(port),
+                                                                          maxRetries(maxRetries),
+                                                                          db(std::move(db)),
+                                                                          set(std::move(set)),
+                                                                          typeName(typeName) {
+  numRecords = 0;
+  failed = false;
+  numPages = 0;
+  numBytes = 0;
+
+  // figure out the defaults
+  this->options.numSenders = std::min<size_t>(std::max<size_t>(this->options.numSenders, 1), maxSenders);
+  this->options.pagesPerSend = std::max<size_t>(this->options.pagesPerSend, 1);
+  if(this->options.maxPendingPages == 0) {
+    this->options.maxPendingPages = 2 * this->options.numSenders * this->options.pagesPerSend;
+  }
+}
+
+size_t PDBBulkLoaderBase::getNumRecords() const {
+  return numRecords;
+}
+
+size_t PDBBulkLoaderBase::getNumPages() const {
+  return numPages;
+}
+
+size_t PDBBulkLoaderBase::getNumBytes() const {
+  return numBytes;
+}
+
+bool PDBBulkLoaderBase::requestLease(std::string &errMsg) {
+  return lease.requestLease(errMsg);
+}
+
+size_t PDBBulkLoaderBase::getNumBuilders() const {
+  return options.numBuilders == 0 ? getMaxBuilders() : std::min(options.numBuilders, getMaxBuilders());
+}
+
+bool PDBBulkLoaderBase::run(size_t numParts,
+                            const std::function<bool(size_t, std::string &)> &buildPart,
+                            std::string &errMsg) {
+
+  // the loads share the workers, so only one of them can run at a time
+  std::unique_lock<std::mutex> loadLck(loadMutex);
+
+  // get the workers
+  auto loadWorkers = getWorkers(errMsg);
+  if(loadWorkers == nullptr) {
+    return false;
+  }
+
+  // reset the state
+  pending.clear();
+  building = true;
+  failed = false;
+  error.clear();
+
+  // the buzzer we use to wait for the builders and the senders
+  std::atomic_int buildersDone;
+  buildersDone = 0;
+  std::atomic_int sendersDone;
+  sendersDone = 0;
+  PDBBuzzerPtr buzzer = std::make_shared<PDBBuzzer>([&](PDBAlarm myAlarm, std::atomic_int &cnt) {
+    cnt++;
+  });
+
+  /// 1. Start the senders
+
+  for(size_t i = 0; i < options.numSenders; ++i) {
+
+    // make the work
+    PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([&sendersDone, this](const PDBBuzzerPtr &callerBuzzer) {
+
+      // send the pages until there are no more
+      std::string sendError;
+      if(!sendPages(sendError)) {
+        fail(sendError);
+      }
+
+      // signal that we are done
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone, sendersDone);
+    });
+
+    // run the work
+    loadWorkers->getWorker()->execute(myWork, buzzer);
+  }
+
+  /// 2. Start the builders, each one takes the next part until there are no parts left
+
+  std::atomic<size_t> nextPart;
+  nextPart = 0;
+  auto numBuilders = std::min(getNumBuilders(), std::max<size_t>(numParts, 1));
+  for(size_t i = 0; i < numBuilders; ++i) {
+
+    // make the work
+    PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([&, this](const PDBBuzzerPtr &callerBuzzer) {
+
+      size_t part;
+      while(!failed && (part = nextPart++) < numParts) {
+
+        // build the part
+        std::string buildError;
+        bool success;
+        try {
+          success = buildPart(part, buildError);
+        }
+        catch (std::exception &e) {
+          success = false;
+          buildError = e.what();
+        }
+
+        // did we fail
+        if(!success) {
+          fail(buildError);
+        }
+      }
+
+      // signal that we are done
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone, buildersDone);
+    });
+
+    // run the work
+    loadWorkers->getWorker()->execute(myWork, buzzer);
+  }
+
+  /// 3. Wait for the builders, then tell the senders that no more pages are coming and wait for them
+
+  while (buildersDone < numBuilders) {
+    buzzer->wait();
+  }
+
+  {
+    std::unique_lock<std::mutex> lck(m);
+    building = false;
+  }
+  cv.notify_all();
+
+  while (sendersDone < options.numSenders) {
+    buzzer->wait();
+  }
+
+  // did we fail
+  if(failed) {
+    errMsg = error;
+    return false;
+  }
+
+  return true;
+}
+
+bool PDBBulkLoaderBase::addPage(PDBBulkLoadPage page) {
+
+  {
+    // wait until there is space in the queue
+    std::unique_lock<std::mutex> lck(m);
+    cv.wait(lck, [&] { return pending.size() < options.maxPendingPages || failed; });
+
+    // if the load failed there is no point in adding it
+    if(failed) {
+      return false;
+    }
+
+    // add the page
+    numPages++;
+    numBytes += page.numBytes;
+    pending.emplace_back(std::move(page));
+  }
+
+  // let the senders know
+  cv.notify_all();
+  return true;
+}
+
+bool PDBBulkLoaderBase::sendPages(std::string &errMsg) {
+
+  // the sender places the pages of a partitioned set on the nodes of our lease, the other pages are placed by the
+  // manager each time we send a batch
+  PDBStoragePageSender sender(address, port, maxRetries, set, db, typeName);
+  sender.copyLease(lease);
+
+  while(true) {
+
+    // take the next batch of pages
+    std::vector<PDBBulkLoadPage> batch;
+    {
+      std::unique_lock<std::mutex> lck(m);
+      cv.wait(lck, [&] { return !pending.empty() || !building || failed; });
+
+      // if we failed or there are no more pages we are done
+      if(failed || pending.empty()) {
+        return true;
+      }
+
+      // we send whatever is there, so the network does not wait for the builders
+      while(!pending.empty() && batch.size() < options.pagesPerSend) {
+        batch.emplace_back(std::move(pending.front()));
+        pending.pop_front();
+      }
+    }
+
+    // the builders can add more pages now
+    cv.notify_all();
+
+    // send the batch
+    for(auto &page : batch) {
+      if(page.assigned) {
+        sender.addPage(page.bytes.get(), page.numBytes, page.node);
+      }
+      else {
+        sender.addPage(page.bytes.get(), page.numBytes);
+      }
+    }
+    bool success = sender.send(errMsg);
+    sender.clear();
+
+    // did we fail
+    if(!success) {
+      return false;
+    }
+  }
+}
+
+void PDBBulkLoaderBase::fail(const std::string &errMsg) {
+
+  {
+    // the first error wins
+    std::unique_lock<std::mutex> lck(m);
+    if(!failed) {
+      error = errMsg;
+      failed = true;
+    }
+  }
+
+  // wake up everyone that is waiting on the queue
+  cv.notify_all();
+}
+
+PDBWorkerQueuePtr PDBBulkLoaderBase::getWorkers(std::string &errMsg) {
+
+  // if we already have the workers we are done
+  if(workers != nullptr) {
+    return workers;
+  }
+
+  // a process can only have one worker queue
+  if(stackBase != nullptr) {
+    errMsg = "The process already has a worker queue, the bulk loader can only be used by the clients.";
+    return nullptr;
+  }
+
+  // start the workers, we need one for each builder and sender
+  workers = std::make_shared<PDBWorkerQueue>(std::make_shared<PDBLogger>("bulkLoader"), getMaxBuilders() + maxSenders);
+  return workers;
+}
+
+size_t PDBBulkLoaderBase::getMaxBuilders() {
+  return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+}
@@ -23,12 +23,15 @@
 #include <fcntl.h>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <algorithm>
 #include <unistd.h>
 #include <CatGetWorkersRequest.h>
 #include <CatUpdateNodeStatusRequest.h>
 #include <PDBCatalogClient.h>
 #include <CatSetUpdateSizeRequest.h>
 #include <CatSetUpdateContainerTypeRequest.h>
+#include <CatSetUpdatePartitionNodesRequest.h>
 
 #include "CatCreateDatabaseRequest.h"
 #include "CatCreateSetRequest.h"
@@ -39,6 +42,8 @@
 #include "CatGetType.h"
 #include "CatGetSetRequest.h"
 #include "CatGetSetResult.h"
+#include "CatGetSetOnNodesRequest.h"
+#include "CatGetSetOnNodesResult.h"
 #include "CatGetDatabaseRequest.h"
 #include "CatGetDatabaseResult.h"
 #include "CatPrintCatalogResult.h"
@@ -409,7 +414,7 @@ pdb::PDBCatalogSetPtr PDBCatalogClient::getSet(const std::string &dbName, const
 
                 // do we have the thing
                 if(result != nullptr && result->databaseName == dbName && result->setName == setName) {
-                  return std::make_shared<pdb::PDBCatalogSet>(result->databaseName, result->setName, result->type, result->setSize, result->containerType);
+                  return result->toCatalogSet();
                 }
 
                 // return a null pointer otherwise
@@ -442,6 +447,51 @@ bool PDBCatalogClient::incrementSetSize(const std::string &databaseName,
       databaseName, setName, sizeToAdd);
 }
 
+bool PDBCatalogClient::incrementSetSize(const std::string &databaseName,
+                                        const std::string &setName,
+                                        const std::string &nodeID,
+                                        size_t sizeToAdd,
+                                        size_t pagesToAdd,
+                                        std::string &errMsg) {
+
+  // make a request and return the value
+  return RequestFactory::heapRequest< CatSetUpdateSizeRequest, SimpleRequestResult, bool>(
+      myLogger, port, address, false, 1024,
+      [&](Handle<SimpleRequestResult> result) {
+
+        if (result != nullptr) {
+          if (!result->getRes().first) {
+            errMsg = "Error updating set: " + result->getRes().second;
+            myLogger->error("Error updating set: " + result->getRes().second);
+            return false;
+          }
+          return true;
+        }
+        errMsg = "Error getting set: got nothing back from catalog";
+        return false;
+      },
+      databaseName, setName, sizeToAdd, nodeID, pagesToAdd);
+}
+
+std::vector<PDBCatalogSetOnNodePtr> PDBCatalogClient::getSetOnNodes(const std::string &databaseName,
+                                                                    const std::string &setName,
+                                                                    std::string &errMsg) {
+
+  // make a request and return the value
+  return RequestFactory::heapRequest< CatGetSetOnNodesRequest, CatGetSetOnNodesResult, std::vector<PDBCatalogSetOnNodePtr>>(
+      myLogger, port, address, std::vector<PDBCatalogSetOnNodePtr>(), 1024,
+      [&](Handle<CatGetSetOnNodesResult> result) {
+
+        if (result == nullptr) {
+          errMsg = "Error getting the size of the set on the nodes: got nothing back from catalog";
+          return std::vector<PDBCatalogSetOnNodePtr>();
+        }
+
+        return result->toSetOnNodes(databaseName + ":" + setName);
+      },
+      databaseName, setName);
+}
+
 bool PDBCatalogClient::updateSetContainerType(const string &databaseName,
                                               const string &setName,
                                               PDBCatalogSetContainerType containerType,
@@ -464,6 +514,28 @@ bool PDBCatalogClient::updateSetContainerType(const string &databaseName,
       databaseName, setName, containerType);
 }
 
+bool PDBCatalogClient::updateSetPartitionNodes(const string &databaseName,
+                                               const string &setName,
+                                               const string &partitionNodes,
+                                               string &errMsg) {
+  // make a request and return the value
+  return RequestFactory::heapRequest<CatSetUpdatePartitionNodesRequest, SimpleRequestResult, bool>(
+      myLogger, port, address, false, 1024 + partitionNodes.size(),
+      [&](Handle<SimpleRequestResult> result) {
+        if (result != nullptr) {
+          if (!result->getRes().first) {
+            errMsg = "Error updating set: " + result->getRes().second;
+            myLogger->error("Error updating set: " + result->getRes().second);
+            return false;
+          }
+          return true;
+        }
+        errMsg = "Error getting set: got nothing back from catalog";
+        return false;
+      },
+      databaseName, setName, partitionNodes);
+}
+
 pdb::PDBCatalogDatabasePtr PDBCatalogClient::getDatabase(const std::string &dbName, std::string &errMsg) {
 
   // make a request and return the value
@@ -608,6 +680,39 @@ string PDBCatalogClient::listUserDefinedTypes(std::string &errMsg) {
   return printCatalogMetadata(category, errMsg);
 }
 
+string PDBCatalogClient::listSetStorageImbalance(const std::string &databaseName, const std::string &setName, std::string &errMsg) {
+
+  // grab the size of the set on each node and all the workers
+  auto setOnNodes = getSetOnNodes(databaseName, setName, errMsg);
+  auto workers = getWorkerNodes();
+
+  // the total size of the set
+  size_t totalSize = 0;
+  for(auto &setOnNode : setOnNodes) {
+    totalSize += setOnNode->setSize;
+  }
+
+  // list each worker, the ones that don't have anything are listed as empty
+  std::stringstream ss;
+  ss << "Storage of the set (" << databaseName << "," << setName << ") per worker :\n";
+  for(auto &worker : workers) {
+
+    // find the size on the worker
+    auto it = std::find_if(setOnNodes.begin(), setOnNodes.end(), [&](const PDBCatalogSetOnNodePtr &s) { return s->nodeID == worker->nodeID; });
+    size_t setSize = it == setOnNodes.end() ? 0 : (*it)->setSize;
+    size_t numPages = it == setOnNodes.end() ? 0 : (*it)->numPages;
+
+    ss << "  " << worker->nodeID << (worker->active ? "" : " (inactive)")
+       << " : " << setSize << " bytes, " << numPages << " pages, "
+       << (totalSize == 0 ? 0.0 : 100.0 * setSize / totalSize) << "% of the set\n";
+  }
+
+  // the most loaded worker compared to the average
+  ss << "  Imbalance (largest / average) : " << PDBCatalogSetOnNode::getImbalance(setOnNodes, workers.size()) << "\n";
+
+  return ss.str();
+}
+
 string PDBCatalogClient::listAllRegisteredMetadata(std::string &errMsg) {
 
   string category = "all";
@@ -143,10 +143,19 @@ bool PDBClient::removeSet(const string &dbName, const string &setName) {
 }
 
 bool PDBClient::executeComputations(Handle<Vector<Handle<Computation>>> &computations, const pdb::String &tcap) {
-  return computationClient->executeComputations(computations, tcap, errorMsg);
+  return computationClient->executeComputations(computations, tcap, errorMsg, nullptr, computationPriority, computationMemoryBudget);
+}
+
+bool PDBClient::executeComputations(Handle<Vector<Handle<Computation>>> &computations, const pdb::String &tcap, PDBProfile &profile) {
+  return computationClient->executeComputations(computations, tcap, errorMsg, &profile, computationPriority, computationMemoryBudget);
 }
 
 bool PDBClient::executeComputations(const std::vector<Handle<Computation>> &sinks) {
+  PDBProfile profile;
+  return executeComputations(sinks, profile);
+}
+
+bool PDBClient::executeComputations(const std::vector<Handle<Computation>> &sinks, PDBProfile &profile) {
 
   // create the graph analyzer
   pdb::QueryGraphAnalyzer queryAnalyzer(sinks);
@@ -159,7 +168,42 @@ bool PDBClient::executeComputations(const std::vector<Handle<Computation>> &sink
   std::cout << TCAPString << "\n";
 
   // execute the computations
-  return computationClient->executeComputations(myComputations, TCAPString, errorMsg);
+  return computationClient->executeComputations(myComputations, TCAPString, errorMsg, &profile, computationPriority, computationMemoryBudget);
+}
+
+PDBPreparedComputationPtr PDBClient::prepareComputations(const std::vector<Handle<Computation>> &sinks) {
+
+  // create the graph analyzer
+  pdb::QueryGraphAnalyzer queryAnalyzer(sinks);
+
+  // here is the list of computations
+  Handle<Vector<Handle<Computation>>> myComputations = makeObject<Vector<Handle<Computation>>>();
+
+  // parse the TCAP string
+  std::string TCAPString = queryAnalyzer.parseTCAPString(*myComputations);
+
+  // keep it on the manager
+  auto preparedID = computationClient->prepareComputations(TCAPString, errorMsg);
+  if(preparedID == 0) {
+    return nullptr;
+  }
+
+  return std::make_shared<PDBPreparedComputation>(preparedID, TCAPString, myComputations);
+}
+
+bool PDBClient::executeComputations(const PDBPreparedComputationPtr &prepared) {
+  PDBProfile profile;
+  return executeComputations(prepared, profile);
+}
+
+bool PDBClient::executeComputations(const PDBPreparedComputationPtr &prepared, PDBProfile &profile) {
+  return computationClient->executeComputations(prepared->getComputations(), "", errorMsg, &profile,
+                                                computationPriority, computationMemoryBudget, prepared->getPreparedID());
+}
+
+void PDBClient::setComputationScheduling(int32_t priority, uint64_t memoryBudget) {
+  computationPriority = priority;
+  computationMemoryBudget = memoryBudget;
 }
 
 void PDBClient::listAllRegisteredMetadata() {
@@ -182,6 +226,10 @@ void PDBClient::listUserDefinedTypes() {
   cout << catalogClient->listUserDefinedTypes(returnedMsg);
 }
 
+void PDBClient::listSetStorageImbalance(const std::string &databaseName, const std::string &setName) {
+  cout << catalogClient->listSetStorageImbalance(databaseName, setName, returnedMsg);
+}
+
 
 
 }
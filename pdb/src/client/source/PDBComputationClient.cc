@@ -5,7 +5,9 @@
 #include <PDBComputationClient.h>
 #include <HeapRequest.h>
 #include <CSExecuteComputation.h>
-#include <SimpleRequestResult.h>
+#include <CSExecuteComputationResult.h>
+#include <CSPrepareComputation.h>
+#include <CSPrepareComputationResult.h>
 
 pdb::PDBComputationClient::PDBComputationClient(const string &address, int port, const pdb::PDBLoggerPtr &myLogger)
     : address(address), port(port), myLogger(myLogger) {
@@ -16,7 +18,9 @@ pdb::PDBComputationClient::PDBComputationClient(const string &address, int port,
   this->myLogger = myLogger;
 }
 
-bool pdb::PDBComputationClient::executeComputations(Handle<Vector<Handle<Computation>>> &computations, const pdb::String &tcap, std::string &error) {
+bool pdb::PDBComputationClient::executeComputations(Handle<Vector<Handle<Computation>>> &computations, const pdb::String &tcap, std::string &error,
+                                                    PDBProfile *profile, int32_t priority, uint64_t memoryBudget,
+                                                    uint64_t preparedID) {
 
   // essentially the buffer should be of this size //TODO this needs to be stress tested
   auto bufferSize = getRecord(computations)->numBytes() + tcap.size() + 1024 * 2;
@@ -27,15 +31,27 @@ bool pdb::PDBComputationClient::executeComputations(Handle<Vector<Handle<Computa
     try {
 
         // send the request
-        return RequestFactory::heapRequest<CSExecuteComputation, SimpleRequestResult, bool>(myLogger, port, address, false, bufferSize,
-        [&](Handle<SimpleRequestResult> result) {
+        return RequestFactory::heapRequest<CSExecuteComputation, CSExecuteComputationResult, bool>(myLogger, port, address, false, bufferSize,
+        [&](Handle<CSExecuteComputationResult> result) {
+
+        // check if we got a response
+        if (result == nullptr) {
+        error = "Error executing computations: no response";
+        myLogger->error(error);
+        return false;
+        }
+
+        // grab the profile even if we failed, it shows how far we got
+        if (profile != nullptr) {
+        profile->merge(result->profile);
+        }
 
         // check the response
-        if ((result != nullptr && !result->getRes().first) || result == nullptr) {
+        if (!result->success) {
 
         // log the error
-        myLogger->error("Error executing computations: " + result->getRes().second);
-        error = "Error executing computations: " + result->getRes().second;
+        myLogger->error("Error executing computations: " + std::string(result->error));
+        error = "Error executing computations: " + std::string(result->error);
 
         // we are done here
         return false;
@@ -43,7 +59,7 @@ bool pdb::PDBComputationClient::executeComputations(Handle<Vector<Handle<Computa
 
         // awesome we finished
         return true;
-        }, computations, tcap, bufferSize);
+        }, computations, tcap, bufferSize, priority, memoryBudget, preparedID);
     }
     catch(pdb::NotEnoughSpace &n) {
 
@@ -57,6 +73,29 @@ bool pdb::PDBComputationClient::executeComputations(Handle<Vector<Handle<Computa
   return false;
 }
 
+uint64_t pdb::PDBComputationClient::prepareComputations(const std::string &tcap, std::string &error) {
+
+  return RequestFactory::heapRequest<CSPrepareComputation, CSPrepareComputationResult, uint64_t>(myLogger, port, address, 0, tcap.size() + 1024,
+      [&](Handle<CSPrepareComputationResult> result) {
+
+        // check if we got a response
+        if (result == nullptr) {
+          error = "Error preparing computations: no response";
+          myLogger->error(error);
+          return (uint64_t) 0;
+        }
+
+        // did the manager prepare it
+        if (!result->success) {
+          error = "Error preparing computations: " + std::string(result->error);
+          myLogger->error(error);
+          return (uint64_t) 0;
+        }
+
+        return result->preparedID;
+      }, tcap);
+}
+
 // set the constants
 const uint64_t pdb::PDBComputationClient::MAX_COMPUTATION_SIZE = 100u * 1024u * 1024u;
 const uint64_t pdb::PDBComputationClient::MAX_STEP_SIZE = 10u * 1024u * 1024u;
\ No newline at end of file
@@ -43,4 +43,35 @@ bool PDBDistributedStorageClient::removeSet(const string &dbName, const string &
       dbName, setName);
 }
 
+std::string PDBDistributedStorageClient::getPartitionKeyName(const std::string &db, const std::string &set) {
+
+  // do we have it
+  auto it = partitionKeyNames.find(std::make_pair(db, set));
+  if(it == partitionKeyNames.end()) {
+    return "";
+  }
+
+  return it->second;
+}
+
+bool PDBDistributedStorageClient::checkPartitionKey(const std::string &db,
+                                                    const std::string &set,
+                                                    const PDBStoragePageSender &sender,
+                                                    std::string &errMsg) {
+
+  // if the set is not partitioned any key is fine
+  if(!sender.isPartitioned()) {
+    return true;
+  }
+
+  // the records would be placed by the wrong key otherwise
+  auto keyName = getPartitionKeyName(db, set);
+  if(keyName != sender.getPartitionKey()) {
+    errMsg = "The set (" + db + "," + set + ") is partitioned on " + sender.getPartitionKey() + ", but the provided key is " + keyName + ".";
+    return false;
+  }
+
+  return true;
+}
+
 }
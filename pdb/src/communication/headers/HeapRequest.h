@@ -20,7 +20,7 @@
 #define SIMPLE_REQUEST_H
 
 #include "PDBLogger.h"
-#include <snappy.h>
+#include <PDBCodec.h>
 #include <PDBCommunicator.h>
 #include <functional>
 
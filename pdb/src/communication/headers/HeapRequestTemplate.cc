@@ -24,7 +24,9 @@
 
 #include "InterfaceFunctions.h"
 #include "UseTemporaryAllocationBlock.h"
+#include "AllocationBlockPool.h"
 #include "PDBCommunicator.h"
+#include "Tracing.h"
 
 using std::function;
 using std::string;
@@ -44,6 +46,7 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
                                        function<ReturnType(Handle<ResponseType>)> processResponse,
                                        RequestTypeParams &&... args) {
 
+    PDB_TRACE_SCOPE("heap request");
 
     // try multiple times if we fail to connect
     int numRetries = 0;
@@ -67,7 +70,7 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
         }
 
         // log that we are connected
-        myLogger->info(std::string("Successfully connected to remote server with port=") + std::to_string(port) + std::string(" and address=") + address);
+        PDB_LOG_INFO(myLogger, std::string("Successfully connected to remote server with port=") + std::to_string(port) + std::string(" and address=") + address);
 
         // check if it is invalid
         if (bytesForRequest <= BLOCK_HEADER_SIZE) {
@@ -95,7 +98,7 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
         }
 
         // log that the object is sent
-        myLogger->info("Object sent.");
+        PDB_LOG_INFO(myLogger, "Object sent.");
 
         // get the response and process it
         ReturnType finalResult;
@@ -112,16 +115,7 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
         }
 
         // allocate the memory
-        std::unique_ptr<char[]> memory(new char[objectSize]);
-        if (memory == nullptr) {
-
-            errMsg = "FATAL ERROR in heapRequest: Can't allocate memory";
-            myLogger->error(errMsg);
-
-            /// TODO this needs to be an exception or something
-            // this is a fatal error we should not be running out of memory
-            exit(-1);
-        }
+        PooledBuffer memory(objectSize);
 
         {
             Handle<ResponseType> result =  temp.getNextObject<ResponseType> (memory.get(), success, errMsg);
@@ -153,6 +147,7 @@ ReturnType RequestFactory::doubleHeapRequest(PDBLoggerPtr logger,
                                              function<ReturnType(Handle < ResponseType > )> processResponse,
                                              Handle<RequestType> &firstRequest,
                                              Handle<SecondRequestType> &secondRequest) {
+    PDB_TRACE_SCOPE("heap request");
     int numRetries = 0;
     while (numRetries <= MAX_RETRIES) {
 
@@ -174,7 +169,7 @@ ReturnType RequestFactory::doubleHeapRequest(PDBLoggerPtr logger,
         }
 
         // log that we are connected
-        logger->info(std::string("Successfully connected to remote server with port=") + std::to_string(port) + std::string(" and address=") + address);
+        PDB_LOG_INFO(logger, std::string("Successfully connected to remote server with port=") + std::to_string(port) + std::string(" and address=") + address);
 
         // build the request
         if (!temp.sendObject(firstRequest, errMsg)) {
@@ -195,16 +190,7 @@ ReturnType RequestFactory::doubleHeapRequest(PDBLoggerPtr logger,
         ReturnType finalResult;
 
         // allocate the memory
-        std::unique_ptr<char[]> memory(new char[temp.getSizeOfNextObject()]);
-        if (memory == nullptr) {
-
-            errMsg = "FATAL ERROR in heapRequest: Can't allocate memory";
-            logger->error(errMsg);
-
-            /// TODO this needs to be an exception or something
-            // this is a fatal error we should not be running out of memory
-            exit(-1);
-        }
+        PooledBuffer memory(temp.getSizeOfNextObject());
 
         {
             Handle<ResponseType> result = temp.getNextObject<ResponseType>(memory.get(), success, errMsg);
@@ -229,20 +215,23 @@ ReturnType RequestFactory::dataHeapRequest(PDBLoggerPtr logger, int port, const
                                            ReturnType onErr, size_t bytesForRequest, function<ReturnType(Handle<ResponseType>)> processResponse,
                                            Handle<Vector<Handle<DataType>>> dataToSend, RequestTypeParams&&... args) {
 
+    PDB_TRACE_SCOPE("data heap request");
+
     // get the record
     auto* myRecord = (Record<Vector<Handle<Object>>>*) getRecord(dataToSend);
 
-    auto maxCompressedSize = snappy::MaxCompressedLength(myRecord->numBytes());
+    // the data requests are compressed with snappy, the frame tells the receiver that
+    auto codec = PDBCodec::get(PDB_SNAPPY_CODEC);
+    auto maxCompressedSize = codec->getMaxFrameSize(myRecord->numBytes());
 
     // allocate the bytes for the compressed record
     std::unique_ptr<char[]> compressedBytes(new char[maxCompressedSize]);
 
     // compress the record
-    size_t compressedSize;
-    snappy::RawCompress((char*) myRecord, myRecord->numBytes(), compressedBytes.get(), &compressedSize);
+    size_t compressedSize = codec->compressFrame((char*) myRecord, myRecord->numBytes(), compressedBytes.get(), maxCompressedSize);
 
     // log what we are doing
-    logger->info("size before compression is "  + std::to_string(myRecord->numBytes()) + " and size after compression is " + std::to_string(compressedSize));
+    PDB_LOG_INFO(logger, "size before compression is "  + std::to_string(myRecord->numBytes()) + " and size after compression is " + std::to_string(compressedSize));
 
     int retries = 0;
     while (retries <= MAX_RETRIES) {
@@ -307,16 +296,7 @@ ReturnType RequestFactory::dataHeapRequest(PDBLoggerPtr logger, int port, const
             return onErr;
         }
 
-        std::unique_ptr<char[]> memory(new char[objectSize]);
-        if (memory == nullptr) {
-
-            // log the error
-            logger->error("can't allocate memory");
-
-            /// TODO this needs to be an exception or something
-            // this is a fatal error we should not be running out of memory
-            exit(-1);
-        }
+        PooledBuffer memory(objectSize);
 
         ReturnType finalResult;
         {
@@ -344,6 +324,7 @@ template <class RequestType, class ResponseType, class ReturnType, class... Requ
 ReturnType RequestFactory::bytesHeapRequest(PDBLoggerPtr logger, int port, std::string address, ReturnType onErr,
                                             size_t bytesForRequest, function<ReturnType(Handle<ResponseType>)> processResponse,
                                             char* bytes, size_t numBytes, RequestTypeParams&&... args) {
+    PDB_TRACE_SCOPE_ARG("bytes heap request", numBytes);
     int retries = 0;
     while (retries <= MAX_RETRIES) {
 
@@ -407,16 +388,7 @@ ReturnType RequestFactory::bytesHeapRequest(PDBLoggerPtr logger, int port, std::
             return onErr;
         }
 
-        std::unique_ptr<char[]> memory(new char[objectSize]);
-        if (memory == nullptr) {
-
-            // log the error
-            logger->error("can't allocate memory");
-
-            /// TODO this needs to be an exception or something
-            // this is a fatal error we should not be running out of memory
-            exit(-1);
-        }
+        PooledBuffer memory(objectSize);
 
         ReturnType finalResult;
         {
@@ -459,16 +431,7 @@ ReturnType pdb::RequestFactory::waitHeapRequest(pdb::PDBLoggerPtr logger,
         return onErr;
     }
 
-    std::unique_ptr<char[]> memory(new char[objectSize]);
-    if (memory == nullptr) {
-
-        // log the error
-        logger->error("can't allocate memory");
-
-        /// TODO this needs to be an exception or something
-        // this is a fatal error we should not be running out of memory
-        exit(-1);
-    }
+    PooledBuffer memory(objectSize);
 
     // used for error handling
     string errMsg;
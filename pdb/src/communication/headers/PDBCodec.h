@@ -0,0 +1,196 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace pdb {
+
+/**
+ * The codecs we can compress with, the value is what goes into the frame header so it must never change
+ */
+enum PDBCodecType : uint8_t {
+
+  // the bytes are copied as they are
+  PDB_NO_CODEC = 0,
+
+  // snappy, fast with a decent ratio
+  PDB_SNAPPY_CODEC = 1,
+
+  // lz4, faster than snappy, only there if we were built with it
+  PDB_LZ4_CODEC = 2,
+
+  // zstd, the best ratio and the level picks the speed, only there if we were built with it
+  PDB_ZSTD_CODEC = 3
+};
+
+class PDBCodec;
+using PDBCodecPtr = std::shared_ptr<PDBCodec>;
+
+/**
+ * A codec compresses a block of bytes. Everything we compress is put into a frame, a small header that records the codec,
+ * the level and the sizes followed by the compressed bytes. The frame tells the receiver how to decompress it, so the
+ * sender can pick whatever codec it is configured with for a set, a shuffle or a type of request.
+ *
+ * The codecs are named by a string, the name of the codec optionally followed by the level,
+ * for example "none", "snappy", "lz4", "zstd" or "zstd:9".
+ */
+class PDBCodec {
+ public:
+
+  /**
+   * The header of a frame
+   */
+  struct Frame {
+
+    // always the magic number
+    uint32_t magic;
+
+    // the codec and the level the bytes were compressed with
+    uint8_t codec;
+    int8_t level;
+
+    // not used
+    uint16_t reserved;
+
+    // the size of the bytes before they were compressed
+    uint64_t uncompressedSize;
+
+    // the size of the compressed bytes that follow the header
+    uint64_t compressedSize;
+  };
+
+  /**
+   * The magic number at the start of every frame
+   */
+  static const uint32_t frameMagic = 0x43424450u;
+
+  virtual ~PDBCodec() = default;
+
+  /**
+   * Returns the type of the codec
+   */
+  PDBCodecType getType() const;
+
+  /**
+   * Returns the level of the codec, 0 means the default level
+   */
+  int getLevel() const;
+
+  /**
+   * Returns the name of the codec, with the level if it is not the default one
+   */
+  std::string getName() const;
+
+  /**
+   * Returns the largest the compressed bytes can get
+   * @param numBytes - the number of bytes we compress
+   * @return that size
+   */
+  virtual size_t getMaxCompressedSize(size_t numBytes) const = 0;
+
+  /**
+   * Compresses the bytes
+   * @param in - the bytes
+   * @param numBytes - the number of bytes
+   * @param out - where we put the compressed bytes
+   * @param outSize - how much space there is, has to be at least @see getMaxCompressedSize
+   * @return the size of the compressed bytes, 0 if we failed
+   */
+  virtual size_t compress(const char *in, size_t numBytes, char *out, size_t outSize) const = 0;
+
+  /**
+   * Decompresses the bytes
+   * @param in - the compressed bytes
+   * @param compressedSize - the number of compressed bytes
+   * @param out - where we put the bytes
+   * @param uncompressedSize - the number of bytes we expect
+   * @return true if we succeeded, false otherwise
+   */
+  virtual bool decompress(const char *in, size_t compressedSize, char *out, size_t uncompressedSize) const = 0;
+
+  /**
+   * Returns the largest a frame can get
+   * @param numBytes - the number of bytes we compress
+   * @return that size
+   */
+  size_t getMaxFrameSize(size_t numBytes) const;
+
+  /**
+   * Compresses the bytes into a frame
+   * @param in - the bytes
+   * @param numBytes - the number of bytes
+   * @param out - where we put the frame
+   * @param outSize - how much space there is
+   * @return the size of the frame, 0 if it does not fit
+   */
+  size_t compressFrame(const char *in, size_t numBytes, char *out, size_t outSize) const;
+
+  /**
+   * Checks if the bytes are a whole frame
+   * @param frame - the bytes
+   * @param size - the number of bytes
+   * @return true if they are, false otherwise
+   */
+  static bool isFrame(const char *frame, size_t size);
+
+  /**
+   * Returns the size of the bytes in a frame once they are decompressed
+   */
+  static size_t getFrameUncompressedSize(const char *frame);
+
+  /**
+   * Returns the size of a frame, the header and the compressed bytes
+   */
+  static size_t getFrameSize(const char *frame);
+
+  /**
+   * Returns the type of the codec the frame was compressed with
+   */
+  static PDBCodecType getFrameCodec(const char *frame);
+
+  /**
+   * Decompresses a frame with the codec it was compressed with
+   * @param frame - the frame
+   * @param frameSize - the size of the frame
+   * @param out - where we put the bytes
+   * @param outSize - how much space there is
+   * @return true if we succeeded, false if the frame is corrupted, does not fit or its codec is not built in
+   */
+  static bool decompressFrame(const char *frame, size_t frameSize, char *out, size_t outSize);
+
+  /**
+   * Returns a codec
+   * @param type - the type of the codec
+   * @param level - the level, 0 means the default level
+   * @return the codec, null if we were not built with it
+   */
+  static PDBCodecPtr get(PDBCodecType type, int level = 0);
+
+  /**
+   * Returns the codec with a name like "zstd:9"
+   * @param name - the name
+   * @param errMsg - the error if we fail
+   * @return the codec, null if the name is wrong or we were not built with it
+   */
+  static PDBCodecPtr get(const std::string &name, std::string &errMsg);
+
+  /**
+   * Returns the names of the codecs we were built with
+   */
+  static std::vector<std::string> getAvailable();
+
+ protected:
+
+  PDBCodec(PDBCodecType type, int level);
+
+  /**
+   * The type and the level of the codec
+   */
+  PDBCodecType type;
+  int level;
+};
+
+}
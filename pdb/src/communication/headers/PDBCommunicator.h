@@ -84,6 +84,11 @@ public:
     template <class ObjType>
     bool sendObject(Handle<ObjType>& sendMe, std::string& errMsg, size_t blockSize);
 
+    // sends an object that is already in a record over the communication channel... return false on error.
+    // This does not touch the allocator, so it can be used by threads that do not have one of their own
+    template <class ObjType>
+    bool sendRecord(Record<ObjType>* sendMe, std::string& errMsg);
+
     // sends a bunch of binary data over a channel
     bool sendBytes(void* data, size_t size, std::string& errMsg);
 
@@ -32,6 +32,7 @@
 #include "InterfaceFunctions.h"
 #include "PDBCommunicator.h"
 #include "UseTemporaryAllocationBlock.h"
+#include "AllocationBlockPool.h"
 #include <stdio.h>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -82,9 +83,9 @@ bool PDBCommunicator::sendObject(Handle<ObjType>& sendMe, std::string& errMsg) {
     }
 
     // log the stuff
-    logToMe->info(std::string("Sent object with typeName=") + getTypeName<ObjType>() +
-                  std::string(", recType=") + std::to_string(recType) +
-                  std::string(" and socketFD=") + std::to_string(socketFD));
+    PDB_LOG_INFO(logToMe, std::string("Sent object with typeName=") + getTypeName<ObjType>() +
+                          std::string(", recType=") + std::to_string(recType) +
+                          std::string(" and socketFD=") + std::to_string(socketFD));
     return true;
 }
 
@@ -131,9 +132,38 @@ bool PDBCommunicator::sendObject(Handle<ObjType>& sendMe, std::string& errMsg, s
     }
 
     // log the info
-    logToMe->info(std::string("Sent object with typeName=") + getTypeName<ObjType>() +
-                  std::string(", recType=") + std::to_string(recType) +
-                  std::string(" and socketFD=") + std::to_string(socketFD));
+    PDB_LOG_INFO(logToMe, std::string("Sent object with typeName=") + getTypeName<ObjType>() +
+                          std::string(", recType=") + std::to_string(recType) +
+                          std::string(" and socketFD=") + std::to_string(socketFD));
+
+    return true;
+}
+
+template <class ObjType>
+bool PDBCommunicator::sendRecord(Record<ObjType>* sendMe, std::string& errMsg) {
+
+    // first, write the record type
+    int16_t recType = getTypeID<ObjType>();
+    if (recType < 0) {
+        logToMe->error("Fatal Error: BAD!  Trying to send a record of a non-Object type.\n");
+        exit(1);
+    }
+
+    // write out the record type
+    if (!doTheWrite(((char*)&recType), ((char*)&recType) + sizeof(int16_t))) {
+        errMsg = "PDBCommunicator: not able to send the object type";
+        logToMe->error(errMsg);
+        logToMe->error(strerror(errno));
+        return false;
+    }
+
+    // write out the record
+    if (!doTheWrite((char*)sendMe, ((char*)sendMe) + sendMe->numBytes())) {
+        errMsg = "PDBCommunicator: not able to send the record";
+        logToMe->error(errMsg);
+        logToMe->error(strerror(errno));
+        return false;
+    }
 
     return true;
 }
@@ -195,13 +225,13 @@ Handle<ObjType> PDBCommunicator::getNextObject(void* readToHere,
     // if we have previously gotten the size, just return it
     if (!readCurMsgSize) {
         getSizeOfNextObject();
-        logToMe->debug(std::string("run getSizeOfNextObject() and get type=") +
-                       std::to_string(nextTypeID) + std::string(" and size=") +
-                       std::to_string(msgSize));
+        PDB_LOG_DEBUG(logToMe, std::string("run getSizeOfNextObject() and get type=") +
+                               std::to_string(nextTypeID) + std::string(" and size=") +
+                               std::to_string(msgSize));
     } else {
-        logToMe->debug(std::string("get size info directly with type=") +
-                       std::to_string(nextTypeID) + std::string(" and size=") +
-                       std::to_string(msgSize));
+        PDB_LOG_DEBUG(logToMe, std::string("get size info directly with type=") +
+                               std::to_string(nextTypeID) + std::string(" and size=") +
+                               std::to_string(msgSize));
     }
 
     if (msgSize == 0) {
@@ -233,9 +263,9 @@ Handle<ObjType> PDBCommunicator::getNextObject(void* readToHere,
 
     // create an object and get outta here
     success = true;
-    logToMe->trace("PDBCommunicator: read the object with no problem.");
-    logToMe->trace("PDBCommunicator: root offset is " +
-                   std::to_string(((Record<ObjType>*)readToHere)->rootObjectOffset()));
+    PDB_LOG_TRACE(logToMe, "PDBCommunicator: read the object with no problem.");
+    PDB_LOG_TRACE(logToMe, "PDBCommunicator: root offset is " +
+                           std::to_string(((Record<ObjType>*)readToHere)->rootObjectOffset()));
     readCurMsgSize = false;
     Handle<ObjType> request = ((Record<ObjType>*)readToHere)->getRootObject();
     return request;
@@ -247,13 +277,13 @@ Handle<ObjType> PDBCommunicator::getNextObject(bool& success, std::string& errMs
     // if we have previously gotten the size, just return it
     if (!readCurMsgSize) {
         getSizeOfNextObject();
-        logToMe->debug(std::string("run getSizeOfNextObject() and get type=") +
-                       std::to_string(nextTypeID) + std::string(" and size=") +
-                       std::to_string(msgSize));
+        PDB_LOG_DEBUG(logToMe, std::string("run getSizeOfNextObject() and get type=") +
+                               std::to_string(nextTypeID) + std::string(" and size=") +
+                               std::to_string(msgSize));
     } else {
-        logToMe->debug(std::string("get size info directly with type=") +
-                       std::to_string(nextTypeID) + std::string(" and size=") +
-                       std::to_string(msgSize));
+        PDB_LOG_DEBUG(logToMe, std::string("get size info directly with type=") +
+                               std::to_string(nextTypeID) + std::string(" and size=") +
+                               std::to_string(msgSize));
     }
     if (msgSize == 0) {
         success = false;
@@ -266,27 +296,19 @@ Handle<ObjType> PDBCommunicator::getNextObject(bool& success, std::string& errMs
             "other side");
         return nullptr;
     }
-    // read in the object
-    void* mem = malloc(msgSize);
-    if (mem == nullptr) {
-        PDB_COUT << "nextTypeId = " << nextTypeID << std::endl;
-        PDB_COUT << "msgSize = " << msgSize << std::endl;
-        PDB_COUT << "memory is failed to allocate for getNextObject()" << std::endl;
-        exit(-1);
-    }
-    Handle<ObjType> temp = getNextObject<ObjType>(mem, success, errMsg);
+    // read in the object, the buffer comes from the pool of this thread
+    PooledBuffer mem(msgSize);
+    Handle<ObjType> temp = getNextObject<ObjType>(mem.get(), success, errMsg);
     UseTemporaryAllocationBlock myBlock{msgSize + 4 * 1024 * 1024};
     // if we were successful, then copy it to the current allocation block
     if (success) {
-        logToMe->trace("PDBCommunicator: about to do the deep copy.");
+        PDB_LOG_TRACE(logToMe, "PDBCommunicator: about to do the deep copy.");
         // std :: cout << "to get handle by deep copy to current block" << std :: endl;
         temp = deepCopyToCurrentAllocationBlock(temp);
         // std :: cout << "got handle" << std :: endl;
-        logToMe->trace("PDBCommunicator: completed the deep copy.");
-        free(mem);
+        PDB_LOG_TRACE(logToMe, "PDBCommunicator: completed the deep copy.");
         return temp;
     } else {
-        free(mem);
         return nullptr;
     }
 }
@@ -0,0 +1,327 @@
+#include <PDBCodec.h>
+#include <snappy.h>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifdef PDB_WITH_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef PDB_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace pdb {
+
+namespace {
+
+/**
+ * Copies the bytes as they are
+ */
+class PDBNoCodec : public PDBCodec {
+ public:
+
+  PDBNoCodec() : PDBCodec(PDB_NO_CODEC, 0) {}
+
+  size_t getMaxCompressedSize(size_t numBytes) const override {
+    return numBytes;
+  }
+
+  size_t compress(const char *in, size_t numBytes, char *out, size_t outSize) const override {
+
+    // check if it fits
+    if(outSize < numBytes) {
+      return 0;
+    }
+
+    memcpy(out, in, numBytes);
+    return numBytes;
+  }
+
+  bool decompress(const char *in, size_t compressedSize, char *out, size_t uncompressedSize) const override {
+
+    // the sizes must match
+    if(compressedSize != uncompressedSize) {
+      return false;
+    }
+
+    memcpy(out, in, compressedSize);
+    return true;
+  }
+};
+
+/**
+ * Compresses with snappy
+ */
+class PDBSnappyCodec : public PDBCodec {
+ public:
+
+  PDBSnappyCodec() : PDBCodec(PDB_SNAPPY_CODEC, 0) {}
+
+  size_t getMaxCompressedSize(size_t numBytes) const override {
+    return snappy::MaxCompressedLength(numBytes);
+  }
+
+  size_t compress(const char *in, size_t numBytes, char *out, size_t outSize) const override {
+
+    // snappy needs the worst case
+    if(outSize < getMaxCompressedSize(numBytes)) {
+      return 0;
+    }
+
+    size_t compressedSize;
+    snappy::RawCompress(in, numBytes, out, &compressedSize);
+    return compressedSize;
+  }
+
+  bool decompress(const char *in, size_t compressedSize, char *out, size_t uncompressedSize) const override {
+
+    // check the size before we write anything
+    size_t size;
+    if(!snappy::GetUncompressedLength(in, compressedSize, &size) || size != uncompressedSize) {
+      return false;
+    }
+
+    return snappy::RawUncompress(in, compressedSize, out);
+  }
+};
+
+#ifdef PDB_WITH_LZ4
+
+/**
+ * Compresses with lz4, the level is the acceleration of lz4
+ */
+class PDBLZ4Codec : public PDBCodec {
+ public:
+
+  explicit PDBLZ4Codec(int level) : PDBCodec(PDB_LZ4_CODEC, level) {}
+
+  size_t getMaxCompressedSize(size_t numBytes) const override {
+    return numBytes > LZ4_MAX_INPUT_SIZE ? 0 : (size_t) LZ4_compressBound((int) numBytes);
+  }
+
+  size_t compress(const char *in, size_t numBytes, char *out, size_t outSize) const override {
+
+    // lz4 only takes int sizes
+    if(numBytes > LZ4_MAX_INPUT_SIZE) {
+      return 0;
+    }
+
+    auto compressedSize = LZ4_compress_fast(in, out, (int) numBytes, (int) std::min<size_t>(outSize, std::numeric_limits<int>::max()), std::max(level, 1));
+    return compressedSize <= 0 ? 0 : (size_t) compressedSize;
+  }
+
+  bool decompress(const char *in, size_t compressedSize, char *out, size_t uncompressedSize) const override {
+
+    // lz4 only takes int sizes
+    if(compressedSize > std::numeric_limits<int>::max() || uncompressedSize > std::numeric_limits<int>::max()) {
+      return false;
+    }
+
+    return LZ4_decompress_safe(in, out, (int) compressedSize, (int) uncompressedSize) == (int) uncompressedSize;
+  }
+};
+
+#endif
+
+#ifdef PDB_WITH_ZSTD
+
+/**
+ * Compresses with zstd, the level is the level of zstd
+ */
+class PDBZstdCodec : public PDBCodec {
+ public:
+
+  explicit PDBZstdCodec(int level) : PDBCodec(PDB_ZSTD_CODEC, level) {}
+
+  size_t getMaxCompressedSize(size_t numBytes) const override {
+    return ZSTD_compressBound(numBytes);
+  }
+
+  size_t compress(const char *in, size_t numBytes, char *out, size_t outSize) const override {
+    auto compressedSize = ZSTD_compress(out, outSize, in, numBytes, level);
+    return ZSTD_isError(compressedSize) ? 0 : compressedSize;
+  }
+
+  bool decompress(const char *in, size_t compressedSize, char *out, size_t uncompressedSize) const override {
+    return ZSTD_decompress(out, uncompressedSize, in, compressedSize) == uncompressedSize;
+  }
+};
+
+#endif
+
+}
+
+PDBCodec::PDBCodec(PDBCodecType type, int level) : type(type), level(level) {}
+
+PDBCodecType PDBCodec::getType() const {
+  return type;
+}
+
+int PDBCodec::getLevel() const {
+  return level;
+}
+
+std::string PDBCodec::getName() const {
+
+  std::string name;
+  switch (type) {
+    case PDB_NO_CODEC: name = "none"; break;
+    case PDB_SNAPPY_CODEC: name = "snappy"; break;
+    case PDB_LZ4_CODEC: name = "lz4"; break;
+    case PDB_ZSTD_CODEC: name = "zstd"; break;
+  }
+
+  return level == 0 ? name : name + ":" + std::to_string(level);
+}
+
+size_t PDBCodec::getMaxFrameSize(size_t numBytes) const {
+  return sizeof(Frame) + getMaxCompressedSize(numBytes);
+}
+
+size_t PDBCodec::compressFrame(const char *in, size_t numBytes, char *out, size_t outSize) const {
+
+  // we need space for the header
+  if(outSize <= sizeof(Frame)) {
+    return 0;
+  }
+
+  // compress the bytes after the header
+  auto compressedSize = compress(in, numBytes, out + sizeof(Frame), outSize - sizeof(Frame));
+  if(compressedSize == 0 && numBytes != 0) {
+    return 0;
+  }
+
+  // write the header
+  auto frame = (Frame*) out;
+  frame->magic = frameMagic;
+  frame->codec = type;
+  frame->level = (int8_t) level;
+  frame->reserved = 0;
+  frame->uncompressedSize = numBytes;
+  frame->compressedSize = compressedSize;
+
+  return sizeof(Frame) + compressedSize;
+}
+
+bool PDBCodec::isFrame(const char *frame, size_t size) {
+  return size >= sizeof(Frame) &&
+         ((const Frame*) frame)->magic == frameMagic &&
+         ((const Frame*) frame)->compressedSize == size - sizeof(Frame);
+}
+
+size_t PDBCodec::getFrameUncompressedSize(const char *frame) {
+  return ((const Frame*) frame)->uncompressedSize;
+}
+
+size_t PDBCodec::getFrameSize(const char *frame) {
+  return sizeof(Frame) + ((const Frame*) frame)->compressedSize;
+}
+
+PDBCodecType PDBCodec::getFrameCodec(const char *frame) {
+  return (PDBCodecType) ((const Frame*) frame)->codec;
+}
+
+bool PDBCodec::decompressFrame(const char *frame, size_t frameSize, char *out, size_t outSize) {
+
+  // check the frame
+  if(!isFrame(frame, frameSize) || getFrameUncompressedSize(frame) > outSize) {
+    return false;
+  }
+
+  // get the codec it was compressed with
+  auto header = (const Frame*) frame;
+  auto codec = get((PDBCodecType) header->codec, header->level);
+  if(codec == nullptr) {
+    return false;
+  }
+
+  return codec->decompress(frame + sizeof(Frame), header->compressedSize, out, header->uncompressedSize);
+}
+
+PDBCodecPtr PDBCodec::get(PDBCodecType type, int level) {
+
+  switch (type) {
+    case PDB_NO_CODEC: return std::make_shared<PDBNoCodec>();
+    case PDB_SNAPPY_CODEC: return std::make_shared<PDBSnappyCodec>();
+#ifdef PDB_WITH_LZ4
+    case PDB_LZ4_CODEC: return std::make_shared<PDBLZ4Codec>(level);
+#endif
+#ifdef PDB_WITH_ZSTD
+    case PDB_ZSTD_CODEC: return std::make_shared<PDBZstdCodec>(level);
+#endif
+    default: return nullptr;
+  }
+}
+
+PDBCodecPtr PDBCodec::get(const std::string &name, std::string &errMsg) {
+
+  // split the name and the level
+  auto separator = name.find(':');
+  auto codecName = name.substr(0, separator);
+  int level = 0;
+  if(separator != std::string::npos) {
+    try {
+      size_t parsed;
+      level = std::stoi(name.substr(separator + 1), &parsed);
+      if(parsed != name.size() - separator - 1 || level < std::numeric_limits<int8_t>::min() || level > std::numeric_limits<int8_t>::max()) {
+        throw std::invalid_argument(name);
+      }
+    }
+    catch (std::exception &e) {
+      errMsg = "The level of the codec " + name + " is not valid.";
+      return nullptr;
+    }
+  }
+
+  // figure out the type
+  PDBCodecType codecType;
+  if(codecName == "none") {
+    codecType = PDB_NO_CODEC;
+  }
+  else if(codecName == "snappy") {
+    codecType = PDB_SNAPPY_CODEC;
+  }
+  else if(codecName == "lz4") {
+    codecType = PDB_LZ4_CODEC;
+  }
+  else if(codecName == "zstd") {
+    codecType = PDB_ZSTD_CODEC;
+  }
+  else {
+    errMsg = "There is no codec named " + codecName + ".";
+    return nullptr;
+  }
+
+  // only lz4 and zstd have levels
+  if(level != 0 && (codecType == PDB_NO_CODEC || codecType == PDB_SNAPPY_CODEC)) {
+    errMsg = "The codec " + codecName + " does not have levels.";
+    return nullptr;
+  }
+
+  // get it
+  auto codec = get(codecType, level);
+  if(codec == nullptr) {
+    errMsg = "The codec " + codecName + " was not built in.";
+  }
+
+  return codec;
+}
+
+std::vector<std::string> PDBCodec::getAvailable() {
+
+  std::vector<std::string> names = { "none", "snappy" };
+#ifdef PDB_WITH_LZ4
+  names.emplace_back("lz4");
+#endif
+#ifdef PDB_WITH_ZSTD
+  names.emplace_back("zstd:1");
+  names.emplace_back("zstd:3");
+  names.emplace_back("zstd:9");
+  names.emplace_back("zstd:19");
+#endif
+  return names;
+}
+
+}
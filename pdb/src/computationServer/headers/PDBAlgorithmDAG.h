@@ -0,0 +1,155 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <string>
+#include <physicalOptimizer/PDBOptimizerSource.h>
+
+namespace pdb {
+
+/**
+ * The algorithms of a computation and what they depend on. An algorithm depends on the algorithms that produce the
+ * page sets it consumes, and on the algorithms before it that write a set it scans or touch a set it writes. The
+ * computation server starts every algorithm as soon as the ones it depends on are done, so the algorithms that do not
+ * depend on each other, like the two sides of a shuffle join, run at the same time instead of one after another.
+ * If an algorithm that can stream its output makes a page set only one algorithm reads, and that one runs its pipelines
+ * on it, the two start together and the pages are handed over as they are made @see PDBStreamingPageSet
+ */
+class PDBAlgorithmDAG {
+ public:
+
+  /**
+   * Adds an algorithm, the algorithms are added in the order the physical optimizer generates them
+   * @param consumes - the page sets the algorithm reads
+   * @param produces - the page set the algorithm produces
+   * @param setsToScan - the sets the algorithm scans as (database, set)
+   * @param setsToWrite - the sets the algorithm materializes as (database, set)
+   * @param pageSetsToRemove - the page sets that are not needed once this algorithm and the ones before it are done
+   * @param pageSetsToScan - the page sets of consumes the pipelines of the algorithm start with, they can be streamed
+   * @param canStreamOutput - can the algorithm hand over the pages of the page set it produces as it makes them
+   * @return the index of the algorithm
+   */
+  size_t add(const std::vector<PDBPageSetIdentifier> &consumes,
+             const PDBPageSetIdentifier &produces,
+             const std::vector<std::pair<std::string, std::string>> &setsToScan,
+             const std::vector<std::pair<std::string, std::string>> &setsToWrite,
+             const std::vector<PDBPageSetIdentifier> &pageSetsToRemove,
+             const std::vector<PDBPageSetIdentifier> &pageSetsToScan = {},
+             bool canStreamOutput = false);
+
+  /**
+   * Returns the number of algorithms
+   */
+  size_t size() const;
+
+  /**
+   * Returns the algorithms an algorithm has to wait for
+   * @param algorithm - the index of the algorithm
+   */
+  const std::vector<size_t> &getDependencies(size_t algorithm) const;
+
+  /**
+   * Returns the page sets an algorithm reads while the algorithms that produce them run, it starts with them
+   * @param algorithm - the index of the algorithm
+   */
+  const std::vector<PDBPageSetIdentifier> &getStreamedPageSets(size_t algorithm) const;
+
+  /**
+   * Returns true if the page set of an algorithm is read while it makes it
+   * @param algorithm - the index of the algorithm
+   */
+  bool streamsOutput(size_t algorithm) const;
+
+  /**
+   * Returns the number of algorithms that might run at the same time as an algorithm, itself included. Those are the
+   * ones that neither wait for it nor it waits for them. The computation splits its threads among them.
+   * @param algorithm - the index of the algorithm
+   */
+  size_t getNumConcurrent(size_t algorithm) const;
+
+  /**
+   * Returns the algorithms that can run now, they are not started, the algorithms they depend on are done and the
+   * ones they stream from are started. They are marked as running.
+   * @return the indices of the algorithms
+   */
+  std::vector<size_t> start();
+
+  /**
+   * Marks a running algorithm as done
+   * @param algorithm - the index of the algorithm
+   * @return the page sets that can be removed now
+   */
+  std::vector<PDBPageSetIdentifier> finish(size_t algorithm);
+
+  /**
+   * Returns the number of algorithms that are running
+   */
+  size_t getNumRunning() const;
+
+  /**
+   * Returns true if all the algorithms are done
+   */
+  bool isDone() const;
+
+ private:
+
+  enum class PDBAlgorithmState {
+    WAITING,
+    RUNNING,
+    DONE
+  };
+
+  struct PDBAlgorithmNode {
+
+    // the algorithms this one has to wait for
+    std::vector<size_t> dependencies;
+
+    // the algorithms this one starts with since it reads their page sets while they make them
+    std::vector<size_t> streamedFrom;
+
+    // the page sets this one reads while they are made
+    std::vector<PDBPageSetIdentifier> streamedPageSets;
+
+    // can the pages of the page set it produces be read while it makes them
+    bool canStreamOutput = false;
+
+    // are they
+    bool streamsOutput = false;
+
+    // the page sets we can remove once this algorithm and all the ones before it are done
+    std::vector<PDBPageSetIdentifier> pageSetsToRemove;
+
+    // is it waiting, running or done
+    PDBAlgorithmState state = PDBAlgorithmState::WAITING;
+  };
+
+  // the algorithms in the order they were added
+  std::vector<PDBAlgorithmNode> algorithms;
+
+  // the algorithm that produces each page set
+  std::map<PDBPageSetIdentifier, size_t, PageSetIdentifierComparator> producers;
+
+  // the algorithms that consume each page set
+  std::map<PDBPageSetIdentifier, std::vector<size_t>, PageSetIdentifierComparator> consumers;
+
+  // the last algorithm that wrote each set
+  std::map<std::pair<std::string, std::string>, size_t> writers;
+
+  // the algorithms that scanned each set since it was last written
+  std::map<std::pair<std::string, std::string>, std::vector<size_t>> readers;
+
+  // the number of algorithms from the start that are all done
+  size_t numDonePrefix = 0;
+
+  // the number of running algorithms
+  size_t numRunning = 0;
+
+  /**
+   * Makes an algorithm wait for the whole page set it streams, since someone else reads it too
+   * @param algorithm - the index of the algorithm
+   * @param pageSet - the page set
+   */
+  void stopStreaming(size_t algorithm, const PDBPageSetIdentifier &pageSet);
+};
+
+}
@@ -8,10 +8,21 @@
 #include "PDBComputationStatsManager.h"
 #include <ServerFunctionality.h>
 #include <ExJob.h>
+#include <PDBChromeTrace.h>
+#include <PDBAlgorithmDAG.h>
+#include <PDBJobScheduler.h>
+#include <PDBPageSetCache.h>
+#include <PDBIncrementalAggregations.h>
+#include <PDBPreparedComputations.h>
+#include <PDBCatalogNode.h>
 #include <mutex>
+#include <atomic>
 
 namespace pdb {
 
+class PDBPhysicalOptimizer;
+class CSExecuteComputation;
+
 class PDBComputationServerFrontend : public ServerFunctionality {
 
 public:
@@ -22,19 +33,132 @@ public:
 
 private:
 
-  bool executeJob(pdb::Handle<ExJob> &job);
+  bool executeJob(pdb::Handle<ExJob> &job, PDBProfile &profile, const PDBChromeTracePtr &trace, std::atomic<uint64_t> &pageSetSize);
+
+  /**
+   * Runs the jobs of a computation. Every job is started as soon as the jobs it depends on are done, so the only
+   * barriers between the jobs are the ones the data requires. Once a job fails no new jobs are started.
+   * @param jobs - the jobs in the order the optimizer made them
+   * @param dag - what each job depends on
+   * @param profile - the profile of the computation, every job is added to it
+   * @param computationName - the name of the computation in the profile
+   * @param trace - the events of the processes that run the jobs
+   * @param pageSetSizes - the size of the page set each job produced on all the nodes together
+   * @param error - the error if a job failed
+   * @return true if all the jobs succeeded
+   */
+  bool executeJobs(std::vector<pdb::Handle<ExJob>> &jobs, PDBAlgorithmDAG &dag, PDBProfile &profile,
+                   const std::string &computationName, const PDBChromeTracePtr &trace, PDBPageSetCosts &pageSetSizes,
+                   std::string &error);
 
   bool scheduleJob(PDBCommunicator &temp, pdb::Handle<ExJob> &job, std::string &errMsg);
 
-  bool runScheduledJob(PDBCommunicator &communicator, string &errMsg);
+  bool runScheduledJob(PDBCommunicator &communicator, string &errMsg, PDBProfile &profile,
+                       const PDBChromeTracePtr &trace, const std::string &node, std::atomic<uint64_t> &pageSetSize);
 
   bool removeUnusedPageSets(const std::vector<pair<uint64_t, std::string>>& pageSets);
 
+  /**
+   * Checks that none of the jobs writes into a partitioned set. The output of a job stays on the node that made it, so
+   * its records would not be on the nodes the partitioning of the set places them on.
+   * @param jobs - the jobs of the computation
+   * @param error - the error if a job writes into a partitioned set
+   * @return true if none of them does
+   */
+  bool checkSetsToMaterialize(std::vector<pdb::Handle<ExJob>> &jobs, std::string &error);
+
+  /**
+   * Picks the nodes the jobs of a computation run on. If the sets the computation scans take at most
+   * @see NodeConfig::smallQueryThreshold bytes, it runs on the node that stores most of them and the rest is gathered
+   * there, so there are no shuffles or broadcasts. Otherwise it runs on all the nodes.
+   * @param optimizer - the optimizer of the computation, it knows the sets the computation scans
+   * @param nodes - the active worker nodes
+   * @param gatherSets - set to true if the computation runs on a single node and the jobs have to gather the sets
+   * @return the nodes the jobs run on
+   */
+  std::vector<PDBCatalogNodePtr> getComputationNodes(const PDBPhysicalOptimizer &optimizer,
+                                                     const std::vector<PDBCatalogNodePtr> &nodes,
+                                                     bool &gatherSets);
+
+  /**
+   * Figures out what the page sets of a computation depend on besides the TCAP, so the optimizer can find the ones that
+   * are cached @see PDBPageSetCache. The cached page sets that were computed from an older version of the sets the
+   * computation scans are removed from the cache.
+   * @param request - the computation
+   * @param optimizer - the optimizer of the computation, it knows the sets the computation scans
+   * @param nodes - the nodes the computation runs on
+   * @param stalePageSets - the cached page sets that have to be removed from the workers
+   * @return the info
+   */
+  PDBPageSetSignatureInfo getPageSetSignatureInfo(Handle<CSExecuteComputation> &request,
+                                                  const PDBPhysicalOptimizer &optimizer,
+                                                  const std::vector<PDBCatalogNodePtr> &nodes,
+                                                  std::vector<PDBPageSetIdentifier> &stalePageSets);
+
+  /**
+   * Hashes every computation of a request with everything it points to, so that two computations with the same TCAP
+   * but different parameters can be told apart. A computation is hashed in a canonical form, it is copied into a
+   * zeroed buffer and the state of the traversal that made the TCAP is cleared @see Computation::clearGraph
+   * @param request - the computation
+   * @return the hashes by the name of the computation in the TCAP, a computation that could not be copied has none
+   */
+  std::map<std::string, size_t> getComputationHashes(Handle<CSExecuteComputation> &request);
+
+  /**
+   * Returns true if the request has an aggregation that is incremental @see AggregateCompBase::setIncremental
+   * @param request - the computation
+   * @return true if it has one
+   */
+  bool hasIncrementalAggregation(Handle<CSExecuteComputation> &request);
+
+  /**
+   * If the job runs an incremental aggregation, starts the run of it and sets the generation of the output the job
+   * makes @see ExJob::incrementalGeneration. The run is finished by @see executeJob
+   * @param request - the computation
+   * @param tcap - the TCAP of the computation
+   * @param job - the job
+   * @param nodes - the nodes the job runs on
+   * @param started - the output set and the generation are added here if a run was started
+   */
+  void startIncrementalAggregation(Handle<CSExecuteComputation> &request,
+                                   const std::string &tcap,
+                                   Handle<ExJob> &job,
+                                   const std::vector<PDBCatalogNodePtr> &nodes,
+                                   std::vector<std::pair<std::pair<std::string, std::string>, uint64_t>> &started);
+
+  /**
+   * Writes the events of a computation into traces/computation_<id>.json under the root directory, so it can be opened
+   * in chrome://tracing or Perfetto. Nothing is written if the trace is empty, which it is if tracing is disabled.
+   * @param compID - the id of the computation
+   * @param trace - the events
+   */
+  void writeTrace(uint64_t compID, const PDBChromeTracePtr &trace);
+
   /**
    * This manages the stats about each computation
    */
   PDBComputationStatsManager statsManager;
 
+  /**
+   * Decides when the computations run and how many threads and memory they get
+   */
+  PDBJobSchedulerPtr scheduler;
+
+  /**
+   * Keeps the intermediate page sets for the computations that compute them again, null if it is disabled
+   */
+  PDBPageSetCachePtr pageSetCache;
+
+  /**
+   * Keeps track of the output of the incremental aggregations
+   */
+  PDBIncrementalAggregations incrementalAggregations;
+
+  /**
+   * The TCAP of the queries the clients prepared
+   */
+  PDBPreparedComputations preparedComputations;
+
   /**
    * The logger for this thing
    */
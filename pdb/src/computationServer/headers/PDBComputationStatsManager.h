@@ -8,6 +8,7 @@
 #include <mutex>
 #include <unordered_map>
 #include <memory>
+#include <PDBProfile.h>
 
 // just declaring a pointer type for the PDBComputationStats
 struct PDBComputationStats;
@@ -37,6 +38,11 @@ struct PDBComputationStats {
    * Is the computation still running
    */
   bool stillRunning = false;
+
+  /**
+   * The profile of the computation once it ended
+   */
+  pdb::PDBProfilePtr profile = nullptr;
 };
 
 /**
@@ -59,8 +65,17 @@ public:
 
   /**
    * This is called to end the computation with a particular id
+   * @param compID - the id of the computation
+   * @param profile - the profile of the operators the computation ran
+   */
+  void endComputation(uint64_t compID, const pdb::PDBProfilePtr &profile);
+
+  /**
+   * Returns the profile of a computation that ended
+   * @param compID - the id of the computation
+   * @return the profile, null if we don't have the computation or it is still running
    */
-  void endComputation(uint64_t compID);
+  pdb::PDBProfilePtr getProfile(uint64_t compID);
 
 private:
 
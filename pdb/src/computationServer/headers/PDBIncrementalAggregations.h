@@ -0,0 +1,95 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <condition_variable>
+
+namespace pdb {
+
+class PDBIncrementalAggregations;
+using PDBIncrementalAggregationsPtr = std::shared_ptr<PDBIncrementalAggregations>;
+
+/**
+ * What the output of an incremental aggregation is computed from
+ */
+struct PDBIncrementalAggregation {
+
+  // the TCAP of the computation with the hash of every computation and its parameters
+  std::string signature;
+
+  // the nodes the aggregation runs on
+  std::string nodes;
+
+  // the number of threads on each node, the keys of the output are partitioned across them
+  uint64_t numThreads = 0;
+
+  // the set the aggregation scans
+  std::pair<std::string, std::string> inputSet;
+
+  // how many times the input set was cleared @see PDBDistributedStorage::getSetNumClears
+  uint64_t inputClears = 0;
+
+  // the version of the output set @see PDBDistributedStorage::getSetVersion
+  uint64_t outputVersion = 0;
+
+  // false if the aggregation can not merge into its output, because it does not just scan a set or is local
+  bool canMerge = false;
+
+  // the generation of the output @see ExJob::incrementalGeneration
+  uint64_t generation = 0;
+};
+
+/**
+ * Keeps track of the output of the incremental aggregations, so that the manager knows if the next run of an aggregation
+ * can aggregate just the pages that were added to its input and merge them into its output. That is the case if the
+ * same aggregation made the output on the same nodes with the same number of threads, nobody wrote to the output after
+ * it and the input was only added to. Otherwise the output is computed from scratch.
+ *
+ * Only one computation at a time runs the aggregation that writes to a set.
+ */
+class PDBIncrementalAggregations {
+ public:
+
+  /**
+   * Starts a run of the aggregation that writes to a set, waits if another computation is running one
+   * @param set - the output set of the aggregation
+   * @param current - what the output is computed from now, the generation is ignored
+   * @return the generation of the output the run makes, 1 if it is computed from scratch
+   */
+  uint64_t start(const std::pair<std::string, std::string> &set, PDBIncrementalAggregation &current);
+
+  /**
+   * Finishes a run of the aggregation, does nothing if it was already finished
+   * @param set - the output set of the aggregation
+   * @param generation - the generation of the output the run made
+   * @param success - true if the run wrote the output on every node
+   * @param outputVersion - the version the output set has after the run
+   */
+  void finish(const std::pair<std::string, std::string> &set, uint64_t generation, bool success, uint64_t outputVersion);
+
+ private:
+
+  /**
+   * The output of each aggregation, by the output set
+   */
+  std::map<std::pair<std::string, std::string>, PDBIncrementalAggregation> outputs;
+
+  /**
+   * The runs that are not finished, by the output set
+   */
+  std::map<std::pair<std::string, std::string>, PDBIncrementalAggregation> running;
+
+  /**
+   * Protects everything
+   */
+  std::mutex m;
+
+  /**
+   * Signaled when a run finishes
+   */
+  std::condition_variable cv;
+};
+
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <set>
+#include <mutex>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <condition_variable>
+
+namespace pdb {
+
+class PDBJobScheduler;
+using PDBJobSchedulerPtr = std::shared_ptr<PDBJobScheduler>;
+
+/**
+ * What a computation got when it was admitted
+ */
+struct PDBJobAdmission {
+
+  // the ticket of the computation, it is used to release it
+  uint64_t ticket = 0;
+
+  // the number of threads the computation can use on each node
+  uint64_t numThreads = 0;
+
+  // how many bytes of the buffer pool of each node the computation can pin
+  uint64_t memoryBudget = 0;
+};
+
+/**
+ * Decides when the computations run on the cluster. A computation is admitted once it is first in the queue, there are
+ * less than the maximum number of computations running and its memory budget fits into the buffer pool next to the
+ * budgets of the computations that are running. The queue is ordered by the priority and then by the time the
+ * computations arrived, so a large computation at the head is not overtaken forever by the smaller ones behind it.
+ * Each computation gets an equal share of the threads, so the computations that run at the same time never use more
+ * threads than a node has. The budgets are enforced by the buffer managers on the nodes @see PDBPinQuotas
+ */
+class PDBJobScheduler {
+ public:
+
+  /**
+   * Creates the scheduler
+   * @param numThreads - the number of threads each node has
+   * @param memory - the size of the buffer pool of each node
+   * @param maxConcurrentJobs - the maximum number of computations that run at the same time
+   */
+  PDBJobScheduler(uint64_t numThreads, uint64_t memory, uint64_t maxConcurrentJobs);
+
+  /**
+   * Waits until the computation is admitted
+   * @param priority - the computations with a higher priority are admitted first
+   * @param memoryBudget - how many bytes of the buffer pool the computation wants, 0 for an equal share
+   * @return what the computation got
+   */
+  PDBJobAdmission admit(int32_t priority, uint64_t memoryBudget);
+
+  /**
+   * Releases the threads and the memory of a computation that finished
+   * @param admission - what the computation got when it was admitted
+   */
+  void release(const PDBJobAdmission &admission);
+
+  /**
+   * Returns the number of computations that are running
+   */
+  uint64_t getNumRunning();
+
+  /**
+   * Returns the number of computations that wait to be admitted
+   */
+  uint64_t getNumWaiting();
+
+ private:
+
+  // the threads of each computation
+  uint64_t threadsPerJob;
+
+  // the size of the buffer pool and how much of it the running computations have
+  uint64_t memory;
+  uint64_t usedMemory = 0;
+
+  // the maximum number of computations that run at the same time and how many are running
+  uint64_t maxConcurrentJobs;
+  uint64_t numRunning = 0;
+
+  // the computations that wait as (-priority, ticket) so the first one is the one we admit next
+  std::set<std::pair<int64_t, uint64_t>> queue;
+
+  // the ticket of the next computation
+  uint64_t nextTicket = 0;
+
+  // protects the scheduler, the waiting computations wait on the condition variable
+  std::mutex m;
+  std::condition_variable cv;
+};
+
+/**
+ * Admits a computation when made and releases it once it goes out of scope, so the slot and the memory go back to the
+ * scheduler even if the computation fails or throws. Works like @see PDBPinOwnerScope
+ */
+class PDBJobAdmissionScope {
+ public:
+
+  PDBJobAdmissionScope(PDBJobSchedulerPtr scheduler, int32_t priority, uint64_t memoryBudget)
+      : scheduler(std::move(scheduler)) {
+    admission = this->scheduler->admit(priority, memoryBudget);
+  }
+
+  ~PDBJobAdmissionScope() {
+    release();
+  }
+
+  PDBJobAdmissionScope(const PDBJobAdmissionScope &) = delete;
+  PDBJobAdmissionScope &operator=(const PDBJobAdmissionScope &) = delete;
+
+  /**
+   * Returns what the computation got
+   */
+  const PDBJobAdmission &get() const {
+    return admission;
+  }
+
+  /**
+   * Releases the computation before the scope ends, calling it again does nothing
+   */
+  void release() {
+    if (!released) {
+      scheduler->release(admission);
+      released = true;
+    }
+  }
+
+ private:
+
+  // the scheduler that admitted the computation
+  PDBJobSchedulerPtr scheduler;
+
+  // what the computation got
+  PDBJobAdmission admission;
+
+  // did we release it already
+  bool released = false;
+};
+
+}
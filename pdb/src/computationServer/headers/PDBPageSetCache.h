@@ -0,0 +1,155 @@
+#pragma once
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <physicalOptimizer/PDBOptimizerSource.h>
+
+namespace pdb {
+
+class PDBPageSetCache;
+using PDBPageSetCachePtr = std::shared_ptr<PDBPageSetCache>;
+
+/**
+ * An intermediate page set that is kept on the workers after the computation that made it is done
+ */
+struct PDBCachedPageSet {
+
+  // the TCAP that makes the page set together with what it depends on @see PDBPhysicalOptimizer::getPageSetSignature
+  std::string signature;
+
+  // the page set on the workers
+  PDBPageSetIdentifier pageSet;
+
+  // the sets the page set was computed from, with the version they had @see PDBDistributedStorage::getSetVersion
+  std::map<std::pair<std::string, std::string>, uint64_t> sets;
+
+  // the size of the page set on all the workers together
+  size_t size = 0;
+};
+
+/**
+ * What the page sets of a computation depend on besides its TCAP
+ */
+struct PDBPageSetSignatureInfo {
+
+  // the nodes the computation runs on, a page set is only on the nodes it was made on
+  std::string nodes;
+
+  // the version of each set the computation scans @see PDBDistributedStorage::getSetVersion
+  std::map<std::pair<std::string, std::string>, uint64_t> setVersions;
+
+  // the hash of each computation with its parameters, by the name of the computation in the TCAP
+  std::map<std::string, size_t> computationHashes;
+};
+
+/**
+ * Keeps the intermediate page sets of the computations, like the selections of a set an iterative algorithm scans in
+ * every iteration, so that the next computation that needs the same page set uses it instead of computing it again.
+ * A page set is found by its signature, so it is only used if it was computed by the same part of the plan with the
+ * same parameters from the same versions of the sets.
+ *
+ * The page sets take up at most the maximum size, the least recently used ones are removed to make space. A page set
+ * is used by one computation at a time since the readers of a page set share its position, it is not removed while
+ * it is used.
+ */
+class PDBPageSetCache {
+ public:
+
+  /**
+   * Creates the cache
+   * @param maxSize - the maximum size of the cached page sets on all the workers together
+   */
+  explicit PDBPageSetCache(size_t maxSize);
+
+  /**
+   * Looks up a page set and marks it as used, it has to be released once the computation is done @see release
+   * @param signature - the signature of the page set
+   * @param pageSet - set to the cached page set if we have it
+   * @return true if we have it and nobody else is using it, false otherwise
+   */
+  bool use(const std::string &signature, PDBCachedPageSet &pageSet);
+
+  /**
+   * Marks a page set as no longer used
+   * @param signature - the signature of the page set
+   */
+  void release(const std::string &signature);
+
+  /**
+   * Adds a page set that a computation made, the least recently used page sets are removed if it does not fit
+   * @param pageSet - the page set
+   * @return the page sets that have to be removed from the workers, it is the added one if it is not kept
+   */
+  std::vector<PDBPageSetIdentifier> add(const PDBCachedPageSet &pageSet);
+
+  /**
+   * Removes the page sets that were computed from a different version of the set
+   * @param dbName - the database of the set
+   * @param setName - the name of the set
+   * @param version - the current version of the set
+   * @return the page sets that have to be removed from the workers
+   */
+  std::vector<PDBPageSetIdentifier> invalidate(const std::string &dbName, const std::string &setName, uint64_t version);
+
+  /**
+   * Returns the size of the cached page sets
+   */
+  size_t getSize();
+
+  /**
+   * Returns the number of cached page sets
+   */
+  size_t getNumPageSets();
+
+ private:
+
+  /**
+   * Removes a page set that is not used
+   * @param it - the page set
+   * @param toRemove - the page set is added here so it is removed from the workers
+   */
+  void evict(std::unordered_map<std::string, PDBCachedPageSet>::iterator it, std::vector<PDBPageSetIdentifier> &toRemove);
+
+  /**
+   * The maximum size of the cached page sets
+   */
+  size_t maxSize;
+
+  /**
+   * The size of the cached page sets
+   */
+  size_t size = 0;
+
+  /**
+   * The signatures of the page sets, the most recently used one is at the front
+   */
+  std::list<std::string> lru;
+
+  /**
+   * The cached page sets by their signature
+   */
+  std::unordered_map<std::string, PDBCachedPageSet> pageSets;
+
+  /**
+   * Where the signature of each page set is in the lru list
+   */
+  std::unordered_map<std::string, std::list<std::string>::iterator> positions;
+
+  /**
+   * The signatures of the page sets that are used by a computation
+   */
+  std::unordered_set<std::string> used;
+
+  /**
+   * Protects everything
+   */
+  std::mutex m;
+};
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+
+namespace pdb {
+
+class PDBPreparedComputations;
+using PDBPreparedComputationsPtr = std::shared_ptr<PDBPreparedComputations>;
+
+/**
+ * Keeps the TCAP of the prepared queries on the manager, so a client can run a query over and over again by its id
+ * without sending the TCAP every time @see CSPrepareComputation. Preparing the same TCAP again gives the same id, so
+ * the manager keeps every TCAP only once however many times it is prepared.
+ */
+class PDBPreparedComputations {
+ public:
+
+  /**
+   * Prepares a query
+   * @param tcap - the TCAP of the query
+   * @return the id of the prepared query
+   */
+  uint64_t prepare(const std::string &tcap);
+
+  /**
+   * Returns the TCAP of a prepared query
+   * @param preparedID - the id of the prepared query
+   * @param tcap - the TCAP is put here
+   * @return true if we have the query, false otherwise
+   */
+  bool getTCAP(uint64_t preparedID, std::string &tcap);
+
+ private:
+
+  /**
+   * The id of each TCAP
+   */
+  std::map<std::string, uint64_t> ids;
+
+  /**
+   * The TCAP of each id, they point to the keys of the ids
+   */
+  std::map<uint64_t, const std::string*> tcaps;
+
+  /**
+   * The id the next query gets, 0 is never used
+   */
+  uint64_t nextID = 1;
+
+  /**
+   * Protects the queries
+   */
+  std::mutex m;
+};
+
+}
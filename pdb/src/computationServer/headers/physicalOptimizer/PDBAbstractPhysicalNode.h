@@ -16,6 +16,7 @@
 #include <AtomicComputationClasses.h>
 #include <PDBPhysicalAlgorithm.h>
 #include "PDBOptimizerSource.h"
+#include <PDBCatalogSet.h>
 #include <Handle.h>
 
 enum PDBPipelineType {
@@ -220,6 +221,26 @@ public:
     return std::make_pair(scanSet->getDBName(), scanSet->getSetName());
   }
 
+  /**
+   * Sets the catalog info of the set this pipeline scans, it is only set for the pipelines that have a scan set
+   * @param set - the set
+   */
+  void setSourceSetInfo(const PDBCatalogSetPtr &set) { sourceSetInfo = set; }
+
+  /**
+   * Returns the catalog info of the set this pipeline scans
+   * @return the set if this pipeline has a scan set, null otherwise
+   */
+  const PDBCatalogSetPtr &getSourceSetInfo() { return sourceSetInfo; }
+
+  /**
+   * Checks if the records this pipeline scans are partitioned on the value of the provided column. That is the case if
+   * the scanned set is partitioned and the column is the partition key applied directly to the scanned records.
+   * @param column - the column produced by this pipeline
+   * @return true if it is, false otherwise
+   */
+  bool isPartitionedOn(const std::string &column);
+
   std::tuple<pdb::Handle<PDBSourcePageSetSpec>, pdb::Handle<PDBSourcePageSetSpec>, bool> getJoinSources(PDBPageSetCosts &pageSetCosts) {
 
     // make sure we are doing a join
@@ -344,6 +365,24 @@ public:
     sinkPageSet.produced = true;
   }
 
+  /**
+   * Makes the node produce a page set that already exists instead of the one it planned to produce, this happens if
+   * the page set was kept by an earlier computation @see PDBPageSetCache
+   * @param pageSet - the existing page set
+   */
+  void reuseSinkPageSet(const PDBPageSetIdentifier &pageSet) {
+    sinkPageSet.pageSetIdentifier = pageSet;
+  }
+
+  /**
+   * Checks if the node produces the page set
+   * @param pageSet - the page set
+   * @return true if it does, false otherwise
+   */
+  bool producesPageSet(const PDBPageSetIdentifier &pageSet) {
+    return sinkPageSet.produced && sinkPageSet.pageSetIdentifier == pageSet;
+  }
+
   /**
    * Returns the source type for a particular sink type. Basically it tells us which source we need
    * in order to use the result of a particular sink
@@ -463,6 +502,11 @@ protected:
    * The additional sources needed for the left pipeline
    */
   std::vector<pdb::Handle<PDBSourcePageSetSpec>> additionalSources;
+
+  /**
+   * The catalog info of the set this pipeline scans, null if it does not have a scan set
+   */
+  PDBCatalogSetPtr sourceSetInfo;
 };
 
 }
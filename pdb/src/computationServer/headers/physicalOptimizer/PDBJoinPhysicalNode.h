@@ -41,6 +41,14 @@ public:
 
 private:
 
+  /**
+   * Checks if the records that join are already on the same node. That is the case if both sides scan sets that are
+   * co-partitioned and each side is partitioned on its join key.
+   * @param other - the other side of the join
+   * @return true if they are, false otherwise
+   */
+  bool isCoPartitionedWith(PDBJoinPhysicalNode *other);
+
   /**
    * This constant is the cutoff threshold point where we use the shuffle join instead of the broadcast join
    */
@@ -55,6 +63,7 @@ private:
   FRIEND_TEST(TestPhysicalOptimizer, TestJoin2);
   FRIEND_TEST(TestPhysicalOptimizer, TestJoin3);
   FRIEND_TEST(TestPhysicalOptimizer, TestAggregationAfterTwoWayJoin);
+  FRIEND_TEST(TestPhysicalOptimizer, TestCoPartitionedJoin);
 };
 
 }
@@ -27,6 +27,7 @@
 #include <PDBPipeNodeBuilder.h>
 #include <PDBDistributedStorage.h>
 #include "PDBOptimizerSource.h"
+#include <PDBPageSetCache.h>
 
 namespace pdb {
 
@@ -78,8 +79,60 @@ public:
    */
   std::vector<PDBPageSetIdentifier> getPageSetsToRemove();
 
+  /**
+   * Returns the sets the computation scans
+   * @return the sets as pairs of (database, set)
+   */
+  const std::vector<std::pair<std::string, std::string>> &getInputSets() const { return inputSets; }
+
+  /**
+   * Returns the size of all the sets the computation scans together, used to figure out if it is small enough to run
+   * on a single node
+   * @return the size in bytes
+   */
+  size_t getInputSize() const { return inputSize; }
+
+  /**
+   * Makes the optimizer use the page sets that are in the cache instead of running the algorithms that make them. The
+   * page sets of this computation that could be cached are not removed, @see getPageSetsToCache
+   * @param cache - the cache
+   * @param info - what the page sets of the computation depend on besides the TCAP
+   */
+  void setPageSetCache(const PDBPageSetCachePtr &cache, PDBPageSetSignatureInfo info);
+
+  /**
+   * Returns the page sets the computation made that can be kept in the cache, their size is the one given by
+   * @see updatePageSet. They are not in the page sets to remove.
+   * @return the page sets
+   */
+  std::vector<PDBCachedPageSet> getPageSetsToCache();
+
+  /**
+   * Returns the signatures of the cached page sets the computation uses, they have to be released once it is done
+   * @return the signatures
+   */
+  const std::vector<std::string> &getUsedCachedPageSets() const { return usedCachedPageSets; }
+
 private:
 
+  /**
+   * Checks if the page set an algorithm makes is in the cache. If it is, the node that makes the page set is changed
+   * to produce the cached one and the algorithm is not run. If it is not, the page set is kept for the cache.
+   * @param source - the source the algorithm was generated from
+   * @param result - the result of the planning, it does not have an algorithm anymore if we use the cached page set
+   * @return true if we use the cached page set
+   */
+  bool useCachedPageSet(const PDBAbstractPhysicalNodePtr &source, PDBPlanningResult &result);
+
+  /**
+   * Returns the signature of a tuple set, it is the TCAP of all the atomic computations it is computed from together
+   * with the versions of the sets they scan, the hashes of the computations they belong to and the nodes.
+   * @param tupleSet - the atomic computation that makes the tuple set
+   * @param sets - the sets the tuple set is computed from are added here with their versions
+   * @return the signature, empty if we don't know everything the tuple set depends on
+   */
+  std::string getPageSetSignature(const AtomicComputationPtr &tupleSet, std::map<std::pair<std::string, std::string>, uint64_t> &sets);
+
   /**
    * The identifier of the computation
    */
@@ -110,6 +163,51 @@ private:
    */
   vector<PDBPageSetIdentifier> pageSetsToRemove;
 
+  /**
+   * The sets the computation scans
+   */
+  std::vector<std::pair<std::string, std::string>> inputSets;
+
+  /**
+   * The size of all the sets the computation scans
+   */
+  size_t inputSize = 0;
+
+  /**
+   * The size of each set the computation scans
+   */
+  std::map<std::pair<std::string, std::string>, size_t> inputSetSizes;
+
+  /**
+   * The atomic computations of the computation
+   */
+  std::shared_ptr<AtomicComputationList> atomicComputations;
+
+  /**
+   * The cache of the page sets, null if we don't use one
+   */
+  PDBPageSetCachePtr pageSetCache;
+
+  /**
+   * What the page sets of the computation depend on besides the TCAP
+   */
+  PDBPageSetSignatureInfo signatureInfo;
+
+  /**
+   * The page sets that will go to the cache once nothing in this computation needs them anymore
+   */
+  map<PDBPageSetIdentifier, PDBCachedPageSet, PageSetIdentifierComparator> pageSetsForCache;
+
+  /**
+   * The page sets nothing in this computation needs anymore that can go to the cache
+   */
+  std::vector<PDBCachedPageSet> pageSetsToCache;
+
+  /**
+   * The signatures of the cached page sets we use
+   */
+  std::vector<std::string> usedCachedPageSets;
+
   /**
    * The logger associated with the physical optimizer
    */
@@ -5,8 +5,7 @@
 #ifndef PDB_PDBPHYSICALOPTIMIZERTEMPLATE_H
 #define PDB_PDBPHYSICALOPTIMIZERTEMPLATE_H
 
-#include <Lexer.h>
-#include <Parser.h>
+#include <PDBPlanCache.h>
 
 namespace pdb {
 
@@ -16,36 +15,28 @@ PDBPhysicalOptimizer::PDBPhysicalOptimizer(uint64_t computationID,
                                            const shared_ptr<CatalogClient> &clientPtr,
                                            PDBLoggerPtr &logger) {
 
-  // get the string to compile
-  std::string myLogicalPlan = tcapString;
-  myLogicalPlan.push_back('\0');
-
-  // where the result of the parse goes
-  AtomicComputationList *myResult;
-
-  // now, do the compilation
-  yyscan_t scanner;
-  LexerExtra extra{""};
-  yylex_init_extra(&extra, &scanner);
-  const YY_BUFFER_STATE buffer{yy_scan_string(myLogicalPlan.data(), scanner)};
-  const int parseFailed{yyparse(scanner, &myResult)};
-  yy_delete_buffer(buffer, scanner);
-  yylex_destroy(scanner);
+  // grab the parsed TCAP, the computations that are run over and over again are parsed only once
+  std::string error;
+  atomicComputations = PDBPlanCache::get().getParsedTCAP(tcapString, error);
 
   // if it didn't parse, get outta here
-  if (parseFailed) {
-    std::cout << "Parse error when compiling TCAP: " << extra.errorMessage;
-    exit(1);
+  if (atomicComputations == nullptr) {
+    throw runtime_error("Parse error when compiling TCAP: " + error);
   }
 
-  // this is the logical plan to return
-  auto atomicComputations = std::shared_ptr<AtomicComputationList>(myResult);
-
-  // split the computations into pipes
+  // split the computations into pipes, if an earlier computation with the same TCAP did it we just make the nodes again
   pdb::PDBPipeNodeBuilder factory(computationID, atomicComputations);
+  auto pipes = PDBPlanCache::get().getPipes(tcapString);
 
   // fill the sources up
-  auto sourcesVector = factory.generateAnalyzerGraph();
+  std::vector<PDBAbstractPhysicalNodePtr> sourcesVector;
+  if(pipes != nullptr) {
+    sourcesVector = factory.generateAnalyzerGraph(*pipes);
+  }
+  else {
+    sourcesVector = factory.generateAnalyzerGraph();
+    PDBPlanCache::get().setPipes(tcapString, std::make_shared<const PDBCachedPipes>(factory.getPipes()));
+  }
   for(const auto &source : sourcesVector) {
 
     // if the source does not have a scan set something went horribly wrong
@@ -62,6 +53,14 @@ PDBPhysicalOptimizer::PDBPhysicalOptimizer(uint64_t computationID,
       throw runtime_error("Could not find the set I needed. " +  error);
     }
 
+    // remember the set so we can figure out if the pipeline can run locally
+    source->setSourceSetInfo(set);
+
+    // remember what we scan
+    inputSets.emplace_back(setIdentifier);
+    inputSetSizes[setIdentifier] = set->setSize;
+    inputSize += set->setSize;
+
     // add the source to the data structures
     sources.insert(std::make_pair(set->setSize, source));
     pageSetCosts[source->getSourcePageSet(pageSetCosts)->pageSetIdentifier] = set->setSize;
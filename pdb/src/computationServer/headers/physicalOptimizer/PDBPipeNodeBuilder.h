@@ -23,6 +23,7 @@
 #include <AtomicComputation.h>
 #include <assert.h>
 #include "PDBAbstractPhysicalNode.h"
+#include "PDBPlanCache.h"
 
 namespace pdb {
 
@@ -39,6 +40,20 @@ public:
    */
   std::vector<PDBAbstractPhysicalNodePtr> generateAnalyzerGraph();
 
+  /**
+   * Makes the nodes from the pipes an earlier computation with the same TCAP was split into, so we don't have to go
+   * through the TCAP graph again. The nodes are new since they belong to this computation.
+   * @param pipes - the pipes @see getPipes
+   * @return the source nodes, the same ones @see generateAnalyzerGraph returns
+   */
+  std::vector<PDBAbstractPhysicalNodePtr> generateAnalyzerGraph(const PDBCachedPipes &pipes);
+
+  /**
+   * Returns the pipes the TCAP was split into, in the order the nodes were made
+   * @return the pipes
+   */
+  const PDBCachedPipes &getPipes() const { return pipes; }
+
  protected:
 
   /**
@@ -68,8 +83,15 @@ public:
     // this must never be empty
     assert(!currentPipe.empty());
 
+    // remember the pipe so the nodes can be made again for the next computation with the same TCAP
+    pipes.emplace_back();
+    for(const auto &atomicComputation : currentPipe) {
+      pipes.back().pipeline.emplace_back(atomicComputation->getOutputName());
+    }
+
     // create the node
     auto node = new T(currentPipe, computationID, currentNodeIndex++);
+    pipes.back().type = node->getType();
 
     // create the node handle
     auto nodeHandle = node->getHandle();
@@ -151,6 +173,11 @@ public:
    * The id of the computation we are building the pipes for
    */
   size_t computationID;
+
+  /**
+   * The pipes we made the nodes from
+   */
+  PDBCachedPipes pipes;
 };
 
 }
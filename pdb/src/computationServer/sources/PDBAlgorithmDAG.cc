@@ -0,0 +1,222 @@
+#include <PDBAlgorithmDAG.h>
+#include <algorithm>
+#include <cassert>
+
+namespace pdb {
+
+size_t PDBAlgorithmDAG::add(const std::vector<PDBPageSetIdentifier> &consumes,
+                            const PDBPageSetIdentifier &produces,
+                            const std::vector<std::pair<std::string, std::string>> &setsToScan,
+                            const std::vector<std::pair<std::string, std::string>> &setsToWrite,
+                            const std::vector<PDBPageSetIdentifier> &pageSetsToRemove,
+                            const std::vector<PDBPageSetIdentifier> &pageSetsToScan,
+                            bool canStreamOutput) {
+
+  auto idx = algorithms.size();
+  PDBAlgorithmNode node;
+  node.pageSetsToRemove = pageSetsToRemove;
+  node.canStreamOutput = canStreamOutput;
+
+  // if somebody already streams a page set we consume it has to wait for the whole of it, we would miss its pages
+  for (const auto &pageSet : consumes) {
+    auto &pageSetConsumers = consumers[pageSet];
+    if (!pageSetConsumers.empty() && pageSetConsumers.back() == idx) {
+      continue;
+    }
+    for (auto consumer : pageSetConsumers) {
+      stopStreaming(consumer, pageSet);
+    }
+    pageSetConsumers.emplace_back(idx);
+  }
+
+  // wait for the last write of the sets we scan
+  for (const auto &set : setsToScan) {
+    auto it = writers.find(set);
+    if (it != writers.end()) {
+      node.dependencies.emplace_back(it->second);
+    }
+  }
+
+  // wait for the last write and the scans after it of the sets we write
+  for (const auto &set : setsToWrite) {
+    auto it = writers.find(set);
+    if (it != writers.end()) {
+      node.dependencies.emplace_back(it->second);
+    }
+    auto &setReaders = readers[set];
+    node.dependencies.insert(node.dependencies.end(), setReaders.begin(), setReaders.end());
+  }
+
+  // we can start together with the producer of a page set our pipelines start with if we are the only one that reads it
+  // and we don't wait for the producer for some other reason
+  for (const auto &pageSet : pageSetsToScan) {
+
+    auto it = producers.find(pageSet);
+    if (it == producers.end()) {
+      continue;
+    }
+
+    auto &producer = algorithms[it->second];
+    auto numReads = std::count(consumes.begin(), consumes.end(), pageSet);
+    auto waitsAnyway = std::find(node.dependencies.begin(), node.dependencies.end(), it->second) != node.dependencies.end();
+    if (producer.canStreamOutput && !producer.streamsOutput && numReads == 1 && consumers[pageSet].size() == 1 && !waitsAnyway) {
+      producer.streamsOutput = true;
+      node.streamedFrom.emplace_back(it->second);
+      node.streamedPageSets.emplace_back(pageSet);
+    }
+  }
+
+  // wait for the algorithms that produce the page sets we consume and don't stream
+  for (const auto &pageSet : consumes) {
+    auto it = producers.find(pageSet);
+    if (it != producers.end() &&
+        std::find(node.streamedPageSets.begin(), node.streamedPageSets.end(), pageSet) == node.streamedPageSets.end()) {
+      node.dependencies.emplace_back(it->second);
+    }
+  }
+
+  // remove the duplicates
+  std::sort(node.dependencies.begin(), node.dependencies.end());
+  node.dependencies.erase(std::unique(node.dependencies.begin(), node.dependencies.end()), node.dependencies.end());
+
+  // remember what we produce, scan and write
+  producers[produces] = idx;
+  for (const auto &set : setsToScan) {
+    readers[set].emplace_back(idx);
+  }
+  for (const auto &set : setsToWrite) {
+    writers[set] = idx;
+    readers[set].clear();
+  }
+
+  algorithms.emplace_back(std::move(node));
+  return idx;
+}
+
+size_t PDBAlgorithmDAG::size() const {
+  return algorithms.size();
+}
+
+const std::vector<size_t> &PDBAlgorithmDAG::getDependencies(size_t algorithm) const {
+  return algorithms[algorithm].dependencies;
+}
+
+const std::vector<PDBPageSetIdentifier> &PDBAlgorithmDAG::getStreamedPageSets(size_t algorithm) const {
+  return algorithms[algorithm].streamedPageSets;
+}
+
+bool PDBAlgorithmDAG::streamsOutput(size_t algorithm) const {
+  return algorithms[algorithm].streamsOutput;
+}
+
+size_t PDBAlgorithmDAG::getNumConcurrent(size_t algorithm) const {
+
+  // figure out what runs before each algorithm, the algorithms only wait for the ones added before them. An algorithm
+  // that streams from a producer runs with it, but the ones waiting for that algorithm run after the producer too
+  std::vector<std::vector<bool>> before(algorithms.size(), std::vector<bool>(algorithms.size(), false));
+  for (size_t i = 0; i < algorithms.size(); ++i) {
+    for (auto dependency : algorithms[i].dependencies) {
+      before[i][dependency] = true;
+      for (auto producer : algorithms[dependency].streamedFrom) {
+        before[i][producer] = true;
+      }
+      for (size_t j = 0; j < dependency; ++j) {
+        before[i][j] = before[i][j] || before[dependency][j];
+      }
+    }
+    for (auto producer : algorithms[i].streamedFrom) {
+      for (size_t j = 0; j < producer; ++j) {
+        before[i][j] = before[i][j] || before[producer][j];
+      }
+    }
+  }
+
+  // count the ones that are not ordered with the algorithm
+  size_t numConcurrent = 0;
+  for (size_t i = 0; i < algorithms.size(); ++i) {
+    if (!before[algorithm][i] && !before[i][algorithm]) {
+      numConcurrent++;
+    }
+  }
+
+  return numConcurrent;
+}
+
+void PDBAlgorithmDAG::stopStreaming(size_t algorithm, const PDBPageSetIdentifier &pageSet) {
+
+  // do we stream it
+  auto &node = algorithms[algorithm];
+  auto it = std::find(node.streamedPageSets.begin(), node.streamedPageSets.end(), pageSet);
+  if (it == node.streamedPageSets.end()) {
+    return;
+  }
+  node.streamedPageSets.erase(it);
+
+  // wait for the producer to finish instead of starting with it
+  auto producer = producers[pageSet];
+  algorithms[producer].streamsOutput = false;
+  node.streamedFrom.erase(std::find(node.streamedFrom.begin(), node.streamedFrom.end(), producer));
+  auto pos = std::lower_bound(node.dependencies.begin(), node.dependencies.end(), producer);
+  if (pos == node.dependencies.end() || *pos != producer) {
+    node.dependencies.insert(pos, producer);
+  }
+}
+
+std::vector<size_t> PDBAlgorithmDAG::start() {
+
+  std::vector<size_t> runnable;
+  for (size_t i = numDonePrefix; i < algorithms.size(); ++i) {
+
+    // skip the ones that are already started
+    auto &node = algorithms[i];
+    if (node.state != PDBAlgorithmState::WAITING) {
+      continue;
+    }
+
+    // check if everything we depend on is done
+    auto ready = std::all_of(node.dependencies.begin(), node.dependencies.end(), [&](size_t dependency) {
+      return algorithms[dependency].state == PDBAlgorithmState::DONE;
+    });
+
+    // the producers we stream from come before us, so they are started in this pass if they can be
+    ready = ready && std::all_of(node.streamedFrom.begin(), node.streamedFrom.end(), [&](size_t producer) {
+      return algorithms[producer].state != PDBAlgorithmState::WAITING;
+    });
+
+    if (ready) {
+      node.state = PDBAlgorithmState::RUNNING;
+      runnable.emplace_back(i);
+    }
+  }
+
+  numRunning += runnable.size();
+  return runnable;
+}
+
+std::vector<PDBPageSetIdentifier> PDBAlgorithmDAG::finish(size_t algorithm) {
+
+  assert(algorithms[algorithm].state == PDBAlgorithmState::RUNNING);
+  algorithms[algorithm].state = PDBAlgorithmState::DONE;
+  numRunning--;
+
+  // the page sets of an algorithm are removed once it and all the ones before it are done, since the optimizer
+  // figured out they are not needed assuming the algorithms run one after another
+  std::vector<PDBPageSetIdentifier> pageSetsToRemove;
+  while (numDonePrefix < algorithms.size() && algorithms[numDonePrefix].state == PDBAlgorithmState::DONE) {
+    auto &toRemove = algorithms[numDonePrefix].pageSetsToRemove;
+    pageSetsToRemove.insert(pageSetsToRemove.end(), toRemove.begin(), toRemove.end());
+    numDonePrefix++;
+  }
+
+  return pageSetsToRemove;
+}
+
+size_t PDBAlgorithmDAG::getNumRunning() const {
+  return numRunning;
+}
+
+bool PDBAlgorithmDAG::isDone() const {
+  return numDonePrefix == algorithms.size();
+}
+
+}
@@ -3,6 +3,7 @@
 //
 
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <ExJob.h>
 #include <PDBComputationServerFrontend.h>
 #include <GenericWork.h>
@@ -16,15 +17,55 @@
 #include "PDBDistributedStorage.h"
 #include "ExRunJob.h"
 #include "SimpleRequestResult.h"
+#include "ExRunJobResult.h"
+#include "CSExecuteComputationResult.h"
+#include "CSPrepareComputation.h"
+#include "CSPrepareComputationResult.h"
+#include "PDBPlanCache.h"
+#include "AllocationBlockPool.h"
+#include "PDBTracer.h"
+#include "Tracing.h"
+#include "PDBAlgorithmDAG.h"
+#include "PDBAggregationPipeAlgorithm.h"
+#include "AggregateCompBase.h"
+#include "LogicalPlan.h"
+#include <condition_variable>
+#include <map>
 
 void pdb::PDBComputationServerFrontend::init() {
 
   // init the class
   logger = make_shared<pdb::PDBLogger>((boost::filesystem::path(getConfiguration()->rootDirectory) / "logs").string(),
                                        "PDBComputationServerFrontend.log");
+
+  // the computations share the threads and the buffer pool of the nodes, we assume they all have the same configuration
+  scheduler = std::make_shared<PDBJobScheduler>((uint64_t) getConfiguration()->numThreads,
+                                                getConfiguration()->sharedMemSize * 1024 * 1024,
+                                                (uint64_t) getConfiguration()->maxConcurrentJobs);
+
+  // keep the intermediate page sets if we have space for them
+  if(getConfiguration()->pageSetCacheSize != 0) {
+    pageSetCache = std::make_shared<PDBPageSetCache>(getConfiguration()->pageSetCacheSize);
+  }
+}
+
+namespace {
+
+// the name of the algorithm of a job in the profile
+std::string getAlgorithmName(pdb::PDBPhysicalAlgorithmType type) {
+  switch (type) {
+    case pdb::ShuffleForJoin: return "shuffle for join";
+    case pdb::BroadcastForJoin: return "broadcast for join";
+    case pdb::DistributedAggregation: return "aggregation";
+    case pdb::StraightPipe: return "straight pipe";
+  }
+  return "unknown";
+}
+
 }
 
-bool pdb::PDBComputationServerFrontend::executeJob(pdb::Handle<pdb::ExJob> &job) {
+bool pdb::PDBComputationServerFrontend::executeJob(pdb::Handle<pdb::ExJob> &job, PDBProfile &profile, const PDBChromeTracePtr &trace,
+                                                  std::atomic<uint64_t> &pageSetSize) {
 
   // the locks for the sets
   std::vector<PDBDistributedStorageSetLockPtr> locks;
@@ -88,7 +129,7 @@ bool pdb::PDBComputationServerFrontend::executeJob(pdb::Handle<pdb::ExJob> &job)
     auto worker = parent->getWorkerQueue()->getWorker();
 
     // make the work
-    PDBWorkPtr myWork = make_shared<pdb::GenericWork>([=, &counter, &job](PDBBuzzerPtr callerBuzzer) {
+    PDBWorkPtr myWork = make_shared<pdb::GenericWork>([=, &counter, &job, &profile, &trace, &pageSetSize](PDBBuzzerPtr callerBuzzer) {
 
       std::string errMsg;
 
@@ -132,8 +173,9 @@ bool pdb::PDBComputationServerFrontend::executeJob(pdb::Handle<pdb::ExJob> &job)
         return;
       }
 
-      /// 4. Run the computation and wait for it to finish
-      if(!runScheduledJob(comm, errMsg)) {
+      /// 4. Run the computation and wait for it to finish, the profile and the events of the node are added to the ones of the job
+      auto node = (std::string) job->nodes[i]->address + ":" + std::to_string(job->nodes[i]->port);
+      if(!runScheduledJob(comm, errMsg, profile, trace, node, pageSetSize)) {
 
         // we failed to run the job
         callerBuzzer->buzz(PDBAlarm::GenericError, counter);
@@ -153,6 +195,102 @@ bool pdb::PDBComputationServerFrontend::executeJob(pdb::Handle<pdb::ExJob> &job)
     tempBuzzer->wait();
   }
 
+  // the output of an incremental aggregation stays valid until somebody else changes the set, we still hold it so the
+  // version changes once more when we release it
+  if(job->incrementalGeneration != 0) {
+    auto &set = setsToMaterialize.front();
+    incrementalAggregations.finish(set, job->incrementalGeneration, success, distStorage->getSetVersion(set.first, set.second) + 1);
+  }
+
+  return success;
+}
+
+bool pdb::PDBComputationServerFrontend::executeJobs(std::vector<pdb::Handle<pdb::ExJob>> &jobs, PDBAlgorithmDAG &dag, PDBProfile &profile,
+                                                   const std::string &computationName, const PDBChromeTracePtr &trace,
+                                                   PDBPageSetCosts &pageSetSizes, std::string &error) {
+
+  // protects the dag and the error, the jobs notify us through the condition variable when they are done
+  std::mutex m;
+  std::condition_variable cv;
+  bool success = true;
+
+  std::unique_lock<std::mutex> lck(m);
+  while(true) {
+
+    // grab the jobs that can run now, we don't start new ones once a job has failed
+    auto runnable = success ? dag.start() : std::vector<size_t>();
+
+    // if nothing can start and nothing is running we are done
+    if(runnable.empty() && dag.getNumRunning() == 0) {
+      break;
+    }
+
+    // wait for a job to finish if we can not start anything
+    if(runnable.empty()) {
+      cv.wait(lck);
+      continue;
+    }
+
+    // we don't hold the lock while waiting for the workers so the running jobs can finish
+    lck.unlock();
+    for(auto idx : runnable) {
+
+      // grab a worker
+      auto worker = parent->getWorkerQueue()->getWorker();
+
+      // make the work
+      PDBWorkPtr myWork = make_shared<pdb::GenericWork>([&, idx](PDBBuzzerPtr callerBuzzer) {
+
+        auto &job = jobs[idx];
+
+        // broadcast the job to each node and run it...
+        PDBProfile jobProfile;
+        auto jobStart = PDBOperatorTimer::getWallTime();
+        std::atomic<uint64_t> pageSetSize;
+        pageSetSize = 0;
+        bool jobSuccess;
+        {
+          const PDBTraceJobScope traceScope{job->computationID, job->jobID};
+          PDB_TRACE_SCOPE_ARG("job", job->jobID);
+          jobSuccess = executeJob(job, jobProfile, trace, pageSetSize);
+        }
+
+        // add the job to the profile with the pages its pipelines scanned, the operators are summed up over all the nodes
+        auto jobStats = jobProfile.getScanStats();
+        jobStats.numInstances = 1;
+        jobStats.wallTime = PDBOperatorTimer::getWallTime() - jobStart;
+        jobStats.maxWallTime = jobStats.wallTime;
+        auto jobName = "job " + std::to_string(job->jobID) + ": " + getAlgorithmName(job->physicalAlgorithm->getAlgorithmType());
+        profile.add({ computationName, jobName }, jobStats);
+        profile.merge(jobProfile, { computationName, jobName });
+
+        // we notify while holding the lock, otherwise executeJobs might return before we are done with it
+        std::unique_lock<std::mutex> jobLck(m);
+
+        // did we fail
+        if(!jobSuccess && success) {
+          success = false;
+          error = "We failed to execute the job with the ID (" + std::to_string(job->jobID) + ")";
+        }
+
+        // remember how large the page set the job made is
+        pageSetSizes[job->physicalAlgorithm->getPageSetToProduce()] = pageSetSize;
+
+        // remove the page sets no job needs anymore
+        auto pageSetsToRemove = dag.finish(idx);
+        if(!pageSetsToRemove.empty() && !removeUnusedPageSets(pageSetsToRemove)) {
+          logger->error("Failed to remove some page sets.");
+        }
+
+        cv.notify_one();
+      });
+
+      // run the work
+      worker->execute(myWork, nullptr);
+    }
+    lck.lock();
+  }
+
   return success;
 }
 
@@ -187,16 +325,7 @@ bool pdb::PDBComputationServerFrontend::scheduleJob(pdb::PDBCommunicator &temp,
   }
 
   // allocate the memory
-  std::unique_ptr<char[]> memory(new char[objectSize]);
-  if (memory == nullptr) {
-
-    errMsg = "FATAL ERROR: Can't allocate memory";
-    logger->error(errMsg);
-
-    /// TODO this needs to be an exception or something
-    // this is a fatal error we should not be running out of memory
-    exit(-1);
-  }
+  PooledBuffer memory(objectSize);
 
   {
     bool success;
@@ -218,7 +347,9 @@ bool pdb::PDBComputationServerFrontend::scheduleJob(pdb::PDBCommunicator &temp,
   return true;
 }
 
-bool pdb::PDBComputationServerFrontend::runScheduledJob(pdb::PDBCommunicator &communicator, string &errMsg) {
+bool pdb::PDBComputationServerFrontend::runScheduledJob(pdb::PDBCommunicator &communicator, string &errMsg, PDBProfile &profile,
+                                                       const PDBChromeTracePtr &trace, const std::string &node,
+                                                       std::atomic<uint64_t> &pageSetSize) {
 
   // make an allocation block
   const pdb::UseTemporaryAllocationBlock tempBlock{1024};
@@ -254,11 +385,14 @@ bool pdb::PDBComputationServerFrontend::runScheduledJob(pdb::PDBCommunicator &co
     return false;
   }
 
+  // allocate the memory
+  PooledBuffer memory(objectSize);
+
   {
     bool success;
 
     // want this to be destroyed
-    Handle<SimpleRequestResult> result = communicator.getNextObject<SimpleRequestResult> (success, errMsg);
+    Handle<ExRunJobResult> result = communicator.getNextObject<ExRunJobResult> (memory.get(), success, errMsg);
     if (!success) {
 
       // log the error
@@ -268,6 +402,25 @@ bool pdb::PDBComputationServerFrontend::runScheduledJob(pdb::PDBCommunicator &co
       // we are done here does not work
       return false;
     }
+
+    // add the profile of the node and the part of the page set it made
+    profile.merge(result->profile);
+    pageSetSize += result->pageSetSize;
+
+    // add the events the processes of the node recorded
+    for (size_t i = 0; i < result->traces.size(); ++i) {
+      trace->addTrace(node, *result->traces[i]);
+    }
+
+    // did the node fail to run the job
+    if (!result->success) {
+
+      // log the error
+      errMsg = result->error;
+      logger->error("Failed to run the job : " + errMsg);
+
+      return false;
+    }
   }
 
   // return true
@@ -276,12 +429,67 @@ bool pdb::PDBComputationServerFrontend::runScheduledJob(pdb::PDBCommunicator &co
 
 void pdb::PDBComputationServerFrontend::registerHandlers(pdb::PDBServer &forMe) {
 
+  forMe.registerHandler(
+      CSPrepareComputation_TYPEID,
+      make_shared<pdb::HeapRequestHandler<pdb::CSPrepareComputation>>(
+          [&](Handle<pdb::CSPrepareComputation> request, PDBCommunicatorPtr sendUsingMe) {
+
+            // parse the TCAP so the client finds out right away if it is wrong, the computations that run it find it
+            // already parsed
+            std::string error;
+            uint64_t preparedID = 0;
+            std::string tcap = request->tcapString;
+            bool success = PDBPlanCache::get().getParsedTCAP(tcap, error) != nullptr;
+            if(success) {
+              preparedID = preparedComputations.prepare(tcap);
+            }
+            else {
+              error = "Parse error when compiling TCAP: " + error;
+              logger->error(error);
+            }
+
+            // send the id of the prepared query back
+            const pdb::UseTemporaryAllocationBlock respBlock{error.size() + 1024};
+            pdb::Handle<pdb::CSPrepareComputationResult> response = pdb::makeObject<pdb::CSPrepareComputationResult>(success, error, preparedID);
+            sendUsingMe->sendObject(response, error);
+
+            return make_pair(success, error);
+          }));
+
   forMe.registerHandler(
       CSExecuteComputation_TYPEID,
       make_shared<pdb::HeapRequestHandler<pdb::CSExecuteComputation>>(
           [&](Handle<pdb::CSExecuteComputation> request, PDBCommunicatorPtr sendUsingMe) {
 
-            /// 1. Init the optimizer
+            // tells the client the computation failed before it started
+            auto sendError = [&](std::string error) {
+
+              logger->error(error);
+
+              const pdb::UseTemporaryAllocationBlock respBlock{error.size() + 1024};
+              pdb::Handle<pdb::CSExecuteComputationResult> response = pdb::makeObject<pdb::CSExecuteComputationResult>(false, error);
+              sendUsingMe->sendObject(response, error);
+
+              return make_pair(false, error);
+            };
+
+            // a prepared query only sends the id of its TCAP
+            std::string tcap = request->tcapString;
+            if(request->preparedID != 0 && !preparedComputations.getTCAP(request->preparedID, tcap)) {
+              return sendError("The prepared computation " + std::to_string(request->preparedID) + " is not known to the manager.");
+            }
+
+            /// 1. Wait until the scheduler admits the computation
+
+            // the computation is released once we are done with it, even if we fail or throw
+            std::unique_ptr<PDBJobAdmissionScope> admissionScope;
+            {
+              PDB_TRACE_SCOPE("admission");
+              admissionScope.reset(new PDBJobAdmissionScope(scheduler, request->priority, request->memoryBudget));
+            }
+            const auto &admission = admissionScope->get();
+
+            /// 2. Init the optimizer
 
             // indicators
             bool success = true;
@@ -290,28 +498,71 @@ void pdb::PDBComputationServerFrontend::registerHandlers(pdb::PDBServer &forMe)
             // the id associated with this computation
             auto compID = this->statsManager.startComputation();
 
+            // the profile of the computation, each job is a child of the computation
+            auto profile = std::make_shared<PDBProfile>();
+            auto computationName = "computation " + std::to_string(compID);
+            auto computationStart = PDBOperatorTimer::getWallTime();
+
+            // the events of all the processes that run the computation
+            auto trace = std::make_shared<PDBChromeTrace>();
+            auto traceStart = PDBTracer::now();
+
             // distributed storage
             auto catalogClient = getFunctionalityPtr<pdb::PDBCatalogClient>();
 
-            // init the optimizer
-            pdb::PDBPhysicalOptimizer optimizer(compID, request->tcapString, catalogClient, logger);
+            // the time it takes to parse and plan the computation, a computation that is run over and over again is parsed only once
+            auto planningStart = PDBOperatorTimer::getWallTime();
+
+            // init the optimizer, if the TCAP does not parse or a set it scans is not there the client gets the error
+            std::unique_ptr<pdb::PDBPhysicalOptimizer> optimizerPtr;
+            try {
+              optimizerPtr.reset(new pdb::PDBPhysicalOptimizer(compID, tcap, catalogClient, logger));
+            } catch (std::runtime_error &e) {
+              this->statsManager.endComputation(compID, profile);
+              return sendError(e.what());
+            }
+            auto &optimizer = *optimizerPtr;
 
             // we start from job 0
             uint64_t jobID = 0;
 
             std::cout << "Got TCAP : \n";
-            std::cout << request->tcapString << "\n\n";
+            std::cout << tcap << "\n\n";
 
-            /// 2. Run job while the optimizer can spit out an algorithm
+            /// 3. Plan all the algorithms, the optimizer does not need to know how they ran to make the next one
 
             // make an allocation block the computation size + 1MB for algorithm and stuff
             const pdb::UseTemporaryAllocationBlock tempBlock{request->numBytes + 1024 * 1024};
 
-            // while we still have jobs to execute
+            // grab the nodes we want to forward the jobs to, a small computation runs on just one of them unless an
+            // incremental aggregation has to replace its output on every node
+            bool gatherSets = false;
+            auto nodes = getFunctionality<PDBCatalogClient>().getActiveWorkerNodes();
+            if(!hasIncrementalAggregation(request)) {
+              nodes = getComputationNodes(optimizer, nodes, gatherSets);
+            }
+
+            // use the page sets the earlier computations left in the cache, the ones that are stale are removed
+            if(pageSetCache != nullptr) {
+
+              std::vector<PDBPageSetIdentifier> stalePageSets;
+              optimizer.setPageSetCache(pageSetCache, getPageSetSignatureInfo(request, optimizer, nodes, stalePageSets));
+              if(!stalePageSets.empty() && !removeUnusedPageSets(stalePageSets)) {
+                logger->error("Failed to remove some page sets.");
+              }
+            }
+
+            // while we still have jobs to plan
+            std::vector<Handle<ExJob>> jobs;
+            std::vector<std::pair<std::pair<std::string, std::string>, uint64_t>> incrementalRuns;
+            PDBAlgorithmDAG dag;
             while(optimizer.hasAlgorithmToRun()) {
 
-              // grab a algorithm
+              // grab a algorithm, we might not get one if the last sources did not need one
               auto algorithm = optimizer.getNextAlgorithm();
+              if(algorithm == nullptr) {
+                break;
+              }
 
               // make the job
               Handle<ExJob> job = pdb::makeObject<ExJob>();
@@ -319,49 +570,121 @@ void pdb::PDBComputationServerFrontend::registerHandlers(pdb::PDBServer &forMe)
               // set the job stuff
               job->computationID = compID;
               job->computations = request->computations;
-              job->tcap = request->tcapString;
+              job->tcap = tcap;
               job->jobID = jobID++;
               job->physicalAlgorithm = algorithm;
-              job->numberOfProcessingThreads = (uint64_t) getConfiguration()->numThreads;
-              job->numberOfNodes = catalogClient->getActiveWorkerNodes().size();
+              job->numberOfNodes = nodes.size();
+              job->gatherSets = gatherSets;
+
+              // the jobs split the share of the computation once we know which ones run together
+              job->memoryBudget = admission.memoryBudget;
 
               // just set how much we need for the computation object in case somebody embed some data in it
               job->computationSize = request->numBytes;
 
-              // grab the nodes we want to forward the request to
-              auto nodes = getFunctionality<PDBCatalogClient>().getActiveWorkerNodes();
-
               // copy the nodes
               for(const auto &node : nodes) {
                 job->nodes.push_back(pdb::makeObject<ExJobNode>(node->port, node->address));
               }
 
-              // broadcast the job to each node and run it...
-              if(!executeJob(job)) {
+              // figure out what the job waits for, the page sets that are not needed after it are removed once it is done
+              dag.add(algorithm->getPageSetsToConsume(),
+                      algorithm->getPageSetToProduce(),
+                      algorithm->getSetsToScan(),
+                      job->getSetsToMaterialize(),
+                      optimizer.getPageSetsToRemove(),
+                      algorithm->getPageSetsToScan(),
+                      algorithm->canStreamOutput());
 
-                // we failed therefore we are done here
-                success = false;
-                error = "We failed to execute the job with the ID (" + std::to_string(job->jobID) + + ")";
+              jobs.push_back(job);
+            }
 
-                break;
-              }
+            // we only know which jobs run together once every job is planned, a later job might run next to an
+            // earlier one or need the whole page set an earlier one would stream
+            for(size_t idx = 0; idx < jobs.size(); ++idx) {
 
-              // remove the page sets
-              if(!removeUnusedPageSets(optimizer.getPageSetsToRemove())) {
-                logger->error("Failed to remove some page sets.");
+              // the jobs that can run at the same time split the threads of the computation, but each job gets at
+              // least a thread per source
+              auto &algorithm = jobs[idx]->physicalAlgorithm;
+              jobs[idx]->numberOfProcessingThreads = std::max<uint64_t>(admission.numThreads / dag.getNumConcurrent(idx),
+                                                                        algorithm->getNumSources());
+
+              // the jobs that read a page set while it is made start with the job that makes it
+              if(dag.streamsOutput(idx)) {
+                algorithm->streamOutput();
+              }
+              for(const auto &pageSet : dag.getStreamedPageSets(idx)) {
+                algorithm->streamSource(pageSet);
               }
+
+              // an incremental aggregation merges into the output it has if it can
+              startIncrementalAggregation(request, tcap, jobs[idx], nodes, incrementalRuns);
+            }
+
+            // add the planning to the profile
+            PDBOperatorStats planningStats;
+            planningStats.numInstances = 1;
+            planningStats.wallTime = PDBOperatorTimer::getWallTime() - planningStart;
+            planningStats.maxWallTime = planningStats.wallTime;
+            profile->add({ computationName, "planning" }, planningStats);
+
+            /// 4. Run each job as soon as the jobs it depends on are done
+
+            PDBPageSetCosts pageSetSizes;
+            success = checkSetsToMaterialize(jobs, error) &&
+                      executeJobs(jobs, dag, *profile, computationName, trace, pageSetSizes, error);
+
+            // the incremental aggregations whose jobs never ran have to start from scratch next time
+            for(const auto &run : incrementalRuns) {
+              incrementalAggregations.finish(run.first, run.second, false, 0);
+            }
+
+            // remove the page sets the optimizer freed after the last algorithm
+            auto leftOverPageSets = optimizer.getPageSetsToRemove();
+
+            // the cached page sets we used can be used by the next computation
+            for(const auto &signature : optimizer.getUsedCachedPageSets()) {
+              pageSetCache->release(signature);
+            }
+
+            // the page sets we made that can be cached go to the cache, unless we failed since they might be incomplete
+            for(const auto &pageSetSize : pageSetSizes) {
+              optimizer.updatePageSet(pageSetSize.first, pageSetSize.second);
+            }
+            for(const auto &pageSet : optimizer.getPageSetsToCache()) {
+
+              auto toRemove = success ? pageSetCache->add(pageSet) : std::vector<PDBPageSetIdentifier>{ pageSet.pageSet };
+              leftOverPageSets.insert(leftOverPageSets.end(), toRemove.begin(), toRemove.end());
+            }
+            if(!leftOverPageSets.empty() && !removeUnusedPageSets(leftOverPageSets)) {
+              logger->error("Failed to remove some page sets.");
             }
 
+            // the threads and the memory can go to the next computation
+            admissionScope->release();
+
+            // the whole computation is the root of the profile, it has the pages all the jobs scanned
+            auto computationStats = profile->getScanStats();
+            computationStats.numInstances = 1;
+            computationStats.wallTime = PDBOperatorTimer::getWallTime() - computationStart;
+            computationStats.maxWallTime = computationStats.wallTime;
+            profile->add({ computationName }, computationStats);
+
             // end the computation
-            this->statsManager.endComputation(compID);
+            this->statsManager.endComputation(compID, profile);
+
+            // add the events of the manager and write the trace if we have one
+            trace->addEvents("manager", PDBTracer::collect(traceStart, compID));
+            writeTrace(compID, trace);
 
-            /// 3. Send the result of the execution back to the client
+            /// 5. Send the result of the execution with the profile back to the client
 
-            // make an allocation block
-            const pdb::UseTemporaryAllocationBlock respBlock{1024};
+            // make an allocation block that can fit the profile
+            const pdb::UseTemporaryAllocationBlock respBlock{profile->getVectorSize()};
 
             // create an allocation block to hold the response
-            pdb::Handle<pdb::SimpleRequestResult> response = pdb::makeObject<pdb::SimpleRequestResult>(success, error);
+            pdb::Handle<pdb::CSExecuteComputationResult> response = pdb::makeObject<pdb::CSExecuteComputationResult>(success, error);
+            profile->toVector(response->profile);
 
             // sends result to requester
             sendUsingMe->sendObject(response, error);
@@ -371,6 +694,215 @@ void pdb::PDBComputationServerFrontend::registerHandlers(pdb::PDBServer &forMe)
 
 }
 
+std::vector<pdb::PDBCatalogNodePtr> pdb::PDBComputationServerFrontend::getComputationNodes(const PDBPhysicalOptimizer &optimizer,
+                                                                                         const std::vector<PDBCatalogNodePtr> &nodes,
+                                                                                         bool &gatherSets) {
+
+  // if the computation is not small or there is only one node anyway we run on all the nodes
+  gatherSets = false;
+  auto threshold = getConfiguration()->smallQueryThreshold;
+  if(threshold == 0 || nodes.size() <= 1 || optimizer.getInputSize() > threshold) {
+    return nodes;
+  }
+
+  // sum up how much of the input is on each node
+  std::map<std::string, size_t> bytesOnNode;
+  auto catalogClient = getFunctionalityPtr<PDBCatalogClient>();
+  for(const auto &set : optimizer.getInputSets()) {
+
+    // if we do not know where the set is we can not pick a node, so we run on all of them
+    std::string error;
+    auto setOnNodes = catalogClient->getSetOnNodes(set.first, set.second, error);
+    if(!error.empty() || setOnNodes.empty()) {
+      logger->warn("Could not get the nodes of the set " + set.first + ":" + set.second + ", running the computation on all the nodes. " + error);
+      return nodes;
+    }
+
+    for(const auto &setOnNode : setOnNodes) {
+      bytesOnNode[setOnNode->nodeID] += setOnNode->setSize;
+    }
+  }
+
+  // pick the node that has most of the input, so we move as little of it as we can
+  auto node = nodes.front();
+  size_t mostBytes = 0;
+  for(const auto &candidate : nodes) {
+
+    auto it = bytesOnNode.find(candidate->nodeID);
+    if(it != bytesOnNode.end() && it->second > mostBytes) {
+      node = candidate;
+      mostBytes = it->second;
+    }
+  }
+
+  logger->info("The computation scans " + std::to_string(optimizer.getInputSize()) + " bytes, running it on the node " + node->nodeID +
+               " that has " + std::to_string(mostBytes) + " of them.");
+
+  // the jobs gather the rest of the input on that node
+  gatherSets = true;
+  return { node };
+}
+
+pdb::PDBPageSetSignatureInfo pdb::PDBComputationServerFrontend::getPageSetSignatureInfo(Handle<CSExecuteComputation> &request,
+                                                                                     const PDBPhysicalOptimizer &optimizer,
+                                                                                     const std::vector<PDBCatalogNodePtr> &nodes,
+                                                                                     std::vector<PDBPageSetIdentifier> &stalePageSets) {
+
+  PDBPageSetSignatureInfo info;
+
+  // the nodes the page sets are made on
+  for(const auto &node : nodes) {
+    info.nodes += node->address + ":" + std::to_string(node->port) + " ";
+  }
+
+  // the versions of the sets, the page sets made from the older versions are not needed anymore
+  auto distStorage = getFunctionalityPtr<PDBDistributedStorage>();
+  for(const auto &set : optimizer.getInputSets()) {
+
+    auto version = distStorage->getSetVersion(set.first, set.second);
+    info.setVersions[set] = version;
+
+    auto stale = pageSetCache->invalidate(set.first, set.second, version);
+    stalePageSets.insert(stalePageSets.end(), stale.begin(), stale.end());
+  }
+
+  // the parameters of a computation are in the computation object, so we hash it
+  info.computationHashes = getComputationHashes(request);
+
+  return info;
+}
+
+std::map<std::string, size_t> pdb::PDBComputationServerFrontend::getComputationHashes(Handle<CSExecuteComputation> &request) {
+
+  // we hash the object with everything it points to, the computations are named the same way the TCAP names them
+  // @see LogicalPlan
+  std::map<std::string, size_t> hashes;
+  std::vector<char> buffer(request->numBytes + 1024 * 1024);
+  auto &computations = *request->computations;
+  for(int i = 0; i < computations.size(); ++i) {
+
+    // copy it into a zeroed buffer so we get all of its bytes in one place, the padding and the unused space are zero
+    // and not what the last computation left there. If it does not fit it has no hash
+    std::fill(buffer.begin(), buffer.end(), 0);
+    Record<Computation> *record;
+    try {
+      record = getRecord(computations[i], buffer.data(), buffer.size());
+    } catch (NotEnoughSpace &n) {
+      continue;
+    }
+
+    // the copy has the state the client left while making the TCAP, the same computation has the same bytes only
+    // once it is cleared
+    {
+      auto copy = record->getRootObject();
+      copy->clearGraph();
+    }
+
+    auto name = computations[i]->getComputationType() + "_" + std::to_string(i);
+    hashes[name] = std::hash<std::string>()(std::string((char*) record, record->numBytes()));
+  }
+
+  return hashes;
+}
+
+bool pdb::PDBComputationServerFrontend::hasIncrementalAggregation(Handle<CSExecuteComputation> &request) {
+
+  auto &computations = *request->computations;
+  for(int i = 0; i < computations.size(); ++i) {
+    if(computations[i]->getComputationType() == "AggregationComp" && unsafeCast<AggregateCompBase>(computations[i])->isIncremental()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void pdb::PDBComputationServerFrontend::startIncrementalAggregation(Handle<CSExecuteComputation> &request,
+                                                                    const std::string &tcap,
+                                                                    Handle<ExJob> &job,
+                                                                    const std::vector<PDBCatalogNodePtr> &nodes,
+                                                                    std::vector<std::pair<std::pair<std::string, std::string>, uint64_t>> &started) {
+
+  // only the aggregations can be incremental
+  auto &algorithm = job->physicalAlgorithm;
+  if(algorithm->getAlgorithmType() != DistributedAggregation) {
+    return;
+  }
+
+  // find the aggregation the job runs and check if it is incremental, the jobs of the computation share the plan
+  auto plan = PDBPlanCache::get().getLogicalPlan(tcap, request->computations, request->numBytes);
+  auto aggregation = plan->getComputations().getProducingAtomicComputation(algorithm->getFinalTupleSet());
+  if(!unsafeCast<AggregateCompBase>(plan->getNode(aggregation->getComputationName()).getComputationHandle())->isIncremental()) {
+    return;
+  }
+
+  // the output is replaced so it has to go to exactly one set, and one computation can only replace it once
+  auto sets = job->getSetsToMaterialize();
+  if(sets.size() != 1 || std::any_of(started.begin(), started.end(), [&](const auto &run) { return run.first == sets.front(); })) {
+    logger->error("An incremental aggregation has to write to exactly one set that nothing else in the computation writes to.");
+    return;
+  }
+
+  // the signature of the computation, if a computation could not be hashed we can not tell if it is the same one
+  auto hashes = getComputationHashes(request);
+  PDBIncrementalAggregation current;
+  current.signature = tcap;
+  for(const auto &hash : hashes) {
+    current.signature += "\n" + hash.first + " " + std::to_string(hash.second);
+  }
+
+  // the nodes and the threads the keys are partitioned across
+  for(const auto &node : nodes) {
+    current.nodes += node->address + ":" + std::to_string(node->port) + " ";
+  }
+  current.numThreads = job->numberOfProcessingThreads;
+
+  // we can only tell what pages of the input are in the output if the aggregation scans a set, and the keys go to the
+  // same workers every time only if they are sent to the workers, not kept on the node they are on
+  auto setsToScan = algorithm->getSetsToScan();
+  current.canMerge = hashes.size() == request->computations->size() &&
+                     setsToScan.size() == 1 &&
+                     algorithm->getNumSources() == 1 &&
+                     algorithm->getPageSetsToConsume().empty() &&
+                     !job->gatherSets &&
+                     !unsafeCast<PDBAggregationPipeAlgorithm>(algorithm)->isLocal();
+
+  // the input might only be added to, the output can not change at all
+  auto distStorage = getFunctionalityPtr<PDBDistributedStorage>();
+  if(current.canMerge) {
+    current.inputSet = setsToScan.front();
+    current.inputClears = distStorage->getSetNumClears(current.inputSet.first, current.inputSet.second);
+  }
+  current.outputVersion = distStorage->getSetVersion(sets.front().first, sets.front().second);
+
+  // start it, it merges only if it got the same share of the threads the output was partitioned across
+  job->incrementalGeneration = incrementalAggregations.start(sets.front(), current);
+  started.emplace_back(sets.front(), job->incrementalGeneration);
+
+  logger->info("The incremental aggregation writing to (" + sets.front().first + "," + sets.front().second + ") makes the generation " +
+               std::to_string(job->incrementalGeneration) + " of its output" + (job->incrementalGeneration == 1 ? " from scratch." : "."));
+}
+
+bool pdb::PDBComputationServerFrontend::checkSetsToMaterialize(std::vector<pdb::Handle<ExJob>> &jobs, std::string &error) {
+
+  auto catalogClient = getFunctionalityPtr<PDBCatalogClient>();
+  for(auto &job : jobs) {
+    for(const auto &set : job->getSetsToMaterialize()) {
+
+      // grab the set, if it is not there the job fails on its own
+      std::string catalogError;
+      auto catalogSet = catalogClient->getSet(set.first, set.second, catalogError);
+      if(catalogSet != nullptr && catalogSet->isPartitioned()) {
+        error = "The set (" + set.first + "," + set.second + ") is partitioned, the output of a computation can not be written into it!";
+        logger->error(error);
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 bool pdb::PDBComputationServerFrontend::removeUnusedPageSets(const std::vector<pair<uint64_t, std::string>> &pageSets) {
 
   atomic_bool success;
@@ -444,3 +976,25 @@ bool pdb::PDBComputationServerFrontend::removeUnusedPageSets(const std::vector<p
   return success;
 }
 
+void pdb::PDBComputationServerFrontend::writeTrace(uint64_t compID, const PDBChromeTracePtr &trace) {
+
+  // if tracing is disabled there is nothing to write
+  if(trace->isEmpty()) {
+    return;
+  }
+
+  // make the directory for the traces
+  boost::system::error_code ec;
+  auto directory = boost::filesystem::path(getConfiguration()->rootDirectory) / "traces";
+  boost::filesystem::create_directories(directory, ec);
+
+  // write the trace
+  std::string error;
+  auto path = (directory / ("computation_" + std::to_string(compID) + ".json")).string();
+  if(!trace->write(path, error)) {
+    logger->error(error);
+    return;
+  }
+
+  logger->info("Wrote the trace of the computation " + std::to_string(compID) + " to " + path);
+}
@@ -21,10 +21,10 @@ uint64_t PDBComputationStatsManager::startComputation() {
   // store the stat
   stats.insert(std::make_pair(compID, stat));
 
-  return 0;
+  return compID;
 }
 
-void PDBComputationStatsManager::endComputation(uint64_t compID) {
+void PDBComputationStatsManager::endComputation(uint64_t compID, const pdb::PDBProfilePtr &profile) {
 
   // lock the stuff
   std::unique_lock<std::mutex> lock(computationIDLock);
@@ -35,4 +35,19 @@ void PDBComputationStatsManager::endComputation(uint64_t compID) {
   // mark it as finished
   it->second->stillRunning = false;
   it->second->end = clock();
+  it->second->profile = profile;
+}
+
+pdb::PDBProfilePtr PDBComputationStatsManager::getProfile(uint64_t compID) {
+
+  // lock the stuff
+  std::unique_lock<std::mutex> lock(computationIDLock);
+
+  // find the computation
+  auto it = stats.find(compID);
+  if(it == stats.end()) {
+    return nullptr;
+  }
+
+  return it->second->profile;
 }
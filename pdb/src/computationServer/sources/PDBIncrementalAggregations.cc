@@ -0,0 +1,54 @@
+#include <PDBIncrementalAggregations.h>
+
+namespace pdb {
+
+uint64_t PDBIncrementalAggregations::start(const std::pair<std::string, std::string> &set, PDBIncrementalAggregation &current) {
+
+  // wait until nobody is writing the output
+  std::unique_lock<std::mutex> lck(m);
+  cv.wait(lck, [&] { return running.find(set) == running.end(); });
+
+  // we merge into the output if it was made the same way from the pages the input still has, and nobody changed it.
+  // The keys have to go to the same workers as before, so it has to run with the threads the output was partitioned
+  // across, if the scheduler gave it a different share it is computed from scratch with that share
+  auto it = outputs.find(set);
+  bool merge = current.canMerge &&
+               it != outputs.end() &&
+               it->second.signature == current.signature &&
+               it->second.nodes == current.nodes &&
+               it->second.numThreads == current.numThreads &&
+               it->second.inputSet == current.inputSet &&
+               it->second.inputClears == current.inputClears &&
+               it->second.outputVersion == current.outputVersion;
+
+  current.generation = merge ? it->second.generation + 1 : 1;
+  running[set] = current;
+
+  return current.generation;
+}
+
+void PDBIncrementalAggregations::finish(const std::pair<std::string, std::string> &set, uint64_t generation, bool success, uint64_t outputVersion) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // is this run still going
+  auto it = running.find(set);
+  if(it == running.end() || it->second.generation != generation) {
+    return;
+  }
+
+  // if we failed some nodes might have the old output, so the next run starts from scratch, and so does the one after
+  // an output that can not be merged into since the workers did not keep track of the pages it was made from
+  if(success && it->second.canMerge) {
+    outputs[set] = it->second;
+    outputs[set].outputVersion = outputVersion;
+  }
+  else {
+    outputs.erase(set);
+  }
+
+  running.erase(it);
+  cv.notify_all();
+}
+
+}
@@ -0,0 +1,67 @@
+#include <PDBJobScheduler.h>
+#include <algorithm>
+
+namespace pdb {
+
+PDBJobScheduler::PDBJobScheduler(uint64_t numThreads, uint64_t memory, uint64_t maxConcurrentJobs)
+    : memory(memory), maxConcurrentJobs(std::max<uint64_t>(maxConcurrentJobs, 1)) {
+
+  // every computation gets an equal share of the threads, but at least one
+  threadsPerJob = std::max<uint64_t>(numThreads / this->maxConcurrentJobs, 1);
+}
+
+PDBJobAdmission PDBJobScheduler::admit(int32_t priority, uint64_t memoryBudget) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // figure out what the computation gets, if it did not ask for memory it gets an equal share
+  PDBJobAdmission admission;
+  admission.ticket = nextTicket++;
+  admission.numThreads = threadsPerJob;
+  admission.memoryBudget = memoryBudget == 0 ? memory / maxConcurrentJobs : std::min(memoryBudget, memory);
+
+  // get in line
+  auto position = std::make_pair(-(int64_t) priority, admission.ticket);
+  queue.insert(position);
+
+  // wait until we are first, there is a free slot and our budget fits
+  cv.wait(lck, [&] {
+    return *queue.begin() == position &&
+           numRunning < maxConcurrentJobs &&
+           usedMemory + admission.memoryBudget <= memory;
+  });
+
+  // we are running
+  queue.erase(queue.begin());
+  numRunning++;
+  usedMemory += admission.memoryBudget;
+
+  // the next one in line might fit too
+  cv.notify_all();
+
+  return admission;
+}
+
+void PDBJobScheduler::release(const PDBJobAdmission &admission) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // give back what the computation had
+  numRunning--;
+  usedMemory -= admission.memoryBudget;
+
+  // the first one in line might fit now
+  cv.notify_all();
+}
+
+uint64_t PDBJobScheduler::getNumRunning() {
+  std::unique_lock<std::mutex> lck(m);
+  return numRunning;
+}
+
+uint64_t PDBJobScheduler::getNumWaiting() {
+  std::unique_lock<std::mutex> lck(m);
+  return queue.size();
+}
+
+}
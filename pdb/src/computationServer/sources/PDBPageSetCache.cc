@@ -0,0 +1,123 @@
+#include <PDBPageSetCache.h>
+#include <PDBMetrics.h>
+
+namespace pdb {
+
+PDBPageSetCache::PDBPageSetCache(size_t maxSize) : maxSize(maxSize) {}
+
+bool PDBPageSetCache::use(const std::string &signature, PDBCachedPageSet &pageSet) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // we need to have it and nobody else can be reading it
+  auto it = pageSets.find(signature);
+  if(it == pageSets.end() || used.find(signature) != used.end()) {
+    PDBMetrics::get().pageSetCacheMisses.inc();
+    return false;
+  }
+
+  // it was just used
+  lru.splice(lru.begin(), lru, positions[signature]);
+  used.insert(signature);
+  PDBMetrics::get().pageSetCacheHits.inc();
+
+  pageSet = it->second;
+  return true;
+}
+
+void PDBPageSetCache::release(const std::string &signature) {
+
+  std::unique_lock<std::mutex> lck(m);
+  used.erase(signature);
+}
+
+std::vector<PDBPageSetIdentifier> PDBPageSetCache::add(const PDBCachedPageSet &pageSet) {
+
+  std::unique_lock<std::mutex> lck(m);
+  std::vector<PDBPageSetIdentifier> toRemove;
+
+  // if we already have it or it can never fit we don't keep it, we already have one if the cached one was in use
+  if(pageSets.find(pageSet.signature) != pageSets.end() || pageSet.size > maxSize) {
+    toRemove.emplace_back(pageSet.pageSet);
+    return toRemove;
+  }
+
+  // remove the least recently used page sets that are not used until it fits
+  auto it = lru.end();
+  while(size + pageSet.size > maxSize && it != lru.begin()) {
+
+    // skip the ones that are used
+    --it;
+    if(used.find(*it) != used.end()) {
+      continue;
+    }
+
+    // evict it, we move past it first since it is removed from the list
+    auto victim = pageSets.find(*it);
+    ++it;
+    evict(victim, toRemove);
+  }
+
+  // if the ones that are used take up the space we don't keep it
+  if(size + pageSet.size > maxSize) {
+    toRemove.emplace_back(pageSet.pageSet);
+    return toRemove;
+  }
+
+  // store it
+  lru.push_front(pageSet.signature);
+  positions[pageSet.signature] = lru.begin();
+  pageSets[pageSet.signature] = pageSet;
+  size += pageSet.size;
+  PDBMetrics::get().pageSetCacheBytes.set(size);
+
+  return toRemove;
+}
+
+std::vector<PDBPageSetIdentifier> PDBPageSetCache::invalidate(const std::string &dbName, const std::string &setName, uint64_t version) {
+
+  std::unique_lock<std::mutex> lck(m);
+  std::vector<PDBPageSetIdentifier> toRemove;
+
+  auto set = std::make_pair(dbName, setName);
+  for(auto it = pageSets.begin(); it != pageSets.end();) {
+
+    // the ones that are used are left alone, nobody can find them since their signature has the old version
+    auto jt = it++;
+    auto scanned = jt->second.sets.find(set);
+    if(scanned == jt->second.sets.end() || scanned->second == version || used.find(jt->first) != used.end()) {
+      continue;
+    }
+
+    evict(jt, toRemove);
+  }
+
+  return toRemove;
+}
+
+size_t PDBPageSetCache::getSize() {
+  std::unique_lock<std::mutex> lck(m);
+  return size;
+}
+
+size_t PDBPageSetCache::getNumPageSets() {
+  std::unique_lock<std::mutex> lck(m);
+  return pageSets.size();
+}
+
+void PDBPageSetCache::evict(std::unordered_map<std::string, PDBCachedPageSet>::iterator it, std::vector<PDBPageSetIdentifier> &toRemove) {
+
+  // the workers have to remove it
+  toRemove.emplace_back(it->second.pageSet);
+  size -= it->second.size;
+
+  // forget about it
+  lru.erase(positions[it->first]);
+  positions.erase(it->first);
+  pageSets.erase(it);
+
+  PDBMetrics::get().pageSetCacheEvictions.inc();
+  PDBMetrics::get().pageSetCacheBytes.set(size);
+}
+
+}
@@ -0,0 +1,29 @@
+#include <PDBPreparedComputations.h>
+
+uint64_t pdb::PDBPreparedComputations::prepare(const std::string &tcap) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // if it is already prepared it keeps its id
+  auto it = ids.find(tcap);
+  if(it != ids.end()) {
+    return it->second;
+  }
+
+  it = ids.emplace(tcap, nextID++).first;
+  tcaps[it->second] = &it->first;
+  return it->second;
+}
+
+bool pdb::PDBPreparedComputations::getTCAP(uint64_t preparedID, std::string &tcap) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  auto it = tcaps.find(preparedID);
+  if(it == tcaps.end()) {
+    return false;
+  }
+
+  tcap = *it->second;
+  return true;
+}
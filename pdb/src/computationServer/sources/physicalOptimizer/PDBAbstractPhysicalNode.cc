@@ -95,3 +95,70 @@ pdb::PDBPlanningResult pdb::PDBAbstractPhysicalNode::generatePipelinedAlgorithm(
   auto me = getHandle();
   return std::move(generateAlgorithm(me, sourcesWithIDs));
 }
+
+bool pdb::PDBAbstractPhysicalNode::isPartitionedOn(const std::string &column) {
+
+  // we need to scan a partitioned set
+  if(!hasScanSet() || sourceSetInfo == nullptr || !sourceSetInfo->isPartitioned()) {
+    return false;
+  }
+
+  // this is the column with the scanned records
+  const auto &records = pipeline.front()->getOutput().getAtts().front();
+
+  // go backwards through the pipeline and find the lambda that produced the column
+  auto current = column;
+  for(auto it = pipeline.rbegin(); it != pipeline.rend(); ++it) {
+
+    // the column has to be the result of an apply
+    auto &comp = *it;
+    const auto &outputs = comp->getOutput().getAtts();
+    if(comp->getAtomicComputationTypeID() != ApplyLambdaTypeID || outputs.empty() || outputs.back() != current) {
+      continue;
+    }
+
+    // the lambda has to be applied on one column
+    const auto &inputs = comp->getInput().getAtts();
+    if(inputs.size() != 1) {
+      return false;
+    }
+
+    // a deref does not change the value, keep looking for the lambda that produced its input
+    auto &keyValuePairs = *comp->getKeyValuePairs();
+    auto lambdaType = keyValuePairs.find("lambdaType");
+    auto isDeref = lambdaType != keyValuePairs.end() ? lambdaType->second == "deref" :
+                   ((ApplyLambda*) comp.get())->getLambdaToApply().find("deref") == 0;
+    if(isDeref) {
+      current = inputs.front();
+      continue;
+    }
+
+    // we don't know what the lambda does
+    if(lambdaType == keyValuePairs.end()) {
+      return false;
+    }
+
+    // the key has to be extracted from the scanned records
+    if(inputs.front() != records) {
+      return false;
+    }
+
+    // check if the lambda is the partition key
+    const auto &key = sourceSetInfo->partitionKey;
+    if(lambdaType->second == "self") {
+      return key == "self";
+    }
+    if(lambdaType->second == "attAccess") {
+      return keyValuePairs["attName"] == key;
+    }
+    if(lambdaType->second == "methodCall") {
+      return keyValuePairs["methodName"] == key;
+    }
+
+    // any other lambda produces something else
+    return false;
+  }
+
+  // the column is the scanned record itself
+  return current == records && sourceSetInfo->partitionKey == "self";
+}
@@ -67,6 +67,10 @@ pdb::PDBPlanningResult PDBAggregationPhysicalNode::generateAlgorithm(PDBAbstract
   // just store the sink page set for later use by the eventual consumers
   setSinkPageSet(sink);
 
+  // if we scan a set that is partitioned on the key of the aggregation, all the records with the same key are on this node
+  // and the hash maps don't need to be sent to the other nodes
+  bool local = primarySources.size() == 1 && isPartitionedOn(pipeline.back()->getOutput().getAtts().front());
+
   // create the algorithm
   pdb::Handle<PDBAggregationPipeAlgorithm> algorithm = pdb::makeObject<PDBAggregationPipeAlgorithm>(primarySources,
                                                                                                     pipeline.back(),
@@ -74,7 +78,8 @@ pdb::PDBPlanningResult PDBAggregationPhysicalNode::generateAlgorithm(PDBAbstract
                                                                                                     hashedToRecv,
                                                                                                     sink,
                                                                                                     additionalSources,
-                                                                                                    setsToMaterialize);
+                                                                                                    setsToMaterialize,
+                                                                                                    local);
   // add all the consumed page sets
   std::list<PDBPageSetIdentifier> consumedPageSets = { hashedToSend->pageSetIdentifier, hashedToRecv->pageSetIdentifier };
   for(auto &primarySource : primarySources) { consumedPageSets.insert(consumedPageSets.begin(), primarySource.source->pageSetIdentifier); }
@@ -27,7 +27,7 @@ pdb::PDBPlanningResult pdb::PDBJoinPhysicalNode::generateAlgorithm(PDBAbstractPh
     // make the additional source from the other side
     pdb::Handle<PDBSourcePageSetSpec> additionalSource = pdb::makeObject<PDBSourcePageSetSpec>();
     additionalSource->sourceType = PDBSourceType::BroadcastJoinSource;
-    additionalSource->pageSetIdentifier = std::make_pair(computationID, (String) otherSidePtr->pipeline.back()->getOutputName());
+    additionalSource->pageSetIdentifier = otherSidePtr->getSinkPageSet()->pageSetIdentifier;
 
     // create the additional sources
     additionalSources.push_back(additionalSource);
@@ -44,9 +44,12 @@ pdb::PDBPlanningResult pdb::PDBJoinPhysicalNode::generateAlgorithm(PDBAbstractPh
   pdb::Handle<PDBSinkPageSetSpec> sink = pdb::makeObject<PDBSinkPageSetSpec>();
   sink->pageSetIdentifier = std::make_pair(computationID, (String) pipeline.back()->getOutputName());
 
+  // if the records that join are already on the same node we don't need to move anything
+  bool local = isCoPartitionedWith(otherSidePtr);
+
   // check if we can broadcast this side (the other side is not shuffled and this side is small enough)
   auto cost = getPrimarySourcesSize(pageSetCosts);
-  if(cost < SHUFFLE_JOIN_THRASHOLD && otherSidePtr->state == PDBJoinPhysicalNodeNotProcessed) {
+  if(!local && cost < SHUFFLE_JOIN_THRASHOLD && otherSidePtr->state == PDBJoinPhysicalNodeNotProcessed) {
 
     // set the type of the sink
     sink->sinkType = PDBSinkType::BroadcastJoinSink;
@@ -108,13 +111,15 @@ pdb::PDBPlanningResult pdb::PDBJoinPhysicalNode::generateAlgorithm(PDBAbstractPh
   sinkPageSet.sinkType = JoinShuffleSink;
   sinkPageSet.pageSetIdentifier = sink->pageSetIdentifier;
 
-  // ok so we have to shuffle this side, generate the algorithm
+  // ok so we have to shuffle this side, generate the algorithm, if it is local nothing is shuffled, the records are
+  // just hashed and the hash maps never leave the node
   pdb::Handle<PDBShuffleForJoinAlgorithm> algorithm = pdb::makeObject<PDBShuffleForJoinAlgorithm>(primarySources,
                                                                                                   pipeline.back(),
                                                                                                   intermediate,
                                                                                                   sink,
                                                                                                   additionalSources,
-                                                                                                  pdb::makeObject<pdb::Vector<PDBSetObject>>());
+                                                                                                  pdb::makeObject<pdb::Vector<PDBSetObject>>(),
+                                                                                                  local);
 
   // mark the state of this node as shuffled
   state = PDBJoinPhysicalNodeShuffled;
@@ -141,6 +146,28 @@ pdb::PDBPlanningResult pdb::PDBJoinPhysicalNode::generateAlgorithm(PDBAbstractPh
 // set this value to some reasonable value // TODO this needs to be smarter
 size_t pdb::PDBJoinPhysicalNode::SHUFFLE_JOIN_THRASHOLD = 0;
 
+bool pdb::PDBJoinPhysicalNode::isCoPartitionedWith(PDBJoinPhysicalNode *other) {
+
+  // both sides have to scan sets whose partitions the catalog placed on the same nodes
+  auto &lhs = getSourceSetInfo();
+  auto &rhs = other->getSourceSetInfo();
+  if(lhs == nullptr || rhs == nullptr || !lhs->isCoPartitionedWith(*rhs) || primarySources.size() > 1) {
+    return false;
+  }
+
+  // the key of each side is the input of the hash at the end of the pipeline
+  auto getJoinKey = [](const std::vector<AtomicComputationPtr> &comps) {
+    auto &hash = comps.back();
+    if(hash->getAtomicComputationTypeID() != HashLeftTypeID && hash->getAtomicComputationTypeID() != HashRightTypeID) {
+      return std::string();
+    }
+    return hash->getInput().getAtts().front();
+  };
+
+  // both sides must be partitioned on the join key
+  return isPartitionedOn(getJoinKey(pipeline)) && other->isPartitionedOn(getJoinKey(other->pipeline));
+}
+
 size_t pdb::PDBJoinPhysicalNode::getPrimarySourcesSize(pdb::PDBPageSetCosts &pageSetCosts) {
 
   // sum up the size of the page set costs
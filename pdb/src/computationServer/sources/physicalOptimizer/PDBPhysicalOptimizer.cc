@@ -9,6 +9,9 @@
 #include <SetScanner.h>
 #include <AtomicComputationClasses.h>
 #include <PDBCatalogClient.h>
+#include <algorithm>
+#include <sstream>
+#include <set>
 
 namespace pdb {
 
@@ -22,6 +25,11 @@ pdb::Handle<pdb::PDBPhysicalAlgorithm> PDBPhysicalOptimizer::getNextAlgorithm()
     // runs the algorithm generation part
     auto result = source.second->generateAlgorithm(pageSetCosts);
 
+    // if the algorithm makes a page set we have in the cache we don't need to run it
+    if(result.resultType == PDBPlanningResultType::GENERATED_ALGORITHM) {
+      useCachedPageSet(source.second, result);
+    }
+
     // remove the source we just used, and add it to the list of processed sources
     sources.erase(sources.begin());
     processedSources.push_back(source);
@@ -56,7 +64,17 @@ pdb::Handle<pdb::PDBPhysicalAlgorithm> PDBPhysicalOptimizer::getNextAlgorithm()
       //  check if we should remove this one
       auto jt = it++;
       if(jt->second == 0) {
-        pageSetsToRemove.emplace_back(jt->first);
+
+        // the page sets that can be cached are kept
+        auto kt = pageSetsForCache.find(jt->first);
+        if(kt != pageSetsForCache.end()) {
+          pageSetsToCache.emplace_back(kt->second);
+          pageSetsForCache.erase(kt);
+        }
+        else {
+          pageSetsToRemove.emplace_back(jt->first);
+        }
+
         activePageSets.erase(jt);
       }
     }
@@ -95,5 +113,167 @@ std::vector<PDBPageSetIdentifier> PDBPhysicalOptimizer::getPageSetsToRemove() {
   return std::move(tmp);
 }
 
+void PDBPhysicalOptimizer::setPageSetCache(const PDBPageSetCachePtr &cache, PDBPageSetSignatureInfo info) {
+  pageSetCache = cache;
+  signatureInfo = std::move(info);
+}
+
+std::vector<PDBCachedPageSet> PDBPhysicalOptimizer::getPageSetsToCache() {
+
+  // set the sizes the jobs reported
+  for (auto &pageSet : pageSetsToCache) {
+    pageSet.size = pageSetCosts[pageSet.pageSet];
+  }
+
+  // empty them out
+  auto tmp = std::move(pageSetsToCache);
+  pageSetsToCache = std::vector<PDBCachedPageSet>();
+
+  return std::move(tmp);
+}
+
+bool PDBPhysicalOptimizer::useCachedPageSet(const PDBAbstractPhysicalNodePtr &source, PDBPlanningResult &result) {
+
+  // we need a cache, and the algorithm can not materialize a set since that would not happen if we skip it
+  auto &algorithm = result.runMe;
+  if(pageSetCache == nullptr || algorithm->getSetsToMaterialize()->size() != 0) {
+    return false;
+  }
+
+  // find the node that makes the page set, it is the source or a node the source was pipelined into
+  auto produced = algorithm->getPageSetToProduce();
+  PDBAbstractPhysicalNodePtr producer;
+  std::vector<PDBAbstractPhysicalNodePtr> toVisit = { source };
+  while(!toVisit.empty() && producer == nullptr) {
+
+    auto node = toVisit.back();
+    toVisit.pop_back();
+    if(node->producesPageSet(produced)) {
+      producer = node;
+    }
+    toVisit.insert(toVisit.end(), node->getConsumers().begin(), node->getConsumers().end());
+  }
+
+  // only the page sets that can be read more than once can be kept, the shuffled ones are gone once they are read
+  if(producer == nullptr) {
+    return false;
+  }
+  auto sinkType = producer->getSinkPageSet()->sinkType;
+  if(sinkType != SetSink && sinkType != AggregationSink && sinkType != BroadcastJoinSink) {
+    return false;
+  }
+
+  // the page set has to be read by the rest of this computation
+  auto it = std::find_if(result.newPageSets.begin(), result.newPageSets.end(), [&](const std::pair<PDBPageSetIdentifier, size_t> &pageSet) {
+    return pageSet.first == produced;
+  });
+  if(it == result.newPageSets.end() || it->second == 0) {
+    return false;
+  }
+
+  // figure out the signature, the same tuple set is stored differently by the different sinks
+  PDBCachedPageSet pageSet;
+  pageSet.signature = getPageSetSignature(producer->getPipeComputations().back(), pageSet.sets);
+  if(pageSet.signature.empty()) {
+    return false;
+  }
+  pageSet.signature += "sink " + std::to_string(sinkType);
+
+  // if we don't have it we keep the one we make once this computation does not need it
+  PDBCachedPageSet cached;
+  if(!pageSetCache->use(pageSet.signature, cached)) {
+    pageSet.pageSet = produced;
+    pageSetsForCache[produced] = pageSet;
+    return false;
+  }
+
+  logger->info("Using the cached page set (" + std::to_string(cached.pageSet.first) + ", " + cached.pageSet.second + ") instead of (" +
+               std::to_string(produced.first) + ", " + produced.second + ")");
+
+  // the consumers read the cached page set, it is not made by this computation so it is not removed either
+  producer->reuseSinkPageSet(cached.pageSet);
+  pageSetCosts[cached.pageSet] = cached.size;
+  usedCachedPageSets.emplace_back(cached.signature);
+
+  // there is nothing to run
+  result.resultType = PDBPlanningResultType::NOTHING;
+  result.runMe = nullptr;
+  result.newPageSets.clear();
+
+  return true;
+}
+
+std::string PDBPhysicalOptimizer::getPageSetSignature(const AtomicComputationPtr &tupleSet,
+                                                      std::map<std::pair<std::string, std::string>, uint64_t> &sets) {
+
+  // the page sets are only on the nodes they were made on
+  std::ostringstream signature;
+  signature << "nodes " << signatureInfo.nodes << "\n";
+
+  // go through the atomic computations the tuple set is computed from, every one is written after its inputs so the
+  // signature does not depend on the order the tuple sets are in the TCAP
+  std::set<std::string> visited;
+  std::vector<std::pair<AtomicComputationPtr, bool>> toVisit = { std::make_pair(tupleSet, false) };
+  while(!toVisit.empty()) {
+
+    auto current = toVisit.back();
+    toVisit.pop_back();
+    auto &comp = current.first;
+
+    // the inputs are written, write the computation
+    if(current.second) {
+
+      // the computation it belongs to has to have the same parameters
+      auto hash = signatureInfo.computationHashes.find(comp->getComputationName());
+      if(hash == signatureInfo.computationHashes.end()) {
+        return "";
+      }
+      signature << *comp << " hash " << hash->second << "\n";
+
+      // the set it scans has to be the same
+      if(comp->getAtomicComputationTypeID() == ScanSetAtomicTypeID) {
+
+        auto scanSet = std::dynamic_pointer_cast<ScanSet>(comp);
+        auto set = std::make_pair(scanSet->getDBName(), scanSet->getSetName());
+        auto version = signatureInfo.setVersions.find(set);
+        if(version == signatureInfo.setVersions.end()) {
+          return "";
+        }
+
+        sets[set] = version->second;
+        signature << "version " << version->second << " size " << inputSetSizes[set] << "\n";
+      }
+      continue;
+    }
+
+    // skip the ones we already have
+    if(!visited.insert(comp->getOutputName()).second) {
+      continue;
+    }
+    toVisit.emplace_back(comp, true);
+
+    // a scan does not have any inputs
+    if(comp->getAtomicComputationTypeID() == ScanSetAtomicTypeID) {
+      continue;
+    }
+
+    // visit the inputs
+    std::vector<std::string> inputs = { comp->getInputName() };
+    if(comp->hasTwoInputs()) {
+      inputs.emplace_back(comp->getRightInput().getSetName());
+    }
+    for(const auto &input : inputs) {
+
+      auto producer = atomicComputations->getProducingAtomicComputation(input);
+      if(producer == nullptr) {
+        return "";
+      }
+      toVisit.emplace_back(producer, false);
+    }
+  }
+
+  return signature.str();
+}
+
 }
 
@@ -57,6 +57,32 @@ std::vector<pdb::PDBAbstractPhysicalNodePtr> pdb::PDBPipeNodeBuilder::generateAn
   return this->physicalSourceNodes;
 }
 
+std::vector<pdb::PDBAbstractPhysicalNodePtr> pdb::PDBPipeNodeBuilder::generateAnalyzerGraph(const PDBCachedPipes &cachedPipes) {
+
+  // make the nodes in the same order they were made the first time, so they get the same identifiers
+  for(const auto &pipe : cachedPipes) {
+
+    // grab the atomic computations of the pipe from our list
+    currentPipe.clear();
+    for(const auto &tupleSet : pipe.pipeline) {
+      currentPipe.push_back(atomicComps->getProducingAtomicComputation(tupleSet));
+    }
+
+    switch (pipe.type) {
+      case PDB_JOIN_SIDE_PIPELINE: createPhysicalPipeline<PDBJoinPhysicalNode>(); break;
+      case PDB_AGGREGATION_PIPELINE: createPhysicalPipeline<PDBAggregationPhysicalNode>(); break;
+      default: createPhysicalPipeline<PDBStraightPhysicalNode>(); break;
+    }
+  }
+  currentPipe.clear();
+
+  // connect the pipes
+  connectThePipes();
+
+  // return the generated source nodes
+  return this->physicalSourceNodes;
+}
+
 void pdb::PDBPipeNodeBuilder::transverseTCAPGraph(AtomicComputationPtr curNode) {
 
   // did we already visit this node
@@ -216,6 +216,10 @@ class AggregateComp : public AggregateCompBase {
     return std::make_shared<pdb::AggregationCombinerSink<KeyClass, ValueClass>>(workerID);
   }
 
+  ComputeSinkPtr getAggregationOutputCombiner(size_t workerID, size_t partition, size_t numPartitions) override {
+    return std::make_shared<pdb::AggregationCombinerSink<KeyClass, ValueClass>>(workerID, partition, numPartitions);
+  }
+
 };
 
 }
@@ -14,6 +14,41 @@ class AggregateCompBase : public Computation {
 
   virtual ComputeSinkPtr getAggregationHashMapCombiner(size_t workerID) = 0;
 
+  /**
+   * Returns the combiner that merges the output an earlier run of the aggregation wrote to its set into the maps of a
+   * worker, the keys of the other workers are skipped @see AggregationCombinerSink
+   * @param workerID - the id of the worker
+   * @param partition - the partition of the keys of the worker
+   * @param numPartitions - the number of partitions
+   * @return the combiner
+   */
+  virtual ComputeSinkPtr getAggregationOutputCombiner(size_t workerID, size_t partition, size_t numPartitions) = 0;
+
+  /**
+   * Makes the aggregation incremental. The output set then always has the aggregation of the whole input, every run
+   * replaces it. If the input was only appended to since the last run, just the new pages of the input are aggregated
+   * and merged into the output that is already there.
+   * @param incremental - true if it is incremental
+   */
+  void setIncremental(bool incremental) {
+    this->incremental = incremental;
+  }
+
+  /**
+   * Is the aggregation incremental @see setIncremental
+   * @return true if it is
+   */
+  bool isIncremental() {
+    return incremental;
+  }
+
+ private:
+
+  /**
+   * True if the aggregation is incremental
+   */
+  bool incremental = false;
+
 };
 
 }
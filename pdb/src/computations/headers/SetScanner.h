@@ -20,6 +20,8 @@
 #include <sources/MapTupleSetIterator.h>
 #include "PDBAbstractPageSet.h"
 #include "VectorTupleSetIterator.h"
+#include "sources/ColumnarTupleSetIterator.h"
+#include "ScanAttributesArg.h"
 #include "SourceSetArg.h"
 #include "Computation.h"
 #include "PDBAggregationResultTest.h"
@@ -160,6 +162,9 @@ class SetScanner : public Computation {
     if(sourceSetInfo->set->containerType == PDB_CATALOG_SET_VECTOR_CONTAINER) {
       return std::make_shared<pdb::VectorTupleSetIterator>(pageSet, chunkSize, workerID);
     }
+    else if(sourceSetInfo->set->containerType == PDB_CATALOG_SET_COLUMNAR_CONTAINER) {
+      return _getColumnarSource(pageSet, workerID, params);
+    }
     else if(sourceSetInfo->set->containerType == PDB_CATALOG_SET_MAP_CONTAINER) {
       return std::make_shared<pdb::MapTupleSetIterator<typename remove_handle<Key>::type, typename remove_handle<Value>::type, OutputClass>> (pageSet, workerID, chunkSize);
     }
@@ -192,11 +197,71 @@ class SetScanner : public Computation {
     if(sourceSetInfo->set->containerType == PDB_CATALOG_SET_VECTOR_CONTAINER) {
       return std::make_shared<pdb::VectorTupleSetIterator>(pageSet, chunkSize, workerID);
     }
+    else if(sourceSetInfo->set->containerType == PDB_CATALOG_SET_COLUMNAR_CONTAINER) {
+      return _getColumnarSource(pageSet, workerID, params);
+    }
 
     // this is not good
     throw runtime_error("Unknown container  type for set ("  + (string) dbName +"," + (string) setName +")");
   }
 
+  /**
+   * Returns the source for a columnar set if the OutputClass describes its columns. If the pipeline only accesses the
+   * attributes and calls the methods of the records only the columns those need are read, if every attribute it reads
+   * has a column and it calls no methods the records are not made at all.
+   * @tparam T - alias for the output type
+   * @param pageSet - the page set we are scanning
+   * @param workerID - the id of the worker
+   * @param params - the pipeline parameters, we look for the attributes of the scan @see ScanAttributesArg
+   * @return the @see ColumnarTupleSetIterator
+   */
+  template<class T = OutputClass>
+  typename std::enable_if_t<hasColumns<T>::value, pdb::ComputeSourcePtr>
+  _getColumnarSource(const PDBAbstractPageSetPtr &pageSet, uint64_t workerID,
+                     std::map<ComputeInfoType, ComputeInfoPtr> &params) {
+
+    // grab the attributes of the scan if we have them
+    auto it = params.find(ComputeInfoType::SCAN_ATTRIBUTES);
+    auto scanAttributes = it == params.end() ? nullptr : std::dynamic_pointer_cast<ScanAttributesArg>(it->second);
+
+    // by default we make the records from every column
+    bool makeRecords = true;
+    bool allColumns = true;
+    std::set<std::string> columns;
+    if(scanAttributes != nullptr && scanAttributes->onlyMembers) {
+
+      // we don't make the records unless some attribute has no column
+      allColumns = false;
+      makeRecords = !scanAttributes->onlyAttributes;
+      for(const auto &attribute : scanAttributes->attributes) {
+        if(PDBColumns<T>::get().find(attribute) == nullptr) {
+          makeRecords = true;
+          continue;
+        }
+        columns.insert(attribute);
+      }
+
+      // add the columns the methods read, if we don't know a method we need all of them
+      for(const auto &method : scanAttributes->methods) {
+        auto usedColumns = PDBColumns<T>::get().findMethod(method);
+        if(usedColumns == nullptr) {
+          allColumns = true;
+          break;
+        }
+        columns.insert(usedColumns->begin(), usedColumns->end());
+      }
+    }
+
+    return std::make_shared<pdb::ColumnarTupleSetIterator<T>>(pageSet, workerID, makeRecords, allColumns, columns);
+  }
+
+  template<class T = OutputClass>
+  typename std::enable_if_t<!hasColumns<T>::value, pdb::ComputeSourcePtr>
+  _getColumnarSource(const PDBAbstractPageSetPtr &pageSet, uint64_t workerID,
+                     std::map<ComputeInfoType, ComputeInfoPtr> &params) {
+    throw runtime_error("The type of the columnar set ("  + (string) dbName +"," + (string) setName +") does not describe its columns");
+  }
+
   /**
    * The name of the database the set we are scanning belongs to
    */
@@ -28,6 +28,16 @@ struct NodeConfig {
    */
   int32_t port = -1;
 
+  /**
+   * The port the node serves its metrics on in the prometheus text format, 0 if it does not
+   */
+  int32_t metricsPort = 0;
+
+  /**
+   * The address the node serves its metrics on, the loopback so they are not open to the network unless we ask for it
+   */
+  std::string metricsAddress = "127.0.0.1";
+
   /**
    * Whether we want to debug the buffer manager or not
    */
@@ -58,6 +68,34 @@ struct NodeConfig {
    */
   int32_t numThreads = 0;
 
+  /**
+   * How many computations the manager runs at the same time, each one gets an equal share of the threads and memory
+   */
+  int32_t maxConcurrentJobs = 1;
+
+  /**
+   * The computations whose input sets take at most this many bytes run on a single node without any shuffles,
+   * 0 if they always run on all the nodes
+   */
+  uint64_t smallQueryThreshold = 64 * 1024 * 1024;
+
+  /**
+   * How many bytes of intermediate page sets the manager keeps on the workers for the later computations that compute
+   * the same page sets, 0 if they are always removed once the computation is done
+   */
+  uint64_t pageSetCacheSize = 1024 * 1024 * 1024;
+
+  /**
+   * How many pages of a set a pipeline keeps pinned ahead of the page it is processing
+   */
+  uint64_t pageLookahead = 0;
+
+  /**
+   * Do the scans of a set read the pages that are on disk straight from the file of the set mapped read-only,
+   * instead of copying them into the buffer pool. Only safe if the sets are not modified while they are scanned
+   */
+  bool mapSetPages = false;
+
   /**
    * The maximum number of connections the server has
    */
@@ -68,6 +106,27 @@ struct NodeConfig {
    */
   uint32_t maxRetries = 0;
 
+  /**
+   * How the manager picks the worker for a page of a set that is not partitioned { random, leastLoaded, twoChoices },
+   * the load aware policies have to be turned on
+   */
+  std::string dispatchPolicy = "random";
+
+  /**
+   * The codec the clients compress the pages they send to the cluster with, the manager hands it out with the lease @see PDBCodec
+   */
+  std::string ingestCodec = "snappy";
+
+  /**
+   * The codec we compress the pages of a set with when we serve them to the clients, unless they are stored compressed
+   */
+  std::string pageCodec = "snappy";
+
+  /**
+   * The codec we compress the pages of a shuffle with when we send them to the other workers
+   */
+  std::string shuffleCodec = "none";
+
   /**
    * The root directory of the node
    */
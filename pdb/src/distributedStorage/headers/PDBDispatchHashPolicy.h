@@ -0,0 +1,23 @@
+#pragma once
+
+#include <PDBDispatchPartitionPolicy.h>
+
+namespace pdb {
+
+/**
+ * Places the records by the hash of their key modulo the number of partitions
+ */
+class PDBDispatchHashPolicy : public PDBDispatchPartitionPolicy {
+public:
+
+  explicit PDBDispatchHashPolicy(int32_t numPartitions) : PDBDispatchPartitionPolicy(numPartitions) {}
+
+  /**
+   * Returns the partition of the key
+   * @param key - the key
+   * @return the partition, a number in [0, numPartitions)
+   */
+  int32_t getPartition(int64_t key) const override;
+};
+
+}
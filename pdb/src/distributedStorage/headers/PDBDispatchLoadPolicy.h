@@ -0,0 +1,134 @@
+#pragma once
+
+#include <PDBDispatchPolicy.h>
+#include <map>
+#include <random>
+#include <mutex>
+#include <chrono>
+
+namespace pdb {
+
+/**
+ * Sends each page to the active node that has the least bytes of the set. The load of a node is what the workers
+ * reported to the catalog @see updateLoad plus the pages we dispatched to it since then, that the workers did not
+ * report yet. That way the pages of a batch and of concurrent ingests are spread even though the reports lag behind.
+ *
+ * If we use the two choices the node is the less loaded one of two random nodes, instead of the least loaded one of
+ * all of them. It keeps the set almost as balanced and does not send every page to the same node when the loads we know
+ * about are stale.
+ */
+class PDBDispatchLoadPolicy : public PDBDispatchPolicy {
+public:
+
+  /**
+   * Initializes the policy
+   * @param twoChoices - true if we pick the less loaded one of two random nodes, false if we pick the least loaded one
+   */
+  explicit PDBDispatchLoadPolicy(bool twoChoices) : twoChoices(twoChoices),
+                                                    generator((unsigned long) std::chrono::system_clock::now().time_since_epoch().count()) {}
+
+  /**
+   * Returns the next node we are about to send a page of unknown size to
+   * @param database - the name of the database the stuff needs to be sent to
+   * @param set - the name of the set the stuff needs to be sent to
+   * @param nodes - the active nodes we can send stuff to
+   * @return - the node we decided to send it to
+   */
+  PDBCatalogNodePtr getNextNode(const std::string &database, const std::string &set, const std::vector<PDBCatalogNodePtr> &nodes) override;
+
+  /**
+   * Returns the least loaded node and adds the page to its load
+   * @param database - the name of the database the stuff needs to be sent to
+   * @param set - the name of the set the stuff needs to be sent to
+   * @param numBytes - the uncompressed size of the page
+   * @param nodes - the active nodes we can send stuff to
+   * @return - the node we decided to send it to
+   */
+  PDBCatalogNodePtr getNextNode(const std::string &database, const std::string &set, uint64_t numBytes, const std::vector<PDBCatalogNodePtr> &nodes) override;
+
+  /**
+   * Updates what the workers reported, the pages they reported are not pending anymore
+   * @param database - the name of the database the set belongs to
+   * @param set - the name of the set
+   * @param setOnNodes - the size of the set on each node
+   */
+  void updateLoad(const std::string &database, const std::string &set, const std::vector<PDBCatalogSetOnNodePtr> &setOnNodes) override;
+
+  /**
+   * We want a new report if we never got one for the set or the last one is older than loadRefreshInterval, in between
+   * the pages we dispatched are counted as pending
+   * @param database - the name of the database the set belongs to
+   * @param set - the name of the set
+   * @return true if we want a new report
+   */
+  bool needsLoad(const std::string &database, const std::string &set) override;
+
+  /**
+   * Forgets the load of the set
+   * @param database - the name of the database the set belongs to
+   * @param set - the name of the set
+   */
+  void removeSet(const std::string &database, const std::string &set) override;
+
+  /**
+   * Returns the number of bytes of the set we think the node has
+   * @param database - the name of the database the set belongs to
+   * @param set - the name of the set
+   * @param nodeID - the id of the node
+   * @return the number of bytes
+   */
+  uint64_t getLoad(const std::string &database, const std::string &set, const std::string &nodeID);
+
+  /**
+   * How long the report of the loads of a set is used before we ask the catalog again
+   */
+  static constexpr std::chrono::milliseconds loadRefreshInterval{1000};
+
+private:
+
+  /**
+   * The load of a set on a node
+   */
+  struct NodeLoad {
+
+    // the bytes and pages the worker reported to the catalog
+    uint64_t reportedBytes = 0;
+    uint64_t reportedPages = 0;
+
+    // the bytes and pages we dispatched to the worker that it did not report yet
+    uint64_t pendingBytes = 0;
+    uint64_t pendingPages = 0;
+
+    // the number of bytes and pages we think the node has
+    uint64_t bytes() const { return reportedBytes + pendingBytes; }
+    uint64_t pages() const { return reportedPages + pendingPages; }
+  };
+
+  /**
+   * Checks if the first node has less of the set than the second one, if they have the same bytes we go by the pages
+   */
+  static bool isLessLoaded(const NodeLoad &lhs, const NodeLoad &rhs);
+
+  /**
+   * True if we pick the less loaded one of two random nodes
+   */
+  bool twoChoices;
+
+  /**
+   * For each set the load of each node, the nodes that don't have anything are not in here
+   */
+  std::map<std::pair<std::string, std::string>, std::map<std::string, NodeLoad>> loads;
+
+  /**
+   * For each set when we got the last report of the loads
+   */
+  std::map<std::pair<std::string, std::string>, std::chrono::steady_clock::time_point> lastReports;
+
+  // make the random number generator
+  std::default_random_engine generator;
+
+  // the mutex to sync this
+  std::mutex m;
+};
+
+}
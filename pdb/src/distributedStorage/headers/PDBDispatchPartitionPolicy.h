@@ -0,0 +1,108 @@
+#pragma once
+
+#include <PDBDispatchPolicy.h>
+#include <PDBCatalogSet.h>
+
+namespace pdb {
+
+class PDBDispatchPartitionPolicy;
+using PDBDispatchPartitionPolicyPtr = std::shared_ptr<PDBDispatchPartitionPolicy>;
+
+/**
+ * The base class of the policies that place the records of a set by their key. The key is mapped to one of the
+ * partitions of the set and the partition i goes to the i-th of the nodes the catalog stores with the set, which are
+ * the workers ordered by their node id when the set first got data. Since the placement only depends on the key, the
+ * number of partitions and those nodes, two sets that are partitioned the same way and have the same nodes have the
+ * records with the same key on the same worker.
+ */
+class PDBDispatchPartitionPolicy : public PDBDispatchPolicy {
+public:
+
+  /**
+   * Initializes the policy
+   * @param numPartitions - the number of partitions
+   */
+  explicit PDBDispatchPartitionPolicy(int32_t numPartitions) : numPartitions(numPartitions) {}
+
+  /**
+   * Returns the partition of the key
+   * @param key - the key
+   * @return the partition, a number in [0, numPartitions)
+   */
+  virtual int32_t getPartition(int64_t key) const = 0;
+
+  /**
+   * Returns the index of the worker the key goes to, the workers have to be ordered by their node id
+   * @param key - the key
+   * @param numNodes - the number of workers
+   * @return the index of the worker
+   */
+  size_t getNodeIndex(int64_t key, size_t numNodes) const;
+
+  /**
+   * Records of a partitioned set can only be placed if we know their key
+   */
+  PDBCatalogNodePtr getNextNode(const std::string &database, const std::string &set, const std::vector<PDBCatalogNodePtr> &nodes) override;
+
+  /**
+   * Returns the node the records with the provided key are sent to
+   * @param database - the name of the database the stuff needs to be sent to
+   * @param set - the name of the set the stuff needs to be sent to
+   * @param key - the key of the records
+   * @param nodes - the active nodes we can send stuff to, in any order
+   * @return - the node we decided to send it to
+   */
+  PDBCatalogNodePtr getNodeForKey(const std::string &database, const std::string &set, int64_t key, const std::vector<PDBCatalogNodePtr> &nodes) override;
+
+  /**
+   * Orders the nodes by their node id, this is the order the partitions are assigned to the nodes
+   * @param nodes - the nodes
+   * @return the ordered nodes
+   */
+  static std::vector<PDBCatalogNodePtr> orderNodes(const std::vector<PDBCatalogNodePtr> &nodes);
+
+  /**
+   * Joins the ids of the nodes with commas, this is how the partition nodes of a set are stored in the catalog
+   * @param nodes - the nodes in the order of the partitions
+   * @return the ids separated by a comma
+   */
+  static std::string formatNodes(const std::vector<PDBCatalogNodePtr> &nodes);
+
+  /**
+   * Finds the nodes the partitions of a set are placed on among the active nodes
+   * @param partitionNodes - the ids of the nodes separated by a comma, as stored in the catalog
+   * @param nodes - the active nodes, in any order
+   * @param placed - the nodes in the order of the partitions
+   * @param error - the error if we fail
+   * @return true if every node is active, false otherwise
+   */
+  static bool placeNodes(const std::string &partitionNodes,
+                         const std::vector<PDBCatalogNodePtr> &nodes,
+                         std::vector<PDBCatalogNodePtr> &placed,
+                         std::string &error);
+
+  /**
+   * Creates the policy for a partitioned set
+   * @param type - the partitioning scheme of the set
+   * @param numPartitions - the number of partitions
+   * @param boundaries - the upper boundaries of the ranges separated by a comma, only used by the range partitioning
+   * @return the policy, null if the set is not partitioned
+   */
+  static PDBDispatchPartitionPolicyPtr create(PDBCatalogSetPartitionType type, int32_t numPartitions, const std::string &boundaries);
+
+  /**
+   * Creates the policy for a set in the catalog
+   * @param set - the set
+   * @return the policy, null if the set is not partitioned
+   */
+  static PDBDispatchPartitionPolicyPtr create(const PDBCatalogSet &set);
+
+ protected:
+
+  /**
+   * The number of partitions
+   */
+  int32_t numPartitions;
+};
+
+}
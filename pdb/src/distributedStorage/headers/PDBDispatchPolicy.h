@@ -6,6 +6,7 @@
 #define PDB_DISPATCHERPOLICY_H
 
 #include <PDBCatalogNode.h>
+#include <PDBCatalogSetOnNode.h>
 
 namespace pdb {
 
@@ -25,6 +26,58 @@ public:
    */
   virtual PDBCatalogNodePtr getNextNode(const std::string &database, const std::string &set, const std::vector<PDBCatalogNodePtr> &nodes) = 0;
 
+  /**
+   * Returns the node the records with the provided key are sent to. Policies that do not care about keys just
+   * return the next node.
+   * @param database - the name of the database the stuff needs to be sent to
+   * @param set - the name of the set the stuff needs to be sent to
+   * @param key - the key of the records
+   * @param nodes - the active nodes we can send stuff to
+   * @return - the node we decided to send it to
+   */
+  virtual PDBCatalogNodePtr getNodeForKey(const std::string &database, const std::string &set, int64_t key, const std::vector<PDBCatalogNodePtr> &nodes) {
+    return getNextNode(database, set, nodes);
+  }
+
+  /**
+   * Returns the next node we are about to send a page of the provided size to. Policies that do not care about the
+   * size just return the next node.
+   * @param database - the name of the database the stuff needs to be sent to
+   * @param set - the name of the set the stuff needs to be sent to
+   * @param numBytes - the uncompressed size of the page
+   * @param nodes - the active nodes we can send stuff to
+   * @return - the node we decided to send it to
+   */
+  virtual PDBCatalogNodePtr getNextNode(const std::string &database, const std::string &set, uint64_t numBytes, const std::vector<PDBCatalogNodePtr> &nodes) {
+    return getNextNode(database, set, nodes);
+  }
+
+  /**
+   * Lets the policy know how much of the set each node stored so far, as reported to the catalog by the workers
+   * @param database - the name of the database the set belongs to
+   * @param set - the name of the set
+   * @param setOnNodes - the size of the set on each node
+   */
+  virtual void updateLoad(const std::string &database, const std::string &set, const std::vector<PDBCatalogSetOnNodePtr> &setOnNodes) {}
+
+  /**
+   * Checks if the policy wants a new report of how much of the set each node has @see updateLoad. Asking the catalog
+   * for every page would be a round trip per page, so the policies only ask for it once in a while.
+   * @param database - the name of the database the set belongs to
+   * @param set - the name of the set
+   * @return true if the caller should get the report and pass it to updateLoad, false otherwise
+   */
+  virtual bool needsLoad(const std::string &database, const std::string &set) { return false; }
+
+  /**
+   * Lets the policy know that the set was cleared or removed
+   * @param database - the name of the database the set belongs to
+   * @param set - the name of the set
+   */
+  virtual void removeSet(const std::string &database, const std::string &set) {}
+
+  virtual ~PDBDispatchPolicy() = default;
+
 };
 
 }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <PDBDispatchPartitionPolicy.h>
+#include <vector>
+
+namespace pdb {
+
+/**
+ * Places the records by the range their key falls into. The boundary i is the largest key of the partition i, the
+ * keys that are larger than the last boundary go to the last partition.
+ */
+class PDBDispatchRangePolicy : public PDBDispatchPartitionPolicy {
+public:
+
+  /**
+   * Initializes the policy
+   * @param boundaries - the upper boundaries of the ranges, they must be sorted
+   */
+  explicit PDBDispatchRangePolicy(std::vector<int64_t> boundaries);
+
+  /**
+   * Returns the partition of the key
+   * @param key - the key
+   * @return the partition, a number in [0, numPartitions)
+   */
+  int32_t getPartition(int64_t key) const override;
+
+  /**
+   * Parses the boundaries the way they are stored in the catalog
+   * @param boundaries - the boundaries separated by a comma
+   * @return the parsed boundaries
+   */
+  static std::vector<int64_t> parseBoundaries(const std::string &boundaries);
+
+  /**
+   * Formats the boundaries the way they are stored in the catalog
+   * @param boundaries - the boundaries
+   * @return the boundaries separated by a comma
+   */
+  static std::string formatBoundaries(const std::vector<int64_t> &boundaries);
+
+private:
+
+  /**
+   * The upper boundaries of the ranges
+   */
+  std::vector<int64_t> boundaries;
+};
+
+}
@@ -27,15 +27,21 @@
 #include "DisAddData.h"
 #include "DisClearSet.h"
 #include "DisRemoveSet.h"
+#include "DisGetSetPlacement.h"
+#include "DisGetIngestLease.h"
+#include "DisReleaseIngestLease.h"
 #include "PDBDistributedStorageSetLock.h"
 #include "PDBDispatchPolicy.h"
 #include <StoDispatchData.h>
+#include <gtest/gtest_prod.h>
 
 #include <string>
 #include <queue>
 #include <condition_variable>
 #include <unordered_map>
 #include <vector>
+#include <chrono>
+#include <random>
 #include <PDBPageHandle.h>
 
 namespace pdb {
@@ -98,6 +104,26 @@ public:
                                               PDBDistributedStorageSetState stateRequested,
                                               std::unique_lock<std::mutex> &lck);
 
+  /**
+   * Returns the version of the set. It changes every time somebody starts or finishes writing to the set or clearing it,
+   * so anything that was computed from the set when it had a different version is stale.
+   *
+   * @param dbName - the name of the database the set belongs to
+   * @param setName - the name of the set
+   * @return - the version
+   */
+  uint64_t getSetVersion(const std::string &dbName, const std::string &setName);
+
+  /**
+   * Returns how many times the set was cleared or removed. Unlike the version it does not change when data is added
+   * to the set, so anything that was computed from the pages the set had is still valid if it did not change.
+   *
+   * @param dbName - the name of the database the set belongs to
+   * @param setName - the name of the set
+   * @return - the number of times it was cleared
+   */
+  uint64_t getSetNumClears(const std::string &dbName, const std::string &setName);
+
 private:
 
   /**
@@ -139,6 +165,24 @@ private:
   std::pair<bool, std::string> handleGetNextPage(const pdb::Handle<pdb::StoGetNextPageRequest> &request,
                                                  std::shared_ptr<Communicator> &sendUsingMe);
 
+  /**
+   * This handler is used by the iterators to find out where the pages of a set are, so that they can grab them
+   * directly from the workers. It asks every active worker for the pages of the set it has and sends back the
+   * address and port of each worker together with the pages.
+   *
+   * @tparam Communicator - the communicator class PDBCommunicator is used to handle the request. This is basically here
+   * so we could write unit tests
+   *
+   * @tparam Requests - is the request factory for this
+   *
+   * @param request - the request for the placement
+   * @param sendUsingMe - the communicator to the node that made the request
+   * @return - the result of the handler (success, error)
+   */
+  template<class Communicator, class Requests>
+  std::pair<bool, std::string> handleGetSetPlacement(const pdb::Handle<pdb::DisGetSetPlacement> &request,
+                                                     std::shared_ptr<Communicator> &sendUsingMe);
+
   /**
    * This handler adds data to the distributed storage. Basically it checks whether the size of the sent data can fit
    * on a single page. If it can it finds a node the data should be stored on and forwards the data to it.
@@ -156,6 +200,47 @@ private:
   std::pair<bool, std::string> handleAddData(const pdb::Handle<pdb::DisAddData> &request,
                                              std::shared_ptr<Communicator> &sendUsingMe);
 
+  /**
+   * This handler gives out an ingest lease, it lets a client send the pages of a set directly to the workers so that
+   * the data does not have to go through the manager. It checks the set the same way @see handleAddData does and then
+   * asks the dispatch policy for a node for each page the client wants to send, given the size of the page. The result
+   * contains the chosen nodes, how many pages each one of them takes and the node of each page. The workers update the size of the set in the catalog once they store
+   * the pages.
+   *
+   * Each lease gets an id that is registered with the workers of the lease, they only accept the pages that come with
+   * a lease they know about. The set stays locked for writing until the client returns the lease
+   * @see handleReleaseIngestLease or until it expires after ingestLeaseTimeout seconds.
+   *
+   * @tparam Communicator - the communicator class PDBCommunicator is used to handle the request. This is basically here
+   * so we could write unit tests
+   *
+   * @tparam Requests - is the request factory for this
+   *
+   * @param request - the request for the lease
+   * @param sendUsingMe - the communicator to the client
+   * @return - the result of the handler (success, error)
+   */
+  template<class Communicator, class Requests>
+  std::pair<bool, std::string> handleGetIngestLease(const pdb::Handle<pdb::DisGetIngestLease> &request,
+                                                    std::shared_ptr<Communicator> &sendUsingMe);
+
+  /**
+   * This handler is called once a client is done sending the pages of an ingest lease. It unlocks the set and lets
+   * the workers of the lease know that they should not accept any more pages with it.
+   *
+   * @tparam Communicator - the communicator class PDBCommunicator is used to handle the request. This is basically here
+   * so we could write unit tests
+   *
+   * @tparam Requests - is the request factory for this
+   *
+   * @param request - the request with the id of the lease
+   * @param sendUsingMe - the communicator to the client
+   * @return - the result of the handler (success, error)
+   */
+  template<class Communicator, class Requests>
+  std::pair<bool, std::string> handleReleaseIngestLease(const pdb::Handle<pdb::DisReleaseIngestLease> &request,
+                                                        std::shared_ptr<Communicator> &sendUsingMe);
+
   /**
    * This handler clears a particular set, just the data.
    * It will succeed if the set is not in use.
@@ -209,8 +294,63 @@ private:
      */
     int32_t numWriters;
 
+    /**
+     * Incremented every time a write or clear of the set starts or finishes @see getSetVersion
+     */
+    uint64_t version;
+
+    /**
+     * Incremented every time a clear of the set starts @see getSetNumClears
+     */
+    uint64_t numClears;
+
+  };
+
+  /**
+   * An ingest lease we gave out @see handleGetIngestLease
+   */
+  struct PDBIngestLease {
+
+    /**
+     * The set the lease is for
+     */
+    std::string dbName;
+    std::string setName;
+
+    /**
+     * Keeps the set locked for writing while the lease is out
+     */
+    PDBDistributedStorageSetLockPtr setLock;
+
+    /**
+     * The addresses and ports of the workers the lease was registered with
+     */
+    std::vector<std::pair<std::string, int32_t>> nodes;
+
+    /**
+     * When the lease expires
+     */
+    std::chrono::steady_clock::time_point expires;
   };
 
+  /**
+   * Drops the leases that have expired, which unlocks their sets. Leases are only checked when we give out or take
+   * back a lease or when somebody wants to clear or remove a set, since that is when a stale lock matters.
+   */
+  void expireIngestLeases();
+
+  /**
+   * Tells the workers of a lease that they should not accept any more pages with it, failures are only logged since
+   * the workers drop the lease once it expires anyway
+   *
+   * @tparam Requests - is the request factory for this
+   *
+   * @param leaseID - the id of the lease
+   * @param lease - the lease
+   */
+  template<class Requests>
+  void revokeIngestLease(uint64_t leaseID, const PDBIngestLease &lease);
+
   /**
    * Same as the other @tryUsingSet just without lock parameter
    * @param dbName - the name of the database the set belongs to
@@ -242,8 +382,8 @@ private:
   void respondAddDataWithError(shared_ptr<Communicator> &sendUsingMe, std::string &errMsg);
 
   /**
-   * The policy we want to use for dispatching.
-   * Maybe make this be per set..
+   * The policy we want to use for dispatching the sets that are not partitioned, it is picked by the dispatchPolicy
+   * option of the configuration.
    */
   PDBDispatcherPolicyPtr policy;
 
@@ -267,8 +407,32 @@ private:
    */
   std::condition_variable cv;
 
+  /**
+   * The ingest leases that are out, by their id
+   */
+  std::map<uint64_t, PDBIngestLease> ingestLeases;
+
+  /**
+   * Makes the ids of the ingest leases, they are random so a client can not guess the lease of another one
+   */
+  std::mt19937_64 leaseIDGenerator{std::random_device{}()};
+
+  /**
+   * Locks the @see ingestLeases and the @see leaseIDGenerator
+   */
+  std::mutex ingestLeasesLck;
+
+  /**
+   * The number of seconds after which an ingest lease expires if the client does not return it
+   */
+  static const uint64_t ingestLeaseTimeout = 3600;
+
   // add the distributed storage lock as a friend
   friend class PDBDistributedStorageSetLock;
+
+  // mark the tests for the ingest leases
+  FRIEND_TEST(IngestLeaseTest, ExpiredLeaseUnlocksTheSet);
+  FRIEND_TEST(IngestLeaseTest, ReleaseTwice);
 };
 
 }
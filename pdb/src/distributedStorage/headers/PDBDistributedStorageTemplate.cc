@@ -12,7 +12,17 @@
 #include <StoClearSetRequest.h>
 #include <DisClearSet.h>
 #include <DisRemoveSet.h>
+#include <DisGetSetPlacement.h>
+#include <DisGetSetPlacementResult.h>
+#include <DisGetIngestLease.h>
+#include <DisGetIngestLeaseResult.h>
+#include <DisReleaseIngestLease.h>
+#include <StoIngestLease.h>
+#include <StoGetSetPagesRequest.h>
+#include <StoGetSetPagesResult.h>
 #include <GenericWork.h>
+#include <PDBDispatchPartitionPolicy.h>
+#include <limits>
 
 template<class Communicator, class Requests>
 std::pair<pdb::PDBPageHandle, size_t> pdb::PDBDistributedStorage::requestPage(const PDBCatalogNodePtr &node,
@@ -215,6 +225,104 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleGetNextPage(const
   return make_pair(success, error);
 }
 
+template<class Communicator, class Requests>
+std::pair<bool, std::string> pdb::PDBDistributedStorage::handleGetSetPlacement(const pdb::Handle<pdb::DisGetSetPlacement> &request,
+                                                                               std::shared_ptr<Communicator> &sendUsingMe) {
+
+  /// 1. Check if we are the manager
+
+  if (!this->getConfiguration()->isManager) {
+
+    string error = "Only a manager can give the placement of a set!";
+
+    // make an allocation block
+    const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+
+    // create an allocation block to hold the response
+    pdb::Handle<pdb::DisGetSetPlacementResult> response = pdb::makeObject<pdb::DisGetSetPlacementResult>(false);
+
+    // sends result to requester
+    sendUsingMe->sendObject(response, error);
+
+    // this is an issue we simply return false only a manager can serve the placement
+    return make_pair(false, error);
+  }
+
+  /// 2. Wait till we get a lock for reading
+
+  auto setLock = useSet(request->databaseName, request->setName, PDBDistributedStorageSetState::READING_DATA);
+
+  /// 3. Ask each active node for the pages it has
+
+  // sort the nodes the same way handleGetNextPage does
+  auto nodes = this->getFunctionality<PDBCatalogClient>().getWorkerNodes();
+  sort(nodes.begin(), nodes.end(), [](const pdb::PDBCatalogNodePtr &a, const pdb::PDBCatalogNodePtr &b) { return a->nodeID > b->nodeID; });
+
+  std::vector<std::pair<PDBCatalogNodePtr, std::vector<uint64_t>>> placement;
+  size_t numPages = 0;
+  for (auto &node : nodes) {
+
+    // skip this node
+    if (!node->active) {
+      continue;
+    }
+
+    // grab the pages of the set on this node
+    auto pageInfo = Requests::template heapRequest<StoGetSetPagesRequest, StoGetSetPagesResult, std::pair<bool, std::vector<uint64_t>>>(
+        logger, node->port, node->address, std::make_pair(false, std::vector<uint64_t>()), 1024,
+        [&](Handle<StoGetSetPagesResult> result) {
+
+          // did we fail
+          if (result == nullptr || !result->success) {
+            return std::make_pair(false, std::vector<uint64_t>());
+          }
+
+          // copy the pages
+          std::vector<uint64_t> pages;
+          pages.reserve(result->pages.size());
+          for (int i = 0; i < result->pages.size(); ++i) { pages.emplace_back(result->pages[i]); }
+
+          return std::make_pair(true, std::move(pages));
+        }, (std::string) request->databaseName, (std::string) request->setName);
+
+    // if the node does not have the set it just does not have any pages of it
+    if (!pageInfo.first || pageInfo.second.empty()) {
+      continue;
+    }
+
+    numPages += pageInfo.second.size();
+    placement.emplace_back(node, std::move(pageInfo.second));
+  }
+
+  /// 4. Send the placement back
+
+  // make an allocation block large enough to hold the placement, the vectors are reserved up front so each of them
+  // is allocated exactly once, the 1024 bytes per node are for the address and the port
+  const pdb::UseTemporaryAllocationBlock tempBlock{numPages * (sizeof(uint64_t) + sizeof(uint32_t)) + placement.size() * 1024 + 1024};
+
+  // create the response
+  pdb::Handle<pdb::DisGetSetPlacementResult> response = pdb::makeObject<pdb::DisGetSetPlacementResult>(true);
+  response->reserve(placement.size(), numPages);
+  for (uint32_t i = 0; i < placement.size(); ++i) {
+
+    // add the node
+    response->nodeAddresses.push_back(placement[i].first->address);
+    response->nodePorts.push_back(placement[i].first->port);
+
+    // add the pages
+    for (auto page : placement[i].second) {
+      response->addPage(i, page);
+    }
+  }
+
+  // sends result to requester
+  string error;
+  bool success = sendUsingMe->sendObject(response, error);
+
+  // return
+  return make_pair(success, error);
+}
+
 template<class Communicator>
 void pdb::PDBDistributedStorage::respondAddDataWithError(shared_ptr<Communicator> &sendUsingMe, std::string &errMsg) {
 
@@ -256,6 +364,19 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleAddData(const pdb
     return make_pair(false, errMsg);
   }
 
+  // the records of a partitioned set are placed by their key, we can not do that for a whole page
+  if (set->isPartitioned()) {
+
+    // make the error string
+    std::string errMsg = "The set (" + (string)request->databaseName +  "," + (string)request->setName + ") is partitioned, the data has to be sent with an ingest lease!";
+
+    // respond with error
+    respondAddDataWithError(sendUsingMe, errMsg);
+
+    // return the problem
+    return make_pair(false, errMsg);
+  }
+
   // lock the set
   auto setLock = tryUsingSet(request->databaseName, request->setName, PDBDistributedStorageSetState::WRITING_DATA);
   if(!setLock->isWriteGranted()) {
@@ -340,15 +461,11 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleAddData(const pdb
   // receive bytes
   sendUsingMe->receiveBytes(page->getBytes(), error);
 
-  // check the uncompressed size
-  size_t uncompressedSize = 0;
-  snappy::GetUncompressedLength((char *) page->getBytes(), numBytes, &uncompressedSize);
-
-  // check the uncompressed size
-  if (bufferManager->getMaxPageSize() < uncompressedSize) {
+  // check the frame
+  if (!PDBCodec::isFrame((char *) page->getBytes(), numBytes)) {
 
     // make the error string
-    std::string errMsg = "The uncompressed size is larger than the maximum page size";
+    std::string errMsg = "The page we got is corrupted";
 
     // log the error
     logger->error(errMsg);
@@ -362,25 +479,26 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleAddData(const pdb
     return make_pair(false, errMsg);
   }
 
-  /// 2. Update the set size
-  {
-    std::string errMsg;
-    if (!getFunctionalityPtr<PDBCatalogClient>()->incrementSetSize(request->databaseName,
-                                                                   request->setName,
-                                                                   uncompressedSize,
-                                                                   errMsg)) {
+  // check the uncompressed size
+  size_t uncompressedSize = PDBCodec::getFrameUncompressedSize((char *) page->getBytes());
+  if (bufferManager->getMaxPageSize() < uncompressedSize) {
 
-      // create an allocation block to hold the response
-      const UseTemporaryAllocationBlock tempBlock{1024};
-      Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(false, errMsg);
+    // make the error string
+    std::string errMsg = "The uncompressed size is larger than the maximum page size";
 
-      // sends result to requester
-      sendUsingMe->sendObject(response, errMsg);
-      return make_pair(false, errMsg);
-    }
+    // log the error
+    logger->error(errMsg);
+
+    // create an allocation block to hold the response
+    const UseTemporaryAllocationBlock tempBlock{1024};
+    Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(false, errMsg);
+
+    // sends result to requester
+    sendUsingMe->sendObject(response, errMsg);
+    return make_pair(false, errMsg);
   }
 
-  /// 3. Figure out on what node to forward the thing
+  /// 2. Figure out on what node to forward the thing
 
   // grab all active nodes
   const auto nodes = getFunctionality<PDBCatalogClient>().getActiveWorkerNodes();
@@ -403,8 +521,34 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleAddData(const pdb
     return make_pair(false, errMsg);
   }
 
-  // get the next node
-  auto node = policy->getNextNode(request->databaseName, request->setName, nodes);
+  // let the policy know how much of the set each node has if its report is stale and get the next node, the pages
+  // dispatched in between are counted by the policy
+  if (policy->needsLoad(request->databaseName, request->setName)) {
+    policy->updateLoad(request->databaseName, request->setName, getFunctionalityPtr<PDBCatalogClient>()->getSetOnNodes(request->databaseName, request->setName, error));
+  }
+  auto node = policy->getNextNode(request->databaseName, request->setName, uncompressedSize, nodes);
+
+  /// 3. Update the set size
+  {
+    std::string errMsg;
+    if (!getFunctionalityPtr<PDBCatalogClient>()->incrementSetSize(request->databaseName,
+                                                                   request->setName,
+                                                                   node->nodeID,
+                                                                   uncompressedSize,
+                                                                   1,
+                                                                   errMsg)) {
+
+      // create an allocation block to hold the response
+      const UseTemporaryAllocationBlock tempBlock{1024};
+      Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(false, errMsg);
+
+      // sends result to requester
+      sendUsingMe->sendObject(response, errMsg);
+      return make_pair(false, errMsg);
+    }
+  }
+
+  /// 4. Time to send the stuff
 
   // time to send the stuff
   auto ret = RequestFactory::bytesHeapRequest<StoDispatchData, SimpleRequestResult, bool>(
@@ -433,6 +577,272 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleAddData(const pdb
   return make_pair(ret, error);
 }
 
+template<class Communicator, class Requests>
+std::pair<bool, std::string> pdb::PDBDistributedStorage::handleGetIngestLease(const pdb::Handle<pdb::DisGetIngestLease> &request,
+                                                                              shared_ptr<Communicator> &sendUsingMe) {
+
+  // the error if we fail
+  std::string error;
+
+  // sends the error back to the client
+  auto respondWithError = [&](const std::string &errMsg) {
+
+    // log the error
+    logger->error(errMsg);
+
+    // create an allocation block to hold the response
+    const UseTemporaryAllocationBlock tempBlock{1024};
+    Handle<DisGetIngestLeaseResult> response = makeObject<DisGetIngestLeaseResult>(false, errMsg);
+
+    // sends result to requester
+    std::string sendError;
+    sendUsingMe->sendObject(response, sendError);
+
+    return make_pair(false, errMsg);
+  };
+
+  // drop the leases nobody returned, so their sets are unlocked
+  expireIngestLeases();
+
+  /// 1. Check if the set exists
+
+  auto set = getFunctionalityPtr<PDBCatalogClient>()->getSet(request->databaseName, request->setName, error);
+  if (set == nullptr) {
+    return respondWithError("The set (" + (string)request->databaseName +  "," + (string)request->setName + ") is does not exist!");
+  }
+
+  /// 2. Make sure nobody is clearing or removing the set while we are giving out the lease
+
+  auto setLock = tryUsingSet(request->databaseName, request->setName, PDBDistributedStorageSetState::WRITING_DATA);
+  if(!setLock->isWriteGranted()) {
+    return respondWithError("The set (" + (string)request->databaseName +  "," + (string)request->setName + ") is already in use!");
+  }
+
+  // make sure the container type of the set is set to a vector, unless it was created as a columnar set
+  if (set->containerType == PDBCatalogSetContainerType::PDB_CATALOG_SET_NO_CONTAINER) {
+
+    // update the container type
+    if (!getFunctionalityPtr<PDBCatalogClient>()->updateSetContainerType(set->database,
+                                                                         set->name,
+                                                                         PDBCatalogSetContainerType::PDB_CATALOG_SET_VECTOR_CONTAINER,
+                                                                         error)) {
+      return respondWithError("Could not update the container type of the set!");
+    }
+    set->containerType = PDBCatalogSetContainerType::PDB_CATALOG_SET_VECTOR_CONTAINER;
+  }
+  else if (set->containerType != PDBCatalogSetContainerType::PDB_CATALOG_SET_VECTOR_CONTAINER &&
+           set->containerType != PDBCatalogSetContainerType::PDB_CATALOG_SET_COLUMNAR_CONTAINER) {
+    return respondWithError("The container type of the set is not a vector. You can only add data to vector or columnar sets!");
+  }
+
+  /// 3. Figure out what node takes each page
+
+  // grab all active nodes
+  const auto nodes = getFunctionality<PDBCatalogClient>().getActiveWorkerNodes();
+  if (nodes.empty()) {
+    return respondWithError("There are no nodes where we can dispatch the data to!");
+  }
+
+  // if the set is partitioned the client places the records by their key, so it gets the nodes the partitions are
+  // placed on in the order of the partitions, the quotas don't matter in that case
+  std::vector<std::pair<PDBCatalogNodePtr, uint64_t>> quotas;
+  if (set->isPartitioned()) {
+
+    // the first time the set gets data its partitions are placed on the active nodes ordered by their id, unless
+    // another set of its co-partitioning group already has nodes, the catalog remembers the placement
+    if (set->partitionNodes.empty()) {
+
+      auto proposed = PDBDispatchPartitionPolicy::formatNodes(PDBDispatchPartitionPolicy::orderNodes(nodes));
+      if (!getFunctionalityPtr<PDBCatalogClient>()->updateSetPartitionNodes(set->database, set->name, proposed, error)) {
+        return respondWithError("Could not store the nodes the partitions of the set are placed on : " + error);
+      }
+
+      // grab the set again to see the nodes the catalog settled on
+      set = getFunctionalityPtr<PDBCatalogClient>()->getSet(request->databaseName, request->setName, error);
+      if (set == nullptr) {
+        return respondWithError("The set (" + (string)request->databaseName +  "," + (string)request->setName + ") is does not exist!");
+      }
+    }
+
+    // if a node with partitions of the set is gone we can not place the records
+    std::vector<PDBCatalogNodePtr> partitionNodes;
+    if (!PDBDispatchPartitionPolicy::placeNodes(set->partitionNodes, nodes, partitionNodes, error)) {
+      return respondWithError(error);
+    }
+
+    for (auto &node : partitionNodes) {
+      quotas.emplace_back(node, std::numeric_limits<uint64_t>::max());
+    }
+  }
+
+  // otherwise let the policy know how much of the set each node has, if its report is stale
+  if (!set->isPartitioned() && request->numPages != 0 && policy->needsLoad(request->databaseName, request->setName)) {
+    policy->updateLoad(request->databaseName, request->setName, getFunctionalityPtr<PDBCatalogClient>()->getSetOnNodes(request->databaseName, request->setName, error));
+  }
+
+  // and ask it for a node for each page, the same way we would if the pages were sent through us
+  std::vector<uint32_t> pageNodes;
+  for (uint64_t i = 0; i < request->numPages && !set->isPartitioned(); ++i) {
+
+    // get the next node
+    auto numBytes = i < request->pageSizes.size() ? request->pageSizes[i] : 0;
+    auto node = policy->getNextNode(request->databaseName, request->setName, numBytes, nodes);
+
+    // increment the quota of the node
+    auto it = std::find_if(quotas.begin(), quotas.end(), [&](const std::pair<PDBCatalogNodePtr, uint64_t> &q) { return q.first->nodeID == node->nodeID; });
+    if (it == quotas.end()) {
+      it = quotas.insert(quotas.end(), std::make_pair(node, 0));
+    }
+    it->second++;
+
+    // remember where the page goes
+    pageNodes.emplace_back(it - quotas.begin());
+  }
+
+  /// 4. Register the lease with the workers so that they accept the pages sent with it
+
+  // pick an id nobody is using
+  uint64_t leaseID;
+  {
+    std::unique_lock<std::mutex> lck{ingestLeasesLck};
+    do {
+      leaseID = leaseIDGenerator();
+    } while (leaseID == 0 || ingestLeases.find(leaseID) != ingestLeases.end());
+  }
+
+  // the lease keeps the set locked for writing until it is returned or it expires
+  PDBIngestLease lease;
+  lease.dbName = request->databaseName;
+  lease.setName = request->setName;
+  lease.setLock = setLock;
+  lease.expires = std::chrono::steady_clock::now() + std::chrono::seconds(ingestLeaseTimeout);
+
+  for (auto &quota : quotas) {
+
+    // tell the worker about the lease
+    std::string registerError;
+    bool registered = Requests::template heapRequest<StoIngestLease, SimpleRequestResult, bool>(
+        logger, quota.first->port, quota.first->address, false, 1024,
+        [&](Handle<SimpleRequestResult> result) {
+
+          // did we fail
+          if (result == nullptr || !result->getRes().first) {
+            registerError = result == nullptr ? "no response" : result->getRes().second;
+            return false;
+          }
+
+          return true;
+        }, leaseID, (std::string) request->databaseName, (std::string) request->setName, ingestLeaseTimeout, false);
+
+    // if we could not register it with a worker, take it back from the ones that have it
+    if (!registered) {
+      revokeIngestLease<Requests>(leaseID, lease);
+      return respondWithError("Could not register the ingest lease with the node " + quota.first->nodeID + " : " + registerError);
+    }
+
+    lease.nodes.emplace_back(quota.first->address, quota.first->port);
+  }
+
+  // store the lease
+  {
+    std::unique_lock<std::mutex> lck{ingestLeasesLck};
+    ingestLeases[leaseID] = std::move(lease);
+  }
+
+  /// 5. Send the lease back
+
+  // create an allocation block to hold the response
+  const UseTemporaryAllocationBlock tempBlock{quotas.size() * 1024 + pageNodes.size() * sizeof(uint32_t) * 2 + 1024};
+  Handle<DisGetIngestLeaseResult> response = makeObject<DisGetIngestLeaseResult>(true, "");
+  response->leaseID = leaseID;
+  response->timeout = ingestLeaseTimeout;
+  for (auto &quota : quotas) {
+    response->addNode(quota.first->address, quota.first->port, quota.second);
+  }
+  for (auto node : pageNodes) {
+    response->pageNodes.push_back(node);
+  }
+
+  // tell the client how the set is partitioned
+  response->partitionType = (PDBCatalogSetPartitionType) set->partitionType;
+  response->numPartitions = set->numPartitions;
+  response->partitionKey = set->partitionKey;
+  response->partitionBoundaries = set->partitionBoundaries;
+
+  // tell the client if it has to write the pages column by column
+  response->containerType = (PDBCatalogSetContainerType) set->containerType;
+
+  // if the set is stored compressed the pages come compressed with its codec, so the workers can store them as they are
+  response->codec = set->storageCodec != "none" ? set->storageCodec : getConfiguration()->ingestCodec;
+
+  // sends result to requester
+  bool success = sendUsingMe->sendObject(response, error);
+  return make_pair(success, error);
+}
+
+template<class Communicator, class Requests>
+std::pair<bool, std::string> pdb::PDBDistributedStorage::handleReleaseIngestLease(const pdb::Handle<pdb::DisReleaseIngestLease> &request,
+                                                                                  shared_ptr<Communicator> &sendUsingMe) {
+
+  // drop the leases nobody returned, so their sets are unlocked
+  expireIngestLeases();
+
+  /// 1. Take the lease out, this unlocks the set once we are done with it
+
+  PDBIngestLease lease;
+  bool found = false;
+  {
+    std::unique_lock<std::mutex> lck{ingestLeasesLck};
+
+    auto it = ingestLeases.find(request->leaseID);
+    if (it != ingestLeases.end()) {
+      lease = std::move(it->second);
+      ingestLeases.erase(it);
+      found = true;
+    }
+  }
+
+  /// 2. Tell the workers to stop accepting pages with it
+
+  std::string error;
+  if (found) {
+    revokeIngestLease<Requests>(request->leaseID, lease);
+  }
+  else {
+    error = "The ingest lease does not exist or it has expired.";
+    logger->error(error);
+  }
+
+  /// 3. Send the response
+
+  // create an allocation block to hold the response
+  const UseTemporaryAllocationBlock tempBlock{1024};
+  Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(found, error);
+
+  // sends result to requester
+  bool success = sendUsingMe->sendObject(response, error) && found;
+  return make_pair(success, error);
+}
+
+template<class Requests>
+void pdb::PDBDistributedStorage::revokeIngestLease(uint64_t leaseID, const PDBIngestLease &lease) {
+
+  for (auto &node : lease.nodes) {
+
+    // tell the worker to forget the lease
+    bool revoked = Requests::template heapRequest<StoIngestLease, SimpleRequestResult, bool>(
+        logger, node.second, node.first, false, 1024,
+        [&](Handle<SimpleRequestResult> result) {
+          return result != nullptr && result->getRes().first;
+        }, leaseID, lease.dbName, lease.setName, 0, true);
+
+    // the worker drops it once it expires anyway
+    if (!revoked) {
+      logger->warn("Could not revoke the ingest lease on the node " + node.first + ":" + std::to_string(node.second));
+    }
+  }
+}
+
 template<class Communicator, class Requests>
 std::pair<bool, std::string> pdb::PDBDistributedStorage::handleClearSet(const pdb::Handle<pdb::DisClearSet> &request,
                                                                         shared_ptr<Communicator> &sendUsingMe) {
@@ -464,6 +874,9 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleClearSet(const pd
 
   /// 1. Try to use the set, if it is already in use NACK
 
+  // an expired ingest lease should not keep the set locked
+  expireIngestLeases();
+
   auto setLock = tryUsingSet(request->databaseName, request->setName, PDBDistributedStorageSetState::CLEARING_DATA);
   if(!setLock->isClearGranted()) {
 
@@ -522,7 +935,7 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleClearSet(const pd
 
             // check if we got a ACK
             return result != nullptr && result->getRes().first;
-          }, request->databaseName, request->setName);
+          }, (std::string) request->databaseName, (std::string) request->setName);
 
       // signal that the run was successful
       callerBuzzer->buzz(success ? PDBAlarm::WorkAllDone : PDBAlarm::GenericError, counter);
@@ -537,6 +950,9 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleClearSet(const pd
     tempBuzzer->wait();
   }
 
+  // the policy does not need to balance the data we just got rid of
+  policy->removeSet(request->databaseName, request->setName);
+
   /// 3. Send back the response to the client
 
   if (!success) {
@@ -586,6 +1002,9 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleRemoveSet(const p
 
   /// 1. Try to use the set, if it is already in use NACK
 
+  // an expired ingest lease should not keep the set locked
+  expireIngestLeases();
+
   auto setLock = tryUsingSet(request->databaseName, request->setName, PDBDistributedStorageSetState::CLEARING_DATA);
   if(!setLock->isClearGranted()) {
 
@@ -665,7 +1084,7 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleRemoveSet(const p
 
             // check if we got a ACK
             return result != nullptr && result->getRes().first;
-          }, request->databaseName, request->setName);
+          }, (std::string) request->databaseName, (std::string) request->setName);
 
       // signal that the run was successful
       callerBuzzer->buzz(success ? PDBAlarm::WorkAllDone : PDBAlarm::GenericError, counter);
@@ -680,6 +1099,9 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleRemoveSet(const p
     tempBuzzer->wait();
   }
 
+  // the policy does not need to balance the data we just got rid of
+  policy->removeSet(request->databaseName, request->setName);
+
   /// 3. Send back the response to the client
 
   if (!success) {
@@ -3,6 +3,7 @@
 #include <string>
 
 #include "PDBStorageIterator.h"
+#include "PDBStoragePageFetcher.h"
 #include "PDBAggregationResultTest.h"
 
 namespace pdb {
@@ -38,7 +39,7 @@ class PDBStorageMapIterator<T, typename std::enable_if<hasGetKey<T>::value and h
   bool hasNextRecord() override {
 
     // are we starting out
-    if (buffer == nullptr && !getNextPage(true)) {
+    if (buffer == nullptr && !getNextPage()) {
       return false;
     }
 
@@ -50,7 +51,7 @@ class PDBStorageMapIterator<T, typename std::enable_if<hasGetKey<T>::value and h
       }
 
       // get the next page since we need it.
-    } while (getNextPage(false));
+    } while (getNextPage());
 
     // we are out of pages
     return false;
@@ -63,7 +64,7 @@ class PDBStorageMapIterator<T, typename std::enable_if<hasGetKey<T>::value and h
   pdb::Handle<T> getNextRecord() override {
 
     // are we starting out
-    if (buffer == nullptr && !getNextPage(true)) {
+    if (buffer == nullptr && !getNextPage()) {
       return nullptr;
     }
 
@@ -91,7 +92,7 @@ class PDBStorageMapIterator<T, typename std::enable_if<hasGetKey<T>::value and h
       }
 
       // get the next page since we need it.
-    } while (getNextPage(false));
+    } while (getNextPage());
 
     // we are out of pages
     return nullptr;
@@ -132,107 +133,21 @@ class PDBStorageMapIterator<T, typename std::enable_if<hasGetKey<T>::value and h
    * Grab the next page
    * @return true if we could grab the next page
    */
-  bool getNextPage(bool isFirst) {
+  bool getNextPage() {
 
-    // the buffer for the compressed data
-    std::unique_ptr<char[]> compressedBuffer;
-    size_t compressedBufferSize;
-
-    // the communicator
-    PDBCommunicatorPtr comm = std::make_shared<PDBCommunicator>();
-    string errMsg;
-
-    // try multiple times if we fail to connect
-    int numRetries = 0;
-    while (numRetries <= maxRetries) {
-
-      // connect to the server
-      if (!comm->connectToInternetServer(logger, port, address, errMsg)) {
-
-        // log the error
-        logger->error(errMsg);
-        logger->error("Can not connect to remote server with port=" + std::to_string(port) + " and address=" + address + ");");
-
-        // throw an exception
-        throw std::runtime_error(errMsg);
-      }
-
-      // we connected
-      break;
-    }
-
-    // make a block to send the request
-    const UseTemporaryAllocationBlock tempBlock{1024};
-
-    // make the request
-    Handle<StoGetNextPageRequest> request = makeObject<StoGetNextPageRequest>(db, set, currPage, currNode, isFirst);
-
-    // send the object
-    if (!comm->sendObject(request, errMsg)) {
-
-      // yeah something happened
-      logger->error(errMsg);
-      logger->error("Not able to send request to server.\n");
-
-      // throw an exception
-      throw std::runtime_error(errMsg);
+    // if this is the first page start fetching the pages
+    if (fetcher == nullptr) {
+      fetcher = std::make_shared<PDBStoragePageFetcher>(address, port, maxRetries, set, db);
     }
 
-    // get the response and process it
-    bool success;
-    Handle<StoGetNextPageResult> result = comm->getNextObject<StoGetNextPageResult>(success, errMsg);
-
-    // did we get a response
-    if (result == nullptr) {
-
-      // throw an exception
-      throw std::runtime_error(errMsg);
-    }
+    // grab the next page
+    auto page = fetcher->getNextPage();
 
     // do we have a next page
-    if (!result->hasNext) {
+    if (page == nullptr) {
       return false;
     }
-
-    // set the node and the page
-    currNode = result->nodeID;
-    currPage = result->page + 1;
-    compressedBufferSize = result->pageSize;
-
-    // init the compressed buffer
-    compressedBuffer = std::unique_ptr<char[]>(new char[result->pageSize]);
-
-    // check if we failed to allocate
-    if (compressedBuffer == nullptr) {
-      throw std::bad_alloc();
-    }
-
-    // read the size
-    auto readSize = RequestFactory::waitForBytes(logger, comm, compressedBuffer.get(), compressedBufferSize, errMsg);
-
-    // did we read anything
-    if (readSize == -1) {
-      throw std::runtime_error(errMsg);
-    }
-
-    // get the uncompressed size
-    size_t uncompressedSize = 0;
-    snappy::GetUncompressedLength(compressedBuffer.get(), compressedBufferSize, &uncompressedSize);
-
-    // allocate some memory if we need it
-    if (bufferSize < uncompressedSize) {
-
-      // allocate the memory
-      buffer = std::unique_ptr<char[]>(new char[uncompressedSize]);
-
-      // check if we failed to allocate
-      if (buffer == nullptr) {
-        throw std::bad_alloc();
-      }
-    }
-
-    // uncompress and copy to buffer
-    snappy::RawUncompress((char *) compressedBuffer.get(), compressedBufferSize, (char *) buffer.get());
+    buffer = std::move(page);
 
     // grab the current map
     currMap = ((Record<Map<Key, Value>> *) (buffer.get()))->getRootObject();
@@ -275,25 +190,15 @@ class PDBStorageMapIterator<T, typename std::enable_if<hasGetKey<T>::value and h
   std::string db;
 
   /**
-   * The number of the page we want to get
+   * Grabs the pages directly from the workers
    */
-  uint64_t currPage = 0;
-
-  /**
-   * The node we want to grab the page from
-   */
-  std::string currNode = "none";
+  PDBStoragePageFetcherPtr fetcher;
 
   /**
    * The buffer we are storing the records
    */
   std::unique_ptr<char[]> buffer;
 
-  /**
-   * The size of the buffer
-   */
-  size_t bufferSize = 0;
-
   /**
    * The map we are currently iterating over
    */
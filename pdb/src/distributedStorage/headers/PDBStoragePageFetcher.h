@@ -0,0 +1,216 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <PDBLogger.h>
+
+namespace pdb {
+
+class PDBStoragePageFetcher;
+using PDBStoragePageFetcherPtr = std::shared_ptr<PDBStoragePageFetcher>;
+
+/**
+ * Grabs the pages of a set for the set iterators. Instead of asking the manager for every page, the fetcher asks the
+ * manager once where the pages of the set are and then requests them directly from the workers. The pages are
+ * requested and decompressed by a couple of background threads, they are handed out in the order the manager gave
+ * them to us. At most @see prefetchWindow pages are fetched ahead of the one the iterator is on.
+ *
+ * The fetching threads do not have an allocator of their own, they share the main one with the thread that is using
+ * the iterator. Therefore they never allocate pdb::Objects, the requests are serialized upfront by @see start.
+ *
+ * Talking to the manager and the workers is done by @see getPlacement and @see fetchFrame so the unit tests can serve
+ * the pages without a cluster.
+ */
+class PDBStoragePageFetcher {
+ public:
+
+  /**
+   * Initializes the fetcher, no request is made until the first page is requested
+   * @param address - the address of the manager
+   * @param port - the port of the manager
+   * @param maxRetries - how many times should we retry to connect to the manager if we fail
+   * @param set - the set we are grabbing the pages of
+   * @param db - the database the set belongs to
+   */
+  PDBStoragePageFetcher(std::string address, int port, int maxRetries, std::string set, std::string db);
+
+  /**
+   * Stops the fetching threads
+   */
+  virtual ~PDBStoragePageFetcher();
+
+  /**
+   * Returns the uncompressed bytes of the next page, blocks until the page is fetched
+   * @return the bytes if there is a page, null otherwise
+   */
+  std::unique_ptr<char[]> getNextPage();
+
+  /**
+   * The maximum number of threads that are fetching pages
+   */
+  static const size_t maxFetchingThreads = 16;
+
+  /**
+   * How many threads we use for each worker
+   */
+  static const size_t threadsPerWorker = 2;
+
+ protected:
+
+  /**
+   * Where a page of the set is
+   */
+  struct PageLocation {
+
+    // the address of the worker
+    std::string address;
+
+    // the port of the worker
+    int32_t port;
+
+    // the number of the page on the worker
+    uint64_t page;
+
+    // the serialized StoGetPageRequest for this page
+    std::vector<char> request;
+  };
+
+  /**
+   * Asks the manager where the pages are and fills in the @see locations, throws a runtime_error if it fails
+   */
+  virtual void getPlacement();
+
+  /**
+   * Requests a page from the worker it is on, throws a runtime_error if it fails. This runs on the fetching threads
+   * @param location - where the page is
+   * @param frameSize - the size of the frame we got
+   * @return the compressed frame of the page, null if the worker does not have the page anymore
+   */
+  virtual std::unique_ptr<char[]> fetchFrame(const PageLocation &location, size_t &frameSize);
+
+  /**
+   * Tells the fetching threads to stop and waits for them, a fetcher that overrides @see fetchFrame has to call it
+   * in its destructor so the threads are not running while it goes away
+   */
+  void stopFetching();
+
+  /**
+   * The pages of the set in the order we hand them out
+   */
+  std::vector<PageLocation> locations;
+
+ private:
+
+  /**
+   * A page that the fetching threads are working on
+   */
+  struct FetchedPage {
+
+    // the uncompressed bytes of the page, null if the worker does not have it anymore
+    std::unique_ptr<char[]> bytes;
+
+    // true once the page is fetched
+    bool done = false;
+
+    // the error if we failed to fetch the page
+    std::string error;
+  };
+
+  /**
+   * Asks the manager where the pages are, makes the requests for them and starts the fetching threads
+   */
+  void start();
+
+  /**
+   * The loop each fetching thread is running
+   */
+  void fetch();
+
+  /**
+   * Requests a page from the worker it is on and decompresses it
+   * @param location - where the page is
+   * @return the uncompressed bytes, null if the worker does not have the page anymore
+   */
+  std::unique_ptr<char[]> fetchPage(const PageLocation &location);
+
+  /**
+   * the address of the manager
+   */
+  std::string address;
+
+  /**
+   * the port of the manager
+   */
+  int port = -1;
+
+  /**
+   * How many times should we retry to connect to the manager if we fail
+   */
+  int maxRetries = 1;
+
+  /**
+   * The set this fetcher belongs to
+   */
+  std::string set;
+
+  /**
+   * The database the set belongs to
+   */
+  std::string db;
+
+  /**
+   * the logger
+   */
+  PDBLoggerPtr logger;
+
+  /**
+   * true once we got the placement from the manager
+   */
+  bool started = false;
+
+  /**
+   * The pages we are fetching, one for each location
+   */
+  std::vector<FetchedPage> pages;
+
+  /**
+   * The index of the next page we want to fetch
+   */
+  size_t nextToFetch = 0;
+
+  /**
+   * The index of the next page we want to hand out
+   */
+  size_t nextToReturn = 0;
+
+  /**
+   * How many pages we fetch ahead of the one we are handing out
+   */
+  size_t prefetchWindow = 0;
+
+  /**
+   * true if we want the fetching threads to stop
+   */
+  bool stop = false;
+
+  /**
+   * the mutex to sync the iterator and the fetching threads
+   */
+  std::mutex m;
+
+  /**
+   * the condition variable to signal that a page is fetched or that there is space for a page in the window
+   */
+  std::condition_variable cv;
+
+  /**
+   * The threads that are fetching the pages
+   */
+  std::vector<std::thread> threads;
+};
+
+}
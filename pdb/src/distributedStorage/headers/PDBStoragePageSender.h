@@ -0,0 +1,274 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <PDBLogger.h>
+#include <PDBDispatchPartitionPolicy.h>
+#include <PDBCodec.h>
+
+namespace pdb {
+
+/**
+ * Sends pages of data to a set without going through the manager. The sender asks the manager once for an ingest
+ * lease, the lease tells us what worker to send each page to. The pages are
+ * then compressed and streamed directly to the workers by a couple of background threads, each one of them using its
+ * own connection. The workers update the size of the set in the catalog once they store the pages.
+ *
+ * The sending threads do not have an allocator of their own, they share the main one with the thread that is using
+ * the sender. Therefore they never allocate pdb::Objects, the requests are made by @see send before they are started.
+ *
+ * If the set is partitioned the lease contains every worker and the partitioning of the set. In that case the caller
+ * has to request the lease upfront, split its records by @see getNodeForKey and add the pages for each node.
+ *
+ * The workers only accept the pages sent with a lease the manager registered with them, and the set stays locked for
+ * writing while the lease is out. The sender returns the lease it requested once it is destroyed, when it requests a
+ * new one or when @see releaseLease is called.
+ */
+class PDBStoragePageSender {
+ public:
+
+  /**
+   * Initializes the sender
+   * @param address - the address of the manager
+   * @param port - the port of the manager
+   * @param maxRetries - how many times should we retry to connect to a node if we fail
+   * @param set - the set we are sending the pages to
+   * @param db - the database the set belongs to
+   * @param typeName - the type of the objects we are sending
+   */
+  PDBStoragePageSender(std::string address, int port, int maxRetries, std::string set, std::string db, std::string typeName);
+
+  /**
+   * Returns the lease if we requested one
+   */
+  ~PDBStoragePageSender();
+
+  /**
+   * Adds a page we want to send, the bytes must stay valid until @see send returns
+   * @param bytes - the bytes of the record we want to send
+   * @param numBytes - the size of the record
+   */
+  void addPage(const char *bytes, size_t numBytes);
+
+  /**
+   * Adds a page that has to go to a particular node of the lease, the bytes must stay valid until @see send returns
+   * @param bytes - the bytes of the record we want to send
+   * @param numBytes - the size of the record
+   * @param node - the index of the node in the lease @see getNodeForKey
+   */
+  void addPage(const char *bytes, size_t numBytes, size_t node);
+
+  /**
+   * Asks the manager for the lease, the manager picks a node for each page that is not assigned to one yet by its size.
+   * If this is not called before @see send or pages were added after it, send will do it.
+   * @param errMsg - the error if we fail
+   * @return true if we got the lease, false otherwise
+   */
+  bool requestLease(std::string &errMsg);
+
+  /**
+   * Returns the lease we requested to the manager, so the set is unlocked and the workers stop accepting pages with it.
+   * A lease that was copied from another sender is returned by that sender.
+   * @param errMsg - the error if we fail
+   * @return true if there was no lease to return or we returned it, false otherwise
+   */
+  bool releaseLease(std::string &errMsg);
+
+  /**
+   * Uses the lease another sender got for the same set, so that the pages of both senders are placed on the same nodes.
+   * The other sender has to keep the lease until this one is done sending.
+   * @param other - the sender that has the lease
+   */
+  void copyLease(const PDBStoragePageSender &other);
+
+  /**
+   * Is the set we are sending the pages to partitioned, only valid once we have the lease
+   * @return true if it is, false otherwise
+   */
+  bool isPartitioned() const;
+
+  /**
+   * Returns the name of the attribute or method the set is partitioned on, only valid once we have the lease
+   * @return the name, empty if the set is not partitioned
+   */
+  const std::string &getPartitionKey() const;
+
+  /**
+   * Is the set we are sending the pages to columnar, if it is the pages have to be columnar pages @see PDBColumns,
+   * only valid once we have the lease
+   * @return true if it is, false otherwise
+   */
+  bool isColumnar() const;
+
+  /**
+   * Returns the index of the node in the lease the records with this key go to, only valid once we have the lease
+   * @param key - the key of the records
+   * @return the index of the node
+   */
+  size_t getNodeForKey(int64_t key) const;
+
+  /**
+   * Returns the number of nodes in the lease
+   * @return the number of nodes
+   */
+  size_t getNumNodes() const;
+
+  /**
+   * Sends all the pages we added and waits until the workers have stored them
+   * @param errMsg - the error if we fail
+   * @return true if every page was stored, false otherwise
+   */
+  bool send(std::string &errMsg);
+
+  /**
+   * Removes the pages we added, but keeps the lease, so the sender can be reused for the next couple of pages
+   */
+  void clear();
+
+  /**
+   * The maximum number of threads that are compressing and sending pages
+   */
+  static const size_t maxSendingThreads = 16;
+
+  /**
+   * How many threads we use for each worker
+   */
+  static const size_t threadsPerWorker = 2;
+
+ private:
+
+  /**
+   * A page we are sending
+   */
+  struct PageToSend {
+
+    // the bytes of the record we are sending
+    const char *bytes;
+
+    // the size of the record
+    size_t numBytes;
+
+    // the compressed record
+    std::unique_ptr<char[]> compressed;
+
+    // the size of the compressed record
+    size_t compressedSize = 0;
+
+    // the index of the node in the lease we are sending this page to
+    size_t node = 0;
+
+    // true if the caller already decided what node the page goes to
+    bool assigned = false;
+
+    // the serialized StoDispatchData for this page
+    std::vector<char> request;
+  };
+
+  /**
+   * Checks if each page is assigned to a node of the lease
+   * @param errMsg - the error if we fail
+   * @return true if the lease covers all the pages, false otherwise
+   */
+  bool checkPages(std::string &errMsg);
+
+  /**
+   * Runs the function for each page on a couple of threads
+   * @param numThreads - the number of threads we want to use
+   * @param function - the function, returns false and sets the error if it fails
+   * @param errMsg - the first error we got if we fail
+   * @return true if the function succeeded for each page
+   */
+  bool forEachPage(size_t numThreads, const std::function<bool(PageToSend &, std::string &)> &function, std::string &errMsg);
+
+  /**
+   * Sends a page to the node it was assigned to and waits for the node to store it
+   * @param page - the page we are sending
+   * @param errMsg - the error if we fail
+   * @return true if the page was stored, false otherwise
+   */
+  bool sendPage(PageToSend &page, std::string &errMsg);
+
+  /**
+   * the address of the manager
+   */
+  std::string address;
+
+  /**
+   * the port of the manager
+   */
+  int port = -1;
+
+  /**
+   * How many times should we retry to connect to a node if we fail
+   */
+  int maxRetries = 1;
+
+  /**
+   * The set we are sending the pages to
+   */
+  std::string set;
+
+  /**
+   * The database the set belongs to
+   */
+  std::string db;
+
+  /**
+   * The type of the objects we are sending
+   */
+  std::string typeName;
+
+  /**
+   * the logger
+   */
+  PDBLoggerPtr logger;
+
+  /**
+   * The addresses and ports of the nodes in the lease
+   */
+  std::vector<std::pair<std::string, int32_t>> nodes;
+
+  /**
+   * true once we have the lease
+   */
+  bool leased = false;
+
+  /**
+   * The id of the lease, it is sent with every page
+   */
+  uint64_t leaseID = 0;
+
+  /**
+   * true if we requested the lease and therefore have to return it
+   */
+  bool ownsLease = false;
+
+  /**
+   * The policy that places the records if the set is partitioned, null otherwise
+   */
+  PDBDispatchPartitionPolicyPtr partitionPolicy;
+
+  /**
+   * The name of the attribute or method the set is partitioned on
+   */
+  std::string partitionKey;
+
+  /**
+   * The codec we compress the pages with, the manager picks it with the lease
+   */
+  PDBCodecPtr codec;
+
+  /**
+   * Is the set columnar
+   */
+  bool columnar = false;
+
+  /**
+   * The pages we are sending
+   */
+  std::vector<PageToSend> pages;
+};
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PDBStorageIterator.h"
+#include "PDBStoragePageFetcher.h"
 #include <string>
 
 namespace pdb {
@@ -31,7 +32,14 @@ private:
    * Grab the next page
    * @return true if we could grab the next page
    */
-  bool getNextPage(bool isFirst);
+  bool getNextPage();
+
+  /**
+   * Makes the records of a columnar page
+   * @param page - the columnar page
+   * @return a buffer that has the records just like a page that is not columnar
+   */
+  std::unique_ptr<char[]> decodeColumnarPage(const char *page);
 
   /**
    * the address of the manager
@@ -64,14 +72,9 @@ private:
   std::string db;
 
   /**
-   * The number of the page we want to get
+   * Grabs the pages directly from the workers
    */
-  uint64_t currPage = 0;
-
-  /**
-   * The node we want to grab the page from
-   */
-  std::string currNode = "none";
+  PDBStoragePageFetcherPtr fetcher;
 
   /**
    * The current record on the page
@@ -82,11 +85,6 @@ private:
    * The buffer we are storing the records
    */
   std::unique_ptr<char[]> buffer;
-
-  /**
-   * The size of the buffer
-   */
-  size_t bufferSize = 0;
 };
 
 }
@@ -2,10 +2,9 @@
 
 #include <PDBVector.h>
 #include <PDBCommunicator.h>
-#include <HeapRequest.h>
-#include <StoGetNextPageRequest.h>
-#include <StoGetNextPageResult.h>
-#include <snappy.h>
+#include <PDBStoragePageFetcher.h>
+#include <PDBColumns.h>
+#include <UseTemporaryAllocationBlock.h>
 
 namespace pdb {
 
@@ -28,7 +27,7 @@ template<class T>
 bool PDBStorageVectorIterator<T>::hasNextRecord() {
 
   // are we starting out
-  if (buffer == nullptr && !getNextPage(true)) {
+  if (buffer == nullptr && !getNextPage()) {
     return false;
   }
 
@@ -43,7 +42,7 @@ bool PDBStorageVectorIterator<T>::hasNextRecord() {
     }
 
     // get the next page since we need it.
-  } while (getNextPage(false));
+  } while (getNextPage());
 
   // we are out of pages
   return false;
@@ -53,7 +52,7 @@ template<class T>
 Handle<T> PDBStorageVectorIterator<T>::getNextRecord() {
 
   // are we starting out
-  if (buffer == nullptr && !getNextPage(true)) {
+  if (buffer == nullptr && !getNextPage()) {
     return nullptr;
   }
 
@@ -68,120 +67,69 @@ Handle<T> PDBStorageVectorIterator<T>::getNextRecord() {
     }
 
     // get the next page since we need it.
-  } while (getNextPage(false));
+  } while (getNextPage());
 
   // we are out of pages
   return nullptr;
 }
 
 template<class T>
-bool PDBStorageVectorIterator<T>::getNextPage(bool isFirst) {
+bool PDBStorageVectorIterator<T>::getNextPage() {
 
-  // the buffer for the compressed data
-  std::unique_ptr<char[]> compressedBuffer;
-  size_t compressedBufferSize;
-
-  // the communicator
-  PDBCommunicatorPtr comm = std::make_shared<PDBCommunicator>();
-  string errMsg;
-
-  // try multiple times if we fail to connect
-  int numRetries = 0;
-  while (numRetries <= maxRetries) {
-
-    // connect to the server
-    if (!comm->connectToInternetServer(logger, port, address, errMsg)) {
-
-      // log the error
-      logger->error(errMsg);
-      logger->error("Can not connect to remote server with port=" + std::to_string(port) + " and address=" + address + ");");
-
-      // throw an exception
-      throw std::runtime_error(errMsg);
-    }
-
-    // we connected
-    break;
-  }
-
-  // make a block to send the request
-  const UseTemporaryAllocationBlock tempBlock{1024};
-
-  // make the request
-  Handle<StoGetNextPageRequest> request = makeObject<StoGetNextPageRequest>(db, set, currPage, currNode, isFirst);
-
-  // send the object
-  if (!comm->sendObject(request, errMsg)) {
-
-    // yeah something happened
-    logger->error(errMsg);
-    logger->error("Not able to send request to server.\n");
-
-    // throw an exception
-    throw std::runtime_error(errMsg);
+  // if this is the first page start fetching the pages
+  if (fetcher == nullptr) {
+    fetcher = std::make_shared<PDBStoragePageFetcher>(address, port, maxRetries, set, db);
   }
 
-  // get the response and process it
-  bool success;
-  Handle<StoGetNextPageResult> result = comm->getNextObject<StoGetNextPageResult>(success, errMsg);
-
-  // did we get a response
-  if (result == nullptr) {
-
-    // throw an exception
-    throw std::runtime_error(errMsg);
-  }
+  // grab the next page
+  auto page = fetcher->getNextPage();
 
   // do we have a next page
-  if (!result->hasNext) {
+  if (page == nullptr) {
     return false;
   }
 
-  // set the node and the page
-  currNode = result->nodeID;
-  currPage = result->page + 1;
-  compressedBufferSize = result->pageSize;
-
-  // init the compressed buffer
-  compressedBuffer = std::unique_ptr<char[]>(new char[result->pageSize]);
-
-  // check if we failed to allocate
-  if (compressedBuffer == nullptr) {
-    throw std::bad_alloc();
+  // if the page is columnar we make the records from the columns
+  if (PDBColumnarPage::isColumnar(page.get())) {
+    page = decodeColumnarPage(page.get());
   }
 
   // we start from the first record
+  buffer = std::move(page);
   currRecord = 0;
 
-  // read the size
-  auto readSize = RequestFactory::waitForBytes(logger, comm, compressedBuffer.get(), compressedBufferSize, errMsg);
-
-  // did we read anything
-  if (readSize == -1) {
-    throw std::runtime_error(errMsg);
-  }
-
-  // get the uncompressed size
-  size_t uncompressedSize = 0;
-  snappy::GetUncompressedLength(compressedBuffer.get(), compressedBufferSize, &uncompressedSize);
-
-  // allocate some memory if we need it
-  if (bufferSize < uncompressedSize) {
-
-    // allocate the memory
-    buffer = std::unique_ptr<char[]>(new char[uncompressedSize]);
+  // we succeeded
+  return true;
+}
 
-    // check if we failed to allocate
-    if (buffer == nullptr) {
-      throw std::bad_alloc();
+template<class T>
+std::unique_ptr<char[]> PDBStorageVectorIterator<T>::decodeColumnarPage(const char *page) {
+
+  // we start with a block that should be large enough for the records and make it larger if it is not
+  PDBColumnarPage columnarPage(page);
+  size_t blockSize = (columnarPage.isValid() ? columnarPage.getNumRows() * columnarPage.getRowBytes() : 0) + 1024 * 1024;
+  while (true) {
+
+    std::unique_ptr<char[]> block(new char[blockSize]);
+    try {
+
+      // make the records on the block
+      const UseTemporaryAllocationBlock tempBlock{block.get(), blockSize};
+      std::string error;
+      Handle<Vector<Handle<T>>> records = pdb::decodeColumnarPage<T>(columnarPage, error);
+      if (records == nullptr) {
+        throw runtime_error("Could not read a page of the set (" + db + "," + set + "). " + error);
+      }
+
+      // make it the root object of the block, so the block is a record like any other page, and keep the records
+      getRecord(records);
+      records.emptyOutContainingBlock();
+      return block;
+
+    } catch (NotEnoughSpace &n) {
+      blockSize *= 2;
     }
   }
-
-  // uncompress and copy to buffer
-  snappy::RawUncompress((char *) compressedBuffer.get(), compressedBufferSize, (char *) buffer.get());
-
-  // we succeeded
-  return true;
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,18 @@
+#include <PDBDispatchHashPolicy.h>
+
+namespace pdb {
+
+int32_t PDBDispatchHashPolicy::getPartition(int64_t key) const {
+
+  // mix the bits of the key so that keys that are close to each other end up in different partitions
+  auto h = (uint64_t) key;
+  h ^= h >> 33u;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33u;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33u;
+
+  return (int32_t) (h % (uint64_t) numPartitions);
+}
+
+}
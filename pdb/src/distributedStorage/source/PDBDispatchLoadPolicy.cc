@@ -0,0 +1,114 @@
+#include <PDBDispatchLoadPolicy.h>
+#include <algorithm>
+
+namespace pdb {
+
+constexpr std::chrono::milliseconds PDBDispatchLoadPolicy::loadRefreshInterval;
+
+PDBCatalogNodePtr PDBDispatchLoadPolicy::getNextNode(const std::string &database, const std::string &set, const std::vector<PDBCatalogNodePtr> &nodes) {
+
+  // we don't know the size so we only count the page
+  return getNextNode(database, set, 0, nodes);
+}
+
+PDBCatalogNodePtr PDBDispatchLoadPolicy::getNextNode(const std::string &database,
+                                                     const std::string &set,
+                                                     uint64_t numBytes,
+                                                     const std::vector<PDBCatalogNodePtr> &nodes) {
+  // lock the thing
+  std::unique_lock<std::mutex> lck(m);
+
+  // the loads of the set
+  auto &setLoads = loads[std::make_pair(database, set)];
+
+  // pick the less loaded one of two distinct random nodes or the least loaded one of all
+  size_t best = 0;
+  if(twoChoices && nodes.size() > 2) {
+    size_t first = generator() % nodes.size();
+    size_t second = (first + 1 + generator() % (nodes.size() - 1)) % nodes.size();
+    best = isLessLoaded(setLoads[nodes[second]->nodeID], setLoads[nodes[first]->nodeID]) ? second : first;
+  }
+  else {
+    for(size_t i = 1; i < nodes.size(); ++i) {
+      if(isLessLoaded(setLoads[nodes[i]->nodeID], setLoads[nodes[best]->nodeID])) {
+        best = i;
+      }
+    }
+  }
+
+  // the page is pending until the worker reports it
+  auto &load = setLoads[nodes[best]->nodeID];
+  load.pendingBytes += numBytes;
+  load.pendingPages++;
+
+  // return the node
+  return nodes[best];
+}
+
+void PDBDispatchLoadPolicy::updateLoad(const std::string &database,
+                                       const std::string &set,
+                                       const std::vector<PDBCatalogSetOnNodePtr> &setOnNodes) {
+  // lock the thing
+  std::unique_lock<std::mutex> lck(m);
+
+  // the loads of the set
+  auto &setLoads = loads[std::make_pair(database, set)];
+  for(const auto &setOnNode : setOnNodes) {
+
+    // whatever got reported since the last time is not pending anymore
+    auto &load = setLoads[setOnNode->nodeID];
+    auto newBytes = setOnNode->setSize > load.reportedBytes ? setOnNode->setSize - load.reportedBytes : 0;
+    auto newPages = setOnNode->numPages > load.reportedPages ? setOnNode->numPages - load.reportedPages : 0;
+    load.pendingBytes -= std::min<uint64_t>(load.pendingBytes, newBytes);
+    load.pendingPages -= std::min<uint64_t>(load.pendingPages, newPages);
+
+    // store the new report
+    load.reportedBytes = setOnNode->setSize;
+    load.reportedPages = setOnNode->numPages;
+  }
+
+  // remember when we got it
+  lastReports[std::make_pair(database, set)] = std::chrono::steady_clock::now();
+}
+
+bool PDBDispatchLoadPolicy::needsLoad(const std::string &database, const std::string &set) {
+
+  // lock the thing
+  std::unique_lock<std::mutex> lck(m);
+
+  // if we never got a report or it is too old we want a new one
+  auto it = lastReports.find(std::make_pair(database, set));
+  return it == lastReports.end() || std::chrono::steady_clock::now() - it->second >= loadRefreshInterval;
+}
+
+void PDBDispatchLoadPolicy::removeSet(const std::string &database, const std::string &set) {
+
+  // lock the thing
+  std::unique_lock<std::mutex> lck(m);
+
+  // forget everything about the set
+  loads.erase(std::make_pair(database, set));
+  lastReports.erase(std::make_pair(database, set));
+}
+
+uint64_t PDBDispatchLoadPolicy::getLoad(const std::string &database, const std::string &set, const std::string &nodeID) {
+
+  // lock the thing
+  std::unique_lock<std::mutex> lck(m);
+
+  // find the set
+  auto setLoads = loads.find(std::make_pair(database, set));
+  if(setLoads == loads.end()) {
+    return 0;
+  }
+
+  // find the node
+  auto load = setLoads->second.find(nodeID);
+  return load == setLoads->second.end() ? 0 : load->second.bytes();
+}
+
+bool PDBDispatchLoadPolicy::isLessLoaded(const NodeLoad &lhs, const NodeLoad &rhs) {
+  return lhs.bytes() < rhs.bytes() || (lhs.bytes() == rhs.bytes() && lhs.pages() < rhs.pages());
+}
+
+}
@@ -0,0 +1,92 @@
+#include <PDBDispatchPartitionPolicy.h>
+#include <PDBDispatchHashPolicy.h>
+#include <PDBDispatchRangePolicy.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace pdb {
+
+size_t PDBDispatchPartitionPolicy::getNodeIndex(int64_t key, size_t numNodes) const {
+  return (size_t) getPartition(key) % numNodes;
+}
+
+PDBCatalogNodePtr PDBDispatchPartitionPolicy::getNextNode(const std::string &database, const std::string &set, const std::vector<PDBCatalogNodePtr> &nodes) {
+  throw std::runtime_error("The set (" + database + "," + set + ") is partitioned, the records can only be placed by their key.");
+}
+
+PDBCatalogNodePtr PDBDispatchPartitionPolicy::getNodeForKey(const std::string &database,
+                                                            const std::string &set,
+                                                            int64_t key,
+                                                            const std::vector<PDBCatalogNodePtr> &nodes) {
+  // the partitions are assigned in the order of the node ids
+  auto ordered = orderNodes(nodes);
+  return ordered[getNodeIndex(key, ordered.size())];
+}
+
+std::vector<PDBCatalogNodePtr> PDBDispatchPartitionPolicy::orderNodes(const std::vector<PDBCatalogNodePtr> &nodes) {
+
+  // copy the nodes and sort them by the id
+  auto ordered = nodes;
+  std::sort(ordered.begin(), ordered.end(), [](const PDBCatalogNodePtr &lhs, const PDBCatalogNodePtr &rhs) {
+    return lhs->nodeID < rhs->nodeID;
+  });
+
+  return std::move(ordered);
+}
+
+std::string PDBDispatchPartitionPolicy::formatNodes(const std::vector<PDBCatalogNodePtr> &nodes) {
+
+  // join the ids with commas
+  std::string ret;
+  for(size_t i = 0; i < nodes.size(); ++i) {
+    ret += (i == 0 ? "" : ",") + nodes[i]->nodeID;
+  }
+
+  return ret;
+}
+
+bool PDBDispatchPartitionPolicy::placeNodes(const std::string &partitionNodes,
+                                            const std::vector<PDBCatalogNodePtr> &nodes,
+                                            std::vector<PDBCatalogNodePtr> &placed,
+                                            std::string &error) {
+
+  // split the string by the commas and find each node
+  placed.clear();
+  std::stringstream ss(partitionNodes);
+  std::string nodeID;
+  while (std::getline(ss, nodeID, ',')) {
+
+    auto it = std::find_if(nodes.begin(), nodes.end(), [&](const PDBCatalogNodePtr &node) { return node->nodeID == nodeID; });
+    if(it == nodes.end()) {
+      error = "The node " + nodeID + " that has partitions of the set is not active.";
+      return false;
+    }
+
+    placed.emplace_back(*it);
+  }
+
+  return true;
+}
+
+PDBDispatchPartitionPolicyPtr PDBDispatchPartitionPolicy::create(PDBCatalogSetPartitionType type,
+                                                                 int32_t numPartitions,
+                                                                 const std::string &boundaries) {
+  switch (type) {
+    case PDB_CATALOG_SET_HASH_PARTITIONING: return std::make_shared<PDBDispatchHashPolicy>(numPartitions);
+    case PDB_CATALOG_SET_RANGE_PARTITIONING: return std::make_shared<PDBDispatchRangePolicy>(PDBDispatchRangePolicy::parseBoundaries(boundaries));
+    default: return nullptr;
+  }
+}
+
+PDBDispatchPartitionPolicyPtr PDBDispatchPartitionPolicy::create(const PDBCatalogSet &set) {
+
+  // if the set is not partitioned there is no policy
+  if(!set.isPartitioned()) {
+    return nullptr;
+  }
+
+  return create((PDBCatalogSetPartitionType) set.partitionType, set.numPartitions, set.partitionBoundaries);
+}
+
+}
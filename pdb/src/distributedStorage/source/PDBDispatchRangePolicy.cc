@@ -0,0 +1,42 @@
+#include <PDBDispatchRangePolicy.h>
+#include <algorithm>
+#include <sstream>
+
+namespace pdb {
+
+PDBDispatchRangePolicy::PDBDispatchRangePolicy(std::vector<int64_t> boundaries) : PDBDispatchPartitionPolicy((int32_t) boundaries.size() + 1),
+                                                                                  boundaries(std::move(boundaries)) {}
+
+int32_t PDBDispatchRangePolicy::getPartition(int64_t key) const {
+
+  // find the first range whose upper boundary is not smaller than the key
+  return (int32_t) (std::lower_bound(boundaries.begin(), boundaries.end(), key) - boundaries.begin());
+}
+
+std::vector<int64_t> PDBDispatchRangePolicy::parseBoundaries(const std::string &boundaries) {
+
+  // split the string by the commas
+  std::vector<int64_t> ret;
+  std::stringstream ss(boundaries);
+  std::string boundary;
+  while (std::getline(ss, boundary, ',')) {
+    if(!boundary.empty()) {
+      ret.emplace_back(std::stoll(boundary));
+    }
+  }
+
+  return std::move(ret);
+}
+
+std::string PDBDispatchRangePolicy::formatBoundaries(const std::vector<int64_t> &boundaries) {
+
+  // join the boundaries with commas
+  std::string ret;
+  for(size_t i = 0; i < boundaries.size(); ++i) {
+    ret += (i == 0 ? "" : ",") + std::to_string(boundaries[i]);
+  }
+
+  return ret;
+}
+
+}
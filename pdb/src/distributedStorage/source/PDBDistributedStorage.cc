@@ -17,7 +17,7 @@
  *****************************************************************************/
 
 #include "PDBDistributedStorage.h"
-#include <snappy.h>
+#include <PDBCodec.h>
 #include <HeapRequestHandler.h>
 #include <DisAddData.h>
 #include <DisClearSet.h>
@@ -25,6 +25,7 @@
 #include <BufGetPageRequest.h>
 #include <PDBBufferManagerInterface.h>
 #include <PDBDispatchRandomPolicy.h>
+#include <PDBDispatchLoadPolicy.h>
 #include "PDBCatalogClient.h"
 #include <boost/filesystem/path.hpp>
 #include <PDBDistributedStorage.h>
@@ -35,11 +36,17 @@ namespace pdb {
 
 namespace fs = boost::filesystem;
 
+const uint64_t PDBDistributedStorage::ingestLeaseTimeout;
 
 void PDBDistributedStorage::init() {
 
-  // init the policy
-  policy = std::make_shared<PDBDispatchRandomPolicy>();
+  // init the policy, the pages go to random nodes unless we asked for one of the policies that look at the load
+  if(getConfiguration()->dispatchPolicy == "leastLoaded" || getConfiguration()->dispatchPolicy == "twoChoices") {
+    policy = std::make_shared<PDBDispatchLoadPolicy>(getConfiguration()->dispatchPolicy == "twoChoices");
+  }
+  else {
+    policy = std::make_shared<PDBDispatchRandomPolicy>();
+  }
 
   // init the class
   logger = make_shared<pdb::PDBLogger>((fs::path(getConfiguration()->rootDirectory) / "logs").string(), "PDBDistributedStorage.log");
@@ -54,6 +61,13 @@ forMe.registerHandler(
           return handleGetNextPage<PDBCommunicator, RequestFactory>(request, sendUsingMe);
         }));
 
+forMe.registerHandler(
+    DisGetSetPlacement_TYPEID,
+    make_shared<pdb::HeapRequestHandler<pdb::DisGetSetPlacement>>(
+        [&](Handle<pdb::DisGetSetPlacement> request, PDBCommunicatorPtr sendUsingMe) {
+          return handleGetSetPlacement<PDBCommunicator, RequestFactory>(request, sendUsingMe);
+        }));
+
 forMe.registerHandler(
     DisAddData_TYPEID,
     make_shared<HeapRequestHandler<pdb::DisAddData>>(
@@ -61,6 +75,20 @@ forMe.registerHandler(
           return handleAddData<PDBCommunicator, RequestFactory>(request, sendUsingMe);
     }));
 
+forMe.registerHandler(
+    DisGetIngestLease_TYPEID,
+    make_shared<HeapRequestHandler<pdb::DisGetIngestLease>>(
+        [&](Handle<pdb::DisGetIngestLease> request, PDBCommunicatorPtr sendUsingMe) {
+          return handleGetIngestLease<PDBCommunicator, RequestFactory>(request, sendUsingMe);
+    }));
+
+forMe.registerHandler(
+    DisReleaseIngestLease_TYPEID,
+    make_shared<HeapRequestHandler<pdb::DisReleaseIngestLease>>(
+        [&](Handle<pdb::DisReleaseIngestLease> request, PDBCommunicatorPtr sendUsingMe) {
+          return handleReleaseIngestLease<PDBCommunicator, RequestFactory>(request, sendUsingMe);
+    }));
+
 forMe.registerHandler(
     DisClearSet_TYPEID,
     make_shared<HeapRequestHandler<pdb::DisClearSet>>(
@@ -137,8 +165,9 @@ PDBDistributedStorageSetLockPtr pdb::PDBDistributedStorage::tryUsingSet(const st
          isInUse.state == PDBDistributedStorageSetState::WRITING_DATA ||
          isInUse.state == PDBDistributedStorageSetState::WRITE_READ_DATA) {
 
-        // update the state
+        // update the state, the set is about to change
         isInUse.numWriters++;
+        isInUse.version++;
 
         // update the state if we need
         if(isInUse.state == PDBDistributedStorageSetState::NONE) {
@@ -185,6 +214,8 @@ PDBDistributedStorageSetLockPtr pdb::PDBDistributedStorage::tryUsingSet(const st
       // check if we can grant it
       if(isInUse.state == PDBDistributedStorageSetState::NONE) {
         isInUse.state =  PDBDistributedStorageSetState::CLEARING_DATA;
+        isInUse.version++;
+        isInUse.numClears++;
 
         // return
         return std::make_shared<PDBDistributedStorageSetLock>(dbName, setName, PDBDistributedStorageSetState::CLEARING_DATA, distStorage);
@@ -196,6 +227,27 @@ PDBDistributedStorageSetLockPtr pdb::PDBDistributedStorage::tryUsingSet(const st
   }
 }
 
+void pdb::PDBDistributedStorage::expireIngestLeases() {
+
+  // grab the expired leases, we drop them once we release the lock since dropping them unlocks their sets
+  std::vector<PDBIngestLease> expired;
+  {
+    std::unique_lock<std::mutex> lck{ingestLeasesLck};
+
+    auto now = std::chrono::steady_clock::now();
+    for(auto it = ingestLeases.begin(); it != ingestLeases.end();) {
+      if(it->second.expires <= now) {
+        logger->warn("The ingest lease for the set (" + it->second.dbName + "," + it->second.setName + ") expired.");
+        expired.emplace_back(std::move(it->second));
+        it = ingestLeases.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+}
+
 void pdb::PDBDistributedStorage::finishUsingSet(const std::string &dbName, const std::string &setName, PDBDistributedStorageSetState stateRequested) {
 
   // lock the structure
@@ -207,9 +259,10 @@ void pdb::PDBDistributedStorage::finishUsingSet(const std::string &dbName, const
   if(stateRequested == PDBDistributedStorageSetState::WRITING_DATA &&
      (isInUse.state == PDBDistributedStorageSetState::WRITING_DATA || isInUse.state == PDBDistributedStorageSetState::WRITE_READ_DATA)) {
 
-    // decrement the number of writers
+    // decrement the number of writers, the set has changed
     assert(isInUse.numWriters > 0);
     isInUse.numWriters--;
+    isInUse.version++;
 
     // check if we are done writing
     if(isInUse.numReaders == 0 && isInUse.numWriters == 0) {
@@ -238,8 +291,9 @@ void pdb::PDBDistributedStorage::finishUsingSet(const std::string &dbName, const
     assert(isInUse.numReaders == 0);
     assert(isInUse.numReaders == 0);
 
-    // set the state back to none
+    // set the state back to none, the set has changed
     isInUse.state = PDBDistributedStorageSetState::NONE;
+    isInUse.version++;
   }
   else {
 
@@ -251,4 +305,24 @@ void pdb::PDBDistributedStorage::finishUsingSet(const std::string &dbName, const
   cv.notify_all();
 }
 
-}
\ No newline at end of file
+uint64_t pdb::PDBDistributedStorage::getSetVersion(const std::string &dbName, const std::string &setName) {
+
+  // lock the structure
+  std::unique_lock<std::mutex> lck{setInUseLck};
+
+  // the sets nobody used yet are at version 0
+  auto it = setStates.find(std::make_pair(dbName, setName));
+  return it != setStates.end() ? it->second.version : 0;
+}
+
+uint64_t pdb::PDBDistributedStorage::getSetNumClears(const std::string &dbName, const std::string &setName) {
+
+  // lock the structure
+  std::unique_lock<std::mutex> lck{setInUseLck};
+
+  // the sets nobody used yet were never cleared
+  auto it = setStates.find(std::make_pair(dbName, setName));
+  return it != setStates.end() ? it->second.numClears : 0;
+}
+
+}
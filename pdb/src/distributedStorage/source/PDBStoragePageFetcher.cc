@@ -0,0 +1,297 @@
+#include <PDBStoragePageFetcher.h>
+#include <PDBCommunicator.h>
+#include <HeapRequest.h>
+#include <UseTemporaryAllocationBlock.h>
+#include <AllocationBlockPool.h>
+#include <DisGetSetPlacement.h>
+#include <DisGetSetPlacementResult.h>
+#include <StoGetPageRequest.h>
+#include <StoGetPageResult.h>
+#include <PDBCodec.h>
+#include <algorithm>
+#include <set>
+
+const size_t pdb::PDBStoragePageFetcher::maxFetchingThreads;
+const size_t pdb::PDBStoragePageFetcher::threadsPerWorker;
+
+pdb::PDBStoragePageFetcher::PDBStoragePageFetcher(std::string address,
+                                                  int port,
+                                                  int maxRetries,
+                                                  std::string set,
+                                                  std::string db) : address(std::move(address)),
+                                                                    port(port),
+                                                                    maxRetries(maxRetries),
+                                                                    set(std::move(set)),
+                                                                    db(std::move(db)) {
+  // init the logger
+  logger = std::make_shared<PDBLogger>("setIterator");
+}
+
+pdb::PDBStoragePageFetcher::~PDBStoragePageFetcher() {
+  stopFetching();
+}
+
+void pdb::PDBStoragePageFetcher::stopFetching() {
+
+  // tell the fetching threads to stop
+  {
+    std::unique_lock<std::mutex> lck(m);
+    stop = true;
+  }
+  cv.notify_all();
+
+  // wait for them to finish
+  for(auto &thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+}
+
+std::unique_ptr<char[]> pdb::PDBStoragePageFetcher::getNextPage() {
+
+  // if this is the first page we need to figure out where the pages are
+  if(!started) {
+    start();
+  }
+
+  std::unique_lock<std::mutex> lck(m);
+  while(nextToReturn < pages.size()) {
+
+    // wait until the page is fetched
+    auto &page = pages[nextToReturn];
+    cv.wait(lck, [&] { return page.done; });
+
+    // we move to the next page, there is space for another page in the window
+    nextToReturn++;
+    cv.notify_all();
+
+    // did we fail to fetch it
+    if(!page.error.empty()) {
+      throw std::runtime_error(page.error);
+    }
+
+    // if the worker did not have the page anymore skip it
+    if(page.bytes != nullptr) {
+      return std::move(page.bytes);
+    }
+  }
+
+  // we are out of pages
+  return nullptr;
+}
+
+void pdb::PDBStoragePageFetcher::start() {
+
+  /// 1. Ask the manager where the pages are
+
+  getPlacement();
+
+  /// 2. Make the requests for the pages, so that the fetching threads don't have to allocate anything
+
+  // resolve the type id of the request here, so that the fetching threads don't have to look it up
+  getTypeID<StoGetPageRequest>();
+
+  for(auto &location : locations) {
+
+    // make the request
+    const UseTemporaryAllocationBlock tempBlock{1024};
+    Handle<StoGetPageRequest> request = makeObject<StoGetPageRequest>(db, set, location.page);
+
+    // copy the record
+    auto *record = getRecord(request);
+    location.request = std::vector<char>((char*) record, (char*) record + record->numBytes());
+  }
+
+  /// 3. Start the threads that are fetching the pages
+
+  // figure out on how many workers the set is
+  std::set<std::pair<std::string, int32_t>> workers;
+  for(auto &location : locations) {
+    workers.insert(std::make_pair(location.address, location.port));
+  }
+
+  // we use a couple of threads for each worker, so that the fetching scales with the number of workers
+  auto numThreads = std::min(std::min(workers.size() * threadsPerWorker, maxFetchingThreads), locations.size());
+  prefetchWindow = 2 * numThreads;
+
+  // init the pages and start the threads
+  pages = std::vector<FetchedPage>(locations.size());
+  for(size_t i = 0; i < numThreads; ++i) {
+    threads.emplace_back([this]() { fetch(); });
+  }
+
+  // mark that we started
+  started = true;
+}
+
+void pdb::PDBStoragePageFetcher::getPlacement() {
+
+  std::string errMsg;
+  bool success = RequestFactory::heapRequest<DisGetSetPlacement, DisGetSetPlacementResult, bool>(
+      logger, port, address, false, 1024,
+      [&](Handle<DisGetSetPlacementResult> result) {
+
+        // did we fail
+        if (result == nullptr || !result->success) {
+          errMsg = "Could not get the placement of the set (" + db + "," + set + ") from the manager.";
+          return false;
+        }
+
+        // copy the locations of the pages
+        locations.reserve(result->pages.size());
+        for(int i = 0; i < result->pages.size(); ++i) {
+          auto node = result->pageNodes[i];
+          locations.push_back(PageLocation{ result->nodeAddresses[node], result->nodePorts[node], result->pages[i] });
+        }
+
+        return true;
+      }, db, set);
+
+  // if we failed throw an exception
+  if(!success) {
+    logger->error(errMsg);
+    throw std::runtime_error(errMsg);
+  }
+}
+
+void pdb::PDBStoragePageFetcher::fetch() {
+
+  while (true) {
+
+    // wait until there is a page to fetch in the window or we need to stop
+    size_t idx;
+    {
+      std::unique_lock<std::mutex> lck(m);
+      cv.wait(lck, [&] { return stop || nextToFetch >= pages.size() || nextToFetch < nextToReturn + prefetchWindow; });
+
+      // should we finish?
+      if(stop || nextToFetch >= pages.size()) {
+        return;
+      }
+
+      // take the page
+      idx = nextToFetch++;
+    }
+
+    // fetch the page, this is the part that is running in parallel
+    std::unique_ptr<char[]> bytes;
+    std::string error;
+    try {
+      bytes = fetchPage(locations[idx]);
+    }
+    catch (std::exception &e) {
+      error = e.what();
+    }
+
+    // store the page
+    {
+      std::unique_lock<std::mutex> lck(m);
+      pages[idx].bytes = std::move(bytes);
+      pages[idx].error = error;
+      pages[idx].done = true;
+    }
+    cv.notify_all();
+  }
+}
+
+std::unique_ptr<char[]> pdb::PDBStoragePageFetcher::fetchPage(const PageLocation &location) {
+
+  // get the frame from the worker
+  size_t frameSize = 0;
+  auto frame = fetchFrame(location, frameSize);
+
+  // if the worker does not have the page anymore we skip it
+  if (frame == nullptr) {
+    return nullptr;
+  }
+
+  // check the frame
+  if (!PDBCodec::isFrame(frame.get(), frameSize)) {
+    throw std::runtime_error("The page we got is corrupted.");
+  }
+
+  // uncompress the page with the codec the node compressed it with
+  auto uncompressedSize = PDBCodec::getFrameUncompressedSize(frame.get());
+  std::unique_ptr<char[]> buffer(new char[uncompressedSize]);
+  if (!PDBCodec::decompressFrame(frame.get(), frameSize, buffer.get(), uncompressedSize)) {
+    throw std::runtime_error("Could not uncompress the page, it is corrupted or we were not built with its codec.");
+  }
+
+  // we succeeded
+  return std::move(buffer);
+}
+
+std::unique_ptr<char[]> pdb::PDBStoragePageFetcher::fetchFrame(const PageLocation &location, size_t &frameSize) {
+
+  // the communicator
+  PDBCommunicatorPtr comm = std::make_shared<PDBCommunicator>();
+  string errMsg;
+
+  // try multiple times if we fail to connect
+  int numRetries = 0;
+  while (!comm->connectToInternetServer(logger, location.port, location.address, errMsg)) {
+
+    // log the error
+    logger->error(errMsg);
+    logger->error("Can not connect to remote server with port=" + std::to_string(location.port) + " and address=" + location.address + ");");
+
+    // if we are out of retries throw an exception
+    if(++numRetries > maxRetries) {
+      throw std::runtime_error(errMsg);
+    }
+  }
+
+  // send the request we made upfront
+  auto *request = (Record<StoGetPageRequest> *) location.request.data();
+  if (!comm->sendRecord(request, errMsg)) {
+
+    // yeah something happened
+    logger->error(errMsg);
+    logger->error("Not able to send request to server.\n");
+
+    // throw an exception
+    throw std::runtime_error(errMsg);
+  }
+
+  // get the response, we read it into our own buffer since we can not use the allocator
+  size_t compressedBufferSize;
+  {
+    // did we get a response
+    auto responseSize = comm->getSizeOfNextObject();
+    if (responseSize == 0) {
+      throw std::runtime_error("Could not get the response for the page " + std::to_string(location.page) + " from " + location.address);
+    }
+
+    // read the response
+    bool success;
+    PooledBuffer response(responseSize);
+    Handle<StoGetPageResult> result = comm->getNextObject<StoGetPageResult>(response.get(), success, errMsg);
+
+    // did we get a response
+    if (!success) {
+      throw std::runtime_error(errMsg);
+    }
+
+    // if the worker does not have the page anymore or gave us a different one we skip it
+    if (!result->hasPage || result->pageNumber != location.page) {
+      return nullptr;
+    }
+
+    compressedBufferSize = result->size;
+  }
+
+  // init the compressed buffer
+  std::unique_ptr<char[]> compressedBuffer(new char[compressedBufferSize]);
+
+  // read the bytes
+  auto readSize = RequestFactory::waitForBytes(logger, comm, compressedBuffer.get(), compressedBufferSize, errMsg);
+
+  // did we read anything
+  if (readSize == -1) {
+    throw std::runtime_error(errMsg);
+  }
+
+  // we succeeded
+  frameSize = compressedBufferSize;
+  return std::move(compressedBuffer);
+}
@@ -0,0 +1,437 @@
+#include <PDBStoragePageSender.h>
+#include <PDBCommunicator.h>
+#include <HeapRequest.h>
+#include <UseTemporaryAllocationBlock.h>
+#include <AllocationBlockPool.h>
+#include <DisGetIngestLease.h>
+#include <DisGetIngestLeaseResult.h>
+#include <DisReleaseIngestLease.h>
+#include <StoDispatchData.h>
+#include <SimpleRequestResult.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+
+const size_t pdb::PDBStoragePageSender::maxSendingThreads;
+const size_t pdb::PDBStoragePageSender::threadsPerWorker;
+
+pdb::PDBStoragePageSender::PDBStoragePageSender(std::string address,
+                                                int port,
+                                                int maxRetries,
+                                                std::string set,
+                                                std::string db,
+                                                std::string typeName) : address(std::move(address)),
+                                                                        port(port),
+                                                                        maxRetries(maxRetries),
+                                                                        set(std::move(set)),
+                                                                        db(std::move(db)),
+                                                                        typeName(std::move(typeName)) {
+  // init the logger
+  logger = std::make_shared<PDBLogger>("pageSender");
+}
+
+pdb::PDBStoragePageSender::~PDBStoragePageSender() {
+
+  // return the lease if we still have it
+  std::string errMsg;
+  if(!releaseLease(errMsg)) {
+    logger->error(errMsg);
+  }
+}
+
+void pdb::PDBStoragePageSender::addPage(const char *bytes, size_t numBytes) {
+
+  // store the page
+  pages.emplace_back();
+  pages.back().bytes = bytes;
+  pages.back().numBytes = numBytes;
+}
+
+void pdb::PDBStoragePageSender::addPage(const char *bytes, size_t numBytes, size_t node) {
+
+  // store the page and the node it goes to
+  addPage(bytes, numBytes);
+  pages.back().node = node;
+  pages.back().assigned = true;
+}
+
+void pdb::PDBStoragePageSender::copyLease(const PDBStoragePageSender &other) {
+
+  // return our own lease if we have one
+  std::string errMsg;
+  if(!releaseLease(errMsg)) {
+    logger->error(errMsg);
+  }
+
+  // the lease belongs to the other sender
+  leaseID = other.leaseID;
+  ownsLease = false;
+
+  // copy the nodes, the partitioning and how the pages are written
+  nodes = other.nodes;
+  partitionPolicy = other.partitionPolicy;
+  partitionKey = other.partitionKey;
+  codec = other.codec;
+  columnar = other.columnar;
+  leased = other.leased;
+}
+
+bool pdb::PDBStoragePageSender::isPartitioned() const {
+  return partitionPolicy != nullptr;
+}
+
+const std::string &pdb::PDBStoragePageSender::getPartitionKey() const {
+  return partitionKey;
+}
+
+bool pdb::PDBStoragePageSender::isColumnar() const {
+  return columnar;
+}
+
+size_t pdb::PDBStoragePageSender::getNodeForKey(int64_t key) const {
+  return partitionPolicy->getNodeIndex(key, nodes.size());
+}
+
+size_t pdb::PDBStoragePageSender::getNumNodes() const {
+  return nodes.size();
+}
+
+bool pdb::PDBStoragePageSender::send(std::string &errMsg) {
+
+  // if there is nothing to send we are done
+  if(pages.empty()) {
+    return true;
+  }
+
+  /// 1. Ask the manager where the pages go if we don't know that yet
+
+  bool unassigned = std::any_of(pages.begin(), pages.end(), [](const PageToSend &page) { return !page.assigned; });
+  if(((!leased || unassigned) && !requestLease(errMsg)) || !checkPages(errMsg)) {
+    logger->error(errMsg);
+    return false;
+  }
+
+  /// 2. Compress the pages in parallel
+
+  auto numThreads = std::min<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), 1), maxSendingThreads);
+  bool success = forEachPage(numThreads, [&](PageToSend &page, std::string &error) {
+
+    // compress the record into a frame
+    auto maxFrameSize = codec->getMaxFrameSize(page.numBytes);
+    page.compressed = std::unique_ptr<char[]>(new char[maxFrameSize]);
+    page.compressedSize = codec->compressFrame(page.bytes, page.numBytes, page.compressed.get(), maxFrameSize);
+
+    // this only happens if the codec can not handle the size
+    if(page.compressedSize == 0) {
+      error = "Could not compress a page with the codec " + codec->getName();
+      return false;
+    }
+
+    return true;
+  }, errMsg);
+
+  // this can not really fail, but check anyway
+  if(!success) {
+    return false;
+  }
+
+  /// 3. Make the requests, so that the sending threads don't have to allocate anything
+
+  for(auto &page : pages) {
+
+    // make the request
+    const UseTemporaryAllocationBlock tempBlock{1024};
+    Handle<StoDispatchData> request = makeObject<StoDispatchData>(db, set, typeName, page.compressedSize, true, leaseID);
+
+    // copy the record
+    auto *record = getRecord(request);
+    page.request = std::vector<char>((char*) record, (char*) record + record->numBytes());
+  }
+
+  /// 4. Send the pages directly to the workers
+
+  // we use a couple of threads for each worker, so that the sending scales with the number of workers
+  numThreads = std::min(nodes.size() * threadsPerWorker, maxSendingThreads);
+  success = forEachPage(numThreads, [&](PageToSend &page, std::string &error) {
+    return sendPage(page, error);
+  }, errMsg);
+
+  // log the error if we failed
+  if(!success) {
+    logger->error(errMsg);
+  }
+
+  return success;
+}
+
+void pdb::PDBStoragePageSender::clear() {
+  pages.clear();
+}
+
+bool pdb::PDBStoragePageSender::requestLease(std::string &errMsg) {
+
+  // the pages we don't know the node of yet, the manager places them by their size
+  std::vector<size_t> unassigned;
+  std::vector<uint64_t> sizes;
+  for(size_t i = 0; i < pages.size(); ++i) {
+    if(!pages[i].assigned) {
+      unassigned.emplace_back(i);
+      sizes.emplace_back(pages[i].numBytes);
+    }
+  }
+
+  // return the previous lease if we requested it, we are getting a new one
+  if(!releaseLease(errMsg)) {
+    return false;
+  }
+
+  // the nodes of the previous lease, if we had one
+  auto previousNodes = std::move(nodes);
+  nodes.clear();
+
+  // ask the manager where we can send the pages
+  bool success = RequestFactory::heapRequest<DisGetIngestLease, DisGetIngestLeaseResult, bool>(
+      logger, port, address, false, 1024 + 2 * sizes.size() * sizeof(uint64_t),
+      [&](Handle<DisGetIngestLeaseResult> result) {
+
+        // did we fail
+        if (result == nullptr) {
+          errMsg = "Could not get an ingest lease for the set (" + db + "," + set + ") from the manager.";
+          return false;
+        }
+
+        // did the manager refuse
+        if (!result->success) {
+          errMsg = "Could not get an ingest lease for the set (" + db + "," + set + ") : " + (std::string) result->error;
+          return false;
+        }
+
+        // we have to return this lease
+        leaseID = result->leaseID;
+        ownsLease = true;
+
+        // copy the nodes
+        for(int i = 0; i < result->nodeAddresses.size(); ++i) {
+          nodes.emplace_back(result->nodeAddresses[i], result->nodePorts[i]);
+        }
+
+        // assign the pages to the nodes the manager picked
+        for(int i = 0; i < result->pageNodes.size() && i < unassigned.size(); ++i) {
+          pages[unassigned[i]].node = result->pageNodes[i];
+          pages[unassigned[i]].assigned = true;
+        }
+
+        // if the set is partitioned make the policy that places the records
+        partitionPolicy = PDBDispatchPartitionPolicy::create(result->partitionType, result->numPartitions, result->partitionBoundaries);
+        partitionKey = partitionPolicy != nullptr ? (std::string) result->partitionKey : "";
+
+        // columnar sets get their pages written column by column
+        columnar = result->containerType == PDB_CATALOG_SET_COLUMNAR_CONTAINER;
+
+        // get the codec the manager wants, if we were not built with it we use snappy, the frame tells the worker
+        std::string codecError;
+        codec = PDBCodec::get(result->codec, codecError);
+        if(codec == nullptr) {
+          logger->warn(codecError + " Using snappy instead.");
+          codec = PDBCodec::get(PDB_SNAPPY_CODEC);
+        }
+
+        return true;
+      }, db, set, typeName, sizes);
+
+  // did we fail, if we could not even connect to the manager there is no error yet
+  if(!success) {
+    if(errMsg.empty()) {
+      errMsg = "Could not get an ingest lease for the set (" + db + "," + set + ") from the manager.";
+    }
+    return false;
+  }
+
+  // the pages that were assigned with the previous lease have to go to the same nodes
+  for(size_t i = 0; i < pages.size() && !previousNodes.empty(); ++i) {
+
+    // skip the pages that were just assigned
+    if(std::binary_search(unassigned.begin(), unassigned.end(), i) || !pages[i].assigned) {
+      continue;
+    }
+
+    // find the node in the new lease
+    auto it = std::find(nodes.begin(), nodes.end(), previousNodes[pages[i].node]);
+    if(it == nodes.end()) {
+      errMsg = "The ingest lease for the set (" + db + "," + set + ") does not cover all the pages.";
+      return false;
+    }
+    pages[i].node = it - nodes.begin();
+  }
+
+  // mark that we have the lease
+  leased = true;
+  return true;
+}
+
+bool pdb::PDBStoragePageSender::releaseLease(std::string &errMsg) {
+
+  // if we did not request a lease there is nothing to return
+  if(!ownsLease) {
+    return true;
+  }
+
+  // we don't have the lease anymore, even if the manager does not hear about it, it expires
+  ownsLease = false;
+  leased = false;
+
+  // return it
+  bool success = RequestFactory::heapRequest<DisReleaseIngestLease, SimpleRequestResult, bool>(
+      logger, port, address, false, 1024,
+      [&](Handle<SimpleRequestResult> result) {
+
+        // did we fail
+        if (result == nullptr || !result->getRes().first) {
+          errMsg = "Could not return the ingest lease for the set (" + db + "," + set + ")" +
+                   (result == nullptr ? "." : " : " + result->getRes().second);
+          return false;
+        }
+
+        return true;
+      }, leaseID);
+
+  // did we fail, if we could not even connect to the manager there is no error yet
+  if(!success && errMsg.empty()) {
+    errMsg = "Could not return the ingest lease for the set (" + db + "," + set + ") to the manager.";
+  }
+
+  return success;
+}
+
+bool pdb::PDBStoragePageSender::checkPages(std::string &errMsg) {
+
+  for(auto &page : pages) {
+
+    // the records of a partitioned set have to be placed by their key
+    if(!page.assigned && isPartitioned()) {
+      errMsg = "The set (" + db + "," + set + ") is partitioned, the pages have to be split by the key of the records.";
+      return false;
+    }
+
+    // every page has to go to a node of the lease
+    if(!page.assigned || page.node >= nodes.size()) {
+      errMsg = "The ingest lease for the set (" + db + "," + set + ") does not cover all the pages.";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool pdb::PDBStoragePageSender::forEachPage(size_t numThreads,
+                                            const std::function<bool(PageToSend &, std::string &)> &function,
+                                            std::string &errMsg) {
+
+  // the next page we want to process and whether we failed
+  std::atomic<size_t> nextPage{0};
+  std::atomic<bool> failed{false};
+  std::mutex m;
+
+  // the loop each thread is running
+  auto loop = [&]() {
+
+    size_t idx;
+    while(!failed && (idx = nextPage++) < pages.size()) {
+
+      // run the function
+      std::string error;
+      bool success;
+      try {
+        success = function(pages[idx], error);
+      }
+      catch (std::exception &e) {
+        success = false;
+        error = e.what();
+      }
+
+      // if we failed store the error, the first one wins
+      if(!success) {
+        std::unique_lock<std::mutex> lck(m);
+        if(!failed) {
+          errMsg = error;
+          failed = true;
+        }
+      }
+    }
+  };
+
+  // start the threads
+  std::vector<std::thread> threads;
+  numThreads = std::max<size_t>(std::min(numThreads, pages.size()), 1);
+  for(size_t i = 0; i < numThreads; ++i) {
+    threads.emplace_back(loop);
+  }
+
+  // wait for them to finish
+  for(auto &thread : threads) {
+    thread.join();
+  }
+
+  return !failed;
+}
+
+bool pdb::PDBStoragePageSender::sendPage(PageToSend &page, std::string &errMsg) {
+
+  // the node we are sending the page to
+  auto &node = nodes[page.node];
+
+  // try multiple times if we fail to connect
+  PDBCommunicatorPtr comm = std::make_shared<PDBCommunicator>();
+  int numRetries = 0;
+  while (!comm->connectToInternetServer(logger, node.second, node.first, errMsg)) {
+
+    // log the error
+    logger->error(errMsg);
+    logger->error("Can not connect to remote server with port=" + std::to_string(node.second) + " and address=" + node.first + ");");
+
+    // if we are out of retries we failed
+    if(++numRetries > maxRetries) {
+      return false;
+    }
+  }
+
+  // send the request we made upfront
+  auto *request = (Record<StoDispatchData> *) page.request.data();
+  if (!comm->sendRecord(request, errMsg)) {
+    return false;
+  }
+
+  // now, send the bytes
+  if (!comm->sendBytes(page.compressed.get(), page.compressedSize, errMsg)) {
+    return false;
+  }
+
+  // did we get a response
+  auto responseSize = comm->getSizeOfNextObject();
+  if (responseSize == 0) {
+    errMsg = "Could not get the response for a page from " + node.first;
+    return false;
+  }
+
+  // read the response, we read it into our own buffer since we can not use the allocator
+  bool success;
+  PooledBuffer response(responseSize);
+  Handle<SimpleRequestResult> result = comm->getNextObject<SimpleRequestResult>(response.get(), success, errMsg);
+
+  // did we get a response
+  if (!success) {
+    return false;
+  }
+
+  // did the worker store the page
+  if (!result->getRes().first) {
+    errMsg = "Error sending data: " + result->getRes().second;
+    return false;
+  }
+
+  // free the compressed bytes, we don't need them anymore
+  page.compressed.reset();
+
+  return true;
+}
@@ -17,6 +17,9 @@
 
 namespace pdb {
 
+// the pages an incremental aggregation aggregated @see PDBStorageManagerBackend
+struct PDBAggregatedPages;
+
 class PDBAggregationPipeAlgorithm : public PDBPhysicalAlgorithm {
 public:
 
@@ -32,7 +35,8 @@ public:
                               const Handle<PDBSourcePageSetSpec> &hashedToRecv,
                               const Handle<PDBSinkPageSetSpec> &sink,
                               const std::vector<pdb::Handle<PDBSourcePageSetSpec>> &secondarySources,
-                              const pdb::Handle<pdb::Vector<PDBSetObject>> &setsToMaterialize);
+                              const pdb::Handle<pdb::Vector<PDBSetObject>> &setsToMaterialize,
+                              bool local = false);
 
   bool setup(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage, Handle<pdb::ExJob> &job, const std::string &error) override;
 
@@ -52,8 +56,29 @@ public:
    */
   PDBCatalogSetContainerType getOutputContainerType() override;
 
+  /**
+   * Returns true if the records with the same key are all on the same node so the aggregation does not send them
+   * @return true if it is local
+   */
+  bool isLocal();
+
  private:
 
+  /**
+   * Returns the set an incremental aggregation writes its output to, it has exactly one
+   * @return the set
+   */
+  std::pair<std::string, std::string> getIncrementalOutputSet();
+
+  /**
+   * Writes the output of an incremental aggregation and removes the one it replaces only once it is written, so if we
+   * fail the old output is still there as it was
+   * @param storage - the storage of the node
+   * @param sinkPageSet - the page set with the output
+   * @return true if it succeeds false otherwise
+   */
+  bool materializeIncrementalOutput(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage, const PDBAbstractPageSetPtr &sinkPageSet);
+
   /**
    * The sink tuple set where we are putting stuff
    */
@@ -64,6 +89,12 @@ public:
    */
   pdb::Handle<PDBSourcePageSetSpec> hashedToRecv;
 
+  /**
+   * True if the records with the same key are all on the same node, in that case the preaggregated pages are not sent
+   * to the other nodes
+   */
+  bool local = false;
+
   /**
    * This forwards the preaggregated pages to this node
    */
@@ -90,11 +121,23 @@ public:
    */
   std::shared_ptr<std::vector<PDBPageQueuePtr>> pageQueues = nullptr;
 
+  /**
+   * The generation of the output if the aggregation is incremental, 0 otherwise @see ExJob::incrementalGeneration
+   */
+  uint64_t incrementalGeneration = 0;
+
+  /**
+   * The pages of the input the output has once it is written, if the aggregation is incremental and scans a set.
+   * This must be null when sending this object.
+   */
+  std::shared_ptr<PDBAggregatedPages> aggregatedPages = nullptr;
+
 
   // mark the tests that are testing this algorithm
   FRIEND_TEST(TestPhysicalOptimizer, TestAggregation);
   FRIEND_TEST(TestPhysicalOptimizer, TestMultiSink);
   FRIEND_TEST(TestPhysicalOptimizer, TestAggregationAfterTwoWayJoin);
+  FRIEND_TEST(TestPhysicalOptimizer, TestCoPartitionedAggregation);
 };
 
 }
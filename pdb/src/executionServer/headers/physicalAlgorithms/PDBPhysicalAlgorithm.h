@@ -17,6 +17,10 @@
 #include <SourceSetArg.h>
 #include <PDBVector.h>
 #include <JoinArguments.h>
+#include <PipelineInterface.h>
+#include <PDBPageSelfReceiver.h>
+#include <PDBPageNetworkSender.h>
+#include <PDBProfile.h>
 #include <PDBSourceSpec.h>
 #include <gtest/gtest_prod.h>
 #include <physicalOptimizer/PDBPrimarySource.h>
@@ -101,19 +105,126 @@ public:
     return std::move(tmp);
   }
 
+  /**
+   * Returns the page sets this algorithm reads, the ones of the sources and the secondary sources like the hash sets of a join
+   * @return the identifiers of the page sets
+   */
+  std::vector<std::pair<size_t, std::string>> getPageSetsToConsume() {
+
+    std::vector<std::pair<size_t, std::string>> tmp;
+    for(int i = 0; i < sources.size(); ++i) {
+
+      // if the source is a page set store it
+      if(sources[i].pageSet != nullptr) {
+        tmp.emplace_back(sources[i].pageSet->pageSetIdentifier.first, sources[i].pageSet->pageSetIdentifier.second);
+      }
+    }
+
+    // add the secondary sources
+    if(secondarySources != nullptr) {
+      for(int i = 0; i < secondarySources->size(); ++i) {
+        tmp.emplace_back((*secondarySources)[i]->pageSetIdentifier.first, (*secondarySources)[i]->pageSetIdentifier.second);
+      }
+    }
+
+    return std::move(tmp);
+  }
+
+  /**
+   * Returns the page sets the pipelines of the algorithm start with, the ones of the primary sources
+   * @return the identifiers of the page sets
+   */
+  std::vector<std::pair<size_t, std::string>> getPageSetsToScan() {
+
+    std::vector<std::pair<size_t, std::string>> tmp;
+    for(int i = 0; i < sources.size(); ++i) {
+      if(sources[i].pageSet != nullptr) {
+        tmp.emplace_back(sources[i].pageSet->pageSetIdentifier.first, sources[i].pageSet->pageSetIdentifier.second);
+      }
+    }
+
+    return std::move(tmp);
+  }
+
+  /**
+   * Marks a page set the pipelines of the algorithm start with as streamed, they read its pages while its producer runs
+   * @param pageSet - the identifier of the page set
+   */
+  void streamSource(const std::pair<size_t, std::string> &pageSet) {
+
+    for(int i = 0; i < sources.size(); ++i) {
+      if(sources[i].pageSet != nullptr &&
+         sources[i].pageSet->pageSetIdentifier.first == pageSet.first &&
+         sources[i].pageSet->pageSetIdentifier.second == pageSet.second) {
+        sources[i].pageSet->streamed = true;
+      }
+    }
+  }
+
+  /**
+   * Returns true if the algorithm can hand over the pages of its page set as it makes them @see streamOutput
+   */
+  virtual bool canStreamOutput() { return false; }
+
+  /**
+   * Marks the page set the algorithm produces as streamed, the pages are handed over as they are made
+   */
+  void streamOutput() {
+    if(sink != nullptr) {
+      sink->streamed = true;
+    }
+  }
+
+  /**
+   * Returns the number of primary sources, each one needs at least one thread
+   */
+  size_t getNumSources() {
+    return sources.size();
+  }
+
+  /**
+   * Returns the tuple set the pipelines of the algorithm end with
+   */
+  std::string getFinalTupleSet() {
+    return finalTupleSet;
+  }
+
+  /**
+   * Returns the page set this algorithm produces, the one of the sink
+   * @return the identifier of the page set
+   */
+  std::pair<size_t, std::string> getPageSetToProduce() {
+
+    // if we don't have a sink we don't produce anything
+    if(sink == nullptr) {
+      return std::make_pair(0, "");
+    }
+
+    return std::make_pair(sink->pageSetIdentifier.first, (std::string) sink->pageSetIdentifier.second);
+  }
+
   /**
    * Returns the type of the container that the materialized result will have
    */
   virtual pdb::PDBCatalogSetContainerType getOutputContainerType() { return PDB_CATALOG_SET_NO_CONTAINER; };
 
+  /**
+   * Returns the profile of the last run of the algorithm, the pipelines, page senders and receivers it ran
+   * @return the profile, null if the algorithm did not run
+   */
+  const PDBProfilePtr &getProfile() { return profile; }
+
 protected:
 
   /**
-   * Returns the source page set we are scanning.
+   * Returns the source page set we are scanning. If the job runs on a single node and gathers the sets, the pages of a
+   * set are fetched from all the workers, otherwise we only scan the pages stored on this node.
    * @param storage - a ptr to the storage manager backend so we can grab the page set
-   * @return - the page set
+   * @param job - the job we are running
+   * @param idx - the index of the source
+   * @return - the page set, null if we could not get it
    */
-  PDBAbstractPageSetPtr getSourcePageSet(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage, size_t idx);
+  PDBAbstractPageSetPtr getSourcePageSet(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage, Handle<pdb::ExJob> &job, size_t idx);
 
   /**
    * Return the info that is going to be provided to the pipeline about the main source set we are scanning
@@ -129,6 +240,29 @@ protected:
    */
   std::shared_ptr<JoinArguments> getJoinArguments(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage);
 
+  /**
+   * Logs the stats of a pipeline that finished running, how many tuples it retried, the tuple set sizes it
+   * has chosen, how many times it failed to process a tuple set and how many bytes its source read
+   * @param idx - the index of the pipeline
+   * @param pipeline - the pipeline
+   */
+  void logPipelineStats(size_t idx, const PipelinePtr &pipeline);
+
+  /**
+   * Adds the profile of a pipeline that finished running to the profile of the algorithm, can be called from
+   * multiple threads
+   * @param pipeline - the pipeline
+   */
+  void profilePipeline(const PipelinePtr &pipeline);
+
+  /**
+   * Adds the stats of the self receiver and the network senders to the profile of the algorithm, once they are done
+   * @param selfReceiver - the self receiver, can be null
+   * @param senders - the senders, can be null
+   */
+  void profilePageForwarding(const PDBPageSelfReceiverPtr &selfReceiver,
+                             const std::shared_ptr<std::vector<PDBPageNetworkSenderPtr>> &senders);
+
   /**
    *
    */
@@ -164,6 +298,11 @@ protected:
    */
   PDBLoggerPtr logger;
 
+  /**
+   * The profile of the last run, made when the algorithm starts running
+   */
+  PDBProfilePtr profile = nullptr;
+
   // mark the tests that are testing this algorithm
   FRIEND_TEST(TestPhysicalOptimizer, TestAggregation);
   FRIEND_TEST(TestPhysicalOptimizer, TestJoin1);
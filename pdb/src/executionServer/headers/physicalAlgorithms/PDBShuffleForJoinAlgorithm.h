@@ -21,7 +21,8 @@ public:
                              const pdb::Handle<pdb::PDBSinkPageSetSpec> &intermediate,
                              const pdb::Handle<pdb::PDBSinkPageSetSpec> &sink,
                              const std::vector<pdb::Handle<PDBSourcePageSetSpec>> &secondarySources,
-                             const pdb::Handle<pdb::Vector<PDBSetObject>> &setsToMaterialize);
+                             const pdb::Handle<pdb::Vector<PDBSetObject>> &setsToMaterialize,
+                             bool local = false);
 
   ENABLE_DEEP_COPY
 
@@ -73,9 +74,16 @@ public:
    */
   pdb::Handle<PDBSinkPageSetSpec> intermediate;
 
+  /**
+   * True if the records that join are all on the same node, in that case the records are not split by node and the
+   * hashed pages go straight to this node
+   */
+  bool local = false;
+
   FRIEND_TEST(TestPhysicalOptimizer, TestJoin2);
   FRIEND_TEST(TestPhysicalOptimizer, TestJoin3);
   FRIEND_TEST(TestPhysicalOptimizer, TestAggregationAfterTwoWayJoin);
+  FRIEND_TEST(TestPhysicalOptimizer, TestCoPartitionedJoin);
 };
 
 }
\ No newline at end of file
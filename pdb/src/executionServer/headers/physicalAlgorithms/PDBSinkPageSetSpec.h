@@ -35,6 +35,11 @@ public:
    * but relying on that is considered bad practice
    */
   std::pair<size_t, pdb::String> pageSetIdentifier;
+
+  /**
+   * Is the page set read while we make it, then the pages we are done with are also fed to the stream
+   */
+  bool streamed = false;
 };
 
 }
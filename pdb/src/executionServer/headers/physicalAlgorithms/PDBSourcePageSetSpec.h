@@ -32,6 +32,11 @@ public:
    * but relying on that is considered bad practice
    */
   std::pair<size_t, pdb::String> pageSetIdentifier;
+
+  /**
+   * Is the page set read while the algorithm that produces it runs, then we get its pages from the stream
+   */
+  bool streamed = false;
 };
 
 }
\ No newline at end of file
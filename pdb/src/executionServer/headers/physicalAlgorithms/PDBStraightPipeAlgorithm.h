@@ -61,6 +61,12 @@ public:
    */
   PDBCatalogSetContainerType getOutputContainerType() override;
 
+  /**
+   * The pages of the sink are done once the pipeline writes them out, so they can be handed over right away
+   * @return true
+   */
+  bool canStreamOutput() override { return true; }
+
  private:
 
   /**
@@ -69,6 +75,12 @@ public:
    */
   std::shared_ptr<std::vector<PipelinePtr>> myPipelines = nullptr;
 
+  /**
+   * The stream the pages of the sink are fed to if the sink is streamed, made in setup.
+   * This must be null when sending this object.
+   */
+  PDBStreamingPageSetPtr streamingPageSet = nullptr;
+
 
   FRIEND_TEST(TestPhysicalOptimizer, TestJoin3);
   FRIEND_TEST(TestPhysicalOptimizer, TestTwoSinksSelection);
@@ -7,8 +7,12 @@
 #include "PDBStorageManagerBackend.h"
 #include "SimpleRequestResult.h"
 #include "ExRunJob.h"
+#include "ExRunJobResult.h"
+#include "PDBTracer.h"
 #include "ExJob.h"
 #include "SharedEmployee.h"
+#include "PDBBufferManagerInterface.h"
+#include "PDBPinQuotas.h"
 
 void pdb::ExecutionServerBackend::registerHandlers(pdb::PDBServer &forMe) {
 
@@ -19,6 +23,9 @@ void pdb::ExecutionServerBackend::registerHandlers(pdb::PDBServer &forMe) {
 
             std::string error;
 
+            // the events we record from now on belong to this job
+            auto traceStart = PDBTracer::now();
+
             /// 1. Do the setup
 
             // setup an allocation block of the size of the compute plan + 1MB so we can do the setup and build the pipeline
@@ -27,8 +34,26 @@ void pdb::ExecutionServerBackend::registerHandlers(pdb::PDBServer &forMe) {
             // grab the storage manager
             auto storage = this->getFunctionalityPtr<PDBStorageManagerBackend>();
 
-            // setup the algorithm
-            bool success = request->physicalAlgorithm->setup(storage, request, error);
+            // the pages the job pins are charged to the computation, once it uses up its budget the pins block
+            auto bufferManager = this->getFunctionalityPtr<PDBBufferManagerInterface>();
+            bufferManager->registerPinOwner(request->computationID, request->memoryBudget);
+            const PDBPinOwnerScope pinScope{request->computationID};
+
+            // the events this thread and the threads it gives work to record are tagged with the job
+            const PDBTraceJobScope traceScope{request->computationID, request->jobID};
+
+            // setup the algorithm, we measure how long it takes since a job has to do it every time it is run
+            auto setupStart = PDBOperatorTimer::getWallTime();
+            bool success;
+            try {
+              success = request->physicalAlgorithm->setup(storage, request, error);
+            } catch (std::runtime_error &e) {
+
+              // the plan of the job could not be made, the manager cleans up the job like any other failed setup
+              success = false;
+              error = e.what();
+            }
+            auto setupTime = PDBOperatorTimer::getWallTime() - setupStart;
 
             // create an allocation block to hold the response
             pdb::Handle<pdb::SimpleRequestResult> response = pdb::makeObject<pdb::SimpleRequestResult>(success, error);
@@ -46,6 +71,7 @@ void pdb::ExecutionServerBackend::registerHandlers(pdb::PDBServer &forMe) {
 
                 // cleanup the algorithm
                 request->physicalAlgorithm->cleanup();
+                bufferManager->unregisterPinOwner(request->computationID);
 
                 // we are done here does not work
                 return make_pair(true, error); // TODO different error message if result->shouldRun is false?
@@ -53,13 +79,53 @@ void pdb::ExecutionServerBackend::registerHandlers(pdb::PDBServer &forMe) {
             }
 
             // run the algorithm
-            request->physicalAlgorithm->run(storage);
+            success = request->physicalAlgorithm->run(storage);
 
-            // sends result to requester
-            sendUsingMe->sendObject(response, error);
+            /// 3. Send the result of the run with the profile of the algorithm and the events we recorded
+
+            {
+              // grab the events, there are none if tracing is disabled
+              auto traceEvents = PDBTracer::collect(traceStart, request->computationID, request->jobID);
+
+              // add the setup to the profile of the algorithm
+              auto &profile = request->physicalAlgorithm->getProfile();
+              if(profile != nullptr) {
+                PDBOperatorStats setupStats;
+                setupStats.numInstances = 1;
+                setupStats.wallTime = setupTime;
+                setupStats.maxWallTime = setupTime;
+                profile->add({ "setup" }, setupStats);
+              }
+
+              // make an allocation block that can fit the profile and the events
+              const UseTemporaryAllocationBlock resultBlock{(profile != nullptr ? profile->getVectorSize() : 1024) + PDBTracer::getTraceSize(traceEvents)};
+
+              // make the result and put the profile in it
+              Handle<ExRunJobResult> runResult = makeObject<ExRunJobResult>(success, error);
+              if(profile != nullptr) {
+                profile->toVector(runResult->profile);
+              }
+
+              // the manager needs the size of the page set we produced if it wants to keep it
+              auto producedPageSet = storage->getPageSet(request->physicalAlgorithm->getPageSetToProduce());
+              if(producedPageSet != nullptr) {
+                runResult->pageSetSize = producedPageSet->getSize();
+              }
+
+              // put the events in it
+              if(!traceEvents.empty()) {
+                Handle<PDBTrace> trace = makeObject<PDBTrace>("backend");
+                PDBTracer::toTrace(traceEvents, *trace);
+                runResult->traces.push_back(trace);
+              }
+
+              // sends result to requester
+              sendUsingMe->sendObject(runResult, error);
+            }
 
             // cleanup the algorithm
             request->physicalAlgorithm->cleanup();
+            bufferManager->unregisterPinOwner(request->computationID);
 
             // just finish
             return make_pair(true, error);
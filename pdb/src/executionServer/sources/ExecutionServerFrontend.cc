@@ -10,6 +10,9 @@
 #include <boost/filesystem/path.hpp>
 #include "ExecutionServerFrontend.h"
 #include "SimpleRequestResult.h"
+#include "ExRunJobResult.h"
+#include "PDBProfile.h"
+#include "PDBTracer.h"
 
 void pdb::ExecutionServerFrontend::registerHandlers(pdb::PDBServer &forMe) {
 
@@ -21,6 +24,10 @@ void pdb::ExecutionServerFrontend::registerHandlers(pdb::PDBServer &forMe) {
             // this is where we put the error
             std::string error;
 
+            // the events we record from now on belong to this job
+            auto traceStart = PDBTracer::now();
+            const PDBTraceJobScope traceScope{request->computationID, request->jobID};
+
             // we will use 2 kb just to make sure there is enough space for the requests
             const UseTemporaryAllocationBlock tempBlock{2 * 1024};
 
@@ -118,39 +125,66 @@ void pdb::ExecutionServerFrontend::registerHandlers(pdb::PDBServer &forMe) {
             if(!success) {
 
               // we failed to send a response
-              response = pdb::makeObject<pdb::SimpleRequestResult>(false, error);
+              Handle<ExRunJobResult> runResult = pdb::makeObject<ExRunJobResult>(false, error);
 
               // sends result to requester
-              sendUsingMe->sendObject(response, error);
+              sendUsingMe->sendObject(runResult, error);
 
               // return error
               return std::make_pair(false, error);
             }
 
-            /// 7. Wait for the backend to respond
+            /// 7. Wait for the backend to respond, the response has the profile of the run so we forward it as it is
 
-            success = RequestFactory::waitHeapRequest<SimpleRequestResult, bool>(logger, communicatorToBackend, false,
-              [&](Handle<SimpleRequestResult> result) {
+            bool forwarded = false;
+            success = RequestFactory::waitHeapRequest<ExRunJobResult, bool>(logger, communicatorToBackend, false,
+              [&](Handle<ExRunJobResult> result) {
 
                 // check the result
-                if (result != nullptr && result->getRes().first) {
-                  return true;
+                if (result == nullptr) {
+                  error = "Error response from distributed-storage: no result";
+                  return false;
                 }
 
-                // log the error
-                error = "Error response from distributed-storage: " + result->getRes().second;
-                logger->error("Error response from distributed-storage: " + result->getRes().second);
+                // log the error if we have one
+                if (!result->success) {
+                  error = "Error response from distributed-storage: " + std::string(result->error);
+                  logger->error(error);
+                }
 
-                return false;
+                // grab the events of this process, the buffer manager runs here, there are none if tracing is disabled
+                auto traceEvents = PDBTracer::collect(traceStart, request->computationID, request->jobID);
+
+                // make an allocation block that can fit the result and our events
+                auto resultSize = PDBProfile::getVectorSize(result->profile) + PDBTracer::getTraceSize(traceEvents);
+                for (size_t i = 0; i < result->traces.size(); ++i) {
+                  resultSize += PDBTracer::getTraceSize(*result->traces[i]);
+                }
+                const UseTemporaryAllocationBlock resultBlock{resultSize};
+
+                // copy the result and add our events to it
+                Handle<ExRunJobResult> forward = deepCopyToCurrentAllocationBlock<ExRunJobResult>(result);
+                if (!traceEvents.empty()) {
+                  Handle<PDBTrace> trace = makeObject<PDBTrace>("frontend");
+                  PDBTracer::toTrace(traceEvents, *trace);
+                  forward->traces.push_back(trace);
+                }
+
+                // forward the result to the computation server
+                forwarded = sendUsingMe->sendObject(forward, error);
+                return (bool) result->success;
               });
 
-            /// 8. Send the response back the computation
+            /// 8. If we did not get a response send the error back to the computation server
 
-            // create the response
-            response = pdb::makeObject<pdb::SimpleRequestResult>(success, error);
+            if (!forwarded) {
 
-            // sends result to requester
-            sendUsingMe->sendObject(response, error);
+              // create the response
+              Handle<ExRunJobResult> runResult = pdb::makeObject<ExRunJobResult>(false, error);
+
+              // sends result to requester
+              sendUsingMe->sendObject(runResult, error);
+            }
 
             // we are done here does not work
             return make_pair(success, error);
@@ -3,12 +3,14 @@
 //
 
 #include <SourceSetArg.h>
+#include <PDBPlanCache.h>
 #include <PDBCatalogClient.h>
 #include "ComputePlan.h"
 #include "ExJob.h"
 #include "PDBAggregationPipeAlgorithm.h"
 #include "PDBStorageManagerBackend.h"
 #include "GenericWork.h"
+#include "AggregationPipeline.h"
 
 pdb::PDBAggregationPipeAlgorithm::PDBAggregationPipeAlgorithm(const std::vector<PDBPrimarySource> &primarySource,
                                                               const AtomicComputationPtr &finalAtomicComputation,
@@ -16,14 +18,15 @@ pdb::PDBAggregationPipeAlgorithm::PDBAggregationPipeAlgorithm(const std::vector<
                                                               const Handle<PDBSourcePageSetSpec> &hashedToRecv,
                                                               const Handle<PDBSinkPageSetSpec> &sink,
                                                               const std::vector<pdb::Handle<PDBSourcePageSetSpec>> &secondarySources,
-                                                              const pdb::Handle<pdb::Vector<PDBSetObject>> &setsToMaterialize)
+                                                              const pdb::Handle<pdb::Vector<PDBSetObject>> &setsToMaterialize,
+                                                              bool local)
 
-    : PDBPhysicalAlgorithm(primarySource, finalAtomicComputation, sink, secondarySources, setsToMaterialize), hashedToSend(hashedToSend), hashedToRecv(hashedToRecv) {}
+    : PDBPhysicalAlgorithm(primarySource, finalAtomicComputation, sink, secondarySources, setsToMaterialize), hashedToSend(hashedToSend), hashedToRecv(hashedToRecv), local(local) {}
 
 bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage, Handle<pdb::ExJob> &job, const std::string &error) {
 
   // init the plan
-  ComputePlan plan(std::make_shared<LogicalPlan>(job->tcap, *job->computations));
+  ComputePlan plan(PDBPlanCache::get().getLogicalPlan(job->tcap, job->computations, job->computationSize));
   logicalPlan = plan.getPlan();
 
   // get the buffer manager
@@ -45,11 +48,49 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
 
   /// 2. Init the preaggregation queues
 
+  // if the aggregation is local the pages for every node go to the same queue, since the records are already on the right node
   pageQueues = std::make_shared<std::vector<PDBPageQueuePtr>>();
-  for(int i = 0; i < job->numberOfNodes; ++i) { pageQueues->emplace_back(std::make_shared<PDBPageQueue>()); }
+  auto localQueue = std::make_shared<PDBPageQueue>();
+  for(int i = 0; i < job->numberOfNodes; ++i) { pageQueues->emplace_back(local ? localQueue : std::make_shared<PDBPageQueue>()); }
 
 
-  /// 3. Initialize the sources
+  /// 3. If the aggregation is incremental figure out what it already aggregated on this node
+
+  incrementalGeneration = job->incrementalGeneration;
+  PDBAggregatedPages previous;
+  if(incrementalGeneration != 0) {
+
+    // the output of an incremental aggregation is replaced, so it has to be written to exactly one set
+    if(setsToMaterialize->size() != 1) {
+      logger->error("An incremental aggregation has to write its output to exactly one set.");
+      return false;
+    }
+
+    // we know what pages of the input are in the output only if we scan a set that is on this node
+    bool scansSet = sources.size() == 1 && sources[0].sourceSet != nullptr && !job->gatherSets;
+    auto inputSet = scansSet ? std::make_pair<std::string, std::string>(sources[0].sourceSet->database, sources[0].sourceSet->set) :
+                               std::make_pair<std::string, std::string>("", "");
+
+    // we can only merge into the output of the generation right before this one, made with the same threads
+    previous = storage->getAggregatedPages(getIncrementalOutputSet());
+    if(incrementalGeneration > 1 && (!scansSet || local || previous.generation != incrementalGeneration - 1 || previous.inputSet != inputSet ||
+                                     previous.outputPages.size() != job->numberOfProcessingThreads)) {
+      logger->error("The output of the incremental aggregation on this node is not at the generation " + std::to_string(incrementalGeneration - 1));
+      return false;
+    }
+
+    // the first generation aggregates the whole input, the ones after it start from what is already in the output
+    if(scansSet) {
+      aggregatedPages = std::make_shared<PDBAggregatedPages>();
+      aggregatedPages->generation = incrementalGeneration;
+      aggregatedPages->inputSet = inputSet;
+      if(incrementalGeneration > 1) {
+        aggregatedPages->pages = previous.pages;
+      }
+    }
+  }
+
+  /// 4. Initialize the sources
 
   // we put them here
   std::vector<PDBAbstractPageSetPtr> sourcePageSets;
@@ -57,13 +98,26 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
 
   // initialize them
   for(int i = 0; i < sources.size(); i++) {
-    sourcePageSets.emplace_back(getSourcePageSet(storage, i));
+
+    // an incremental aggregation reads only the pages of the set that are not in its output yet
+    if(aggregatedPages != nullptr) {
+
+      auto newPages = storage->createPageSetFromPDBSet(aggregatedPages->inputSet.first, aggregatedPages->inputSet.second, aggregatedPages->pages);
+      if(newPages != nullptr) {
+        aggregatedPages->pages.insert(newPages->getPageNumbers().begin(), newPages->getPageNumbers().end());
+      }
+
+      sourcePageSets.emplace_back(newPages);
+      continue;
+    }
+
+    sourcePageSets.emplace_back(getSourcePageSet(storage, job, i));
   }
 
-  /// 4. Initialize all the pipelines
+  /// 5. Initialize all the pipelines
 
-  // get the number of worker threads from this server's config
-  int32_t numWorkers = storage->getConfiguration()->numThreads;
+  // get the number of worker threads, the share of the threads of this server the computation got
+  int32_t numWorkers = (int32_t) job->numberOfProcessingThreads;
 
   // check that we have at least one worker per primary source
   if(numWorkers < sources.size()) {
@@ -74,7 +128,7 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
   preaggregationPipelines = std::make_shared<std::vector<PipelinePtr>>();
   for (uint64_t pipelineIndex = 0; pipelineIndex < job->numberOfProcessingThreads; ++pipelineIndex) {
 
-    /// 4.1. Figure out the source page set
+    /// 5.1. Figure out the source page set
 
     // figure out what pipeline
     auto pipelineSource = pipelineIndex % sources.size();
@@ -94,7 +148,7 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
       return false;
     }
 
-    /// 4.2. Figure out the parameters of the pipeline
+    /// 5.2. Figure out the parameters of the pipeline
 
     // figure out the join arguments
     auto joinArguments = getJoinArguments (storage);
@@ -116,7 +170,7 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
                                                          { ComputeInfoType::SHUFFLE_JOIN_ARG, std::make_shared<ShuffleJoinArg>(swapLHSandRHS) },
                                                          { ComputeInfoType::SOURCE_SET_INFO, getSourceSetArg(catalogClient, pipelineSource)}} ;
 
-    /// 4.3. Build the pipeline
+    /// 5.3. Build the pipeline
 
     auto pipeline = plan.buildPipeline(firstTupleSet, /* this is the TupleSet the pipeline starts with */
                                        finalTupleSet,     /* this is the TupleSet the pipeline ends with */
@@ -131,7 +185,7 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
     preaggregationPipelines->push_back(pipeline);
   }
 
-  /// 5. Create the sink
+  /// 6. Create the sink
 
   // get the sink page set
   auto sinkPageSet = storage->createAnonymousPageSet(std::make_pair(sink->pageSetIdentifier.first, sink->pageSetIdentifier.second));
@@ -141,23 +195,29 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
     return false;
   }
 
-  /// 6. Create the page set that contains the preaggregated pages for this node
+  /// 7. Create the page set that contains the preaggregated pages for this node
 
-  // get the receive page set
+  // get the receive page set, if the aggregation is local only this node is feeding it
   auto recvPageSet = storage->createFeedingAnonymousPageSet(std::make_pair(hashedToRecv->pageSetIdentifier.first, hashedToRecv->pageSetIdentifier.second),
                                                             job->numberOfProcessingThreads,
-                                                            job->numberOfNodes);
+                                                            local ? 1 : job->numberOfNodes);
 
   // did we manage to get a page set where we receive this? if not the setup failed
   if(recvPageSet == nullptr) {
     return false;
   }
 
-  /// 7. Create the self receiver to forward pages that are created on this node and the network senders to forward pages for the other nodes
+  /// 8. Create the self receiver to forward pages that are created on this node and the network senders to forward pages for the other nodes
 
   senders = std::make_shared<std::vector<PDBPageNetworkSenderPtr>>();
   for(unsigned i = 0; i < job->nodes.size(); ++i) {
 
+    // if the aggregation is local we just need the self receiver for the shared queue
+    if(local) {
+      selfReceiver = std::make_shared<pdb::PDBPageSelfReceiver>(localQueue, recvPageSet, myMgr);
+      break;
+    }
+
     // check if it is this node or another node
     if(job->nodes[i]->port == job->thisNode->port && job->nodes[i]->address == job->thisNode->address) {
 
@@ -166,6 +226,10 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
     }
     else {
 
+      // the codec we compress the pages we send with
+      std::string codecError;
+      auto codec = PDBCodec::get(storage->getConfiguration()->shuffleCodec, codecError);
+
       // make the sender
       auto sender = std::make_shared<PDBPageNetworkSender>(job->nodes[i]->address,
                                                            job->nodes[i]->port,
@@ -174,7 +238,8 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
                                                            storage->getConfiguration()->maxRetries,
                                                            logger,
                                                            std::make_pair(hashedToRecv->pageSetIdentifier.first, hashedToRecv->pageSetIdentifier.second),
-                                                           pageQueues->at(i));
+                                                           pageQueues->at(i),
+                                                           codec);
 
       // setup the sender, if we fail return false
       if(!sender->setup()) {
@@ -186,13 +251,35 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
     }
   }
 
-  /// 8. Create the aggregation pipeline
+  /// 9. Create the aggregation pipeline
+
+  // the index of this node, the preaggregation sends the keys of the partition (node * threads + worker) to the worker
+  uint64_t nodeIndex = 0;
+  while(nodeIndex < job->nodes.size() && (job->nodes[nodeIndex]->port != job->thisNode->port ||
+                                          job->nodes[nodeIndex]->address != job->thisNode->address)) { nodeIndex++; }
 
   aggregationPipelines = std::make_shared<std::vector<PipelinePtr>>();
   for (uint64_t workerID = 0; workerID < job->numberOfProcessingThreads; ++workerID) {
 
-    // build the aggregation pipeline
-    auto aggPipeline = plan.buildAggregationPipeline(finalTupleSet, recvPageSet, sinkPageSet, workerID);
+    // build the aggregation pipeline, if the aggregation is incremental it merges into the output it already has
+    PipelinePtr aggPipeline;
+    if(incrementalGeneration > 1) {
+
+      // the worker reads just the page of the output the worker with the same id wrote, it has the keys of its partition
+      auto outputSet = getIncrementalOutputSet();
+      auto existingOutput = storage->createPageSetFromPDBSetPages(outputSet.first, outputSet.second, { previous.outputPages[workerID] });
+
+      aggPipeline = plan.buildAggregationPipeline(finalTupleSet,
+                                                  recvPageSet,
+                                                  sinkPageSet,
+                                                  existingOutput,
+                                                  nodeIndex * job->numberOfProcessingThreads + workerID,
+                                                  job->numberOfNodes * job->numberOfProcessingThreads,
+                                                  workerID);
+    }
+    else {
+      aggPipeline = plan.buildAggregationPipeline(finalTupleSet, recvPageSet, sinkPageSet, workerID);
+    }
 
     // store the aggregation pipeline
     aggregationPipelines->push_back(aggPipeline);
@@ -203,6 +290,9 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
 
 bool pdb::PDBAggregationPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage) {
 
+  // start a new profile for this run
+  profile = std::make_shared<PDBProfile>();
+
   // success indicator
   atomic_bool success;
   success = true;
@@ -236,6 +326,9 @@ bool pdb::PDBAggregationPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManage
 
         // run the pipeline
         (*aggregationPipelines)[workerID]->run();
+
+        // add the profile of the merge to the profile of the algorithm
+        this->profilePipeline((*aggregationPipelines)[workerID]);
       }
       catch (std::exception &e) {
 
@@ -361,6 +454,12 @@ bool pdb::PDBAggregationPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManage
 
         // run the pipeline
         (*preaggregationPipelines)[workerID]->run();
+
+        // report how many tuples the pipeline had to process again and what tuple set sizes it used
+        this->logPipelineStats(workerID, (*preaggregationPipelines)[workerID]);
+
+        // add the profile of the pipeline to the profile of the algorithm
+        this->profilePipeline((*preaggregationPipelines)[workerID]);
       }
       catch (std::exception &e) {
 
@@ -386,8 +485,11 @@ bool pdb::PDBAggregationPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManage
     preaggBuzzer->wait();
   }
 
-  // ok they have finished now push a null page to each of the preagg queues
-  for(auto &queue : *pageQueues) { queue->enqueue(nullptr); }
+  // ok they have finished now push a null page to each of the preagg queues, if we are local they are all the same queue
+  for(auto &queue : *pageQueues) {
+    queue->enqueue(nullptr);
+    if(local) { break; }
+  }
 
   // wait while we are running the receiver
   while(selfRecDone == 0) {
@@ -399,6 +501,9 @@ bool pdb::PDBAggregationPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManage
     sendersBuzzer->wait();
   }
 
+  // the receiver and the senders are done, profile them
+  profilePageForwarding(selfReceiver, senders);
+
   // wait until all the aggregation pipelines have completed
   while (aggCounter < aggregationPipelines->size()) {
     aggBuzzer->wait();
@@ -418,12 +523,24 @@ bool pdb::PDBAggregationPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManage
       break;
     }
 
+    // the output of an incremental aggregation replaces the one it has since it was merged into the new one, if we
+    // failed we keep the old one and the next generation starts from scratch
+    if(incrementalGeneration != 0) {
+      success = success && materializeIncrementalOutput(storage, sinkPageSet);
+      break;
+    }
+
     // materialize the page set
     sinkPageSet->resetPageSet();
     success = storage->materializePageSet(sinkPageSet, std::make_pair<std::string, std::string>((*setsToMaterialize)[j].database, (*setsToMaterialize)[j].set)) && success;
   }
 
-  return true;
+  // the output has the pages we aggregated, the next generation aggregates just the ones added after them
+  if(aggregatedPages != nullptr && success) {
+    storage->setAggregatedPages(getIncrementalOutputSet(), *aggregatedPages);
+  }
+
+  return success;
 }
 
 
@@ -438,6 +555,58 @@ void pdb::PDBAggregationPipeAlgorithm::cleanup() {
   preaggregationPipelines = nullptr;
   aggregationPipelines = nullptr;
   pageQueues = nullptr;
+  aggregatedPages = nullptr;
+}
+
+bool pdb::PDBAggregationPipeAlgorithm::materializeIncrementalOutput(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage,
+                                                                  const PDBAbstractPageSetPtr &sinkPageSet) {
+
+  // write the new output next to the old one
+  auto outputSet = getIncrementalOutputSet();
+  std::map<uint64_t, uint64_t> setPages;
+  sinkPageSet->resetPageSet();
+  bool success = storage->materializePageSet(sinkPageSet, outputSet, &setPages);
+
+  // the pages of the set we wrote and how much they take
+  std::vector<uint64_t> written;
+  uint64_t writtenSize = 0;
+  PDBPageHandle page;
+  sinkPageSet->resetPageSet();
+  while((page = sinkPageSet->getNextPage(0)) != nullptr) {
+    auto it = setPages.find(page->whichPage());
+    if(it != setPages.end()) {
+      written.emplace_back(it->second);
+      writtenSize += page->getSize();
+    }
+  }
+
+  // if we failed we remove what we wrote so the old output is whole, otherwise we remove everything else
+  if(!success) {
+    storage->removeSetPages(outputSet, written, false, writtenSize);
+    return false;
+  }
+  if(!storage->removeSetPages(outputSet, written, true, writtenSize)) {
+    return false;
+  }
+
+  // the next generation gives every worker just the page with the keys of its partition
+  if(aggregatedPages != nullptr) {
+    aggregatedPages->outputPages.clear();
+    for(uint64_t workerID = 0; workerID < aggregationPipelines->size(); ++workerID) {
+      auto pipeline = std::dynamic_pointer_cast<AggregationPipeline>((*aggregationPipelines)[workerID]);
+      aggregatedPages->outputPages[workerID] = setPages[pipeline->getOutputPage()];
+    }
+  }
+
+  return true;
+}
+
+std::pair<std::string, std::string> pdb::PDBAggregationPipeAlgorithm::getIncrementalOutputSet() {
+  return std::make_pair<std::string, std::string>((*setsToMaterialize)[0].database, (*setsToMaterialize)[0].set);
+}
+
+bool pdb::PDBAggregationPipeAlgorithm::isLocal() {
+  return local;
 }
 
 pdb::PDBPhysicalAlgorithmType pdb::PDBAggregationPipeAlgorithm::getAlgorithmType() {
@@ -3,6 +3,7 @@
 //
 
 #include <physicalAlgorithms/PDBBroadcastForJoinAlgorithm.h>
+#include <PDBPlanCache.h>
 
 pdb::PDBBroadcastForJoinAlgorithm::PDBBroadcastForJoinAlgorithm(const std::vector<PDBPrimarySource> &primarySource,
                                                                 const AtomicComputationPtr &finalAtomicComputation,
@@ -29,7 +30,7 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
                                               const std::string &error) {
 
   // init the plan
-  ComputePlan plan(std::make_shared<LogicalPlan>(job->tcap, *job->computations));
+  ComputePlan plan(PDBPlanCache::get().getLogicalPlan(job->tcap, job->computations, job->computationSize));
   logicalPlan = plan.getPlan();
 
   // get the manager
@@ -61,13 +62,13 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
 
   // initialize them
   for(int i = 0; i < sources.size(); i++) {
-    sourcePageSets.emplace_back(getSourcePageSet(storage, i));
+    sourcePageSets.emplace_back(getSourcePageSet(storage, job, i));
   }
 
   /// 3. Initialize all the pipelines
 
-  // get the number of worker threads from this server's config
-  int32_t numWorkers = storage->getConfiguration()->numThreads;
+  // get the number of worker threads, the share of the threads of this server the computation got
+  int32_t numWorkers = (int32_t) job->numberOfProcessingThreads;
 
   // check that we have at least one worker per primary source
   if(numWorkers < sources.size()) {
@@ -86,8 +87,8 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
     // get the source computation
     auto srcNode = logicalPlan->getComputations().getProducingAtomicComputation(firstTupleSet);
 
-    // if this is a scan set get the page set from a real set
-    PDBAbstractPageSetPtr sourcePageSet = getSourcePageSet(storage, pipelineIndex);
+    // go grab the source page set
+    PDBAbstractPageSetPtr sourcePageSet = sourcePageSets[pipelineSource];
 
     // did we manage to get a source page set? if not the setup failed
     if (sourcePageSet == nullptr) {
@@ -168,6 +169,10 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
       selfReceiver = std::make_shared<pdb::PDBPageSelfReceiver>(pageQueues->at(i), recvPageSet, myMgr);
     } else {
 
+      // the codec we compress the pages we send with
+      std::string codecError;
+      auto codec = PDBCodec::get(storage->getConfiguration()->shuffleCodec, codecError);
+
       // make the sender
       auto sender = std::make_shared<PDBPageNetworkSender>(job->nodes[i]->address,
                                                            job->nodes[i]->port,
@@ -177,7 +182,8 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
                                                            logger,
                                                            std::make_pair(hashedToRecv->pageSetIdentifier.first,
                                                                           hashedToRecv->pageSetIdentifier.second),
-                                                           pageQueues->at(i));
+                                                           pageQueues->at(i),
+                                                           codec);
 
       // setup the sender, if we fail return false
       if (!sender->setup()) {
@@ -211,6 +217,9 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
 
 bool pdb::PDBBroadcastForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage) {
 
+  // start a new profile for this run
+  profile = std::make_shared<PDBProfile>();
+
   // success indicator
   atomic_bool success;
   success = true;
@@ -244,6 +253,9 @@ bool pdb::PDBBroadcastForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManag
 
         // run the pipeline
         (*broadcastjoinPipelines)[workerID]->run();
+
+        // add the profile of the merge to the profile of the algorithm
+        this->profilePipeline((*broadcastjoinPipelines)[workerID]);
       }
       catch (std::exception &e) {
 
@@ -366,6 +378,12 @@ bool pdb::PDBBroadcastForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManag
 
         // run the pipeline
         (*prebroadcastjoinPipelines)[workerID]->run();
+
+        // report how many tuples the pipeline had to process again and what tuple set sizes it used
+        this->logPipelineStats(workerID, (*prebroadcastjoinPipelines)[workerID]);
+
+        // add the profile of the pipeline to the profile of the algorithm
+        this->profilePipeline((*prebroadcastjoinPipelines)[workerID]);
       }
       catch (std::exception &e) {
 
@@ -404,6 +422,9 @@ bool pdb::PDBBroadcastForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManag
     sendersBuzzer->wait();
   }
 
+  // the receiver and the senders are done, profile them
+  profilePageForwarding(selfReceiver, senders);
+
   // wait until all the broadcastjoin pipelines have completed
   while (joinCounter < broadcastjoinPipelines->size()) {
     joinBuzzer->wait();
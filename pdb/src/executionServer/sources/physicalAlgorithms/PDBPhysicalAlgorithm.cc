@@ -3,6 +3,7 @@
 #include <AtomicComputationClasses.h>
 #include <AtomicComputation.h>
 #include <PDBCatalogClient.h>
+#include <ExJob.h>
 
 namespace pdb {
 
@@ -47,20 +48,31 @@ PDBPhysicalAlgorithm::PDBPhysicalAlgorithm(const std::vector<PDBPrimarySource> &
   }
 }
 
-PDBAbstractPageSetPtr PDBPhysicalAlgorithm::getSourcePageSet(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage, size_t idx) {
+PDBAbstractPageSetPtr PDBPhysicalAlgorithm::getSourcePageSet(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage, Handle<pdb::ExJob> &job, size_t idx) {
 
   // grab the source set from the sources
   auto &sourceSet = this->sources[idx].sourceSet;
 
   // if this is a scan set get the page set from a real set
   PDBAbstractPageSetPtr sourcePageSet;
-  if (sourceSet != nullptr) {
+  if (sourceSet != nullptr && job->gatherSets) {
+
+    // the job runs only on this node, so we need the pages of the set from every worker
+    sourcePageSet = storage->createPageSetFromGatheredPDBSet(sourceSet->database, sourceSet->set);
+
+  } else if (sourceSet != nullptr) {
 
     // get the page set
     std::cout << sourceSet->database << sourceSet->set << "\n";
     sourcePageSet = storage->createPageSetFromPDBSet(sourceSet->database, sourceSet->set);
     sourcePageSet->resetPageSet();
 
+  } else if (this->sources[idx].pageSet->streamed) {
+
+    // the producer is running, we get the pages as it makes them
+    auto &pageSetIdentifier = this->sources[idx].pageSet->pageSetIdentifier;
+    sourcePageSet = storage->getStreamingPageSet(std::make_pair(pageSetIdentifier.first, pageSetIdentifier.second));
+
   } else {
 
     // we are reading from an existing page set get it
@@ -109,4 +121,51 @@ std::shared_ptr<JoinArguments> PDBPhysicalAlgorithm::getJoinArguments(std::share
   return joinArguments;
 }
 
-}
\ No newline at end of file
+void PDBPhysicalAlgorithm::logPipelineStats(size_t idx, const PipelinePtr &pipeline) {
+
+  // grab the tuple set size stats
+  auto stats = pipeline->getTupleSetSizeStats();
+
+  // log them
+  logger->info("Pipeline " + std::to_string(idx) + " retried " + std::to_string(pipeline->getNumRetriedTuples()) + " tuples, " +
+               "processed " + std::to_string(stats.numChunks) + " tuple sets with sizes from " + std::to_string(stats.minChunkSize) +
+               " to " + std::to_string(stats.maxChunkSize) + " (initial " + std::to_string(stats.initialChunkSize) +
+               (stats.usedLearnedModel ? " learned" : " default") + ", final " + std::to_string(stats.finalChunkSize) + ") and failed " +
+               std::to_string(stats.numFailures) + " times.");
+
+  // log how much the source read from its pages
+  auto scanStats = pipeline->getScanStats();
+  if(scanStats.numPages != 0) {
+    logger->info("Pipeline " + std::to_string(idx) + " scanned " + std::to_string(scanStats.numPages) + " pages with " +
+                 std::to_string(scanStats.numPageBytes) + " bytes and read " + std::to_string(scanStats.numBytesRead) + " bytes of them.");
+  }
+}
+
+void PDBPhysicalAlgorithm::profilePipeline(const PipelinePtr &pipeline) {
+  profile->merge(pipeline->getProfile());
+}
+
+void PDBPhysicalAlgorithm::profilePageForwarding(const PDBPageSelfReceiverPtr &selfReceiver,
+                                                 const std::shared_ptr<std::vector<PDBPageNetworkSenderPtr>> &senders) {
+
+  // each sender and receiver runs on its own thread
+  auto add = [&](const std::string &name, PDBOperatorStats stats) {
+    stats.numInstances = 1;
+    stats.maxWallTime = stats.wallTime;
+    profile->add({ name }, stats);
+  };
+
+  // the pages that stayed on this node
+  if(selfReceiver != nullptr) {
+    add("page self receiver", selfReceiver->getStats());
+  }
+
+  // the pages we sent to the other nodes
+  if(senders != nullptr) {
+    for(const auto &sender : *senders) {
+      add("page network sender", sender->getStats());
+    }
+  }
+}
+
+}
@@ -3,6 +3,7 @@
 //
 
 #include <ComputePlan.h>
+#include <PDBPlanCache.h>
 #include <PDBCatalogClient.h>
 #include <physicalAlgorithms/PDBShuffleForJoinAlgorithm.h>
 #include <ExJob.h>
@@ -18,9 +19,11 @@ pdb::PDBShuffleForJoinAlgorithm::PDBShuffleForJoinAlgorithm(const std::vector<PD
                                                             const pdb::Handle<pdb::PDBSinkPageSetSpec> &intermediate,
                                                             const pdb::Handle<pdb::PDBSinkPageSetSpec> &sink,
                                                             const std::vector<pdb::Handle<PDBSourcePageSetSpec>> &secondarySources,
-                                                            const pdb::Handle<pdb::Vector<PDBSetObject>> &setsToMaterialize)
+                                                            const pdb::Handle<pdb::Vector<PDBSetObject>> &setsToMaterialize,
+                                                            bool local)
     : PDBPhysicalAlgorithm(primarySource, finalAtomicComputation, sink, secondarySources, setsToMaterialize),
-      intermediate(intermediate) {
+      intermediate(intermediate),
+      local(local) {
 
 }
 
@@ -31,7 +34,7 @@ pdb::PDBPhysicalAlgorithmType pdb::PDBShuffleForJoinAlgorithm::getAlgorithmType(
 bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage, Handle<pdb::ExJob> &job, const std::string &error) {
 
   // init the plan
-  ComputePlan plan(std::make_shared<LogicalPlan>(job->tcap, *job->computations));
+  ComputePlan plan(PDBPlanCache::get().getLogicalPlan(job->tcap, job->computations, job->computationSize));
   logicalPlan = plan.getPlan();
 
   // init the logger
@@ -49,15 +52,18 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
 
   /// 1. Init the shuffle queues
 
+  // if the join is local the records are already on the right node, so they are not split by node at all and there is
+  // just one queue that goes straight to this node
+  auto numShuffleNodes = local ? 1 : job->numberOfNodes;
   pageQueues = std::make_shared<std::vector<PDBPageQueuePtr>>();
-  for(int i = 0; i < job->numberOfNodes; ++i) { pageQueues->emplace_back(std::make_shared<PDBPageQueue>()); }
+  for(int i = 0; i < numShuffleNodes; ++i) { pageQueues->emplace_back(std::make_shared<PDBPageQueue>()); }
 
   /// 2. Create the page set that contains the shuffled join side pages for this node
 
-  // get the receive page set
+  // get the receive page set, if the join is local only this node is feeding it
   auto recvPageSet = storage->createFeedingAnonymousPageSet(std::make_pair(sink->pageSetIdentifier.first, sink->pageSetIdentifier.second),
                                                             job->numberOfProcessingThreads,
-                                                            job->numberOfNodes);
+                                                            local ? 1 : job->numberOfNodes);
 
   // make sure we can use them all at the same time
   recvPageSet->setUsagePolicy(PDBFeedingPageSetUsagePolicy::KEEP_AFTER_USED);
@@ -74,6 +80,12 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
   senders = std::make_shared<std::vector<PDBPageNetworkSenderPtr>>();
   for(unsigned i = 0; i < job->nodes.size(); ++i) {
 
+    // if the join is local we just need the self receiver for the only queue
+    if(local) {
+      selfReceiver = std::make_shared<pdb::PDBPageSelfReceiver>(pageQueues->front(), recvPageSet, myMgr);
+      break;
+    }
+
     // check if it is this node or another node
     if(job->nodes[i]->port == job->thisNode->port && job->nodes[i]->address == job->thisNode->address) {
 
@@ -82,6 +94,10 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
     }
     else {
 
+      // the codec we compress the pages we send with
+      std::string codecError;
+      auto codec = PDBCodec::get(storage->getConfiguration()->shuffleCodec, codecError);
+
       // make the sender
       auto sender = std::make_shared<PDBPageNetworkSender>(job->nodes[i]->address,
                                                            job->nodes[i]->port,
@@ -90,7 +106,8 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
                                                            storage->getConfiguration()->maxRetries,
                                                            logger,
                                                            std::make_pair(sink->pageSetIdentifier.first, sink->pageSetIdentifier.second),
-                                                           pageQueues->at(i));
+                                                           pageQueues->at(i),
+                                                           codec);
 
       // setup the sender, if we fail return false
       if(!sender->setup()) {
@@ -110,13 +127,13 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
 
   // initialize them
   for(int i = 0; i < sources.size(); i++) {
-    sourcePageSets.emplace_back(getSourcePageSet(storage, i));
+    sourcePageSets.emplace_back(getSourcePageSet(storage, job, i));
   }
 
   /// 5. Initialize all the pipelines
 
-  // get the number of worker threads from this server's config
-  int32_t numWorkers = storage->getConfiguration()->numThreads;
+  // get the number of worker threads, the share of the threads of this server the computation got
+  int32_t numWorkers = (int32_t) job->numberOfProcessingThreads;
 
   // check that we have at least one worker per primary source
   if(numWorkers < sources.size()) {
@@ -162,7 +179,7 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
     auto catalogClient = storage->getFunctionalityPtr<PDBCatalogClient>();
 
     // empty computations parameters
-    std::map<ComputeInfoType, ComputeInfoPtr> params =  {{ComputeInfoType::PAGE_PROCESSOR, plan.getProcessorForJoin(finalTupleSet, job->numberOfNodes, job->numberOfProcessingThreads, *pageQueues, myMgr)},
+    std::map<ComputeInfoType, ComputeInfoPtr> params =  {{ComputeInfoType::PAGE_PROCESSOR, plan.getProcessorForJoin(finalTupleSet, numShuffleNodes, job->numberOfProcessingThreads, *pageQueues, myMgr)},
                                                          {ComputeInfoType::JOIN_ARGS, joinArguments},
                                                          {ComputeInfoType::SHUFFLE_JOIN_ARG, std::make_shared<ShuffleJoinArg>(swapLHSandRHS)},
                                                          {ComputeInfoType::SOURCE_SET_INFO, getSourceSetArg(catalogClient, pipelineSource)}};
@@ -175,7 +192,7 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
                                        sourcePageSet,
                                        intermediatePageSet,
                                        params,
-                                       job->numberOfNodes,
+                                       numShuffleNodes,
                                        job->numberOfProcessingThreads,
                                        20,
                                        pipelineIndex);
@@ -189,6 +206,9 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
 
 bool pdb::PDBShuffleForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage) {
 
+  // start a new profile for this run
+  profile = std::make_shared<PDBProfile>();
+
   // success indicator
   atomic_bool success;
   success = true;
@@ -300,6 +320,12 @@ bool pdb::PDBShuffleForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManager
 
         // run the pipeline
         (*joinShufflePipelines)[workerID]->run();
+
+        // report how many tuples the pipeline had to process again and what tuple set sizes it used
+        this->logPipelineStats(workerID, (*joinShufflePipelines)[workerID]);
+
+        // add the profile of the pipeline to the profile of the algorithm
+        this->profilePipeline((*joinShufflePipelines)[workerID]);
       }
       catch (std::exception &e) {
 
@@ -324,7 +350,9 @@ bool pdb::PDBShuffleForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManager
   }
 
   // ok they have finished now push a null page to each of the preagg queues
-  for(auto &queue : *pageQueues) { queue->enqueue(nullptr); }
+  for(auto &queue : *pageQueues) {
+    queue->enqueue(nullptr);
+  }
 
   // wait while we are running the receiver
   while(selfRecDone == 0) {
@@ -336,6 +364,9 @@ bool pdb::PDBShuffleForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManager
     sendersBuzzer->wait();
   }
 
+  // the receiver and the senders are done, profile them
+  profilePageForwarding(selfReceiver, senders);
+
   return true;
 }
 
@@ -3,11 +3,13 @@
 //
 
 #include <PDBVector.h>
+#include <PDBPlanCache.h>
 #include <ComputePlan.h>
 #include <GenericWork.h>
 #include <PDBCatalogClient.h>
 #include <physicalAlgorithms/PDBStraightPipeAlgorithm.h>
 #include <processors/NullProcessor.h>
+#include <processors/StreamingProcessor.h>
 
 #include "physicalAlgorithms/PDBStraightPipeAlgorithm.h"
 #include "ExJob.h"
@@ -22,11 +24,17 @@ pdb::PDBStraightPipeAlgorithm::PDBStraightPipeAlgorithm(const std::vector<PDBPri
 
 bool pdb::PDBStraightPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage, Handle<pdb::ExJob> &job, const std::string &error) {
 
+  // if the algorithm after us reads our pages while we make them grab the stream first, we have to finish it in
+  // cleanup even if the setup fails, otherwise it waits forever
+  if(sink->streamed) {
+    streamingPageSet = storage->getStreamingPageSet(std::make_pair(sink->pageSetIdentifier.first, sink->pageSetIdentifier.second));
+  }
+
   // init the logger
   logger = make_shared<PDBLogger>("PDBStraightPipeAlgorithm" + std::to_string(job->computationID));
 
   // init the plan
-  ComputePlan plan(std::make_shared<LogicalPlan>(job->tcap, *job->computations));
+  ComputePlan plan(PDBPlanCache::get().getLogicalPlan(job->tcap, job->computations, job->computationSize));
   logicalPlan = plan.getPlan();
 
   /// 0. Figure out the sink tuple set
@@ -47,13 +55,13 @@ bool pdb::PDBStraightPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManager
 
   // initialize them
   for(int i = 0; i < sources.size(); i++) {
-    sourcePageSets.emplace_back(getSourcePageSet(storage, i));
+    sourcePageSets.emplace_back(getSourcePageSet(storage, job, i));
   }
 
   /// 2. Initialize all the pipelines
 
-  // get the number of worker threads from this server's config
-  int32_t numWorkers = storage->getConfiguration()->numThreads;
+  // get the number of worker threads, the share of the threads of this server the computation got
+  int32_t numWorkers = (int32_t) job->numberOfProcessingThreads;
 
   // check that we have at least one worker per primary source
   if(numWorkers < sources.size()) {
@@ -97,8 +105,14 @@ bool pdb::PDBStraightPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManager
     // get catalog client
     auto catalogClient = storage->getFunctionalityPtr<PDBCatalogClient>();
 
+    // we keep every page, if they are streamed we also hand them over once they are written out
+    PageProcessorPtr processor = std::make_shared<NullProcessor>();
+    if(streamingPageSet != nullptr) {
+      processor = std::make_shared<StreamingProcessor>(streamingPageSet);
+    }
+
     // empty computations parameters
-    std::map<ComputeInfoType, ComputeInfoPtr> params =  {{ComputeInfoType::PAGE_PROCESSOR, std::make_shared<NullProcessor>()},
+    std::map<ComputeInfoType, ComputeInfoPtr> params =  {{ComputeInfoType::PAGE_PROCESSOR, processor},
                                                          {ComputeInfoType::JOIN_ARGS, joinArguments},
                                                          {ComputeInfoType::SHUFFLE_JOIN_ARG, std::make_shared<ShuffleJoinArg>(swapLHSandRHS)},
                                                          {ComputeInfoType::SOURCE_SET_INFO, getSourceSetArg(catalogClient, pipelineSource)}};
@@ -124,6 +138,9 @@ bool pdb::PDBStraightPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManager
 
 bool pdb::PDBStraightPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManagerBackend> &storage) {
 
+  // start a new profile for this run
+  profile = std::make_shared<PDBProfile>();
+
   atomic_bool success;
   success = true;
 
@@ -154,6 +171,12 @@ bool pdb::PDBStraightPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManagerBa
 
         // run the pipeline
         (*myPipelines)[i]->run();
+
+        // report how many tuples the pipeline had to process again and what tuple set sizes it used
+        this->logPipelineStats(i, (*myPipelines)[i]);
+
+        // add the profile of the pipeline to the profile of the algorithm
+        this->profilePipeline((*myPipelines)[i]);
       }
       catch (std::exception &e) {
 
@@ -177,6 +200,11 @@ bool pdb::PDBStraightPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManagerBa
     tempBuzzer->wait();
   }
 
+  // every page is written out, the algorithm reading them can finish
+  if(streamingPageSet != nullptr) {
+    streamingPageSet->finishFeeding();
+  }
+
   // if we failed finish
   if(!success) {
     return success;
@@ -208,9 +236,15 @@ pdb::PDBPhysicalAlgorithmType pdb::PDBStraightPipeAlgorithm::getAlgorithmType()
 
 void pdb::PDBStraightPipeAlgorithm::cleanup() {
 
+  // if we failed before we were done feeding the pages the reader still has to finish
+  if(streamingPageSet != nullptr) {
+    streamingPageSet->finishFeeding();
+  }
+
   // invalidate everything
   myPipelines = nullptr;
   logicalPlan = nullptr;
+  streamingPageSet = nullptr;
 }
 
 pdb::PDBCatalogSetContainerType pdb::PDBStraightPipeAlgorithm::getOutputContainerType() {
@@ -21,6 +21,7 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include <typeinfo>
 
 #include "Ptr.h"
 #include "Handle.h"
@@ -78,6 +79,16 @@ public:
       int numTuples = inputColumn.size ();
       outColumn.resize (numTuples);
 
+      // if the rows come from a columnar set that did not make the records we point to the values of the column
+      auto chunk = input->getColumnarChunk (whichAtt);
+      auto values = chunk == nullptr ? nullptr : (Out *) chunk->getAttribute (attName, typeid (Out));
+      if (values != nullptr) {
+        for (int i = 0; i < numTuples; i++) {
+          outColumn [i] = values + i;
+        }
+        return output;
+      }
+
       for (int i = 0; i < numTuples; i++) {
 
         auto ptr = (char *) &(*(inputColumn[i]));
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+#include "AtomicComputationList.h"
+#include "LogicalPlan.h"
+
+namespace pdb {
+
+/**
+ * A pipe the physical optimizer splits the TCAP into @see PDBPipeNodeBuilder
+ */
+struct PDBCachedPipe {
+
+  /**
+   * The PDBPipelineType of the pipe
+   */
+  int32_t type;
+
+  /**
+   * The names of the tuple sets the atomic computations of the pipe make, in the order they run
+   */
+  std::vector<std::string> pipeline;
+};
+
+using PDBCachedPipes = std::vector<PDBCachedPipe>;
+using PDBCachedPipesPtr = std::shared_ptr<const PDBCachedPipes>;
+
+/**
+ * Caches what the manager and the workers make from the TCAP of a computation, so that the computations that are run
+ * over and over again, like the iterations of an iterative algorithm, don't redo it for every job. The plans are found
+ * by the hash of the TCAP string, the least recently used ones are evicted once we have more than the maximum number
+ * of them. For every TCAP we keep
+ *
+ * 1. The parsed TCAP. The parsed plans are shared by the computations that run at the same time, so nobody gets the
+ *    cached one, everyone gets their own copy of the list. The atomic computations in it are not modified after the
+ *    parse so they are shared.
+ * 2. The pipes the physical optimizer split it into, the physical nodes are made again from them for every
+ *    computation since they belong to it.
+ * 3. The logical plan with the lambdas the compute plan makes the executors of the pipelines from. The lambdas capture
+ *    the parameters of the computations, so the plan is bound to a copy of the computations the cache owns and only
+ *    reused by a job whose computations have exactly the same bytes.
+ */
+class PDBPlanCache {
+ public:
+
+  /**
+   * Creates the cache
+   * @param maxPlans - the maximum number of plans we keep
+   * @param maxComputationsSize - the maximum number of bytes the copies of the computations the logical plans are
+   * bound to take together
+   */
+  explicit PDBPlanCache(size_t maxPlans = 64, size_t maxComputationsSize = 64 * 1024 * 1024);
+
+  /**
+   * Returns the cache of this process
+   */
+  static PDBPlanCache &get();
+
+  /**
+   * Returns the hash the plan of a TCAP string is found by
+   * @param tcap - the TCAP string
+   * @return the hash
+   */
+  static size_t getTCAPHash(const std::string &tcap);
+
+  /**
+   * Returns a copy of the parsed TCAP, parses it if it is not in the cache
+   * @param tcap - the TCAP string
+   * @param error - the error of the parser if it fails
+   * @return the parsed TCAP, null if it does not parse
+   */
+  std::shared_ptr<AtomicComputationList> getParsedTCAP(const std::string &tcap, std::string &error);
+
+  /**
+   * Returns the pipes the TCAP was split into by an earlier computation @see setPipes
+   * @param tcap - the TCAP string
+   * @return the pipes, null if we don't have them
+   */
+  PDBCachedPipesPtr getPipes(const std::string &tcap);
+
+  /**
+   * Stores the pipes the TCAP was split into, if we still have the TCAP
+   * @param tcap - the TCAP string
+   * @param pipes - the pipes
+   */
+  void setPipes(const std::string &tcap, const PDBCachedPipesPtr &pipes);
+
+  /**
+   * Returns the logical plan of a job with the lambdas extracted from the computations. If the computations can not be
+   * copied into the cache the plan is bound to the ones of the job and not cached.
+   * @param tcap - the TCAP string
+   * @param computations - the computations of the job
+   * @param computationsSize - how many bytes the computations take at most
+   * @return the plan, throws a runtime_error if the TCAP does not parse
+   */
+  LogicalPlanPtr getLogicalPlan(const std::string &tcap,
+                                Handle<Vector<Handle<Computation>>> &computations,
+                                size_t computationsSize);
+
+  /**
+   * Parses the TCAP with the flex/bison parser, without looking at the cache
+   * @param tcap - the TCAP string
+   * @param error - the error of the parser if it fails
+   * @return the parsed TCAP, null if it does not parse
+   */
+  static std::shared_ptr<AtomicComputationList> parse(const std::string &tcap, std::string &error);
+
+  /**
+   * Returns how many times we found the parsed TCAP in the cache
+   */
+  uint64_t getNumHits() const { return numHits; }
+
+  /**
+   * Returns how many times we had to parse the TCAP
+   */
+  uint64_t getNumMisses() const { return numMisses; }
+
+  /**
+   * Returns how many times a job got a logical plan that was already made
+   */
+  uint64_t getNumLogicalPlanHits() const { return numLogicalPlanHits; }
+
+  /**
+   * Returns how many times we had to extract the lambdas for a job
+   */
+  uint64_t getNumLogicalPlanMisses() const { return numLogicalPlanMisses; }
+
+  /**
+   * Returns the number of plans in the cache
+   */
+  size_t getNumPlans();
+
+ private:
+
+  /**
+   * A logical plan bound to the copy of the computations it was made from
+   */
+  struct PDBBoundLogicalPlan {
+
+    /**
+     * The record of the computations, the plan points into it so it is destroyed after the plan
+     */
+    std::unique_ptr<char[]> computations;
+
+    /**
+     * The size of the record
+     */
+    size_t numBytes = 0;
+
+    /**
+     * The plan
+     */
+    LogicalPlanPtr plan;
+  };
+
+  /**
+   * Everything we keep for a TCAP string
+   */
+  struct PDBCachedPlan {
+
+    /**
+     * The TCAP string, two strings might have the same hash
+     */
+    std::string tcap;
+
+    /**
+     * The parsed TCAP
+     */
+    std::shared_ptr<const AtomicComputationList> parsed;
+
+    /**
+     * The pipes the physical optimizer split the TCAP into, null until it tells us
+     */
+    PDBCachedPipesPtr pipes;
+
+    /**
+     * The logical plan of the last computation that ran the TCAP, null if there is none
+     */
+    std::shared_ptr<PDBBoundLogicalPlan> logicalPlan;
+
+    /**
+     * Where the hash is in the lru list
+     */
+    std::list<size_t>::iterator lruPosition;
+  };
+
+  /**
+   * Finds the plan of a TCAP string and marks it as the most recently used one, the lock has to be held
+   * @param tcap - the TCAP string
+   * @return the plan, null if we don't have it
+   */
+  PDBCachedPlan *find(const std::string &tcap);
+
+  /**
+   * Stores the logical plan of a TCAP, the plans of the least recently used TCAP strings are dropped if the copies of
+   * the computations take too much space. The lock has to be held.
+   * @param plan - the plan of the TCAP string
+   * @param logicalPlan - the logical plan
+   */
+  void setLogicalPlan(PDBCachedPlan &plan, const std::shared_ptr<PDBBoundLogicalPlan> &logicalPlan);
+
+  /**
+   * Returns a pointer to the logical plan that keeps the copy of the computations alive
+   */
+  static LogicalPlanPtr share(const std::shared_ptr<PDBBoundLogicalPlan> &logicalPlan) {
+    return LogicalPlanPtr(logicalPlan, logicalPlan->plan.get());
+  }
+
+  /**
+   * The maximum number of plans we keep
+   */
+  size_t maxPlans;
+
+  /**
+   * The maximum number of bytes the copies of the computations take
+   */
+  size_t maxComputationsSize;
+
+  /**
+   * The number of bytes the copies of the computations take
+   */
+  size_t computationsSize = 0;
+
+  /**
+   * The hashes of the TCAP strings, the most recently used one is at the front
+   */
+  std::list<size_t> lru;
+
+  /**
+   * The plans by the hash of their TCAP string
+   */
+  std::unordered_map<size_t, PDBCachedPlan> plans;
+
+  /**
+   * The hits and misses
+   */
+  std::atomic<uint64_t> numHits{0};
+  std::atomic<uint64_t> numMisses{0};
+  std::atomic<uint64_t> numLogicalPlanHits{0};
+  std::atomic<uint64_t> numLogicalPlanMisses{0};
+
+  /**
+   * Protects the plans
+   */
+  std::mutex m;
+};
+
+}
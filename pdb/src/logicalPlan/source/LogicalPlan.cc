@@ -1,6 +1,5 @@
 #include <LogicalPlan.h>
-#include <Lexer.h>
-#include <Parser.h>
+#include <PDBPlanCache.h>
 
 namespace pdb {
 
@@ -25,32 +24,17 @@ void LogicalPlan::init(AtomicComputationList &computationsIn, pdb::Vector<pdb::H
 
 void LogicalPlan::init(const std::string &tcap, Vector<Handle<Computation>> &allComputations) {
 
-  // get the string to compile
-  std::string myLogicalPlan = tcap;
-  myLogicalPlan.push_back('\0');
-
-  // where the result of the parse goes
-  AtomicComputationList *myResult;
-
-  // now, do the compilation
-  yyscan_t scanner;
-  LexerExtra extra{""};
-  yylex_init_extra(&extra, &scanner);
-  const YY_BUFFER_STATE buffer{yy_scan_string(myLogicalPlan.data(), scanner)};
-  const int parseFailed{yyparse(scanner, &myResult)};
-  yy_delete_buffer(buffer, scanner);
-  yylex_destroy(scanner);
+  // grab the parsed TCAP, it is only parsed if this process has not seen it recently
+  std::string error;
+  auto parsed = PDBPlanCache::get().getParsedTCAP(tcap, error);
 
   // if it didn't parse, get outta here
-  if (parseFailed) {
-    std::cout << "Parse error when compiling TCAP: " << extra.errorMessage;
-    exit(1);
+  if (parsed == nullptr) {
+    throw std::runtime_error("Parse error when compiling TCAP: " + error);
   }
 
   // copy all the computations
-  init(*myResult, allComputations);
-
-  delete myResult;
+  init(*parsed, allComputations);
 }
 
 }
@@ -0,0 +1,245 @@
+#include <PDBPlanCache.h>
+#include <PDBMetrics.h>
+#include <Lexer.h>
+#include <Parser.h>
+#include <cstring>
+
+namespace pdb {
+
+PDBPlanCache::PDBPlanCache(size_t maxPlans, size_t maxComputationsSize) : maxPlans(std::max<size_t>(maxPlans, 1)),
+                                                                          maxComputationsSize(maxComputationsSize) {}
+
+PDBPlanCache &PDBPlanCache::get() {
+
+  // never destroyed so the threads that are still running while the process exits can use it
+  static auto *cache = new PDBPlanCache();
+  return *cache;
+}
+
+size_t PDBPlanCache::getTCAPHash(const std::string &tcap) {
+  return std::hash<std::string>()(tcap);
+}
+
+PDBPlanCache::PDBCachedPlan *PDBPlanCache::find(const std::string &tcap) {
+
+  // is it here, a different string might have the same hash
+  auto it = plans.find(getTCAPHash(tcap));
+  if(it == plans.end() || it->second.tcap != tcap) {
+    return nullptr;
+  }
+
+  // it was just used
+  lru.splice(lru.begin(), lru, it->second.lruPosition);
+  return &it->second;
+}
+
+std::shared_ptr<AtomicComputationList> PDBPlanCache::getParsedTCAP(const std::string &tcap, std::string &error) {
+
+  /// 1. Check if we already parsed it
+
+  {
+    std::unique_lock<std::mutex> lck(m);
+
+    auto plan = find(tcap);
+    if(plan != nullptr) {
+
+      numHits++;
+      PDBMetrics::get().planCacheHits.inc();
+
+      // everyone gets their own copy
+      return std::make_shared<AtomicComputationList>(*plan->parsed);
+    }
+  }
+
+  /// 2. Parse it, we don't hold the lock while parsing so the other computations don't wait for us
+
+  numMisses++;
+  PDBMetrics::get().planCacheMisses.inc();
+
+  auto parsed = parse(tcap, error);
+  if(parsed == nullptr) {
+    return nullptr;
+  }
+
+  /// 3. Store it, somebody might have parsed it while we were parsing it
+
+  std::unique_lock<std::mutex> lck(m);
+  if(find(tcap) == nullptr) {
+
+    // a different string with the same hash goes
+    auto hash = getTCAPHash(tcap);
+    auto it = plans.find(hash);
+    if(it != plans.end()) {
+      setLogicalPlan(it->second, nullptr);
+      lru.erase(it->second.lruPosition);
+      plans.erase(it);
+    }
+
+    // evict the least recently used plan if we are full
+    if(plans.size() >= maxPlans) {
+      setLogicalPlan(plans[lru.back()], nullptr);
+      plans.erase(lru.back());
+      lru.pop_back();
+    }
+
+    lru.push_front(hash);
+    auto &plan = plans[hash];
+    plan.tcap = tcap;
+    plan.parsed = std::make_shared<const AtomicComputationList>(*parsed);
+    plan.lruPosition = lru.begin();
+  }
+
+  return parsed;
+}
+
+PDBCachedPipesPtr PDBPlanCache::getPipes(const std::string &tcap) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  auto plan = find(tcap);
+  return plan != nullptr ? plan->pipes : nullptr;
+}
+
+void PDBPlanCache::setPipes(const std::string &tcap, const PDBCachedPipesPtr &pipes) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  auto plan = find(tcap);
+  if(plan != nullptr) {
+    plan->pipes = pipes;
+  }
+}
+
+LogicalPlanPtr PDBPlanCache::getLogicalPlan(const std::string &tcap,
+                                            Handle<Vector<Handle<Computation>>> &computations,
+                                            size_t computationsSize) {
+
+  // we need the parsed TCAP either way
+  std::string error;
+  auto parsed = getParsedTCAP(tcap, error);
+  if(parsed == nullptr) {
+    throw std::runtime_error("Parse error when compiling TCAP: " + error);
+  }
+
+  /// 1. Copy the computations, if they don't fit the plan is bound to the ones of the job and not cached
+
+  std::vector<char> buffer(computationsSize + 1024 * 1024);
+  Record<Vector<Handle<Computation>>> *record = nullptr;
+  if(buffer.size() <= maxComputationsSize) {
+    try {
+      record = getRecord(computations, buffer.data(), buffer.size());
+    } catch (NotEnoughSpace &n) {
+      record = nullptr;
+    }
+  }
+
+  if(record == nullptr) {
+
+    numLogicalPlanMisses++;
+    PDBMetrics::get().logicalPlanCacheMisses.inc();
+    return std::make_shared<LogicalPlan>(*parsed, *computations);
+  }
+
+  /// 2. Check if an earlier job had the same computations, like a later job of the same computation or a prepared
+  ///    computation run with the same parameters. The id of the computation is not enough, the manager might have
+  ///    been restarted and numbers them from zero again
+
+  {
+    std::unique_lock<std::mutex> lck(m);
+
+    auto plan = find(tcap);
+    if(plan != nullptr && plan->logicalPlan != nullptr && plan->logicalPlan->numBytes == record->numBytes() &&
+       memcmp(plan->logicalPlan->computations.get(), record, record->numBytes()) == 0) {
+
+      numLogicalPlanHits++;
+      PDBMetrics::get().logicalPlanCacheHits.inc();
+      return share(plan->logicalPlan);
+    }
+  }
+
+  /// 3. Extract the lambdas from our copy of the computations, without holding the lock
+
+  numLogicalPlanMisses++;
+  PDBMetrics::get().logicalPlanCacheMisses.inc();
+
+  auto logicalPlan = std::make_shared<PDBBoundLogicalPlan>();
+  logicalPlan->numBytes = record->numBytes();
+  logicalPlan->computations.reset(new char[logicalPlan->numBytes]);
+  memcpy(logicalPlan->computations.get(), record, logicalPlan->numBytes);
+
+  auto copy = ((Record<Vector<Handle<Computation>>> *) logicalPlan->computations.get())->getRootObject();
+  logicalPlan->plan = std::make_shared<LogicalPlan>(*parsed, *copy);
+
+  /// 4. Store it for the next jobs, if we still have the TCAP
+
+  std::unique_lock<std::mutex> lck(m);
+  auto plan = find(tcap);
+  if(plan != nullptr) {
+    setLogicalPlan(*plan, logicalPlan);
+  }
+
+  return share(logicalPlan);
+}
+
+void PDBPlanCache::setLogicalPlan(PDBCachedPlan &plan, const std::shared_ptr<PDBBoundLogicalPlan> &logicalPlan) {
+
+  // the one we replace does not take any space anymore, the jobs that still use it keep it alive
+  if(plan.logicalPlan != nullptr) {
+    computationsSize -= plan.logicalPlan->numBytes;
+  }
+  plan.logicalPlan = logicalPlan;
+  if(logicalPlan == nullptr) {
+    return;
+  }
+  computationsSize += logicalPlan->numBytes;
+
+  // drop the logical plans of the least recently used TCAP strings until the copies fit
+  for(auto it = lru.rbegin(); it != lru.rend() && computationsSize > maxComputationsSize; ++it) {
+
+    auto &other = plans[*it];
+    if(&other != &plan && other.logicalPlan != nullptr) {
+      computationsSize -= other.logicalPlan->numBytes;
+      other.logicalPlan = nullptr;
+    }
+  }
+
+  // if it still does not fit it is not kept either
+  if(computationsSize > maxComputationsSize) {
+    computationsSize -= logicalPlan->numBytes;
+    plan.logicalPlan = nullptr;
+  }
+}
+
+std::shared_ptr<AtomicComputationList> PDBPlanCache::parse(const std::string &tcap, std::string &error) {
+
+  // get the string to compile
+  std::string myLogicalPlan = tcap;
+  myLogicalPlan.push_back('\0');
+
+  // where the result of the parse goes
+  AtomicComputationList *myResult;
+
+  // now, do the compilation
+  yyscan_t scanner;
+  LexerExtra extra{""};
+  yylex_init_extra(&extra, &scanner);
+  const YY_BUFFER_STATE buffer{yy_scan_string(myLogicalPlan.data(), scanner)};
+  const int parseFailed{yyparse(scanner, &myResult)};
+  yy_delete_buffer(buffer, scanner);
+  yylex_destroy(scanner);
+
+  // if it didn't parse, get outta here
+  if (parseFailed) {
+    error = extra.errorMessage;
+    return nullptr;
+  }
+
+  return std::shared_ptr<AtomicComputationList>(myResult);
+}
+
+size_t PDBPlanCache::getNumPlans() {
+  std::unique_lock<std::mutex> lck(m);
+  return plans.size();
+}
+
+}
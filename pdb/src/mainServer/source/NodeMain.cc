@@ -21,6 +21,7 @@
 #include <PDBServer.h>
 #include <GenericWork.h>
 #include <NodeConfig.h>
+#include <PDBCodec.h>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <ClusterManager.h>
@@ -33,6 +34,7 @@
 #include <PDBStorageManagerBackend.h>
 #include <PDBBufferManagerDebugFrontend.h>
 #include <ExecutionServerBackend.h>
+#include <PDBMetricsServer.h>
 #include <random>
 
 namespace po = boost::program_options;
@@ -99,12 +101,23 @@ int main(int argc, char *argv[]) {
   desc.add_options()("isManager,m", po::bool_switch(&config->isManager), "Start manager");
   desc.add_options()("address,i", po::value<std::string>(&config->address)->default_value("localhost"), "IP of the node");
   desc.add_options()("port,p", po::value<int32_t>(&config->port)->default_value(8108), "Port of the node");
+  desc.add_options()("metricsPort", po::value<int32_t>(&config->metricsPort)->default_value(0), "The port the node serves its metrics on in the prometheus text format, 0 to not serve them");
+  desc.add_options()("metricsAddress", po::value<std::string>(&config->metricsAddress)->default_value("127.0.0.1"), "The IPv4 address the node serves its metrics on, 0.0.0.0 to serve them on every interface");
   desc.add_options()("debugBufferManager", po::bool_switch(&config->debugBufferManager), "Whether we want to debug the buffer manager or not. (has to be compiled for that)");
   desc.add_options()("managerAddress,d", po::value<std::string>(&config->managerAddress)->default_value("localhost"), "IP of the manager");
   desc.add_options()("managerPort,o", po::value<int32_t>(&config->managerPort)->default_value(8108), "Port of the manager");
   desc.add_options()("sharedMemSize,s", po::value<size_t>(&config->sharedMemSize)->default_value(2048), "The size of the shared memory (MB)");
   desc.add_options()("pageSize,e", po::value<size_t>(&config->pageSize)->default_value(1024 * 1024 * 128), "The size of a page (bytes)");
   desc.add_options()("numThreads,t", po::value<int32_t>(&config->numThreads)->default_value(2), "The number of threads we want to use");
+  desc.add_options()("maxConcurrentJobs", po::value<int32_t>(&config->maxConcurrentJobs)->default_value(1), "The number of computations the manager runs at the same time, each gets an equal share of the threads and memory");
+  desc.add_options()("smallQueryThreshold", po::value<uint64_t>(&config->smallQueryThreshold)->default_value(config->smallQueryThreshold), "The computations with at most this many input bytes run on a single node, 0 to always use all the nodes");
+  desc.add_options()("pageSetCacheSize", po::value<uint64_t>(&config->pageSetCacheSize)->default_value(config->pageSetCacheSize), "The bytes of intermediate page sets the manager keeps for the computations that compute them again, 0 to not keep any");
+  desc.add_options()("pageLookahead", po::value<uint64_t>(&config->pageLookahead)->default_value(2), "The number of set pages a pipeline prefetches ahead of the one it is processing");
+  desc.add_options()("mapSetPages", po::bool_switch(&config->mapSetPages), "Whether the scans read the set pages on disk from the files mapped read-only instead of the buffer pool");
+  desc.add_options()("dispatchPolicy", po::value<std::string>(&config->dispatchPolicy)->default_value("random"), "How the manager places the pages of a set on the workers { random, leastLoaded, twoChoices }");
+  desc.add_options()("ingestCodec", po::value<std::string>(&config->ingestCodec)->default_value("snappy"), "The codec the clients compress the pages they send with { none, snappy, lz4, zstd[:level] }");
+  desc.add_options()("pageCodec", po::value<std::string>(&config->pageCodec)->default_value("snappy"), "The codec the pages served to the clients are compressed with { none, snappy, lz4, zstd[:level] }");
+  desc.add_options()("shuffleCodec", po::value<std::string>(&config->shuffleCodec)->default_value("none"), "The codec the pages of a shuffle are compressed with { none, snappy, lz4, zstd[:level] }");
   desc.add_options()("rootDirectory,r", po::value<std::string>(&config->rootDirectory)->default_value("./pdbRoot"), "The root directory we want to use.");
   desc.add_options()("maxRetries", po::value<uint32_t>(&config->maxRetries)->default_value(5), "The maximum number of retries before we give up.");
 
@@ -119,6 +132,15 @@ int main(int argc, char *argv[]) {
     return 0;
   }
 
+  // check if we were built with the codecs
+  std::string codecError;
+  for(const auto &codec : { config->ingestCodec, config->pageCodec, config->shuffleCodec }) {
+    if(pdb::PDBCodec::get(codec, codecError) == nullptr) {
+      std::cout << codecError << '\n';
+      return 1;
+    }
+  }
+
   // create the root directory
   fs::path rootPath(config->rootDirectory);
   if(!fs::exists(rootPath) && !fs::create_directories(rootPath)) {
@@ -161,6 +183,7 @@ int main(int argc, char *argv[]) {
     backEnd.addFunctionality(std::make_shared<pdb::PDBCatalogClient>(config->port, config->address, logger));
     backEnd.addFunctionality(std::make_shared<pdb::PDBStorageManagerBackend>());
     backEnd.addFunctionality(std::make_shared<pdb::ExecutionServerBackend>());
+    backEnd.addFunctionality(std::make_shared<pdb::PDBMetricsServer>(false));
 
     // start the backend
     backEnd.startServer(make_shared<pdb::GenericWork>([&](PDBBuzzerPtr callerBuzzer) {
@@ -189,6 +212,7 @@ int main(int argc, char *argv[]) {
     frontEnd.addFunctionality(std::make_shared<pdb::PDBDistributedStorage>());
     frontEnd.addFunctionality(std::make_shared<pdb::PDBCatalogClient>(config->port, config->address, logger));
     frontEnd.addFunctionality(std::make_shared<pdb::PDBStorageManagerFrontend>());
+    frontEnd.addFunctionality(std::make_shared<pdb::PDBMetricsServer>(true));
 
     // on the worker put and execution server
     if(!config->isManager) {
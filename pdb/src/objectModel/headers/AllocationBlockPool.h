@@ -0,0 +1,260 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef ALLOCATION_BLOCK_POOL_H
+#define ALLOCATION_BLOCK_POOL_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <iostream>
+
+namespace pdb {
+
+// This file contains a small thread local pool of memory blocks.  Allocation blocks that are set up by
+// UseTemporaryAllocationBlock and the buffers we receive objects into are malloced and freed for pretty much every
+// request, so instead of going to malloc each time we keep a few of the recently freed ones around.  The blocks
+// are bucketed by size.  Every power of two is split into POOLED_SIZE_CLASSES_PER_POWER size classes, so for
+// 2^k < n <= 2^(k+1) the bucket holds blocks of 2^k + i * 2^k / 4 bytes, and a request wastes at most 25%.
+
+// the smallest block we pool is 2^MIN_POOLED_BLOCK_BITS bytes, the largest one is 2^MAX_POOLED_BLOCK_BITS bytes
+#define MIN_POOLED_BLOCK_BITS 10
+#define MAX_POOLED_BLOCK_BITS 23
+#define POOLED_SIZE_CLASSES_PER_POWER 4
+#define NUM_POOLED_BLOCK_BUCKETS ((MAX_POOLED_BLOCK_BITS - MIN_POOLED_BLOCK_BITS) * POOLED_SIZE_CLASSES_PER_POWER + 1)
+
+// how many blocks can be in a bucket
+#define MAX_POOLED_BLOCKS_PER_BUCKET 8
+
+// how many bytes a single thread is allowed to keep in its pool
+#define MAX_POOLED_BYTES_PER_THREAD (32ul * 1024ul * 1024ul)
+
+// the statistics of all the pools in the process
+struct AllocationBlockPoolStats {
+
+    // the number of blocks we got from a pool
+    uint64_t hits;
+
+    // the number of blocks we had to malloc
+    uint64_t misses;
+
+    // the number of blocks we have freed since the pool was full or they could not be pooled
+    uint64_t discarded;
+
+    // the fraction of the requests that were served from a pool
+    double hitRate() const {
+        return (hits + misses) == 0 ? 0.0 : (double)hits / (double)(hits + misses);
+    }
+};
+
+class AllocationBlockPool {
+
+public:
+    // returns the size of the block acquire will return for a request of numBytes, the caller is
+    // free to use all of it.  Sizes we pool are rounded up to the size of their bucket.
+    static size_t getBlockSize(size_t numBytes) {
+        int bucket = getBucket(numBytes);
+        if (bucket == -1) {
+            return numBytes;
+        }
+        if (bucket == 0) {
+            return (size_t)1 << MIN_POOLED_BLOCK_BITS;
+        }
+
+        // the bucket is the i-th size class above 2^k
+        size_t powerOfTwo = (size_t)1 << (MIN_POOLED_BLOCK_BITS + (bucket - 1) / POOLED_SIZE_CLASSES_PER_POWER);
+        size_t sizeClass = (bucket - 1) % POOLED_SIZE_CLASSES_PER_POWER + 1;
+        return powerOfTwo + sizeClass * (powerOfTwo / POOLED_SIZE_CLASSES_PER_POWER);
+    }
+
+    // returns a block of getBlockSize (numBytes) bytes, or nullptr if we are out of memory.
+    // The block must be given back through release, or freed with free ().  If INITIALIZE_ALLOCATOR_BLOCK
+    // is defined the block is zeroed, unless the caller tells us that it overwrites it anyway
+    static void* acquire(size_t numBytes, bool zero = true) {
+
+        // figure out the bucket
+        int bucket = getBucket(numBytes);
+        size_t blockSize = getBlockSize(numBytes);
+
+        // if we have a block of this size grab it
+        ThreadPool& pool = getThreadPool();
+        if (bucket != -1 && !pool.destroyed && pool.numBlocks[bucket] != 0) {
+            void* block = pool.blocks[bucket][--pool.numBlocks[bucket]];
+            pool.numBytes -= blockSize;
+            getHits()++;
+
+// JiaNote: we need initialize allocator block to make valgrind happy
+#ifdef INITIALIZE_ALLOCATOR_BLOCK
+            if (zero) {
+                memset(block, 0, blockSize);
+            }
+#endif
+            return block;
+        }
+
+        // otherwise we need to go to malloc
+        getMisses()++;
+#ifdef INITIALIZE_ALLOCATOR_BLOCK
+        if (zero) {
+            return calloc(blockSize, 1);
+        }
+#endif
+        return malloc(blockSize);
+    }
+
+    // gives a block of numBytes bytes back to the pool, the block must have been malloced
+    static void release(void* block, size_t numBytes) {
+
+        if (block == nullptr) {
+            return;
+        }
+
+        // we only keep blocks that have exactly the size of a bucket and if we have room for them
+        int bucket = getBucket(numBytes);
+        ThreadPool& pool = getThreadPool();
+        if (bucket == -1 || getBlockSize(numBytes) != numBytes || pool.destroyed ||
+            pool.numBlocks[bucket] == MAX_POOLED_BLOCKS_PER_BUCKET ||
+            pool.numBytes + numBytes > MAX_POOLED_BYTES_PER_THREAD) {
+            getDiscarded()++;
+            free(block);
+            return;
+        }
+
+        // keep it
+        pool.blocks[bucket][pool.numBlocks[bucket]++] = block;
+        pool.numBytes += numBytes;
+    }
+
+    // returns the statistics of the pools
+    static AllocationBlockPoolStats getStats() {
+        return AllocationBlockPoolStats{getHits(), getMisses(), getDiscarded()};
+    }
+
+private:
+    // the blocks of a single thread
+    struct ThreadPool {
+
+        // the blocks in each bucket
+        void* blocks[NUM_POOLED_BLOCK_BUCKETS][MAX_POOLED_BLOCKS_PER_BUCKET];
+
+        // the number of blocks in each bucket
+        int numBlocks[NUM_POOLED_BLOCK_BUCKETS] = {};
+
+        // the total number of bytes in this pool
+        size_t numBytes = 0;
+
+        // set once the thread is exiting, after that we just use malloc and free
+        bool destroyed = false;
+
+        ~ThreadPool() {
+            for (int i = 0; i < NUM_POOLED_BLOCK_BUCKETS; i++) {
+                for (int j = 0; j < numBlocks[i]; j++) {
+                    free(blocks[i][j]);
+                }
+                numBlocks[i] = 0;
+            }
+            numBytes = 0;
+            destroyed = true;
+        }
+    };
+
+    // returns the bucket a request of numBytes goes to, -1 if we don't pool blocks of this size
+    static int getBucket(size_t numBytes) {
+        if (numBytes == 0 || numBytes > ((size_t)1 << MAX_POOLED_BLOCK_BITS)) {
+            return -1;
+        }
+        if (numBytes <= ((size_t)1 << MIN_POOLED_BLOCK_BITS)) {
+            return 0;
+        }
+
+        // find the power of two such that 2^k < numBytes <= 2^(k+1)
+        int power = MIN_POOLED_BLOCK_BITS;
+        while (((size_t)1 << (power + 1)) < numBytes) {
+            power++;
+        }
+
+        // and the first size class above 2^k that fits the request
+        size_t powerOfTwo = (size_t)1 << power;
+        size_t step = powerOfTwo / POOLED_SIZE_CLASSES_PER_POWER;
+        size_t sizeClass = (numBytes - powerOfTwo + step - 1) / step;
+        return (power - MIN_POOLED_BLOCK_BITS) * POOLED_SIZE_CLASSES_PER_POWER + (int)sizeClass;
+    }
+
+    static ThreadPool& getThreadPool() {
+        static thread_local ThreadPool pool;
+        return pool;
+    }
+
+    static std::atomic<uint64_t>& getHits() {
+        static std::atomic<uint64_t> hits{0};
+        return hits;
+    }
+
+    static std::atomic<uint64_t>& getMisses() {
+        static std::atomic<uint64_t> misses{0};
+        return misses;
+    }
+
+    static std::atomic<uint64_t>& getDiscarded() {
+        static std::atomic<uint64_t> discarded{0};
+        return discarded;
+    }
+};
+
+// a buffer that we receive an object into, it comes from the pool of the thread and is given back once we are done.
+// We read the object right into it, so it is never zeroed
+class PooledBuffer {
+
+public:
+    explicit PooledBuffer(size_t numBytes)
+        : numBytes(AllocationBlockPool::getBlockSize(numBytes)),
+          memory((char*)AllocationBlockPool::acquire(numBytes, false)) {
+
+        // JiaNote: malloc check
+        if (memory == nullptr) {
+            std::cout << "Fatal Error in PooledBuffer(): out of memory with size=" << numBytes
+                      << std::endl;
+            exit(-1);
+        }
+    }
+
+    ~PooledBuffer() {
+        AllocationBlockPool::release(memory, numBytes);
+    }
+
+    // returns the memory of the buffer
+    char* get() const {
+        return memory;
+    }
+
+    // forbidden, to avoid double frees
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+private:
+    // the size of the block we got from the pool
+    size_t numBytes;
+
+    // the memory of the buffer
+    char* memory;
+};
+}
+
+#endif
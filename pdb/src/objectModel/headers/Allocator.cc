@@ -20,6 +20,7 @@
 #define ALLOCATOR_CC
 
 #include "PDBDebug.h"
+#include "AllocationBlockPool.h"
 #include <sstream>
 #include <cstddef>
 #include <iostream>
@@ -41,7 +42,7 @@ inline InactiveAllocationBlock::InactiveAllocationBlock() {
 // free the memory associated with the block
 inline void InactiveAllocationBlock::freeBlock() {
     if (start != nullptr)
-        free(start);
+        AllocationBlockPool::release(start, CHAR_PTR(end) - CHAR_PTR(start));
 }
 
 // create a block
@@ -107,6 +108,30 @@ inline void* InactiveAllocationBlock::getEnd() {
 #define GET_CHUNK_SIZE(ofMe) (*((unsigned*)ofMe))
 #define CHUNK_HEADER_SIZE sizeof(unsigned)
 
+// These macros are used by the size class policy
+// The layout of a free chunk is | chunk size | offset to the next free chunk of the same size | ... |
+#define SIZE_CLASS_MAX_CHUNK 512
+#define NUM_SIZE_CLASSES (SIZE_CLASS_MAX_CHUNK / 4 + 1)
+#define SIZE_CLASS_MIN_CHUNK (CHUNK_HEADER_SIZE + sizeof(size_t))
+#define NEXT_FREE_CHUNK(ofMe) (*((size_t*)(CHAR_PTR(ofMe) + CHUNK_HEADER_SIZE)))
+#define CHUNK_AT(offset) (CHAR_PTR(myState.activeRAM) + (offset))
+
+// forget all the free chunks in the current allocation block
+inline void clearFreeChunks(AllocatorState& myState) {
+
+    // empty out the list of unused chunks of RAM in this block
+    for (auto& c : myState.chunks) {
+        c.clear();
+    }
+
+    // and the ones the size class policy keeps
+    std::fill(myState.sizeClassHeads.begin(), myState.sizeClassHeads.end(), 0);
+    myState.largeChunks.clear();
+    myState.largeChunksBySize.clear();
+    myState.sizeClassFreeBytes = 0;
+    myState.sizeClassSmallFreeBytes = 0;
+}
+
 // free some RAM
 #ifdef DEBUG_OBJECT_MODEL
 inline void defaultFreeRAM(bool isContained,
@@ -328,6 +353,237 @@ inline void* fastGetRAM(size_t howMuch, AllocatorState& myState) {
 }
 
 
+// adds a free chunk to the structures of the size class policy, the chunk must not have any free neighbours that
+// are large chunks, since they are not coalesced here. If coalesce is true the chunk is kept with the large chunks
+// regardless of its size, so it can be merged with its neighbours later on
+inline void sizeClassAddFreeChunk(size_t offset, unsigned chunkSize, AllocatorState& myState, bool coalesce) {
+
+    // the chunk was allocated by some other policy and can not store the offset, so we can not reuse it
+    if (chunkSize < SIZE_CLASS_MIN_CHUNK) {
+        return;
+    }
+
+    // write the size of the chunk
+    void* chunk = CHUNK_AT(offset);
+    GET_CHUNK_SIZE(chunk) = chunkSize;
+    myState.sizeClassFreeBytes += chunkSize;
+
+    // small chunks go to the head of the free list for their size
+    if (chunkSize <= SIZE_CLASS_MAX_CHUNK && !coalesce) {
+        NEXT_FREE_CHUNK(chunk) = myState.sizeClassHeads[chunkSize / 4];
+        myState.sizeClassHeads[chunkSize / 4] = offset;
+        myState.sizeClassSmallFreeBytes += chunkSize;
+        return;
+    }
+
+    // large chunks are kept ordered by offset and size
+    myState.largeChunks[offset] = chunkSize;
+    myState.largeChunksBySize.insert(std::make_pair(chunkSize, offset));
+}
+
+// removes a large chunk from the structures of the size class policy
+inline void sizeClassRemoveLargeChunk(std::map<size_t, unsigned>::iterator it, AllocatorState& myState) {
+    myState.sizeClassFreeBytes -= it->second;
+    myState.largeChunksBySize.erase(std::make_pair(it->second, it->first));
+    myState.largeChunks.erase(it);
+}
+
+// moves all the small chunks to the large chunks and merges all the neighbouring chunks, so that the memory they
+// hold can service larger requests. This is linear in the number of free chunks, so we only do it once we
+// would otherwise have to fail the allocation
+inline void sizeClassCoalesceSmallChunks(AllocatorState& myState) {
+
+    // move the small chunks, they are ordered by the offset in the map
+    for (auto& head : myState.sizeClassHeads) {
+        while (head != 0) {
+            void* chunk = CHUNK_AT(head);
+            myState.largeChunks[head] = GET_CHUNK_SIZE(chunk);
+            head = NEXT_FREE_CHUNK(chunk);
+        }
+    }
+    myState.sizeClassSmallFreeBytes = 0;
+
+    // merge the neighbours
+    auto it = myState.largeChunks.begin();
+    while (it != myState.largeChunks.end()) {
+        auto next = std::next(it);
+        if (next != myState.largeChunks.end() && it->first + it->second == next->first) {
+            it->second += next->second;
+            myState.largeChunks.erase(next);
+        } else {
+            it = next;
+        }
+    }
+
+    // give back the chunk at the end of the used memory
+    if (!myState.largeChunks.empty()) {
+        auto last = std::prev(myState.largeChunks.end());
+        if (last->first + last->second == LAST_USED) {
+            LAST_USED = last->first;
+            myState.largeChunks.erase(last);
+        }
+    }
+
+    // rebuild the size index and the free byte count
+    myState.largeChunksBySize.clear();
+    myState.sizeClassFreeBytes = 0;
+    for (auto& c : myState.largeChunks) {
+        myState.largeChunksBySize.insert(std::make_pair(c.second, c.first));
+        myState.sizeClassFreeBytes += c.second;
+    }
+}
+
+// free some RAM
+#ifdef DEBUG_OBJECT_MODEL
+inline void sizeClassFreeRAM(bool isContained,
+                             void* here,
+                             std::vector<InactiveAllocationBlock>& allInactives,
+                             AllocatorState& myState,
+                             int16_t typeId) {
+#else
+inline void sizeClassFreeRAM(bool isContained,
+                             void* here,
+                             std::vector<InactiveAllocationBlock>& allInactives,
+                             AllocatorState& myState) {
+#endif
+
+    // if this guy is not from the active block, the default policy knows how to find his block
+    if (!isContained) {
+#ifdef DEBUG_OBJECT_MODEL
+        defaultFreeRAM(isContained, here, allInactives, myState, typeId);
+#else
+        defaultFreeRAM(isContained, here, allInactives, myState);
+#endif
+        return;
+    }
+
+    here = CHAR_PTR(here) - CHUNK_HEADER_SIZE;
+    ALLOCATOR_REF_COUNT--;
+
+    // get the chunk size and the offset
+    unsigned chunkSize = GET_CHUNK_SIZE(here);
+    size_t offset = CHAR_PTR(here) - CHAR_PTR(myState.activeRAM);
+
+    // every chunk is coalesced with its free neighbours among the large chunks, the small chunks are only
+    // found in the free lists, so they are merged with each other once the block runs out of space
+    bool merged = false;
+
+    // is the chunk right after this one free
+    auto next = myState.largeChunks.find(offset + chunkSize);
+    if (next != myState.largeChunks.end()) {
+        chunkSize += next->second;
+        sizeClassRemoveLargeChunk(next, myState);
+        merged = true;
+    }
+
+    // is the chunk right before this one free
+    auto prev = myState.largeChunks.lower_bound(offset);
+    if (prev != myState.largeChunks.begin()) {
+        prev--;
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            chunkSize += prev->second;
+            sizeClassRemoveLargeChunk(prev, myState);
+            merged = true;
+        }
+    }
+
+    // if the chunk is at the end of the used memory, just give it back
+    if (offset + chunkSize == LAST_USED) {
+
+        LAST_USED = offset;
+
+        // and any large chunk that is now at the end
+        while (!myState.largeChunks.empty()) {
+            auto last = std::prev(myState.largeChunks.end());
+            if (last->first + last->second != LAST_USED) {
+                break;
+            }
+            LAST_USED = last->first;
+            sizeClassRemoveLargeChunk(last, myState);
+        }
+        return;
+    }
+
+    // remember this chunk, if it was merged keep it with the large chunks so it can be merged again
+    sizeClassAddFreeChunk(offset, chunkSize, myState, merged);
+
+#ifdef DEBUG_OBJECT_MODEL
+    std::cout << "**sizeClassFreeRAM**" << std::endl;
+    std::cout << "###################################" << std::endl;
+    std::cout << "allocator block reference count--=" << ALLOCATOR_REF_COUNT
+              << " with typeId=" << typeId << std::endl;
+    std::cout << "allocator block start =" << myState.activeRAM << std::endl;
+    std::cout << "allocator numBytes=" << myState.numBytes << std::endl;
+    std::cout << "freed numBytes=" << chunkSize << std::endl;
+    std::cout << "###################################" << std::endl;
+#endif
+}
+
+// returns some RAM... this can throw an exception if the request is too large
+// to be handled because there is not enough RAM in the current allocation block
+#ifdef DEBUG_OBJECT_MODEL
+inline void* sizeClassGetRAM(size_t howMuch, AllocatorState& myState, int16_t typeId) {
+    std::cout << "to get RAM with size = " << howMuch << " and typeId = " << typeId << std::endl;
+#else
+inline void* sizeClassGetRAM(size_t howMuch, AllocatorState& myState) {
+#endif
+    unsigned bytesNeeded = (unsigned)(CHUNK_HEADER_SIZE + howMuch);
+    if ((bytesNeeded % 4) != 0) {
+        bytesNeeded += (4 - (bytesNeeded % 4));
+    }
+
+    // the chunk needs to be able to store the offset to the next free chunk once it is freed
+    bytesNeeded = std::max<unsigned>(bytesNeeded, SIZE_CLASS_MIN_CHUNK);
+
+    // if there is a free chunk of exactly this size take it
+    if (bytesNeeded <= SIZE_CLASS_MAX_CHUNK && myState.sizeClassHeads[bytesNeeded / 4] != 0) {
+
+        void* res = CHUNK_AT(myState.sizeClassHeads[bytesNeeded / 4]);
+        myState.sizeClassHeads[bytesNeeded / 4] = NEXT_FREE_CHUNK(res);
+        myState.sizeClassFreeBytes -= bytesNeeded;
+        myState.sizeClassSmallFreeBytes -= bytesNeeded;
+        ALLOCATOR_REF_COUNT++;
+        return CHAR_PTR(res) + CHUNK_HEADER_SIZE;
+    }
+
+    // otherwise find the smallest large chunk that can service the request
+    auto it = myState.largeChunksBySize.lower_bound(std::make_pair(bytesNeeded, (size_t) 0));
+
+    // if none can and the end of the block can not either, merge the small chunks and try again
+    if (it == myState.largeChunksBySize.end() && LAST_USED + bytesNeeded > myState.numBytes &&
+        myState.sizeClassSmallFreeBytes != 0) {
+        sizeClassCoalesceSmallChunks(myState);
+        it = myState.largeChunksBySize.lower_bound(std::make_pair(bytesNeeded, (size_t) 0));
+    }
+
+    if (it != myState.largeChunksBySize.end()) {
+
+        // take the chunk
+        size_t offset = it->second;
+        unsigned chunkSize = it->first;
+        sizeClassRemoveLargeChunk(myState.largeChunks.find(offset), myState);
+
+        // if what is left is large enough to be a chunk, split it, we keep what is left with the large chunks
+        // so that it can be merged back with the chunk we are returning once it is freed
+        if (chunkSize - bytesNeeded >= SIZE_CLASS_MIN_CHUNK) {
+            sizeClassAddFreeChunk(offset + bytesNeeded, chunkSize - bytesNeeded, myState, true);
+            chunkSize = bytesNeeded;
+        }
+
+        void* res = CHUNK_AT(offset);
+        GET_CHUNK_SIZE(res) = chunkSize;
+        ALLOCATOR_REF_COUNT++;
+        return CHAR_PTR(res) + CHUNK_HEADER_SIZE;
+    }
+
+#ifdef DEBUG_OBJECT_MODEL
+    return fastGetRAM(bytesNeeded - CHUNK_HEADER_SIZE, myState, typeId);
+#else
+    return fastGetRAM(bytesNeeded - CHUNK_HEADER_SIZE, myState);
+#endif
+}
+
 // free some RAM
 #ifdef DEBUG_OBJECT_MODEL
 inline void DefaultPolicy::freeRAM(bool isContained,
@@ -437,6 +693,43 @@ inline void* NoReferenceCountPolicy::getRAM(size_t howMuch, AllocatorState& mySt
 }
 
 
+// free some RAM
+#ifdef DEBUG_OBJECT_MODEL
+inline void SizeClassPolicy::freeRAM(bool isContained,
+                                     void* here,
+                                     std::vector<InactiveAllocationBlock>& allInactives,
+                                     AllocatorState& myState,
+                                     int16_t typeId) {
+#else
+inline void SizeClassPolicy::freeRAM(bool isContained,
+                                     void* here,
+                                     std::vector<InactiveAllocationBlock>& allInactives,
+                                     AllocatorState& myState) {
+#endif
+
+#ifdef DEBUG_OBJECT_MODEL
+    sizeClassFreeRAM(isContained, here, allInactives, myState, typeId);
+#else
+    sizeClassFreeRAM(isContained, here, allInactives, myState);
+#endif
+}
+
+// returns some RAM... this can throw an exception if the request is too large
+// to be handled because there is not enough RAM in the current allocation block
+#ifdef DEBUG_OBJECT_MODEL
+inline void* SizeClassPolicy::getRAM(size_t howMuch, AllocatorState& myState, int16_t typeId) {
+#else
+inline void* SizeClassPolicy::getRAM(size_t howMuch, AllocatorState& myState) {
+#endif
+
+#ifdef DEBUG_OBJECT_MODEL
+    return sizeClassGetRAM(howMuch, myState, typeId);
+#else
+    return sizeClassGetRAM(howMuch, myState);
+#endif
+}
+
+
 // return true if allocations should not fail due to not enough RAM...
 // in this case, a null pointer is returned on a bad allocate, and NOT
 // an exception
@@ -476,6 +769,7 @@ MultiPolicyAllocator<FirstPolicy, OtherPolicies...>::MultiPolicyAllocator() {
         std::vector<void*> temp;
         myState.chunks.push_back(temp);
     }
+    myState.sizeClassHeads.resize(NUM_SIZE_CLASSES, 0);
     myState.activeRAM = nullptr;
     myState.numBytes = 0;
 
@@ -507,6 +801,7 @@ MultiPolicyAllocator<FirstPolicy, OtherPolicies...>::MultiPolicyAllocator(size_t
         std::vector<void*> temp;
         myState.chunks.push_back(temp);
     }
+    myState.sizeClassHeads.resize(NUM_SIZE_CLASSES, 0);
     myState.activeRAM = nullptr;
     myState.numBytes = 0;
 
@@ -535,6 +830,12 @@ MultiPolicyAllocator<FirstPolicy, OtherPolicies...>::MultiPolicyAllocator(size_t
 template <typename FirstPolicy, typename... OtherPolicies>
 inline void MultiPolicyAllocator<FirstPolicy, OtherPolicies...>::setPolicy(AllocatorPolicy policy) {
     // std :: cout << "to set policy " <<policy << std :: endl;
+
+    // the policies keep the free chunks differently, so they can not use each others free chunks
+    if (policy != curPolicy && myState.activeRAM != nullptr) {
+        clearFreeChunks(myState);
+    }
+    curPolicy = policy;
     myPolicies.setPolicy(policy);
 }
 
@@ -598,9 +899,7 @@ inline void MultiPolicyAllocator<FirstPolicy, OtherPolicies...>::emptyOutBlock(v
     // if this is the active one, emty it out
     if (contains(here)) {
         // empty out the list of unused chunks of RAM in this block
-        for (auto& c : myState.chunks) {
-            c.clear();
-        }
+        clearFreeChunks(myState);
 
         // LAST_USED = HEADER_SIZE;
         ALLOCATOR_REF_COUNT = 0;
@@ -668,7 +967,7 @@ MultiPolicyAllocator<FirstPolicy, OtherPolicies...>::getBytesAvailableInCurrentA
         }
     }
 
-    return myState.numBytes - LAST_USED + amtUnused;
+    return myState.numBytes - LAST_USED + amtUnused + myState.sizeClassFreeBytes;
 }
 
 template <typename FirstPolicy, typename... OtherPolicies>
@@ -744,14 +1043,12 @@ inline void MultiPolicyAllocator<FirstPolicy, OtherPolicies...>::setupBlock(
             allInactives.emplace_back(myState.activeRAM, myState.numBytes);
             std::sort(allInactives.begin(), allInactives.end());
         } else {
-            free(myState.activeRAM);
+            AllocationBlockPool::release(myState.activeRAM, myState.numBytes);
         }
     }
 
     // empty out the list of unused chunks of RAM in this block
-    for (auto& c : myState.chunks) {
-        c.clear();
-    }
+    clearFreeChunks(myState);
 
     myState.activeRAM = where;
 
@@ -829,13 +1126,10 @@ MultiPolicyAllocator<FirstPolicy, OtherPolicies...>::temporarilyUseBlockForAlloc
     // give the current alloction block a phantom reference count so it is not freed
     ALLOCATOR_REF_COUNT++;
 
-// and set up the new block
-// JiaNote: we need initialize allocator block to make valgrind happy
-#ifdef INITIALIZE_ALLOCATOR_BLOCK
-    void* putMeHere = calloc(numBytesAvailable, 1);
-#else
-    void* putMeHere = malloc(numBytesAvailable);
-#endif
+    // and set up the new block, we take it from the pool of this thread if we can, the block
+    // we get might be a bit larger than what we asked for, so we use all of it
+    numBytesAvailable = AllocationBlockPool::getBlockSize(numBytesAvailable);
+    void* putMeHere = AllocationBlockPool::acquire(numBytesAvailable);
     // JiaNote: malloc check
     if (putMeHere == nullptr) {
         std::cout << "Fatal Error in temporarilyUseBlockForAllocations(): out of memory with size="
@@ -858,7 +1152,7 @@ inline void MultiPolicyAllocator<FirstPolicy, OtherPolicies...>::restoreAllocati
             allInactives.emplace_back(myState.activeRAM, myState.numBytes);
             std::sort(allInactives.begin(), allInactives.end());
         } else {
-            free(myState.activeRAM);
+            AllocationBlockPool::release(myState.activeRAM, myState.numBytes);
         }
     }
 
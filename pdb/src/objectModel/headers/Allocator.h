@@ -26,6 +26,8 @@
 #include <iterator>
 #include <cstring>
 #include <unordered_map>
+#include <map>
+#include <set>
 
 //#define DEBUG_OBJECT_MODEL
 //#define DEBUG_DEEP_COPY
@@ -124,10 +126,33 @@ struct AllocatorState {
     // service the request is returned.  If no region in the list can service it, the
     // next list is checked.  Then the next, and so on.
     std::vector<std::vector<void*>> chunks;
+
+    // The size class policy keeps the free regions differently.  Every chunk of up to
+    // SIZE_CLASS_MAX_CHUNK bytes goes into a free list with chunks of exactly the same size,
+    // since the sizes are multiples of 4 the list of chunks with n bytes is at n / 4.  The lists
+    // are intrusive, each free chunk stores the offset of the next free chunk in the list from the
+    // start of the block right after the chunk header, and we only keep the offset of the first one
+    // here (zero if the list is empty).  Since we only store offsets the block stays relocatable.
+    std::vector<size_t> sizeClassHeads;
+
+    // the free chunks that are larger than SIZE_CLASS_MAX_CHUNK, the key is the offset of the chunk
+    // from the start of the block, the value its size.  They are ordered by the offset so that we can
+    // coalesce the neighbouring chunks when we free one.
+    std::map<size_t, unsigned> largeChunks;
+
+    // the same large chunks ordered by (size, offset) so we can find the best fit
+    std::set<std::pair<unsigned, size_t>> largeChunksBySize;
+
+    // the number of bytes in the chunks managed by the size class policy
+    size_t sizeClassFreeBytes = 0;
+
+    // the number of bytes in the small chunks, once the block runs out of space these are
+    // coalesced with their neighbours so they can service larger requests
+    size_t sizeClassSmallFreeBytes = 0;
 };
 
 
-enum AllocatorPolicy { defaultAllocator, noReuseAllocator, noReferenceCountAllocator };
+enum AllocatorPolicy { defaultAllocator, noReuseAllocator, noReferenceCountAllocator, sizeClassAllocator };
 
 // the dummy policy
 
@@ -271,6 +296,40 @@ public:
 };
 
 
+// Policy that reuses deallocated space through exact size class free lists for small chunks
+// and coalesces the large ones, both allocation and deallocation of small chunks are O(1)
+class SizeClassPolicy {
+
+public:
+// free some RAM
+#ifdef DEBUG_OBJECT_MODEL
+    inline void freeRAM(bool isContained,
+                        void* here,
+                        std::vector<InactiveAllocationBlock>& allInactives,
+                        AllocatorState& myState,
+                        int16_t typeId);
+#else
+    inline void freeRAM(bool isContained,
+                        void* here,
+                        std::vector<InactiveAllocationBlock>& allInactives,
+                        AllocatorState& myState);
+#endif
+
+// returns some RAM... this can throw an exception if the request is too large
+// to be handled because there is not enough RAM in the current allocation block
+#ifdef DEBUG_OBJECT_MODEL
+    inline void* getRAM(size_t howMuch, AllocatorState& myState, int16_t typeId);
+#else
+    inline void* getRAM(size_t howMuch, AllocatorState& myState);
+#endif
+
+    inline AllocatorPolicy getPolicyName() {
+
+        return AllocatorPolicy::sizeClassAllocator;
+    }
+};
+
+
 // forward declaration of the PolicyList class
 
 template <typename FirstPolicy, typename... OtherPolicies>
@@ -411,6 +470,10 @@ class MultiPolicyAllocator {
 private:
     PolicyList<FirstPolicy, OtherPolicies...> myPolicies;
 
+    // the policy we are currently using, the policies keep the free chunks differently
+    // so when we switch the policy we have to forget them
+    AllocatorPolicy curPolicy = defaultAllocator;
+
     AllocatorState myState;
 
     // this is the list of all self-managed allocation blocks that are not active, but
@@ -525,7 +588,7 @@ private:
     friend void makeObjectAllocatorBlock(size_t numBytesIn);
 };
 
-typedef MultiPolicyAllocator<DefaultPolicy, NoReusePolicy, NoReferenceCountPolicy> Allocator;
+typedef MultiPolicyAllocator<DefaultPolicy, NoReusePolicy, NoReferenceCountPolicy, SizeClassPolicy> Allocator;
 
 
 // returns a reference to the allocator that should be used.  Each process has one default
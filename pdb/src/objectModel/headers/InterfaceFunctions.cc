@@ -88,6 +88,15 @@ inline size_t getBytesAvailableInCurrentAllocatorBlock() {
     return getAllocator().getBytesAvailableInCurrentAllocatorBlock();
 }
 
+inline bool fitsInCurrentAllocatorBlock(size_t numBytes) {
+    return getAllocator().getFreeBytesAtTheEnd() >= numBytes;
+}
+
+inline size_t getAllocatedSizeForObject(size_t objectSize) {
+    size_t numBytes = CHUNK_HEADER_SIZE + REF_COUNT_PREAMBLE_SIZE + objectSize;
+    return numBytes + (4 - numBytes % 4) % 4;
+}
+
 inline void emptyOutContainingBlock(void* forMe) {
     getAllocator().emptyOutBlock(forMe);
 }
@@ -105,6 +105,17 @@ void makeObjectAllocatorBlock(void* spaceToUse, size_t numBytesIn, bool throwExc
 // allocation block.
 size_t getBytesAvailableInCurrentAllocatorBlock();
 
+// this checks whether numBytes can be allocated from the end of the current allocation
+// block.  Since the allocator only hands out memory from the end of the block once
+// the free chunks are exhausted, a true means that the next numBytes worth of
+// allocations on this thread are not going to throw a NotEnoughSpace exception.
+// Nothing is set aside, whoever needs the space has to allocate it right away.
+bool fitsInCurrentAllocatorBlock(size_t numBytes);
+
+// this returns how many bytes of an allocation block an object of objectSize bytes
+// takes up, this includes the reference count, the chunk header and the padding
+size_t getAllocatedSizeForObject(size_t objectSize);
+
 // this gets a count of the current number of individual, active objects that
 // are present in the current allocation block
 unsigned getNumObjectsInCurrentAllocatorBlock();
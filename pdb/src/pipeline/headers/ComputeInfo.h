@@ -27,7 +27,8 @@ enum ComputeInfoType {
   PAGE_PROCESSOR,
   JOIN_ARGS,
   SHUFFLE_JOIN_ARG,
-  SOURCE_SET_INFO
+  SOURCE_SET_INFO,
+  SCAN_ATTRIBUTES
 };
 
 // this is the base class for parameters that are sent into a pipeline when it is built
@@ -25,6 +25,7 @@
 #include "PDBVector.h"
 #include "pipeline/Pipeline.h"
 #include "ComputeInfo.h"
+#include "ScanAttributesArg.h"
 
 namespace pdb {
 
@@ -42,6 +43,9 @@ class ComputePlan {
                                     uint64_t chunkSize,
                                     uint64_t workerID);
 
+  // figures out what attributes and methods of the records the pipelines that start with a scan use
+  ScanAttributesArgPtr getScanAttributes(AtomicComputationPtr &scan);
+
   // returns the compute sink
   ComputeSinkPtr getComputeSink(AtomicComputationPtr &targetAtomicComp,
                                 std::string& targetComputationName,
@@ -96,6 +100,16 @@ class ComputePlan {
                                        const PDBAnonymousPageSetPtr &outputPageSet,
                                        uint64_t workerID);
 
+  // build the aggregation pipeline of an incremental aggregation, it first merges the keys of its partition from the
+  // output the aggregation already has and then the preaggregated maps
+  PipelinePtr buildAggregationPipeline(const std::string &targetTupleSetName,
+                                       const PDBAbstractPageSetPtr &inputPageSet,
+                                       const PDBAnonymousPageSetPtr &outputPageSet,
+                                       const PDBAbstractPageSetPtr &existingOutputPageSet,
+                                       uint64_t partition,
+                                       uint64_t numPartitions,
+                                       uint64_t workerID);
+
   // build a pipeline for the broadcast join
   PipelinePtr buildBroadcastJoinPipeline(const string &targetTupleSetName,
                                          const PDBAbstractPageSetPtr &inputPageSet,
@@ -44,6 +44,14 @@ public:
 	// this writes out the whole page to this sink
   	virtual void writeOutPage(pdb::PDBPageHandle &page, Handle<Object> &writeToMe) = 0;
 
+	// this estimates how many bytes of the current allocation block writing the tuple set into the output
+	// container is going to need, so that the pipeline can make room before calling writeOut, zero if we can not tell
+	virtual uint64_t bytesNeeded (TupleSetPtr writeMe, Handle <Object> &writeToMe) { return 0; }
+
+	// this grows the output container so that writing the tuple set does not have to grow it, the pipeline calls it
+	// right after bytesNeeded once it made sure the bytes fit into the current allocation block
+	virtual void reserve (TupleSetPtr writeMe, Handle <Object> &writeToMe) {}
+
 	virtual ~ComputeSink () = default;
 
 };
@@ -21,6 +21,7 @@
 
 #include <pipeline/PDBTupleSetSizePolicy.h>
 #include "TupleSet.h"
+#include "PDBScanStats.h"
 
 namespace pdb {
 
@@ -39,6 +40,9 @@ public:
 
 	virtual ~ComputeSource () = default;
 
+	// returns the stats about the pages this source read, sources that don't read pages have none
+	virtual PDBScanStats getScanStats () { return PDBScanStats{}; }
+
 };
 
 }
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <typeinfo>
+
+namespace pdb {
+
+/**
+ * The rows of a tuple set that come from a columnar set, @see ColumnarTupleSetIterator. If the scan does not make the
+ * records, the column of the records has null handles and the attributes are taken from here instead.
+ */
+class PDBColumnarChunk {
+ public:
+
+  virtual ~PDBColumnarChunk() = default;
+
+  /**
+   * Returns the values of an attribute for the rows of the tuple set, the value of the i-th row is at the i-th position
+   * @param attName - the name of the attribute
+   * @param type - the type of the attribute
+   * @return a pointer to the value of the first row, or null if we don't have the attribute with that type
+   */
+  virtual void *getAttribute(const std::string &attName, const std::type_info &type) = 0;
+};
+
+}
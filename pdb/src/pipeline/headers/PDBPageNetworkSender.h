@@ -8,6 +8,8 @@
 #include <memory>
 #include <PageProcessor.h>
 #include <PDBCommunicator.h>
+#include <PDBCodec.h>
+#include <PDBProfile.h>
 
 namespace pdb {
 
@@ -21,7 +23,8 @@ class PDBPageNetworkSender {
 public:
 
   PDBPageNetworkSender(string address, int32_t port, uint64_t numberOfProcessingThreads, uint64_t numberOfNodes,
-                       uint64_t maxRetries, PDBLoggerPtr logger, std::pair<uint64_t, std::string> pageSetID, pdb::PDBPageQueuePtr queue);
+                       uint64_t maxRetries, PDBLoggerPtr logger, std::pair<uint64_t, std::string> pageSetID, pdb::PDBPageQueuePtr queue,
+                       PDBCodecPtr codec = nullptr);
 
   /**
    * Connects to the node with the parameters provided in the constructor and gets the ACK that the other side has set everything up.
@@ -35,6 +38,12 @@ public:
    */
   bool run();
 
+  /**
+   * Returns the stats of the pages we sent, the time is the time spent on them not waiting for them
+   * @return the stats
+   */
+  const PDBOperatorStats &getStats() const;
+
 private:
 
   /**
@@ -77,6 +86,11 @@ private:
    */
   PDBPageQueuePtr queue;
 
+  /**
+   * The codec we compress the pages with, if it is null or the no-op codec we send them as they are
+   */
+  PDBCodecPtr codec;
+
   /**
    * The logger
    */
@@ -86,6 +100,11 @@ private:
    * The communicator to the node
    */
   PDBCommunicatorPtr comm;
+
+  /**
+   * The stats of the pages we sent
+   */
+  PDBOperatorStats stats;
 };
 
 }
@@ -7,6 +7,7 @@
 
 #include <PDBFeedingPageSet.h>
 #include "PageProcessor.h"
+#include "PDBProfile.h"
 
 namespace pdb {
 
@@ -30,6 +31,12 @@ public:
    */
   bool run();
 
+  /**
+   * Returns the stats of the pages we fed to the page set, the time is the time spent on them not waiting for them
+   * @return the stats
+   */
+  const PDBOperatorStats &getStats() const;
+
 private:
 
   /**
@@ -46,6 +53,11 @@ private:
    * The buffer manager
    */
   pdb::PDBBufferManagerInterfacePtr bufferManager;
+
+  /**
+   * The stats of the pages we fed to the page set
+   */
+  PDBOperatorStats stats;
 };
 
 }
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <PDBVector.h>
+#include <PDBProfileEntry.h>
+
+namespace pdb {
+
+/**
+ * The stats of an operator of a computation, like a stage of a pipeline, a sink or a page sender. The stats of the
+ * same operator running on different threads or nodes are summed up, the slowest one is kept in maxWallTime.
+ */
+struct PDBOperatorStats {
+
+  // how many threads or nodes the stats were collected on
+  uint64_t numInstances = 0;
+
+  // the wall time the operator took, summed up over all the instances (ns)
+  uint64_t wallTime = 0;
+
+  // the wall time of the slowest instance (ns)
+  uint64_t maxWallTime = 0;
+
+  // the cpu time the operator took (ns)
+  uint64_t cpuTime = 0;
+
+  // the number of rows that went into the operator
+  uint64_t numRowsIn = 0;
+
+  // the number of rows that came out of the operator
+  uint64_t numRowsOut = 0;
+
+  // the number of bytes the operator allocated, read or sent
+  uint64_t numBytes = 0;
+
+  // the number of pages the operator allocated, read or sent
+  uint64_t numPages = 0;
+
+  // the number of bytes on the pages a source went through, numBytes is what it actually read of them
+  uint64_t numPageBytes = 0;
+
+  // the number of times the operator ran out of space and had to be run again
+  uint64_t numRetries = 0;
+
+  // the number of rows a pipeline had to process again because a stage or the sink ran out of space
+  uint64_t numRetriedTuples = 0;
+
+  // the number of tuple sets a pipeline processed and how many times it failed to process one @see PDBTupleSetSizeStats
+  uint64_t numChunks = 0;
+  uint64_t numChunkFailures = 0;
+
+  // the smallest and the largest number of rows in a tuple set a pipeline chose
+  uint64_t minChunkSize = 0;
+  uint64_t maxChunkSize = 0;
+
+  // the number of rows in a tuple set a pipeline started and ended with, summed up over all the instances
+  uint64_t initialChunkSize = 0;
+  uint64_t finalChunkSize = 0;
+
+  // how many of the instances started from a model learned by an earlier pipeline instead of the default size
+  uint64_t numLearnedChunkSizes = 0;
+
+  /**
+   * Adds the stats of another instance of the operator
+   * @param other - the stats of the other instance
+   */
+  void merge(const PDBOperatorStats &other);
+};
+
+/**
+ * Measures the wall and cpu time of the current thread from its construction until it is destroyed and adds it to
+ * the stats of an operator
+ */
+class PDBOperatorTimer {
+ public:
+
+  explicit PDBOperatorTimer(PDBOperatorStats &stats);
+
+  ~PDBOperatorTimer();
+
+  /**
+   * Returns the wall time since some fixed point (ns)
+   */
+  static uint64_t getWallTime();
+
+  /**
+   * Returns the cpu time of the current thread (ns)
+   */
+  static uint64_t getCpuTime();
+
+ private:
+
+  // the stats we add the times to
+  PDBOperatorStats &stats;
+
+  // when we started
+  uint64_t wallStart;
+  uint64_t cpuStart;
+};
+
+class PDBProfile;
+using PDBProfilePtr = std::shared_ptr<PDBProfile>;
+
+/**
+ * The profile of a computation, a tree of operators with their stats. Every operator is identified by its path from
+ * the root, like { "job 1", "pipeline A -> B", "stage 0: Apply C" }, adding the stats of an operator that is already in
+ * the profile merges them, so the profiles of all the threads and nodes can be added into one. The profile is sent
+ * over the wire as a vector of @see PDBProfileEntry in tree order. It is thread safe.
+ */
+class PDBProfile {
+ public:
+
+  PDBProfile() = default;
+
+  PDBProfile(const PDBProfile &other);
+
+  PDBProfile &operator=(const PDBProfile &other);
+
+  /**
+   * An operator of the profile
+   */
+  struct Entry {
+
+    // the path of the operator from the root
+    std::vector<std::string> path;
+
+    // the stats of the operator
+    PDBOperatorStats stats;
+  };
+
+  /**
+   * Adds the stats of an operator, the operators on its path are added with empty stats if they are not there
+   * @param path - the path of the operator
+   * @param stats - the stats
+   */
+  void add(const std::vector<std::string> &path, const PDBOperatorStats &stats);
+
+  /**
+   * Adds all the operators of another profile under a prefix
+   * @param other - the other profile
+   * @param prefix - the path we put the operators under
+   */
+  void merge(const PDBProfile &other, const std::vector<std::string> &prefix = {});
+
+  /**
+   * Adds all the operators of a profile that was sent over the wire under a prefix
+   * @param entries - the entries of the profile
+   * @param prefix - the path we put the operators under
+   */
+  void merge(const pdb::Vector<pdb::Handle<PDBProfileEntry>> &entries, const std::vector<std::string> &prefix = {});
+
+  /**
+   * Puts the operators into a vector so the profile can be sent over the wire, has to be called with an allocation
+   * block that can fit the entries
+   * @param entries - where we put them
+   */
+  void toVector(pdb::Vector<pdb::Handle<PDBProfileEntry>> &entries) const;
+
+  /**
+   * Returns how large the allocation block has to be for the vector of entries of this profile
+   * @return the size in bytes
+   */
+  size_t getVectorSize() const;
+
+  /**
+   * Returns how large the allocation block has to be to copy a vector of entries that was sent over the wire
+   * @param entries - the entries
+   * @return the size in bytes
+   */
+  static size_t getVectorSize(const pdb::Vector<pdb::Handle<PDBProfileEntry>> &entries);
+
+  /**
+   * Returns the operators in tree order, each operator is followed by its children in the order they were added
+   * @return the operators
+   */
+  std::vector<Entry> getEntries() const;
+
+  /**
+   * Returns the stats of an operator
+   * @param path - the path of the operator
+   * @param stats - the stats if we have the operator
+   * @return true if we have it
+   */
+  bool getStats(const std::vector<std::string> &path, PDBOperatorStats &stats) const;
+
+  /**
+   * Returns the pages and the bytes the sources of all the pipelines in the profile scanned
+   */
+  PDBOperatorStats getScanStats() const;
+
+  /**
+   * Is the profile empty
+   */
+  bool isEmpty() const;
+
+  /**
+   * Renders the profile as text, one operator per line indented by its depth
+   * @return the text
+   */
+  std::string toString() const;
+
+ private:
+
+  /**
+   * Adds the stats of an operator without locking
+   */
+  void addUnsafe(const std::vector<std::string> &path, const PDBOperatorStats &stats);
+
+  /**
+   * Returns the operators in tree order without locking
+   */
+  std::vector<Entry> getEntriesUnsafe() const;
+
+  // the operators in the order they were added
+  std::vector<Entry> entries;
+
+  // the index of each operator by its path
+  std::map<std::vector<std::string>, size_t> index;
+
+  // locks the operators
+  mutable std::mutex m;
+};
+
+}
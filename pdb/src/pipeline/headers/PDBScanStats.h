@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace pdb {
+
+/**
+ * The stats about the pages a source of a pipeline read, these are reported by the physical algorithms once the
+ * pipeline is finished.
+ */
+struct PDBScanStats {
+
+  // the number of pages the source went through
+  uint64_t numPages{0};
+
+  // the number of bytes on those pages
+  uint64_t numPageBytes{0};
+
+  // the number of bytes the source actually read from them, a columnar scan only reads the columns it needs
+  uint64_t numBytesRead{0};
+};
+
+}
@@ -6,6 +6,10 @@
 #define PDB_ABSTRACTPIPELINE_H
 
 #include <memory>
+#include <cstdint>
+#include <pipeline/PDBTupleSetSizePolicy.h>
+#include "PDBScanStats.h"
+#include "PDBProfile.h"
 
 namespace pdb {
 
@@ -18,6 +22,31 @@ public:
    * Runs the pipeline
    */
   virtual void run() = 0;
+
+  /**
+   * Returns the number of tuples the pipeline had to process again, because it ran out of space in the middle of
+   * processing them.
+   * @return the number of tuples
+   */
+  virtual uint64_t getNumRetriedTuples() { return 0; }
+
+  /**
+   * Returns the stats about the sizes of the tuple sets the pipeline used to process the input
+   * @return the stats
+   */
+  virtual PDBTupleSetSizeStats getTupleSetSizeStats() { return PDBTupleSetSizeStats{}; }
+
+  /**
+   * Returns the stats about the pages the source of the pipeline read
+   * @return the stats
+   */
+  virtual PDBScanStats getScanStats() { return PDBScanStats{}; }
+
+  /**
+   * Returns the profile of the pipeline after it has run, the pipeline is the root and its operators are the children
+   * @return the profile
+   */
+  virtual PDBProfile getProfile() { return PDBProfile{}; }
 };
 
 typedef std::shared_ptr<PipelineInterface> PipelinePtr;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <ComputeInfo.h>
+
+namespace pdb {
+
+class ScanAttributesArg;
+using ScanAttributesArgPtr = std::shared_ptr<ScanAttributesArg>;
+
+/**
+ * Tells a scan what the pipeline does with the records it reads. If the pipeline only accesses their attributes and
+ * calls their methods a scan of a columnar set only reads the columns those need, if it only accesses attributes
+ * right on the tuple sets of the scan it does not have to make the records at all @see ColumnarTupleSetIterator
+ */
+class ScanAttributesArg : public ComputeInfo {
+ public:
+
+  ScanAttributesArg(bool onlyMembers,
+                    bool onlyAttributes,
+                    std::set<std::string> attributes,
+                    std::set<std::string> methods) : onlyMembers(onlyMembers),
+                                                     onlyAttributes(onlyAttributes),
+                                                     attributes(std::move(attributes)),
+                                                     methods(std::move(methods)) {}
+
+  /**
+   * True if the records are only used to access their attributes and call their methods
+   */
+  bool onlyMembers;
+
+  /**
+   * True if the records are only used to access their attributes, directly on the tuple sets of the scan
+   */
+  bool onlyAttributes;
+
+  /**
+   * The names of the attributes that are accessed
+   */
+  std::set<std::string> attributes;
+
+  /**
+   * The names of the methods that are called
+   */
+  std::set<std::string> methods;
+};
+
+}
@@ -22,6 +22,7 @@
 #include "Handle.h"
 #include "PDBVector.h"
 #include "Ptr.h"
+#include "PDBColumnarChunk.h"
 #include <functional>
 #include <utility>
 
@@ -162,6 +163,9 @@ class TupleSet {
   // (that filters rows from the column)
   std::map<int, std::pair<void *, MaintenanceFuncs>> columns;
 
+  // the columns that come from a columnar set, they are only kept as long as the rows of the column stay the same
+  std::map<int, PDBColumnarChunk *> columnarChunks;
+
  public:
 
   // get the number of columns in this TupleSet
@@ -181,6 +185,9 @@ class TupleSet {
 
   static void split(const TupleSet& lhs, TupleSet& rhs, uint64_t where) {
 
+    // the rows of the columns change so the chunks don't match them anymore
+    rhs.columnarChunks.clear();
+
     // go through each column and split them
     for(auto &c : lhs.columns) {
 
@@ -211,6 +218,9 @@ class TupleSet {
 
   static void merge(TupleSet& lhs, TupleSet& rhs) {
 
+    // the rows of the columns change so the chunks don't match them anymore
+    lhs.columnarChunks.clear();
+
     // go through each column and merge them
     for(auto &r : rhs.columns) {
 
@@ -295,6 +305,21 @@ class TupleSet {
     return columns.count(whichColumn) != 0;
   }
 
+  // attaches the chunk of a columnar set to a column, the attributes of its records can be taken from the chunk
+  void setColumnarChunk(int whichColumn, PDBColumnarChunk *chunk) {
+    if (chunk == nullptr) {
+      columnarChunks.erase(whichColumn);
+      return;
+    }
+    columnarChunks[whichColumn] = chunk;
+  }
+
+  // returns the chunk of a columnar set attached to a column, null if there is none
+  PDBColumnarChunk *getColumnarChunk(int whichColumn) {
+    auto it = columnarChunks.find(whichColumn);
+    return it == columnarChunks.end() ? nullptr : it->second;
+  }
+
   ~TupleSet() {
 
     // delete all of the columns
@@ -325,6 +350,9 @@ class TupleSet {
 
       // remember that we need to delete it
       value.second.mustDelete = true;
+
+      // the rows are not the ones of the chunk anymore
+      columnarChunks.erase(whichColToFilter);
       return;
     }
 
@@ -356,6 +384,18 @@ class TupleSet {
 
     // and go ahead and remember the column
     columns[whichColToCopyTo] = std::make_pair(newCol, temp);
+
+    // the rows are not the ones of the chunk anymore
+    columnarChunks.erase(whichColToCopyTo);
+  }
+
+  // returns the number of rows in the tuple set, all the columns have the same number of rows so we use the first one
+  int getNumRows() {
+    if (columns.empty()) {
+      return 0;
+    }
+    auto &column = columns.begin()->second;
+    return column.second.getCount(column.first);
   }
 
   int getNumRows(int whichColumn) {
@@ -387,6 +427,9 @@ class TupleSet {
 
     // and go ahead and remember the column
     columns[whichColToCopyTo] = std::make_pair(value.first, temp);
+
+    // the rows are the same, so is the chunk
+    setColumnarChunk(whichColToCopyTo, fromMe->getColumnarChunk(whichColInFromMe));
   }
 
   // creates a new column, adding it to the tuple set
@@ -401,6 +444,9 @@ class TupleSet {
       }
     }
 
+    // a new column has no chunk
+    columnarChunks.erase(where);
+
     // now, add the new column... this reqires creating three lambdas to deal with
     // column maintenance.  The first lamba deletes the column, correctly taking into
     // account the type of the column...
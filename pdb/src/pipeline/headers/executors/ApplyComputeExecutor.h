@@ -23,7 +23,9 @@
 
 #include "TupleSet.h"
 #include "ComputeExecutor.h"
+#include "InterfaceFunctions.h"
 #include <memory>
+#include <cmath>
 
 namespace pdb {
 
@@ -41,6 +43,10 @@ private:
   // this is a lambda that we'll call to process input
   std::function<TupleSetPtr(TupleSetPtr)> processInput;
 
+  // the most bytes of the allocation block the lambda needed per input row so far, the objects a lambda makes
+  // are usually about the same size every time so this tells us what the next tuple set is going to need
+  double maxBytesPerRow = 0;
+
 public:
 
 	ApplyComputeExecutor(TupleSetPtr outputIn, std::function<TupleSetPtr(TupleSetPtr)> processInputIn) {
@@ -49,7 +55,24 @@ public:
     }
 
     TupleSetPtr process(TupleSetPtr input) override {
-      return processInput(input);
+
+      // remember how much we had before we run the lambda
+      auto numRows = input->getNumRows();
+      auto initialFree = getAllocator().getFreeBytesAtTheEnd();
+
+      auto result = processInput(input);
+
+      // if we stayed in the same block we know how much the lambda needed
+      auto finalFree = getAllocator().getFreeBytesAtTheEnd();
+      if (numRows > 0 && finalFree <= initialFree) {
+        maxBytesPerRow = std::max(maxBytesPerRow, (double) (initialFree - finalFree) / numRows);
+      }
+
+      return result;
+    }
+
+    uint64_t bytesNeeded(TupleSetPtr input) override {
+      return (uint64_t) std::ceil(maxBytesPerRow * input->getNumRows());
     }
 };
 
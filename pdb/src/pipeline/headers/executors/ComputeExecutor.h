@@ -37,6 +37,11 @@ public:
   // precess a tuple set
   virtual TupleSetPtr process(TupleSetPtr input) = 0;
 
+  // estimates how many bytes of the current allocation block processing the tuple set is going to need,
+  // so that the pipeline can make room before calling process, zero if we can not tell. Most executors only
+  // fill std::vector columns and allocate nothing in the block, the ones that do override this
+  virtual uint64_t bytesNeeded(TupleSetPtr input) { return 0; }
+
 };
 
 }
@@ -27,6 +27,18 @@ private:
   // the merger sink
   pdb::ComputeSinkPtr merger;
 
+  // the output the aggregation already has, if it is incremental, null otherwise
+  pdb::PDBAbstractPageSetPtr existingOutputPageSet;
+
+  // the merger of the output the aggregation already has
+  pdb::ComputeSinkPtr existingOutputMerger;
+
+  // the stats of the merge
+  PDBOperatorStats mergeStats;
+
+  // the page of the output page set the hash table was written to
+  uint64_t outputPage = 0;
+
 public:
 
   AggregationPipeline(size_t workerID,
@@ -34,8 +46,20 @@ public:
                       const PDBAbstractPageSetPtr &inputPageSet,
                       const ComputeSinkPtr &merger);
 
+  AggregationPipeline(size_t workerID,
+                      const PDBAnonymousPageSetPtr &outputPageSet,
+                      const PDBAbstractPageSetPtr &inputPageSet,
+                      const ComputeSinkPtr &merger,
+                      const PDBAbstractPageSetPtr &existingOutputPageSet,
+                      const ComputeSinkPtr &existingOutputMerger);
+
   void run() override;
 
+  PDBProfile getProfile() override;
+
+  // returns the number of the page in the output page set the hash table was written to, once the pipeline ran
+  uint64_t getOutputPage();
+
 };
 
 }
@@ -29,6 +29,9 @@ class JoinBroadcastPipeline : public PipelineInterface {
   // the merger sink
   pdb::ComputeSinkPtr merger;
 
+  // the stats of the merge
+  PDBOperatorStats mergeStats;
+
  public:
 
   JoinBroadcastPipeline(size_t workerID,
@@ -38,6 +41,8 @@ class JoinBroadcastPipeline : public PipelineInterface {
 
   void run() override;
 
+  PDBProfile getProfile() override;
+
 };
 
 }
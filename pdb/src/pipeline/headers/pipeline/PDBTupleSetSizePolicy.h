@@ -1,34 +1,96 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <list>
+#include <unordered_map>
 
 namespace pdb {
 
+/**
+ * The stats about the tuple set sizes a pipeline used, these are reported by the physical algorithms once the pipeline
+ * is finished.
+ */
+struct PDBTupleSetSizeStats {
+
+  // the chunk size we started with, either the default one or the one from a learned model
+  int32_t initialChunkSize{0};
+
+  // the smallest chunk size we have chosen
+  int32_t minChunkSize{0};
+
+  // the largest chunk size we have chosen
+  int32_t maxChunkSize{0};
+
+  // the chunk size we ended with
+  int32_t finalChunkSize{0};
+
+  // the number of chunks that we have successfully processed
+  uint64_t numChunks{0};
+
+  // the number of times the pipeline failed to process a chunk
+  uint64_t numFailures{0};
+
+  // true if we started from a model learned by a previous pipeline with the same signature
+  bool usedLearnedModel{false};
+};
+
+/**
+ * The tuple set size policy fits the number of bytes each stage of the pipeline and the sink allocate per input row
+ * and from that picks the largest chunk size that fits into a page with a safety margin.
+ *
+ * The learned model is stored per pipeline signature (the TCAP of the computations in the pipeline) when the pipeline
+ * finishes, so that the next pipeline with the same signature starts with the right chunk size. We keep at most
+ * maxLearnedModels of them and evict the least recently used one when we go over.
+ */
 class PDBTupleSetSizePolicy {
 public:
 
-  explicit PDBTupleSetSizePolicy(uint64_t pageSize);
+  /**
+   * Initializes the policy, if there is a learned model for the signature it is loaded
+   * @param pageSize - the size of the page the pipeline is writing to
+   * @param signature - the signature of the pipeline, if empty no model is loaded or stored
+   */
+  explicit PDBTupleSetSizePolicy(uint64_t pageSize, std::string signature = "");
 
   /**
    * This is supposed to be called to indicate that the pipeline failed while we were processing it.
    */
   void pipelineFailed();
 
+  /**
+   * This is supposed to be called when a stage of the pipeline processed the chunk without switching pages
+   * @param stage - the index of the stage
+   * @param numRows - the number of rows the chunk had when we got it from the source
+   * @param initialFree - how much was free before the stage was run
+   * @param finalFree - how much was free after the stage was run
+   */
+  void stageSucceeded(size_t stage, uint64_t numRows, uint64_t initialFree, uint64_t finalFree);
+
   /**
    * This is supposed to be called
+   * @param numRows - the number of rows the chunk had when we got it from the source
    * @param additionalPagesUsed - how many additional pages were used to process the pipeline
    * @param initialFree - how much did we have initially in the page we started with
    * @param finalFree - how much did we have in the page we ended with
    */
-  void pipelineSucceeded(uint64_t additionalPagesUsed, uint64_t initialFree, uint64_t finalFree);
+  void pipelineSucceeded(uint64_t numRows, uint64_t additionalPagesUsed, uint64_t initialFree, uint64_t finalFree);
 
   /**
    * This is supposed to be called if a write to a page succeeded
-   * @param initialFree - how much did we have initially in the page we started with
+   * @param additionalPages - how many additional pages we needed to do the write
+   * @param initialFree - how much did we have in the page right before the write
    * @param finalFree - how much did we have in the page we ended with
    */
   void writeToPageSucceeded(uint64_t additionalPages, uint64_t initialFree, uint64_t finalFree);
 
+  /**
+   * Stores the learned model under the signature of this policy so the next pipeline with the same signature can use it
+   */
+  void saveModel();
+
   /**
    * This will tell us if the input was processed or not. It will be used by the source to know if it should use the
    * the same input again
@@ -42,8 +104,64 @@ public:
    */
   int32_t getChunksSize() const;
 
+  /**
+   * Returns the stats about the chunk sizes we have chosen and the failures we had
+   * @return the stats
+   */
+  const PDBTupleSetSizeStats &getStats() const;
+
+  /**
+   * Removes all the learned models
+   */
+  static void forgetLearnedModels();
+
+  /**
+   * Returns the number of learned models we are currently keeping
+   * @return the number of models
+   */
+  static size_t numLearnedModels();
+
+  /**
+   * The maximum number of learned models we keep, once we go over this the least recently used one is evicted
+   */
+  static const size_t maxLearnedModels = 1024;
+
 protected:
 
+  /**
+   * The model we are learning, for each stage and the sink it has the number of bytes that are allocated per input row
+   */
+  struct Model {
+
+    // the bytes per input row each stage allocates
+    std::vector<double> stageBytesPerRow;
+
+    // the bytes per input row the sink allocates
+    double sinkBytesPerRow = 0;
+
+    // every time the pipeline fails we know that the chunk needs at least pageSize / chunkSize bytes per row
+    double minBytesPerRow = 0;
+  };
+
+  /**
+   * Updates a coefficient of the model with a new observation
+   * @param coefficient - the coefficient
+   * @param observed - the observed value
+   */
+  static void fit(double &coefficient, double observed);
+
+  /**
+   * Sets the new chunk size and updates the stats
+   * @param newChunkSize - the new chunk size
+   */
+  void updateChunkSize(int32_t newChunkSize);
+
+  /**
+   * Returns the largest chunk size that fits into a page according to the model
+   * @return the chunk size or -1 if the model has no observations
+   */
+  int32_t modelChunkSize() const;
+
   /**
    * This is the size the policy has at the beginning of pipeline
    */
@@ -58,21 +176,21 @@ protected:
   int32_t maxChunkSize = 100;
 
   /**
-   * The the last known chunk size we know the write succeeded.
-   * This is used to restore back the the value of the chunk if we went too low.
+   * We size the chunks so that they use at most this fraction of the page
    */
-  int32_t lastChunkSizeForWrite = -1;
+  constexpr static double pageUsage = 0.8;
 
   /**
-   * The last size that was fully successful
+   * How much weight does a new observation have when we fit the coefficients
    */
-  int32_t lastFullySuccessfulSize = -1;
-
-  int32_t pipelineRetry = 3;
+  constexpr static double learningRate = 0.25;
 
   // pipeline stats
   struct {
 
+    // the number of rows in the chunk
+    uint64_t numRows{0};
+
     // the initial free memory in the pipeline
     uint64_t initialFree{0};
 
@@ -87,33 +205,26 @@ protected:
 
   } pipeline;
 
-  // write stats
-  struct {
+  // the model we are fitting
+  Model model;
 
-    // the initial free memory in the pipeline
-    uint64_t initialFree{0};
+  // the stats about the chunk sizes
+  PDBTupleSetSizeStats stats;
 
-    // the final free memory in the pipeline
-    uint64_t finalFree{0};
+  // the signature of the pipeline
+  std::string signature;
 
-    // the number of additional pages added
-    uint64_t numAdditionalPages{0};
-
-  } writeStats;
-
-  // did we increment the previous time
-  bool lastIncremented = false;
+  // the size of the page
+  uint64_t pageSize;
 
-  // do we still allow increments?
-  // basically if we have an increment and after that increment there is a failure we disable the increments.
-  bool allowIncrements = true;
+  // the learned models of the finished pipelines, the most recently used one is at the front
+  static std::list<std::pair<std::string, Model>> learnedModels;
 
-  // in case the pipeline is using multiple pages to finish we want to decrease the chunk size until it can
-  // finish without using additional pages since we need to redo expensive steps otherwise.
-  bool tryToMakePipelineSucceed = true;
+  // maps the signature to the position of its model in the learnedModels list
+  static std::unordered_map<std::string, std::list<std::pair<std::string, Model>>::iterator> learnedModelsIndex;
 
-  // the size of the page
-  uint64_t pageSize;
+  // the lock for the learned models
+  static std::mutex learnedModelsLock;
 };
 
 }
@@ -63,6 +63,30 @@ class Pipeline : public PipelineInterface {
   // this determines the size of the tuple set when running the pipeline
   PDBTupleSetSizePolicy tupleSetSizePolicy;
 
+  // the number of tuples we had to process again because we ran out of space
+  uint64_t numRetriedTuples = 0;
+
+  // the name of the pipeline and the names of its stages, used in the profile
+  std::string name = "pipeline";
+  std::vector<std::string> stageNames;
+
+  // the stats of the whole pipeline, the source, the stages, the sink and the page processor
+  PDBOperatorStats pipelineStats;
+  PDBOperatorStats sourceStats;
+  std::vector<PDBOperatorStats> stageStats;
+  PDBOperatorStats sinkStats;
+  PDBOperatorStats processorStats;
+
+  // grabs the next tuple set from the source and counts its rows
+  TupleSetPtr getNextTupleSet();
+
+  // grabs a new page from the output page set to write to and counts it
+  MemoryHolderPtr getNewPage();
+
+  // makes sure that numBytes can be allocated from the current page, if they can not we move to a new page
+  // and increment additionalPagesUsed. Returns false if they do not fit even into the new page
+  bool makeRoom(MemoryHolderPtr &ram, uint64_t numBytes, int iteration, uint64_t &additionalPagesUsed);
+
   // cleans the pipeline from all the leftover pages
   void cleanPipeline();
 
@@ -74,12 +98,20 @@ class Pipeline : public PipelineInterface {
   // the first argument is a function to call that gets a new output page...
   // the second argument is a function to call that deals with a full output page
   // the third argument is the iterator that will create TupleSets to process
-  Pipeline(const PDBAnonymousPageSetPtr &outputPageSet, ComputeSourcePtr dataSource, ComputeSinkPtr tupleSink, PageProcessorPtr pageProcessor);
+  // the signature identifies the computations in the pipeline so that the tuple set sizes can be learned across jobs
+  Pipeline(const PDBAnonymousPageSetPtr &outputPageSet,
+           ComputeSourcePtr dataSource,
+           ComputeSinkPtr tupleSink,
+           PageProcessorPtr pageProcessor,
+           const std::string &signature = "");
 
   ~Pipeline() override;
 
-  // adds a stage to the pipeline
-  void addStage(const ComputeExecutorPtr& addMe);
+  // adds a stage to the pipeline, the name is used in the profile
+  void addStage(const ComputeExecutorPtr& addMe, const std::string &stageName = "");
+
+  // sets the name of the pipeline that is used in the profile
+  void setName(const std::string &pipelineName);
 
   // store page
   void addPageToIteration(const pdb::MemoryHolderPtr& ram, int iteration);
@@ -87,6 +119,18 @@ class Pipeline : public PipelineInterface {
   // runs the pipeline
   void run() override;
 
+  // returns the number of tuples we had to process again
+  uint64_t getNumRetriedTuples() override;
+
+  // returns the stats about the tuple set sizes the pipeline used
+  PDBTupleSetSizeStats getTupleSetSizeStats() override;
+
+  // returns the stats about the pages the source read
+  PDBScanStats getScanStats() override;
+
+  // returns the profile of the source, the stages, the sink and the page processor
+  PDBProfile getProfile() override;
+
 };
 
 }
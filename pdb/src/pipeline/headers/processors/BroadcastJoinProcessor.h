@@ -10,6 +10,7 @@
 #include <PageProcessor.h>
 #include <PDBPageHandle.h>
 #include <PDBBufferManagerInterface.h>
+#include <PDBMetrics.h>
 #include <JoinMap.h>
 
 namespace pdb {
@@ -51,6 +52,7 @@ class BroadcastJoinProcessor : public PageProcessor {
     for (auto node = 0; node < numNodes; ++node) {
       pageQueues[node]->enqueue(memory->pageHandle);
     }
+    PDBMetrics::get().pageQueuePages.inc(numNodes);
 
     memory->pageHandle->unpin();
     return false;
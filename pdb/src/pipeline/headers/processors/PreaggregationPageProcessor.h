@@ -10,6 +10,7 @@
 #include <PageProcessor.h>
 #include <PDBPageHandle.h>
 #include <PDBBufferManagerInterface.h>
+#include <PDBMetrics.h>
 
 namespace pdb {
 
@@ -71,6 +72,7 @@ public:
 
       // add the page to the page queue
       pageQueues[node]->enqueue(page);
+      PDBMetrics::get().pageQueuePages.inc();
     }
 
     return false;
@@ -10,6 +10,7 @@
 #include <PageProcessor.h>
 #include <PDBPageHandle.h>
 #include <PDBBufferManagerInterface.h>
+#include <PDBMetrics.h>
 #include <JoinMap.h>
 
 namespace pdb {
@@ -76,6 +77,7 @@ public:
 
       // add the page to the page queue
       pageQueues[node]->enqueue(page);
+      PDBMetrics::get().pageQueuePages.inc();
     }
 
     return false;
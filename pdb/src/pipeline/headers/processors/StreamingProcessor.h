@@ -0,0 +1,40 @@
+#ifndef PDB_STREAMINGPROCESSOR_H
+#define PDB_STREAMINGPROCESSOR_H
+
+#include <utility>
+#include <PageProcessor.h>
+#include <PDBStreamingPageSet.h>
+
+namespace pdb {
+
+/**
+ * This processor keeps every page like the @see NullProcessor, but also hands it to the algorithm that reads the page
+ * set while we make it.
+ */
+class StreamingProcessor : public PageProcessor {
+
+public:
+
+  explicit StreamingProcessor(PDBStreamingPageSetPtr pageSet) : pageSet(std::move(pageSet)) {}
+
+  /**
+   * Feeds the page to the stream, the page is done once the pipeline writes it out
+   * @param memory - the memory with the page and the output sink
+   * @return - always true, the page stays in the page set
+   */
+  bool process(const MemoryHolderPtr &memory) override {
+    pageSet->feedPage(memory->pageHandle);
+    return true;
+  }
+
+private:
+
+  /**
+   * The stream we feed the pages to
+   */
+  PDBStreamingPageSetPtr pageSet;
+};
+
+}
+
+#endif //PDB_STREAMINGPROCESSOR_H
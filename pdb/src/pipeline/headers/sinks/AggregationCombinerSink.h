@@ -6,6 +6,7 @@
 #define PDB_AGGREGATIONCOMBINERSINK_H
 
 #include <ComputeSink.h>
+#include <EqualsLambda.h>
 #include <stdexcept>
 #include <PDBPageHandle.h>
 
@@ -17,6 +18,18 @@ public:
 
   explicit AggregationCombinerSink(size_t workerID) : workerID(workerID) {}
 
+  /**
+   * Makes a combiner that merges the maps an earlier run of the aggregation wrote to its output set, instead of the
+   * preaggregated maps. The keys of the output might have gone to a different worker, so only the ones that hash to the
+   * partition of this worker are merged.
+   * @param workerID - the id of the worker
+   * @param partition - the partition of the worker, the same one the preaggregation hashes the keys to
+   * @param numPartitions - the number of partitions, the number of nodes times the number of threads
+   */
+  AggregationCombinerSink(size_t workerID, size_t partition, size_t numPartitions) : workerID(workerID),
+                                                                                    partition(partition),
+                                                                                    numPartitions(numPartitions) {}
+
   Handle<Object> createNewOutputContainer() override {
 
     // we simply create a new map to store the output
@@ -31,13 +44,19 @@ public:
     // cast the hash table we are merging to
     Map<KeyType, ValueType> &mergeToMe = *unsafeCast <Map<KeyType, ValueType>> (writeToMe);
 
-    // grab the hash table
+    // grab the hash table, the output of the aggregation has one map on the page, the preaggregation one for every worker
     Handle<Object> hashTable = ((Record<Object> *) page->getBytes())->getRootObject();
-    auto mergeMe = (*unsafeCast<Vector<Handle<Map<KeyType, ValueType>>>>(hashTable))[workerID];
+    auto mergeMe = numPartitions != 0 ? unsafeCast<Map<KeyType, ValueType>>(hashTable) :
+                                        (*unsafeCast<Vector<Handle<Map<KeyType, ValueType>>>>(hashTable))[workerID];
 
     // go through each key, value pair in the hash map we want to merge
     for(auto it = mergeMe->begin(); it != mergeMe->end(); ++it) {
 
+      // if we are merging the output skip the keys of the other workers
+      if (numPartitions != 0 && hashHim((*it).key) % numPartitions != partition) {
+        continue;
+      }
+
       // if this key is not already there...
       if (mergeToMe.count ((*it).key) == 0) {
 
@@ -96,6 +115,16 @@ private:
    * The id of the worker
    */
   size_t workerID = 0;
+
+  /**
+   * The partition of the worker if we are merging the output of the aggregation
+   */
+  size_t partition = 0;
+
+  /**
+   * The number of partitions if we are merging the output of the aggregation, 0 if we are merging preaggregated maps
+   */
+  size_t numPartitions = 0;
 };
 
 }
@@ -25,6 +25,38 @@ class PreaggregationSink : public ComputeSink {
   // how many partitions do we have
   size_t numPartitions;
 
+  // the hashes of the keys of the tuple set bytesNeeded was last called with, so that writeOut does not hash them again
+  std::vector<size_t> hashes;
+
+  // how many of those keys go to each partition
+  std::vector<uint32_t> keysPerPartition;
+
+  // the key column the hashes belong to, null if we don't have them
+  const KeyType *hashedKeys = nullptr;
+
+  // hashes the keys of the tuple set unless we already did
+  void hashKeys(std::vector<KeyType> &keyColumn) {
+
+    // do we already have them
+    if (hashedKeys == keyColumn.data() && hashes.size() == keyColumn.size()) {
+      return;
+    }
+
+    // hash them and count how many keys are going to go to each partition
+    hashes.resize(keyColumn.size());
+    keysPerPartition.assign(numPartitions, 0);
+    for (size_t i = 0; i < keyColumn.size(); ++i) {
+      hashes[i] = hashHim(keyColumn[i]);
+      keysPerPartition[hashes[i] % numPartitions]++;
+    }
+    hashedKeys = keyColumn.data();
+  }
+
+  // the tuple set is changed or gone so we can not use the hashes anymore
+  void forgetHashes() {
+    hashedKeys = nullptr;
+  }
+
  public:
 
   PreaggregationSink(TupleSpec &inputSchema, TupleSpec &attsToOperateOn, size_t numPartitions) : numPartitions(numPartitions) {
@@ -66,12 +98,15 @@ class PreaggregationSink : public ComputeSink {
     std::vector<KeyType> &keyColumn = input->getColumn<KeyType>(whichAttToHash);
     std::vector<ValueType> &valueColumn = input->getColumn<ValueType>(whichAttToAggregate);
 
+    // hash the keys unless bytesNeeded already did
+    hashKeys(keyColumn);
+
     // and aggregate everyone
     size_t length = keyColumn.size();
     for (size_t i = 0; i < length; i++) {
 
-      // hash the key
-      auto hash = hashHim(keyColumn[i]);
+      // grab the hash of the key
+      auto hash = hashes[i];
 
       // get the map we are adding to
       Map<KeyType, ValueType> &myMap = (*(*vectorOfMaps)[hash % numPartitions]);
@@ -92,6 +127,7 @@ class PreaggregationSink : public ComputeSink {
 
           // if we got here, then we ran out of space, and so we need to delete the already-processed
           // data so that we can try again...
+          forgetHashes();
           keyColumn.erase(keyColumn.begin(), keyColumn.begin() + i);
           valueColumn.erase(valueColumn.begin(), valueColumn.begin() + i);
           throw n;
@@ -108,6 +144,7 @@ class PreaggregationSink : public ComputeSink {
           myMap.setUnused(keyColumn[i]);
 
           // and erase all of these guys from the tuple set since they were processed
+          forgetHashes();
           keyColumn.erase(keyColumn.begin(), keyColumn.begin() + i);
           valueColumn.erase(valueColumn.begin(), valueColumn.begin() + i);
           throw n;
@@ -132,12 +169,48 @@ class PreaggregationSink : public ComputeSink {
           temp = copy;
 
           // and erase all of the guys who were processed
+          forgetHashes();
           keyColumn.erase(keyColumn.begin(), keyColumn.begin() + i);
           valueColumn.erase(valueColumn.begin(), valueColumn.begin() + i);
           throw n;
         }
       }
     }
+
+    // the next tuple set has different keys
+    forgetHashes();
+  }
+
+  uint64_t bytesNeeded(TupleSetPtr input, Handle<Object> &writeToMe) override {
+
+    // cast the thing to the map of maps
+    Handle<Vector<Handle<Map<KeyType, ValueType>>>> vectorOfMaps = unsafeCast<Vector<Handle<Map<KeyType, ValueType>>>>(writeToMe);
+
+    // hash the keys, writeOut uses the hashes so we do it only once
+    hashKeys(input->getColumn<KeyType>(whichAttToHash));
+
+    // in the worst case every key is new, so we sum up what reserve needs to grow each map
+    uint64_t numBytes = 0;
+    for (size_t i = 0; i < numPartitions; ++i) {
+      auto &myMap = (*vectorOfMaps)[i];
+      numBytes += myMap->getArray()->bytesNeededToGrowToFit(myMap->size() + keysPerPartition[i]);
+    }
+
+    return numBytes;
+  }
+
+  void reserve(TupleSetPtr input, Handle<Object> &writeToMe) override {
+
+    // cast the thing to the map of maps
+    Handle<Vector<Handle<Map<KeyType, ValueType>>>> vectorOfMaps = unsafeCast<Vector<Handle<Map<KeyType, ValueType>>>>(writeToMe);
+
+    // grow each map once so it can hold every key of the tuple set, instead of doubling it while we write. Since we
+    // assume every key is new a map is at most doubled once more than it would have been anyway
+    hashKeys(input->getColumn<KeyType>(whichAttToHash));
+    for (size_t i = 0; i < numPartitions; ++i) {
+      auto &myMap = (*vectorOfMaps)[i];
+      myMap->reserve(myMap->size() + keysPerPartition[i]);
+    }
   }
 
   void writeOutPage(pdb::PDBPageHandle &page, Handle<Object> &writeToMe) override { throw runtime_error("PreaggregationSink can not write out a page."); }
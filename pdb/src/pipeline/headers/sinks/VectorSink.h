@@ -36,6 +36,26 @@ class VectorSink : public ComputeSink {
   int whichAttToStore;
   int whichAttToAggregate;
 
+  // returns the capacity the vector needs to fit the tuple set, we double it like push_back would so that
+  // growing it stays amortized
+  size_t newCapacity(TupleSetPtr &input, Handle<Vector<Handle<DataType>>> &writeMe) {
+
+    // figure out how large the vector is going to be after we write the tuple set
+    size_t newSize = writeMe->size() + input->getColumn<Handle<DataType>>(whichAttToStore).size();
+
+    // an empty array can not be doubled so we just make it large enough
+    size_t capacity = writeMe->capacity();
+    if (capacity == 0) {
+      return newSize;
+    }
+
+    while (capacity < newSize) {
+      capacity *= 2;
+    }
+
+    return capacity;
+  }
+
  public:
 
   VectorSink(TupleSpec &inputSchema, TupleSpec &attsToOperateOn) {
@@ -81,6 +101,28 @@ class VectorSink : public ComputeSink {
     }
   }
 
+  uint64_t bytesNeeded(TupleSetPtr input, Handle<Object> &writeToMe) override {
+
+    // get the vector we are adding to
+    Handle<Vector<Handle<DataType>>> writeMe = unsafeCast<Vector<Handle<DataType>>>(writeToMe);
+
+    // if it fits in the current array we don't need to allocate a new one
+    auto capacity = newCapacity(input, writeMe);
+    if (capacity == writeMe->capacity()) {
+      return 0;
+    }
+
+    // otherwise reserve allocates one array that can fit everything
+    return getAllocatedSizeForObject(sizeof(Array<Handle<DataType>>) + capacity * sizeof(Handle<DataType>));
+  }
+
+  void reserve(TupleSetPtr input, Handle<Object> &writeToMe) override {
+
+    // grow the array once instead of doubling it while we write
+    Handle<Vector<Handle<DataType>>> writeMe = unsafeCast<Vector<Handle<DataType>>>(writeToMe);
+    writeMe->reserve(newCapacity(input, writeMe));
+  }
+
   void writeOutPage(pdb::PDBPageHandle &page, Handle<Object> &writeToMe) override { throw runtime_error("VectorSink can not write out a page."); }
 };
 
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <memory>
+#include <stdexcept>
+#include <ComputeSource.h>
+#include <PDBColumnarChunk.h>
+#include <PDBColumnarPage.h>
+#include <PDBColumns.h>
+#include <PDBPageLookahead.h>
+#include <PDBAbstractPageSet.h>
+#include <UseTemporaryAllocationBlock.h>
+
+namespace pdb {
+
+/**
+ * This class iterates over the pages of a columnar set @see PDBColumnarPage, breaking them up into a series of TupleSet
+ * objects. The pages are decoded into a block of memory this iterator owns. If the pipeline needs the records they are
+ * made from the columns it reads, otherwise only the columns of the attributes the pipeline reads are decoded, the
+ * column of the records has null handles and the attributes are served through @see PDBColumnarChunk.
+ */
+template<class T>
+class ColumnarTupleSetIterator : public ComputeSource, public PDBColumnarChunk {
+
+ private:
+
+  /**
+   * A decoded page
+   */
+  struct DecodedPage {
+
+    // the memory where the records and the values of the attributes live, declared first so it is freed last
+    std::unique_ptr<char[]> block;
+
+    // the number of records on the page
+    size_t numRows = 0;
+
+    // the records if we make them
+    Handle<Vector<Handle<T>>> rows;
+
+    // the type and the values of each attribute if we don't make the records
+    std::map<std::string, std::pair<const std::type_info*, PDBColumnDataPtr>> attributes;
+  };
+
+  using DecodedPagePtr = std::shared_ptr<DecodedPage>;
+
+  // grabs the pages from the page set we are iterating over, keeping the next few of them pinned ahead
+  PDBPageLookaheadPtr lookahead;
+
+  // the page we are currently iterating over
+  DecodedPagePtr curPage;
+
+  // the page we were using before
+  DecodedPagePtr lastPage;
+
+  // do we make the records or just decode the attributes
+  bool makeRecords;
+
+  // do we read every column
+  bool allColumns;
+
+  // the columns we read if we don't read all of them
+  std::set<std::string> columns;
+
+  // the stats about the pages we went through
+  PDBScanStats scanStats;
+
+  // where we are in the page
+  size_t pos = 0;
+
+  // where the tuple set we returned last starts
+  size_t chunkStart = 0;
+
+  // the tuple set we return
+  TupleSetPtr output;
+
+  /**
+   * Grabs the next page that has records and decodes it
+   * @return the decoded page or null if there are no more pages
+   */
+  DecodedPagePtr getNextPage() {
+
+    while (true) {
+
+      // grab the page, we don't need it after it is decoded
+      auto page = lookahead->getNextPage();
+      if (page == nullptr) {
+        return nullptr;
+      }
+
+      // decode it and skip it if it is empty
+      auto decoded = decode(page->getBytes());
+      if (decoded->numRows != 0) {
+        return decoded;
+      }
+    }
+  }
+
+  /**
+   * Decodes the bytes of a page
+   * @param bytes - the bytes of the page
+   * @return the decoded page
+   */
+  DecodedPagePtr decode(void *bytes) {
+
+    PDBColumnarPage page(bytes);
+    if (!page.isValid()) {
+      throw std::runtime_error("A page of the columnar set is corrupted.");
+    }
+
+    // count the page and the bytes of the columns we read
+    scanStats.numPages++;
+    scanStats.numPageBytes += page.getNumBytes();
+    if (allColumns) {
+      scanStats.numBytesRead += page.getNumBytes();
+    } else {
+      scanStats.numBytesRead += sizeof(PDBColumnarPage::Header);
+      for (const auto &column : columns) {
+        auto index = page.getColumnIndex(column);
+        scanStats.numBytesRead += index < 0 ? 0 : sizeof(PDBColumnarPage::ColumnHeader) + page.getColumnSize((size_t) index);
+      }
+    }
+
+    auto decoded = std::make_shared<DecodedPage>();
+    decoded->numRows = page.getNumRows();
+    if (decoded->numRows == 0) {
+      return decoded;
+    }
+
+    // start with the size the records had before they were encoded, double it until they fit
+    size_t blockSize = decoded->numRows * page.getRowBytes() + 1024 * 1024;
+    while (true) {
+
+      decoded->block.reset(new char[blockSize]);
+      try {
+
+        const UseTemporaryAllocationBlock tempBlock{decoded->block.get(), blockSize};
+
+        /// 1. Make the records from the columns we read
+
+        if (makeRecords) {
+
+          std::string error;
+          decoded->rows = decodeColumnarPage<T>(page, error, allColumns ? nullptr : &columns);
+          if (decoded->rows == nullptr) {
+            throw std::runtime_error(error);
+          }
+          return decoded;
+        }
+
+        /// 2. Decode only the attributes
+
+        for (const auto &attribute : columns) {
+
+          // find the column, we checked that every attribute has one before we went with this
+          auto column = PDBColumns<T>::get().find(attribute);
+          auto index = page.getColumnIndex(attribute);
+          if (column == nullptr || index < 0) {
+            throw std::runtime_error("The columnar page has no column for the attribute " + attribute + ".");
+          }
+
+          PDBColumnValues values;
+          if (!page.decode((size_t) index, values)) {
+            throw std::runtime_error("A page of the columnar set is corrupted.");
+          }
+          decoded->attributes[attribute] = std::make_pair(&column->getType(), column->makeData(values, decoded->numRows));
+        }
+        return decoded;
+
+      } catch (NotEnoughSpace &n) {
+
+        // drop what we made before we free the memory and try again with twice as much
+        decoded->rows = nullptr;
+        decoded->attributes.clear();
+        blockSize *= 2;
+      }
+    }
+  }
+
+ public:
+
+  /**
+   * Initializes the iterator with a page set from which we are going to grab the pages from.
+   *
+   * @param pageSet - the page set we are going to grab the pages from
+   * @param workerID - the worker id is used a as a parameter @see PDBAbstractPageSetPtr::getNextPage to get a specific page for a worker
+   * @param makeRecords - do we make the records, if not only the columns of the attributes are decoded
+   * @param allColumns - do we read every column, we have to if we make the records for something we know nothing about
+   * @param columns - the columns we read if we don't read all of them
+   */
+  ColumnarTupleSetIterator(PDBAbstractPageSetPtr pageSet, uint64_t workerID, bool makeRecords, bool allColumns, std::set<std::string> columns)
+      : makeRecords(makeRecords), allColumns(allColumns), columns(std::move(columns)) {
+
+    // start grabbing the pages
+    lookahead = std::make_shared<PDBPageLookahead>(std::move(pageSet), workerID);
+
+    // create the tuple set that we'll return during iteration
+    output = std::make_shared<TupleSet>();
+    output->addColumn(0, new std::vector<Handle<Object>>, true);
+
+    // decode the first page
+    curPage = getNextPage();
+  }
+
+  ~ColumnarTupleSetIterator() override {
+
+    // the records in the tuple set point into the pages, so they go first
+    output->getColumn<Handle<Object>>(0).clear();
+    lastPage = nullptr;
+    curPage = nullptr;
+  }
+
+  /**
+   * returns the next tuple set to process, or nullptr if there is not one to process
+   * @return - the mentioned tuple set
+   */
+  TupleSetPtr getNextTupleSet(const PDBTupleSetSizePolicy &policy) override {
+
+    auto &inputColumn = output->getColumn<Handle<Object>>(0);
+
+    /**
+     * 0. In case of failure we need to reprocess the input, the records are still on the page so we just go back
+     */
+
+    if (!policy.inputWasProcessed()) {
+      pos = chunkStart;
+    }
+
+    /**
+     * 1. If we went through an entire cycle nothing references the last page anymore, so we can kill it
+     */
+
+    if (lastPage != nullptr) {
+      inputColumn.clear();
+      lastPage = nullptr;
+    }
+
+    // if we did not get a page we don't have any records..
+    if (curPage == nullptr) {
+      return nullptr;
+    }
+
+    // if we are done with the page move to the next one
+    if (pos == curPage->numRows) {
+
+      lastPage = curPage;
+      curPage = getNextPage();
+      pos = 0;
+
+      // if there are no more pages we are done
+      if (curPage == nullptr) {
+        return nullptr;
+      }
+    }
+
+    /**
+     * 2. Fill up the tuple set
+     */
+
+    auto numToCopy = std::min((size_t) policy.getChunksSize(), curPage->numRows - pos);
+    if (makeRecords) {
+
+      inputColumn.resize(numToCopy);
+      for (size_t i = 0; i < numToCopy; ++i) {
+        inputColumn[i] = (*curPage->rows)[pos + i];
+      }
+    } else {
+
+      // the records are not there, only their number matters
+      inputColumn.clear();
+      inputColumn.resize(numToCopy);
+    }
+
+    // remember where we started and move on
+    chunkStart = pos;
+    pos += numToCopy;
+
+    // the attributes are taken from us if we don't have the records
+    output->setColumnarChunk(0, makeRecords ? nullptr : this);
+    return output;
+  }
+
+  PDBScanStats getScanStats() override {
+    return scanStats;
+  }
+
+  void *getAttribute(const std::string &attName, const std::type_info &type) override {
+
+    // do we have the attribute with that type
+    auto it = curPage->attributes.find(attName);
+    if (it == curPage->attributes.end() || *it->second.first != type) {
+      return nullptr;
+    }
+
+    // the values of the rows in the tuple set
+    return it->second.second->getValue(chunkStart);
+  }
+};
+
+}
@@ -81,16 +81,17 @@ public:
   MapTupleSetIterator(const PDBAbstractPageSetPtr &pageSet, uint64_t workerID, size_t chunkSize) {
 
     // get the page if we have one if we don't set the hash map to null
+    // the map is always on a single page so there is nothing for us to look ahead to
     page = pageSet->getNextPage(workerID);
 
-    // repin the page
-    page->repin();
-
     if(page == nullptr) {
       iterateOverMe = nullptr;
       return;
     }
 
+    // repin the page
+    page->repin();
+
     // get the hash table
     Handle<Object> myHashTable = ((Record<Object> *) page->getBytes())->getRootObject();
     iterateOverMe = unsafeCast<Map<KeyType, ValueType>>(myHashTable);
@@ -1,5 +1,6 @@
 #include <utility>
 #include <PDBAbstractPageSet.h>
+#include <PDBPageLookahead.h>
 #include <ComputeSource.h>
 
 /*****************************************************************************
@@ -32,11 +33,8 @@ class VectorTupleSetIterator : public ComputeSource {
 
  private:
 
-  // the page set over which we are iterating
-  PDBAbstractPageSetPtr pageSet;
-
-  // the id of the worker that is iterating over the page set
-  uint64_t workerID;
+  // grabs the pages from the page set we are iterating over, keeping the next few of them pinned ahead
+  PDBPageLookaheadPtr lookahead;
 
   // the page we are currently iterating over
   PDBPageHandle curPage;
@@ -62,6 +60,16 @@ class VectorTupleSetIterator : public ComputeSource {
   // the buffer where we put records in the case of a failed processing attempt
   std::vector<Handle<Object>> *inputBuffer = nullptr;
 
+  // the stats about the pages we went through, we read every byte of the records
+  PDBScanStats scanStats;
+
+  // adds a page to the stats
+  void countPage() {
+    scanStats.numPages++;
+    scanStats.numPageBytes += curRec->numBytes();
+    scanStats.numBytesRead += curRec->numBytes();
+  }
+
 public:
 
  /**
@@ -71,13 +79,16 @@ public:
   * @param chunkSize - the chunk size tells us how many objects to put into a tuple set
   * @param workerID - the worker id is used a as a parameter @see PDBAbstractPageSetPtr::getNextPage to get a specific page for a worker
   */
-  VectorTupleSetIterator(PDBAbstractPageSetPtr pageSetIn, size_t chunkSize, uint64_t workerID) : pageSet(std::move(pageSetIn)), workerID(workerID) {
+  VectorTupleSetIterator(PDBAbstractPageSetPtr pageSetIn, size_t chunkSize, uint64_t workerID) {
+
+    // start grabbing the pages
+    lookahead = std::make_shared<PDBPageLookahead>(std::move(pageSetIn), workerID);
 
     // create the tuple set that we'll return during iteration
     output = std::make_shared<TupleSet>();
 
-    // set the current page (can be null if there is none)
-    curPage = pageSet->getNextPage(workerID);
+    // set the current page (can be null if there is none), the page is already pinned
+    curPage = lookahead->getNextPage();
 
     // check if we actually have a page
     if(curPage == nullptr) {
@@ -91,15 +102,13 @@ public:
       return ;
     }
 
-    // repin the page
-    curPage->repin();
-
     // extract the vector from the first page if there is no page just set it to null
     curRec = (Record<Vector<Handle<Object>>> *) curPage->getBytes();
     if (curRec != nullptr) {
 
       // get the root object of the page
       iterateOverMe = curRec->getRootObject();
+      countPage();
 
       // create the output vector and put it into the tuple set
       auto *inputColumn = new std::vector<Handle<Object>>;
@@ -209,23 +218,21 @@ public:
       lastRec = curRec;
       lastPage = curPage;
 
-      // try to get another vector
-      curPage = pageSet->getNextPage(workerID);
+      // try to get another vector, the lookahead gives us a pinned page
+      curPage = lookahead->getNextPage();
 
       // if we could not, then we are outta here
       if (curPage == nullptr) {
         return nullptr;
       }
 
-      // repin the page
-      curPage->repin();
-
       // extract the vector from the first page if there is no page just set it to null
       curRec = (Record<Vector<Handle<Object>>> *) curPage->getBytes();
 
       // and reset everything
       iterateOverMe = curRec->getRootObject();
       pos = 0;
+      countPage();
     }
 
     /**
@@ -252,6 +259,10 @@ public:
     return output;
   }
 
+  PDBScanStats getScanStats() override {
+    return scanStats;
+  }
+
 };
 
 }
@@ -1,4 +1,5 @@
 #include <utility>
+#include <sstream>
 
 /*****************************************************************************
  *                                                                           *
@@ -33,6 +34,7 @@
 #include "Parser.h"
 #include "StringIntPair.h"
 #include "JoinBroadcastPipeline.h"
+#include "ScanAttributesArg.h"
 
 
 extern int yydebug;
@@ -55,6 +57,11 @@ ComputeSourcePtr ComputePlan::getComputeSource(AtomicComputationPtr &sourceAtomi
   // get a reference to the computations of the logical plan
   auto &allComps = myPlan->getComputations();
 
+  // if we are scanning a set tell the scan what the pipeline does with the records
+  if(sourceAtomicComputation->getAtomicComputationTypeID() == ScanSetAtomicTypeID) {
+    params[ComputeInfoType::SCAN_ATTRIBUTES] = getScanAttributes(sourceAtomicComputation);
+  }
+
   // if we are a join (shuffle join source) we need to have separate logic to handle that, otherwise just return a regular source
   if(sourceAtomicComputation->getAtomicComputationTypeID() != ApplyJoinTypeID) {
 
@@ -223,25 +230,37 @@ PipelinePtr ComputePlan::assemblePipeline(const std::string& sourceTupleSetName,
                                           size_t numProcessingThreads,
                                           uint64_t workerID) {
 
+  // the atomic computation that produces the source
+  AtomicComputationPtr lastOne = myPlan->getComputations().getProducingAtomicComputation(sourceTupleSetName);
+
+  // the signature of the pipeline is the TCAP of the source and all the computations in it
+  std::stringstream signature;
+  signature << *lastOne;
+  for (auto &a : pipelineComputations) {
+    signature << *a;
+  }
+
   // make the pipeline
-  std::shared_ptr<Pipeline> returnVal = std::make_shared<Pipeline>(outputPageSet, computeSource, computeSink, processor);
+  std::shared_ptr<Pipeline> returnVal = std::make_shared<Pipeline>(outputPageSet, computeSource, computeSink, processor, signature.str());
 
   // add the operations to the pipeline
-  AtomicComputationPtr lastOne = myPlan->getComputations().getProducingAtomicComputation(sourceTupleSetName);
   for (auto &a : pipelineComputations) {
 
+    // the stage is named after the computation and the tuple set it produces
+    auto stageName = a->getAtomicComputationType() + " " + a->getOutputName();
+
     // if we have a filter, then just go ahead and create it
     if (a->getAtomicComputationType() == "Filter") {
 
       // create a filter executor
-      returnVal->addStage(std::make_shared<FilterExecutor>(lastOne->getOutput(), a->getInput(), a->getProjection()));
+      returnVal->addStage(std::make_shared<FilterExecutor>(lastOne->getOutput(), a->getInput(), a->getProjection()), stageName);
 
       // if we had an apply, go ahead and find it and add it to the pipeline
     } else if (a->getAtomicComputationType() == "Apply") {
 
       // create an executor for the apply lambda
       returnVal->addStage(myPlan->getNode(a->getComputationName()).
-          getLambda(((ApplyLambda *) a.get())->getLambdaToApply())->getExecutor(lastOne->getOutput(), a->getInput(), a->getProjection()));
+          getLambda(((ApplyLambda *) a.get())->getLambdaToApply())->getExecutor(lastOne->getOutput(), a->getInput(), a->getProjection()), stageName);
 
     } else if(a->getAtomicComputationType() == "Union") {
 
@@ -251,33 +270,33 @@ PipelinePtr ComputePlan::assemblePipeline(const std::string& sourceTupleSetName,
       // check if we are pipelining the right input
       if (lastOne->getOutput().getSetName() == u->getRightInput().getSetName()) {
 
-        returnVal->addStage(std::make_shared<UnionExecutor>(lastOne->getOutput(), u->getRightInput()));
+        returnVal->addStage(std::make_shared<UnionExecutor>(lastOne->getOutput(), u->getRightInput()), stageName);
 
       } else {
 
-        returnVal->addStage(std::make_shared<UnionExecutor>(lastOne->getOutput(), u->getInput()));
+        returnVal->addStage(std::make_shared<UnionExecutor>(lastOne->getOutput(), u->getInput()), stageName);
       }
 
     } else if (a->getAtomicComputationType() == "HashLeft") {
 
       // create an executor for left hasher
       returnVal->addStage(myPlan->getNode(a->getComputationName()).
-          getLambda(((HashLeft *) a.get())->getLambdaToApply())->getLeftHasher(lastOne->getOutput(), a->getInput(), a->getProjection()));
+          getLambda(((HashLeft *) a.get())->getLambdaToApply())->getLeftHasher(lastOne->getOutput(), a->getInput(), a->getProjection()), stageName);
 
     } else if (a->getAtomicComputationType() == "HashRight") {
 
       // create an executor for the right hasher
       returnVal->addStage(myPlan->getNode(a->getComputationName()).
-          getLambda(((HashLeft *) a.get())->getLambdaToApply())->getRightHasher(lastOne->getOutput(), a->getInput(), a->getProjection()));
+          getLambda(((HashLeft *) a.get())->getLambdaToApply())->getRightHasher(lastOne->getOutput(), a->getInput(), a->getProjection()), stageName);
 
 
     } else if (a->getAtomicComputationType() == "HashOne") {
 
-      returnVal->addStage(std::make_shared<HashOneExecutor>(lastOne->getOutput(), a->getInput(), a->getProjection()));
+      returnVal->addStage(std::make_shared<HashOneExecutor>(lastOne->getOutput(), a->getInput(), a->getProjection()), stageName);
 
     } else if (a->getAtomicComputationType() == "Flatten") {
 
-      returnVal->addStage(std::make_shared<FlattenExecutor>(lastOne->getOutput(), a->getInput(), a->getProjection()));
+      returnVal->addStage(std::make_shared<FlattenExecutor>(lastOne->getOutput(), a->getInput(), a->getProjection()), stageName);
 
     } else if (a->getAtomicComputationType() == "JoinSets") {
 
@@ -301,7 +320,7 @@ PipelinePtr ComputePlan::assemblePipeline(const std::string& sourceTupleSetName,
         }
 
         // if we are pipelining the right input, then we don't need to switch left and right inputs
-        returnVal->addStage(myComp.getExecutor(true, myJoin->getProjection(), lastOne->getOutput(), myJoin->getRightInput(), myJoin->getRightProjection(), it->second, numNodes, numProcessingThreads, workerID, *this));
+        returnVal->addStage(myComp.getExecutor(true, myJoin->getProjection(), lastOne->getOutput(), myJoin->getRightInput(), myJoin->getRightProjection(), it->second, numNodes, numProcessingThreads, workerID, *this), stageName);
       } else {
 
         // do we have the appropriate join arguments? if not throw an exception
@@ -311,7 +330,7 @@ PipelinePtr ComputePlan::assemblePipeline(const std::string& sourceTupleSetName,
         }
 
         // if we are pipelining the right input, then we don't need to switch left and right inputs
-        returnVal->addStage(myComp.getExecutor(false, myJoin->getRightProjection(), lastOne->getOutput(), myJoin->getInput(), myJoin->getProjection(), it->second, numNodes, numProcessingThreads, workerID, *this));
+        returnVal->addStage(myComp.getExecutor(false, myJoin->getRightProjection(), lastOne->getOutput(), myJoin->getInput(), myJoin->getProjection(), it->second, numNodes, numProcessingThreads, workerID, *this), stageName);
       }
 
     }
@@ -327,6 +346,9 @@ PipelinePtr ComputePlan::assemblePipeline(const std::string& sourceTupleSetName,
     lastOne = a;
   }
 
+  // the pipeline is named after the tuple sets it goes through
+  returnVal->setName(sourceTupleSetName + " -> " + lastOne->getOutputName());
+
   return std::move(returnVal);
 }
 
@@ -363,6 +385,101 @@ bool ComputePlan::findPipelineComputations(const LogicalPlanPtr& myPlan,
   return false;
 }
 
+ScanAttributesArgPtr ComputePlan::getScanAttributes(AtomicComputationPtr &scan) {
+
+  // what we return if the pipeline needs the whole records
+  auto wholeRecords = std::make_shared<ScanAttributesArg>(false, false, std::set<std::string>(), std::set<std::string>());
+
+  // the column of the records the scan produces
+  auto &scanAtts = scan->getOutput().getAtts();
+  if(scanAtts.empty()) {
+    return wholeRecords;
+  }
+  auto records = scanAtts.front();
+
+  // checks if a tuple spec has the records
+  auto hasRecords = [&records](TupleSpec &spec) {
+    auto &atts = spec.getAtts();
+    return std::find(atts.begin(), atts.end(), records) != atts.end();
+  };
+
+  // go through the tuple sets that have the records, a tuple set is aligned if it has the same rows as the one the
+  // scan produced, that is only the applies can be between them
+  bool onlyAttributes = true;
+  std::set<std::string> attributes;
+  std::set<std::string> methods;
+  std::set<std::string> visited;
+  std::vector<std::pair<std::string, bool>> toVisit = { std::make_pair(scan->getOutputName(), true) };
+  auto &allComps = myPlan->getComputations();
+  while(!toVisit.empty()) {
+
+    // grab the next tuple set
+    auto tupleSet = toVisit.back();
+    toVisit.pop_back();
+    if(!visited.insert(tupleSet.first).second) {
+      continue;
+    }
+
+    // check what its consumers do with the records
+    for(auto &consumer : allComps.getConsumingAtomicComputations(tupleSet.first)) {
+
+      // does it use the records or just carry them
+      bool inInput = hasRecords(consumer->getInput()) || (consumer->hasTwoInputs() && hasRecords(consumer->getRightInput()));
+      bool inProjection = hasRecords(consumer->getProjection()) || (consumer->hasTwoInputs() && hasRecords(consumer->getRightProjection()));
+      if(!inInput && !inProjection) {
+        continue;
+      }
+
+      switch(consumer->getAtomicComputationTypeID()) {
+
+        case ApplyLambdaTypeID: {
+
+          // if it uses the records it has to access an attribute or call a method
+          if(inInput) {
+
+            auto lambda = myPlan->getNode(consumer->getComputationName()).getLambda(((ApplyLambda*) consumer.get())->getLambdaToApply());
+            if(lambda->getTypeOfLambda() == "attAccess") {
+
+              // we can only skip making the records if the attribute is accessed on an aligned tuple set
+              attributes.insert(lambda->getInfo()["attName"]);
+              onlyAttributes = onlyAttributes && tupleSet.second;
+            }
+            else if(lambda->getTypeOfLambda() == "methodCall") {
+
+              // a method needs the records
+              methods.insert(lambda->getInfo()["methodName"]);
+              onlyAttributes = false;
+            }
+            else {
+              return wholeRecords;
+            }
+          }
+
+          // the output has the same rows
+          toVisit.emplace_back(consumer->getOutputName(), tupleSet.second);
+          break;
+        }
+        case ApplyFilterTypeID: {
+
+          // a filter can only carry the records, and its output does not have the same rows
+          if(inInput) {
+            return wholeRecords;
+          }
+          toVisit.emplace_back(consumer->getOutputName(), false);
+          break;
+        }
+        default: {
+
+          // everything else needs the records
+          return wholeRecords;
+        }
+      }
+    }
+  }
+
+  return std::make_shared<ScanAttributesArg>(true, onlyAttributes, attributes, methods);
+}
+
 LogicalPlanPtr &ComputePlan::getPlan() {
   return myPlan;
 }
@@ -480,6 +597,26 @@ PipelinePtr ComputePlan::buildAggregationPipeline(const std::string &targetTuple
   return std::make_shared<pdb::AggregationPipeline>(workerID, outputPageSet, inputPageSet, combiner);
 }
 
+PipelinePtr ComputePlan::buildAggregationPipeline(const std::string &targetTupleSetName,
+                                                  const PDBAbstractPageSetPtr &inputPageSet,
+                                                  const PDBAnonymousPageSetPtr &outputPageSet,
+                                                  const PDBAbstractPageSetPtr &existingOutputPageSet,
+                                                  uint64_t partition,
+                                                  uint64_t numPartitions,
+                                                  uint64_t workerID) {
+
+  // find the target real PDBComputation
+  auto targetAtomicComp = myPlan->getComputations().getProducingAtomicComputation(targetTupleSetName);
+  auto targetComputationName = targetAtomicComp->getComputationName();
+
+  // grab the aggregation combiner and the one that merges the output that is already there
+  Handle<AggregateCompBase> agg = unsafeCast<AggregateCompBase>(myPlan->getNode(targetComputationName).getComputationHandle());
+  auto combiner = agg->getAggregationHashMapCombiner(workerID);
+  auto outputCombiner = agg->getAggregationOutputCombiner(workerID, partition, numPartitions);
+
+  return std::make_shared<pdb::AggregationPipeline>(workerID, outputPageSet, inputPageSet, combiner, existingOutputPageSet, outputCombiner);
+}
+
 
 PipelinePtr ComputePlan::buildBroadcastJoinPipeline(const string &targetTupleSetName,
                                                            const PDBAbstractPageSetPtr &inputPageSet,
@@ -14,11 +14,15 @@
 #include <StoFeedPageRequest.h>
 
 #include "PDBPageNetworkSender.h"
+#include "Tracing.h"
+#include "PDBMetrics.h"
 
 pdb::PDBPageNetworkSender::PDBPageNetworkSender(string address, int32_t port, uint64_t numberOfProcessingThreads, uint64_t numberOfNodes,
-                                                uint64_t maxRetries, PDBLoggerPtr logger, std::pair<uint64_t, std::string> pageSetID, pdb::PDBPageQueuePtr queue)
+                                                uint64_t maxRetries, PDBLoggerPtr logger, std::pair<uint64_t, std::string> pageSetID, pdb::PDBPageQueuePtr queue,
+                                                PDBCodecPtr codec)
     : address(std::move(address)), port(port), queue(std::move(queue)), numberOfProcessingThreads(numberOfProcessingThreads),
-      numberOfNodes(numberOfNodes), logger(std::move(logger)), pageSetID(std::move(pageSetID)), maxRetries(maxRetries) {}
+      numberOfNodes(numberOfNodes), logger(std::move(logger)), pageSetID(std::move(pageSetID)), maxRetries(maxRetries),
+      codec(std::move(codec)) {}
 
 bool pdb::PDBPageNetworkSender::setup() {
 
@@ -80,6 +84,10 @@ bool pdb::PDBPageNetworkSender::run() {
   // make the request
   Handle<pdb::StoFeedPageRequest> request = makeObject<pdb::StoFeedPageRequest>();
 
+  // the buffer we compress the pages into
+  std::vector<char> frame;
+  bool compress = codec != nullptr && codec->getType() != PDB_NO_CODEC;
+
   // send the pages
   PDBPageHandle page;
   do {
@@ -90,14 +98,13 @@ bool pdb::PDBPageNetworkSender::run() {
     // if we got a page from the queue
     if(page != nullptr) {
 
-      // signal that we have another page
-      request->hasNextPage = true;
-      request->pageSize = page->getSize();
+      // the page is out of the queue
+      auto &metrics = PDBMetrics::get();
+      metrics.pageQueuePages.dec();
 
-      // send the object
-      if (!comm->sendObject(request, errMsg)) {
-        return false;
-      }
+      // time the sending
+      PDBOperatorTimer timer(stats);
+      PDB_TRACE_SCOPE_ARG("page network send", page->getSize());
 
       // repin the page
       page->repin();
@@ -108,8 +115,37 @@ bool pdb::PDBPageNetworkSender::run() {
       // get how large it was
       auto numBytes = curRec->numBytes();
 
+      // compress the page if we have a codec, we only send the frame if it got smaller
+      size_t frameSize = 0;
+      if(compress) {
+        frame.resize(std::max(frame.size(), codec->getMaxFrameSize(numBytes)));
+        frameSize = codec->compressFrame((char*) curRec, numBytes, frame.data(), frame.size());
+        frameSize = frameSize < numBytes ? frameSize : 0;
+      }
+
+      // signal that we have another page
+      request->hasNextPage = true;
+      request->pageSize = page->getSize();
+      request->compressedSize = frameSize;
+
+      // send the object
+      if (!comm->sendObject(request, errMsg)) {
+        return false;
+      }
+
       // send the page
-      comm->sendBytes(page->getBytes(), numBytes, errMsg);
+      if(frameSize != 0) {
+        comm->sendBytes(frame.data(), frameSize, errMsg);
+      }
+      else {
+        comm->sendBytes(page->getBytes(), numBytes, errMsg);
+      }
+
+      // count the page and the bytes that went over the wire
+      stats.numPages++;
+      stats.numBytes += frameSize != 0 ? frameSize : numBytes;
+      metrics.shuffledPages.inc();
+      metrics.shuffledBytes.inc(frameSize != 0 ? frameSize : numBytes);
     }
 
   } while (page != nullptr);
@@ -118,3 +154,7 @@ bool pdb::PDBPageNetworkSender::run() {
   request->hasNextPage = false;
   return comm->sendObject(request, errMsg);
 }
+
+const pdb::PDBOperatorStats &pdb::PDBPageNetworkSender::getStats() const {
+  return stats;
+}
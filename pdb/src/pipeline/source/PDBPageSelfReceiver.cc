@@ -7,6 +7,7 @@
 #include <PDBPageSelfReceiver.h>
 
 #include "PDBPageSelfReceiver.h"
+#include "PDBMetrics.h"
 
 pdb::PDBPageSelfReceiver::PDBPageSelfReceiver(pdb::PDBPageQueuePtr queue,
                                               pdb::PDBFeedingPageSetPtr pageSet,
@@ -28,6 +29,12 @@ bool pdb::PDBPageSelfReceiver::run() {
     // if we got a page from the queue
     if(page != nullptr) {
 
+      // the page is out of the queue
+      PDBMetrics::get().pageQueuePages.dec();
+
+      // time the copy
+      PDBOperatorTimer timer(stats);
+
       // repin the page
       page->repin();
 
@@ -45,6 +52,10 @@ bool pdb::PDBPageSelfReceiver::run() {
 
       // feed the page into the page set...
       pageSet->feedPage(outPage);
+
+      // count the page
+      stats.numPages++;
+      stats.numBytes += pageSize;
     }
 
   } while (page != nullptr);
@@ -58,3 +69,7 @@ bool pdb::PDBPageSelfReceiver::run() {
   // we are done here everything worked
   return true;
 }
+
+const pdb::PDBOperatorStats &pdb::PDBPageSelfReceiver::getStats() const {
+  return stats;
+}
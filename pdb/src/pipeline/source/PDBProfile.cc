@@ -0,0 +1,356 @@
+#include <PDBProfile.h>
+#include <InterfaceFunctions.h>
+#include <ctime>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+
+namespace pdb {
+
+namespace {
+
+// formats a time in ns so it is easy to read
+std::string formatTime(uint64_t ns) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(2);
+  if (ns >= 1000000000ull) {
+    ss << (double) ns / 1e9 << " s";
+  } else if (ns >= 1000000ull) {
+    ss << (double) ns / 1e6 << " ms";
+  } else {
+    ss << (double) ns / 1e3 << " us";
+  }
+  return ss.str();
+}
+
+// formats a number of bytes so it is easy to read
+std::string formatBytes(uint64_t bytes) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(2);
+  if (bytes >= 1024ull * 1024ull * 1024ull) {
+    ss << (double) bytes / (1024.0 * 1024.0 * 1024.0) << " GB";
+  } else if (bytes >= 1024ull * 1024ull) {
+    ss << (double) bytes / (1024.0 * 1024.0) << " MB";
+  } else if (bytes >= 1024ull) {
+    ss << (double) bytes / 1024.0 << " KB";
+  } else {
+    ss << bytes << " B";
+  }
+  return ss.str();
+}
+
+}
+
+void PDBOperatorStats::merge(const PDBOperatorStats &other) {
+  numInstances += other.numInstances;
+  wallTime += other.wallTime;
+  maxWallTime = std::max(maxWallTime, other.maxWallTime);
+  cpuTime += other.cpuTime;
+  numRowsIn += other.numRowsIn;
+  numRowsOut += other.numRowsOut;
+  numBytes += other.numBytes;
+  numPages += other.numPages;
+  numPageBytes += other.numPageBytes;
+  numRetries += other.numRetries;
+  numRetriedTuples += other.numRetriedTuples;
+
+  // the smallest tuple set size is only set by the instances that processed a tuple set
+  if (other.numChunks != 0) {
+    minChunkSize = numChunks == 0 ? other.minChunkSize : std::min(minChunkSize, other.minChunkSize);
+  }
+  numChunks += other.numChunks;
+  numChunkFailures += other.numChunkFailures;
+  maxChunkSize = std::max(maxChunkSize, other.maxChunkSize);
+  initialChunkSize += other.initialChunkSize;
+  finalChunkSize += other.finalChunkSize;
+  numLearnedChunkSizes += other.numLearnedChunkSizes;
+}
+
+PDBOperatorTimer::PDBOperatorTimer(PDBOperatorStats &stats) : stats(stats),
+                                                              wallStart(getWallTime()),
+                                                              cpuStart(getCpuTime()) {}
+
+PDBOperatorTimer::~PDBOperatorTimer() {
+  stats.wallTime += getWallTime() - wallStart;
+  stats.cpuTime += getCpuTime() - cpuStart;
+}
+
+uint64_t PDBOperatorTimer::getWallTime() {
+  return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t PDBOperatorTimer::getCpuTime() {
+  timespec time{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return (uint64_t) time.tv_sec * 1000000000ull + (uint64_t) time.tv_nsec;
+}
+
+PDBProfile::PDBProfile(const PDBProfile &other) {
+  std::unique_lock<std::mutex> lck(other.m);
+  entries = other.entries;
+  index = other.index;
+}
+
+PDBProfile &PDBProfile::operator=(const PDBProfile &other) {
+
+  if (this == &other) {
+    return *this;
+  }
+
+  // copy the other one first so we never hold both locks
+  auto otherEntries = other.getEntries();
+
+  std::unique_lock<std::mutex> lck(m);
+  entries.clear();
+  index.clear();
+  for (const auto &entry : otherEntries) {
+    addUnsafe(entry.path, entry.stats);
+  }
+  return *this;
+}
+
+void PDBProfile::add(const std::vector<std::string> &path, const PDBOperatorStats &stats) {
+  std::unique_lock<std::mutex> lck(m);
+  addUnsafe(path, stats);
+}
+
+void PDBProfile::merge(const PDBProfile &other, const std::vector<std::string> &prefix) {
+
+  // grab the operators of the other one, it could be us so we don't hold the lock
+  auto otherEntries = other.getEntries();
+
+  std::unique_lock<std::mutex> lck(m);
+  for (const auto &entry : otherEntries) {
+
+    auto path = prefix;
+    path.insert(path.end(), entry.path.begin(), entry.path.end());
+    addUnsafe(path, entry.stats);
+  }
+}
+
+void PDBProfile::merge(const pdb::Vector<pdb::Handle<PDBProfileEntry>> &profileEntries, const std::vector<std::string> &prefix) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // the entries are in tree order so the path of an entry is the path of the last entry with a smaller depth plus it
+  std::vector<std::string> path;
+  for (size_t i = 0; i < profileEntries.size(); ++i) {
+
+    auto &entry = profileEntries[i];
+    path.resize(std::min<size_t>(path.size(), entry->depth));
+    path.emplace_back(entry->name);
+
+    PDBOperatorStats stats;
+    stats.numInstances = entry->numInstances;
+    stats.wallTime = entry->wallTime;
+    stats.maxWallTime = entry->maxWallTime;
+    stats.cpuTime = entry->cpuTime;
+    stats.numRowsIn = entry->numRowsIn;
+    stats.numRowsOut = entry->numRowsOut;
+    stats.numBytes = entry->numBytes;
+    stats.numPages = entry->numPages;
+    stats.numPageBytes = entry->numPageBytes;
+    stats.numRetries = entry->numRetries;
+    stats.numRetriedTuples = entry->numRetriedTuples;
+    stats.numChunks = entry->numChunks;
+    stats.numChunkFailures = entry->numChunkFailures;
+    stats.minChunkSize = entry->minChunkSize;
+    stats.maxChunkSize = entry->maxChunkSize;
+    stats.initialChunkSize = entry->initialChunkSize;
+    stats.finalChunkSize = entry->finalChunkSize;
+    stats.numLearnedChunkSizes = entry->numLearnedChunkSizes;
+
+    auto fullPath = prefix;
+    fullPath.insert(fullPath.end(), path.begin(), path.end());
+    addUnsafe(fullPath, stats);
+  }
+}
+
+void PDBProfile::toVector(pdb::Vector<pdb::Handle<PDBProfileEntry>> &profileEntries) const {
+
+  for (const auto &entry : getEntries()) {
+
+    pdb::Handle<PDBProfileEntry> out = pdb::makeObject<PDBProfileEntry>(entry.path.back(), (uint32_t) entry.path.size() - 1);
+    out->numInstances = entry.stats.numInstances;
+    out->wallTime = entry.stats.wallTime;
+    out->maxWallTime = entry.stats.maxWallTime;
+    out->cpuTime = entry.stats.cpuTime;
+    out->numRowsIn = entry.stats.numRowsIn;
+    out->numRowsOut = entry.stats.numRowsOut;
+    out->numBytes = entry.stats.numBytes;
+    out->numPages = entry.stats.numPages;
+    out->numPageBytes = entry.stats.numPageBytes;
+    out->numRetries = entry.stats.numRetries;
+    out->numRetriedTuples = entry.stats.numRetriedTuples;
+    out->numChunks = entry.stats.numChunks;
+    out->numChunkFailures = entry.stats.numChunkFailures;
+    out->minChunkSize = entry.stats.minChunkSize;
+    out->maxChunkSize = entry.stats.maxChunkSize;
+    out->initialChunkSize = entry.stats.initialChunkSize;
+    out->finalChunkSize = entry.stats.finalChunkSize;
+    out->numLearnedChunkSizes = entry.stats.numLearnedChunkSizes;
+    profileEntries.push_back(out);
+  }
+}
+
+size_t PDBProfile::getVectorSize() const {
+
+  // the object, the handle and the name of every entry, doubled since the vector copies itself when it grows
+  size_t size = 1024;
+  for (const auto &entry : getEntries()) {
+    size += 256 + entry.path.back().size();
+  }
+  return 2 * size;
+}
+
+size_t PDBProfile::getVectorSize(const pdb::Vector<pdb::Handle<PDBProfileEntry>> &entries) {
+
+  // same as above
+  size_t size = 1024;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    size += 256 + entries[i]->name.size();
+  }
+  return 2 * size;
+}
+
+std::vector<PDBProfile::Entry> PDBProfile::getEntries() const {
+  std::unique_lock<std::mutex> lck(m);
+  return getEntriesUnsafe();
+}
+
+bool PDBProfile::getStats(const std::vector<std::string> &path, PDBOperatorStats &stats) const {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  auto it = index.find(path);
+  if (it == index.end()) {
+    return false;
+  }
+  stats = entries[it->second].stats;
+  return true;
+}
+
+PDBOperatorStats PDBProfile::getScanStats() const {
+
+  // sum up what the sources of all the pipelines read
+  PDBOperatorStats stats;
+  for (const auto &entry : getEntries()) {
+    if (entry.path.back() == "source") {
+      stats.numPages += entry.stats.numPages;
+      stats.numBytes += entry.stats.numBytes;
+      stats.numPageBytes += entry.stats.numPageBytes;
+    }
+  }
+  return stats;
+}
+
+bool PDBProfile::isEmpty() const {
+  std::unique_lock<std::mutex> lck(m);
+  return entries.empty();
+}
+
+std::string PDBProfile::toString() const {
+
+  std::stringstream ss;
+  for (const auto &entry : getEntries()) {
+
+    // the name indented by the depth
+    ss << std::string(2 * (entry.path.size() - 1), ' ') << entry.path.back();
+
+    // only print the stats the operator has
+    auto &stats = entry.stats;
+    std::vector<std::string> columns;
+    if (stats.wallTime != 0) {
+      columns.emplace_back("wall " + formatTime(stats.wallTime) + (stats.numInstances > 1 ? " (max " + formatTime(stats.maxWallTime) + ")" : ""));
+    }
+    if (stats.cpuTime != 0) {
+      columns.emplace_back("cpu " + formatTime(stats.cpuTime));
+    }
+    if (stats.numRowsIn != 0 || stats.numRowsOut != 0) {
+      columns.emplace_back("rows " + std::to_string(stats.numRowsIn) + " -> " + std::to_string(stats.numRowsOut));
+    }
+    if (stats.numBytes != 0) {
+      columns.emplace_back(formatBytes(stats.numBytes));
+    }
+    if (stats.numPages != 0) {
+      columns.emplace_back(std::to_string(stats.numPages) + " pages" + (stats.numPageBytes != 0 ? " of " + formatBytes(stats.numPageBytes) : ""));
+    }
+    if (stats.numRetries != 0) {
+      columns.emplace_back(std::to_string(stats.numRetries) + " retries" + (stats.numRetriedTuples != 0 ? " of " + std::to_string(stats.numRetriedTuples) + " rows" : ""));
+    }
+    if (stats.numChunks != 0) {
+
+      // the initial and the final sizes are averaged over the instances
+      auto numInstances = std::max<uint64_t>(stats.numInstances, 1);
+      columns.emplace_back(std::to_string(stats.numChunks) + " tuple sets of " + std::to_string(stats.minChunkSize) + " to " +
+                           std::to_string(stats.maxChunkSize) + " rows (initial " + std::to_string(stats.initialChunkSize / numInstances) +
+                           (stats.numLearnedChunkSizes != 0 ? ", " + std::to_string(stats.numLearnedChunkSizes) + " learned" : "") +
+                           ", final " + std::to_string(stats.finalChunkSize / numInstances) + ")");
+    }
+    if (stats.numChunkFailures != 0) {
+      columns.emplace_back(std::to_string(stats.numChunkFailures) + " failed tuple sets");
+    }
+    if (stats.numInstances > 1) {
+      columns.emplace_back("x" + std::to_string(stats.numInstances));
+    }
+
+    for (size_t i = 0; i < columns.size(); ++i) {
+      ss << (i == 0 ? " : " : ", ") << columns[i];
+    }
+    ss << '\n';
+  }
+
+  return ss.str();
+}
+
+void PDBProfile::addUnsafe(const std::vector<std::string> &path, const PDBOperatorStats &stats) {
+
+  if (path.empty()) {
+    return;
+  }
+
+  // make sure the operators on the path are there so the parents come before their children
+  for (size_t i = 1; i <= path.size(); ++i) {
+
+    std::vector<std::string> prefix(path.begin(), path.begin() + i);
+    if (index.find(prefix) == index.end()) {
+      index[prefix] = entries.size();
+      entries.push_back(Entry{prefix, PDBOperatorStats{}});
+    }
+  }
+
+  // merge the stats
+  entries[index[path]].stats.merge(stats);
+}
+
+std::vector<PDBProfile::Entry> PDBProfile::getEntriesUnsafe() const {
+
+  // find the children of each operator, they are in the order they were added
+  std::vector<std::vector<size_t>> children(entries.size());
+  std::vector<size_t> roots;
+  for (size_t i = 0; i < entries.size(); ++i) {
+
+    auto &path = entries[i].path;
+    if (path.size() == 1) {
+      roots.emplace_back(i);
+    } else {
+      children[index.find(std::vector<std::string>(path.begin(), path.end() - 1))->second].emplace_back(i);
+    }
+  }
+
+  // go through the tree depth first
+  std::vector<Entry> out;
+  out.reserve(entries.size());
+  std::vector<size_t> toVisit(roots.rbegin(), roots.rend());
+  while (!toVisit.empty()) {
+
+    auto i = toVisit.back();
+    toVisit.pop_back();
+    out.emplace_back(entries[i]);
+    toVisit.insert(toVisit.end(), children[i].rbegin(), children[i].rend());
+  }
+
+  return out;
+}
+
+}
@@ -7,18 +7,41 @@
 
 void pdb::AggregationPipeline::run() {
 
+  // time the merge
+  PDBOperatorTimer timer(mergeStats);
+
   // this is where we are outputting all of our results to
   MemoryHolderPtr myRAM = std::make_shared<MemoryHolder>(outputPageSet->getNewPage());
+  outputPage = myRAM->pageHandle->whichPage();
 
   // create an output container create it.
   myRAM->outputSink = merger->createNewOutputContainer();
 
-  // aggregate all hash maps
+  // if the aggregation is incremental start from the output it already has
   PDBPageHandle inputPage;
+  if(existingOutputPageSet != nullptr) {
+
+    // each worker has its own page set with just the page that has the keys of its partition
+    while ((inputPage = existingOutputPageSet->getNextPage(workerID)) != nullptr) {
+
+      // write out the keys of this worker
+      existingOutputMerger->writeOutPage(inputPage, myRAM->outputSink);
+
+      // count the page
+      mergeStats.numPages++;
+      mergeStats.numBytes += inputPage->getSize();
+    }
+  }
+
+  // aggregate all hash maps
   while ((inputPage = inputPageSet->getNextPage(workerID)) != nullptr) {
 
     // write out the page
     merger->writeOutPage(inputPage, myRAM->outputSink);
+
+    // count the page
+    mergeStats.numPages++;
+    mergeStats.numBytes += inputPage->getSize();
   }
 
   // we only have one iteration
@@ -38,3 +61,31 @@ pdb::AggregationPipeline::AggregationPipeline(size_t workerID,
                                               const pdb::PDBAnonymousPageSetPtr &outputPageSet,
                                               const pdb::PDBAbstractPageSetPtr &inputPageSet,
                                               const pdb::ComputeSinkPtr &merger) : workerID(workerID), outputPageSet(outputPageSet), inputPageSet(inputPageSet), merger(merger) {}
+
+pdb::AggregationPipeline::AggregationPipeline(size_t workerID,
+                                              const pdb::PDBAnonymousPageSetPtr &outputPageSet,
+                                              const pdb::PDBAbstractPageSetPtr &inputPageSet,
+                                              const pdb::ComputeSinkPtr &merger,
+                                              const pdb::PDBAbstractPageSetPtr &existingOutputPageSet,
+                                              const pdb::ComputeSinkPtr &existingOutputMerger) : workerID(workerID),
+                                                                                                 outputPageSet(outputPageSet),
+                                                                                                 inputPageSet(inputPageSet),
+                                                                                                 merger(merger),
+                                                                                                 existingOutputPageSet(existingOutputPageSet),
+                                                                                                 existingOutputMerger(existingOutputMerger) {}
+
+pdb::PDBProfile pdb::AggregationPipeline::getProfile() {
+
+  // this merge ran on one thread
+  auto stats = mergeStats;
+  stats.numInstances = 1;
+  stats.maxWallTime = stats.wallTime;
+
+  PDBProfile profile;
+  profile.add({ "aggregation merge" }, stats);
+  return profile;
+}
+
+uint64_t pdb::AggregationPipeline::getOutputPage() {
+  return outputPage;
+}
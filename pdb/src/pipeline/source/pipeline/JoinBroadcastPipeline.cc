@@ -21,6 +21,9 @@ pdb::JoinBroadcastPipeline::JoinBroadcastPipeline(size_t workerID,
 
 void pdb::JoinBroadcastPipeline::run() {
 
+  // time the merge
+  PDBOperatorTimer timer(mergeStats);
+
   // this is where we are outputting all of our results to
   MemoryHolderPtr myRAM = std::make_shared<MemoryHolder>(outputPageSet->getNewPage());
 
@@ -36,6 +39,10 @@ void pdb::JoinBroadcastPipeline::run() {
     // write out the page
     merger->writeOutPage(inputPage, myRAM->outputSink);
 
+    // count the page
+    mergeStats.numPages++;
+    mergeStats.numBytes += inputPage->getSize();
+
     inputPage->unpin();
   }
 
@@ -54,3 +61,15 @@ void pdb::JoinBroadcastPipeline::run() {
   // TODO make this nicer
   makeObjectAllocatorBlock(1024, true);
 }
+
+pdb::PDBProfile pdb::JoinBroadcastPipeline::getProfile() {
+
+  // this merge ran on one thread
+  auto stats = mergeStats;
+  stats.numInstances = 1;
+  stats.maxWallTime = stats.wallTime;
+
+  PDBProfile profile;
+  profile.add({ "broadcast join merge" }, stats);
+  return profile;
+}
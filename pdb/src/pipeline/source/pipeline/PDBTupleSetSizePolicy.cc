@@ -1,12 +1,45 @@
 #include <stdexcept>
 #include <iostream>
 #include <limits>
+#include <algorithm>
 #include <pipeline/PDBTupleSetSizePolicy.h>
 #include "PDBTupleSetSizePolicy.h"
 
 namespace pdb {
 
-PDBTupleSetSizePolicy::PDBTupleSetSizePolicy(uint64_t pageSize) : pageSize(pageSize) {}
+std::list<std::pair<std::string, PDBTupleSetSizePolicy::Model>> PDBTupleSetSizePolicy::learnedModels;
+std::unordered_map<std::string, std::list<std::pair<std::string, PDBTupleSetSizePolicy::Model>>::iterator> PDBTupleSetSizePolicy::learnedModelsIndex;
+std::mutex PDBTupleSetSizePolicy::learnedModelsLock;
+
+PDBTupleSetSizePolicy::PDBTupleSetSizePolicy(uint64_t pageSize, std::string signature) : signature(std::move(signature)),
+                                                                                         pageSize(pageSize) {
+
+  // check if we have learned a model for this signature
+  if(!this->signature.empty()) {
+
+    std::unique_lock<std::mutex> lck(learnedModelsLock);
+
+    // if we have grab it and mark it as the most recently used one
+    auto it = learnedModelsIndex.find(this->signature);
+    if(it != learnedModelsIndex.end()) {
+      learnedModels.splice(learnedModels.begin(), learnedModels, it->second);
+      model = it->second->second;
+    }
+  }
+
+  // if the model can tell us the chunk size use it
+  auto learnedSize = modelChunkSize();
+  if(learnedSize != -1) {
+    chunkSize = learnedSize;
+    stats.usedLearnedModel = true;
+  }
+
+  // init the stats
+  stats.initialChunkSize = chunkSize;
+  stats.minChunkSize = chunkSize;
+  stats.maxChunkSize = chunkSize;
+  stats.finalChunkSize = chunkSize;
+}
 
 void PDBTupleSetSizePolicy::pipelineFailed() {
 
@@ -16,24 +49,46 @@ void PDBTupleSetSizePolicy::pipelineFailed() {
     throw std::runtime_error("We can not reduce the chunk size anymore so we fail here.");
   }
 
-  // divide the chunk size by 2
-  chunkSize /= 2;
+  // the chunk did not fit into an empty page, so we know how much it needs at least
+  model.minBytesPerRow = std::max(model.minBytesPerRow, (double) pageSize / chunkSize);
+  stats.numFailures++;
+
+  // divide the chunk size by 2, unless the model tells us to go even lower
+  auto newChunkSize = chunkSize / 2;
+  auto learnedSize = modelChunkSize();
+  if(learnedSize != -1) {
+    newChunkSize = std::min(newChunkSize, learnedSize);
+  }
+  updateChunkSize(std::max(newChunkSize, 1));
 
   // mark that we have failed running the pipeline
+  pipeline.numRows = 0;
   pipeline.initialFree = 0;
   pipeline.finalFree = 0;
   pipeline.numAdditionalPages = 0;
   pipeline.succeeded = false;
+}
+
+void PDBTupleSetSizePolicy::stageSucceeded(size_t stage, uint64_t numRows, uint64_t initialFree, uint64_t finalFree) {
 
-  // if we incremented last time disable increments we are at the edge on how much we can push the chunk size
-  if(lastIncremented) {
-    allowIncrements = false;
+  // if we don't have any rows there is nothing to learn
+  if(numRows == 0 || finalFree > initialFree) {
+    return;
   }
+
+  // make sure we have a coefficient for this stage
+  if(model.stageBytesPerRow.size() <= stage) {
+    model.stageBytesPerRow.resize(stage + 1, 0);
+  }
+
+  // fit the coefficient
+  fit(model.stageBytesPerRow[stage], (double) (initialFree - finalFree) / numRows);
 }
 
-void PDBTupleSetSizePolicy::pipelineSucceeded(uint64_t additionalPagesUsed, uint64_t initialFree, uint64_t finalFree) {
+void PDBTupleSetSizePolicy::pipelineSucceeded(uint64_t numRows, uint64_t additionalPagesUsed, uint64_t initialFree, uint64_t finalFree) {
 
   // set the pipeline stats
+  pipeline.numRows = numRows;
   pipeline.initialFree = initialFree;
   pipeline.finalFree = finalFree;
   pipeline.numAdditionalPages = additionalPagesUsed;
@@ -42,69 +97,47 @@ void PDBTupleSetSizePolicy::pipelineSucceeded(uint64_t additionalPagesUsed, uint
 
 void PDBTupleSetSizePolicy::writeToPageSucceeded(uint64_t additionalPages, uint64_t initialFree, uint64_t finalFree) {
 
-  // set the write stats
-  writeStats.initialFree = initialFree;
-  writeStats.finalFree = finalFree;
-  writeStats.numAdditionalPages = additionalPages;
+  // we processed another chunk
+  stats.numChunks++;
 
-  if(pipeline.succeeded && pipeline.numAdditionalPages == 0 && additionalPages == 0) {
-    tryToMakePipelineSucceed = false;
+  // fit the sink coefficient if we can
+  if(pipeline.numRows != 0 && finalFree <= initialFree) {
+    fit(model.sinkBytesPerRow, (double) (initialFree - finalFree) / pipeline.numRows);
   }
 
-  // if the pipeline succeeded and write succeeded without any additional pages then we
-  // can possibly increase the chunk size
-  if(allowIncrements && pipeline.succeeded && pipeline.numAdditionalPages == 0 && additionalPages == 0) {
-
-    // so the rule is if we only used less than 20% of the page in total
-    // increase chunk size 3 times because we expect the usage to go up to 60%
-    auto percentage = ((pipeline.initialFree - writeStats.finalFree) * 100) / pageSize;
-
-    // do the check and increment if it works
-    if(percentage < 20) {
-      chunkSize = std::min<uint64_t>(((uint64_t) chunkSize) * 3, maxChunkSize);
-    }
-
-    // just take the larger of two sizes where we succeeded
-    lastFullySuccessfulSize = std::max(lastFullySuccessfulSize, chunkSize);
+  // pick the largest chunk size that fits according to the model
+  auto learnedSize = modelChunkSize();
+  if(learnedSize != -1) {
+    updateChunkSize(learnedSize);
+  }
+}
 
-    // mark that we incremented in the previous iteration
-    lastIncremented = true;
+void PDBTupleSetSizePolicy::saveModel() {
 
-    // restart the retry
-    pipelineRetry = 3;
+  // if we don't have a signature we can not store it
+  if(signature.empty()) {
+    return;
   }
-  else if(tryToMakePipelineSucceed && pipeline.numAdditionalPages != 0 && pipeline.succeeded && chunkSize != 1) {
-
-    // if this is the first time we encountered this store it
-    if(lastChunkSizeForWrite == -1) {
-      lastChunkSizeForWrite = chunkSize;
-    }
 
-    // if we have used additional pages and the pipeline succeeded we want to disallow increments
-    allowIncrements = false;
+  std::unique_lock<std::mutex> lck(learnedModelsLock);
 
-    // decrement the chunks size
-    chunkSize /= 2;
+  // if we already have a model for this signature update it and move it to the front
+  auto it = learnedModelsIndex.find(signature);
+  if(it != learnedModelsIndex.end()) {
+    it->second->second = model;
+    learnedModels.splice(learnedModels.begin(), learnedModels, it->second);
+    return;
   }
-  // if we last incremented and we made the pipeline not succeed that means that we exceeded the
-  // best chunk size therefore we need to revert to the last good known size.
-  else if(lastIncremented && !tryToMakePipelineSucceed && pipeline.numAdditionalPages != 0 && pipeline.succeeded) {
 
-    // revert back and don't mess with the increments
-    chunkSize = lastFullySuccessfulSize;
-    allowIncrements = false;
-  }
-  // if be got 3 pipeline failures in a row, it might be that we need to reduce the size down further
-  else if(pipeline.numAdditionalPages != 0 && pipelineRetry == 0) {
-    tryToMakePipelineSucceed = true;
-    pipelineRetry = 3;
-  }
-  else if(pipeline.numAdditionalPages != 0) {
-    pipelineRetry--;
-  }
+  // store the model
+  learnedModels.emplace_front(signature, model);
+  learnedModelsIndex[signature] = learnedModels.begin();
 
-  // mark that we did not increment
-  lastIncremented = false;
+  // evict the least recently used model if we have too many
+  if(learnedModels.size() > maxLearnedModels) {
+    learnedModelsIndex.erase(learnedModels.back().first);
+    learnedModels.pop_back();
+  }
 }
 
 bool PDBTupleSetSizePolicy::inputWasProcessed() const {
@@ -118,4 +151,64 @@ int32_t PDBTupleSetSizePolicy::getChunksSize() const {
   return this->chunkSize;
 }
 
-}
\ No newline at end of file
+const PDBTupleSetSizeStats &PDBTupleSetSizePolicy::getStats() const {
+  return stats;
+}
+
+void PDBTupleSetSizePolicy::forgetLearnedModels() {
+
+  std::unique_lock<std::mutex> lck(learnedModelsLock);
+  learnedModels.clear();
+  learnedModelsIndex.clear();
+}
+
+size_t PDBTupleSetSizePolicy::numLearnedModels() {
+
+  std::unique_lock<std::mutex> lck(learnedModelsLock);
+  return learnedModels.size();
+}
+
+void PDBTupleSetSizePolicy::fit(double &coefficient, double observed) {
+
+  // if this is the first observation just take it, otherwise move the coefficient towards the observed value
+  if(coefficient == 0) {
+    coefficient = observed;
+  }
+  else {
+    coefficient += learningRate * (observed - coefficient);
+  }
+}
+
+void PDBTupleSetSizePolicy::updateChunkSize(int32_t newChunkSize) {
+
+  // set the chunk size
+  chunkSize = newChunkSize;
+
+  // update the stats
+  stats.minChunkSize = std::min(stats.minChunkSize, chunkSize);
+  stats.maxChunkSize = std::max(stats.maxChunkSize, chunkSize);
+  stats.finalChunkSize = chunkSize;
+}
+
+int32_t PDBTupleSetSizePolicy::modelChunkSize() const {
+
+  // sum up the bytes per row of all the stages and the sink
+  double bytesPerRow = model.sinkBytesPerRow;
+  for(auto &b : model.stageBytesPerRow) {
+    bytesPerRow += b;
+  }
+
+  // we know that the chunk needs at least this much
+  bytesPerRow = std::max(bytesPerRow, model.minBytesPerRow);
+
+  // if we did not observe anything we can not say anything
+  if(bytesPerRow <= 0) {
+    return -1;
+  }
+
+  // the largest chunk that fits into the usable part of the page
+  auto size = (uint64_t) ((pageSize * pageUsage) / bytesPerRow);
+  return (int32_t) std::max<uint64_t>(1, std::min<uint64_t>(size, maxChunkSize));
+}
+
+}
@@ -19,13 +19,15 @@
  *****************************************************************************/
 
 #include "Pipeline.h"
+#include "Tracing.h"
 #include <utility>
 
 pdb::Pipeline::Pipeline(const PDBAnonymousPageSetPtr &outputPageSet,
                         ComputeSourcePtr dataSource,
                         ComputeSinkPtr tupleSink,
-                        PageProcessorPtr pageProcessor) :
-    tupleSetSizePolicy(outputPageSet->getMaxPageSize()),
+                        PageProcessorPtr pageProcessor,
+                        const std::string &signature) :
+    tupleSetSizePolicy(outputPageSet->getMaxPageSize(), signature),
     outputPageSet(outputPageSet),
     dataSource(std::move(dataSource)),
     dataSink(std::move(tupleSink)),
@@ -39,8 +41,15 @@ pdb::Pipeline::~Pipeline() {
 }
 
 // adds a stage to the pipeline
-void pdb::Pipeline::addStage(const ComputeExecutorPtr& addMe) {
+void pdb::Pipeline::addStage(const ComputeExecutorPtr& addMe, const std::string &stageName) {
   pipeline.push_back(addMe);
+  stageNames.push_back(stageName.empty() ? "stage" : stageName);
+  stageStats.emplace_back();
+}
+
+// sets the name of the pipeline
+void pdb::Pipeline::setName(const std::string &pipelineName) {
+  name = pipelineName;
 }
 
 // writes back any unwritten pages
@@ -68,8 +77,16 @@ void pdb::Pipeline::cleanPages(int iteration) {
       // in this case, the page DID have some data written to it
     } else {
 
+      // process the page and count it
+      bool keepPage;
+      {
+        PDBOperatorTimer timer(processorStats);
+        keepPage = pageProcessor->process(unwrittenPages.front());
+        processorStats.numPages++;
+      }
+
       // remove the page if not needed
-      if(!pageProcessor->process(unwrittenPages.front())) {
+      if(!keepPage) {
 
         // and force the reference count for this guy to go to zero
         unwrittenPages.front()->outputSink.emptyOutContainingBlock();
@@ -123,8 +140,11 @@ void pdb::Pipeline::cleanPipeline() {
 // runs the pipeline
 void pdb::Pipeline::run() {
 
+  // time the whole pipeline
+  PDBOperatorTimer pipelineTimer(pipelineStats);
+
   // this is where we are outputting all of our results to
-  MemoryHolderPtr ram = std::make_shared<MemoryHolder>(outputPageSet->getNewPage());
+  MemoryHolderPtr ram = getNewPage();
 
   // and here is the chunk
   TupleSetPtr curChunk;
@@ -138,13 +158,23 @@ void pdb::Pipeline::run() {
   uint64_t finalFree = 0;
   uint64_t additionalPagesUsed = 0;
 
+  // how much memory was free before we run the current stage, used to learn how much each stage needs per row
+  uint64_t stageInitialFree = 0;
+
+  // the number of rows in the tuple set we got from the source
+  uint64_t numInputRows = 0;
+
   // while there is still data
-  while ((curChunk = dataSource->getNextTupleSet(tupleSetSizePolicy)) != nullptr) {
+  while ((curChunk = getNextTupleSet()) != nullptr) {
+
+    // the iteration is one event on the timeline
+    PDB_TRACE_SCOPE_ARG("pipeline iteration", curChunk->getNumRows());
 
     // we keep track of how much ram we used to process each iteration of the pipeline
     // this will be used by @see PDBTupleSetSizePolicy to determine the number of rows in the tuple set
     initialFree = getAllocator().getFreeBytesAtTheEnd();
     additionalPagesUsed = 0;
+    numInputRows = curChunk->getNumRows();
 
     /**
      * 1. First we go through each computation in the pipeline and apply it
@@ -158,89 +188,162 @@ void pdb::Pipeline::run() {
       // this value indicates whether we need to reapply this computation
       bool reapply = false;
 
+      // the stats of the stage
+      auto &stats = stageStats[stage];
+
+      // if the executor can tell how much memory it needs, make room for it before we process the chunk
+      // so that we don't run out of space in the middle of processing it
+      if(!makeRoom(ram, q->bytesNeeded(curChunk), iteration, additionalPagesUsed)) {
+
+        // the chunk does not fit even into an empty page, so the whole chunk has to be processed again with less rows
+        numRetriedTuples += numInputRows;
+        stats.numRetries++;
+        tupleSetSizePolicy.pipelineFailed();
+        goto CLEAN_ITERATION;
+      }
+
 // this is kind of nasty but I am doing this so we can reapply a failed computation
 // I am doing this since it is the easiest way to go and repeat this try block
 REAPPLY:
 
+      // mark how much memory we have before running the stage
+      stageInitialFree = getAllocator().getFreeBytesAtTheEnd();
+
       try {
 
         // try to process the chunk
-        curChunk = q->process(curChunk);
+        auto numStageRows = curChunk->getNumRows();
+        {
+          PDBOperatorTimer timer(stats);
+          curChunk = q->process(curChunk);
+        }
+
+        // the stage was run on a single page so we know exactly how much memory it used
+        auto stageFinalFree = getAllocator().getFreeBytesAtTheEnd();
+        tupleSetSizePolicy.stageSucceeded(stage, numInputRows, stageInitialFree, stageFinalFree);
+
+        // count the rows and the bytes
+        stats.numRowsIn += numStageRows;
+        stats.numRowsOut += curChunk->getNumRows();
+        stats.numBytes += stageInitialFree > stageFinalFree ? stageInitialFree - stageFinalFree : 0;
 
       } catch (NotEnoughSpace &n) {
 
+        // count the retry
+        stats.numRetries++;
+
         // if we already reapplied then we can obviously not do the processing of this tuple set
         // we need to have less rows to finish this pipeline
         if(reapply) {
 
+          // the source is going to give us the whole chunk again
+          numRetriedTuples += numInputRows;
+
           // mark that we had a failure to process this pipeline
           tupleSetSizePolicy.pipelineFailed();
 
           // we add the current page to the list so it can be removed and then we grab a new one
           // the page will not contain anything important since we just grabbed it
           addPageToIteration(ram, iteration);
-          ram = std::make_shared<MemoryHolder>(outputPageSet->getNewPage());
+          ram = getNewPage();
 
           // so in this case we need to reduce the number of rows by half to finish this pipeline
           goto CLEAN_ITERATION;
         }
 
+        // we are going to process the input of this stage again
+        numRetriedTuples += curChunk->getNumRows();
+
         // we run out of space so this page can contain important data, process the page and possibly store it
         // the page can contain intermediate results
         addPageToIteration(ram, iteration);
 
         // get new page
-        ram = std::make_shared<MemoryHolder>(outputPageSet->getNewPage());
+        ram = getNewPage();
         additionalPagesUsed++;
 
         // jump to reapply and try to reprocess the chunk
         reapply = true;
         goto REAPPLY;
       }
+
+      // go to the next stage
+      stage++;
     }
 
     // mark how much memory we have at the end in the last page we used
     finalFree = getAllocator().getFreeBytesAtTheEnd();
 
     // mark that we succeeded in running this pipeline
-    tupleSetSizePolicy.pipelineSucceeded(additionalPagesUsed, initialFree, finalFree);
+    tupleSetSizePolicy.pipelineSucceeded(numInputRows, additionalPagesUsed, initialFree, finalFree);
 
-    // the initial size before we do the write to sink is how much free memory was at the end
-    initialFree = finalFree;
+    // we count the pages the write needs separately
+    additionalPagesUsed = 0;
 
     /**
      * 2. Write to the output pages and once we run out of memory process the page if needed.
      */
 
     // write the output pages
-    try {
+    {
+      // time the sink
+      PDBOperatorTimer sinkTimer(sinkStats);
+      sinkStats.numRowsIn += curChunk->getNumRows();
+      try {
 
-      // make a new output sink if we don't have one already
-      if (ram->outputSink == nullptr) {
-        ram->outputSink = dataSink->createNewOutputContainer();
-      }
+        // make a new output sink if we don't have one already
+        if (ram->outputSink == nullptr) {
+          ram->outputSink = dataSink->createNewOutputContainer();
+        }
 
-      // write the thing out
-      dataSink->writeOut(curChunk, ram->outputSink);
+        // if the sink can tell how much memory it needs and we don't have it, move to a new page before writing,
+        // this way the sink does not have to throw in the middle of writing. If it does not fit into a new page either
+        // we just try to write and let the sink handle it.
+        if(!fitsInCurrentAllocatorBlock(dataSink->bytesNeeded(curChunk, ram->outputSink))) {
 
-    } catch (NotEnoughSpace &n) {
+          // we need to keep the page
+          addPageToIteration(ram, iteration);
 
-      // we need to keep the page
-      addPageToIteration(ram, iteration);
+          // get new page and make a new output container on it
+          ram = getNewPage();
+          ram->outputSink = dataSink->createNewOutputContainer();
+          additionalPagesUsed++;
+        }
 
-      // get new page
-      ram = std::make_shared<MemoryHolder>(outputPageSet->getNewPage());
+        // the initial size before we do the write to sink
+        initialFree = getAllocator().getFreeBytesAtTheEnd();
 
-      // and again, try to write back the output
-      ram->outputSink = dataSink->createNewOutputContainer();
-      dataSink->writeOut(curChunk, ram->outputSink);
-    }
+        // grow the output container up front, so that the write does not have to
+        dataSink->reserve(curChunk, ram->outputSink);
 
-    // mark how much memory we have at the end in the last page we used
-    finalFree = getAllocator().getFreeBytesAtTheEnd();
+        // write the thing out
+        dataSink->writeOut(curChunk, ram->outputSink);
+
+      } catch (NotEnoughSpace &n) {
+
+        // count the retry
+        sinkStats.numRetries++;
+
+        // we need to keep the page
+        addPageToIteration(ram, iteration);
+
+        // get new page
+        ram = getNewPage();
+
+        // and again, try to write back the output
+        ram->outputSink = dataSink->createNewOutputContainer();
+        additionalPagesUsed++;
+        initialFree = getAllocator().getFreeBytesAtTheEnd();
+        dataSink->writeOut(curChunk, ram->outputSink);
+      }
+
+      // mark how much memory we have at the end in the last page we used
+      finalFree = getAllocator().getFreeBytesAtTheEnd();
+      sinkStats.numBytes += initialFree > finalFree ? initialFree - finalFree : 0;
+    }
 
     // mark that we succeeded in writing to a page
-    tupleSetSizePolicy.writeToPageSucceeded(0, initialFree, finalFree);
+    tupleSetSizePolicy.writeToPageSucceeded(additionalPagesUsed, initialFree, finalFree);
 
 // this is also nasty but basically if we have a tuple set that has too many rows
 // we jump here to do some cleanup and repeat with a smaller chunk size
@@ -256,6 +359,111 @@ CLEAN_ITERATION:
 
   // clean the pipeline before we finish running
   cleanPipeline();
+
+  // store what we have learned about the sizes so the next pipeline with the same signature can start from it
+  tupleSetSizePolicy.saveModel();
+}
+
+bool pdb::Pipeline::makeRoom(MemoryHolderPtr &ram, uint64_t numBytes, int iteration, uint64_t &additionalPagesUsed) {
+
+  // if we have enough space we are good
+  if(fitsInCurrentAllocatorBlock(numBytes)) {
+    return true;
+  }
+
+  // the current page can contain intermediate results so we keep it for this iteration
+  addPageToIteration(ram, iteration);
+
+  // get new page
+  ram = getNewPage();
+  additionalPagesUsed++;
+
+  // check if it fits into the new page
+  return fitsInCurrentAllocatorBlock(numBytes);
+}
+
+uint64_t pdb::Pipeline::getNumRetriedTuples() {
+  return numRetriedTuples;
+}
+
+pdb::PDBTupleSetSizeStats pdb::Pipeline::getTupleSetSizeStats() {
+  return tupleSetSizePolicy.getStats();
+}
+
+pdb::PDBScanStats pdb::Pipeline::getScanStats() {
+  return dataSource->getScanStats();
+}
+
+pdb::PDBProfile pdb::Pipeline::getProfile() {
+
+  PDBProfile profile;
+
+  // this pipeline ran on one thread
+  auto add = [&](const std::vector<std::string> &path, PDBOperatorStats stats) {
+    stats.numInstances = 1;
+    stats.maxWallTime = stats.wallTime;
+    profile.add(path, stats);
+  };
+
+  // the pipeline takes its rows from the source and gives them to the sink
+  auto stats = pipelineStats;
+  stats.numRowsIn = sourceStats.numRowsOut;
+  stats.numRowsOut = sinkStats.numRowsIn;
+  stats.numRetries = sinkStats.numRetries;
+  for(const auto &stage : stageStats) {
+    stats.numRetries += stage.numRetries;
+  }
+  stats.numRetriedTuples = numRetriedTuples;
+
+  // with the tuple set sizes it chose
+  auto tupleSetSizeStats = getTupleSetSizeStats();
+  stats.numChunks = tupleSetSizeStats.numChunks;
+  stats.numChunkFailures = tupleSetSizeStats.numFailures;
+  stats.minChunkSize = (uint64_t) tupleSetSizeStats.minChunkSize;
+  stats.maxChunkSize = (uint64_t) tupleSetSizeStats.maxChunkSize;
+  stats.initialChunkSize = (uint64_t) tupleSetSizeStats.initialChunkSize;
+  stats.finalChunkSize = (uint64_t) tupleSetSizeStats.finalChunkSize;
+  stats.numLearnedChunkSizes = tupleSetSizeStats.usedLearnedModel ? 1 : 0;
+  add({ name }, stats);
+
+  // the source also reports the pages it read
+  auto scanStats = getScanStats();
+  stats = sourceStats;
+  stats.numPages = scanStats.numPages;
+  stats.numBytes = scanStats.numBytesRead;
+  stats.numPageBytes = scanStats.numPageBytes;
+  add({ name, "source" }, stats);
+
+  // the stages in the order they are run
+  for(size_t i = 0; i < pipeline.size(); ++i) {
+    add({ name, "stage " + std::to_string(i) + ": " + stageNames[i] }, stageStats[i]);
+  }
+
+  add({ name, "sink" }, sinkStats);
+  add({ name, "page processor" }, processorStats);
+
+  return profile;
+}
+
+pdb::TupleSetPtr pdb::Pipeline::getNextTupleSet() {
+
+  // time the source
+  TupleSetPtr chunk;
+  {
+    PDBOperatorTimer timer(sourceStats);
+    chunk = dataSource->getNextTupleSet(tupleSetSizePolicy);
+  }
+
+  // count the rows
+  sourceStats.numRowsOut += chunk != nullptr ? chunk->getNumRows() : 0;
+  return chunk;
+}
+
+pdb::MemoryHolderPtr pdb::Pipeline::getNewPage() {
+
+  // count the page
+  pipelineStats.numPages++;
+  return std::make_shared<MemoryHolder>(outputPageSet->getNewPage());
 }
 
 void pdb::Pipeline::addPageToIteration(const pdb::MemoryHolderPtr& ram, int iteration) {
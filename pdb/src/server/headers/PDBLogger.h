@@ -27,6 +27,8 @@
 #define PDBLOGGER_H
 
 #include <memory>
+#include <string>
+#include <cstdint>
 #include "LogLevel.h"
 
 #include <pthread.h>
@@ -34,12 +36,28 @@
 
 // used to log client and server activity to a text file
 
+// logs a message only if the level is enabled, the message is not even built otherwise
+#define PDB_LOG(logger, level, method, ...) do { if ((logger)->isEnabled(level)) (logger)->method(__VA_ARGS__); } while (0)
+
+#define PDB_LOG_TRACE(logger, ...) PDB_LOG(logger, LogLevel::TRACE, trace, __VA_ARGS__)
+#define PDB_LOG_DEBUG(logger, ...) PDB_LOG(logger, LogLevel::DEBUG, debug, __VA_ARGS__)
+#define PDB_LOG_INFO(logger, ...) PDB_LOG(logger, LogLevel::INFO, info, __VA_ARGS__)
+#define PDB_LOG_WARN(logger, ...) PDB_LOG(logger, LogLevel::WARN, warn, __VA_ARGS__)
+#define PDB_LOG_ERROR(logger, ...) PDB_LOG(logger, LogLevel::ERROR, error, __VA_ARGS__)
+
 namespace pdb {
 
 // create a smart pointer for PDBLogger objects
 class PDBLogger;
 typedef std::shared_ptr<PDBLogger> PDBLoggerPtr;
 
+// the file a logger writes to, the buffered lines keep it open until they are written
+class PDBLogFile;
+typedef std::shared_ptr<PDBLogFile> PDBLogFilePtr;
+
+// The lines are not written by the thread that logs them. Each thread puts them into its own ring buffer without taking
+// a lock and a background thread writes them out in batches. If a ring buffer is full the line is dropped and counted.
+
 class PDBLogger {
 public:
 
@@ -56,9 +74,23 @@ public:
     // empty logger
     // PDBLogger();
 
-    // closes the text file
+    // closes the text file once the buffered lines are written
     ~PDBLogger();
 
+    // returns true if a line of the level would be written, checked before the line is built by the PDB_LOG macros
+    bool isEnabled(LogLevel level) const {
+        return enabled && level != OFF && level <= loglevel;
+    }
+
+    // writes out the lines that are buffered by all the threads, it is done on exit and on a fatal error
+    static void flush();
+
+    // the number of lines that were dropped because the buffer of a thread was full
+    static uint64_t getNumDropped();
+
+    // the number of lines a thread can buffer
+    static const size_t BUFFER_SIZE;
+
     // added by Jia, so that we can disable debug for performance testing
     void setEnabled(bool enabled);
 
@@ -106,11 +138,14 @@ public:
     void trace(std::string writeMe);
 
 private:
-    // prohibits two people from writing to the file at the same time
+    // hands a line over to the background thread
+    void push(std::string writeMe, bool raw);
+
+    // prohibits two people from opening the file at the same time
     pthread_mutex_t fileLock;
 
     // the location we are writing to
-    FILE* outputFile;
+    PDBLogFilePtr outputFile;
 
     bool enabled = true;
 
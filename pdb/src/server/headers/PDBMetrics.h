@@ -0,0 +1,322 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+namespace pdb {
+
+class PDBMetrics;
+
+/**
+ * The types of the metrics, they map to the prometheus types
+ */
+enum class PDBMetricType {
+  COUNTER,
+  GAUGE,
+  SUMMARY
+};
+
+/**
+ * A metric of the node. It is updated with atomics only so it can be updated from any thread without a lock.
+ * To send the metrics of a process over the wire we sample them into a vector of numbers, the processes run the same
+ * binary so they have the same metrics in the same order.
+ */
+class PDBMetric {
+ public:
+
+  PDBMetric(PDBMetrics &registry, std::string name, std::string help);
+
+  virtual ~PDBMetric() = default;
+
+  /**
+   * Returns the type of the metric
+   */
+  virtual PDBMetricType getType() const = 0;
+
+  /**
+   * Returns how many numbers a sample of the metric has
+   */
+  virtual size_t getNumValues() const = 0;
+
+  /**
+   * Adds the current values of the metric to the sample
+   * @param values - the sample
+   */
+  virtual void sample(std::vector<double> &values) const = 0;
+
+  /**
+   * Writes the values of a sample in the prometheus text format
+   * @param out - where we write them
+   * @param labels - the labels of the sample like process="frontend"
+   * @param values - the values, there are getNumValues of them
+   */
+  virtual void write(std::ostream &out, const std::string &labels, const double *values) const = 0;
+
+  // the name of the metric
+  const std::string name;
+
+  // what the metric is about
+  const std::string help;
+};
+
+/**
+ * A number that only goes up, like the number of requests
+ */
+class PDBCounter : public PDBMetric {
+ public:
+
+  PDBCounter(PDBMetrics &registry, std::string name, std::string help) : PDBMetric(registry, std::move(name), std::move(help)) {}
+
+  void inc(uint64_t n = 1) {
+    value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  uint64_t get() const {
+    return value.load(std::memory_order_relaxed);
+  }
+
+  PDBMetricType getType() const override;
+
+  size_t getNumValues() const override;
+
+  void sample(std::vector<double> &values) const override;
+
+  void write(std::ostream &out, const std::string &labels, const double *values) const override;
+
+ private:
+
+  std::atomic<uint64_t> value{0};
+};
+
+/**
+ * A number that goes up and down, like the number of open connections
+ */
+class PDBGauge : public PDBMetric {
+ public:
+
+  PDBGauge(PDBMetrics &registry, std::string name, std::string help) : PDBMetric(registry, std::move(name), std::move(help)) {}
+
+  void set(int64_t n) {
+    value.store(n, std::memory_order_relaxed);
+  }
+
+  void inc(int64_t n = 1) {
+    value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  void dec(int64_t n = 1) {
+    value.fetch_sub(n, std::memory_order_relaxed);
+  }
+
+  int64_t get() const {
+    return value.load(std::memory_order_relaxed);
+  }
+
+  PDBMetricType getType() const override;
+
+  size_t getNumValues() const override;
+
+  void sample(std::vector<double> &values) const override;
+
+  void write(std::ostream &out, const std::string &labels, const double *values) const override;
+
+ private:
+
+  std::atomic<int64_t> value{0};
+};
+
+/**
+ * A HDR style histogram of integer values, like latencies in nanoseconds. The values below 2^(SUB_BUCKET_BITS + 1) get
+ * their own bucket, above that every power of two is split into 2^SUB_BUCKET_BITS buckets, so a quantile is off by at
+ * most 1/2^SUB_BUCKET_BITS of its value no matter how large it is. It is exported as a prometheus summary.
+ */
+class PDBHistogram : public PDBMetric {
+ public:
+
+  /**
+   * @param unit - what a recorded value is in the unit of the metric, like 1e-9 if we record nanoseconds of a metric in seconds
+   */
+  PDBHistogram(PDBMetrics &registry, std::string name, std::string help, double unit = 1.0)
+      : PDBMetric(registry, std::move(name), std::move(help)), unit(unit) {}
+
+  /**
+   * Records a value
+   */
+  void record(uint64_t value);
+
+  /**
+   * Returns the number of recorded values
+   */
+  uint64_t getCount() const;
+
+  /**
+   * Returns the sum of the recorded values
+   */
+  uint64_t getSum() const;
+
+  /**
+   * Returns the largest recorded value
+   */
+  uint64_t getMax() const;
+
+  /**
+   * Returns the value at a quantile, it is the largest value of the bucket the quantile falls into
+   * @param quantile - between 0 and 1
+   * @return the value, 0 if nothing was recorded
+   */
+  uint64_t getQuantile(double quantile) const;
+
+  PDBMetricType getType() const override;
+
+  size_t getNumValues() const override;
+
+  void sample(std::vector<double> &values) const override;
+
+  void write(std::ostream &out, const std::string &labels, const double *values) const override;
+
+  /**
+   * Returns the bucket a value goes into
+   */
+  static size_t getBucket(uint64_t value);
+
+  /**
+   * Returns the largest value of a bucket
+   */
+  static uint64_t getBucketMax(size_t bucket);
+
+  // each power of two is split into 2^SUB_BUCKET_BITS buckets
+  static const size_t SUB_BUCKET_BITS = 4;
+
+  // the number of buckets we need for all the uint64_t values
+  static const size_t NUM_BUCKETS = (1ul << (SUB_BUCKET_BITS + 1)) + (63 - SUB_BUCKET_BITS) * (1ul << SUB_BUCKET_BITS);
+
+ private:
+
+  // the quantiles we export
+  static const std::vector<double> QUANTILES;
+
+  // what a value is in the unit of the metric
+  double unit;
+
+  // the number of values in each bucket
+  std::atomic<uint64_t> buckets[NUM_BUCKETS] = {};
+
+  // the number of values, their sum and the largest one
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> sum{0};
+  std::atomic<uint64_t> max{0};
+};
+
+/**
+ * The metrics of a node. There is one instance per process, the frontend and the backend each have their own and the
+ * frontend exports both of them @see PDBMetricsServer. The metrics are registered here so they exist even in a process
+ * that never touches them, that way every process has the same metrics in the same order.
+ */
+class PDBMetrics {
+ public:
+
+  /**
+   * Returns the metrics of this process
+   */
+  static PDBMetrics &get();
+
+  /**
+   * Returns how many numbers a sample of all the metrics has
+   */
+  size_t getNumValues() const;
+
+  /**
+   * Samples all the metrics
+   */
+  std::vector<double> sample() const;
+
+  /**
+   * Writes the samples of the processes in the prometheus text format, every process gets its own label. A sample that
+   * does not have the right number of values is skipped.
+   * @param processes - the name of each process and its sample
+   * @return the text
+   */
+  std::string toPrometheus(const std::vector<std::pair<std::string, std::vector<double>>> &processes) const;
+
+ private:
+
+  friend class PDBMetric;
+
+  PDBMetrics() = default;
+
+  // all the metrics in the order they were declared, it has to be declared before them
+  std::vector<PDBMetric*> metrics;
+
+ public:
+
+  /// The buffer manager
+
+  PDBCounter bufferPageHits{*this, "pdb_buffer_page_hits_total", "The pages of sets that were requested and were in the buffer pool"};
+
+  PDBCounter bufferPageMisses{*this, "pdb_buffer_page_misses_total", "The pages of sets that were requested and had to be created or read from disk"};
+
+  PDBCounter bufferEvictions{*this, "pdb_buffer_evictions_total", "The buffer pages that were evicted to make space"};
+
+  PDBCounter bufferWritebacks{*this, "pdb_buffer_writebacks_total", "The dirty pages that were written to disk when their buffer page was evicted"};
+
+  PDBGauge bufferPinnedPages{*this, "pdb_buffer_pinned_pages", "The pages that are pinned"};
+
+  /// The worker queue
+
+  PDBGauge workers{*this, "pdb_workers", "The worker threads"};
+
+  PDBGauge workersBusy{*this, "pdb_workers_busy", "The worker threads that are doing work"};
+
+  PDBHistogram workerWait{*this, "pdb_worker_wait_seconds", "How long it took to get a worker", 1e-9};
+
+  /// The server
+
+  PDBGauge serverConnections{*this, "pdb_server_connections", "The connections the server is handling"};
+
+  PDBCounter serverRequests{*this, "pdb_server_requests_total", "The requests the server has handled"};
+
+  PDBHistogram serverRequestTime{*this, "pdb_server_request_seconds", "How long it took to handle a request", 1e-9};
+
+  /// The communicator
+
+  PDBCounter sentBytes{*this, "pdb_communicator_sent_bytes_total", "The bytes sent over the sockets"};
+
+  PDBCounter receivedBytes{*this, "pdb_communicator_received_bytes_total", "The bytes received over the sockets"};
+
+  /// The page queues
+
+  PDBGauge pageQueuePages{*this, "pdb_page_queue_pages", "The pages waiting in the page queues to be sent to a node"};
+
+  PDBCounter shuffledPages{*this, "pdb_shuffle_sent_pages_total", "The pages sent to the other nodes"};
+
+  PDBCounter shuffledBytes{*this, "pdb_shuffle_sent_bytes_total", "The bytes of the pages sent to the other nodes"};
+
+  /// The plan cache
+
+  PDBCounter planCacheHits{*this, "pdb_plan_cache_hits_total", "The TCAP strings that were already parsed"};
+
+  PDBCounter planCacheMisses{*this, "pdb_plan_cache_misses_total", "The TCAP strings that had to be parsed"};
+
+  PDBCounter logicalPlanCacheHits{*this, "pdb_plan_cache_logical_plan_hits_total", "The jobs that got a logical plan with the lambdas already extracted"};
+
+  PDBCounter logicalPlanCacheMisses{*this, "pdb_plan_cache_logical_plan_misses_total", "The jobs that had to extract the lambdas of their computations"};
+
+  /// The page set cache
+
+  PDBCounter pageSetCacheHits{*this, "pdb_page_set_cache_hits_total", "The intermediate page sets that were reused instead of computed"};
+
+  PDBCounter pageSetCacheMisses{*this, "pdb_page_set_cache_misses_total", "The intermediate page sets that could be cached and had to be computed"};
+
+  PDBCounter pageSetCacheEvictions{*this, "pdb_page_set_cache_evictions_total", "The cached page sets that were removed to make space or because their sets changed"};
+
+  PDBGauge pageSetCacheBytes{*this, "pdb_page_set_cache_bytes", "The bytes of the cached page sets on all the workers"};
+
+  /// The logger
+
+  PDBCounter loggerDropped{*this, "pdb_logger_dropped_total", "The log lines dropped because the buffer of the thread was full"};
+};
+
+}
@@ -59,6 +59,10 @@ public:
         return parent->getWorkerQueue()->getWorker();
     }
 
+    PDBWorkerQueuePtr getWorkerQueue() {
+        return parent->getWorkerQueue();
+    }
+
     PDBLoggerPtr getLogger() {
         return parent->getLogger();
     }
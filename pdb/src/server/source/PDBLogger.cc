@@ -27,11 +27,272 @@
 #include <sys/stat.h>
 #include <pthread.h>
 #include <boost/filesystem/path.hpp>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <algorithm>
 #include "LogLevel.h"
+#include "PDBMetrics.h"
 
 
 namespace pdb {
 
+const size_t PDBLogger::BUFFER_SIZE = 1024;
+
+class PDBLogFile {
+public:
+
+    explicit PDBLogFile(FILE* file) : file(file) {}
+
+    ~PDBLogFile() {
+        fclose(file);
+    }
+
+    FILE* file;
+};
+
+namespace {
+
+// a line waiting to be written
+struct PDBLogRecord {
+
+    // the file we write it to
+    PDBLogFilePtr file;
+
+    // when it was logged, the time is formatted by the background thread
+    time_t time;
+
+    // the thread that logged it
+    pthread_t threadId;
+
+    // the line
+    std::string line;
+
+    // raw data is written as is, without the time and the thread
+    bool raw;
+};
+
+// the ring buffer of a thread, only the thread puts lines into it and only the background thread takes them out
+struct PDBLogBuffer {
+
+    PDBLogBuffer() : records(PDBLogger::BUFFER_SIZE) {}
+
+    // the line i is at i % BUFFER_SIZE
+    std::vector<PDBLogRecord> records;
+
+    // the number of lines put in by the thread
+    std::atomic<uint64_t> head{0};
+
+    // the number of lines taken out by the background thread
+    std::atomic<uint64_t> tail{0};
+};
+
+typedef std::shared_ptr<PDBLogBuffer> PDBLogBufferPtr;
+
+// the state of the background thread, it is never destroyed so the threads that log while the process exits can use it
+struct PDBLogWriter {
+
+    // protects the buffers, it is only taken when a thread logs its first line and by the background thread
+    std::mutex buffersLock;
+
+    // the buffers of all the threads
+    std::vector<PDBLogBufferPtr> buffers;
+
+    // only one thread at a time takes the lines out of the buffers
+    std::mutex drainLock;
+
+    // protects the background thread
+    std::mutex threadLock;
+
+    // the background thread, it is started with the first line
+    std::atomic<std::thread*> thread{nullptr};
+
+    // set when the background thread has to stop
+    std::atomic<bool> stop{false};
+
+    // the number of dropped lines
+    std::atomic<uint64_t> numDropped{0};
+};
+
+PDBLogWriter& getWriter() {
+    static auto* writer = new PDBLogWriter();
+    return *writer;
+}
+
+// takes the lines out of all the buffers and writes them, returns the number of lines written
+size_t drain() {
+
+    auto& writer = getWriter();
+    std::unique_lock<std::mutex> drainGuard(writer.drainLock);
+
+    // grab the buffers, the ones of the threads that have finished are not needed once they are empty
+    std::vector<PDBLogBufferPtr> buffers;
+    {
+        std::unique_lock<std::mutex> buffersGuard(writer.buffersLock);
+        buffers = writer.buffers;
+    }
+
+    // take out the lines
+    std::vector<PDBLogRecord> records;
+    for (auto& buffer : buffers) {
+        auto tail = buffer->tail.load(std::memory_order_relaxed);
+        auto head = buffer->head.load(std::memory_order_acquire);
+        for (auto i = tail; i < head; ++i) {
+            records.emplace_back(std::move(buffer->records[i % PDBLogger::BUFFER_SIZE]));
+        }
+        buffer->tail.store(head, std::memory_order_release);
+    }
+
+    // the threads buffer their lines separately so we put them back in order
+    std::stable_sort(records.begin(), records.end(), [](const PDBLogRecord& lhs, const PDBLogRecord& rhs) {
+        return lhs.time < rhs.time;
+    });
+
+    // write them, the time is only formatted when it changes
+    std::vector<PDBLogFilePtr> files;
+    time_t lastTime = -1;
+    char buf[80] = {};
+    for (auto& record : records) {
+
+        if (record.raw) {
+            fwrite(record.line.data(), sizeof(char), record.line.size(), record.file->file);
+        } else {
+            if (record.time != lastTime) {
+                struct tm tstruct;
+                localtime_r(&record.time, &tstruct);
+                strftime(buf, sizeof(buf), "[%Y-%m-%d-%X] ", &tstruct);
+                lastTime = record.time;
+            }
+            const char* newLine = (!record.line.empty() && record.line.back() == '\n') ? "" : "\n";
+            fprintf(record.file->file, "[%lu]%s%s%s", record.threadId, buf, record.line.c_str(), newLine);
+        }
+
+        // remember the file so we flush it once
+        if (std::find(files.begin(), files.end(), record.file) == files.end()) {
+            files.emplace_back(record.file);
+        }
+    }
+    for (auto& file : files) {
+        fflush(file->file);
+    }
+
+    // remove the buffers of the threads that have finished
+    buffers.clear();
+    {
+        std::unique_lock<std::mutex> buffersGuard(writer.buffersLock);
+        writer.buffers.erase(std::remove_if(writer.buffers.begin(), writer.buffers.end(), [](const PDBLogBufferPtr& buffer) {
+            return buffer.use_count() == 1 &&
+                   buffer->tail.load(std::memory_order_relaxed) == buffer->head.load(std::memory_order_acquire);
+        }), writer.buffers.end());
+    }
+
+    return records.size();
+}
+
+// stops the background thread and writes out what is left, registered with atexit
+void stopWriter() {
+
+    auto& writer = getWriter();
+    std::unique_lock<std::mutex> threadGuard(writer.threadLock);
+    writer.stop = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writer.thread != nullptr) {
+        writer.thread.load()->join();
+        delete writer.thread.load();
+        writer.thread = nullptr;
+    }
+    drain();
+}
+
+// the threads do not survive a fork, so the child starts its own background thread. The lines that were buffered when
+// we forked are written by the parent, the child drops them so they do not end up in the log twice
+void beforeFork() {
+    getWriter().threadLock.lock();
+    getWriter().drainLock.lock();
+    getWriter().buffersLock.lock();
+}
+
+void afterForkInParent() {
+    getWriter().buffersLock.unlock();
+    getWriter().drainLock.unlock();
+    getWriter().threadLock.unlock();
+}
+
+void afterForkInChild() {
+    getWriter().thread = nullptr;
+    for (auto& buffer : getWriter().buffers) {
+        auto head = buffer->head.load(std::memory_order_relaxed);
+        for (auto i = buffer->tail.load(std::memory_order_relaxed); i < head; ++i) {
+            buffer->records[i % PDBLogger::BUFFER_SIZE] = PDBLogRecord();
+        }
+        buffer->tail.store(head, std::memory_order_relaxed);
+    }
+    getWriter().buffersLock.unlock();
+    getWriter().drainLock.unlock();
+    getWriter().threadLock.unlock();
+}
+
+// starts the background thread if it is not running
+void startWriter() {
+
+    auto& writer = getWriter();
+    std::unique_lock<std::mutex> threadGuard(writer.threadLock);
+    if (writer.thread != nullptr || writer.stop) {
+        return;
+    }
+
+    // register the exit and fork handlers the first time
+    static bool registered = false;
+    if (!registered) {
+        atexit(stopWriter);
+        pthread_atfork(beforeFork, afterForkInParent, afterForkInChild);
+        registered = true;
+    }
+
+    writer.thread = new std::thread([&writer]() {
+        while (!writer.stop) {
+
+            // if there was nothing to write we wait a bit for more lines to batch
+            if (drain() == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    });
+}
+
+// makes the buffer of the current thread
+PDBLogBufferPtr registerBuffer() {
+
+    auto buffer = std::make_shared<PDBLogBuffer>();
+    auto& writer = getWriter();
+    std::unique_lock<std::mutex> buffersGuard(writer.buffersLock);
+    writer.buffers.emplace_back(buffer);
+    return buffer;
+}
+
+// returns the buffer of the current thread
+PDBLogBuffer& getBuffer() {
+    thread_local PDBLogBufferPtr buffer = registerBuffer();
+    return *buffer;
+}
+
+// opens the log file
+PDBLogFilePtr openFile(const std::string& outFile) {
+
+    FILE* file = fopen(outFile.c_str(), "a");
+    if (file == nullptr) {
+        std::cout << "Unable to open logging file : " << outFile << ".\n";
+        perror(nullptr);
+        exit(-1);
+    }
+
+    return std::make_shared<PDBLogFile>(file);
+}
+
+}
+
 PDBLogger::PDBLogger(const std::string &directory, const std::string &fName) {
 
     // create a director logs if not exists
@@ -40,13 +301,7 @@ PDBLogger::PDBLogger(const std::string &directory, const std::string &fName) {
         PDB_COUT << "logs folder created." << std::endl;
     }
 
-    std::string outFile = (boost::filesystem::path(directory) / fName).string();
-    outputFile = fopen(outFile.c_str(), "a");
-    if (outputFile == nullptr) {
-        std::cout << "Unable to open logging file : " << outFile << ".\n";
-        perror(nullptr);
-        exit(-1);
-    }
+    outputFile = openFile((boost::filesystem::path(directory) / fName).string());
 
     pthread_mutex_init(&fileLock, nullptr);
     loglevel = WARN;
@@ -63,12 +318,7 @@ PDBLogger::PDBLogger(std::string fName) {
         PDB_COUT << "logs folder created." << std::endl;
     }
 
-    outputFile = fopen(std::string("logs/" + fName).c_str(), "a");
-    if (outputFile == nullptr) {
-        std::cout << "Unable to open logging file : " << std::string("logs/" + fName) << ".\n";
-        perror(nullptr);
-        exit(-1);
-    }
+    outputFile = openFile("logs/" + fName);
 
     pthread_mutex_init(&fileLock, nullptr);
     loglevel = WARN;
@@ -77,15 +327,9 @@ PDBLogger::PDBLogger(std::string fName) {
 
 void PDBLogger::open(std::string fName) {
     const LockGuard guard{fileLock};
-    if (outputFile != nullptr) {
-        fclose(outputFile);
-    }
-    outputFile = fopen((std::string("logs/") + fName).c_str(), "a");
-    if (outputFile == nullptr) {
-        std::cout << "Unable to open logging file : " << std::string("logs/") + fName <<"\n";
-        perror(nullptr);
-        exit(-1);
-    }
+
+    // the lines that are still buffered go to the old file, it is closed once they are written
+    std::atomic_store(&outputFile, openFile("logs/" + fName));
 }
 
 /*PDBLogger::PDBLogger() {
@@ -95,33 +339,25 @@ void PDBLogger::open(std::string fName) {
 
 PDBLogger::~PDBLogger() {
 
-    if (outputFile != nullptr)
-        fclose(outputFile);
+    // the buffered lines hold on to the file, so it is closed when the last of them is written
+    outputFile = nullptr;
 
     pthread_mutex_destroy(&fileLock);
 }
 
-// void PDBLogger::writeLn(std :: string writeMe) {
-//    if (!this->enabled) {
-//        return;
-//    }
-//    const LockGuard guard{fileLock};
-//    if (writeMe[writeMe.length() - 1] != '\n') {
-//        fprintf(outputFile, "%s\n", writeMe.c_str());
-//    } else {
-//        fprintf(outputFile, "%s", writeMe.c_str());
-//    }
-//    fflush(outputFile);
-//}
+void PDBLogger::flush() {
+    drain();
+}
+
+uint64_t PDBLogger::getNumDropped() {
+    return getWriter().numDropped.load(std::memory_order_relaxed);
+}
 
 void PDBLogger::writeInt(int writeMe) {
     if (!this->enabled) {
         return;
     }
     writeLn(std::to_string(writeMe));
-    //    const LockGuard guard{fileLock};
-    //    fprintf(outputFile, "%d\n", writeMe);
-    //    fflush(outputFile);
 }
 
 
@@ -136,17 +372,14 @@ void PDBLogger::writeInt(int writeMe) {
 //	TRACE
 
 void PDBLogger::trace(std::string writeMe) {
-    if (!this->enabled || this->loglevel == OFF || this->loglevel == FATAL ||
-        this->loglevel == ERROR || this->loglevel == WARN || this->loglevel == INFO ||
-        this->loglevel == DEBUG) {
+    if (!isEnabled(TRACE)) {
         return;
     }
     this->writeLn("[TRACE] " + writeMe);
 }
 
 void PDBLogger::debug(std::string writeMe) {
-    if (!this->enabled || this->loglevel == OFF || this->loglevel == FATAL ||
-        this->loglevel == ERROR || this->loglevel == WARN || this->loglevel == INFO) {
+    if (!isEnabled(DEBUG)) {
         return;
     }
     this->writeLn("[DEBUG] " + writeMe);
@@ -154,8 +387,7 @@ void PDBLogger::debug(std::string writeMe) {
 
 
 void PDBLogger::info(std::string writeMe) {
-    if (!this->enabled || this->loglevel == OFF || this->loglevel == FATAL ||
-        this->loglevel == ERROR || this->loglevel == WARN) {
+    if (!isEnabled(INFO)) {
         return;
     }
     this->writeLn("[INFO] " + writeMe);
@@ -163,8 +395,7 @@ void PDBLogger::info(std::string writeMe) {
 
 
 void PDBLogger::warn(std::string writeMe) {
-    if (!this->enabled || this->loglevel == OFF || this->loglevel == FATAL ||
-        this->loglevel == ERROR) {
+    if (!isEnabled(WARN)) {
         return;
     }
     this->writeLn("[WARN] " + writeMe);
@@ -172,7 +403,7 @@ void PDBLogger::warn(std::string writeMe) {
 
 
 void PDBLogger::error(std::string writeMe) {
-    if (!this->enabled || this->loglevel == OFF || this->loglevel == FATAL) {
+    if (!isEnabled(ERROR)) {
         return;
     }
     this->writeLn("[ERROR] " + writeMe);
@@ -180,10 +411,13 @@ void PDBLogger::error(std::string writeMe) {
 
 
 void PDBLogger::fatal(std::string writeMe) {
-    if (!this->enabled || this->loglevel == OFF) {
+    if (!isEnabled(FATAL)) {
         return;
     }
     this->writeLn("[FATAL] " + writeMe);
+
+    // the process is probably about to die, so we write it out right away
+    flush();
 }
 
 
@@ -194,35 +428,49 @@ void PDBLogger::writeLn(std::string writeMe) {
         return;
     }
 
-    const LockGuard guard{fileLock};
-
-    // get the current time and date
-    time_t now = time(0);
-    struct tm tstruct;
-    char buf[80];
-    tstruct = *localtime(&now);
-    strftime(buf, sizeof(buf), "[%Y-%m-%d-%X] ", &tstruct);
+    push(std::move(writeMe), false);
+}
 
-    // add date and time to the log
-    writeMe = buf + writeMe;
 
-    // JiaNote: to get thread id for debugging
-    pthread_t threadId = pthread_self();
-    if (writeMe[writeMe.length() - 1] != '\n') {
-        fprintf(outputFile, "[%lu]%s\n", threadId, writeMe.c_str());
-    } else {
-        fprintf(outputFile, "[%lu]%s", threadId, writeMe.c_str());
+void PDBLogger::write(char* data, unsigned int length) {
+    if (!this->enabled) {
+        return;
     }
-    fflush(outputFile);
+
+    push(std::string(data, length), true);
 }
 
+void PDBLogger::push(std::string writeMe, bool raw) {
 
-void PDBLogger::write(char* data, unsigned int length) {
-    if (!this->enabled) {
+    auto& buffer = getBuffer();
+
+    // if the buffer is full we drop the line rather than wait for the background thread
+    auto head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= BUFFER_SIZE) {
+        getWriter().numDropped.fetch_add(1, std::memory_order_relaxed);
+        PDBMetrics::get().loggerDropped.inc();
         return;
     }
-    const LockGuard guard{fileLock};
-    fwrite(data, sizeof(char), length, outputFile);
+
+    // put the line into the next slot
+    auto& record = buffer.records[head % BUFFER_SIZE];
+    record.file = std::atomic_load(&outputFile);
+    record.time = time(nullptr);
+    record.threadId = pthread_self();
+    record.line = std::move(writeMe);
+    record.raw = raw;
+
+    // publish it, the fence makes sure that either we see that the writer is stopping or its last drain sees the line
+    buffer.head.store(head + 1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // make sure somebody writes it out, once the process is exiting we do it ourselves
+    auto& writer = getWriter();
+    if (writer.stop) {
+        drain();
+    } else if (writer.thread == nullptr) {
+        startWriter();
+    }
 }
 
 // added by Jia
@@ -0,0 +1,212 @@
+#include <PDBMetrics.h>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+namespace pdb {
+
+PDBMetric::PDBMetric(PDBMetrics &registry, std::string name, std::string help) : name(std::move(name)), help(std::move(help)) {
+  registry.metrics.emplace_back(this);
+}
+
+PDBMetricType PDBCounter::getType() const {
+  return PDBMetricType::COUNTER;
+}
+
+size_t PDBCounter::getNumValues() const {
+  return 1;
+}
+
+void PDBCounter::sample(std::vector<double> &values) const {
+  values.emplace_back((double) get());
+}
+
+void PDBCounter::write(std::ostream &out, const std::string &labels, const double *values) const {
+  out << name << '{' << labels << "} " << (uint64_t) values[0] << '\n';
+}
+
+PDBMetricType PDBGauge::getType() const {
+  return PDBMetricType::GAUGE;
+}
+
+size_t PDBGauge::getNumValues() const {
+  return 1;
+}
+
+void PDBGauge::sample(std::vector<double> &values) const {
+  values.emplace_back((double) get());
+}
+
+void PDBGauge::write(std::ostream &out, const std::string &labels, const double *values) const {
+  out << name << '{' << labels << "} " << (int64_t) values[0] << '\n';
+}
+
+const std::vector<double> PDBHistogram::QUANTILES = { 0.5, 0.9, 0.99 };
+
+void PDBHistogram::record(uint64_t value) {
+
+  buckets[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+  count.fetch_add(1, std::memory_order_relaxed);
+  sum.fetch_add(value, std::memory_order_relaxed);
+
+  // update the max if we are larger
+  auto current = max.load(std::memory_order_relaxed);
+  while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+uint64_t PDBHistogram::getCount() const {
+  return count.load(std::memory_order_relaxed);
+}
+
+uint64_t PDBHistogram::getSum() const {
+  return sum.load(std::memory_order_relaxed);
+}
+
+uint64_t PDBHistogram::getMax() const {
+  return max.load(std::memory_order_relaxed);
+}
+
+uint64_t PDBHistogram::getQuantile(double quantile) const {
+
+  // we add up the buckets separately from the count since they are updated at different times
+  uint64_t total = 0;
+  for (const auto &bucket : buckets) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+
+  // nothing is recorded
+  if (total == 0) {
+    return 0;
+  }
+
+  // find the bucket with the value at the rank of the quantile
+  auto rank = std::max<uint64_t>(1, (uint64_t) std::ceil(quantile * (double) total));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    seen += buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(getBucketMax(i), getMax());
+    }
+  }
+
+  return getMax();
+}
+
+PDBMetricType PDBHistogram::getType() const {
+  return PDBMetricType::SUMMARY;
+}
+
+size_t PDBHistogram::getNumValues() const {
+  return 2 + QUANTILES.size();
+}
+
+void PDBHistogram::sample(std::vector<double> &values) const {
+
+  values.emplace_back((double) getCount());
+  values.emplace_back((double) getSum() * unit);
+  for (auto quantile : QUANTILES) {
+    values.emplace_back((double) getQuantile(quantile) * unit);
+  }
+}
+
+void PDBHistogram::write(std::ostream &out, const std::string &labels, const double *values) const {
+
+  for (size_t i = 0; i < QUANTILES.size(); ++i) {
+    out << name << '{' << labels << ",quantile=\"" << QUANTILES[i] << "\"} " << values[2 + i] << '\n';
+  }
+  out << name << "_sum{" << labels << "} " << values[1] << '\n';
+  out << name << "_count{" << labels << "} " << (uint64_t) values[0] << '\n';
+}
+
+size_t PDBHistogram::getBucket(uint64_t value) {
+
+  // the small values get their own bucket
+  if (value < (1ul << (SUB_BUCKET_BITS + 1))) {
+    return value;
+  }
+
+  // find the power of two and the sub bucket in it
+  size_t exponent = 63 - __builtin_clzl(value);
+  size_t subBucket = (value >> (exponent - SUB_BUCKET_BITS)) & ((1ul << SUB_BUCKET_BITS) - 1);
+  return (1ul << (SUB_BUCKET_BITS + 1)) + ((exponent - SUB_BUCKET_BITS - 1) << SUB_BUCKET_BITS) + subBucket;
+}
+
+uint64_t PDBHistogram::getBucketMax(size_t bucket) {
+
+  // the small values get their own bucket
+  if (bucket < (1ul << (SUB_BUCKET_BITS + 1))) {
+    return bucket;
+  }
+
+  // figure out the power of two and the sub bucket
+  bucket -= (1ul << (SUB_BUCKET_BITS + 1));
+  size_t exponent = (bucket >> SUB_BUCKET_BITS) + SUB_BUCKET_BITS + 1;
+  size_t subBucket = bucket & ((1ul << SUB_BUCKET_BITS) - 1);
+
+  // the bucket starts here and has 2^(exponent - SUB_BUCKET_BITS) values
+  auto shift = exponent - SUB_BUCKET_BITS;
+  uint64_t first = ((1ul << SUB_BUCKET_BITS) + subBucket) << shift;
+  return first + ((1ul << shift) - 1);
+}
+
+PDBMetrics &PDBMetrics::get() {
+
+  // never destroyed so the threads that are still running while the process exits can update it
+  static auto *metrics = new PDBMetrics();
+  return *metrics;
+}
+
+size_t PDBMetrics::getNumValues() const {
+
+  size_t numValues = 0;
+  for (const auto &metric : metrics) {
+    numValues += metric->getNumValues();
+  }
+  return numValues;
+}
+
+std::vector<double> PDBMetrics::sample() const {
+
+  std::vector<double> values;
+  values.reserve(getNumValues());
+  for (const auto &metric : metrics) {
+    metric->sample(values);
+  }
+  return values;
+}
+
+std::string PDBMetrics::toPrometheus(const std::vector<std::pair<std::string, std::vector<double>>> &processes) const {
+
+  auto numValues = getNumValues();
+
+  std::stringstream out;
+  size_t offset = 0;
+  for (const auto &metric : metrics) {
+
+    // write the description of the metric
+    out << "# HELP " << metric->name << ' ' << metric->help << '\n';
+    out << "# TYPE " << metric->name << ' ';
+    switch (metric->getType()) {
+      case PDBMetricType::COUNTER: out << "counter\n"; break;
+      case PDBMetricType::GAUGE: out << "gauge\n"; break;
+      case PDBMetricType::SUMMARY: out << "summary\n"; break;
+    }
+
+    // write the values of each process
+    for (const auto &process : processes) {
+
+      // skip the sample if it is not from the same metrics
+      if (process.second.size() != numValues) {
+        continue;
+      }
+
+      metric->write(out, "process=\"" + process.first + "\"", process.second.data() + offset);
+    }
+
+    offset += metric->getNumValues();
+  }
+
+  return out.str();
+}
+
+}
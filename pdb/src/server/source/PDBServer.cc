@@ -40,7 +40,10 @@
 #include "ShutDown.h"
 #include "ServerFunctionality.h"
 #include "UseTemporaryAllocationBlock.h"
+#include "AllocationBlockPool.h"
 #include "SimpleRequestResult.h"
+#include "PDBMetrics.h"
+#include <chrono>
 #include <memory>
 
 namespace pdb {
@@ -286,6 +289,13 @@ bool PDBServer::handleOneRequest(PDBBuzzerPtr callerBuzzer, PDBCommunicatorPtr m
       functionality->cleanup();
     }
 
+    // report how many allocation blocks and receive buffers we got from the pools
+    auto poolStats = AllocationBlockPool::getStats();
+    logger->info("PDBServer: allocation block pool hits=" + std::to_string(poolStats.hits) +
+                 ", misses=" + std::to_string(poolStats.misses) +
+                 ", discarded=" + std::to_string(poolStats.discarded) +
+                 ", hit rate=" + std::to_string(poolStats.hitRate()));
+
     // kill the FD and let everyone know we are done
     allDone = true;
 
@@ -316,11 +326,18 @@ bool PDBServer::handleOneRequest(PDBBuzzerPtr callerBuzzer, PDBCommunicatorPtr m
 
     PDBCommWorkPtr tempWork = handlers[requestID]->clone();
 
+    // we keep track of how long the request takes
+    auto requestStart = std::chrono::steady_clock::now();
+
     logger->trace("PDBServer: setting guts");
     tempWork->setGuts(myCommunicator, this);
     tempWorker->execute(tempWork, callerBuzzer);
     callerBuzzer->wait();
     logger->trace("PDBServer: handler has completed its work");
+
+    auto &metrics = PDBMetrics::get();
+    metrics.serverRequests.inc();
+    metrics.serverRequestTime.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - requestStart).count());
     return true;
   }
 }
@@ -20,6 +20,7 @@
 #define SERVER_WORK_CC
 
 #include "ServerWork.h"
+#include "PDBMetrics.h"
 
 namespace pdb {
 
@@ -43,6 +44,9 @@ PDBBuzzerPtr ServerWork::getLinkedBuzzer() {
 
 void ServerWork::execute(PDBBuzzerPtr callerBuzzer) {
 
+    // the connection is open until we are done with it
+    PDBMetrics::get().serverConnections.inc();
+
     // while there is still something to do on this connection
     getLogger()->trace("ServerWork: about to handle a request");
     PDBBuzzerPtr myBuzzer{getLinkedBuzzer()};
@@ -52,6 +56,7 @@ void ServerWork::execute(PDBBuzzerPtr callerBuzzer) {
     }
 
     getLogger()->trace("ServerWork: done with this server work");
+    PDBMetrics::get().serverConnections.dec();
     callerBuzzer->buzz(PDBAlarm::WorkAllDone);
 }
 }
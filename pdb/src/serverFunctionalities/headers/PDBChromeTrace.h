@@ -0,0 +1,78 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <PDBTracer.h>
+
+namespace pdb {
+
+class PDBChromeTrace;
+using PDBChromeTracePtr = std::shared_ptr<PDBChromeTrace>;
+
+/**
+ * Merges the events of all the processes that ran a computation into one timeline and writes it in the Chrome trace
+ * event format, so it can be opened in chrome://tracing or Perfetto. Every process gets its own row and every thread
+ * of it its own track, the events are put on the system clock of their node. It is thread safe.
+ */
+class PDBChromeTrace {
+ public:
+
+  /**
+   * Adds the events of a process that were sent over the wire
+   * @param node - the node the process is running on
+   * @param trace - the events
+   */
+  void addTrace(const std::string &node, const PDBTrace &trace);
+
+  /**
+   * Adds the events of a process that were collected in this process
+   * @param process - the name of the process
+   * @param events - the events
+   */
+  void addEvents(const std::string &process, const std::vector<PDBTraceEvent> &events);
+
+  /**
+   * Is the trace empty
+   */
+  bool isEmpty() const;
+
+  /**
+   * Returns the trace as a JSON document in the Chrome trace event format
+   */
+  std::string toJSON() const;
+
+  /**
+   * Writes the trace to a file
+   * @param path - the path of the file
+   * @param error - the error if we fail
+   * @return true if we succeed
+   */
+  bool write(const std::string &path, std::string &error) const;
+
+ private:
+
+  /**
+   * Adds an event, has to be called with the lock
+   */
+  void addEvent(uint64_t processID, const std::string &name, uint64_t threadID, int64_t begin, uint64_t duration, uint64_t arg,
+                uint64_t jobID);
+
+  /**
+   * Returns the id of a process, has to be called with the lock
+   */
+  uint64_t getProcessID(const std::string &process);
+
+  // the events as JSON objects
+  std::vector<std::string> events;
+
+  // the ids of the processes
+  std::map<std::string, uint64_t> processes;
+
+  // locks the events
+  mutable std::mutex m;
+};
+
+}
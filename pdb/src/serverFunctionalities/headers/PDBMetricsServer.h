@@ -0,0 +1,101 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include "ServerFunctionality.h"
+
+namespace pdb {
+
+/**
+ * Serves the metrics of the node @see PDBMetrics. Both the frontend and the backend answer a CluGetMetricsRequest with
+ * a sample of their metrics, the frontend also puts the metrics of the whole node in the prometheus text format into
+ * the answer. If the metrics port is set, the frontend also listens on it and answers every connection with the
+ * metrics of the node in the prometheus text format, so the node can be scraped.
+ */
+class PDBMetricsServer : public ServerFunctionality {
+public:
+
+  /**
+   * @param isFrontend - are we running in the frontend
+   */
+  explicit PDBMetricsServer(bool isFrontend);
+
+  ~PDBMetricsServer();
+
+  void init() override;
+
+  void registerHandlers(PDBServer &forMe) override;
+
+  void cleanup() override;
+
+  /**
+   * Returns the metrics of this frontend and its backend in the prometheus text format
+   */
+  std::string getNodeMetrics();
+
+private:
+
+  /**
+   * Grabs a sample of the metrics of the backend
+   * @param values - the sample
+   * @param error - the error if we fail
+   * @return true if we succeed
+   */
+  bool getBackendMetrics(std::vector<double> &values, std::string &error);
+
+  /**
+   * Accepts the connections on the metrics port until we are stopped
+   */
+  void listen();
+
+  /**
+   * Sends the metrics of the node over a connection and closes it
+   * @param connection - the socket of the connection
+   */
+  void serve(int connection);
+
+  /**
+   * Are we running in the frontend
+   */
+  bool isFrontend;
+
+  /**
+   * The socket we accept the connections for the metrics on, -1 if we don't
+   */
+  int sockFD = -1;
+
+  /**
+   * Set when we have to stop listening
+   */
+  std::atomic_bool stopped{false};
+
+  /**
+   * Accepts the connections
+   */
+  std::thread listener;
+
+  /**
+   * The logger
+   */
+  PDBLoggerPtr logger;
+};
+
+}
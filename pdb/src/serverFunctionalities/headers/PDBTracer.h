@@ -0,0 +1,172 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace pdb {
+
+class PDBTrace;
+
+// the computation or the job of an event that was not recorded while running one
+const uint64_t PDB_NO_TRACE_JOB = std::numeric_limits<uint64_t>::max();
+
+/**
+ * An event of a thread, the time the thread spent somewhere like running an iteration of a pipeline or waiting for a page
+ */
+struct PDBTraceEvent {
+
+  // the name of the event, it is a string literal so we only keep the pointer
+  const char *name = nullptr;
+
+  // when the event started and ended (steady clock ns)
+  uint64_t begin = 0;
+  uint64_t end = 0;
+
+  // a number that goes with the event, like the page number or the number of bytes
+  uint64_t arg = 0;
+
+  // the computation and the job the thread was running when it recorded the event
+  uint64_t computationID = PDB_NO_TRACE_JOB;
+  uint64_t jobID = PDB_NO_TRACE_JOB;
+
+  // the thread the event happened on, they are numbered in the order the threads recorded their first event
+  uint32_t threadID = 0;
+};
+
+/**
+ * Records the events of the threads of this process. Every thread writes into its own ring buffer so recording an event
+ * does not take a lock, the buffer keeps the last BUFFER_SIZE events of the thread. Every slot of the buffer has a
+ * sequence number so an event that is overwritten while it is collected is skipped instead of being read half written.
+ * An event is tagged with the job the thread is running @see PDBTraceJobScope. The events are usually recorded through
+ * the macros in @see Tracing.h so they are not there if tracing is disabled.
+ */
+class PDBTracer {
+ public:
+
+  /**
+   * Returns the time we use for the events (steady clock ns)
+   */
+  static uint64_t now();
+
+  /**
+   * Records an event of the current thread
+   * @param name - the name of the event, has to be a string literal
+   * @param begin - when it started
+   * @param end - when it ended
+   * @param arg - a number that goes with the event
+   */
+  static void record(const char *name, uint64_t begin, uint64_t end, uint64_t arg = 0);
+
+  /**
+   * Grabs the events of all the threads that started after some time and belong to a computation or a job, the events
+   * that were not recorded while running a job are always there. An event that is being written at the same time is
+   * left out.
+   * @param since - the time
+   * @param computationID - the computation, PDB_NO_TRACE_JOB for all of them
+   * @param jobID - the job of the computation, PDB_NO_TRACE_JOB for all of them
+   * @return the events ordered by the time they started
+   */
+  static std::vector<PDBTraceEvent> collect(uint64_t since, uint64_t computationID = PDB_NO_TRACE_JOB, uint64_t jobID = PDB_NO_TRACE_JOB);
+
+  /**
+   * Returns the computation the current thread is running, PDB_NO_TRACE_JOB if it is not running one
+   */
+  static uint64_t getComputation();
+
+  /**
+   * Returns the job the current thread is running, PDB_NO_TRACE_JOB if it is not running one
+   */
+  static uint64_t getJob();
+
+  /**
+   * Sets the job the current thread is running, the events it records are tagged with it
+   * @param computationID - the computation of the job
+   * @param jobID - the job
+   */
+  static void setJob(uint64_t computationID, uint64_t jobID);
+
+  /**
+   * Returns how much the system clock is ahead of the steady clock, so the events of different nodes can be put on the
+   * same time line (ns)
+   */
+  static int64_t getClockOffset();
+
+  /**
+   * Returns how large the allocation block has to be to put the events into a @see PDBTrace
+   * @param events - the events
+   * @return the size in bytes
+   */
+  static size_t getTraceSize(const std::vector<PDBTraceEvent> &events);
+
+  /**
+   * Returns how large the allocation block has to be to copy a trace that was sent over the wire
+   * @param trace - the trace
+   * @return the size in bytes
+   */
+  static size_t getTraceSize(const PDBTrace &trace);
+
+  /**
+   * Puts the events into a trace so they can be sent over the wire
+   * @param events - the events
+   * @param trace - the trace
+   */
+  static void toTrace(const std::vector<PDBTraceEvent> &events, PDBTrace &trace);
+
+  /**
+   * How many events we keep per thread
+   */
+  static const size_t BUFFER_SIZE;
+};
+
+/**
+ * Tags the events of the current thread with a job while it is in scope, works like @see PDBPinOwnerScope
+ */
+class PDBTraceJobScope {
+ public:
+
+  PDBTraceJobScope(uint64_t computationID, uint64_t jobID) : previousComputation(PDBTracer::getComputation()),
+                                                             previousJob(PDBTracer::getJob()) {
+    PDBTracer::setJob(computationID, jobID);
+  }
+
+  ~PDBTraceJobScope() {
+    PDBTracer::setJob(previousComputation, previousJob);
+  }
+
+  PDBTraceJobScope(const PDBTraceJobScope &) = delete;
+  PDBTraceJobScope &operator=(const PDBTraceJobScope &) = delete;
+
+ private:
+
+  // the job of the thread before the scope
+  uint64_t previousComputation;
+  uint64_t previousJob;
+};
+
+/**
+ * Records the time from its construction until it is destroyed as an event of the current thread
+ */
+class PDBTraceScope {
+ public:
+
+  explicit PDBTraceScope(const char *name, uint64_t arg = 0) : name(name), arg(arg), begin(PDBTracer::now()) {}
+
+  ~PDBTraceScope() {
+    PDBTracer::record(name, begin, PDBTracer::now(), arg);
+  }
+
+ private:
+
+  // the name of the event
+  const char *name;
+
+  // the number of the event
+  uint64_t arg;
+
+  // when we started
+  uint64_t begin;
+};
+
+}
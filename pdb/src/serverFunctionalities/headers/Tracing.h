@@ -0,0 +1,56 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef PDB_TRACING_H
+#define PDB_TRACING_H
+
+#include <PDBTracer.h>
+
+#define PDB_TRACE_CONCAT_INNER(a, b) a##b
+#define PDB_TRACE_CONCAT(a, b) PDB_TRACE_CONCAT_INNER(a, b)
+
+#ifdef PDB_TRACING
+
+/**
+ * This macro records the time from where it is used until the end of the block as an event of the current thread
+ * @param name - the name of the event, has to be a string literal
+ */
+#define PDB_TRACE_SCOPE(name) pdb::PDBTraceScope PDB_TRACE_CONCAT(___traceScope_, __LINE__)(name)
+
+/**
+ * Same as PDB_TRACE_SCOPE but the event also has a number, like the page number or the number of bytes
+ * @param name - the name of the event, has to be a string literal
+ * @param arg - the number
+ */
+#define PDB_TRACE_SCOPE_ARG(name, arg) pdb::PDBTraceScope PDB_TRACE_CONCAT(___traceScope_, __LINE__)(name, arg)
+
+#else
+
+/**
+ * Tracing is disabled so this does nothing
+ */
+#define PDB_TRACE_SCOPE(name)
+
+/**
+ * Tracing is disabled so this does nothing
+ */
+#define PDB_TRACE_SCOPE_ARG(name, arg)
+
+#endif // PDB_TRACING
+
+#endif //PDB_TRACING_H
@@ -0,0 +1,134 @@
+#include <PDBChromeTrace.h>
+#include <PDBTrace.h>
+#include <fstream>
+#include <sstream>
+
+namespace pdb {
+
+namespace {
+
+// escapes a string so it can go into JSON
+std::string escape(const std::string &value) {
+
+  std::string out;
+  out.reserve(value.size());
+  for (auto c : value) {
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\t': out += "\\t"; break;
+      default: {
+        if ((unsigned char) c < 0x20) {
+          continue;
+        }
+        out += c;
+      }
+    }
+  }
+  return out;
+}
+
+}
+
+void PDBChromeTrace::addTrace(const std::string &node, const PDBTrace &trace) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  auto processID = getProcessID(node + " " + (std::string) trace.process);
+  for (size_t i = 0; i + 5 < trace.events.size(); i += 6) {
+
+    // move the event to the system clock of the node
+    auto begin = (int64_t) trace.events[i + 2] + trace.clockOffset;
+    addEvent(processID, (std::string) trace.names[trace.events[i]], trace.events[i + 1], begin, trace.events[i + 3], trace.events[i + 4],
+             trace.events[i + 5]);
+  }
+}
+
+void PDBChromeTrace::addEvents(const std::string &process, const std::vector<PDBTraceEvent> &processEvents) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  auto processID = getProcessID(process);
+  auto clockOffset = PDBTracer::getClockOffset();
+  for (const auto &event : processEvents) {
+    addEvent(processID, event.name, event.threadID, (int64_t) event.begin + clockOffset, event.end - event.begin, event.arg, event.jobID);
+  }
+}
+
+bool PDBChromeTrace::isEmpty() const {
+  std::unique_lock<std::mutex> lck(m);
+  return events.empty();
+}
+
+std::string PDBChromeTrace::toJSON() const {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  std::stringstream ss;
+  ss << "{\"traceEvents\":[\n";
+
+  // name the processes
+  bool first = true;
+  for (const auto &process : processes) {
+    ss << (first ? "" : ",\n") << R"({"name":"process_name","ph":"M","pid":)" << process.second
+       << R"(,"args":{"name":")" << escape(process.first) << "\"}}";
+    first = false;
+  }
+
+  // the events
+  for (const auto &event : events) {
+    ss << (first ? "" : ",\n") << event;
+    first = false;
+  }
+
+  ss << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return ss.str();
+}
+
+bool PDBChromeTrace::write(const std::string &path, std::string &error) const {
+
+  // open the file
+  std::ofstream out(path, std::ios::out | std::ios::trunc);
+  if (!out.is_open()) {
+    error = "Could not open the trace file " + path;
+    return false;
+  }
+
+  // write the trace
+  out << toJSON();
+  if (!out.good()) {
+    error = "Could not write the trace file " + path;
+    return false;
+  }
+
+  return true;
+}
+
+void PDBChromeTrace::addEvent(uint64_t processID, const std::string &name, uint64_t threadID, int64_t begin, uint64_t duration,
+                              uint64_t arg, uint64_t jobID) {
+
+  // a complete event, the times are in microseconds
+  std::stringstream ss;
+  ss << R"({"name":")" << escape(name) << R"(","ph":"X","pid":)" << processID << ",\"tid\":" << threadID
+     << ",\"ts\":" << begin / 1000 << "." << (begin % 1000) / 100 << ",\"dur\":" << duration / 1000 << "." << (duration % 1000) / 100
+     << ",\"args\":{\"arg\":" << arg;
+
+  // the job if the event was recorded while running one
+  if (jobID != PDB_NO_TRACE_JOB) {
+    ss << ",\"job\":" << jobID;
+  }
+  ss << "}}";
+  events.emplace_back(ss.str());
+}
+
+uint64_t PDBChromeTrace::getProcessID(const std::string &process) {
+
+  auto it = processes.find(process);
+  if (it == processes.end()) {
+    it = processes.insert(std::make_pair(process, (uint64_t) processes.size())).first;
+  }
+  return it->second;
+}
+
+}
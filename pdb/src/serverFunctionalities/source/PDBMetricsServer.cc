@@ -0,0 +1,253 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <PDBMetricsServer.h>
+#include <PDBMetrics.h>
+#include <GenericWork.h>
+#include <HeapRequest.h>
+#include <HeapRequestHandler.h>
+#include <CluGetMetricsRequest.h>
+#include <CluGetMetricsResult.h>
+#include <UseTemporaryAllocationBlock.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace pdb {
+
+PDBMetricsServer::PDBMetricsServer(bool isFrontend) : isFrontend(isFrontend) {
+
+  // create the logger
+  logger = make_shared<PDBLogger>("metricsServer.log");
+}
+
+PDBMetricsServer::~PDBMetricsServer() {
+  cleanup();
+}
+
+void PDBMetricsServer::init() {
+
+  // only the frontend listens and only if we have a port
+  auto port = getConfiguration()->metricsPort;
+  if (!isFrontend || port <= 0) {
+    return;
+  }
+
+  // get an internet socket
+  sockFD = socket(AF_INET, SOCK_STREAM, 0);
+  if (sockFD < 0) {
+    logger->error("PDBMetricsServer: could not get FD to internet socket " + std::string(strerror(errno)));
+    return;
+  }
+
+  // so we can restart the node right away
+  int optval = 1;
+  setsockopt(sockFD, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+
+  // bind the socket FD
+  struct sockaddr_in serverAddress{};
+  serverAddress.sin_family = AF_INET;
+  serverAddress.sin_port = htons((uint16_t) port);
+  auto &address = getConfiguration()->metricsAddress;
+  if (inet_pton(AF_INET, address.c_str(), &serverAddress.sin_addr) != 1) {
+
+    // the node works without the metrics so we just log it
+    logger->error("PDBMetricsServer: " + address + " is not an IPv4 address");
+    close(sockFD);
+    sockFD = -1;
+    return;
+  }
+  if (::bind(sockFD, (struct sockaddr *) &serverAddress, sizeof(serverAddress)) < 0 || ::listen(sockFD, 16) != 0) {
+
+    // the node works without the metrics so we just log it
+    logger->error("PDBMetricsServer: could not listen on " + address + ":" + std::to_string(port) + " " + std::string(strerror(errno)));
+    close(sockFD);
+    sockFD = -1;
+    return;
+  }
+
+  // start accepting the connections
+  listener = std::thread([this]() { listen(); });
+  logger->info("PDBMetricsServer: serving the metrics on " + address + ":" + std::to_string(port));
+}
+
+void PDBMetricsServer::registerHandlers(PDBServer &forMe) {
+
+  forMe.registerHandler(
+      CluGetMetricsRequest_TYPEID,
+      make_shared<HeapRequestHandler<CluGetMetricsRequest>>(
+          [&](Handle<CluGetMetricsRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+            // sample our metrics, the frontend also adds the text for the whole node
+            auto values = PDBMetrics::get().sample();
+            auto text = isFrontend ? getNodeMetrics() : std::string();
+
+            // create an allocation block to hold the response
+            const UseTemporaryAllocationBlock tempBlock{values.size() * sizeof(double) + text.size() + 64 * 1024};
+
+            // create the response
+            Handle<CluGetMetricsResult> response = makeObject<CluGetMetricsResult>(values, text);
+
+            // sends result to requester
+            std::string error;
+            bool success = sendUsingMe->sendObject(response, error);
+
+            // return the result
+            return make_pair(success, error);
+          }));
+}
+
+void PDBMetricsServer::cleanup() {
+
+  // we are not listening
+  if (sockFD < 0) {
+    return;
+  }
+
+  // stop the listener, shutting down the socket wakes it up
+  stopped = true;
+  shutdown(sockFD, SHUT_RDWR);
+  if (listener.joinable()) {
+    listener.join();
+  }
+
+  close(sockFD);
+  sockFD = -1;
+}
+
+std::string PDBMetricsServer::getNodeMetrics() {
+
+  // our metrics
+  std::vector<std::pair<std::string, std::vector<double>>> processes;
+  processes.emplace_back("frontend", PDBMetrics::get().sample());
+
+  // the metrics of the backend
+  std::string error;
+  std::vector<double> backend;
+  if (getBackendMetrics(backend, error)) {
+    processes.emplace_back("backend", std::move(backend));
+  } else {
+    logger->error("PDBMetricsServer: could not get the metrics of the backend " + error);
+  }
+
+  return PDBMetrics::get().toPrometheus(processes);
+}
+
+bool PDBMetricsServer::getBackendMetrics(std::vector<double> &values, std::string &error) {
+
+  // the request is empty, the result is a few numbers per metric
+  const UseTemporaryAllocationBlock tempBlock{64 * 1024};
+
+  // connect to the backend
+  PDBCommunicatorPtr communicatorToBackend = make_shared<PDBCommunicator>();
+  if (!communicatorToBackend->connectToLocalServer(logger, getConfiguration()->ipcFile, error)) {
+    return false;
+  }
+
+  // ask for the metrics
+  Handle<CluGetMetricsRequest> request = makeObject<CluGetMetricsRequest>();
+  if (!communicatorToBackend->sendObject(request, error)) {
+    return false;
+  }
+
+  // grab the sample
+  return RequestFactory::waitHeapRequest<CluGetMetricsResult, bool>(logger, communicatorToBackend, false,
+    [&](Handle<CluGetMetricsResult> result) {
+
+      // check the result
+      if (result == nullptr) {
+        error = "Did not get the metrics from the backend";
+        return false;
+      }
+
+      // copy the values
+      values.resize(result->values.size());
+      for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = result->values[i];
+      }
+      return true;
+    });
+}
+
+void PDBMetricsServer::listen() {
+
+  while (!stopped) {
+
+    // wait for a connection
+    int connection = accept(sockFD, nullptr, nullptr);
+    if (connection < 0) {
+
+      // did we get woken up because we are stopping
+      if (stopped) {
+        break;
+      }
+
+      logger->error("PDBMetricsServer: could not accept a connection " + std::string(strerror(errno)));
+      continue;
+    }
+
+    // serve it on a worker, they have their own allocation blocks
+    PDBWorkerPtr worker = getWorker();
+    PDBWorkPtr work = make_shared<GenericWork>([this, connection](PDBBuzzerPtr callerBuzzer) {
+      serve(connection);
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone);
+    });
+    worker->execute(work, work->getLinkedBuzzer());
+  }
+}
+
+void PDBMetricsServer::serve(int connection) {
+
+  // don't wait forever for the request
+  struct timeval timeout{};
+  timeout.tv_sec = 1;
+  setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  // read the request, we answer every request with the metrics so we don't look at it
+  char request[4096];
+  if (read(connection, request, sizeof(request)) < 0) {
+    logger->error("PDBMetricsServer: could not read the request " + std::string(strerror(errno)));
+  }
+
+  // make the response
+  auto body = getNodeMetrics();
+  std::string response = "HTTP/1.1 200 OK\r\n"
+                         "Content-Type: text/plain; version=0.0.4\r\n"
+                         "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                         "Connection: close\r\n\r\n" + body;
+
+  // send it
+  const char *start = response.data();
+  const char *end = start + response.size();
+  while (start != end) {
+
+    auto numBytes = write(connection, start, end - start);
+    if (numBytes <= 0) {
+      logger->error("PDBMetricsServer: could not send the metrics " + std::string(strerror(errno)));
+      break;
+    }
+    start += numBytes;
+  }
+
+  close(connection);
+}
+
+}
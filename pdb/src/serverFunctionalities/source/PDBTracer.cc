@@ -0,0 +1,256 @@
+#include <PDBTracer.h>
+#include <PDBTrace.h>
+#include <InterfaceFunctions.h>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace pdb {
+
+const size_t PDBTracer::BUFFER_SIZE = 32 * 1024;
+
+namespace {
+
+// how long we keep the buffer of a thread that has finished after its last event (ns)
+const uint64_t FINISHED_BUFFER_TIMEOUT = 10ull * 60ull * 1000000000ull;
+
+/**
+ * A slot of a ring buffer. The sequence number is the number of the event in it plus one, it is zero while the event is
+ * being written, so a reader that sees the same sequence number before and after it copied the event got all of it.
+ */
+struct PDBTraceSlot {
+
+  std::atomic<uint64_t> sequence{0};
+
+  std::atomic<const char *> name{nullptr};
+  std::atomic<uint64_t> begin{0};
+  std::atomic<uint64_t> end{0};
+  std::atomic<uint64_t> arg{0};
+  std::atomic<uint64_t> computationID{PDB_NO_TRACE_JOB};
+  std::atomic<uint64_t> jobID{PDB_NO_TRACE_JOB};
+};
+
+/**
+ * The ring buffer of a thread, only the thread writes into it
+ */
+struct PDBTraceBuffer {
+
+  explicit PDBTraceBuffer(uint32_t threadID) : threadID(threadID), events(PDBTracer::BUFFER_SIZE) {}
+
+  // the id of the thread
+  uint32_t threadID;
+
+  // the events, the event i is at i % BUFFER_SIZE
+  std::vector<PDBTraceSlot> events;
+
+  // how many events the thread has recorded
+  std::atomic<uint64_t> numEvents{0};
+};
+
+using PDBTraceBufferPtr = std::shared_ptr<PDBTraceBuffer>;
+
+// the buffers of all the threads and the lock that protects them, the lock is only taken when a thread records its
+// first event and when we collect the events
+std::mutex &getBuffersLock() {
+  static std::mutex buffersLock;
+  return buffersLock;
+}
+
+std::vector<PDBTraceBufferPtr> &getBuffers() {
+  static std::vector<PDBTraceBufferPtr> buffers;
+  return buffers;
+}
+
+// makes the buffer of the current thread
+PDBTraceBufferPtr registerBuffer() {
+
+  std::unique_lock<std::mutex> lck(getBuffersLock());
+
+  // the threads are numbered in the order they show up
+  static uint32_t lastThreadID = 0;
+  auto buffer = std::make_shared<PDBTraceBuffer>(lastThreadID++);
+  getBuffers().emplace_back(buffer);
+  return buffer;
+}
+
+// returns the buffer of the current thread
+PDBTraceBuffer &getBuffer() {
+  thread_local PDBTraceBufferPtr buffer = registerBuffer();
+  return *buffer;
+}
+
+// the computation and the job the current thread is running
+thread_local uint64_t currentComputation = PDB_NO_TRACE_JOB;
+thread_local uint64_t currentJob = PDB_NO_TRACE_JOB;
+
+// does an event belong to a computation or a job, the events without one always do
+bool belongsTo(uint64_t eventID, uint64_t id) {
+  return id == PDB_NO_TRACE_JOB || eventID == PDB_NO_TRACE_JOB || eventID == id;
+}
+
+}
+
+uint64_t PDBTracer::now() {
+  return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PDBTracer::record(const char *name, uint64_t begin, uint64_t end, uint64_t arg) {
+
+  // mark the next slot as being written
+  auto &buffer = getBuffer();
+  auto i = buffer.numEvents.load(std::memory_order_relaxed);
+  auto &slot = buffer.events[i % BUFFER_SIZE];
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  // write the event
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.begin.store(begin, std::memory_order_relaxed);
+  slot.end.store(end, std::memory_order_relaxed);
+  slot.arg.store(arg, std::memory_order_relaxed);
+  slot.computationID.store(currentComputation, std::memory_order_relaxed);
+  slot.jobID.store(currentJob, std::memory_order_relaxed);
+
+  // publish it
+  slot.sequence.store(i + 1, std::memory_order_release);
+  buffer.numEvents.store(i + 1, std::memory_order_release);
+}
+
+uint64_t PDBTracer::getComputation() {
+  return currentComputation;
+}
+
+uint64_t PDBTracer::getJob() {
+  return currentJob;
+}
+
+void PDBTracer::setJob(uint64_t computationID, uint64_t jobID) {
+  currentComputation = computationID;
+  currentJob = jobID;
+}
+
+std::vector<PDBTraceEvent> PDBTracer::collect(uint64_t since, uint64_t computationID, uint64_t jobID) {
+
+  std::unique_lock<std::mutex> lck(getBuffersLock());
+
+  // go through the last events of each thread
+  std::vector<PDBTraceEvent> events;
+  for (const auto &buffer : getBuffers()) {
+
+    auto numEvents = buffer->numEvents.load(std::memory_order_acquire);
+    auto first = numEvents > BUFFER_SIZE ? numEvents - BUFFER_SIZE : 0;
+    for (auto i = first; i < numEvents; ++i) {
+
+      // skip the slot if the thread is writing a newer event into it
+      auto &slot = buffer->events[i % BUFFER_SIZE];
+      if (slot.sequence.load(std::memory_order_acquire) != i + 1) {
+        continue;
+      }
+
+      // copy the event
+      PDBTraceEvent event;
+      event.name = slot.name.load(std::memory_order_relaxed);
+      event.begin = slot.begin.load(std::memory_order_relaxed);
+      event.end = slot.end.load(std::memory_order_relaxed);
+      event.arg = slot.arg.load(std::memory_order_relaxed);
+      event.computationID = slot.computationID.load(std::memory_order_relaxed);
+      event.jobID = slot.jobID.load(std::memory_order_relaxed);
+      event.threadID = buffer->threadID;
+
+      // if the thread started writing into the slot while we copied it, we might have half of the event
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != i + 1) {
+        continue;
+      }
+
+      if (event.begin >= since && belongsTo(event.computationID, computationID) && belongsTo(event.jobID, jobID)) {
+        events.emplace_back(event);
+      }
+    }
+  }
+
+  // the buffers of the threads that have finished are not needed once the jobs that were running on them had the time
+  // to collect their events, we can not drop them right away since other jobs only collect their own events
+  auto &buffers = getBuffers();
+  auto current = now();
+  buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [current](const PDBTraceBufferPtr &buffer) {
+    auto numEvents = buffer->numEvents.load(std::memory_order_acquire);
+    auto lastEnd = numEvents == 0 ? 0 : buffer->events[(numEvents - 1) % BUFFER_SIZE].end.load(std::memory_order_relaxed);
+    return buffer.use_count() == 1 && lastEnd + FINISHED_BUFFER_TIMEOUT < current;
+  }), buffers.end());
+
+  // order them by time
+  std::sort(events.begin(), events.end(), [](const PDBTraceEvent &lhs, const PDBTraceEvent &rhs) {
+    return lhs.begin < rhs.begin;
+  });
+
+  return events;
+}
+
+int64_t PDBTracer::getClockOffset() {
+  auto system = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  return (int64_t) system - (int64_t) now();
+}
+
+size_t PDBTracer::getTraceSize(const std::vector<PDBTraceEvent> &events) {
+
+  // the names are string literals so the same name has the same pointer
+  std::unordered_set<const char *> names;
+  for (const auto &event : events) {
+    names.insert(event.name);
+  }
+
+  // toTrace reserves the vectors so they never copy themselves, six numbers per event and the names
+  size_t size = 4 * 1024 + events.size() * 6 * sizeof(uint64_t);
+  for (const auto &name : names) {
+    size += 64 + strlen(name);
+  }
+  return size;
+}
+
+size_t PDBTracer::getTraceSize(const PDBTrace &trace) {
+
+  // a copy has vectors of the same size
+  size_t size = 4 * 1024 + trace.events.size() * sizeof(uint64_t);
+  for (size_t i = 0; i < trace.names.size(); ++i) {
+    size += 64 + trace.names[i].size();
+  }
+  return size;
+}
+
+void PDBTracer::toTrace(const std::vector<PDBTraceEvent> &events, PDBTrace &trace) {
+
+  trace.clockOffset = getClockOffset();
+
+  // number the names first so the vectors are allocated only once, the names are string literals so the same name has
+  // the same pointer
+  std::unordered_map<const char *, uint64_t> names;
+  std::vector<const char *> orderedNames;
+  for (const auto &event : events) {
+    if (names.insert(std::make_pair(event.name, (uint64_t) orderedNames.size())).second) {
+      orderedNames.emplace_back(event.name);
+    }
+  }
+  trace.names.reserve((uint32_t) orderedNames.size());
+  for (const auto &name : orderedNames) {
+    trace.names.push_back(name);
+  }
+  trace.events.reserve((uint32_t) (events.size() * 6));
+
+  for (const auto &event : events) {
+
+    trace.events.push_back(names[event.name]);
+    trace.events.push_back(event.threadID);
+    trace.events.push_back(event.begin);
+    trace.events.push_back(event.end - event.begin);
+    trace.events.push_back(event.arg);
+    trace.events.push_back(event.jobID);
+  }
+}
+
+}
@@ -6,6 +6,7 @@
 #define PDB_ABSTRATCTPAGESET_H
 
 #include <PDBPageHandle.h>
+#include <PDBWorker.h>
 
 namespace pdb {
 
@@ -34,10 +35,43 @@ public:
    */
   virtual size_t getNumPages() = 0;
 
+  /**
+   * Returns how many bytes the pages of this page set take, a page that had its size frozen takes only that much
+   * @return the number of bytes, zero if the page set does not keep its pages
+   */
+  virtual size_t getSize() { return 0; }
+
   /**
    * Resets the page set so it can be reused
    */
   virtual void resetPageSet() = 0;
+
+  /**
+   * Returns how many pages a reader should keep pinned ahead of the page it is currently processing.
+   * Page sets with pages that are expected to be resident in memory return a small number, the ones that need to
+   * fetch them from disk or the frontend a larger one. If zero the reader should not look ahead at all.
+   * By default we don't look ahead.
+   * @return the lookahead depth
+   */
+  virtual size_t getLookaheadDepth() { return 0; }
+
+  /**
+   * Sets the workers a reader uses to look ahead. The pages are fetched on a worker since getting a page from the
+   * buffer manager of the backend allocates the request objects, and only the workers have their own allocator.
+   * @param workers - the worker queue of the node
+   */
+  void setLookaheadWorkers(const PDBWorkerQueuePtr &workers) { lookaheadWorkers = workers; }
+
+  /**
+   * Returns the workers a reader uses to look ahead, if there are none the reader does not look ahead
+   * @return the worker queue or null
+   */
+  const PDBWorkerQueuePtr &getLookaheadWorkers() { return lookaheadWorkers; }
+
+ protected:
+
+  // the workers a reader uses to look ahead
+  PDBWorkerQueuePtr lookaheadWorkers;
 };
 
 }
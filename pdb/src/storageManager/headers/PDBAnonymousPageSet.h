@@ -53,6 +53,8 @@ public:
    */
   size_t getNumPages() override;
 
+  size_t getSize() override;
+
   /**
    * Returns the maximum size of the page
    * @return the size
@@ -76,6 +78,13 @@ public:
    */
   void setAccessOrder(PDBAnonymousPageSetAccessPattern pattern);
 
+  /**
+   * The anonymous pages are usually still in memory, but they might have been evicted to the temporary file
+   * if we were low on memory, so we look only one page ahead.
+   * @return the lookahead depth
+   */
+  size_t getLookaheadDepth() override;
+
  private:
 
   /**
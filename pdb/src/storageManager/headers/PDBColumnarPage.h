@@ -0,0 +1,287 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace pdb {
+
+/**
+ * The kind of values a column of a columnar page has, every integer type and bool is stored as a 64 bit integer, floats
+ * and doubles as the bits of a double and strings as strings
+ */
+enum PDBColumnType : uint8_t {
+  PDB_INTEGER_COLUMN,
+  PDB_FLOAT_COLUMN,
+  PDB_STRING_COLUMN
+};
+
+/**
+ * How the values of a column chunk are encoded
+ */
+enum PDBColumnEncoding : uint8_t {
+
+  // the values as they are, 8 bytes per number, the lengths of the strings followed by their bytes for strings
+  PDB_PLAIN_ENCODING,
+
+  // runs of the same value, a value and the length of its run for each run
+  PDB_RLE_ENCODING,
+
+  // the first value, and the differences between the consecutive values bit-packed as an offset from the smallest one
+  PDB_DELTA_ENCODING,
+
+  // the smallest value and the offset of each value from it packed into as few bits as the largest one needs
+  PDB_BIT_PACKED_ENCODING,
+
+  // the distinct values followed by the bit-packed index of the value for each row
+  PDB_DICTIONARY_ENCODING
+};
+
+/**
+ * The decoded values of a column. Numbers end up in integers, the doubles as their bits. Strings end up in the
+ * dictionary with the index of the string for each row in codes, if the strings were not dictionary encoded each row
+ * has its own entry.
+ */
+struct PDBColumnValues {
+
+  // the numbers of the column, one for each row
+  std::vector<int64_t> integers;
+
+  // the distinct strings of a string column
+  std::vector<std::string> dictionary;
+
+  // for each row the index of its string in the dictionary
+  std::vector<uint32_t> codes;
+};
+
+/**
+ * The layout of a set page that stores the records column by column (PAX). The page starts with a header, followed by
+ * a chunk for each column, a chunk is a column header, the name of the column and the encoded values, each chunk
+ * starts at an 8 byte boundary. The encoding of each chunk is picked when the page is written, we try every encoding
+ * the values can have and keep the smallest one.
+ *
+ * The first thing on the page is the size of it, just like with a record, so everything that only moves the pages
+ * around treats a columnar page like any other page. The magic number that follows tells us it is columnar.
+ *
+ * The pages are written and read by @see PDBColumns, that knows what member each column is.
+ */
+class PDBColumnarPage {
+ public:
+
+  /**
+   * The header of a columnar page
+   */
+  struct Header {
+
+    // the number of bytes on the page including the header
+    uint64_t numBytes;
+
+    // always the magic number
+    uint64_t magic;
+
+    // the number of records on the page
+    uint64_t numRows;
+
+    // the number of columns
+    uint64_t numColumns;
+
+    // how many bytes a record took on average before it was encoded, used to size the memory for the objects
+    uint64_t rowBytes;
+  };
+
+  /**
+   * The header of a column chunk, the name and the values follow it
+   */
+  struct ColumnHeader {
+
+    // the type of the column @see PDBColumnType
+    uint8_t type;
+
+    // the encoding of the values @see PDBColumnEncoding
+    uint8_t encoding;
+
+    // the length of the name
+    uint16_t nameSize;
+
+    // unused
+    uint32_t reserved;
+
+    // the size of the encoded values
+    uint64_t dataSize;
+  };
+
+  /**
+   * The magic number after the size of every columnar page
+   */
+  static const uint64_t magicNumber = 0xC01C01C01C01C01Cull;
+
+  /**
+   * Parses a columnar page
+   * @param page - the bytes of the page, if it is not a valid columnar page @see isValid returns false
+   */
+  explicit PDBColumnarPage(const void *page);
+
+  /**
+   * Checks if the bytes of a page are a columnar page
+   * @param page - the bytes of the page
+   * @return true if it is, false otherwise
+   */
+  static bool isColumnar(const void *page);
+
+  /**
+   * Starts writing a columnar page to a buffer, the buffer is cleared
+   * @param numRows - the number of records we are storing
+   * @param rowBytes - the average size of a record before it was encoded
+   * @param page - the buffer
+   */
+  static void startPage(uint64_t numRows, uint64_t rowBytes, std::vector<char> &page);
+
+  /**
+   * Adds a column of numbers to the page with the encoding that makes it the smallest
+   * @param name - the name of the column
+   * @param type - PDB_INTEGER_COLUMN or PDB_FLOAT_COLUMN if these are the bits of doubles
+   * @param values - a value for each row
+   * @param page - the buffer we started with @see startPage
+   * @return the encoding we picked
+   */
+  static PDBColumnEncoding addColumn(const std::string &name, PDBColumnType type, const std::vector<int64_t> &values, std::vector<char> &page);
+
+  /**
+   * Adds a column of strings to the page with the encoding that makes it the smallest
+   * @param name - the name of the column
+   * @param values - a value for each row
+   * @param page - the buffer we started with @see startPage
+   * @return the encoding we picked
+   */
+  static PDBColumnEncoding addColumn(const std::string &name, const std::vector<std::string> &values, std::vector<char> &page);
+
+  /**
+   * Encodes numbers with a particular encoding
+   * @param values - the values
+   * @param encoding - the encoding
+   * @param out - we append the encoded values to it
+   * @return true if the values can be encoded like that, false otherwise
+   */
+  static bool encode(const std::vector<int64_t> &values, PDBColumnEncoding encoding, std::vector<char> &out);
+
+  /**
+   * Encodes strings with a particular encoding, strings are either plain or dictionary encoded
+   * @param values - the values
+   * @param encoding - the encoding
+   * @param out - we append the encoded values to it
+   * @return true if the values can be encoded like that, false otherwise
+   */
+  static bool encode(const std::vector<std::string> &values, PDBColumnEncoding encoding, std::vector<char> &out);
+
+  /**
+   * Decodes the values of a column chunk
+   * @param type - the type of the column
+   * @param encoding - the encoding of the values
+   * @param data - the encoded values
+   * @param dataSize - the size of the encoded values
+   * @param numRows - the number of values
+   * @param values - the numbers end up in integers the strings in dictionary and codes
+   * @return true if we succeeded, false if the values are corrupted
+   */
+  static bool decode(PDBColumnType type, PDBColumnEncoding encoding, const char *data, size_t dataSize, size_t numRows, PDBColumnValues &values);
+
+  /**
+   * Is the page a columnar page that is not corrupted
+   */
+  bool isValid() const;
+
+  /**
+   * Returns the number of records on the page
+   */
+  uint64_t getNumRows() const;
+
+  /**
+   * Returns the average size of a record before it was encoded
+   */
+  uint64_t getRowBytes() const;
+
+  /**
+   * Returns the number of bytes of the page
+   */
+  uint64_t getNumBytes() const;
+
+  /**
+   * Returns the number of columns on the page
+   */
+  size_t getNumColumns() const;
+
+  /**
+   * Returns the index of the column with that name
+   * @param name - the name of the column
+   * @return the index or -1 if there is no such column
+   */
+  int32_t getColumnIndex(const std::string &name) const;
+
+  /**
+   * Returns the name of a column
+   */
+  const std::string &getColumnName(size_t column) const;
+
+  /**
+   * Returns the type of a column
+   */
+  PDBColumnType getColumnType(size_t column) const;
+
+  /**
+   * Returns the encoding of a column
+   */
+  PDBColumnEncoding getColumnEncoding(size_t column) const;
+
+  /**
+   * Returns the size of the encoded values of a column
+   */
+  size_t getColumnSize(size_t column) const;
+
+  /**
+   * Decodes the values of a column
+   * @param column - the index of the column
+   * @param values - where we put the values
+   * @return true if we succeeded, false if the column is corrupted
+   */
+  bool decode(size_t column, PDBColumnValues &values) const;
+
+ private:
+
+  /**
+   * A column chunk on the page
+   */
+  struct Column {
+
+    // the name of the column
+    std::string name;
+
+    // the header of the chunk
+    const ColumnHeader *header;
+
+    // the encoded values
+    const char *data;
+  };
+
+  /**
+   * Appends a column chunk to a page
+   */
+  static void addColumn(const std::string &name, PDBColumnType type, PDBColumnEncoding encoding, const std::vector<char> &data, std::vector<char> &page);
+
+  /**
+   * The header of the page
+   */
+  const Header *header = nullptr;
+
+  /**
+   * The columns on the page
+   */
+  std::vector<Column> columns;
+
+  /**
+   * Did we manage to parse the page
+   */
+  bool valid = false;
+};
+
+}
@@ -0,0 +1,490 @@
+#pragma once
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <typeinfo>
+#include <type_traits>
+#include <vector>
+#include "Handle.h"
+#include "PDBVector.h"
+#include "PDBString.h"
+#include "InterfaceFunctions.h"
+#include "PDBColumnarPage.h"
+
+namespace pdb {
+
+template<class T>
+class PDBColumns;
+
+/**
+ * SFINAE test to check if a type describes its columns, a type can be stored in a columnar set if it has a static
+ * method template<class Columns> static void getColumns(Columns &columns) that adds its members @see PDBColumns::add
+ */
+template<typename T>
+class hasColumns {
+
+  typedef char one;
+  typedef long two;
+
+  template<typename C> static one test(decltype(C::getColumns(std::declval<PDBColumns<C>&>())) *);
+  template<typename C> static two test(...);
+
+ public:
+  enum { value = sizeof(test<T>(nullptr)) == sizeof(char) };
+};
+
+/**
+ * The values of one column for all the records of a page, the scans hand out pointers to them instead of the records
+ */
+class PDBColumnData {
+ public:
+
+  virtual ~PDBColumnData() = default;
+
+  /**
+   * Returns a pointer to the value of a row, the values of the consecutive rows are consecutive
+   * @param row - the row
+   * @return the pointer to the value
+   */
+  virtual void *getValue(size_t row) = 0;
+};
+
+using PDBColumnDataPtr = std::shared_ptr<PDBColumnData>;
+
+/**
+ * A column of the records of type T, it knows how to get the values of its member out of the records and how to put
+ * them back
+ */
+template<class T>
+class PDBColumn {
+ public:
+
+  explicit PDBColumn(std::string name) : name(std::move(name)) {}
+
+  virtual ~PDBColumn() = default;
+
+  /**
+   * Adds the values of the member of each record as a column to a page
+   * @param rows - the records
+   * @param page - the page we are writing @see PDBColumnarPage::startPage
+   */
+  virtual void encode(Vector<Handle<T>> &rows, std::vector<char> &page) = 0;
+
+  /**
+   * Sets the member of each record to its decoded value, the strings are allocated in the current allocation block
+   * @param values - the decoded values
+   * @param rows - the records
+   */
+  virtual void fill(const PDBColumnValues &values, Vector<Handle<T>> &rows) = 0;
+
+  /**
+   * Makes the values of the member for each row from the decoded values, the strings are allocated in the current
+   * allocation block
+   * @param values - the decoded values
+   * @param numRows - the number of rows
+   * @return the values
+   */
+  virtual PDBColumnDataPtr makeData(const PDBColumnValues &values, size_t numRows) = 0;
+
+  /**
+   * Returns the type of the member
+   */
+  virtual const std::type_info &getType() = 0;
+
+  /**
+   * The name of the column, it is the name of the member
+   */
+  std::string name;
+};
+
+template<class T>
+using PDBColumnPtr = std::shared_ptr<PDBColumn<T>>;
+
+/**
+ * The values of a column that are stored in a std::vector, that is every number
+ */
+template<class M>
+class PDBVectorColumnData : public PDBColumnData {
+ public:
+
+  void *getValue(size_t row) override {
+    return &values[row];
+  }
+
+  std::vector<M> values;
+};
+
+/**
+ * The values of a column that are stored in a pdb::Vector, that is the strings and the handles to them
+ */
+template<class M>
+class PDBObjectColumnData : public PDBColumnData {
+ public:
+
+  void *getValue(size_t row) override {
+    return values->c_ptr() + row;
+  }
+
+  Handle<Vector<M>> values;
+};
+
+/**
+ * A column for a member that is a number or a bool
+ */
+template<class T, class M>
+class PDBNumberColumn : public PDBColumn<T> {
+ public:
+
+  PDBNumberColumn(const std::string &name, M T::*member) : PDBColumn<T>(name), member(member) {}
+
+  void encode(Vector<Handle<T>> &rows, std::vector<char> &page) override {
+
+    std::vector<int64_t> values(rows.size());
+    for (uint32_t i = 0; i < rows.size(); ++i) {
+      values[i] = toInteger((*rows[i]).*member);
+    }
+    PDBColumnarPage::addColumn(this->name, std::is_floating_point<M>::value ? PDB_FLOAT_COLUMN : PDB_INTEGER_COLUMN, values, page);
+  }
+
+  void fill(const PDBColumnValues &values, Vector<Handle<T>> &rows) override {
+    for (uint32_t i = 0; i < rows.size(); ++i) {
+      (*rows[i]).*member = fromInteger(values.integers[i]);
+    }
+  }
+
+  PDBColumnDataPtr makeData(const PDBColumnValues &values, size_t numRows) override {
+
+    auto data = std::make_shared<PDBVectorColumnData<M>>();
+    data->values.resize(numRows);
+    for (size_t i = 0; i < numRows; ++i) {
+      data->values[i] = fromInteger(values.integers[i]);
+    }
+    return data;
+  }
+
+  const std::type_info &getType() override {
+    return typeid(M);
+  }
+
+ private:
+
+  // doubles and floats are stored as the bits of a double
+  template<class N = M>
+  static typename std::enable_if_t<std::is_floating_point<N>::value, int64_t> toInteger(N value) {
+    int64_t bits;
+    auto asDouble = (double) value;
+    memcpy(&bits, &asDouble, sizeof(bits));
+    return bits;
+  }
+
+  template<class N = M>
+  static typename std::enable_if_t<!std::is_floating_point<N>::value, int64_t> toInteger(N value) {
+    return (int64_t) value;
+  }
+
+  template<class N = M>
+  static typename std::enable_if_t<std::is_floating_point<N>::value, N> fromInteger(int64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(bits));
+    return (N) value;
+  }
+
+  template<class N = M>
+  static typename std::enable_if_t<!std::is_floating_point<N>::value, N> fromInteger(int64_t value) {
+    return (N) value;
+  }
+
+  // the member
+  M T::*member;
+};
+
+/**
+ * A column for a member that is a pdb::String or a handle to one, a null handle is stored as an empty string
+ */
+template<class T, class M>
+class PDBStringColumn : public PDBColumn<T> {
+ public:
+
+  PDBStringColumn(const std::string &name, M T::*member) : PDBColumn<T>(name), member(member) {}
+
+  void encode(Vector<Handle<T>> &rows, std::vector<char> &page) override {
+
+    std::vector<std::string> values(rows.size());
+    for (uint32_t i = 0; i < rows.size(); ++i) {
+      values[i] = toString((*rows[i]).*member);
+    }
+    PDBColumnarPage::addColumn(this->name, values, page);
+  }
+
+  void fill(const PDBColumnValues &values, Vector<Handle<T>> &rows) override {
+
+    auto dictionary = makeDictionary(values);
+    for (uint32_t i = 0; i < rows.size(); ++i) {
+      (*rows[i]).*member = (*dictionary)[values.codes[i]];
+    }
+  }
+
+  PDBColumnDataPtr makeData(const PDBColumnValues &values, size_t numRows) override {
+
+    auto dictionary = makeDictionary(values);
+    auto data = std::make_shared<PDBObjectColumnData<M>>();
+    data->values = makeObject<Vector<M>>(numRows);
+    data->values->resize(numRows);
+    for (size_t i = 0; i < numRows; ++i) {
+      (*data->values)[i] = (*dictionary)[values.codes[i]];
+    }
+    return data;
+  }
+
+  const std::type_info &getType() override {
+    return typeid(M);
+  }
+
+ private:
+
+  static std::string toString(String &value) {
+    return value;
+  }
+
+  static std::string toString(Handle<String> &value) {
+    return value == nullptr ? std::string() : (std::string) *value;
+  }
+
+  // makes a value for each entry of the dictionary, the handles of the rows with the same string share the object
+  static Handle<Vector<M>> makeDictionary(const PDBColumnValues &values) {
+
+    Handle<Vector<M>> dictionary = makeObject<Vector<M>>(values.dictionary.size());
+    dictionary->resize(values.dictionary.size());
+    for (uint32_t i = 0; i < values.dictionary.size(); ++i) {
+      setValue((*dictionary)[i], values.dictionary[i]);
+    }
+    return dictionary;
+  }
+
+  static void setValue(String &value, const std::string &s) {
+    value = s;
+  }
+
+  static void setValue(Handle<String> &value, const std::string &s) {
+    value = makeObject<String>(s);
+  }
+
+  // the member
+  M T::*member;
+};
+
+/**
+ * The columns a type is stored in when it is in a columnar set. A type that wants to be stored like that lists its
+ * members like this
+ *
+ * template<class Columns>
+ * static void getColumns(Columns &columns) {
+ *   columns.add("age", &Employee::age);
+ *   columns.add("name", &Employee::name);
+ *   columns.method("getAge", { "age" });
+ * }
+ *
+ * The members can be numbers, bools, pdb::Strings or handles to pdb::Strings, every other member keeps the value it
+ * gets from the default constructor when a record is read back. The methods tell a scan what columns it has to read
+ * if a computation only calls them, a method that is not listed makes the scan read every column.
+ */
+template<class T>
+class PDBColumns {
+ public:
+
+  /**
+   * Returns the columns of the type, they are made once
+   */
+  static PDBColumns<T> &get() {
+    static PDBColumns<T> columns;
+    return columns;
+  }
+
+  /**
+   * Adds a member that is a number or a bool
+   */
+  template<class M>
+  typename std::enable_if_t<std::is_arithmetic<M>::value> add(const std::string &name, M T::*member) {
+    columns.emplace_back(std::make_shared<PDBNumberColumn<T, M>>(name, member));
+  }
+
+  /**
+   * Adds a member that is a pdb::String
+   */
+  void add(const std::string &name, String T::*member) {
+    columns.emplace_back(std::make_shared<PDBStringColumn<T, String>>(name, member));
+  }
+
+  /**
+   * Adds a member that is a handle to a pdb::String
+   */
+  void add(const std::string &name, Handle<String> T::*member) {
+    columns.emplace_back(std::make_shared<PDBStringColumn<T, Handle<String>>>(name, member));
+  }
+
+  /**
+   * Adds a method that only reads some of the columns
+   * @param name - the name of the method
+   * @param usedColumns - the names of the columns it reads
+   */
+  void method(const std::string &name, std::set<std::string> usedColumns) {
+    methods[name] = std::move(usedColumns);
+  }
+
+  /**
+   * Finds the columns a method reads
+   * @param name - the name of the method
+   * @return the names of the columns or null if we don't know the method
+   */
+  const std::set<std::string> *findMethod(const std::string &name) const {
+    auto it = methods.find(name);
+    return it == methods.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * Returns the number of columns
+   */
+  size_t size() const {
+    return columns.size();
+  }
+
+  /**
+   * Returns a column
+   */
+  PDBColumn<T> &operator[](size_t which) {
+    return *columns[which];
+  }
+
+  /**
+   * Finds a column by its name
+   * @param name - the name of the column
+   * @return the column or null if there is no such column
+   */
+  PDBColumnPtr<T> find(const std::string &name) const {
+    for (auto &column : columns) {
+      if (column->name == name) {
+        return column;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * Writes the records column by column to a page
+   * @param rows - the records
+   * @param rowBytes - the average size of a record, it is stored on the page to size the memory when it is read back
+   * @param page - the page, it is cleared first
+   */
+  void encode(Vector<Handle<T>> &rows, uint64_t rowBytes, std::vector<char> &page) {
+
+    PDBColumnarPage::startPage(rows.size(), rowBytes, page);
+    for (auto &column : columns) {
+      column->encode(rows, page);
+    }
+  }
+
+  /**
+   * Makes the records of a page in the current allocation block, this throws NotEnoughSpace if they don't fit
+   * @param page - the page
+   * @param only - if not null only these columns are filled in, the other members keep their default values
+   * @return the records or null if the page is corrupted
+   */
+  Handle<Vector<Handle<T>>> decode(const PDBColumnarPage &page, const std::set<std::string> *only = nullptr) {
+
+    // make the records
+    auto numRows = (uint32_t) page.getNumRows();
+    Handle<Vector<Handle<T>>> rows = makeObject<Vector<Handle<T>>>(numRows);
+    for (uint32_t i = 0; i < numRows; ++i) {
+      rows->push_back(makeObject<T>());
+    }
+
+    // fill in the columns that are on the page
+    PDBColumnValues values;
+    for (auto &column : columns) {
+
+      auto index = page.getColumnIndex(column->name);
+      if (index < 0 || (only != nullptr && only->count(column->name) == 0)) {
+        continue;
+      }
+
+      values = PDBColumnValues();
+      if (!page.decode((size_t) index, values)) {
+        return nullptr;
+      }
+      column->fill(values, *rows);
+    }
+
+    return rows;
+  }
+
+ private:
+
+  PDBColumns() {
+    T::getColumns(*this);
+  }
+
+  /**
+   * The columns in the order they are on the page
+   */
+  std::vector<PDBColumnPtr<T>> columns;
+
+  /**
+   * The columns each method we know of reads
+   */
+  std::map<std::string, std::set<std::string>> methods;
+};
+
+/**
+ * Writes a page of records to a columnar page, if the type has no columns we fail
+ * @param rows - the records
+ * @param numBytes - the size of the record with the records
+ * @param page - the page
+ * @param errMsg - the error if we fail
+ * @return true if we succeeded, false otherwise
+ */
+template<class T>
+typename std::enable_if_t<hasColumns<T>::value, bool>
+encodeColumnarPage(Handle<Vector<Handle<T>>> &rows, size_t numBytes, std::vector<char> &page, std::string &errMsg) {
+
+  auto rowBytes = rows->size() == 0 ? 0 : numBytes / rows->size();
+  PDBColumns<T>::get().encode(*rows, rowBytes, page);
+  return true;
+}
+
+template<class T>
+typename std::enable_if_t<!hasColumns<T>::value, bool>
+encodeColumnarPage(Handle<Vector<Handle<T>>> &rows, size_t numBytes, std::vector<char> &page, std::string &errMsg) {
+  errMsg = "The type " + getTypeName<T>() + " does not describe its columns, it can not be stored in a columnar set.";
+  return false;
+}
+
+/**
+ * Reads the records of a columnar page back into the current allocation block, this throws NotEnoughSpace if they
+ * don't fit
+ * @param page - the page
+ * @param errMsg - the error if we fail
+ * @param only - if not null only these columns are read @see PDBColumns::decode
+ * @return the records or null if we fail
+ */
+template<class T>
+typename std::enable_if_t<hasColumns<T>::value, Handle<Vector<Handle<T>>>>
+decodeColumnarPage(const PDBColumnarPage &page, std::string &errMsg, const std::set<std::string> *only = nullptr) {
+
+  auto rows = page.isValid() ? PDBColumns<T>::get().decode(page, only) : nullptr;
+  if (rows == nullptr) {
+    errMsg = "The columnar page is corrupted.";
+  }
+  return rows;
+}
+
+template<class T>
+typename std::enable_if_t<!hasColumns<T>::value, Handle<Vector<Handle<T>>>>
+decodeColumnarPage(const PDBColumnarPage &page, std::string &errMsg, const std::set<std::string> *only = nullptr) {
+  errMsg = "The type " + getTypeName<T>() + " does not describe its columns, it can not be read from a columnar set.";
+  return nullptr;
+}
+
+}
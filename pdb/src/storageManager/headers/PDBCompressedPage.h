@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <PDBCodec.h>
+
+namespace pdb {
+
+/**
+ * The layout of a set page that is stored compressed. The page starts with a header followed by a frame with the
+ * compressed record @see PDBCodec, the page is frozen to the size of the header and the frame, so that is all that goes
+ * to disk. The frame is exactly what we send over the wire, so a compressed page is served as it is.
+ *
+ * A page that is not compressed starts with a record and the first thing in a record is its size, the magic number can
+ * not be the size of a record that fits on a page, therefore a page always tells us if it is compressed.
+ */
+class PDBCompressedPage {
+ public:
+
+  /**
+   * The header of a compressed page, the frame follows it
+   */
+  struct Header {
+
+    // always the magic number
+    uint64_t magic;
+  };
+
+  /**
+   * The magic number at the start of every compressed page
+   */
+  static const uint64_t magicNumber = 0xC0DEC0DEC0DEC0DEull;
+
+  /**
+   * Checks if a page is compressed
+   * @param page - the bytes of the page
+   * @return true if it is, false otherwise
+   */
+  static bool isCompressed(const void *page);
+
+  /**
+   * Compresses a record onto a page. If the record does not get smaller we don't compress it, but the page might be
+   * overwritten, so the caller has to copy the record onto it.
+   * @param codec - the codec we use, if it is null or the no-op codec we don't compress
+   * @param record - the record
+   * @param numBytes - the size of the record
+   * @param page - the page we write to
+   * @param pageSize - the size of the page
+   * @return the number of bytes we wrote to the page, 0 if we did not compress it
+   */
+  static size_t compress(const PDBCodecPtr &codec, const void *record, size_t numBytes, void *page, size_t pageSize);
+
+  /**
+   * Puts a record that is already compressed into a frame onto a page, if the record would not get smaller the page is
+   * not written. This is what we do with the records the clients send, since they come compressed.
+   * @param frame - the frame with the compressed record
+   * @param frameSize - the size of the frame
+   * @param page - the page we write to
+   * @param pageSize - the size of the page
+   * @return the number of bytes we wrote to the page, 0 if we did not store it
+   */
+  static size_t storeFrame(const char *frame, size_t frameSize, void *page, size_t pageSize);
+
+  /**
+   * Decompresses the record of a compressed page
+   * @param page - the compressed page
+   * @param record - where we put the record
+   * @param recordSize - the space there is for the record, it needs at least @see getUncompressedSize bytes
+   * @return true if we succeeded, false if the page is corrupted
+   */
+  static bool decompress(const void *page, void *record, size_t recordSize);
+
+  /**
+   * Returns the size of the record of a compressed page once it is decompressed
+   */
+  static size_t getUncompressedSize(const void *page);
+
+  /**
+   * Returns the frame of a compressed page
+   */
+  static const char *getFrame(const void *page);
+
+  /**
+   * Returns the size of the frame of a compressed page
+   */
+  static size_t getFrameSize(const void *page);
+};
+
+}
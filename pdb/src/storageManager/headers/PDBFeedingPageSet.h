@@ -100,11 +100,24 @@ class PDBFeedingPageSet : public PDBAbstractPageSet {
    */
   size_t getNumPages() override;
 
+  /**
+   * Return how many bytes the pages in this page set take
+   * @return - the number of bytes
+   */
+  size_t getSize() override;
+
   /**
    * Resets the page set so it can be reused
    */
   void resetPageSet() override;
 
+  /**
+   * The pages are fed into this page set while they are in memory, plus getting the next page for a worker releases
+   * the page it got before, so a reader must never look ahead.
+   * @return always zero
+   */
+  size_t getLookaheadDepth() override;
+
  private:
 
   /**
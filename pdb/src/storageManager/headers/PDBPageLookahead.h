@@ -0,0 +1,95 @@
+//
+// Created by dimitrije on 10/19/19.
+//
+
+#ifndef PDB_PDBPAGELOOKAHEAD_H
+#define PDB_PDBPAGELOOKAHEAD_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <PDBAbstractPageSet.h>
+
+namespace pdb {
+
+class PDBPageLookahead;
+using PDBPageLookaheadPtr = std::shared_ptr<PDBPageLookahead>;
+
+/**
+ * Grabs pages for a particular worker from a page set and keeps the next N of them pinned ahead of the reader.
+ * The pages are requested from the page set and repined on a worker from @see PDBAbstractPageSet::getLookaheadWorkers,
+ * so that the I/O the buffer manager needs to do in order to pin them overlaps with the processing of the current page.
+ * It has to be a worker since the buffer manager of the backend allocates its requests, and a plain thread would share
+ * the main allocator. The number of pages we keep ahead is given by @see PDBAbstractPageSet::getLookaheadDepth.
+ * If it is zero, the page set has no workers or they are all busy the pages are fetched on the calling thread.
+ */
+class PDBPageLookahead {
+ public:
+
+  /**
+   * Initializes the lookahead and starts prefetching the first pages of the page set
+   * @param pageSet - the page set we are grabbing the pages from
+   * @param workerID - the id of the worker we are grabbing the pages for @see PDBAbstractPageSet::getNextPage
+   */
+  PDBPageLookahead(PDBAbstractPageSetPtr pageSet, uint64_t workerID);
+
+  /**
+   * Stops the prefetching and unpins all the pages that were prefetched but never handed out
+   */
+  ~PDBPageLookahead();
+
+  /**
+   * Returns the next page of the page set for this worker. The returned page is always pinned.
+   * If the page has not yet been prefetched this method blocks until it is. If prefetching it failed the error is
+   * rethrown here.
+   * @return the page handle if there is one, null otherwise
+   */
+  PDBPageHandle getNextPage();
+
+ private:
+
+  /**
+   * The loop the prefetching worker is running
+   */
+  void prefetch();
+
+  /**
+   * Grabs the next page from the page set and pins it
+   * @return the pinned page or null if there are no more pages
+   */
+  PDBPageHandle fetchPage();
+
+  // the page set we are grabbing the pages from
+  PDBAbstractPageSetPtr pageSet;
+
+  // the id of the worker
+  uint64_t workerID;
+
+  // how many pages we keep pinned ahead of the reader
+  size_t depth;
+
+  // the pages that were prefetched and not yet handed out
+  std::deque<PDBPageHandle> pages;
+
+  // true if the page set ran out of pages
+  bool noMorePages = false;
+
+  // true if we want the prefetching worker to stop
+  bool stop = false;
+
+  // true while the prefetching worker is running
+  bool prefetching = false;
+
+  // the error the prefetching worker failed with if it did
+  std::exception_ptr error;
+
+  // the mutex to sync the reader and the prefetching worker
+  std::mutex m;
+
+  // the condition variable to signal that we have a page, that there is space for a page or that the worker is done
+  std::condition_variable cv;
+};
+
+}
+
+#endif //PDB_PDBPAGELOOKAHEAD_H
@@ -27,11 +27,19 @@ public:
    * @param set - the set name
    * @param pages - the page numbers that are valid for the set
    * @param bufferManager - the buffer manager
+   * @param lookaheadDepth - how many pages a reader should keep pinned ahead @see getLookaheadDepth
+   * @param mapPages - do we grab the pages from the mapped file of the set @see PDBBufferManagerInterface::getMappedPage
    */
-  PDBSetPageSet(const std::string &db, const std::string &set, vector<uint64_t> &pages, PDBBufferManagerInterfacePtr bufferManager);
+  PDBSetPageSet(const std::string &db,
+                const std::string &set,
+                vector<uint64_t> &pages,
+                PDBBufferManagerInterfacePtr bufferManager,
+                size_t lookaheadDepth = 0,
+                bool mapPages = false);
 
   /**
-   * Grabs the next page for this set.
+   * Grabs the next page for this set. If the page is stored compressed it is decompressed into an anonymous page.
+   * If we map the pages the page we return might point into the file of the set, so it must not be modified.
    * @param workerID - the worker id does nothing in this case
    * @return the page handle if there is one, null otherwise
    */
@@ -54,6 +62,19 @@ public:
    */
   void resetPageSet() override;
 
+  /**
+   * The pages of a set most likely need to be loaded from disk by the frontend, therefore we look ahead as much as
+   * we were configured to, but not more than the number of pages in the set.
+   * @return the lookahead depth
+   */
+  size_t getLookaheadDepth() override;
+
+  /**
+   * Returns the numbers of the pages of the set that are in this page set
+   * @return the page numbers
+   */
+  const vector<uint64_t> &getPageNumbers();
+
  private:
 
   // current page, it is thread safe to update it
@@ -67,6 +88,12 @@ public:
 
   // the buffer manager to get the pages
   PDBBufferManagerInterfacePtr bufferManager;
+
+  // how many pages a reader should keep pinned ahead
+  size_t lookaheadDepth;
+
+  // do we grab the pages from the mapped file of the set
+  bool mapPages;
 };
 
 }
@@ -9,9 +9,32 @@
 #include "StoRemovePageSetRequest.h"
 #include "StoStartFeedingPageSetRequest.h"
 #include "PDBFeedingPageSet.h"
+#include "PDBStreamingPageSet.h"
+#include "PDBCatalogSet.h"
+#include "PDBCodec.h"
+#include <set>
+#include <map>
 
 namespace pdb {
 
+/**
+ * The pages of its input an incremental aggregation has already aggregated into its output set on a node
+ */
+struct PDBAggregatedPages {
+
+  // the generation of the output @see ExJob::incrementalGeneration, 0 if the aggregation never ran on the node
+  uint64_t generation = 0;
+
+  // the set the aggregation scans
+  std::pair<std::string, std::string> inputSet;
+
+  // the pages of that set that are in the output
+  std::set<uint64_t> pages;
+
+  // the page of the output set each worker wrote the keys of its partition to, by the id of the worker
+  std::map<uint64_t, uint64_t> outputPages;
+};
+
 class PDBStorageManagerBackend : public ServerFunctionality {
 
 public:
@@ -28,6 +51,35 @@ public:
    */
   PDBSetPageSetPtr createPageSetFromPDBSet(const std::string &db, const std::string &set);
 
+  /**
+   * Same as @see createPageSetFromPDBSet but the page set does not have the pages we skip. An incremental aggregation
+   * uses this to get the pages that were added to its input since it last ran.
+   * @param db - the database the set belongs to
+   * @param set - the set name
+   * @param skipPages - the pages we skip
+   * @return the PDBPage set
+   */
+  PDBSetPageSetPtr createPageSetFromPDBSet(const std::string &db, const std::string &set, const std::set<uint64_t> &skipPages);
+
+  /**
+   * Makes a page set with just the given pages of a PDB set, without asking the frontend what pages the set has.
+   * A worker of an incremental aggregation uses this to read just the page of the output with its keys.
+   * @param db - the database the set belongs to
+   * @param set - the set name
+   * @param pages - the pages
+   * @return the PDBPage set
+   */
+  PDBSetPageSetPtr createPageSetFromPDBSetPages(const std::string &db, const std::string &set, std::vector<uint64_t> pages);
+
+  /**
+   * Gathers all the pages of a PDB set from the workers that store them, this node included, into an anonymous page set
+   * on this node. Used when a computation is small enough to run on a single node.
+   * @param db - the database the set belongs to
+   * @param set - the set name
+   * @return the page set with a copy of every page of the set, null if we failed to fetch them
+   */
+  PDBAnonymousPageSetPtr createPageSetFromGatheredPDBSet(const std::string &db, const std::string &set);
+
   /**
    *
    * @param pageSetID
@@ -42,6 +94,14 @@ public:
    */
   PDBFeedingPageSetPtr createFeedingAnonymousPageSet(const std::pair<uint64_t, std::string> &pageSetID, uint64_t numReaders, uint64_t numFeeders);
 
+  /**
+   * Returns the stream of the pages of a page set while the job that produces it runs. The producer and the consumer
+   * are started at the same time so whichever of them asks first makes it.
+   * @param pageSetID - the id of the page set the producer makes. The usual is (computationID, tupleSetID)
+   * @return the stream
+   */
+  PDBStreamingPageSetPtr getStreamingPageSet(const std::pair<uint64_t, std::string> &pageSetID);
+
   /**
    * Returns a pages set that already exists
    * @param pageSetID - the id of the page set. The usual is (computationID, tupleSetID)
@@ -50,7 +110,7 @@ public:
   PDBAbstractPageSetPtr getPageSet(const std::pair<uint64_t, std::string> &pageSetID);
 
   /**
-   * Removes the page set from the storage.
+   * Removes the page set and its stream if it has one from the storage.
    * @param pageSetID
    * @return
    */
@@ -61,9 +121,38 @@ public:
    * it assumes that the set we are materializing to exists.
    * @param pageSet - the page set we want to materialize
    * @param set - the set we want to materialize to
+   * @param setPages - if not null we put here the page of the set every page of the page set was written to, by the
+   * number of the page in the page set. It has the pages that were written even if we fail.
+   * @return true if it succeeds false otherwise
+   */
+  bool materializePageSet(const PDBAbstractPageSetPtr& pageSet,
+                          const std::pair<std::string, std::string> &set,
+                          std::map<uint64_t, uint64_t> *setPages = nullptr);
+
+  /**
+   * Removes some of the pages of a set that are on this node by contacting the frontend. An incremental aggregation
+   * uses it to replace its output once the new one is written.
+   * @param set - the set we want to remove the pages from
+   * @param pages - the pages we remove, or the ones we keep
+   * @param keepPages - if true every page of the set on this node but the pages is removed
+   * @param size - the bytes the pages take
    * @return true if it succeeds false otherwise
    */
-  bool materializePageSet(const PDBAbstractPageSetPtr& pageSet, const std::pair<std::string, std::string> &set);
+  bool removeSetPages(const std::pair<std::string, std::string> &set, const std::vector<uint64_t> &pages, bool keepPages, uint64_t size);
+
+  /**
+   * Returns the pages of its input an incremental aggregation has aggregated into its output on this node
+   * @param set - the output set of the aggregation
+   * @return the pages, the generation is 0 if the aggregation never ran here
+   */
+  PDBAggregatedPages getAggregatedPages(const std::pair<std::string, std::string> &set);
+
+  /**
+   * Stores the pages an incremental aggregation has aggregated once it has written its output
+   * @param set - the output set of the aggregation
+   * @param pages - the pages
+   */
+  void setAggregatedPages(const std::pair<std::string, std::string> &set, const PDBAggregatedPages &pages);
 
  private:
 
@@ -72,9 +161,18 @@ public:
    */
   PDBLoggerPtr logger;
 
+  /**
+   * Returns the codec the pages of a set are stored with, the catalog is only asked the first time for each set
+   * @param db - the database of the set
+   * @param set - the name of the set
+   * @return the codec, null if the pages are stored as they are or we could not find the set
+   */
+  PDBCodecPtr getStorageCodec(const std::string &db, const std::string &set);
+
   /**
    * This method simply stores the data that follows the request onto a page.
-   * The data is compressed it is uncompressed to the page
+   * The data is a frame, if the set has a storage codec and the frame was compressed with it, it is stored as it is.
+   * Otherwise it is uncompressed and compressed again with the codec of the set, or just uncompressed to the page
    *
    * @tparam Communicator - the communicator class PDBCommunicator is used to handle the request. This is basically here
    * so we could write unit tests
@@ -111,10 +209,36 @@ public:
    */
   map<std::pair<uint64_t, std::string>, PDBAbstractPageSetPtr> pageSets;
 
+  /**
+   * The streams of the page sets that are consumed while they are produced, by the id of the page set
+   */
+  map<std::pair<uint64_t, std::string>, PDBStreamingPageSetPtr> streamingPageSets;
+
   /**
    * the mutex to lock the page sets
    */
   std::mutex pageSetMutex;
+
+  /**
+   * The pages each incremental aggregation has aggregated, by its output set
+   */
+  std::map<std::pair<std::string, std::string>, PDBAggregatedPages> aggregatedPages;
+
+  /**
+   * the mutex to lock the aggregated pages
+   */
+  std::mutex aggregatedPagesMutex;
+
+  /**
+   * The codec of each set we stored pages of, null if the pages are stored as they are. The codec of a set does not
+   * change and every stored page says how it was compressed, so an entry of a removed set never makes a page unreadable.
+   */
+  std::map<std::pair<std::string, std::string>, PDBCodecPtr> storageCodecs;
+
+  /**
+   * the mutex to lock the storage codecs
+   */
+  std::mutex storageCodecsMutex;
 };
 
 using PDBStorageManagerBackendPtr = std::shared_ptr<PDBStorageManagerBackend>;
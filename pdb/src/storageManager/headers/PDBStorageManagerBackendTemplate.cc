@@ -8,12 +8,13 @@
 #include <PDBBufferManagerBackEnd.h>
 #include <StoFeedPageRequest.h>
 #include <PDBBufferManagerDebugBackEnd.h>
+#include <PDBCompressedPage.h>
 
 template <class Communicator>
 std::pair<bool, std::string> pdb::PDBStorageManagerBackend::handleStoreOnPage(const pdb::Handle<pdb::StoStoreOnPageRequest> &request,
                                                                               std::shared_ptr<Communicator> &sendUsingMe) {
 
-  /// 1. Grab a page and decompress the forwarded page
+  /// 1. Grab a page and store the forwarded page on it
 
   // grab the buffer manager
   auto bufferManager = std::dynamic_pointer_cast<pdb::PDBBufferManagerBackEndImpl>(this->getFunctionalityPtr<PDBBufferManagerInterface>());
@@ -21,18 +22,52 @@ std::pair<bool, std::string> pdb::PDBStorageManagerBackend::handleStoreOnPage(co
   // grab the forwarded page
   auto inPage = bufferManager->expectPage(sendUsingMe);
 
-  // check the uncompressed size
-  size_t uncompressedSize = 0;
-  snappy::GetUncompressedLength((char*) inPage->getBytes(), request->compressedSize, &uncompressedSize);
+  // grab the frame that was forwarded
+  auto frame = (char*) inPage->getBytes();
+  if(!PDBCodec::isFrame(frame, request->compressedSize)) {
+
+    // send the error back
+    string error = "The page forwarded for the set (" + (std::string) request->databaseName + "," + (std::string) request->setName + ") is corrupted";
+    pdb::Handle<pdb::SimpleRequestResult> simpleResponse = pdb::makeObject<pdb::SimpleRequestResult>(false, error);
+    sendUsingMe->sendObject(simpleResponse, error);
+
+    return make_pair(false, error);
+  }
 
   // grab the page
   auto outPage = bufferManager->getPage(make_shared<pdb::PDBSet>(request->databaseName, request->setName), request->page);
 
-  // uncompress and copy to page
-  snappy::RawUncompress((char*) inPage->getBytes(), request->compressedSize, (char*) outPage->getBytes());
+  // if the set is stored with the codec the frame came with we keep the bytes as they came
+  size_t storedSize = 0;
+  auto storageCodec = getStorageCodec(request->databaseName, request->setName);
+  if(storageCodec != nullptr && storageCodec->getType() == PDBCodec::getFrameCodec(frame)) {
+    storedSize = PDBCompressedPage::storeFrame(frame, request->compressedSize, outPage->getBytes(), outPage->getSize());
+  }
+
+  // the set is stored with a different codec, so uncompress it and compress it with that one
+  auto uncompressedSize = PDBCodec::getFrameUncompressedSize(frame);
+  if(storedSize == 0 && storageCodec != nullptr) {
+
+    // uncompress it to a buffer and compress it from there onto the page
+    std::unique_ptr<char[]> record(new char[uncompressedSize]);
+    PDBCodec::decompressFrame(frame, request->compressedSize, record.get(), uncompressedSize);
+    storedSize = PDBCompressedPage::compress(storageCodec, record.get(), uncompressedSize, outPage->getBytes(), outPage->getSize());
+
+    // if it did not get smaller the page might be overwritten so copy the record
+    if(storedSize == 0) {
+      memcpy(outPage->getBytes(), record.get(), uncompressedSize);
+      storedSize = uncompressedSize;
+    }
+  }
+
+  // if we did not store it compressed uncompress it to the page
+  if(storedSize == 0) {
+    PDBCodec::decompressFrame(frame, request->compressedSize, (char*) outPage->getBytes(), outPage->getSize());
+    storedSize = uncompressedSize;
+  }
 
   // freeze the page
-  outPage->freezeSize(uncompressedSize);
+  outPage->freezeSize(storedSize);
 
   /// 2. Send the response that we are done
 
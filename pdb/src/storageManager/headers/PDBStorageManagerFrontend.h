@@ -6,6 +6,7 @@
 #define PDB_STORAGEMANAGERFRONTEND_H
 
 #include <mutex>
+#include <chrono>
 #include <unordered_set>
 
 #include <PDBSet.h>
@@ -16,12 +17,15 @@
 #include <StoGetPageRequest.h>
 #include <StoGetNextPageRequest.h>
 #include <StoDispatchData.h>
+#include <StoIngestLease.h>
 #include <StoGetSetPagesRequest.h>
 #include <StoMaterializePageSetRequest.h>
 #include <StoMaterializePageResult.h>
 #include <StoRemovePageSetRequest.h>
 #include <StoStartFeedingPageSetRequest.h>
 #include <StoClearSetRequest.h>
+#include <StoRemoveSetPagesRequest.h>
+#include <gtest/gtest_prod.h>
 
 namespace pdb {
 
@@ -85,6 +89,31 @@ public:
   template <class Communicator, class Requests>
   std::pair<bool, std::string> handleDispatchedData(pdb::Handle<pdb::StoDispatchData> request, std::shared_ptr<Communicator> sendUsingMe);
 
+  /**
+   * Handles the request of the manager to register or revoke an ingest lease. Data that a client sends us directly
+   * is only stored if it comes with a lease we know about @see checkIngestLease
+   *
+   * @tparam Communicator - the communicator class PDBCommunicator is used to handle the request. This is basically here
+   * so we could write unit tests
+   *
+   * @param request - the lease and whether it was revoked
+   * @param sendUsingMe - the communicator to the manager
+   * @return - the result of the handler (success, error)
+   */
+  template <class Communicator>
+  std::pair<bool, std::string> handleIngestLease(pdb::Handle<pdb::StoIngestLease> &request, std::shared_ptr<Communicator> &sendUsingMe);
+
+  /**
+   * Checks whether the manager gave out the lease for the set and whether it has not expired or was revoked.
+   * This method is thread safe so no locking required!
+   *
+   * @param leaseID - the id of the lease
+   * @param dbName - the database the data goes to
+   * @param setName - the set the data goes to
+   * @return true if the lease is valid, false otherwise
+   */
+  bool checkIngestLease(uint64_t leaseID, const std::string &dbName, const std::string &setName);
+
   /**
    * Handles the the request to get stats about a particular set.
    *
@@ -146,6 +175,18 @@ public:
   template <class Communicator>
   std::pair<bool, std::string> handleClearSetRequest(pdb::Handle<pdb::StoClearSetRequest> &request, std::shared_ptr<Communicator> &sendUsingMe);
 
+  /**
+   * Removes some of the pages of a set on this node, or all of them but some. The removed pages are freed so they are
+   * not read anymore and the next pages written to the set reuse them @see freeSetPage
+   * @tparam Communicator - the communicator class PDBCommunicator is used to handle the request. This is basically here
+   * so we could write unit tests
+   * @param request - the request with the pages
+   * @param sendUsingMe - the communicator to the node that made the request
+   * @return the result of the handler (success, error)
+   */
+  template <class Communicator>
+  std::pair<bool, std::string> handleRemoveSetPagesRequest(pdb::Handle<pdb::StoRemoveSetPagesRequest> &request, std::shared_ptr<Communicator> &sendUsingMe);
+
   /**
    * This method handles the situation where we want to reclaim a page of a set that was allocated for the backend to
    * put the dispatched data to. We want to call this in case some unpredicted error happens
@@ -159,6 +200,23 @@ public:
    */
   bool handleDispatchFailure(const PDBSetPtr &set, uint64_t pageNum, uint64_t size, PDBCommunicatorPtr communicator);
 
+  /**
+   * Adds the size of the data that was sent to us directly by a client to the size of the set in the catalog of the
+   * manager. The update is done in the background by a worker, the sizes of pages that arrive while a worker is
+   * updating the catalog are summed up and sent with the next update.
+   * This method is thread safe so no locking required!
+   *
+   * @param set - the set the data was added to
+   * @param uncompressedSize - the size of the data
+   */
+  void updateCatalogSetSize(const PDBSetPtr &set, uint64_t uncompressedSize);
+
+  /**
+   * Returns the id of this node in the catalog "ip:port", the size updates we send to the catalog are tagged with it
+   * @return the id
+   */
+  std::string getNodeID();
+
   /**
    * Checks whether we are writing to a particular page.
    * This method is not thread-safe and should only be used when locking the page mutex
@@ -282,6 +340,47 @@ public:
    * Lock last pages
    */
   std::mutex pageMutex;
+
+  /**
+   * The sizes and the number of pages we still need to add to the sets in the catalog of the manager @see updateCatalogSetSize
+   */
+  map<PDBSetPtr, std::pair<uint64_t, uint64_t>, PDBSetCompare> pendingCatalogSizes;
+
+  /**
+   * True if there is a worker that is updating the catalog
+   */
+  bool updatingCatalog = false;
+
+  /**
+   * Locks the @see pendingCatalogSizes and @see updatingCatalog
+   */
+  std::mutex catalogSizeMutex;
+
+  /**
+   * An ingest lease the manager registered with us
+   */
+  struct IngestLease {
+
+    // the set the lease is for
+    std::string dbName;
+    std::string setName;
+
+    // when the lease expires
+    std::chrono::steady_clock::time_point expires;
+  };
+
+  /**
+   * The ingest leases we accept data with, by their id
+   */
+  std::map<uint64_t, IngestLease> ingestLeases;
+
+  /**
+   * Locks the @see ingestLeases
+   */
+  std::mutex ingestLeasesMutex;
+
+  // mark the tests for the ingest leases
+  FRIEND_TEST(IngestLeaseTest, WorkerRejectsInvalidLeases);
 };
 
 }
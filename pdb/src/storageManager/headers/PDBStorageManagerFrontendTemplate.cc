@@ -24,6 +24,7 @@
 #include <StoRemovePageSetRequest.h>
 #include <StoMaterializePageResult.h>
 #include <StoFeedPageRequest.h>
+#include <PDBCompressedPage.h>
 
 template <class T>
 std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleGetPageRequest(const pdb::Handle<pdb::StoGetPageRequest> &request,
@@ -59,21 +60,45 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleGetPageReques
     return make_pair(false, error);
   }
 
-  /// 3. Ok we have it, grab the page and compress it.
+  /// 3. Ok we have it, grab the page and compress it if it is not stored compressed
 
   // grab the page
   auto page = this->getFunctionalityPtr<PDBBufferManagerInterface>()->getPage(set, pageNum);
 
-  // grab the vector
-  auto* pageRecord = (pdb::Record<pdb::Vector<pdb::Handle<pdb::Object>>> *) (page->getBytes());
+  // if the page is stored compressed we send the frame as it is
+  PDBPageHandle compressedPage;
+  std::unique_ptr<char[]> compressedBuffer;
+  const char *compressedBytes;
+  size_t compressedSize;
+  if(PDBCompressedPage::isCompressed(page->getBytes())) {
+    compressedBytes = PDBCompressedPage::getFrame(page->getBytes());
+    compressedSize = PDBCompressedPage::getFrameSize(page->getBytes());
+  }
+  else {
 
-  // grab an anonymous page to store the compressed stuff //TODO this kind of sucks since the max compressed size can be larger than the actual size
-  auto maxCompressedSize = std::min<size_t>(snappy::MaxCompressedLength(pageRecord->numBytes()), 128 * 1024 * 1024);
-  auto compressedPage = getFunctionalityPtr<PDBBufferManagerInterface>()->getPage(maxCompressedSize);
+    // grab the vector
+    auto* pageRecord = (pdb::Record<pdb::Vector<pdb::Handle<pdb::Object>>> *) (page->getBytes());
 
-  // compress the record
-  size_t compressedSize;
-  snappy::RawCompress((char*) pageRecord, pageRecord->numBytes(), (char*)compressedPage->getBytes(), &compressedSize);
+    // grab the codec we serve the pages with, it was checked when the node started
+    string error;
+    auto codec = PDBCodec::get(getConfiguration()->pageCodec, error);
+
+    // grab an anonymous page to store the frame if the worst case fits on one, otherwise use a buffer
+    auto maxFrameSize = codec->getMaxFrameSize(pageRecord->numBytes());
+    char *frame;
+    if(maxFrameSize <= getFunctionalityPtr<PDBBufferManagerInterface>()->getMaxPageSize()) {
+      compressedPage = getFunctionalityPtr<PDBBufferManagerInterface>()->getPage(maxFrameSize);
+      frame = (char*) compressedPage->getBytes();
+    }
+    else {
+      compressedBuffer = std::unique_ptr<char[]>(new char[maxFrameSize]);
+      frame = compressedBuffer.get();
+    }
+
+    // compress the record
+    compressedSize = codec->compressFrame((char*) pageRecord, pageRecord->numBytes(), frame, maxFrameSize);
+    compressedBytes = frame;
+  }
 
   /// 4. Send the compressed page
 
@@ -88,7 +113,7 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleGetPageReques
   sendUsingMe->sendObject(response, error);
 
   // now, send the bytes
-  if (!sendUsingMe->sendBytes(compressedPage->getBytes(), compressedSize, error)) {
+  if (!sendUsingMe->sendBytes((void*) compressedBytes, compressedSize, error)) {
 
     this->logger->error(error);
     this->logger->error("sending page bytes: not able to send data to client.\n");
@@ -109,6 +134,24 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleDispatchedDat
   // the error
   std::string error;
 
+  // the data a client sends us directly is only accepted with a valid ingest lease
+  if(request->updateCatalog && !checkIngestLease(request->leaseID, request->databaseName, request->setName)) {
+
+    // skip the data
+    error = "The ingest lease for the set (" + (std::string) request->databaseName + "," + (std::string) request->setName + ") is not valid.";
+    std::string skipError;
+    sendUsingMe->skipBytes(skipError);
+
+    // create an allocation block to hold the response
+    const UseTemporaryAllocationBlock tempBlock{1024};
+    Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(false, error);
+
+    // sends result to requester
+    sendUsingMe->sendObject(response, skipError);
+
+    return std::make_pair(false, error);
+  }
+
   // grab the buffer manager
   auto bufferManager = std::dynamic_pointer_cast<pdb::PDBBufferManagerFrontEnd>(getFunctionalityPtr<pdb::PDBBufferManagerInterface>());
 
@@ -134,10 +177,20 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleDispatchedDat
     return std::make_pair(false, error);
   }
 
-  // figure out the size so we can increment it
-  // check the uncompressed size
-  size_t uncompressedSize = 0;
-  snappy::GetUncompressedLength((char*) page->getBytes(), numBytes, &uncompressedSize);
+  // the payload is a frame, check it and figure out the size so we can increment it
+  if(!PDBCodec::isFrame((char*) page->getBytes(), numBytes)) {
+
+    // create an allocation block to hold the response
+    error = "The dispatched page is corrupted";
+    const UseTemporaryAllocationBlock tempBlock{1024};
+    Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(false, error);
+
+    // sends result to requester
+    sendUsingMe->sendObject(response, error);
+
+    return std::make_pair(false, error);
+  }
+  size_t uncompressedSize = PDBCodec::getFrameUncompressedSize((char*) page->getBytes());
 
   /// 2. Figure out the page we want to put this thing onto
 
@@ -234,6 +287,11 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleDispatchedDat
   // finish writing to the set
   endWritingToPage(std::make_shared<PDBSet>(request->databaseName, request->setName), pageNum);
 
+  // if the data did not go through the manager we need to let the catalog know about it
+  if(success && request->updateCatalog) {
+    updateCatalogSetSize(std::make_shared<PDBSet>(request->databaseName, request->setName), uncompressedSize);
+  }
+
   /// 6. Send the response that we are done
 
   // create an allocation block to hold the response
@@ -361,8 +419,9 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleMaterializeSe
   // make the set
   auto set = std::make_shared<PDBSet>(request->databaseName, request->setName);
 
-  // this is going to count the total size of the pages
+  // this is going to count the total size and the number of the pages
   uint64_t totalSize = 0;
+  uint64_t numPages = 0;
 
   // start forwarding the pages
   bool hasNext = true;
@@ -405,15 +464,16 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleMaterializeSe
       if(totalSize != 0) {
 
         // broadcast the set size change so far
-        this->getFunctionalityPtr<PDBCatalogClient>()->incrementSetSize(set->getDBName(), set->getSetName(), totalSize, error);
+        this->getFunctionalityPtr<PDBCatalogClient>()->incrementSetSize(set->getDBName(), set->getSetName(), getNodeID(), totalSize, numPages, error);
       }
 
       // finish here since this is not recoverable on the backend
       return std::make_pair(success, "Error occurred while forwarding the page to the backend.\n" + error);
     }
 
-    // the size we want to freeze this thing to
+    // the size we want to freeze this thing to and the size of the page if it is stored compressed
     size_t freezeSize = 0;
+    size_t setSize = 0;
 
     // wait for the storage finish result
     success = RequestFactory::waitHeapRequest<StoMaterializePageResult, bool>(logger, sendUsingMe, false,
@@ -422,8 +482,9 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleMaterializeSe
         // check the result
         if (result != nullptr && result->success) {
 
-          // set the freeze size
+          // set the freeze size and the size the page adds to the set
           freezeSize = result->materializeSize;
+          setSize = result->setSize;
 
           // set the has next
           hasNext = result->hasNext;
@@ -458,7 +519,7 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleMaterializeSe
       if(totalSize != 0) {
 
         // broadcast the set size change so far
-        this->getFunctionalityPtr<PDBCatalogClient>()->incrementSetSize(set->getDBName(), set->getSetName(), totalSize, error);
+        this->getFunctionalityPtr<PDBCatalogClient>()->incrementSetSize(set->getDBName(), set->getSetName(), getNodeID(), totalSize, numPages, error);
       }
 
       // finish
@@ -477,17 +538,18 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleMaterializeSe
       endWritingToPage(set, pageNum);
 
       // decrement the size of the set
-      incrementSetSize(set, freezeSize);
+      incrementSetSize(set, setSize);
     }
 
     // increment the set size
-    totalSize += freezeSize;
+    totalSize += setSize;
+    numPages++;
   }
 
   /// 4. Update the set size
 
   // broadcast the set size change so far
-  success = this->getFunctionalityPtr<PDBCatalogClient>()->incrementSetSize(set->getDBName(), set->getSetName(), totalSize, error);
+  success = this->getFunctionalityPtr<PDBCatalogClient>()->incrementSetSize(set->getDBName(), set->getSetName(), getNodeID(), totalSize, numPages, error);
 
   /// 5. Finish this
 
@@ -495,6 +557,34 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleMaterializeSe
   return std::make_pair(success, error);
 }
 
+template <class Communicator>
+std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleIngestLease(pdb::Handle<pdb::StoIngestLease> &request, std::shared_ptr<Communicator> &sendUsingMe) {
+
+  {
+    // lock the leases
+    unique_lock<std::mutex> lck(ingestLeasesMutex);
+
+    // forget the lease if it was revoked, otherwise remember it
+    if(request->revoke) {
+      ingestLeases.erase(request->leaseID);
+    }
+    else {
+      ingestLeases[request->leaseID] = IngestLease { request->databaseName,
+                                                     request->setName,
+                                                     std::chrono::steady_clock::now() + std::chrono::seconds(request->timeout) };
+    }
+  }
+
+  // create an allocation block to hold the response
+  std::string error;
+  const UseTemporaryAllocationBlock tempBlock{1024};
+  Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(true, error);
+
+  // sends result to requester
+  bool success = sendUsingMe->sendObject(response, error);
+  return std::make_pair(success, error);
+}
+
 template <class Communicator>
 std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleRemovePageSet(pdb::Handle<pdb::StoRemovePageSetRequest> &request, std::shared_ptr<Communicator> &sendUsingMe) {
 
@@ -609,6 +699,67 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleClearSetReque
   return std::make_pair(true, error);
 }
 
+template <class Communicator>
+std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleRemoveSetPagesRequest(pdb::Handle<pdb::StoRemoveSetPagesRequest> &request,
+                                                                                         std::shared_ptr<Communicator> &sendUsingMe) {
+  std::string error;
+  bool success = true;
+
+  {
+    // lock the structures
+    std::unique_lock<std::mutex> lck{pageMutex};
+
+    // make the set
+    auto set = std::make_shared<PDBSet>(request->databaseName, request->setName);
+
+    // the pages in the request
+    std::unordered_set<uint64_t> requested;
+    for(int i = 0; i < request->pages.size(); ++i) {
+      requested.insert(request->pages[i]);
+    }
+
+    // figure out what pages we remove, if the set has no pages here there is nothing to remove
+    std::vector<uint64_t> toRemove;
+    auto it = pageStats.find(set);
+    if(it != pageStats.end()) {
+      for(uint64_t page = 0; page <= it->second.lastPage; ++page) {
+        if((requested.find(page) != requested.end()) != request->keepPages && !isPageFree(set, page)) {
+          toRemove.emplace_back(page);
+        }
+      }
+    }
+
+    // make sure we are not writing to any of them
+    for(auto page : toRemove) {
+      if(isPageBeingWrittenTo(set, page)) {
+        error = "There are currently pages being written to, failed to remove the pages of the set.";
+        success = false;
+        break;
+      }
+    }
+
+    // free them and update the size of the set
+    if(success && it != pageStats.end()) {
+
+      for(auto page : toRemove) {
+        freeSetPage(set, page);
+      }
+
+      it->second.size = request->keepPages ? request->size : it->second.size - std::min(it->second.size, request->size);
+    }
+  }
+
+  // create an allocation block to hold the response
+  const UseTemporaryAllocationBlock tempBlock{1024};
+  Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(success, error);
+
+  // sends result to requester
+  sendUsingMe->sendObject(response, error);
+
+  // return
+  return std::make_pair(success, error);
+}
+
 template <class Communicator>
 std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleStartFeedingPageSetRequest(pdb::Handle<pdb::StoStartFeedingPageSetRequest> &request,
                                                                                               std::shared_ptr<Communicator> &sendUsingMe) {
@@ -708,8 +859,24 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleStartFeedingP
     // get the page of the size we need
     auto page = bufferManager->getPage(hasPage->pageSize);
 
-    // grab the bytes
-    success = sendUsingMe->receiveBytes(page->getBytes(), error);
+    // if the page is compressed we first get the frame and then decompress it to the page
+    if(hasPage->compressedSize != 0) {
+
+      // get a page for the frame and grab the bytes
+      auto framePage = bufferManager->getPage(hasPage->compressedSize);
+      success = sendUsingMe->receiveBytes(framePage->getBytes(), error);
+
+      // decompress the frame
+      if(success && !PDBCodec::decompressFrame((char*) framePage->getBytes(), hasPage->compressedSize, (char*) page->getBytes(), hasPage->pageSize)) {
+        error = "The page of the shuffle is corrupted";
+        success = false;
+      }
+    }
+    else {
+
+      // grab the bytes
+      success = sendUsingMe->receiveBytes(page->getBytes(), error);
+    }
 
     // if we failed finish
     if(!success) {
@@ -0,0 +1,93 @@
+#ifndef PDB_PDBSTREAMINGPAGESET_H
+#define PDB_PDBSTREAMINGPAGESET_H
+
+#include "PDBAbstractPageSet.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace pdb {
+
+class PDBStreamingPageSet;
+using PDBStreamingPageSetPtr = std::shared_ptr<pdb::PDBStreamingPageSet>;
+
+/**
+ * The pages of a page set as the job that produces it finishes them, so the job that consumes it can run at the same
+ * time. The producer feeds every page once it has written it out and says when it is done, the readers get every page
+ * once, in the order they were fed. If there is no page and the producer is not done getNextPage blocks. Both jobs
+ * can get the page set first @see PDBStorageManagerBackend::getStreamingPageSet
+ */
+class PDBStreamingPageSet : public PDBAbstractPageSet {
+
+ public:
+
+  PDBStreamingPageSet() = default;
+
+  /**
+   * Returns the next page the producer fed. This is a blocking method, it waits until there is a page or the producer
+   * is done.
+   * @param workerID - the id of the worker, every page goes to just one worker
+   * @return the page or null if the producer is done and we handed out every page
+   */
+  PDBPageHandle getNextPage(size_t workerID) override;
+
+  /**
+   * The pages come from the producer @see feedPage, so this throws a runtime error
+   * @return - throws exception
+   */
+  PDBPageHandle getNewPage() override;
+
+  /**
+   * Adds a page the producer is done with
+   * @param page - the page
+   */
+  void feedPage(const PDBPageHandle &page);
+
+  /**
+   * Called once the producer is done, whether it succeeded or not, so the readers do not wait forever. Calling it more
+   * than once does nothing.
+   */
+  void finishFeeding();
+
+  /**
+   * Returns the number of pages fed so far
+   * @return - the number of pages
+   */
+  size_t getNumPages() override;
+
+  /**
+   * Every page is handed out just once, so there is nothing to reset
+   */
+  void resetPageSet() override;
+
+ private:
+
+  /**
+   * The pages that were fed and not handed out yet
+   */
+  std::deque<PDBPageHandle> pages;
+
+  /**
+   * The number of pages that were fed
+   */
+  size_t numPages = 0;
+
+  /**
+   * Is the producer done
+   */
+  bool finished = false;
+
+  /**
+   * Protects the pages
+   */
+  std::mutex m;
+
+  /**
+   * The readers wait on this for pages
+   */
+  std::condition_variable cv;
+};
+
+}
+
+#endif //PDB_PDBSTREAMINGPAGESET_H
@@ -78,6 +78,20 @@ size_t pdb::PDBAnonymousPageSet::getNumPages() {
   return pages.size();
 }
 
+size_t pdb::PDBAnonymousPageSet::getSize() {
+
+  // lock the pages struct
+  std::unique_lock<std::mutex> lck(m);
+
+  // sum up the sizes of the pages
+  size_t size = 0;
+  for(auto &page : pages) {
+    size += page.second->getSize();
+  }
+
+  return size;
+}
+
 void pdb::PDBAnonymousPageSet::resetPageSet() {
 
   // lock the pages struct
@@ -102,3 +116,7 @@ void pdb::PDBAnonymousPageSet::setAccessOrder(PDBAnonymousPageSetAccessPattern p
 size_t pdb::PDBAnonymousPageSet::getMaxPageSize() {
   return bufferManager->getMaxPageSize();
 }
+
+size_t pdb::PDBAnonymousPageSet::getLookaheadDepth() {
+  return 1;
+}
@@ -0,0 +1,602 @@
+#include <PDBColumnarPage.h>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <limits>
+
+namespace {
+
+// dictionaries with more entries than this are never smaller than the other encodings, so we don't try them
+const size_t maxDictionarySize = 1u << 16u;
+
+// rounds up to the next multiple of 8
+size_t align8(size_t size) {
+  return (size + 7u) & ~((size_t) 7u);
+}
+
+// appends a value to the buffer
+template<class V>
+void append(std::vector<char> &out, const V &value) {
+  auto bytes = (const char*) &value;
+  out.insert(out.end(), bytes, bytes + sizeof(V));
+}
+
+// pads the buffer to the next multiple of 8
+void pad(std::vector<char> &out) {
+  out.resize(align8(out.size()), 0);
+}
+
+// the number of bits the value needs
+uint64_t bitWidth(uint64_t value) {
+  uint64_t width = 0;
+  while (value != 0) {
+    width++;
+    value >>= 1u;
+  }
+  return width;
+}
+
+// the number of bytes the values take once they are packed
+size_t packedSize(size_t numValues, uint64_t width) {
+  return ((numValues * width + 63u) / 64u) * sizeof(uint64_t);
+}
+
+// packs the values, they must fit into the width, the width is written in front of them
+void packBits(const std::vector<uint64_t> &values, uint64_t width, std::vector<char> &out) {
+
+  // write the width
+  append(out, width);
+
+  // pack the values into words
+  std::vector<uint64_t> words(packedSize(values.size(), width) / sizeof(uint64_t), 0);
+  for (size_t i = 0; i < values.size() && width != 0; ++i) {
+
+    auto bit = i * width;
+    auto word = bit / 64u;
+    auto offset = bit % 64u;
+
+    // put the low bits into this word and the rest into the next one if it does not fit
+    words[word] |= values[i] << offset;
+    if (offset + width > 64u) {
+      words[word + 1] |= values[i] >> (64u - offset);
+    }
+  }
+
+  // write them out
+  auto bytes = (const char*) words.data();
+  out.insert(out.end(), bytes, bytes + words.size() * sizeof(uint64_t));
+}
+
+/**
+ * Reads packed values one by one
+ */
+class BitReader {
+ public:
+
+  // reads the width and makes sure the values are there
+  bool init(const char *&data, const char *end, size_t numValues) {
+
+    if (end - data < (ptrdiff_t) sizeof(uint64_t)) {
+      return false;
+    }
+    memcpy(&width, data, sizeof(uint64_t));
+    data += sizeof(uint64_t);
+
+    if (width > 64u || (size_t) (end - data) < packedSize(numValues, width)) {
+      return false;
+    }
+
+    words = (const uint64_t*) data;
+    data += packedSize(numValues, width);
+    mask = width == 64u ? std::numeric_limits<uint64_t>::max() : (((uint64_t) 1u << width) - 1u);
+    return true;
+  }
+
+  // returns the i-th value
+  uint64_t get(size_t i) const {
+
+    if (width == 0) {
+      return 0;
+    }
+
+    auto bit = i * width;
+    auto word = bit / 64u;
+    auto offset = bit % 64u;
+
+    auto value = words[word] >> offset;
+    if (offset + width > 64u) {
+      value |= words[word + 1] << (64u - offset);
+    }
+    return value & mask;
+  }
+
+ private:
+
+  const uint64_t *words = nullptr;
+  uint64_t width = 0;
+  uint64_t mask = 0;
+};
+
+// reads a value if it is there
+template<class V>
+bool read(const char *&data, const char *end, V &value) {
+  if (end - data < (ptrdiff_t) sizeof(V)) {
+    return false;
+  }
+  memcpy(&value, data, sizeof(V));
+  data += sizeof(V);
+  return true;
+}
+
+// makes the dictionary of the values and the index of each value in it, false if there are too many distinct values
+template<class V>
+bool makeDictionary(const std::vector<V> &values, std::vector<V> &dictionary, std::vector<uint64_t> &codes) {
+
+  std::unordered_map<V, uint64_t> indices;
+  codes.reserve(values.size());
+  for (const auto &value : values) {
+
+    auto it = indices.find(value);
+    if (it == indices.end()) {
+
+      // if there are too many distinct values we don't build it
+      if (dictionary.size() == maxDictionarySize) {
+        return false;
+      }
+
+      it = indices.emplace(value, dictionary.size()).first;
+      dictionary.emplace_back(value);
+    }
+    codes.emplace_back(it->second);
+  }
+
+  return true;
+}
+
+}
+
+pdb::PDBColumnarPage::PDBColumnarPage(const void *page) {
+
+  // check if it is columnar at all
+  if (!isColumnar(page)) {
+    return;
+  }
+  header = (const Header*) page;
+
+  // go through the column chunks
+  auto begin = (const char*) page;
+  auto end = begin + header->numBytes;
+  auto cur = begin + sizeof(Header);
+  for (uint64_t i = 0; i < header->numColumns; ++i) {
+
+    // check if the header and the name are there
+    if (end - cur < (ptrdiff_t) sizeof(ColumnHeader)) {
+      return;
+    }
+    auto columnHeader = (const ColumnHeader*) cur;
+    cur += sizeof(ColumnHeader);
+    if ((size_t) (end - cur) < columnHeader->nameSize) {
+      return;
+    }
+    std::string name(cur, columnHeader->nameSize);
+    cur = begin + align8((cur - begin) + columnHeader->nameSize);
+
+    // check if the values are there
+    if (cur > end || (size_t) (end - cur) < columnHeader->dataSize) {
+      return;
+    }
+    columns.push_back(Column{std::move(name), columnHeader, cur});
+    cur = begin + align8((cur - begin) + columnHeader->dataSize);
+  }
+
+  valid = true;
+}
+
+bool pdb::PDBColumnarPage::isColumnar(const void *page) {
+  auto pageHeader = (const Header*) page;
+  return pageHeader->magic == magicNumber && pageHeader->numBytes >= sizeof(Header);
+}
+
+void pdb::PDBColumnarPage::startPage(uint64_t numRows, uint64_t rowBytes, std::vector<char> &page) {
+
+  page.clear();
+  append(page, Header{sizeof(Header), magicNumber, numRows, 0, rowBytes});
+}
+
+pdb::PDBColumnEncoding pdb::PDBColumnarPage::addColumn(const std::string &name,
+                                                       PDBColumnType type,
+                                                       const std::vector<int64_t> &values,
+                                                       std::vector<char> &page) {
+
+  // try every encoding and keep the smallest one, on a tie the simpler encoding wins
+  std::vector<char> best;
+  std::vector<char> data;
+  auto bestEncoding = PDB_PLAIN_ENCODING;
+  encode(values, PDB_PLAIN_ENCODING, best);
+  for (auto encoding : { PDB_BIT_PACKED_ENCODING, PDB_RLE_ENCODING, PDB_DELTA_ENCODING, PDB_DICTIONARY_ENCODING }) {
+    data.clear();
+    if (encode(values, encoding, data) && data.size() < best.size()) {
+      std::swap(best, data);
+      bestEncoding = encoding;
+    }
+  }
+
+  addColumn(name, type, bestEncoding, best, page);
+  return bestEncoding;
+}
+
+pdb::PDBColumnEncoding pdb::PDBColumnarPage::addColumn(const std::string &name,
+                                                       const std::vector<std::string> &values,
+                                                       std::vector<char> &page) {
+
+  // try the dictionary and keep it if it is smaller
+  std::vector<char> plain;
+  std::vector<char> dictionary;
+  encode(values, PDB_PLAIN_ENCODING, plain);
+  if (encode(values, PDB_DICTIONARY_ENCODING, dictionary) && dictionary.size() < plain.size()) {
+    addColumn(name, PDB_STRING_COLUMN, PDB_DICTIONARY_ENCODING, dictionary, page);
+    return PDB_DICTIONARY_ENCODING;
+  }
+
+  addColumn(name, PDB_STRING_COLUMN, PDB_PLAIN_ENCODING, plain, page);
+  return PDB_PLAIN_ENCODING;
+}
+
+void pdb::PDBColumnarPage::addColumn(const std::string &name,
+                                     PDBColumnType type,
+                                     PDBColumnEncoding encoding,
+                                     const std::vector<char> &data,
+                                     std::vector<char> &page) {
+
+  // write the chunk
+  append(page, ColumnHeader{type, encoding, (uint16_t) name.size(), 0, data.size()});
+  page.insert(page.end(), name.begin(), name.end());
+  pad(page);
+  page.insert(page.end(), data.begin(), data.end());
+  pad(page);
+
+  // update the header
+  auto pageHeader = (Header*) page.data();
+  pageHeader->numColumns++;
+  pageHeader->numBytes = page.size();
+}
+
+bool pdb::PDBColumnarPage::encode(const std::vector<int64_t> &values, PDBColumnEncoding encoding, std::vector<char> &out) {
+
+  switch (encoding) {
+
+    case PDB_PLAIN_ENCODING: {
+
+      auto bytes = (const char*) values.data();
+      out.insert(out.end(), bytes, bytes + values.size() * sizeof(int64_t));
+      return true;
+    }
+    case PDB_RLE_ENCODING: {
+
+      // find the runs
+      std::vector<std::pair<int64_t, uint64_t>> runs;
+      for (auto value : values) {
+        if (runs.empty() || runs.back().first != value) {
+          runs.emplace_back(value, 0);
+        }
+        runs.back().second++;
+      }
+
+      // write them
+      append(out, (uint64_t) runs.size());
+      for (auto &run : runs) {
+        append(out, run.first);
+        append(out, run.second);
+      }
+      return true;
+    }
+    case PDB_BIT_PACKED_ENCODING: {
+
+      // the offsets from the smallest value
+      auto min = values.empty() ? 0 : *std::min_element(values.begin(), values.end());
+      std::vector<uint64_t> offsets(values.size());
+      uint64_t max = 0;
+      for (size_t i = 0; i < values.size(); ++i) {
+        offsets[i] = (uint64_t) values[i] - (uint64_t) min;
+        max = std::max(max, offsets[i]);
+      }
+
+      append(out, min);
+      packBits(offsets, bitWidth(max), out);
+      return true;
+    }
+    case PDB_DELTA_ENCODING: {
+
+      // there is nothing to take the difference of
+      if (values.empty()) {
+        return false;
+      }
+
+      // the differences between the consecutive values
+      std::vector<int64_t> deltas(values.size() - 1);
+      for (size_t i = 1; i < values.size(); ++i) {
+        deltas[i - 1] = (int64_t) ((uint64_t) values[i] - (uint64_t) values[i - 1]);
+      }
+
+      // and their offsets from the smallest one
+      auto minDelta = deltas.empty() ? 0 : *std::min_element(deltas.begin(), deltas.end());
+      std::vector<uint64_t> offsets(deltas.size());
+      uint64_t max = 0;
+      for (size_t i = 0; i < deltas.size(); ++i) {
+        offsets[i] = (uint64_t) deltas[i] - (uint64_t) minDelta;
+        max = std::max(max, offsets[i]);
+      }
+
+      append(out, values.front());
+      append(out, minDelta);
+      packBits(offsets, bitWidth(max), out);
+      return true;
+    }
+    case PDB_DICTIONARY_ENCODING: {
+
+      // make the dictionary
+      std::vector<int64_t> dictionary;
+      std::vector<uint64_t> codes;
+      if (!makeDictionary(values, dictionary, codes)) {
+        return false;
+      }
+
+      // write it and the codes
+      append(out, (uint64_t) dictionary.size());
+      auto bytes = (const char*) dictionary.data();
+      out.insert(out.end(), bytes, bytes + dictionary.size() * sizeof(int64_t));
+      packBits(codes, bitWidth(dictionary.empty() ? 0 : dictionary.size() - 1), out);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool pdb::PDBColumnarPage::encode(const std::vector<std::string> &values, PDBColumnEncoding encoding, std::vector<char> &out) {
+
+  // writes the lengths of the strings followed by their bytes
+  auto writeStrings = [&out](const std::vector<std::string> &strings) {
+    for (auto &s : strings) {
+      append(out, (uint32_t) s.size());
+    }
+    for (auto &s : strings) {
+      out.insert(out.end(), s.begin(), s.end());
+    }
+    pad(out);
+  };
+
+  switch (encoding) {
+
+    case PDB_PLAIN_ENCODING: {
+      writeStrings(values);
+      return true;
+    }
+    case PDB_DICTIONARY_ENCODING: {
+
+      // make the dictionary
+      std::vector<std::string> dictionary;
+      std::vector<uint64_t> codes;
+      if (!makeDictionary(values, dictionary, codes)) {
+        return false;
+      }
+
+      // write it and the codes
+      append(out, (uint64_t) dictionary.size());
+      writeStrings(dictionary);
+      packBits(codes, bitWidth(dictionary.empty() ? 0 : dictionary.size() - 1), out);
+      return true;
+    }
+    default: {
+
+      // the other encodings are only for numbers
+      return false;
+    }
+  }
+}
+
+bool pdb::PDBColumnarPage::decode(PDBColumnType type,
+                                  PDBColumnEncoding encoding,
+                                  const char *data,
+                                  size_t dataSize,
+                                  size_t numRows,
+                                  PDBColumnValues &values) {
+
+  auto start = data;
+  auto end = data + dataSize;
+
+  // reads the given number of strings into the dictionary
+  auto readStrings = [&](size_t numStrings) {
+
+    if ((size_t) (end - data) < numStrings * sizeof(uint32_t)) {
+      return false;
+    }
+    auto lengths = data;
+    data += numStrings * sizeof(uint32_t);
+
+    values.dictionary.resize(numStrings);
+    for (size_t i = 0; i < numStrings; ++i) {
+
+      uint32_t length;
+      memcpy(&length, lengths + i * sizeof(uint32_t), sizeof(uint32_t));
+      if ((size_t) (end - data) < length) {
+        return false;
+      }
+      values.dictionary[i].assign(data, length);
+      data += length;
+    }
+
+    // skip the padding
+    data = std::min(end, start + align8(data - start));
+    return true;
+  };
+
+  // strings are either plain or dictionary encoded
+  if (type == PDB_STRING_COLUMN) {
+
+    values.codes.resize(numRows);
+    if (encoding == PDB_PLAIN_ENCODING) {
+
+      // each row has its own string
+      for (uint32_t i = 0; i < numRows; ++i) {
+        values.codes[i] = i;
+      }
+      return readStrings(numRows);
+    }
+
+    // read the dictionary and the codes
+    uint64_t dictionarySize;
+    BitReader codes;
+    if (encoding != PDB_DICTIONARY_ENCODING || !read(data, end, dictionarySize) || dictionarySize > maxDictionarySize ||
+        !readStrings(dictionarySize) || !codes.init(data, end, numRows)) {
+      return false;
+    }
+    for (size_t i = 0; i < numRows; ++i) {
+      values.codes[i] = (uint32_t) codes.get(i);
+      if (values.codes[i] >= dictionarySize) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // decode the numbers
+  values.integers.resize(numRows);
+  switch (encoding) {
+
+    case PDB_PLAIN_ENCODING: {
+
+      if (dataSize < numRows * sizeof(int64_t)) {
+        return false;
+      }
+      memcpy(values.integers.data(), data, numRows * sizeof(int64_t));
+      return true;
+    }
+    case PDB_RLE_ENCODING: {
+
+      uint64_t numRuns;
+      if (!read(data, end, numRuns) || (size_t) (end - data) / (2 * sizeof(uint64_t)) < numRuns) {
+        return false;
+      }
+
+      // expand the runs
+      size_t row = 0;
+      for (uint64_t i = 0; i < numRuns; ++i) {
+
+        int64_t value;
+        uint64_t length;
+        read(data, end, value);
+        read(data, end, length);
+        if (length > numRows - row) {
+          return false;
+        }
+        std::fill(values.integers.begin() + row, values.integers.begin() + row + length, value);
+        row += length;
+      }
+      return row == numRows;
+    }
+    case PDB_BIT_PACKED_ENCODING: {
+
+      int64_t min;
+      BitReader offsets;
+      if (!read(data, end, min) || !offsets.init(data, end, numRows)) {
+        return false;
+      }
+      for (size_t i = 0; i < numRows; ++i) {
+        values.integers[i] = (int64_t) ((uint64_t) min + offsets.get(i));
+      }
+      return true;
+    }
+    case PDB_DELTA_ENCODING: {
+
+      int64_t first;
+      int64_t minDelta;
+      BitReader offsets;
+      if (numRows == 0 || !read(data, end, first) || !read(data, end, minDelta) || !offsets.init(data, end, numRows - 1)) {
+        return false;
+      }
+
+      // add up the differences
+      values.integers[0] = first;
+      for (size_t i = 1; i < numRows; ++i) {
+        values.integers[i] = (int64_t) ((uint64_t) values.integers[i - 1] + (uint64_t) minDelta + offsets.get(i - 1));
+      }
+      return true;
+    }
+    case PDB_DICTIONARY_ENCODING: {
+
+      uint64_t dictionarySize;
+      if (!read(data, end, dictionarySize) || (size_t) (end - data) / sizeof(int64_t) < dictionarySize) {
+        return false;
+      }
+      auto dictionary = data;
+      data += dictionarySize * sizeof(int64_t);
+
+      // look up the value of each row
+      BitReader codes;
+      if (!codes.init(data, end, numRows)) {
+        return false;
+      }
+      for (size_t i = 0; i < numRows; ++i) {
+        auto code = codes.get(i);
+        if (code >= dictionarySize) {
+          return false;
+        }
+        memcpy(&values.integers[i], dictionary + code * sizeof(int64_t), sizeof(int64_t));
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool pdb::PDBColumnarPage::isValid() const {
+  return valid;
+}
+
+uint64_t pdb::PDBColumnarPage::getNumRows() const {
+  return header->numRows;
+}
+
+uint64_t pdb::PDBColumnarPage::getRowBytes() const {
+  return header->rowBytes;
+}
+
+uint64_t pdb::PDBColumnarPage::getNumBytes() const {
+  return header->numBytes;
+}
+
+size_t pdb::PDBColumnarPage::getNumColumns() const {
+  return columns.size();
+}
+
+int32_t pdb::PDBColumnarPage::getColumnIndex(const std::string &name) const {
+
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (columns[i].name == name) {
+      return (int32_t) i;
+    }
+  }
+  return -1;
+}
+
+const std::string &pdb::PDBColumnarPage::getColumnName(size_t column) const {
+  return columns[column].name;
+}
+
+pdb::PDBColumnType pdb::PDBColumnarPage::getColumnType(size_t column) const {
+  return (PDBColumnType) columns[column].header->type;
+}
+
+pdb::PDBColumnEncoding pdb::PDBColumnarPage::getColumnEncoding(size_t column) const {
+  return (PDBColumnEncoding) columns[column].header->encoding;
+}
+
+size_t pdb::PDBColumnarPage::getColumnSize(size_t column) const {
+  return columns[column].header->dataSize;
+}
+
+bool pdb::PDBColumnarPage::decode(size_t column, PDBColumnValues &values) const {
+  return decode(getColumnType(column), getColumnEncoding(column), columns[column].data, getColumnSize(column), header->numRows, values);
+}
@@ -0,0 +1,85 @@
+#include <PDBCompressedPage.h>
+#include <cstring>
+#include <memory>
+
+bool pdb::PDBCompressedPage::isCompressed(const void *page) {
+  return ((const Header*) page)->magic == magicNumber;
+}
+
+size_t pdb::PDBCompressedPage::compress(const PDBCodecPtr &codec,
+                                        const void *record,
+                                        size_t numBytes,
+                                        void *page,
+                                        size_t pageSize) {
+  // there is nothing to compress with
+  if(codec == nullptr || codec->getType() == PDB_NO_CODEC || pageSize <= sizeof(Header)) {
+    return 0;
+  }
+
+  // if the worst case fits on the page we compress directly onto it, otherwise we need a buffer
+  size_t frameSize;
+  auto header = (Header*) page;
+  auto maxFrameSize = codec->getMaxFrameSize(numBytes);
+  std::unique_ptr<char[]> buffer;
+  if(sizeof(Header) + maxFrameSize <= pageSize) {
+    frameSize = codec->compressFrame((const char*) record, numBytes, (char*) (header + 1), maxFrameSize);
+  }
+  else {
+    buffer = std::unique_ptr<char[]>(new char[maxFrameSize]);
+    frameSize = codec->compressFrame((const char*) record, numBytes, buffer.get(), maxFrameSize);
+  }
+
+  // if we failed, it did not get smaller or does not fit we don't compress it
+  if(frameSize == 0 || sizeof(Header) + frameSize >= numBytes || sizeof(Header) + frameSize > pageSize) {
+    return 0;
+  }
+
+  // copy it from the buffer if we used one
+  if(buffer != nullptr) {
+    memcpy(header + 1, buffer.get(), frameSize);
+  }
+
+  // write the header
+  header->magic = magicNumber;
+
+  return sizeof(Header) + frameSize;
+}
+
+size_t pdb::PDBCompressedPage::storeFrame(const char *frame, size_t frameSize, void *page, size_t pageSize) {
+
+  // if it is not a frame, it does not get smaller or does not fit we don't store it compressed
+  if(!PDBCodec::isFrame(frame, frameSize) ||
+     sizeof(Header) + frameSize >= PDBCodec::getFrameUncompressedSize(frame) ||
+     sizeof(Header) + frameSize > pageSize) {
+    return 0;
+  }
+
+  // write the header and copy the frame
+  auto header = (Header*) page;
+  header->magic = magicNumber;
+  memcpy(header + 1, frame, frameSize);
+
+  return sizeof(Header) + frameSize;
+}
+
+bool pdb::PDBCompressedPage::decompress(const void *page, void *record, size_t recordSize) {
+
+  // check if it is compressed
+  if(!isCompressed(page)) {
+    return false;
+  }
+
+  return PDBCodec::decompressFrame(getFrame(page), getFrameSize(page), (char*) record, recordSize);
+}
+
+size_t pdb::PDBCompressedPage::getUncompressedSize(const void *page) {
+  return PDBCodec::getFrameUncompressedSize(getFrame(page));
+}
+
+const char *pdb::PDBCompressedPage::getFrame(const void *page) {
+  return (const char*) (((const Header*) page) + 1);
+}
+
+size_t pdb::PDBCompressedPage::getFrameSize(const void *page) {
+  return PDBCodec::getFrameSize(getFrame(page));
+}
@@ -5,6 +5,7 @@
 #include <PDBFeedingPageSet.h>
 
 #include "PDBFeedingPageSet.h"
+#include "Tracing.h"
 
 pdb::PDBFeedingPageInfo::PDBFeedingPageInfo(pdb::PDBPageHandle page, uint64_t numUsers, uint64_t timesServed)
     : page(std::move(page)), numUsers(numUsers), timesServed(timesServed) {}
@@ -19,6 +20,20 @@ size_t pdb::PDBFeedingPageSet::getNumPages() {
   return pages.size();
 }
 
+size_t pdb::PDBFeedingPageSet::getSize() {
+
+  // lock pages structure
+  unique_lock<std::mutex> lck(m);
+
+  // sum up the sizes of the pages
+  size_t size = 0;
+  for(auto &page : pages) {
+    size += page.second.page->getSize();
+  }
+
+  return size;
+}
+
 pdb::PDBPageHandle pdb::PDBFeedingPageSet::getNextPage(size_t workerID) {
 
   // lock pages structure
@@ -28,7 +43,10 @@ pdb::PDBPageHandle pdb::PDBFeedingPageSet::getNextPage(size_t workerID) {
   auto page = nextPageForWorker[workerID]++;
 
   // wait to have a page
-  cv.wait(lck, [&]{ return numFinishedFeeders == numFeeders || nextPage > page; });
+  {
+    PDB_TRACE_SCOPE_ARG("feeding page set wait", page);
+    cv.wait(lck, [&]{ return numFinishedFeeders == numFeeders || nextPage > page; });
+  }
 
   // if we are done here (all feeders have finished and we served the last page) return null
   if(numFinishedFeeders == numFeeders && nextPage == page) {
@@ -125,4 +143,8 @@ void pdb::PDBFeedingPageSet::setUsagePolicy(pdb::PDBFeedingPageSetUsagePolicy po
 
   // set the policy
   this->usagePolicy = policy;
-}
\ No newline at end of file
+}
+
+size_t pdb::PDBFeedingPageSet::getLookaheadDepth() {
+  return 0;
+}
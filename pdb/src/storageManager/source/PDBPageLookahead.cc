@@ -0,0 +1,140 @@
+//
+// Created by dimitrije on 10/19/19.
+//
+
+#include <PDBPageLookahead.h>
+#include <GenericWork.h>
+
+pdb::PDBPageLookahead::PDBPageLookahead(pdb::PDBAbstractPageSetPtr pageSet, uint64_t workerID) : pageSet(std::move(pageSet)),
+                                                                                                 workerID(workerID) {
+
+  // figure out how far ahead we want to look
+  depth = this->pageSet->getLookaheadDepth();
+  if(depth == 0) {
+    return;
+  }
+
+  // grab a worker to do the prefetching, we don't wait for one since the reader is most likely holding one already
+  auto &workers = this->pageSet->getLookaheadWorkers();
+  PDBWorkerPtr worker = workers == nullptr ? nullptr : workers->tryGetWorker();
+  if(worker == nullptr) {
+    depth = 0;
+    return;
+  }
+
+  // start the prefetching
+  prefetching = true;
+  PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([this](const PDBBuzzerPtr& callerBuzzer) { prefetch(); });
+  worker->execute(myWork, nullptr);
+}
+
+pdb::PDBPageLookahead::~PDBPageLookahead() {
+
+  // tell the prefetching worker to stop and wait for it to finish
+  {
+    std::unique_lock<std::mutex> lck(m);
+    stop = true;
+    cv.notify_all();
+    cv.wait(lck, [&] { return !prefetching; });
+  }
+
+  // unpin all the pages we prefetched but did not hand out
+  for(auto &page : pages) {
+    page->unpin();
+  }
+}
+
+pdb::PDBPageHandle pdb::PDBPageLookahead::getNextPage() {
+
+  // if we are not looking ahead just grab the page here
+  if(depth == 0) {
+    return fetchPage();
+  }
+
+  // wait until we have a page or we are out of pages
+  std::unique_lock<std::mutex> lck(m);
+  cv.wait(lck, [&] { return !pages.empty() || noMorePages; });
+
+  // if we don't have any pages we are done, unless we ran out because the worker failed
+  if(pages.empty()) {
+    if(error != nullptr) {
+      std::rethrow_exception(error);
+    }
+    return nullptr;
+  }
+
+  // grab the page
+  auto page = pages.front();
+  pages.pop_front();
+
+  // there is space for a new page notify the prefetching worker
+  lck.unlock();
+  cv.notify_all();
+
+  // return the page
+  return page;
+}
+
+void pdb::PDBPageLookahead::prefetch() {
+
+  while (true) {
+
+    // wait until there is space for a page or we need to stop
+    {
+      std::unique_lock<std::mutex> lck(m);
+      cv.wait(lck, [&] { return pages.size() < depth || stop; });
+
+      // should we finish?
+      if(stop) {
+        break;
+      }
+    }
+
+    // grab and pin the page, this is the part that is overlapping with the processing
+    PDBPageHandle page;
+    std::exception_ptr failure;
+    try {
+      page = fetchPage();
+    }
+    catch (...) {
+      failure = std::current_exception();
+    }
+
+    // store the page
+    {
+      std::unique_lock<std::mutex> lck(m);
+
+      // if there are no more pages mark that
+      if(page == nullptr) {
+        noMorePages = true;
+        error = failure;
+      } else {
+        pages.emplace_back(page);
+      }
+    }
+    cv.notify_all();
+
+    // we are done if we are out of pages
+    if(page == nullptr) {
+      break;
+    }
+  }
+
+  // let the destructor know we are done, we don't touch the lookahead after this
+  std::unique_lock<std::mutex> lck(m);
+  prefetching = false;
+  cv.notify_all();
+}
+
+pdb::PDBPageHandle pdb::PDBPageLookahead::fetchPage() {
+
+  // grab the next page
+  auto page = pageSet->getNextPage(workerID);
+
+  // repin the page if we got one
+  if(page != nullptr) {
+    page->repin();
+  }
+
+  return page;
+}
@@ -7,11 +7,18 @@
 #include <PDBSetPageSet.h>
 
 #include "PDBSetPageSet.h"
+#include "PDBCompressedPage.h"
 
 pdb::PDBSetPageSet::PDBSetPageSet(const std::string &db,
                                   const std::string &set,
                                   vector<uint64_t> &pages,
-                                  pdb::PDBBufferManagerInterfacePtr bufferManager) : curPage(0), pages(pages), bufferManager(std::move(bufferManager)) {
+                                  pdb::PDBBufferManagerInterfacePtr bufferManager,
+                                  size_t lookaheadDepth,
+                                  bool mapPages) : curPage(0),
+                                                   pages(pages),
+                                                   bufferManager(std::move(bufferManager)),
+                                                   lookaheadDepth(lookaheadDepth),
+                                                   mapPages(mapPages) {
   // make the pdb set
   this->set = make_shared<PDBSet>(db, set);
 }
@@ -26,8 +33,20 @@ pdb::PDBPageHandle pdb::PDBSetPageSet::getNextPage(size_t workerID) {
     return nullptr;
   }
 
-  // return the page
-  return bufferManager->getPage(set, pages[pageNum]);
+  // grab the page, if it is not stored compressed we are done
+  auto page = mapPages ? bufferManager->getMappedPage(set, pages[pageNum]) : bufferManager->getPage(set, pages[pageNum]);
+  if(!PDBCompressedPage::isCompressed(page->getBytes())) {
+    return page;
+  }
+
+  // decompress it into an anonymous page, that way the set page stays compressed and is never written back
+  auto uncompressedSize = PDBCompressedPage::getUncompressedSize(page->getBytes());
+  auto decompressed = bufferManager->getPage(uncompressedSize);
+  if(!PDBCompressedPage::decompress(page->getBytes(), decompressed->getBytes(), uncompressedSize)) {
+    throw runtime_error("The page " + std::to_string(pages[pageNum]) + " of the set (" + set->getDBName() + "," + set->getSetName() + ") is corrupted.");
+  }
+
+  return decompressed;
 }
 
 pdb::PDBPageHandle pdb::PDBSetPageSet::getNewPage() {
@@ -45,3 +64,11 @@ void pdb::PDBSetPageSet::resetPageSet() {
   // reset the page counter
   curPage = 0;
 }
+
+size_t pdb::PDBSetPageSet::getLookaheadDepth() {
+  return std::min<size_t>(lookaheadDepth, pages.size());
+}
+
+const vector<uint64_t> &pdb::PDBSetPageSet::getPageNumbers() {
+  return pages;
+}
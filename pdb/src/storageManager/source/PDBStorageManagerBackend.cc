@@ -12,10 +12,17 @@
 #include <PDBSetPageSet.h>
 #include <PDBStorageManagerBackend.h>
 #include <StoMaterializePageSetRequest.h>
+#include <StoRemoveSetPagesRequest.h>
+#include <SimpleRequestResult.h>
 #include <StoRemovePageSetRequest.h>
 #include <StoMaterializePageResult.h>
 #include <PDBBufferManagerBackEnd.h>
 #include <StoStartFeedingPageSetRequest.h>
+#include <PDBCatalogClient.h>
+#include <PDBCompressedPage.h>
+#include <PDBStoragePageFetcher.h>
+#include <Record.h>
+#include <cstring>
 
 void pdb::PDBStorageManagerBackend::init() {
 
@@ -90,8 +97,81 @@ pdb::PDBSetPageSetPtr pdb::PDBStorageManagerBackend::createPageSetFromPDBSet(con
   /// 3. Crate it and return it
 
 
-  // store the page set
-  return std::make_shared<pdb::PDBSetPageSet>(db, set, pageInfo.second, getFunctionalityPtr<PDBBufferManagerInterface>());
+  // make the page set, the readers look ahead on our workers
+  auto pageSet = std::make_shared<pdb::PDBSetPageSet>(db, set, pageInfo.second, getFunctionalityPtr<PDBBufferManagerInterface>(), getConfiguration()->pageLookahead, getConfiguration()->mapSetPages);
+  pageSet->setLookaheadWorkers(getWorkerQueue());
+
+  return pageSet;
+}
+
+pdb::PDBSetPageSetPtr pdb::PDBStorageManagerBackend::createPageSetFromPDBSet(const std::string &db,
+                                                                         const std::string &set,
+                                                                         const std::set<uint64_t> &skipPages) {
+
+  // get all the pages of the set
+  auto pageSet = createPageSetFromPDBSet(db, set);
+  if(pageSet == nullptr) {
+    return nullptr;
+  }
+
+  // keep just the ones we don't skip
+  std::vector<uint64_t> pages;
+  for(auto page : pageSet->getPageNumbers()) {
+    if(skipPages.find(page) == skipPages.end()) {
+      pages.emplace_back(page);
+    }
+  }
+
+  return createPageSetFromPDBSetPages(db, set, std::move(pages));
+}
+
+pdb::PDBSetPageSetPtr pdb::PDBStorageManagerBackend::createPageSetFromPDBSetPages(const std::string &db,
+                                                                              const std::string &set,
+                                                                              std::vector<uint64_t> pages) {
+
+  // make the page set, the readers look ahead on our workers
+  auto pageSet = std::make_shared<pdb::PDBSetPageSet>(db, set, pages, getFunctionalityPtr<PDBBufferManagerInterface>(), getConfiguration()->pageLookahead, getConfiguration()->mapSetPages);
+  pageSet->setLookaheadWorkers(getWorkerQueue());
+
+  return pageSet;
+}
+
+pdb::PDBAnonymousPageSetPtr pdb::PDBStorageManagerBackend::createPageSetFromGatheredPDBSet(const std::string &db, const std::string &set) {
+
+  // get the configuration
+  auto conf = this->getConfiguration();
+
+  // the page set is not registered, it is gone once the algorithm is done with it
+  auto pageSet = std::make_shared<pdb::PDBAnonymousPageSet>(getFunctionalityPtr<PDBBufferManagerInterface>());
+  pageSet->setLookaheadWorkers(getWorkerQueue());
+
+  // fetch the pages straight from the workers, the manager tells the fetcher where they are
+  PDBStoragePageFetcher fetcher(conf->managerAddress, conf->managerPort, (int) conf->maxRetries, set, db);
+  try {
+
+    std::unique_ptr<char[]> bytes;
+    while((bytes = fetcher.getNextPage()) != nullptr) {
+
+      // the fetched bytes are the record of the page
+      auto *record = (Record<Vector<Handle<Object>>> *) bytes.get();
+      if(record->numBytes() > pageSet->getMaxPageSize()) {
+        logger->error("A page of the set (" + db + "," + set + ") does not fit on a page of this node.");
+        return nullptr;
+      }
+
+      // copy the record to a page of the page set and unpin it, the pipelines pin it again when they get to it
+      auto page = pageSet->getNewPage();
+      memcpy(page->getBytes(), bytes.get(), record->numBytes());
+      page->unpin();
+    }
+  }
+  catch (std::exception &e) {
+
+    logger->error("Failed to gather the pages of the set (" + db + "," + set + ") : " + e.what());
+    return nullptr;
+  }
+
+  return pageSet;
 }
 
 pdb::PDBAnonymousPageSetPtr pdb::PDBStorageManagerBackend::createAnonymousPageSet(const std::pair<uint64_t, std::string> &pageSetID) {
@@ -110,6 +190,7 @@ pdb::PDBAnonymousPageSetPtr pdb::PDBStorageManagerBackend::createAnonymousPageSe
 
   // store the page set
   auto pageSet = std::make_shared<pdb::PDBAnonymousPageSet>(getFunctionalityPtr<PDBBufferManagerInterface>());
+  pageSet->setLookaheadWorkers(getWorkerQueue());
   pageSets[pageSetID] = pageSet;
 
   // return it
@@ -138,8 +219,24 @@ pdb::PDBFeedingPageSetPtr pdb::PDBStorageManagerBackend::createFeedingAnonymousP
   return pageSet;
 }
 
+pdb::PDBStreamingPageSetPtr pdb::PDBStorageManagerBackend::getStreamingPageSet(const std::pair<uint64_t, std::string> &pageSetID) {
+
+  std::unique_lock<std::mutex> lck(pageSetMutex);
+
+  // make it if we are the first one to ask for it
+  auto &pageSet = streamingPageSets[pageSetID];
+  if(pageSet == nullptr) {
+    pageSet = std::make_shared<pdb::PDBStreamingPageSet>();
+  }
+
+  return pageSet;
+}
+
 pdb::PDBAbstractPageSetPtr pdb::PDBStorageManagerBackend::getPageSet(const std::pair<uint64_t, std::string> &pageSetID) {
 
+  // the jobs of a computation run at the same time
+  std::unique_lock<std::mutex> lck(pageSetMutex);
+
   // try to find the page if it exists return it
   auto it = pageSets.find(pageSetID);
   if(it != pageSets.end()) {
@@ -152,11 +249,18 @@ pdb::PDBAbstractPageSetPtr pdb::PDBStorageManagerBackend::getPageSet(const std::
 
 bool pdb::PDBStorageManagerBackend::removePageSet(const std::pair<uint64_t, std::string> &pageSetID) {
 
+  std::unique_lock<std::mutex> lck(pageSetMutex);
+
+  // the stream is not needed once the page set is gone
+  streamingPageSets.erase(pageSetID);
+
   // erase it if it exists
   return pageSets.erase(pageSetID) == 1;
 }
 
-bool pdb::PDBStorageManagerBackend::materializePageSet(const pdb::PDBAbstractPageSetPtr& pageSet, const std::pair<std::string, std::string> &set) {
+bool pdb::PDBStorageManagerBackend::materializePageSet(const pdb::PDBAbstractPageSetPtr& pageSet,
+                                                      const std::pair<std::string, std::string> &set,
+                                                      std::map<uint64_t, uint64_t> *setPages) {
 
   // if the page set is empty no need materialize stuff
   if(pageSet->getNumPages() == 0) {
@@ -255,6 +359,9 @@ bool pdb::PDBStorageManagerBackend::materializePageSet(const pdb::PDBAbstractPag
 
   /// 4. Grab the pages from the frontend
 
+  // figure out if we store the pages compressed
+  auto storageCodec = getStorageCodec(set.first, set.second);
+
   // buffer manager
   pdb::PDBBufferManagerBackEndPtr bufferManager = std::dynamic_pointer_cast<PDBBufferManagerBackEndImpl>(getFunctionalityPtr<pdb::PDBBufferManagerInterface>());
   auto setIdentifier = std::make_shared<PDBSet>(set.first, set.second);
@@ -286,17 +393,32 @@ bool pdb::PDBStorageManagerBackend::materializePageSet(const pdb::PDBAbstractPag
     // get the size of the page
     auto pageSize = page->getSize();
 
-    // copy the memory to the set page
-    memcpy(setPage->getBytes(), page->getBytes(), pageSize);
+    // compress the record of the page onto the set page if the set is stored compressed
+    auto storedSize = PDBCompressedPage::compress(storageCodec,
+                                                  page->getBytes(),
+                                                  ((Record<Object>*) page->getBytes())->numBytes(),
+                                                  setPage->getBytes(),
+                                                  setPage->getSize());
+
+    // if we did not compress it copy the memory to the set page
+    if(storedSize == 0) {
+      memcpy(setPage->getBytes(), page->getBytes(), pageSize);
+      storedSize = pageSize;
+    }
 
     // unpin the page
     page->unpin();
 
+    // remember where the page went
+    if(setPages != nullptr) {
+      (*setPages)[page->whichPage()] = setPage->whichPage();
+    }
+
     // make an allocation block to send the response
     const pdb::UseTemporaryAllocationBlock blk{1024};
 
     // make a request to mark that we succeeded
-    pdb::Handle<StoMaterializePageResult> materializeResult = pdb::makeObject<StoMaterializePageResult>(set.first, set.second, pageSize, true, (i + 1) < numPages);
+    pdb::Handle<StoMaterializePageResult> materializeResult = pdb::makeObject<StoMaterializePageResult>(set.first, set.second, storedSize, pageSize, true, (i + 1) < numPages);
 
     // sends result to requester
     success = comm->sendObject(materializeResult, error);
@@ -315,3 +437,77 @@ bool pdb::PDBStorageManagerBackend::materializePageSet(const pdb::PDBAbstractPag
   // we succeeded
   return true;
 }
+
+pdb::PDBCodecPtr pdb::PDBStorageManagerBackend::getStorageCodec(const std::string &db, const std::string &set) {
+
+  // if we already know the codec of the set use it
+  {
+    std::unique_lock<std::mutex> lck(storageCodecsMutex);
+    auto it = storageCodecs.find(std::make_pair(db, set));
+    if(it != storageCodecs.end()) {
+      return it->second;
+    }
+  }
+
+  // grab the set from the catalog
+  std::string error;
+  auto catalogSet = getFunctionalityPtr<PDBCatalogClient>()->getSet(db, set, error);
+
+  // if we could not find it we store the pages as they are, we don't remember that since the set might show up later
+  if(catalogSet == nullptr) {
+    logger->error("Could not get the storage codec of the set (" + db + "," + set + ") : " + error);
+    return nullptr;
+  }
+
+  // get the codec, the catalog checked the name when the set was created
+  auto codec = PDBCodec::get(catalogSet->storageCodec, error);
+  if(codec != nullptr && codec->getType() == PDB_NO_CODEC) {
+    codec = nullptr;
+  }
+
+  // remember it for the next pages
+  std::unique_lock<std::mutex> lck(storageCodecsMutex);
+  storageCodecs[std::make_pair(db, set)] = codec;
+
+  return codec;
+}
+
+bool pdb::PDBStorageManagerBackend::removeSetPages(const std::pair<std::string, std::string> &set,
+                                                  const std::vector<uint64_t> &pages,
+                                                  bool keepPages,
+                                                  uint64_t size) {
+
+  // get the configuration
+  auto conf = this->getConfiguration();
+
+  // ask the frontend to remove the pages
+  return RequestFactory::heapRequest<StoRemoveSetPagesRequest, SimpleRequestResult, bool>(
+      logger, conf->port, conf->address, false, 1024 + pages.size() * sizeof(uint64_t), [&](Handle<SimpleRequestResult> result) {
+
+        // did we succeed
+        if (result == nullptr || !result->getRes().first) {
+
+          logger->error("Failed to remove the pages of the set (" + set.first + "," + set.second + ") on this node");
+          return false;
+        }
+
+        return true;
+      }, set.first, set.second, pages, keepPages, size);
+}
+
+pdb::PDBAggregatedPages pdb::PDBStorageManagerBackend::getAggregatedPages(const std::pair<std::string, std::string> &set) {
+
+  // lock the aggregated pages
+  std::unique_lock<std::mutex> lck(aggregatedPagesMutex);
+
+  // if the aggregation never ran here it is at generation 0
+  auto it = aggregatedPages.find(set);
+  return it != aggregatedPages.end() ? it->second : PDBAggregatedPages();
+}
+
+void pdb::PDBStorageManagerBackend::setAggregatedPages(const std::pair<std::string, std::string> &set, const PDBAggregatedPages &pages) {
+
+  // lock the aggregated pages
+  std::unique_lock<std::mutex> lck(aggregatedPagesMutex);
+  aggregatedPages[set] = pages;
+}
@@ -19,6 +19,7 @@
 #include <StoGetPageResult.h>
 #include <StoMaterializePageSetRequest.h>
 #include <StoStartFeedingPageSetRequest.h>
+#include <GenericWork.h>
 
 namespace fs = boost::filesystem;
 
@@ -116,6 +117,12 @@ void pdb::PDBStorageManagerFrontend::registerHandlers(PDBServer &forMe) {
             return handleDispatchedData<PDBCommunicator, RequestFactory>(request, sendUsingMe);
           }));
 
+  forMe.registerHandler(
+      StoIngestLease_TYPEID,
+      make_shared<pdb::HeapRequestHandler<pdb::StoIngestLease>>([&](Handle<pdb::StoIngestLease> request, PDBCommunicatorPtr sendUsingMe) {
+        return handleIngestLease(request, sendUsingMe);
+      }));
+
   forMe.registerHandler(
       StoGetSetPagesRequest_TYPEID,
       make_shared<pdb::HeapRequestHandler<pdb::StoGetSetPagesRequest>>([&](pdb::Handle<pdb::StoGetSetPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
@@ -146,6 +153,12 @@ void pdb::PDBStorageManagerFrontend::registerHandlers(PDBServer &forMe) {
         return handleClearSetRequest(request, sendUsingMe);
   }));
 
+  forMe.registerHandler(
+      StoRemoveSetPagesRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<pdb::StoRemoveSetPagesRequest>>([&](Handle<pdb::StoRemoveSetPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+        return handleRemoveSetPagesRequest(request, sendUsingMe);
+  }));
+
 }
 
 bool pdb::PDBStorageManagerFrontend::isPageBeingWrittenTo(const pdb::PDBSetPtr &set, uint64_t pageNum) {
@@ -303,6 +316,92 @@ bool pdb::PDBStorageManagerFrontend::handleDispatchFailure(const PDBSetPtr &set,
   return communicator->sendObject(failResponse, error);
 }
 
+bool pdb::PDBStorageManagerFrontend::checkIngestLease(uint64_t leaseID, const std::string &dbName, const std::string &setName) {
+
+  // lock the leases
+  unique_lock<std::mutex> lck(ingestLeasesMutex);
+
+  // do we know about the lease
+  auto it = ingestLeases.find(leaseID);
+  if(it == ingestLeases.end()) {
+    return false;
+  }
+
+  // if it expired forget it
+  if(it->second.expires <= std::chrono::steady_clock::now()) {
+    ingestLeases.erase(it);
+    return false;
+  }
+
+  // it has to be for this set
+  return it->second.dbName == dbName && it->second.setName == setName;
+}
+
+void pdb::PDBStorageManagerFrontend::updateCatalogSetSize(const PDBSetPtr &set, uint64_t uncompressedSize) {
+
+  {
+    // lock the pending sizes
+    unique_lock<std::mutex> lck(catalogSizeMutex);
+
+    // add the size and the page
+    pendingCatalogSizes[set].first += uncompressedSize;
+    pendingCatalogSizes[set].second++;
+
+    // if somebody is already updating the catalog it will pick up this size
+    if(updatingCatalog) {
+      return;
+    }
+
+    // we are updating it
+    updatingCatalog = true;
+  }
+
+  // the catalog we want to update is the one on the manager
+  auto conf = getConfiguration();
+
+  // make the work that updates the catalog
+  PDBWorkPtr myWork = make_shared<pdb::GenericWork>([this, conf](PDBBuzzerPtr callerBuzzer) {
+
+    // the client to the catalog of the manager
+    auto client = PDBCatalogClient(conf->managerPort, conf->managerAddress, logger);
+
+    while (true) {
+
+      // grab the sizes we need to update
+      map<PDBSetPtr, std::pair<uint64_t, uint64_t>, PDBSetCompare> sizes;
+      {
+        unique_lock<std::mutex> lck(catalogSizeMutex);
+
+        // if there is nothing to update we are done
+        if(pendingCatalogSizes.empty()) {
+          updatingCatalog = false;
+          break;
+        }
+
+        std::swap(sizes, pendingCatalogSizes);
+      }
+
+      // update the catalog
+      for(auto &size : sizes) {
+        std::string error;
+        if(!client.incrementSetSize(size.first->getDBName(), size.first->getSetName(), getNodeID(), size.second.first, size.second.second, error)) {
+          logger->error("Could not update the size of the set (" + size.first->getDBName() + "," + size.first->getSetName() + ") in the catalog : " + error);
+        }
+      }
+    }
+
+    // we are done here
+    callerBuzzer->buzz(PDBAlarm::WorkAllDone);
+  });
+
+  // run the work
+  getWorker()->execute(myWork, myWork->getLinkedBuzzer());
+}
+
+std::string pdb::PDBStorageManagerFrontend::getNodeID() {
+  return getConfiguration()->address + ":" + std::to_string(getConfiguration()->port);
+}
+
 void pdb::PDBStorageManagerFrontend::decrementSetSize(const pdb::PDBSetPtr &set, uint64_t uncompressedSize) {
 
   // try to find the set
@@ -0,0 +1,62 @@
+#include "PDBStreamingPageSet.h"
+#include "Tracing.h"
+#include <stdexcept>
+
+pdb::PDBPageHandle pdb::PDBStreamingPageSet::getNextPage(size_t workerID) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  // wait for a page or for the producer to finish
+  {
+    PDB_TRACE_SCOPE_ARG("streaming page set wait", workerID);
+    cv.wait(lck, [&] { return !pages.empty() || finished; });
+  }
+
+  // if the producer is done and we handed out everything we are done
+  if (pages.empty()) {
+    return nullptr;
+  }
+
+  // hand out the oldest page
+  auto page = pages.front();
+  pages.pop_front();
+  return page;
+}
+
+pdb::PDBPageHandle pdb::PDBStreamingPageSet::getNewPage() {
+  throw std::runtime_error("One can only feed the pages to the streaming page set.");
+}
+
+void pdb::PDBStreamingPageSet::feedPage(const PDBPageHandle &page) {
+
+  std::unique_lock<std::mutex> lck(m);
+
+  if (finished) {
+    throw std::runtime_error("Trying to feed pages, when the producer is done.");
+  }
+
+  // add the page
+  pages.push_back(page);
+  numPages++;
+
+  // unlock and wake up a reader
+  lck.unlock();
+  cv.notify_one();
+}
+
+void pdb::PDBStreamingPageSet::finishFeeding() {
+
+  std::unique_lock<std::mutex> lck(m);
+  finished = true;
+
+  // unlock and wake up all the readers so they can finish
+  lck.unlock();
+  cv.notify_all();
+}
+
+size_t pdb::PDBStreamingPageSet::getNumPages() {
+  std::unique_lock<std::mutex> lck(m);
+  return numPages;
+}
+
+void pdb::PDBStreamingPageSet::resetPageSet() {}
@@ -22,6 +22,7 @@
 #include "PDBCommunicator.h"
 #include "PDBCommWork.h"
 #include "UseTemporaryAllocationBlock.h"
+#include "AllocationBlockPool.h"
 #include "PDBBuzzer.h"
 #include <memory>
 
@@ -61,16 +62,14 @@ public:
             callerBuzzer->buzz(PDBAlarm::GenericError);
             return;
         }
-        void* memory = malloc(myCommunicator->getSizeOfNextObject());
+        PooledBuffer memory(objectSize);
         {
             Handle<RequestType> request =
-                myCommunicator->getNextObject<RequestType>(memory, success, errMsg);
+                myCommunicator->getNextObject<RequestType>(memory.get(), success, errMsg);
 
             if (!success) {
                 myLogger->error("HeapRequestHandler: tried to get the next object and failed; " +
                                 errMsg);
-                /// JiaNote: we need free memory and return here
-                free(memory);
                 callerBuzzer->buzz(PDBAlarm::GenericError);
                 return;
             }
@@ -79,14 +78,11 @@ public:
             if (!res.first) {
                 myLogger->error("HeapRequestHandler: tried to process the request and failed; " +
                                 errMsg);
-                /// JiaNote: we need free memory here
-                free(memory);
                 callerBuzzer->buzz(PDBAlarm::GenericError);
                 return;
             }
 
             myLogger->info("HeapRequestHandler: finished processing requet.");
-            free(memory);
             callerBuzzer->buzz(PDBAlarm::WorkAllDone);
         }
     }
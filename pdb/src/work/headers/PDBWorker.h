@@ -56,7 +56,8 @@ public:
     PDBWorkerPtr getWorker();
 
     // asks this worker to execute runMe... this call is non-blocking.  When the task
-    // is done, myBuzzer->buzz () should be called.
+    // is done, myBuzzer->buzz () should be called. The pages runMe pins are charged to
+    // the same owner as the ones of the calling thread (see PDBPinQuotas)
     void execute(PDBWorkPtr runMe, PDBBuzzerPtr myBuzzer);
 
     // directly sound the buzzer on this guy to wake him if he is sleeping
@@ -87,6 +88,13 @@ private:
 
     // set to true when the worker is able to go and do the work
     bool okToExecute;
+
+    // the owner the pins of the thread that gave us the work are charged to, the work is charged to it too
+    uint64_t pinOwner;
+
+    // the job the thread that gave us the work was running, the events of the work are tagged with it
+    uint64_t traceComputation;
+    uint64_t traceJob;
 };
 }
 
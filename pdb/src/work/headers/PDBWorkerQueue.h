@@ -76,6 +76,11 @@ public:
     // the same thread!!
     PDBWorkerPtr getWorker();
 
+    // just like getWorker, except that it never blocks... if all of the workers are busy
+    // this returns a nullptr right away.  Use this when the work can also be done on the
+    // calling thread, so that a thread that holds a worker never waits for another one
+    PDBWorkerPtr tryGetWorker();
+
     // adds another worker to the queue... give the worker the range where its call stack
     // should exist
     void addAnotherWorker(void* stackStart, void* stackEnd);
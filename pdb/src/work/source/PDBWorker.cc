@@ -22,6 +22,8 @@
 #include "Allocator.h"
 #include "LockGuard.h"
 #include "PDBWorker.h"
+#include "PDBPinQuotas.h"
+#include "PDBTracer.h"
 #include <iostream>
 
 namespace pdb {
@@ -30,6 +32,9 @@ PDBWorker::PDBWorker(PDBWorkerQueue* parentIn) : parent(parentIn) {
     pthread_mutex_init(&workerMutex, nullptr);
     pthread_cond_init(&workToDoSignal, nullptr);
     okToExecute = false;
+    pinOwner = PDB_NO_PIN_OWNER;
+    traceComputation = PDB_NO_TRACE_JOB;
+    traceJob = PDB_NO_TRACE_JOB;
 }
 
 PDBWorkerPtr PDBWorker::getWorker() {
@@ -44,6 +49,9 @@ void PDBWorker::execute(PDBWorkPtr runMeIn, PDBBuzzerPtr buzzWhenDoneIn) {
     const LockGuard guard{workerMutex};
     runMe = runMeIn;
     buzzWhenDone = buzzWhenDoneIn;
+    pinOwner = PDBPinQuotas::getOwner();
+    traceComputation = PDBTracer::getComputation();
+    traceJob = PDBTracer::getJob();
     okToExecute = true;
     pthread_cond_signal(&workToDoSignal);
 }
@@ -65,8 +73,12 @@ void PDBWorker::enter() {
     }
     getAllocator().cleanInactiveBlocks((size_t)(67108844));
     getAllocator().cleanInactiveBlocks((size_t)(12582912));
-    // then do the work
-    runMe->execute(parent, buzzWhenDone);
+    // then do the work, charging the pins to the owner of the thread that gave it to us and tagging the events with its job
+    {
+        const PDBPinOwnerScope pinScope{pinOwner};
+        const PDBTraceJobScope traceScope{traceComputation, traceJob};
+        runMe->execute(parent, buzzWhenDone);
+    }
     okToExecute = false;
 }
 
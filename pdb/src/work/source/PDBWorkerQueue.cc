@@ -25,6 +25,8 @@
 #include "NothingWork.h"
 #include <limits.h>
 #include "PDBWorkerQueue.h"
+#include "PDBMetrics.h"
+#include <chrono>
 
 namespace pdb {
 
@@ -125,6 +127,9 @@ PDBWorkerPtr PDBWorkerQueue::getWorker() {
 
     PDBWorkerPtr myWorker;
 
+    // we keep track of how long we wait for a worker
+    auto waitStart = std::chrono::steady_clock::now();
+
     {
         // make sure there is a worker
         const LockGuard guard{waitingMutex};
@@ -142,6 +147,39 @@ PDBWorkerPtr PDBWorkerQueue::getWorker() {
         waiting.pop_back();
     }
 
+    // the worker is busy until it finishes its work
+    auto &metrics = PDBMetrics::get();
+    metrics.workerWait.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart).count());
+    metrics.workersBusy.inc();
+
+    {
+        // remember that he is working
+        const LockGuard guard{workingMutex};
+        working.insert(myWorker);
+    }
+
+    return myWorker;
+}
+
+PDBWorkerPtr PDBWorkerQueue::tryGetWorker() {
+
+    PDBWorkerPtr myWorker;
+
+    {
+        // if nobody is waiting we don't wait for them
+        const LockGuard guard{waitingMutex};
+        if (waiting.size() == 0) {
+            return nullptr;
+        }
+
+        // get the worker
+        myWorker = waiting.back();
+        waiting.pop_back();
+    }
+
+    // the worker is busy until it finishes its work
+    PDBMetrics::get().workersBusy.inc();
+
     {
         // remember that he is working
         const LockGuard guard{workingMutex};
@@ -180,6 +218,7 @@ void PDBWorkerQueue::addAnotherWorker(void* stackBaseIn, void* stackEndIn) {
         exit(-1);
     } else {
         numOut++;
+        PDBMetrics::get().workers.inc();
     }
 }
 
@@ -221,6 +260,7 @@ void PDBWorkerQueue::enter() {
                 exit(-1);
             }
         }
+        PDBMetrics::get().workersBusy.dec();
 
         // make sure to kill all references to stuff that we want to be able to dellocate
         // or else we will block and that stuff will sit around forever
@@ -234,6 +274,7 @@ void PDBWorkerQueue::enter() {
         // decrement the count of outstanding workers
         const LockGuard guard{waitingMutex};
         numOut--;
+        PDBMetrics::get().workers.dec();
 
         // if there are no outstanding workers, everyone is woken up and gets a null
         if (numOut == 0)
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <atomic>
+#include <PDBJobScheduler.h>
+#include <PDBPinQuotas.h>
+
+namespace pdb {
+
+TEST(AdmissionControlTest, SchedulerSharesThreadsAndMemory) {
+
+  // 8 threads and 1000 bytes shared by two computations
+  PDBJobScheduler scheduler(8, 1000, 2);
+
+  // the first two get half of everything
+  auto first = scheduler.admit(0, 0);
+  auto second = scheduler.admit(0, 0);
+  EXPECT_EQ(first.numThreads, 4);
+  EXPECT_EQ(first.memoryBudget, 500);
+  EXPECT_EQ(scheduler.getNumRunning(), 2);
+
+  // the third one waits until a slot is free
+  std::atomic_bool admitted;
+  admitted = false;
+  PDBJobAdmission third;
+  std::thread waiter([&] {
+    third = scheduler.admit(0, 0);
+    admitted = true;
+  });
+
+  // wait until it is in line
+  while (scheduler.getNumWaiting() == 0) {
+    std::this_thread::yield();
+  }
+  EXPECT_FALSE(admitted);
+
+  // release one and it gets in
+  scheduler.release(first);
+  waiter.join();
+  EXPECT_TRUE(admitted);
+  EXPECT_EQ(scheduler.getNumRunning(), 2);
+
+  scheduler.release(second);
+  scheduler.release(third);
+  EXPECT_EQ(scheduler.getNumRunning(), 0);
+}
+
+TEST(AdmissionControlTest, SchedulerAdmitsByPriority) {
+
+  // one computation at a time
+  PDBJobScheduler scheduler(4, 1000, 1);
+  auto running = scheduler.admit(0, 0);
+
+  // a low and a high priority computation get in line
+  std::vector<int32_t> order;
+  std::mutex m;
+  auto run = [&](int32_t priority) {
+    auto admission = scheduler.admit(priority, 0);
+    {
+      std::unique_lock<std::mutex> lck(m);
+      order.push_back(priority);
+    }
+    scheduler.release(admission);
+  };
+
+  std::thread low(run, 1);
+  while (scheduler.getNumWaiting() != 1) {
+    std::this_thread::yield();
+  }
+  std::thread high(run, 5);
+  while (scheduler.getNumWaiting() != 2) {
+    std::this_thread::yield();
+  }
+
+  // the high priority one goes first even though it came later
+  scheduler.release(running);
+  low.join();
+  high.join();
+  EXPECT_EQ(order, std::vector<int32_t>({ 5, 1 }));
+}
+
+TEST(AdmissionControlTest, SchedulerWaitsForMemory) {
+
+  // the memory budgets decide here, not the slots
+  PDBJobScheduler scheduler(4, 1000, 4);
+  auto large = scheduler.admit(0, 800);
+  EXPECT_EQ(large.memoryBudget, 800);
+
+  // this one does not fit until the large one is done
+  std::atomic_bool admitted;
+  admitted = false;
+  std::thread waiter([&] {
+    auto admission = scheduler.admit(0, 400);
+    admitted = true;
+    scheduler.release(admission);
+  });
+  while (scheduler.getNumWaiting() == 0) {
+    std::this_thread::yield();
+  }
+  EXPECT_FALSE(admitted);
+
+  scheduler.release(large);
+  waiter.join();
+  EXPECT_TRUE(admitted);
+}
+
+TEST(AdmissionControlTest, AdmissionScopeReleasesTheComputation) {
+
+  auto scheduler = std::make_shared<PDBJobScheduler>(4, 1000, 1);
+
+  // a computation that throws gives back its slot
+  try {
+    PDBJobAdmissionScope scope(scheduler, 0, 0);
+    EXPECT_EQ(scheduler->getNumRunning(), 1);
+    throw std::runtime_error("failed");
+  }
+  catch (std::runtime_error &) {}
+  EXPECT_EQ(scheduler->getNumRunning(), 0);
+
+  // releasing it early is only done once
+  {
+    PDBJobAdmissionScope scope(scheduler, 0, 0);
+    EXPECT_EQ(scope.get().numThreads, 4);
+    scope.release();
+    EXPECT_EQ(scheduler->getNumRunning(), 0);
+  }
+  EXPECT_EQ(scheduler->getNumRunning(), 0);
+}
+
+TEST(AdmissionControlTest, PinQuotaBlocksTheOwner) {
+
+  PDBPinQuotas quotas(std::chrono::milliseconds(10000));
+  quotas.registerOwner(1, 100);
+
+  // the owners without a quota are never blocked
+  quotas.acquire(2, 1000);
+  quotas.acquire(PDB_NO_PIN_OWNER, 1000);
+  EXPECT_EQ(quotas.getPinnedBytes(2), 0);
+
+  // the owner can pin up to its quota
+  quotas.acquire(1, 60);
+  EXPECT_EQ(quotas.getPinnedBytes(1), 60);
+
+  // the next pin blocks until the owner unpins something
+  std::atomic_bool pinned;
+  pinned = false;
+  std::thread waiter([&] {
+    quotas.acquire(1, 60);
+    pinned = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(pinned);
+
+  quotas.release(1, 60);
+  waiter.join();
+  EXPECT_TRUE(pinned);
+  EXPECT_EQ(quotas.getPinnedBytes(1), 60);
+
+  // once the owner is gone it is not limited
+  quotas.unregisterOwner(1);
+  quotas.acquire(1, 1000);
+  EXPECT_EQ(quotas.getPinnedBytes(1), 0);
+}
+
+TEST(AdmissionControlTest, PinQuotaFailsAfterWaiting) {
+
+  // a pin that waits too long fails, the owner is not charged for it
+  PDBPinQuotas quotas(std::chrono::milliseconds(10));
+  quotas.registerOwner(1, 100);
+  EXPECT_TRUE(quotas.acquire(1, 100));
+  EXPECT_FALSE(quotas.acquire(1, 100));
+  EXPECT_EQ(quotas.getPinnedBytes(1), 100);
+}
+
+TEST(AdmissionControlTest, PinOwnerScope) {
+
+  EXPECT_EQ(PDBPinQuotas::getOwner(), PDB_NO_PIN_OWNER);
+  {
+    PDBPinOwnerScope scope(7);
+    EXPECT_EQ(PDBPinQuotas::getOwner(), 7);
+    {
+      PDBPinOwnerScope inner(8);
+      EXPECT_EQ(PDBPinQuotas::getOwner(), 8);
+    }
+    EXPECT_EQ(PDBPinQuotas::getOwner(), 7);
+  }
+  EXPECT_EQ(PDBPinQuotas::getOwner(), PDB_NO_PIN_OWNER);
+}
+
+}
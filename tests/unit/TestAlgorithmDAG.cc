@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <PDBAlgorithmDAG.h>
+
+namespace pdb {
+
+TEST(AlgorithmDAGTest, ShuffleJoinSidesRunTogether) {
+
+  PDBAlgorithmDAG dag;
+
+  // the two sides of the join scan their sets and shuffle them
+  auto lhs = dag.add({}, { 1, "AHashed" }, { { "db", "setA" } }, {}, {});
+  auto rhs = dag.add({}, { 1, "BHashedOnA" }, { { "db", "setB" } }, {}, { { 1, "A_to_shuffle" } });
+
+  // the join probes both and writes the output set, after it the hashed sides are not needed
+  auto join = dag.add({ { 1, "AHashed" }, { 1, "BHashedOnA" } }, { 1, "out" }, {}, { { "db", "outSet" } },
+                      { { 1, "AHashed" }, { 1, "BHashedOnA" } });
+
+  EXPECT_TRUE(dag.getDependencies(lhs).empty());
+  EXPECT_TRUE(dag.getDependencies(rhs).empty());
+  EXPECT_EQ(dag.getDependencies(join), std::vector<size_t>({ lhs, rhs }));
+
+  // the sides split the threads, the join has them all
+  EXPECT_EQ(dag.getNumConcurrent(lhs), 2);
+  EXPECT_EQ(dag.getNumConcurrent(rhs), 2);
+  EXPECT_EQ(dag.getNumConcurrent(join), 1);
+
+  // both sides start right away
+  EXPECT_EQ(dag.start(), std::vector<size_t>({ lhs, rhs }));
+  EXPECT_EQ(dag.getNumRunning(), 2);
+  EXPECT_TRUE(dag.start().empty());
+
+  // the right side finishes first, its page sets are only removed once the left side is done too
+  EXPECT_TRUE(dag.finish(rhs).empty());
+  EXPECT_TRUE(dag.start().empty());
+  auto removed = dag.finish(lhs);
+  ASSERT_EQ(removed.size(), 1);
+  EXPECT_EQ(removed[0].second, "A_to_shuffle");
+
+  // now the join can run
+  EXPECT_EQ(dag.start(), std::vector<size_t>({ join }));
+  EXPECT_FALSE(dag.isDone());
+  EXPECT_EQ(dag.finish(join).size(), 2);
+  EXPECT_TRUE(dag.isDone());
+  EXPECT_EQ(dag.getNumRunning(), 0);
+}
+
+TEST(AlgorithmDAGTest, SetsAreReadAfterTheyAreWritten) {
+
+  PDBAlgorithmDAG dag;
+
+  // write a set, scan it twice and then overwrite it
+  auto write = dag.add({}, { 1, "first" }, { { "db", "input" } }, { { "db", "tmp" } }, {});
+  auto scan1 = dag.add({}, { 1, "second" }, { { "db", "tmp" } }, {}, {});
+  auto scan2 = dag.add({}, { 1, "third" }, { { "db", "tmp" } }, {}, {});
+  auto overwrite = dag.add({}, { 1, "fourth" }, { { "db", "input" } }, { { "db", "tmp" } }, {});
+
+  EXPECT_EQ(dag.getDependencies(scan1), std::vector<size_t>({ write }));
+  EXPECT_EQ(dag.getDependencies(scan2), std::vector<size_t>({ write }));
+  EXPECT_EQ(dag.getDependencies(overwrite), std::vector<size_t>({ write, scan1, scan2 }));
+
+  // the scans run together after the write and the overwrite runs after both of them
+  EXPECT_EQ(dag.start(), std::vector<size_t>({ write }));
+  dag.finish(write);
+  EXPECT_EQ(dag.start(), std::vector<size_t>({ scan1, scan2 }));
+  dag.finish(scan2);
+  EXPECT_TRUE(dag.start().empty());
+  dag.finish(scan1);
+  EXPECT_EQ(dag.start(), std::vector<size_t>({ overwrite }));
+  dag.finish(overwrite);
+  EXPECT_TRUE(dag.isDone());
+}
+
+TEST(AlgorithmDAGTest, OnlyReaderStartsWithTheProducer) {
+
+  PDBAlgorithmDAG dag;
+
+  // a straight pipe makes a page set that only the aggregation after it reads, the aggregation starts with it
+  auto pipe = dag.add({}, { 1, "selected" }, { { "db", "input" } }, {}, {}, {}, true);
+  auto agg = dag.add({ { 1, "selected" } }, { 1, "aggregated" }, {}, { { "db", "out" } }, { { 1, "selected" } },
+                     { { 1, "selected" } }, false);
+
+  EXPECT_TRUE(dag.getDependencies(agg).empty());
+  EXPECT_EQ(dag.getStreamedPageSets(agg), std::vector<PDBPageSetIdentifier>({ { 1, "selected" } }));
+  EXPECT_TRUE(dag.streamsOutput(pipe));
+  EXPECT_EQ(dag.getNumConcurrent(pipe), 2);
+  EXPECT_EQ(dag.getNumConcurrent(agg), 2);
+
+  // a job after the aggregation runs after the pipe too
+  auto after = dag.add({ { 1, "aggregated" } }, { 1, "final" }, {}, {}, {}, {}, false);
+  EXPECT_EQ(dag.getNumConcurrent(after), 1);
+  EXPECT_EQ(dag.getNumConcurrent(pipe), 2);
+
+  // both run at the same time, the page set is removed once both are done
+  EXPECT_EQ(dag.start(), std::vector<size_t>({ pipe, agg }));
+  EXPECT_TRUE(dag.finish(pipe).empty());
+  EXPECT_EQ(dag.finish(agg).size(), 1);
+  EXPECT_EQ(dag.start(), std::vector<size_t>({ after }));
+  dag.finish(after);
+  EXPECT_TRUE(dag.isDone());
+}
+
+TEST(AlgorithmDAGTest, SecondReaderStopsTheStream) {
+
+  PDBAlgorithmDAG dag;
+
+  // the first reader would stream the page set
+  auto pipe = dag.add({}, { 1, "selected" }, { { "db", "input" } }, {}, {}, {}, true);
+  auto first = dag.add({ { 1, "selected" } }, { 1, "first" }, {}, {}, {}, { { 1, "selected" } }, true);
+  EXPECT_TRUE(dag.streamsOutput(pipe));
+
+  // but a second one needs all of it too, so both wait for the pipe
+  auto second = dag.add({ { 1, "selected" } }, { 1, "second" }, {}, {}, {}, { { 1, "selected" } }, true);
+  EXPECT_FALSE(dag.streamsOutput(pipe));
+  EXPECT_TRUE(dag.getStreamedPageSets(first).empty());
+  EXPECT_TRUE(dag.getStreamedPageSets(second).empty());
+  EXPECT_EQ(dag.getDependencies(first), std::vector<size_t>({ pipe }));
+  EXPECT_EQ(dag.getDependencies(second), std::vector<size_t>({ pipe }));
+
+  // a page set that is only used to probe, like the hash set of a join, is never streamed
+  auto probe = dag.add({ { 1, "first" } }, { 1, "probed" }, {}, {}, {}, {}, false);
+  EXPECT_FALSE(dag.streamsOutput(first));
+  EXPECT_EQ(dag.getDependencies(probe), std::vector<size_t>({ first }));
+
+  EXPECT_EQ(dag.start(), std::vector<size_t>({ pipe }));
+  dag.finish(pipe);
+  EXPECT_EQ(dag.start(), std::vector<size_t>({ first, second }));
+}
+
+TEST(AlgorithmDAGTest, ReaderThatWaitsAnywayDoesNotStream) {
+
+  PDBAlgorithmDAG dag;
+
+  // the reader overwrites the set the pipe scans, so it has to wait for the pipe to finish
+  auto pipe = dag.add({}, { 1, "selected" }, { { "db", "input" } }, {}, {}, {}, true);
+  auto reader = dag.add({ { 1, "selected" } }, { 1, "out" }, {}, { { "db", "input" } }, {}, { { 1, "selected" } }, false);
+
+  EXPECT_FALSE(dag.streamsOutput(pipe));
+  EXPECT_EQ(dag.getDependencies(reader), std::vector<size_t>({ pipe }));
+
+  // the producer has to be able to stream
+  PDBAlgorithmDAG other;
+  auto join = other.add({}, { 1, "joined" }, { { "db", "input" } }, {}, {}, {}, false);
+  auto after = other.add({ { 1, "joined" } }, { 1, "out" }, {}, {}, {}, { { 1, "joined" } }, false);
+  EXPECT_FALSE(other.streamsOutput(join));
+  EXPECT_EQ(other.getDependencies(after), std::vector<size_t>({ join }));
+}
+
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "AllocationBlockPool.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "InterfaceFunctions.h"
+#include "UseTemporaryAllocationBlock.h"
+
+using namespace pdb;
+
+TEST(AllocationBlockPoolTest, BlockSizes) {
+
+  // the sizes we pool are rounded up to the next quarter of a power of two
+  EXPECT_EQ(AllocationBlockPool::getBlockSize(1), 1024);
+  EXPECT_EQ(AllocationBlockPool::getBlockSize(1024), 1024);
+  EXPECT_EQ(AllocationBlockPool::getBlockSize(1025), 1280);
+  EXPECT_EQ(AllocationBlockPool::getBlockSize(2048), 2048);
+  EXPECT_EQ(AllocationBlockPool::getBlockSize(3000), 3072);
+  EXPECT_EQ(AllocationBlockPool::getBlockSize(5 * 1024 * 1024), 5 * 1024 * 1024);
+  EXPECT_EQ(AllocationBlockPool::getBlockSize(5 * 1024 * 1024 + 1), 6 * 1024 * 1024);
+  EXPECT_EQ(AllocationBlockPool::getBlockSize(8 * 1024 * 1024), 8 * 1024 * 1024);
+
+  // we never waste more than a quarter of the request
+  for (size_t numBytes = 1025; numBytes < 8 * 1024 * 1024; numBytes += 997) {
+    EXPECT_GE(AllocationBlockPool::getBlockSize(numBytes), numBytes);
+    EXPECT_LE(AllocationBlockPool::getBlockSize(numBytes), numBytes + numBytes / 4);
+  }
+
+  // the ones that are too large are not
+  EXPECT_EQ(AllocationBlockPool::getBlockSize(8 * 1024 * 1024 + 1), 8 * 1024 * 1024 + 1);
+}
+
+TEST(AllocationBlockPoolTest, ReuseBlocks) {
+
+  // get a block and give it back
+  void* block = AllocationBlockPool::acquire(3000);
+  AllocationBlockPool::release(block, AllocationBlockPool::getBlockSize(3000));
+
+  // a request that goes to the same bucket must get the same block
+  auto stats = AllocationBlockPool::getStats();
+  void* other = AllocationBlockPool::acquire(3072);
+  EXPECT_EQ(block, other);
+  EXPECT_EQ(AllocationBlockPool::getStats().hits, stats.hits + 1);
+  AllocationBlockPool::release(other, 3072);
+
+  // blocks that are not exactly the size of a bucket are freed
+  stats = AllocationBlockPool::getStats();
+  AllocationBlockPool::release(malloc(3000), 3000);
+  EXPECT_EQ(AllocationBlockPool::getStats().discarded, stats.discarded + 1);
+}
+
+TEST(AllocationBlockPoolTest, TemporaryAllocationBlocks) {
+
+  // warm up the pool
+  {
+    const UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+    Handle<String> str = makeObject<String>("warm up");
+  }
+
+  // every temporary block after that should come from the pool
+  auto stats = AllocationBlockPool::getStats();
+  for (int i = 0; i < 10; ++i) {
+    const UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+    Handle<String> str = makeObject<String>("string number " + std::to_string(i));
+    EXPECT_EQ(std::string(str->c_str()), "string number " + std::to_string(i));
+  }
+  EXPECT_EQ(AllocationBlockPool::getStats().hits, stats.hits + 10);
+  EXPECT_EQ(AllocationBlockPool::getStats().misses, stats.misses);
+
+  // the receive buffers come from the same pool
+  stats = AllocationBlockPool::getStats();
+  for (int i = 0; i < 10; ++i) {
+    PooledBuffer buffer(1000 * 1000);
+    memset(buffer.get(), i, 1000 * 1000);
+  }
+  EXPECT_EQ(AllocationBlockPool::getStats().hits, stats.hits + 10);
+}
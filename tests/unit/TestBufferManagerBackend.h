@@ -194,6 +194,21 @@ public:
     return _requestFactory->pinPage(myLogger, port, address, onErr, bytesForRequest, processResponse, setPtr, pageNum);
   }
 
+  // get mapped page, the mock frontend never has the page on disk so it is grabbed like any other page
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::BufGetMappedPageResult>)> &processResponse,
+                          const std::string &setName,
+                          const std::string &dbName,
+                          uint64_t pageNum) {
+
+    return onErr;
+  }
+
   static shared_ptr<MockRequestFactoryImpl> _requestFactory;
 };
 
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <PDBBulkLoadInput.h>
+#include <fstream>
+#include <cstdio>
+
+using namespace pdb;
+
+namespace {
+
+// reads all the items of the parts
+template<class Item, class Value>
+std::vector<Value> readAll(std::vector<PDBBulkLoadPart<Item>> &parts, const std::function<Value(Item&)> &toValue) {
+
+  std::vector<Value> values;
+  for(auto &part : parts) {
+    Item item;
+    while(part(item)) {
+      values.emplace_back(toValue(item));
+    }
+  }
+  return values;
+}
+
+}
+
+TEST(BulkLoadInputTest, SplitRange) {
+
+  // 103 records in 10 parts
+  auto parts = PDBBulkLoadInput::splitRange(103, 10);
+  EXPECT_EQ(parts.size(), 10);
+
+  // each index has to come up exactly once and in order
+  auto indices = readAll<size_t, size_t>(parts, [](size_t &idx) { return idx; });
+  ASSERT_EQ(indices.size(), 103);
+  for(size_t i = 0; i < indices.size(); ++i) {
+    EXPECT_EQ(indices[i], i);
+  }
+
+  // we never make more parts than there are records
+  EXPECT_EQ(PDBBulkLoadInput::splitRange(3, 10).size(), 3);
+}
+
+TEST(BulkLoadInputTest, SplitTextFile) {
+
+  // write the file, the lines have different lengths, some are windows lines and the last one has no line break
+  std::vector<std::string> lines;
+  {
+    std::ofstream file("bulkLoadInput.txt", std::ios::binary);
+    for(int i = 0; i < 1000; ++i) {
+      lines.emplace_back(std::to_string(i) + std::string(i % 17, 'x'));
+      file << lines.back() << (i == 999 ? "" : (i % 5 == 0 ? "\r\n" : "\n"));
+    }
+  }
+
+  // try a couple of part sizes, including ones smaller than a line
+  for(size_t partSize : { 3, 7, 100, 4096, 1000000 }) {
+
+    std::string error;
+    std::vector<PDBBulkLoadPart<std::string>> parts;
+    ASSERT_TRUE(PDBBulkLoadInput::splitTextFile("bulkLoadInput.txt", partSize, parts, error));
+
+    // each line has to come up exactly once and in order
+    auto read = readAll<std::string, std::string>(parts, [](std::string &line) { return line; });
+    EXPECT_EQ(read, lines);
+  }
+
+  // a file that is not there
+  std::string error;
+  std::vector<PDBBulkLoadPart<std::string>> parts;
+  EXPECT_FALSE(PDBBulkLoadInput::splitTextFile("bulkLoadInputMissing.txt", 100, parts, error));
+
+  std::remove("bulkLoadInput.txt");
+}
+
+TEST(BulkLoadInputTest, SplitBinaryFile) {
+
+  // write the file, the records are 12 bytes
+  const int numRecords = 100000;
+  {
+    std::ofstream file("bulkLoadInput.bin", std::ios::binary);
+    for(int32_t i = 0; i < numRecords; ++i) {
+      int32_t record[3] = { i, 2 * i, 3 * i };
+      file.write((char*) record, sizeof(record));
+    }
+  }
+
+  // the part size is not a multiple of the record size
+  std::string error;
+  std::vector<PDBBulkLoadPart<const char*>> parts;
+  ASSERT_TRUE(PDBBulkLoadInput::splitBinaryFile("bulkLoadInput.bin", 12, 100000, parts, error));
+  EXPECT_GT(parts.size(), 1);
+
+  // each record has to come up exactly once, in order and whole
+  auto read = readAll<const char*, int32_t>(parts, [](const char *&record) {
+    auto values = (int32_t*) record;
+    EXPECT_EQ(values[1], 2 * values[0]);
+    EXPECT_EQ(values[2], 3 * values[0]);
+    return values[0];
+  });
+  ASSERT_EQ(read.size(), numRecords);
+  for(int32_t i = 0; i < numRecords; ++i) {
+    EXPECT_EQ(read[i], i);
+  }
+
+  // the file does not have whole records of 7 bytes
+  parts.clear();
+  EXPECT_FALSE(PDBBulkLoadInput::splitBinaryFile("bulkLoadInput.bin", 7, 100000, parts, error));
+
+  std::remove("bulkLoadInput.bin");
+}
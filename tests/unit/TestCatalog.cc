@@ -152,6 +152,44 @@ TEST(CatalogTest, FullTest) {
   EXPECT_TRUE(!catalog.setExists("db1", "set2"));
 }
 
+TEST(CatalogTest, SetOnNodes) {
+
+  // remove the catalog if it exists from a previous run
+  boost::filesystem::remove("out.sqlite");
+
+  // create a catalog with a set
+  pdb::PDBCatalog catalog("out.sqlite");
+  std::string error;
+  EXPECT_TRUE(catalog.registerDatabase(std::make_shared<pdb::PDBCatalogDatabase>("db1"), error));
+  EXPECT_TRUE(catalog.registerType(std::make_shared<pdb::PDBCatalogType>(8341, "built-in", "Type1", std::vector<char>()), error));
+  EXPECT_TRUE(catalog.registerSet(std::make_shared<pdb::PDBCatalogSet>("db1", "set1", "Type1", 0, pdb::PDBCatalogSetContainerType::PDB_CATALOG_SET_NO_CONTAINER), error));
+
+  // two workers store some pages of the set
+  EXPECT_TRUE(catalog.incrementSetSize("db1", "set1", "localhost:8081", 1024, 1, error));
+  EXPECT_TRUE(catalog.incrementSetSize("db1", "set1", "localhost:8081", 2048, 2, error));
+  EXPECT_TRUE(catalog.incrementSetSize("db1", "set1", "localhost:8082", 1024, 1, error));
+
+  // an update without a node only changes the size of the set
+  EXPECT_TRUE(catalog.incrementSetSize("db1", "set1", 512, error));
+  EXPECT_EQ(catalog.getSet("db1", "set1")->setSize, 1024 + 2048 + 1024 + 512);
+
+  // check the size of the set on each node
+  auto setOnNodes = catalog.getSetOnNodes("db1", "set1");
+  EXPECT_EQ(setOnNodes.size(), 2);
+  for(auto &setOnNode : setOnNodes) {
+    EXPECT_EQ(setOnNode->setSize, setOnNode->nodeID == "localhost:8081" ? 1024 + 2048 : 1024);
+    EXPECT_EQ(setOnNode->numPages, setOnNode->nodeID == "localhost:8081" ? 3 : 1);
+  }
+
+  // the largest node has 3072 bytes, the average of the three workers is 4096 / 3
+  EXPECT_DOUBLE_EQ(pdb::PDBCatalogSetOnNode::getImbalance(setOnNodes, 3), 3072.0 * 3 / 4096);
+  EXPECT_DOUBLE_EQ(pdb::PDBCatalogSetOnNode::getImbalance({}, 3), 0);
+
+  // the sizes go away with the set
+  EXPECT_TRUE(catalog.removeSet("db1", "set1", error));
+  EXPECT_TRUE(catalog.getSetOnNodes("db1", "set1").empty());
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <PDBCodec.h>
+
+namespace pdb {
+
+namespace {
+
+// bytes that compress well, records with a name padded with zeros like the fixed size fields on a page
+std::vector<char> makeBytes(size_t numBytes) {
+
+  std::vector<char> bytes;
+  for(size_t i = 0; bytes.size() < numBytes; ++i) {
+    auto name = "Frank" + std::to_string(i % 1000);
+    name.resize(32, '\0');
+    bytes.insert(bytes.end(), name.begin(), name.end());
+  }
+  bytes.resize(numBytes);
+  return bytes;
+}
+
+}
+
+TEST(CodecsTest, RoundTrip) {
+
+  auto bytes = makeBytes(1024 * 1024);
+  for(const auto &name : PDBCodec::getAvailable()) {
+
+    // get the codec
+    std::string error;
+    auto codec = PDBCodec::get(name, error);
+    ASSERT_NE(codec, nullptr) << error;
+    EXPECT_EQ(codec->getName(), name);
+
+    // compress it into a frame
+    std::vector<char> frame(codec->getMaxFrameSize(bytes.size()));
+    auto frameSize = codec->compressFrame(bytes.data(), bytes.size(), frame.data(), frame.size());
+    ASSERT_GT(frameSize, 0) << name;
+
+    // the frame tells us everything we need
+    EXPECT_TRUE(PDBCodec::isFrame(frame.data(), frameSize));
+    EXPECT_EQ(PDBCodec::getFrameSize(frame.data()), frameSize);
+    EXPECT_EQ(PDBCodec::getFrameUncompressedSize(frame.data()), bytes.size());
+    EXPECT_EQ(PDBCodec::getFrameCodec(frame.data()), codec->getType());
+
+    // everything but the no-op codec makes it smaller
+    if(codec->getType() != PDB_NO_CODEC) {
+      EXPECT_LT(frameSize, bytes.size()) << name;
+    }
+
+    // decompress it without knowing the codec
+    std::vector<char> decompressed(bytes.size());
+    ASSERT_TRUE(PDBCodec::decompressFrame(frame.data(), frameSize, decompressed.data(), decompressed.size())) << name;
+    EXPECT_EQ(decompressed, bytes);
+
+    // an empty block works too
+    frameSize = codec->compressFrame(bytes.data(), 0, frame.data(), frame.size());
+    ASSERT_GT(frameSize, 0) << name;
+    EXPECT_TRUE(PDBCodec::decompressFrame(frame.data(), frameSize, decompressed.data(), decompressed.size())) << name;
+  }
+}
+
+TEST(CodecsTest, Names) {
+
+  std::string error;
+
+  // the codecs we are always built with
+  EXPECT_EQ(PDBCodec::get("none", error)->getType(), PDB_NO_CODEC);
+  EXPECT_EQ(PDBCodec::get("snappy", error)->getType(), PDB_SNAPPY_CODEC);
+
+  // names that are wrong, snappy has no levels
+  for(const auto &name : { "", "gzip", "snappy:", "snappy:fast", "snappy:3", "none:1", "zstd:1000", "zstd:3x", "Snappy" }) {
+    error.clear();
+    EXPECT_EQ(PDBCodec::get(name, error), nullptr) << name;
+    EXPECT_FALSE(error.empty()) << name;
+  }
+
+  // the optional codecs are only there if we were built with them
+  auto available = PDBCodec::getAvailable();
+  for(const auto &name : { "lz4", "zstd:3" }) {
+    auto isAvailable = std::find(available.begin(), available.end(), name) != available.end();
+    EXPECT_EQ(PDBCodec::get(name, error) != nullptr, isAvailable) << name;
+  }
+}
+
+TEST(CodecsTest, CorruptedFrames) {
+
+  auto bytes = makeBytes(64 * 1024);
+  auto codec = PDBCodec::get(PDB_SNAPPY_CODEC);
+
+  std::vector<char> frame(codec->getMaxFrameSize(bytes.size()));
+  auto frameSize = codec->compressFrame(bytes.data(), bytes.size(), frame.data(), frame.size());
+  ASSERT_GT(frameSize, 0);
+
+  std::vector<char> decompressed(bytes.size());
+
+  // a truncated frame
+  EXPECT_FALSE(PDBCodec::isFrame(frame.data(), frameSize - 1));
+  EXPECT_FALSE(PDBCodec::decompressFrame(frame.data(), frameSize - 1, decompressed.data(), decompressed.size()));
+  EXPECT_FALSE(PDBCodec::decompressFrame(frame.data(), sizeof(PDBCodec::Frame) - 1, decompressed.data(), decompressed.size()));
+
+  // not enough space for the bytes
+  EXPECT_FALSE(PDBCodec::decompressFrame(frame.data(), frameSize, decompressed.data(), decompressed.size() - 1));
+
+  // bytes that are not a frame
+  EXPECT_FALSE(PDBCodec::isFrame(bytes.data(), frameSize));
+
+  // a codec we don't know
+  auto unknown = frame;
+  ((PDBCodec::Frame*) unknown.data())->codec = 42;
+  EXPECT_FALSE(PDBCodec::decompressFrame(unknown.data(), frameSize, decompressed.data(), decompressed.size()));
+
+  // the uncompressed size does not match the compressed bytes
+  auto wrongSize = frame;
+  ((PDBCodec::Frame*) wrongSize.data())->uncompressedSize -= 1;
+  EXPECT_FALSE(PDBCodec::decompressFrame(wrongSize.data(), frameSize, decompressed.data(), decompressed.size()));
+
+  // the frame is still fine
+  EXPECT_TRUE(PDBCodec::decompressFrame(frame.data(), frameSize, decompressed.data(), decompressed.size()));
+  EXPECT_EQ(decompressed, bytes);
+}
+
+TEST(CodecsTest, NoSpace) {
+
+  auto bytes = makeBytes(64 * 1024);
+  for(const auto &name : PDBCodec::getAvailable()) {
+
+    std::string error;
+    auto codec = PDBCodec::get(name, error);
+
+    // there is not even space for the header
+    std::vector<char> frame(sizeof(PDBCodec::Frame));
+    EXPECT_EQ(codec->compressFrame(bytes.data(), bytes.size(), frame.data(), frame.size()), 0) << name;
+  }
+}
+
+}
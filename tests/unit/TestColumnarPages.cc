@@ -0,0 +1,336 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+
+#include <SetScanner.h>
+#include <Employee.h>
+#include <PDBColumns.h>
+#include <PDBColumnarPage.h>
+#include <PDBBufferManagerImpl.h>
+#include <PDBAbstractPageSet.h>
+#include <gmock/gmock-generated-function-mockers.h>
+#include <gmock/gmock-more-actions.h>
+
+namespace pdb {
+
+namespace {
+
+const PDBColumnEncoding allEncodings[] = { PDB_PLAIN_ENCODING, PDB_RLE_ENCODING, PDB_DELTA_ENCODING,
+                                           PDB_BIT_PACKED_ENCODING, PDB_DICTIONARY_ENCODING };
+
+// encodes the values and decodes them back with every encoding
+void checkRoundTrip(const std::vector<int64_t> &values) {
+
+  for (auto encoding : allEncodings) {
+
+    std::vector<char> data;
+    ASSERT_TRUE(PDBColumnarPage::encode(values, encoding, data)) << (int) encoding;
+
+    PDBColumnValues decoded;
+    ASSERT_TRUE(PDBColumnarPage::decode(PDB_INTEGER_COLUMN, encoding, data.data(), data.size(), values.size(), decoded)) << (int) encoding;
+    EXPECT_EQ(decoded.integers, values) << (int) encoding;
+  }
+}
+
+// the encoding that was picked for a column
+PDBColumnEncoding pickEncoding(const std::vector<int64_t> &values) {
+  std::vector<char> page;
+  PDBColumnarPage::startPage(values.size(), 8, page);
+  return PDBColumnarPage::addColumn("values", PDB_INTEGER_COLUMN, values, page);
+}
+
+PDBColumnEncoding pickEncoding(const std::vector<std::string> &values) {
+  std::vector<char> page;
+  PDBColumnarPage::startPage(values.size(), 8, page);
+  return PDBColumnarPage::addColumn("values", values, page);
+}
+
+// makes the employees on the current allocation block
+Handle<Vector<Handle<Employee>>> makeEmployees(size_t numEmployees) {
+
+  Handle<Vector<Handle<Employee>>> employees = makeObject<Vector<Handle<Employee>>>();
+  for (size_t i = 0; i < numEmployees; ++i) {
+    employees->push_back(makeObject<Employee>(i % 3 == 0 ? "Ann Frank" : "Tom Frank", (int) (i % 50), "dept" + std::to_string(i % 4), i * 1.5));
+  }
+  return employees;
+}
+
+// writes the employees to a columnar page
+std::vector<char> makeEmployeePage(size_t numEmployees) {
+
+  const UseTemporaryAllocationBlock tempBlock{16 * 1024 * 1024};
+  auto employees = makeEmployees(numEmployees);
+
+  std::vector<char> page;
+  std::string error;
+  EXPECT_TRUE(encodeColumnarPage<Employee>(employees, numEmployees * 64, page, error)) << error;
+  return page;
+}
+
+class MockPageSet : public pdb::PDBAbstractPageSet {
+ public:
+
+  MOCK_METHOD1(getNextPage, PDBPageHandle(size_t workerID));
+
+  MOCK_METHOD0(getNewPage, PDBPageHandle());
+
+  MOCK_METHOD0(getNumPages, size_t ());
+
+  MOCK_METHOD0(resetPageSet, void ());
+};
+
+}
+
+TEST(ColumnarPagesTest, RoundTrip) {
+
+  std::mt19937_64 random(42);
+
+  // random values, runs, sorted values, small values and a few distinct large values
+  std::vector<int64_t> randomValues, runs, sorted, small, few;
+  for (int i = 0; i < 10000; ++i) {
+    randomValues.push_back((int64_t) random());
+    runs.push_back(i / 100);
+    sorted.push_back(1000000 + i * 7 + (int64_t) (random() % 3));
+    small.push_back((int64_t) (random() % 16));
+    few.push_back(i % 3 == 0 ? std::numeric_limits<int64_t>::max() : -123456789012LL);
+  }
+
+  checkRoundTrip(randomValues);
+  checkRoundTrip(runs);
+  checkRoundTrip(sorted);
+  checkRoundTrip(small);
+  checkRoundTrip(few);
+
+  // the extremes need all 64 bits
+  checkRoundTrip({ std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), 0, -1 });
+  checkRoundTrip({ 42 });
+
+  // strings are plain or dictionary encoded
+  std::vector<std::string> strings;
+  for (int i = 0; i < 1000; ++i) {
+    strings.push_back(i % 7 == 0 ? "" : "string" + std::to_string(i % 13));
+  }
+  for (auto encoding : { PDB_PLAIN_ENCODING, PDB_DICTIONARY_ENCODING }) {
+
+    std::vector<char> data;
+    ASSERT_TRUE(PDBColumnarPage::encode(strings, encoding, data));
+
+    PDBColumnValues decoded;
+    ASSERT_TRUE(PDBColumnarPage::decode(PDB_STRING_COLUMN, encoding, data.data(), data.size(), strings.size(), decoded));
+    ASSERT_EQ(decoded.codes.size(), strings.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+      EXPECT_EQ(decoded.dictionary[decoded.codes[i]], strings[i]);
+    }
+  }
+
+  std::vector<char> data;
+  EXPECT_FALSE(PDBColumnarPage::encode(strings, PDB_RLE_ENCODING, data));
+}
+
+TEST(ColumnarPagesTest, PicksTheSmallestEncoding) {
+
+  std::mt19937_64 random(42);
+
+  std::vector<int64_t> randomValues, runs, sorted, small, few;
+  for (int i = 0; i < 10000; ++i) {
+    randomValues.push_back((int64_t) random());
+    runs.push_back((int64_t) std::mt19937_64(i / 1000)());
+    sorted.push_back((int64_t) 1 << 50 | (i * 5));
+    small.push_back((int64_t) (random() % 16));
+    few.push_back(i % 2 == 0 ? (int64_t) 1 << 60 : -((int64_t) 1 << 60) + (int64_t) (random() % 2) * 77777);
+  }
+
+  EXPECT_EQ(pickEncoding(randomValues), PDB_PLAIN_ENCODING);
+  EXPECT_EQ(pickEncoding(runs), PDB_RLE_ENCODING);
+  EXPECT_EQ(pickEncoding(sorted), PDB_DELTA_ENCODING);
+  EXPECT_EQ(pickEncoding(small), PDB_BIT_PACKED_ENCODING);
+  EXPECT_EQ(pickEncoding(few), PDB_DICTIONARY_ENCODING);
+
+  std::vector<std::string> distinct, repeated;
+  for (int i = 0; i < 1000; ++i) {
+    distinct.push_back("string" + std::to_string(i));
+    repeated.push_back("a much longer string" + std::to_string(i % 5));
+  }
+
+  EXPECT_EQ(pickEncoding(distinct), PDB_PLAIN_ENCODING);
+  EXPECT_EQ(pickEncoding(repeated), PDB_DICTIONARY_ENCODING);
+}
+
+TEST(ColumnarPagesTest, CorruptedPages) {
+
+  auto page = makeEmployeePage(1000);
+
+  // a good page
+  PDBColumnarPage good(page.data());
+  ASSERT_TRUE(good.isValid());
+  EXPECT_TRUE(PDBColumnarPage::isColumnar(page.data()));
+  EXPECT_EQ(good.getNumRows(), 1000);
+  EXPECT_EQ(good.getNumBytes(), page.size());
+  EXPECT_EQ(good.getNumColumns(), 4);
+  EXPECT_EQ(good.getColumnIndex("age"), 1);
+  EXPECT_EQ(good.getColumnIndex("nope"), -1);
+  EXPECT_EQ(good.getColumnType(good.getColumnIndex("salary")), PDB_FLOAT_COLUMN);
+  EXPECT_EQ(good.getColumnType(good.getColumnIndex("name")), PDB_STRING_COLUMN);
+
+  // the magic number is wrong
+  auto wrongMagic = page;
+  ((PDBColumnarPage::Header*) wrongMagic.data())->magic = 42;
+  EXPECT_FALSE(PDBColumnarPage::isColumnar(wrongMagic.data()));
+  EXPECT_FALSE(PDBColumnarPage(wrongMagic.data()).isValid());
+
+  // the page claims to be shorter than it is, so the last column sticks out
+  auto truncated = page;
+  ((PDBColumnarPage::Header*) truncated.data())->numBytes -= 8;
+  EXPECT_FALSE(PDBColumnarPage(truncated.data()).isValid());
+
+  // the page claims to have more columns than it does
+  auto moreColumns = page;
+  ((PDBColumnarPage::Header*) moreColumns.data())->numColumns += 1;
+  EXPECT_FALSE(PDBColumnarPage(moreColumns.data()).isValid());
+
+  // the values of a column are cut short
+  auto ages = good.getColumnIndex("age");
+  PDBColumnValues values;
+  EXPECT_FALSE(PDBColumnarPage::decode(good.getColumnType(ages), good.getColumnEncoding(ages), page.data() + sizeof(PDBColumnarPage::Header), 4, 1000, values));
+}
+
+TEST(ColumnarPagesTest, EmployeeRoundTrip) {
+
+  auto page = makeEmployeePage(1000);
+
+  // it is smaller than the records were
+  {
+    const UseTemporaryAllocationBlock tempBlock{16 * 1024 * 1024};
+    auto employees = makeEmployees(1000);
+    getRecord(employees);
+    EXPECT_LT(page.size(), getRecord(employees)->numBytes());
+  }
+
+  const UseTemporaryAllocationBlock tempBlock{16 * 1024 * 1024};
+
+  std::string error;
+  auto employees = decodeColumnarPage<Employee>(PDBColumnarPage(page.data()), error);
+  ASSERT_NE(employees, nullptr) << error;
+  ASSERT_EQ(employees->size(), 1000);
+
+  for (size_t i = 0; i < employees->size(); ++i) {
+    auto &employee = (*employees)[i];
+    EXPECT_EQ((std::string) *employee->name, i % 3 == 0 ? "Ann Frank" : "Tom Frank");
+    EXPECT_EQ(employee->age, i % 50);
+    EXPECT_EQ(employee->salary, i * 1.5);
+    EXPECT_EQ((std::string) employee->department, "dept" + std::to_string(i % 4));
+  }
+
+  // a corrupted page fails
+  ((PDBColumnarPage::Header*) page.data())->numColumns += 1;
+  EXPECT_EQ(decodeColumnarPage<Employee>(PDBColumnarPage(page.data()), error), nullptr);
+  EXPECT_FALSE(error.empty());
+}
+
+TEST(ColumnarPagesTest, SetScanner) {
+
+  // create the buffer manager
+  pdb::PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", 1024 * 1024, 16, "metadata", ".");
+
+  // write 5 columnar pages, the third one is empty
+  const size_t numRows[] = { 1000, 500, 0, 1234, 7 };
+  for (int j = 0; j < 5; ++j) {
+
+    auto bytes = makeEmployeePage(numRows[j]);
+    ASSERT_LE(bytes.size(), myMgr.getMaxPageSize());
+
+    auto page = myMgr.getPage(make_shared<pdb::PDBSet>("db", "set"), j);
+    memcpy(page->getBytes(), bytes.data(), bytes.size());
+  }
+
+  // the pipeline uses the whole records, calls getAge on them, or only accesses the ages
+  for (int mode : { 0, 1, 2 }) {
+
+    bool onlyAttributes = mode == 2;
+
+    // the page set that is gonna provide stuff
+    std::shared_ptr<MockPageSet> pageSet = std::make_shared<MockPageSet>();
+
+    uint64_t counter = 0;
+    ON_CALL(*pageSet, getNextPage(testing::An<size_t>())).WillByDefault(testing::Invoke(
+        [&](size_t workerID) {
+
+          if(counter >= 5) {
+            return (PDBPageHandle) nullptr;
+          }
+
+          return myMgr.getPage(make_shared<pdb::PDBSet>("db", "set"), counter++);
+        }
+    ));
+
+    EXPECT_CALL(*pageSet, getNextPage(testing::An<size_t>())).Times(6);
+
+    auto scanAttributes = std::make_shared<ScanAttributesArg>(mode != 0,
+                                                              onlyAttributes,
+                                                              mode == 2 ? std::set<std::string>{ "age" } : std::set<std::string>{},
+                                                              mode == 1 ? std::set<std::string>{ "getAge" } : std::set<std::string>{});
+
+    std::map<ComputeInfoType, ComputeInfoPtr> params = {{ ComputeInfoType::SOURCE_SET_INFO,
+                                                          std::make_shared<pdb::SourceSetArg>(std::make_shared<PDBCatalogSet>("", "", "", 0, PDBCatalogSetContainerType::PDB_CATALOG_SET_COLUMNAR_CONTAINER))},
+                                                        { ComputeInfoType::SCAN_ATTRIBUTES, scanAttributes }};
+
+    pdb::SetScanner<pdb::Employee> scanner("db", "set");
+    auto dataSource = scanner.getComputeSource(std::dynamic_pointer_cast<pdb::PDBAbstractPageSet>(pageSet), 15, 0, params);
+
+    // go through the rows, the ages restart on every page
+    TupleSetPtr curChunk;
+    PDBTupleSetSizePolicy curpolicy(myMgr.getMaxPageSize());
+    size_t page = 0, row = 0, total = 0;
+    while ((curChunk = dataSource->getNextTupleSet(curpolicy)) != nullptr) {
+
+      auto &emps = curChunk->getColumn<Handle<pdb::Employee>>(0);
+      auto chunk = curChunk->getColumnarChunk(0);
+      auto ages = chunk == nullptr ? nullptr : (int*) chunk->getAttribute("age", typeid(int));
+
+      // we only get the ages if we don't have the records
+      EXPECT_EQ(chunk != nullptr, onlyAttributes);
+      EXPECT_EQ(ages != nullptr, onlyAttributes);
+      if (chunk != nullptr) {
+        EXPECT_EQ(chunk->getAttribute("age", typeid(double)), nullptr);
+        EXPECT_EQ(chunk->getAttribute("salary", typeid(double)), nullptr);
+      }
+
+      for (size_t i = 0; i < emps.size(); ++i) {
+
+        // move to the next page with rows
+        while (row == numRows[page]) {
+          page++;
+          row = 0;
+        }
+
+        if (onlyAttributes) {
+          EXPECT_EQ(emps[i], nullptr);
+          EXPECT_EQ(ages[i], row % 50);
+        } else if (mode == 1) {
+          EXPECT_EQ(emps[i]->getAge(), row % 50);
+          EXPECT_EQ(emps[i]->name, nullptr);
+        } else {
+          EXPECT_EQ(emps[i]->age, row % 50);
+          EXPECT_EQ((std::string) *emps[i]->name, row % 3 == 0 ? "Ann Frank" : "Tom Frank");
+        }
+        row++;
+      }
+      total += emps.size();
+    }
+
+    EXPECT_EQ(total, 1000 + 500 + 1234 + 7);
+
+    // we only read the ages unless we need the whole records
+    auto stats = dataSource->getScanStats();
+    EXPECT_EQ(stats.numPages, 5);
+    EXPECT_GT(stats.numBytesRead, 0);
+    if (mode == 0) {
+      EXPECT_EQ(stats.numBytesRead, stats.numPageBytes);
+    } else {
+      EXPECT_LT(stats.numBytesRead * 2, stats.numPageBytes);
+    }
+  }
+}
+
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <cstring>
+#include <PDBCompressedPage.h>
+#include <PDBSetPageSet.h>
+#include <PDBBufferManagerImpl.h>
+#include <UseTemporaryAllocationBlock.h>
+#include <InterfaceFunctions.h>
+#include <PDBVector.h>
+#include <Employee.h>
+
+namespace pdb {
+
+namespace {
+
+// builds a page of employees in place and returns the size of the record
+size_t makeEmployeePage(void *bytes, size_t pageSize, int32_t first) {
+
+  const UseTemporaryAllocationBlock tempBlock{bytes, pageSize};
+
+  // add employees until the page is full
+  Handle<Vector<Handle<Employee>>> employees = makeObject<Vector<Handle<Employee>>>();
+  try {
+    for(int32_t i = first; true; ++i) {
+      Handle<Employee> employee = makeObject<Employee>("Frank" + std::to_string(i), i, "myDept", 123.45);
+      employees->push_back(employee);
+    }
+  } catch (NotEnoughSpace &n) {}
+
+  // keep the record
+  auto numBytes = getRecord(employees)->numBytes();
+  employees.emptyOutContainingBlock();
+  return numBytes;
+}
+
+// returns the ages of the employees on a page
+std::vector<int32_t> getAges(void *bytes) {
+
+  auto record = (Record<Vector<Handle<Employee>>>*) bytes;
+  auto employees = record->getRootObject();
+
+  std::vector<int32_t> ages;
+  for(size_t i = 0; i < employees->size(); ++i) {
+    ages.emplace_back((*employees)[i]->getAge());
+  }
+  return ages;
+}
+
+}
+
+TEST(CompressedPagesTest, RoundTrip) {
+
+  const size_t pageSize = 1024 * 1024;
+  std::unique_ptr<char[]> record(new char[pageSize]);
+  std::unique_ptr<char[]> page(new char[pageSize]);
+  std::unique_ptr<char[]> decompressed(new char[pageSize]);
+
+  // a page with a record is not compressed
+  auto numBytes = makeEmployeePage(record.get(), pageSize, 0);
+  EXPECT_FALSE(PDBCompressedPage::isCompressed(record.get()));
+
+  // without a codec we don't compress it
+  EXPECT_EQ(PDBCompressedPage::compress(nullptr, record.get(), numBytes, page.get(), pageSize), 0);
+  EXPECT_EQ(PDBCompressedPage::compress(PDBCodec::get(PDB_NO_CODEC), record.get(), numBytes, page.get(), pageSize), 0);
+
+  // compress it, the employees compress well
+  auto codec = PDBCodec::get(PDB_SNAPPY_CODEC);
+  auto storedSize = PDBCompressedPage::compress(codec, record.get(), numBytes, page.get(), pageSize);
+  EXPECT_GT(storedSize, 0);
+  EXPECT_LT(storedSize, numBytes);
+  EXPECT_TRUE(PDBCompressedPage::isCompressed(page.get()));
+  EXPECT_EQ(PDBCompressedPage::getUncompressedSize(page.get()), numBytes);
+  EXPECT_EQ(PDBCompressedPage::getFrameSize(page.get()) + sizeof(PDBCompressedPage::Header), storedSize);
+
+  // the page holds a frame, that is what we send over the wire
+  auto frame = PDBCompressedPage::getFrame(page.get());
+  ASSERT_TRUE(PDBCodec::isFrame(frame, PDBCompressedPage::getFrameSize(page.get())));
+  EXPECT_EQ(PDBCodec::getFrameCodec(frame), PDB_SNAPPY_CODEC);
+  EXPECT_EQ(PDBCodec::getFrameUncompressedSize(frame), numBytes);
+
+  // decompress it
+  EXPECT_FALSE(PDBCompressedPage::decompress(page.get(), decompressed.get(), numBytes - 1));
+  ASSERT_TRUE(PDBCompressedPage::decompress(page.get(), decompressed.get(), pageSize));
+  EXPECT_EQ(memcmp(decompressed.get(), record.get(), numBytes), 0);
+  EXPECT_EQ(getAges(decompressed.get()), getAges(record.get()));
+
+  // a record that does not get smaller is not compressed
+  std::mt19937_64 gen(42);
+  for(size_t i = 0; i < pageSize / sizeof(uint64_t); ++i) {
+    ((uint64_t*) record.get())[i] = gen();
+  }
+  EXPECT_EQ(PDBCompressedPage::compress(codec, record.get(), pageSize, page.get(), pageSize), 0);
+}
+
+TEST(CompressedPagesTest, StoreFrame) {
+
+  const size_t pageSize = 1024 * 1024;
+  std::unique_ptr<char[]> record(new char[pageSize]);
+  std::unique_ptr<char[]> page(new char[pageSize]);
+  std::unique_ptr<char[]> decompressed(new char[pageSize]);
+
+  // compress the record like the clients do
+  auto numBytes = makeEmployeePage(record.get(), pageSize, 0);
+  auto codec = PDBCodec::get(PDB_SNAPPY_CODEC);
+  std::unique_ptr<char[]> frame(new char[codec->getMaxFrameSize(numBytes)]);
+  auto frameSize = codec->compressFrame(record.get(), numBytes, frame.get(), codec->getMaxFrameSize(numBytes));
+  ASSERT_GT(frameSize, 0);
+
+  // store it as it is
+  auto storedSize = PDBCompressedPage::storeFrame(frame.get(), frameSize, page.get(), pageSize);
+  EXPECT_EQ(storedSize, frameSize + sizeof(PDBCompressedPage::Header));
+  EXPECT_EQ(PDBCompressedPage::getFrameSize(page.get()), frameSize);
+  ASSERT_TRUE(PDBCompressedPage::decompress(page.get(), decompressed.get(), pageSize));
+  EXPECT_EQ(memcmp(decompressed.get(), record.get(), numBytes), 0);
+
+  // it does not fit on a tiny page
+  EXPECT_EQ(PDBCompressedPage::storeFrame(frame.get(), frameSize, page.get(), frameSize), 0);
+
+  // a truncated frame is not stored
+  EXPECT_EQ(PDBCompressedPage::storeFrame(frame.get(), frameSize - 1, page.get(), pageSize), 0);
+}
+
+TEST(CompressedPagesTest, SetPageSet) {
+
+  const uint64_t numPages = 10;
+  const size_t pageSize = 1024 * 1024;
+
+  // create the buffer manager
+  auto myMgr = std::make_shared<PDBBufferManagerImpl>();
+  myMgr->initialize("tempDSFSD", pageSize, 16, "metadata", ".");
+
+  // every other page of the set is stored compressed
+  auto set = make_shared<PDBSet>("db", "set");
+  std::unique_ptr<char[]> record(new char[pageSize]);
+  std::vector<uint64_t> pages;
+  std::vector<std::vector<int32_t>> ages;
+  for(uint64_t i = 0; i < numPages; ++i) {
+
+    auto numBytes = makeEmployeePage(record.get(), pageSize, (int32_t) (i * 1000));
+    ages.emplace_back(getAges(record.get()));
+
+    // store the page
+    auto page = myMgr->getPage(set, i);
+    size_t storedSize = 0;
+    if(i % 2 == 0) {
+      storedSize = PDBCompressedPage::compress(PDBCodec::get(PDB_SNAPPY_CODEC), record.get(), numBytes, page->getBytes(), page->getSize());
+      EXPECT_GT(storedSize, 0);
+    }
+    if(storedSize == 0) {
+      memcpy(page->getBytes(), record.get(), numBytes);
+      storedSize = numBytes;
+    }
+    page->freezeSize(storedSize);
+    page->unpin();
+
+    pages.emplace_back(i);
+  }
+
+  // the pages of the page set are always decompressed
+  auto pageSet = std::make_shared<PDBSetPageSet>("db", "set", pages, myMgr);
+  for(uint64_t i = 0; i < numPages; ++i) {
+
+    auto page = pageSet->getNextPage(0);
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(page->isPinned());
+    EXPECT_FALSE(PDBCompressedPage::isCompressed(page->getBytes()));
+    EXPECT_EQ(getAges(page->getBytes()), ages[i]);
+  }
+  EXPECT_EQ(pageSet->getNextPage(0), nullptr);
+
+  // the set pages stay compressed
+  for(uint64_t i = 0; i < numPages; ++i) {
+    auto page = myMgr->getPage(set, i);
+    EXPECT_EQ(PDBCompressedPage::isCompressed(page->getBytes()), i % 2 == 0);
+  }
+}
+
+}
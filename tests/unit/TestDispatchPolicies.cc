@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <PDBCatalogSet.h>
+#include <PDBCatalogNode.h>
+#include <PDBDispatchHashPolicy.h>
+#include <PDBDispatchRangePolicy.h>
+#include <PDBDispatchLoadPolicy.h>
+#include <PDBDispatchRandomPolicy.h>
+
+using namespace pdb;
+
+TEST(DispatchPoliciesTest, HashPartitioning) {
+
+  PDBDispatchHashPolicy policy(16);
+
+  // every key has to go to a valid partition and always to the same one
+  std::vector<int32_t> counts(16, 0);
+  for(int64_t key = -5000; key < 5000; ++key) {
+    auto partition = policy.getPartition(key);
+    ASSERT_GE(partition, 0);
+    ASSERT_LT(partition, 16);
+    EXPECT_EQ(partition, policy.getPartition(key));
+    counts[partition]++;
+  }
+
+  // consecutive keys should be spread over all the partitions
+  for(auto count : counts) {
+    EXPECT_GT(count, 10000 / 16 / 2);
+  }
+
+  // the partitions are spread over the nodes
+  EXPECT_EQ(policy.getNodeIndex(7, 3), policy.getPartition(7) % 3);
+}
+
+TEST(DispatchPoliciesTest, RangePartitioning) {
+
+  // the boundaries are stored as a string in the catalog
+  auto boundaries = PDBDispatchRangePolicy::parseBoundaries("10,20,30");
+  EXPECT_EQ(boundaries, std::vector<int64_t>({10, 20, 30}));
+  EXPECT_EQ(PDBDispatchRangePolicy::formatBoundaries(boundaries), "10,20,30");
+  EXPECT_TRUE(PDBDispatchRangePolicy::parseBoundaries("").empty());
+
+  // n boundaries give us n + 1 partitions, the boundary belongs to the lower partition
+  PDBDispatchRangePolicy policy(boundaries);
+  EXPECT_EQ(policy.getPartition(-100), 0);
+  EXPECT_EQ(policy.getPartition(10), 0);
+  EXPECT_EQ(policy.getPartition(11), 1);
+  EXPECT_EQ(policy.getPartition(30), 2);
+  EXPECT_EQ(policy.getPartition(31), 3);
+}
+
+TEST(DispatchPoliciesTest, CoPartitionedSets) {
+
+  // two sets partitioned the same way
+  PDBCatalogSet setA("db", "setA", "Nothing", 0, PDB_CATALOG_SET_NO_CONTAINER);
+  PDBCatalogSet setB("db", "setB", "Nothing", 0, PDB_CATALOG_SET_NO_CONTAINER);
+  setA.setPartitioning(PDB_CATALOG_SET_HASH_PARTITIONING, 8, "self", "group", "");
+  setB.setPartitioning(PDB_CATALOG_SET_HASH_PARTITIONING, 8, "myInt", "group", "");
+  EXPECT_TRUE(setA.isPartitionedLike(setB));
+
+  // they are only co-partitioned once their partitions are placed on the same nodes
+  EXPECT_FALSE(setA.isCoPartitionedWith(setB));
+  setA.partitionNodes = "localhost:8109,localhost:8110";
+  setB.partitionNodes = "localhost:8110,localhost:8109";
+  EXPECT_FALSE(setA.isCoPartitionedWith(setB));
+  setB.partitionNodes = setA.partitionNodes;
+  EXPECT_TRUE(setA.isCoPartitionedWith(setB));
+
+  // a different number of partitions or group breaks it
+  PDBCatalogSet setC("db", "setC", "Nothing", 0, PDB_CATALOG_SET_NO_CONTAINER);
+  setC.setPartitioning(PDB_CATALOG_SET_HASH_PARTITIONING, 4, "self", "group", "");
+  EXPECT_FALSE(setA.isCoPartitionedWith(setC));
+  setC.setPartitioning(PDB_CATALOG_SET_HASH_PARTITIONING, 8, "self", "other", "");
+  EXPECT_FALSE(setA.isCoPartitionedWith(setC));
+
+  // make some nodes
+  std::vector<PDBCatalogNodePtr> nodes;
+  for(int i = 0; i < 5; ++i) {
+    auto id = "localhost:" + std::to_string(8109 + i);
+    nodes.emplace_back(std::make_shared<PDBCatalogNode>(id, "localhost", 8109 + i, "worker", 1, 1024, true));
+  }
+
+  // the nodes can come in any order from the catalog
+  auto shuffled = nodes;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+
+  // the catalog stores the nodes of the partitions and we find them among the active ones in that order
+  auto partitionNodes = PDBDispatchPartitionPolicy::formatNodes(PDBDispatchPartitionPolicy::orderNodes(shuffled));
+  EXPECT_EQ(partitionNodes, "localhost:8109,localhost:8110,localhost:8111,localhost:8112,localhost:8113");
+
+  std::string error;
+  std::vector<PDBCatalogNodePtr> placed;
+  EXPECT_TRUE(PDBDispatchPartitionPolicy::placeNodes(partitionNodes, shuffled, placed, error));
+  ASSERT_EQ(placed.size(), nodes.size());
+  for(size_t i = 0; i < nodes.size(); ++i) {
+    EXPECT_EQ(placed[i]->nodeID, nodes[i]->nodeID);
+  }
+
+  // if a node with partitions is gone the records can not be placed
+  EXPECT_FALSE(PDBDispatchPartitionPolicy::placeNodes(partitionNodes,
+                                                      std::vector<PDBCatalogNodePtr>(nodes.begin(), nodes.end() - 1),
+                                                      placed,
+                                                      error));
+
+  // the same key has to go to the same node for both sets
+  auto policyA = PDBDispatchPartitionPolicy::create(setA);
+  auto policyB = PDBDispatchPartitionPolicy::create(setB);
+  for(int64_t key = 0; key < 1000; ++key) {
+    EXPECT_EQ(policyA->getNodeForKey("db", "setA", key, nodes)->nodeID,
+              policyB->getNodeForKey("db", "setB", key, shuffled)->nodeID);
+  }
+
+  // records of a partitioned set can not be sent without a key
+  EXPECT_THROW(policyA->getNextNode("db", "setA", nodes), std::runtime_error);
+
+  // sets that are not partitioned don't have a partition policy
+  PDBCatalogSet setD("db", "setD", "Nothing", 0, PDB_CATALOG_SET_NO_CONTAINER);
+  EXPECT_FALSE(setD.isPartitioned());
+  EXPECT_EQ(PDBDispatchPartitionPolicy::create(setD), nullptr);
+}
+
+namespace {
+
+std::vector<PDBCatalogNodePtr> makeNodes(int numNodes) {
+  std::vector<PDBCatalogNodePtr> nodes;
+  for(int i = 0; i < numNodes; ++i) {
+    auto id = "localhost:" + std::to_string(8109 + i);
+    nodes.emplace_back(std::make_shared<PDBCatalogNode>(id, "localhost", 8109 + i, "worker", 1, 1024, true));
+  }
+  return nodes;
+}
+
+}
+
+TEST(DispatchPoliciesTest, LeastLoaded) {
+
+  auto nodes = makeNodes(4);
+  PDBDispatchLoadPolicy policy(false);
+
+  // the first node already has a lot of the set
+  policy.updateLoad("db", "set", { std::make_shared<PDBCatalogSetOnNode>("db:set", nodes[0]->nodeID, 10000, 10) });
+
+  // pages of very different sizes, the large ones must not pile up on one node
+  std::vector<uint64_t> sizes = { 5000, 100, 100, 100, 5000, 100, 100, 100, 5000, 100 };
+  for(auto size : sizes) {
+    auto node = policy.getNextNode("db", "set", size, nodes);
+    EXPECT_NE(node->nodeID, nodes[0]->nodeID);
+  }
+
+  // the bytes should be spread almost evenly over the other nodes, no node gets more than one large page over the rest
+  uint64_t largest = 0, smallest = std::numeric_limits<uint64_t>::max();
+  for(int i = 1; i < 4; ++i) {
+    largest = std::max(largest, policy.getLoad("db", "set", nodes[i]->nodeID));
+    smallest = std::min(smallest, policy.getLoad("db", "set", nodes[i]->nodeID));
+  }
+  EXPECT_EQ(largest, 5500);
+  EXPECT_EQ(smallest, 5100);
+
+  // the other sets are not affected
+  EXPECT_EQ(policy.getLoad("db", "other", nodes[1]->nodeID), 0);
+}
+
+TEST(DispatchPoliciesTest, PendingPagesAreReported) {
+
+  auto nodes = makeNodes(2);
+  PDBDispatchLoadPolicy policy(false);
+
+  // send a page, it is pending
+  auto node = policy.getNextNode("db", "set", 1000, nodes);
+  EXPECT_EQ(policy.getLoad("db", "set", node->nodeID), 1000);
+
+  // the worker reports it, it should not be counted twice
+  policy.updateLoad("db", "set", { std::make_shared<PDBCatalogSetOnNode>("db:set", node->nodeID, 1000, 1) });
+  EXPECT_EQ(policy.getLoad("db", "set", node->nodeID), 1000);
+
+  // a report of data that did not go through us is just added
+  policy.updateLoad("db", "set", { std::make_shared<PDBCatalogSetOnNode>("db:set", node->nodeID, 3000, 3) });
+  EXPECT_EQ(policy.getLoad("db", "set", node->nodeID), 3000);
+
+  // once the set is removed we forget about it
+  policy.removeSet("db", "set");
+  EXPECT_EQ(policy.getLoad("db", "set", node->nodeID), 0);
+}
+
+TEST(DispatchPoliciesTest, LoadIsOnlyAskedForOnceInAWhile) {
+
+  auto nodes = makeNodes(2);
+  PDBDispatchLoadPolicy policy(false);
+
+  // we know nothing about the set, so we want a report
+  EXPECT_TRUE(policy.needsLoad("db", "set"));
+
+  // once we have one the pages we send are counted as pending until it gets stale
+  policy.updateLoad("db", "set", { std::make_shared<PDBCatalogSetOnNode>("db:set", nodes[0]->nodeID, 1000, 1) });
+  EXPECT_FALSE(policy.needsLoad("db", "set"));
+  policy.getNextNode("db", "set", 1000, nodes);
+  EXPECT_FALSE(policy.needsLoad("db", "set"));
+  EXPECT_TRUE(policy.needsLoad("db", "other"));
+
+  // a removed set needs a new report
+  policy.removeSet("db", "set");
+  EXPECT_TRUE(policy.needsLoad("db", "set"));
+
+  // the random policy does not care about the load
+  PDBDispatchRandomPolicy randomPolicy;
+  EXPECT_FALSE(randomPolicy.needsLoad("db", "set"));
+}
+
+TEST(DispatchPoliciesTest, TwoChoices) {
+
+  auto nodes = makeNodes(8);
+  PDBDispatchLoadPolicy policy(true);
+
+  // send a bunch of equally sized pages
+  for(int i = 0; i < 8000; ++i) {
+    policy.getNextNode("db", "set", 100, nodes);
+  }
+
+  // every node should get close to the average of 1000 pages
+  for(auto &node : nodes) {
+    auto load = policy.getLoad("db", "set", node->nodeID);
+    EXPECT_GT(load, 900 * 100);
+    EXPECT_LT(load, 1100 * 100);
+  }
+}
@@ -87,4 +87,30 @@ TEST(FeedingPageSetTest, Test1) {
 
 }
 
+TEST(FeedingPageSetTest, TestSize) {
+
+  // create the buffer manager
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", 64, 30, "metadata", ".");
+
+  // the feeding page set
+  auto feedingPageSet = std::make_shared<PDBFeedingPageSet>(1, 1);
+  EXPECT_EQ(feedingPageSet->getSize(), 0);
+
+  // a full page
+  auto page = myMgr.getPage();
+  page->unpin();
+  feedingPageSet->feedPage(page);
+  EXPECT_EQ(feedingPageSet->getSize(), 64);
+
+  // a page that had its size frozen counts only that much
+  page = myMgr.getPage();
+  page->freezeSize(10);
+  page->unpin();
+  feedingPageSet->feedPage(page);
+  EXPECT_EQ(feedingPageSet->getSize(), 64 + 16);
+
+  feedingPageSet->finishFeeding();
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <PDBIncrementalAggregations.h>
+
+namespace pdb {
+
+// makes what an aggregation of myData.mySet is computed from
+static PDBIncrementalAggregation makeAggregation(uint64_t outputVersion, uint64_t numThreads = 4, uint64_t inputClears = 0) {
+
+  PDBIncrementalAggregation aggregation;
+  aggregation.signature = "A";
+  aggregation.nodes = "localhost:8109";
+  aggregation.numThreads = numThreads;
+  aggregation.inputSet = std::make_pair("myData", "mySet");
+  aggregation.inputClears = inputClears;
+  aggregation.outputVersion = outputVersion;
+  aggregation.canMerge = true;
+
+  return aggregation;
+}
+
+TEST(IncrementalAggregationsTest, MergesIntoTheLastOutput) {
+
+  PDBIncrementalAggregations aggregations;
+  auto set = std::make_pair("myData", "outSet");
+
+  // the first run computes the output from scratch
+  auto current = makeAggregation(0);
+  EXPECT_EQ(aggregations.start(set, current), 1);
+  aggregations.finish(set, 1, true, 2);
+
+  // the next one merges into it
+  current = makeAggregation(2);
+  EXPECT_EQ(aggregations.start(set, current), 2);
+  aggregations.finish(set, 2, true, 4);
+
+  // other sets don't matter
+  auto other = makeAggregation(0);
+  EXPECT_EQ(aggregations.start(std::make_pair("myData", "otherSet"), other), 1);
+}
+
+TEST(IncrementalAggregationsTest, RecomputesWhenTheOutputIsStale) {
+
+  PDBIncrementalAggregations aggregations;
+  auto set = std::make_pair("myData", "outSet");
+
+  auto current = makeAggregation(0);
+  EXPECT_EQ(aggregations.start(set, current), 1);
+  aggregations.finish(set, 1, true, 2);
+
+  // somebody wrote to the output
+  current = makeAggregation(3);
+  EXPECT_EQ(aggregations.start(set, current), 1);
+  aggregations.finish(set, 1, true, 5);
+
+  // the input was cleared
+  current = makeAggregation(5, 4, 1);
+  EXPECT_EQ(aggregations.start(set, current), 1);
+  aggregations.finish(set, 1, true, 7);
+
+  // the aggregation can not merge
+  current = makeAggregation(7, 4, 1);
+  current.canMerge = false;
+  EXPECT_EQ(aggregations.start(set, current), 1);
+  aggregations.finish(set, 1, true, 9);
+
+  // it can again, but the workers did not keep track of what the last output was made from
+  current = makeAggregation(9, 4, 1);
+  EXPECT_EQ(aggregations.start(set, current), 1);
+  aggregations.finish(set, 1, true, 11);
+
+  current = makeAggregation(11, 4, 1);
+  EXPECT_EQ(aggregations.start(set, current), 2);
+  aggregations.finish(set, 2, true, 13);
+
+  // the scheduler gave it a different share of the threads, the keys would go to different workers
+  current = makeAggregation(13, 8, 1);
+  EXPECT_EQ(aggregations.start(set, current), 1);
+  EXPECT_EQ(current.numThreads, 8);
+}
+
+TEST(IncrementalAggregationsTest, RecomputesAfterAFailure) {
+
+  PDBIncrementalAggregations aggregations;
+  auto set = std::make_pair("myData", "outSet");
+
+  auto current = makeAggregation(0);
+  EXPECT_EQ(aggregations.start(set, current), 1);
+  aggregations.finish(set, 1, true, 2);
+
+  current = makeAggregation(2);
+  EXPECT_EQ(aggregations.start(set, current), 2);
+  aggregations.finish(set, 2, false, 0);
+
+  // finishing it again does nothing
+  aggregations.finish(set, 2, true, 4);
+
+  // we don't know what the workers have so we start over
+  current = makeAggregation(4);
+  EXPECT_EQ(aggregations.start(set, current), 1);
+}
+
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <boost/filesystem.hpp>
+
+#include <PDBServer.h>
+#include <PDBCommunicator.h>
+#include <PDBDistributedStorage.h>
+#include <PDBStorageManagerFrontend.h>
+#include <SimpleRequestResult.h>
+#include <DisReleaseIngestLease.h>
+#include <StoIngestLease.h>
+#include <StoDispatchData.h>
+
+namespace pdb {
+
+namespace fs = boost::filesystem;
+
+/**
+ * This is the mock communicator we provide to the request handlers, it only records the responses
+ */
+class CommunicatorMock : public PDBCommunicator {
+
+public:
+
+  MOCK_METHOD2(sendObject, bool(pdb::Handle<pdb::SimpleRequestResult>& res, std::string& errMsg));
+
+  MOCK_METHOD1(skipBytes, bool(std::string& errMsg));
+};
+
+/**
+ * The requests the manager sends to the workers, it remembers the leases it was asked to revoke
+ */
+class MockLeaseRequests {
+public:
+
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse,
+                          uint64_t leaseID,
+                          const std::string &dbName,
+                          const std::string &setName,
+                          uint64_t timeout,
+                          bool revoke) {
+
+    // remember the revoked lease
+    if(revoke) {
+      revoked.emplace_back(leaseID);
+    }
+
+    // the worker always succeeds
+    const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+    pdb::Handle<pdb::SimpleRequestResult> result = pdb::makeObject<pdb::SimpleRequestResult>(true, "");
+    return processResponse(result);
+  }
+
+  static std::vector<uint64_t> revoked;
+};
+
+std::vector<uint64_t> MockLeaseRequests::revoked;
+
+// makes a communicator that stores the results of the responses in a vector
+std::shared_ptr<CommunicatorMock> makeCommunicator(std::vector<bool> &responses) {
+
+  auto comm = std::make_shared<CommunicatorMock>();
+  ON_CALL(*comm, sendObject(testing::An<pdb::Handle<pdb::SimpleRequestResult> &>(), testing::An<std::string &>())).WillByDefault(testing::Invoke(
+      [&](pdb::Handle<pdb::SimpleRequestResult> &res, std::string &errMsg) {
+        responses.emplace_back(res->getRes().first);
+        return true;
+      }));
+  ON_CALL(*comm, skipBytes(testing::An<std::string &>())).WillByDefault(testing::Return(true));
+  return comm;
+}
+
+// makes a server with a configuration that keeps everything in the directory
+std::shared_ptr<PDBServer> makeServer(const std::string &directory) {
+
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+
+  auto config = std::make_shared<pdb::NodeConfig>();
+  config->rootDirectory = directory;
+  return std::make_shared<PDBServer>(PDBServer::NodeType::FRONTEND, config, std::make_shared<PDBLogger>(directory, "server.log"));
+}
+
+TEST(IngestLeaseTest, WorkerRejectsInvalidLeases) {
+
+  auto server = makeServer("tempIngestLeaseWorker");
+  auto frontend = std::make_shared<PDBStorageManagerFrontend>();
+  server->addFunctionality(frontend);
+
+  // the manager registers a lease and one that has already expired
+  std::vector<bool> responses;
+  auto comm = makeCommunicator(responses);
+  EXPECT_CALL(*comm, sendObject(testing::An<pdb::Handle<pdb::SimpleRequestResult> &>(), testing::An<std::string &>())).Times(4);
+  {
+    const pdb::UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+    pdb::Handle<pdb::StoIngestLease> lease = pdb::makeObject<pdb::StoIngestLease>(42, "db", "set", 3600, false);
+    EXPECT_TRUE(frontend->handleIngestLease(lease, comm).first);
+    pdb::Handle<pdb::StoIngestLease> expired = pdb::makeObject<pdb::StoIngestLease>(43, "db", "set", 0, false);
+    EXPECT_TRUE(frontend->handleIngestLease(expired, comm).first);
+  }
+
+  // only the valid lease for the right set is accepted
+  EXPECT_TRUE(frontend->checkIngestLease(42, "db", "set"));
+  EXPECT_FALSE(frontend->checkIngestLease(41, "db", "set"));
+  EXPECT_FALSE(frontend->checkIngestLease(42, "db", "otherSet"));
+  EXPECT_FALSE(frontend->checkIngestLease(43, "db", "set"));
+
+  // the data sent with a wrong lease is skipped and the client gets an error
+  EXPECT_CALL(*comm, skipBytes(testing::An<std::string &>())).Times(1);
+  {
+    const pdb::UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+    pdb::Handle<pdb::StoDispatchData> data = pdb::makeObject<pdb::StoDispatchData>("db", "set", "Type", 100, true, 41);
+    EXPECT_FALSE((frontend->handleDispatchedData<CommunicatorMock, RequestFactory>(data, comm).first));
+  }
+
+  // once the lease is revoked it is not accepted anymore
+  {
+    const pdb::UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+    pdb::Handle<pdb::StoIngestLease> revoke = pdb::makeObject<pdb::StoIngestLease>(42, "db", "set", 0, true);
+    EXPECT_TRUE(frontend->handleIngestLease(revoke, comm).first);
+  }
+  EXPECT_FALSE(frontend->checkIngestLease(42, "db", "set"));
+
+  // the worker acknowledged the leases and rejected the data
+  EXPECT_EQ(responses, std::vector<bool>({ true, true, false, true }));
+
+  // the frontend stores its metadata through the server when it goes away
+  frontend.reset();
+  server.reset();
+  fs::remove_all("tempIngestLeaseWorker");
+}
+
+TEST(IngestLeaseTest, ExpiredLeaseUnlocksTheSet) {
+
+  auto server = makeServer("tempIngestLeaseExpire");
+  auto storage = std::make_shared<PDBDistributedStorage>();
+  server->addFunctionality(storage);
+
+  // give out a lease, it keeps the set locked for writing
+  {
+    auto setLock = storage->tryUsingSet("db", "set", PDBDistributedStorageSetState::WRITING_DATA);
+    ASSERT_TRUE(setLock->isWriteGranted());
+
+    PDBDistributedStorage::PDBIngestLease lease;
+    lease.dbName = "db";
+    lease.setName = "set";
+    lease.setLock = setLock;
+    lease.expires = std::chrono::steady_clock::now() + std::chrono::seconds(3600);
+    storage->ingestLeases[1] = lease;
+  }
+
+  // while the lease is out the set can not be cleared
+  storage->expireIngestLeases();
+  EXPECT_FALSE(storage->tryUsingSet("db", "set", PDBDistributedStorageSetState::CLEARING_DATA)->isClearGranted());
+
+  // once it expires the lease is dropped and the clear is granted
+  storage->ingestLeases[1].expires = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+  storage->expireIngestLeases();
+  EXPECT_TRUE(storage->ingestLeases.empty());
+  EXPECT_TRUE(storage->tryUsingSet("db", "set", PDBDistributedStorageSetState::CLEARING_DATA)->isClearGranted());
+
+  storage.reset();
+  server.reset();
+  fs::remove_all("tempIngestLeaseExpire");
+}
+
+TEST(IngestLeaseTest, ReleaseTwice) {
+
+  auto server = makeServer("tempIngestLeaseRelease");
+  auto storage = std::make_shared<PDBDistributedStorage>();
+  server->addFunctionality(storage);
+
+  // give out a lease registered with two workers
+  {
+    auto setLock = storage->tryUsingSet("db", "set", PDBDistributedStorageSetState::WRITING_DATA);
+    ASSERT_TRUE(setLock->isWriteGranted());
+
+    PDBDistributedStorage::PDBIngestLease lease;
+    lease.dbName = "db";
+    lease.setName = "set";
+    lease.setLock = setLock;
+    lease.nodes = { { "worker1", 8109 }, { "worker2", 8109 } };
+    lease.expires = std::chrono::steady_clock::now() + std::chrono::seconds(3600);
+    storage->ingestLeases[7] = lease;
+  }
+
+  std::vector<bool> responses;
+  auto comm = makeCommunicator(responses);
+  EXPECT_CALL(*comm, sendObject(testing::An<pdb::Handle<pdb::SimpleRequestResult> &>(), testing::An<std::string &>())).Times(2);
+  MockLeaseRequests::revoked.clear();
+
+  const pdb::UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+  pdb::Handle<pdb::DisReleaseIngestLease> request = pdb::makeObject<pdb::DisReleaseIngestLease>(7);
+
+  // the first release revokes the lease on both workers and unlocks the set
+  EXPECT_TRUE((storage->handleReleaseIngestLease<CommunicatorMock, MockLeaseRequests>(request, comm).first));
+  EXPECT_EQ(MockLeaseRequests::revoked, std::vector<uint64_t>({ 7, 7 }));
+  EXPECT_TRUE(storage->tryUsingSet("db", "set", PDBDistributedStorageSetState::CLEARING_DATA)->isClearGranted());
+
+  // the second one fails without talking to the workers
+  EXPECT_FALSE((storage->handleReleaseIngestLease<CommunicatorMock, MockLeaseRequests>(request, comm).first));
+  EXPECT_EQ(MockLeaseRequests::revoked.size(), 2);
+
+  // the client got an ack and then an error
+  EXPECT_EQ(responses, std::vector<bool>({ true, false }));
+
+  storage.reset();
+  server.reset();
+  fs::remove_all("tempIngestLeaseRelease");
+}
+
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <map>
+#include <fstream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <PDBLogger.h>
+#include <PDBMetrics.h>
+
+namespace pdb {
+
+// reads the lines of a log file
+std::vector<std::string> readLog(const std::string &fName) {
+
+  std::vector<std::string> lines;
+  std::ifstream in("logs/" + fName);
+  for (std::string line; std::getline(in, line);) {
+    lines.emplace_back(line);
+  }
+  return lines;
+}
+
+TEST(LoggerTest, LevelsAndThreads) {
+
+  std::remove("logs/testLoggerLevels.log");
+  auto logger = std::make_shared<PDBLogger>("testLoggerLevels.log");
+  logger->setLoglevel(INFO);
+
+  // the message of a disabled level is never built
+  int built = 0;
+  auto message = [&built]() { built++; return std::string("debug"); };
+  PDB_LOG_DEBUG(logger, message());
+  PDB_LOG_INFO(logger, message());
+  EXPECT_EQ(built, 1);
+
+  // every thread logs a few lines
+  const int numThreads = 4;
+  const int numLines = 200;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&logger, t]() {
+      for (int i = 0; i < numLines; ++i) {
+        PDB_LOG_INFO(logger, std::to_string(t) + " " + std::to_string(i));
+        logger->trace("filtered");
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // write them out
+  PDBLogger::flush();
+  auto lines = readLog("testLoggerLevels.log");
+  EXPECT_EQ(lines.size(), numThreads * numLines + 1);
+
+  // the lines of a thread are in order
+  std::vector<int> last(numThreads, -1);
+  for (size_t i = 1; i < lines.size(); ++i) {
+    auto pos = lines[i].find("[INFO] ");
+    ASSERT_NE(pos, std::string::npos);
+    int t, line;
+    ASSERT_EQ(sscanf(lines[i].c_str() + pos, "[INFO] %d %d", &t, &line), 2);
+    EXPECT_EQ(line, last[t] + 1);
+    last[t] = line;
+  }
+}
+
+TEST(LoggerTest, DropsWhenTheBufferIsFull) {
+
+  std::remove("logs/testLoggerDrops.log");
+  auto logger = std::make_shared<PDBLogger>("testLoggerDrops.log");
+  logger->setLoglevel(INFO);
+
+  auto dropped = PDBLogger::getNumDropped();
+  auto droppedMetric = PDBMetrics::get().loggerDropped.get();
+
+  // log more than the buffer can hold as fast as we can
+  const size_t numLines = PDBLogger::BUFFER_SIZE * 8;
+  std::thread thread([&logger, numLines]() {
+    for (size_t i = 0; i < numLines; ++i) {
+      logger->info("line");
+    }
+  });
+  thread.join();
+
+  // every line was either written or dropped
+  PDBLogger::flush();
+  auto numDropped = PDBLogger::getNumDropped() - dropped;
+  EXPECT_EQ(readLog("testLoggerDrops.log").size() + numDropped, numLines);
+  EXPECT_EQ(PDBMetrics::get().loggerDropped.get() - droppedMetric, numDropped);
+}
+
+TEST(LoggerTest, ForkDoesNotWriteTheLinesTwice) {
+
+  std::remove("logs/testLoggerFork.log");
+  auto logger = std::make_shared<PDBLogger>("testLoggerFork.log");
+  logger->setLoglevel(INFO);
+
+  // log some lines and fork while some of them could still be buffered
+  const int numLines = 200;
+  for (int i = 0; i < numLines; ++i) {
+    logger->info(std::to_string(i));
+  }
+  auto pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+
+    // the child writes out what it has and logs a line of its own
+    logger->info("child");
+    PDBLogger::flush();
+    _exit(0);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+  PDBLogger::flush();
+
+  // every line is there once
+  std::map<std::string, int> counts;
+  for (auto &line : readLog("testLoggerFork.log")) {
+    counts[line.substr(line.find("[INFO] ") + 7)]++;
+  }
+  EXPECT_EQ(counts.size(), numLines + 1);
+  for (auto &count : counts) {
+    EXPECT_EQ(count.second, 1) << count.first;
+  }
+}
+
+}
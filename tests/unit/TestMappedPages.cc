@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <fstream>
+#include <PDBSetPageSet.h>
+#include <PDBBufferManagerImpl.h>
+#include <PDBMappedFiles.h>
+
+namespace pdb {
+
+namespace {
+
+// fills a page with values that depend on the page number
+void writePage(void *bytes, size_t numBytes, uint64_t pageNum) {
+  auto values = (uint64_t *) bytes;
+  for(size_t i = 0; i < numBytes / sizeof(uint64_t); ++i) {
+    values[i] = pageNum * 1000000 + i;
+  }
+}
+
+// checks the values on a page
+bool checkPage(void *bytes, size_t numBytes, uint64_t pageNum) {
+  auto values = (uint64_t *) bytes;
+  for(size_t i = 0; i < numBytes / sizeof(uint64_t); ++i) {
+    if(values[i] != pageNum * 1000000 + i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// writes the pages of a set and shuts down the buffer manager so they all end up on disk
+void writeSet(size_t pageSize, uint64_t numPages) {
+
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", pageSize, 4, "metadata", ".");
+
+  auto set = make_shared<PDBSet>("db", "set");
+  for(uint64_t i = 0; i < numPages; ++i) {
+    auto page = myMgr.getPage(set, i);
+    writePage(page->getBytes(), pageSize, i);
+  }
+}
+
+}
+
+TEST(MappedPagesTest, GetMappedPage) {
+
+  const uint64_t numPages = 10;
+  const size_t pageSize = 1024 * 1024;
+  writeSet(pageSize, numPages);
+
+  // start from the metadata, nothing is buffered
+  auto myMgr = std::make_shared<PDBBufferManagerImpl>();
+  myMgr->initialize("metadata");
+  auto set = make_shared<PDBSet>("db", "set");
+
+  // the pages point into the file and have the right bytes
+  std::vector<PDBPageHandle> pages;
+  for(uint64_t i = 0; i < numPages; ++i) {
+    auto page = myMgr->getMappedPage(set, i);
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(page->isMapped());
+    EXPECT_TRUE(page->isPinned());
+    EXPECT_FALSE(page->isDirty());
+    EXPECT_EQ(page->getSize(), pageSize);
+    EXPECT_TRUE(checkPage(page->getBytes(), pageSize, i));
+    pages.emplace_back(page);
+  }
+  EXPECT_EQ(myMgr->getMappedFiles().getNumMappedPages(), numPages);
+  EXPECT_EQ(myMgr->getMappedFiles().getNumMappedBytes(), numPages * pageSize);
+
+  // pinning and unpinning is only counted
+  auto &mappedFiles = myMgr->getMappedFiles();
+  EXPECT_EQ(mappedFiles.getNumPinnedPages(), numPages);
+  pages.front()->unpin();
+  EXPECT_FALSE(pages.front()->isPinned());
+  EXPECT_EQ(mappedFiles.getNumPinnedPages(), numPages - 1);
+  pages.front()->repin();
+  EXPECT_TRUE(pages.front()->isPinned());
+  EXPECT_TRUE(checkPage(pages.front()->getBytes(), pageSize, 0));
+  EXPECT_EQ(mappedFiles.getNumPinnedPages(), numPages);
+
+  // dropping the handles unpins them
+  pages.clear();
+  EXPECT_EQ(mappedFiles.getNumPinnedPages(), 0);
+
+  // a buffered page is not mapped
+  {
+    auto page = myMgr->getPage(set, 3);
+    auto mapped = myMgr->getMappedPage(set, 3);
+    EXPECT_FALSE(mapped->isMapped());
+    EXPECT_EQ(mapped->getBytes(), page->getBytes());
+  }
+
+  // neither is a page that was never written
+  auto page = myMgr->getMappedPage(set, numPages);
+  EXPECT_FALSE(page->isMapped());
+}
+
+TEST(MappedPagesTest, SetPageSet) {
+
+  const uint64_t numPages = 10;
+  const size_t pageSize = 1024 * 1024;
+  writeSet(pageSize, numPages);
+
+  auto myMgr = std::make_shared<PDBBufferManagerImpl>();
+  myMgr->initialize("metadata");
+
+  // scan the set from the mapped file
+  std::vector<uint64_t> pages;
+  for(uint64_t i = 0; i < numPages; ++i) {
+    pages.emplace_back(i);
+  }
+  auto pageSet = std::make_shared<PDBSetPageSet>("db", "set", pages, myMgr, 2, true);
+  for(uint64_t i = 0; i < numPages; ++i) {
+
+    auto page = pageSet->getNextPage(0);
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(page->isMapped());
+    EXPECT_TRUE(checkPage(page->getBytes(), pageSize, i));
+  }
+  EXPECT_EQ(pageSet->getNextPage(0), nullptr);
+
+  // nothing went through the buffer pool, so scanning it again without mapping reads the same bytes
+  pageSet = std::make_shared<PDBSetPageSet>("db", "set", pages, myMgr, 2);
+  for(uint64_t i = 0; i < numPages; ++i) {
+
+    auto page = pageSet->getNextPage(0);
+    ASSERT_NE(page, nullptr);
+    EXPECT_FALSE(page->isMapped());
+    EXPECT_TRUE(checkPage(page->getBytes(), pageSize, i));
+  }
+}
+
+TEST(MappedPagesTest, GrowingFile) {
+
+  const size_t pageSize = 1024 * 1024;
+  std::vector<char> page(pageSize);
+
+  // write the first page of the file
+  const std::string path = "tempMappedFile";
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    writePage(page.data(), pageSize, 0);
+    out.write(page.data(), pageSize);
+  }
+
+  PDBMappedFile file(path);
+  ASSERT_TRUE(file.isOpen());
+  auto first = file.getBytes(0, pageSize);
+  ASSERT_NE(first, nullptr);
+  EXPECT_TRUE(checkPage(first, pageSize, 0));
+
+  // the second page is not there yet
+  EXPECT_EQ(file.getBytes(pageSize, pageSize), nullptr);
+
+  // grow the file, the second page shows up in the chunk we already mapped
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    writePage(page.data(), pageSize, 1);
+    out.write(page.data(), pageSize);
+  }
+  auto second = file.getBytes(pageSize, pageSize);
+  ASSERT_NE(second, nullptr);
+  EXPECT_TRUE(checkPage(second, pageSize, 1));
+  EXPECT_EQ(file.getNumMappings(), 1);
+
+  // the first page is still where it was
+  EXPECT_EQ(file.getBytes(0, pageSize), first);
+  EXPECT_TRUE(checkPage(first, pageSize, 0));
+  EXPECT_EQ(file.getNumMappings(), 1);
+
+  remove(path.c_str());
+}
+
+}
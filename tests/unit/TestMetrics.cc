@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <random>
+#include <limits>
+#include <PDBMetrics.h>
+
+namespace pdb {
+
+TEST(MetricsTest, HistogramBuckets) {
+
+  // every bucket ends right before the next one starts
+  for (size_t bucket = 0; bucket + 1 < PDBHistogram::NUM_BUCKETS; ++bucket) {
+    EXPECT_EQ(PDBHistogram::getBucket(PDBHistogram::getBucketMax(bucket)), bucket);
+    EXPECT_EQ(PDBHistogram::getBucket(PDBHistogram::getBucketMax(bucket) + 1), bucket + 1);
+  }
+
+  // the last bucket ends with the largest value
+  EXPECT_EQ(PDBHistogram::getBucket(std::numeric_limits<uint64_t>::max()), PDBHistogram::NUM_BUCKETS - 1);
+  EXPECT_EQ(PDBHistogram::getBucketMax(PDBHistogram::NUM_BUCKETS - 1), std::numeric_limits<uint64_t>::max());
+
+  // a value is at most 1/16 off from the end of its bucket
+  std::mt19937_64 gen(7);
+  for (int i = 0; i < 100000; ++i) {
+    auto value = gen() >> (gen() % 64);
+    auto max = PDBHistogram::getBucketMax(PDBHistogram::getBucket(value));
+    EXPECT_GE(max, value);
+    EXPECT_LE((double) (max - value), (double) value / 16.0);
+  }
+}
+
+TEST(MetricsTest, HistogramQuantiles) {
+
+  // nothing recorded by the tests uses this one
+  auto &histogram = PDBMetrics::get().serverRequestTime;
+  EXPECT_EQ(histogram.getQuantile(0.5), 0);
+
+  // record 1 to 10000 from a few threads
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&histogram, t]() {
+      for (uint64_t value = t + 1; value <= 10000; value += 4) {
+        histogram.record(value);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(histogram.getCount(), 10000);
+  EXPECT_EQ(histogram.getSum(), 10000ul * 10001ul / 2);
+  EXPECT_EQ(histogram.getMax(), 10000);
+
+  // the quantiles are within the precision of the buckets
+  for (auto quantile : { 0.5, 0.9, 0.99 }) {
+    auto expected = quantile * 10000;
+    auto value = (double) histogram.getQuantile(quantile);
+    EXPECT_GE(value, expected);
+    EXPECT_LE(value, expected * (1.0 + 1.0 / 16.0));
+  }
+  EXPECT_EQ(histogram.getQuantile(1.0), 10000);
+}
+
+TEST(MetricsTest, CountersAndPrometheusText) {
+
+  auto &metrics = PDBMetrics::get();
+
+  // update a counter from a few threads
+  auto before = metrics.shuffledBytes.get();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&metrics]() {
+      for (int i = 0; i < 1000; ++i) {
+        metrics.shuffledBytes.inc(2);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(metrics.shuffledBytes.get() - before, 16000);
+
+  // a gauge goes up and down
+  metrics.pageQueuePages.inc(5);
+  metrics.pageQueuePages.dec(2);
+  EXPECT_EQ(metrics.pageQueuePages.get(), 3);
+  metrics.pageQueuePages.set(0);
+
+  // sample the metrics of two processes, the one with the wrong number of values is skipped
+  auto frontend = metrics.sample();
+  EXPECT_EQ(frontend.size(), metrics.getNumValues());
+  auto backend = std::vector<double>(frontend.size(), 0.0);
+  auto text = metrics.toPrometheus({ { "frontend", frontend }, { "backend", backend }, { "broken", { 1.0 } } });
+
+  EXPECT_NE(text.find("# TYPE pdb_shuffle_sent_bytes_total counter\n"), std::string::npos);
+  EXPECT_NE(text.find("pdb_shuffle_sent_bytes_total{process=\"frontend\"} " + std::to_string(metrics.shuffledBytes.get()) + "\n"), std::string::npos);
+  EXPECT_NE(text.find("pdb_shuffle_sent_bytes_total{process=\"backend\"} 0\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE pdb_page_queue_pages gauge\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE pdb_server_request_seconds summary\n"), std::string::npos);
+  EXPECT_NE(text.find("pdb_server_request_seconds{process=\"backend\",quantile=\"0.99\"} 0\n"), std::string::npos);
+  EXPECT_NE(text.find("pdb_server_request_seconds_count{process=\"backend\"} 0\n"), std::string::npos);
+  EXPECT_EQ(text.find("broken"), std::string::npos);
+}
+
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <set>
+#include <PDBSetPageSet.h>
+#include <PDBPageLookahead.h>
+
+#include "PDBBufferManagerImpl.h"
+#include "PDBPageHandle.h"
+#include "PDBSet.h"
+
+namespace pdb {
+
+// the workers the lookahead runs on, there can only be one worker queue in a process
+static PDBWorkerQueuePtr getWorkers() {
+  static auto workers = make_shared<PDBWorkerQueue>(make_shared<PDBLogger>("worker.log"), 4);
+  return workers;
+}
+
+TEST(PageLookaheadTest, Test1) {
+
+  const uint64_t numPages = 100;
+
+  // create the buffer manager
+  auto myMgr = std::make_shared<PDBBufferManagerImpl>();
+  myMgr->initialize("tempDSFSD", 64, 16, "metadata", ".");
+
+  // write the page number to each page of the set
+  auto set = make_shared<PDBSet>("db", "set");
+  std::vector<uint64_t> pages;
+  for(uint64_t i = 0; i < numPages; ++i) {
+
+    auto page = myMgr->getPage(set, i);
+    *((uint64_t*) page->getBytes()) = i;
+    page->unpin();
+
+    pages.emplace_back(i);
+  }
+
+  // try it with different depths
+  for(size_t depth = 0; depth < 4; ++depth) {
+
+    // make the page set
+    auto pageSet = std::make_shared<PDBSetPageSet>("db", "set", pages, myMgr, depth);
+    pageSet->setLookaheadWorkers(getWorkers());
+    EXPECT_EQ(pageSet->getLookaheadDepth(), depth);
+
+    // go through all the pages
+    std::set<uint64_t> seen;
+    {
+      PDBPageLookahead lookahead(pageSet, 0);
+
+      PDBPageHandle page;
+      while((page = lookahead.getNextPage()) != nullptr) {
+
+        // the page has to be pinned and has to have the right value
+        EXPECT_TRUE(page->isPinned());
+        EXPECT_EQ(*((uint64_t*) page->getBytes()), page->whichPage());
+        seen.insert(page->whichPage());
+
+        page->unpin();
+      }
+    }
+
+    // we must have seen every page exactly once
+    EXPECT_EQ(seen.size(), numPages);
+  }
+}
+
+TEST(PageLookaheadTest, Test2) {
+
+  const uint64_t numPages = 10;
+
+  // create the buffer manager
+  auto myMgr = std::make_shared<PDBBufferManagerImpl>();
+  myMgr->initialize("tempDSFSD", 64, 16, "metadata", ".");
+
+  // make the pages
+  auto set = make_shared<PDBSet>("db", "set");
+  std::vector<uint64_t> pages;
+  for(uint64_t i = 0; i < numPages; ++i) {
+    myMgr->getPage(set, i)->unpin();
+    pages.emplace_back(i);
+  }
+
+  // make the page set with a lookahead greater than the number of pages
+  auto pageSet = std::make_shared<PDBSetPageSet>("db", "set", pages, myMgr, 2 * numPages);
+  pageSet->setLookaheadWorkers(getWorkers());
+  EXPECT_EQ(pageSet->getLookaheadDepth(), numPages);
+
+  // read only one page and destroy the lookahead, this has to release the prefetched pages
+  {
+    PDBPageLookahead lookahead(pageSet, 0);
+    auto page = lookahead.getNextPage();
+    EXPECT_NE(page, nullptr);
+    page->unpin();
+  }
+
+  // reset the page set and make sure we can go through all the pages again
+  pageSet->resetPageSet();
+
+  uint64_t count = 0;
+  PDBPageLookahead lookahead(pageSet, 0);
+  PDBPageHandle page;
+  while((page = lookahead.getNextPage()) != nullptr) {
+    page->unpin();
+    count++;
+  }
+
+  EXPECT_EQ(count, numPages);
+}
+
+}
@@ -0,0 +1,139 @@
+#include <PDBBufferManagerBackEnd.h>
+#include <PDBSetPageSet.h>
+#include <PDBPageLookahead.h>
+#include <set>
+#include "TestBufferManagerBackend.h"
+
+namespace pdb {
+
+// this test checks that the lookahead requests the pages of the backend on a worker with its own allocator
+TEST(PageLookaheadBackendTest, Test1) {
+
+  const uint64_t numPages = 100;
+  const size_t pageSize = 64;
+
+  // allocate memory and write the page number to each page
+  std::unique_ptr<char[]> memory(new char[numPages * pageSize]);
+  for(uint64_t i = 0; i < numPages; ++i) {
+    *((uint64_t*) (memory.get() + i * pageSize)) = i;
+  }
+
+  // make the shared memory object
+  PDBSharedMemory sharedMemory{};
+  sharedMemory.pageSize = pageSize;
+  sharedMemory.numPages = numPages;
+  sharedMemory.memory = memory.get();
+
+  auto myMgr = std::make_shared<pdb::PDBBufferManagerBackEnd<MockRequestFactory>>(sharedMemory);
+
+  MockRequestFactory::_requestFactory = std::make_shared<MockRequestFactoryImpl>();
+
+  MockServer server;
+  ON_CALL(server, getConfiguration).WillByDefault(testing::Invoke(
+      [&]() {
+        return std::make_shared<pdb::NodeConfig>();
+      }));
+
+  EXPECT_CALL(server, getConfiguration).Times(testing::AnyNumber());
+
+  myMgr->recordServer(server);
+
+  // how many pages were requested on the main allocator
+  std::atomic<uint64_t> onMainAllocator;
+  onMainAllocator = 0;
+
+  /// 1. Mock the get page for the set
+
+  ON_CALL(*MockRequestFactory::_requestFactory, getPage).WillByDefault(testing::Invoke(
+      [&](pdb::PDBLoggerPtr &myLogger,
+          int port,
+          const std::string &address,
+          pdb::PDBPageHandle onErr,
+          size_t bytesForRequest,
+          const std::function<pdb::PDBPageHandle(pdb::Handle<pdb::BufGetPageResult>)> &processResponse,
+          pdb::PDBSetPtr set,
+          uint64_t pageNum) {
+
+        // the request is allocated with the allocator of the thread, it must not be the shared one
+        if(&getAllocator() == mainAllocatorPtr) {
+          onMainAllocator++;
+        }
+
+        const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+
+        // check the page
+        EXPECT_LT(pageNum, numPages);
+        EXPECT_EQ(set->getSetName(), "set");
+        EXPECT_EQ(set->getDBName(), "db");
+
+        // make the page
+        pdb::Handle<pdb::BufGetPageResult> returnPageRequest = pdb::makeObject<pdb::BufGetPageResult>(pageNum * pageSize, pageNum, false, false, -1, pageSize, set->getSetName(), set->getDBName());
+
+        // return true since we assume this succeeded
+        return processResponse(returnPageRequest);
+      }
+  ));
+
+  EXPECT_CALL(*MockRequestFactory::_requestFactory, getPage).Times(numPages);
+
+  /// 2. Mock the unpin and the return of the page, the reader does those on its own thread
+
+  ON_CALL(*MockRequestFactory::_requestFactory, unpinPage).WillByDefault(testing::Invoke(
+      [&](pdb::PDBLoggerPtr &myLogger, int port, const std::string &address, bool onErr, size_t bytesForRequest,
+          const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse, PDBSetPtr &set, size_t pageNum, bool isDirty) {
+
+        const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+        pdb::Handle<pdb::SimpleRequestResult> returnPageRequest = pdb::makeObject<pdb::SimpleRequestResult>(true, "");
+        return processResponse(returnPageRequest);
+      }
+  ));
+
+  EXPECT_CALL(*MockRequestFactory::_requestFactory, unpinPage).Times(testing::AnyNumber());
+
+  ON_CALL(*MockRequestFactory::_requestFactory, returnPage).WillByDefault(testing::Invoke(
+      [&](pdb::PDBLoggerPtr &myLogger, int port, const std::string &address, bool onErr,
+          size_t bytesForRequest, const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse,
+          std::string setName, std::string dbName, size_t pageNum, bool isDirty) {
+
+        const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+        pdb::Handle<pdb::SimpleRequestResult> returnPageRequest = pdb::makeObject<pdb::SimpleRequestResult>(true, "");
+        return processResponse(returnPageRequest);
+      }
+  ));
+
+  EXPECT_CALL(*MockRequestFactory::_requestFactory, returnPage).Times(testing::AnyNumber());
+
+  /// 3. Read the set through the lookahead
+
+  auto workers = make_shared<PDBWorkerQueue>(make_shared<PDBLogger>("worker.log"), 2);
+
+  std::vector<uint64_t> pages;
+  for(uint64_t i = 0; i < numPages; ++i) {
+    pages.emplace_back(i);
+  }
+
+  auto pageSet = std::make_shared<PDBSetPageSet>("db", "set", pages, myMgr, 2);
+  pageSet->setLookaheadWorkers(workers);
+
+  std::set<uint64_t> seen;
+  {
+    PDBPageLookahead lookahead(pageSet, 0);
+
+    PDBPageHandle page;
+    while((page = lookahead.getNextPage()) != nullptr) {
+
+      // the page has to be pinned and has to have the right value
+      EXPECT_TRUE(page->isPinned());
+      EXPECT_EQ(*((uint64_t*) page->getBytes()), page->whichPage());
+      seen.insert(page->whichPage());
+
+      page->unpin();
+    }
+  }
+
+  // we must have seen every page exactly once and none of them was requested on the main allocator
+  EXPECT_EQ(seen.size(), numPages);
+  EXPECT_EQ(onMainAllocator, 0);
+}
+
+}
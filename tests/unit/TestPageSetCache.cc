@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <PDBPageSetCache.h>
+
+namespace pdb {
+
+// makes a page set computed from the given set
+static PDBCachedPageSet makePageSet(const std::string &signature, size_t id, size_t size, uint64_t version = 1) {
+
+  PDBCachedPageSet pageSet;
+  pageSet.signature = signature;
+  pageSet.pageSet = std::make_pair(id, "intermediate");
+  pageSet.sets[std::make_pair("myData", "mySet")] = version;
+  pageSet.size = size;
+
+  return pageSet;
+}
+
+TEST(PageSetCacheTest, UsesOneAtATime) {
+
+  PDBPageSetCache cache(100);
+  EXPECT_TRUE(cache.add(makePageSet("A", 1, 10)).empty());
+
+  // we don't have it
+  PDBCachedPageSet pageSet;
+  EXPECT_FALSE(cache.use("B", pageSet));
+
+  // we have it
+  EXPECT_TRUE(cache.use("A", pageSet));
+  EXPECT_EQ(pageSet.pageSet.first, 1);
+
+  // somebody is using it
+  EXPECT_FALSE(cache.use("A", pageSet));
+
+  // they are done
+  cache.release("A");
+  EXPECT_TRUE(cache.use("A", pageSet));
+}
+
+TEST(PageSetCacheTest, EvictsTheLeastRecentlyUsed) {
+
+  PDBPageSetCache cache(30);
+  cache.add(makePageSet("A", 1, 10));
+  cache.add(makePageSet("B", 2, 10));
+  cache.add(makePageSet("C", 3, 10));
+
+  // A was used last so B is the one that goes
+  PDBCachedPageSet pageSet;
+  EXPECT_TRUE(cache.use("A", pageSet));
+  cache.release("A");
+
+  auto removed = cache.add(makePageSet("D", 4, 10));
+  ASSERT_EQ(removed.size(), 1);
+  EXPECT_EQ(removed.front().first, 2);
+  EXPECT_EQ(cache.getSize(), 30);
+
+  // a page set that is used is not removed, so if everything is used the new one is not kept
+  EXPECT_TRUE(cache.use("A", pageSet));
+  EXPECT_TRUE(cache.use("C", pageSet));
+  EXPECT_TRUE(cache.use("D", pageSet));
+  removed = cache.add(makePageSet("E", 5, 10));
+  ASSERT_EQ(removed.size(), 1);
+  EXPECT_EQ(removed.front().first, 5);
+
+  // one that can never fit is not kept either
+  removed = cache.add(makePageSet("F", 6, 40));
+  ASSERT_EQ(removed.size(), 1);
+  EXPECT_EQ(removed.front().first, 6);
+  EXPECT_EQ(cache.getNumPageSets(), 3);
+}
+
+TEST(PageSetCacheTest, InvalidatesOldVersions) {
+
+  PDBPageSetCache cache(100);
+  cache.add(makePageSet("A", 1, 10, 1));
+  cache.add(makePageSet("B", 2, 10, 2));
+
+  // the set was written to so A was computed from an old version
+  auto removed = cache.invalidate("myData", "mySet", 2);
+  ASSERT_EQ(removed.size(), 1);
+  EXPECT_EQ(removed.front().first, 1);
+  EXPECT_EQ(cache.getNumPageSets(), 1);
+  EXPECT_EQ(cache.getSize(), 10);
+
+  // other sets don't matter
+  EXPECT_TRUE(cache.invalidate("myData", "otherSet", 5).empty());
+}
+
+}
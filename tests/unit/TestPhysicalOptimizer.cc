@@ -78,6 +78,11 @@ TEST(TestPhysicalOptimizer, TestAggregation) {
   // init the optimizer
   pdb::PDBPhysicalOptimizer optimizer(compID, tcapString, catalogClient, logger);
 
+  // the computation scans just the input set
+  EXPECT_EQ(optimizer.getInputSize(), 10);
+  EXPECT_EQ(optimizer.getInputSets().size(), 1);
+  EXPECT_EQ(optimizer.getInputSets()[0], std::make_pair(std::string("by8_db"), std::string("input_set")));
+
   // we should have one source so we should be able to generate an algorithm
   EXPECT_TRUE(optimizer.hasAlgorithmToRun());
 
@@ -577,6 +582,130 @@ TEST(TestPhysicalOptimizer, TestJoin2) {
 }
 
 
+TEST(TestPhysicalOptimizer, TestCoPartitionedJoin) {
+
+  // 1MB for algorithm and stuff
+  const pdb::UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+
+  // setup the input parameters
+  uint64_t compID = 99;
+  pdb::String tcapString =
+      "A(a) <= SCAN ('myData', 'mySetA', 'SetScanner_0')\n"
+      "B(b) <= SCAN ('myData', 'mySetB', 'SetScanner_1')\n"
+      "A_extracted_value(a,self_0_2Extracted) <= APPLY (A(a), A(a), 'JoinComp_2', 'self_0', [('lambdaType', 'self')])\n"
+      "AHashed(a,a_value_for_hashed) <= HASHLEFT (A_extracted_value(self_0_2Extracted), A_extracted_value(a), 'JoinComp_2', '==_2', [])\n"
+      "B_extracted_value(b,b_value_for_hash) <= APPLY (B(b), B(b), 'JoinComp_2', 'attAccess_1', [('attName', 'myInt'), ('attTypeName', 'int'), ('inputTypeName', 'pdb::StringIntPair'), ('lambdaType', 'attAccess')])\n"
+      "BHashedOnA(b,b_value_for_hashed) <= HASHRIGHT (B_extracted_value(b_value_for_hash), B_extracted_value(b), 'JoinComp_2', '==_2', [])\n"
+      "\n"
+      "/* Join ( a ) and ( b ) */\n"
+      "AandBJoined(a, b) <= JOIN (AHashed(a_value_for_hashed), AHashed(a), BHashedOnA(b_value_for_hashed), BHashedOnA(b), 'JoinComp_2')\n"
+      "AandBJoined_Projection (nativ_3_2OutFor) <= APPLY (AandBJoined(a,b), AandBJoined(), 'JoinComp_2', 'native_lambda_3', [('lambdaType', 'native_lambda')])\n"
+      "out( ) <= OUTPUT ( AandBJoined_Projection ( nativ_3_2OutFor ), 'outSet', 'myData', 'SetWriter_3')";
+
+  // make a logger
+  auto logger = make_shared<pdb::PDBLogger>("log.out");
+
+  // set the join threshold so we would otherwise do a shuffle join
+  PDBJoinPhysicalNode::SHUFFLE_JOIN_THRASHOLD = 0;
+
+  // make the mock client, both sets are hash partitioned in the same group on the join key
+  auto catalogClient = std::make_shared<MockCatalog>();
+  ON_CALL(*catalogClient,
+          getSet(testing::An<const std::string &>(),
+                 testing::An<const std::string &>(),
+                 testing::An<std::string &>())).WillByDefault(testing::Invoke(
+      [&](const std::string &dbName, const std::string &setName, std::string &errMsg) {
+        auto set = std::make_shared<pdb::PDBCatalogSet>("myData", setName, "Nothing", std::numeric_limits<size_t>::max(), PDB_CATALOG_SET_NO_CONTAINER);
+        set->setPartitioning(PDB_CATALOG_SET_HASH_PARTITIONING, 16, setName == "mySetA" ? "self" : "myInt", "group", "");
+        set->partitionNodes = "localhost:8109,localhost:8110";
+        return set;
+      }));
+
+  EXPECT_CALL(*catalogClient, getSet).Times(testing::Exactly(2));
+
+  // init the optimizer
+  pdb::PDBPhysicalOptimizer optimizer(compID, tcapString, catalogClient, logger);
+
+  // both sides are hashed, but nothing is shuffled since the records are already on the right node
+  EXPECT_TRUE(optimizer.hasAlgorithmToRun());
+  Handle<pdb::PDBShuffleForJoinAlgorithm> shuffleB = unsafeCast<pdb::PDBShuffleForJoinAlgorithm>(optimizer.getNextAlgorithm());
+  EXPECT_EQ(shuffleB->getAlgorithmType(), ShuffleForJoin);
+  EXPECT_TRUE(shuffleB->local);
+
+  EXPECT_TRUE(optimizer.hasAlgorithmToRun());
+  Handle<pdb::PDBShuffleForJoinAlgorithm> shuffleA = unsafeCast<pdb::PDBShuffleForJoinAlgorithm>(optimizer.getNextAlgorithm());
+  EXPECT_EQ(shuffleA->getAlgorithmType(), ShuffleForJoin);
+  EXPECT_TRUE(shuffleA->local);
+
+  // if the partitions of the sets were placed on different nodes the join has to shuffle
+  auto movedCatalogClient = std::make_shared<MockCatalog>();
+  ON_CALL(*movedCatalogClient,
+          getSet(testing::An<const std::string &>(),
+                 testing::An<const std::string &>(),
+                 testing::An<std::string &>())).WillByDefault(testing::Invoke(
+      [&](const std::string &dbName, const std::string &setName, std::string &errMsg) {
+        auto set = std::make_shared<pdb::PDBCatalogSet>("myData", setName, "Nothing", std::numeric_limits<size_t>::max(), PDB_CATALOG_SET_NO_CONTAINER);
+        set->setPartitioning(PDB_CATALOG_SET_HASH_PARTITIONING, 16, setName == "mySetA" ? "self" : "myInt", "group", "");
+        set->partitionNodes = setName == "mySetA" ? "localhost:8109,localhost:8110" : "localhost:8110,localhost:8109";
+        return set;
+      }));
+
+  EXPECT_CALL(*movedCatalogClient, getSet).Times(testing::Exactly(2));
+
+  pdb::PDBPhysicalOptimizer movedOptimizer(compID, tcapString, movedCatalogClient, logger);
+
+  EXPECT_TRUE(movedOptimizer.hasAlgorithmToRun());
+  Handle<pdb::PDBShuffleForJoinAlgorithm> movedShuffleB = unsafeCast<pdb::PDBShuffleForJoinAlgorithm>(movedOptimizer.getNextAlgorithm());
+  EXPECT_EQ(movedShuffleB->getAlgorithmType(), ShuffleForJoin);
+  EXPECT_FALSE(movedShuffleB->local);
+}
+
+TEST(TestPhysicalOptimizer, TestCoPartitionedAggregation) {
+
+  // 1MB for algorithm and stuff
+  const pdb::UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+
+  // setup the input parameters
+  uint64_t compID = 99;
+  pdb::String tcapString =
+      "inputData (in) <= SCAN ('by8_db', 'input_set', 'SetScanner_0', []) \n"
+      "aggWithKeyWithPtr (in, key) <= APPLY (inputData (in), inputData (in), 'AggregationComp_1', 'attAccess_0', [('attName', 'myInt'), ('lambdaType', 'attAccess')]) \n"
+      "aggWithKey (in, key) <= APPLY (aggWithKeyWithPtr (key), aggWithKeyWithPtr (in), 'AggregationComp_1', 'deref_1', [('lambdaType', 'deref')]) \n"
+      "aggWithValue (key, value) <= APPLY (aggWithKey (in), aggWithKey (key), 'AggregationComp_1', 'methodCall_2', [('methodName', 'getValue'), ('lambdaType', 'methodCall')]) \n"
+      "agg (aggOut) <= AGGREGATE (aggWithValue (key, value), 'AggregationComp_1', []) \n"
+      "nothing () <= OUTPUT (agg (aggOut), 'outSet', 'myDB', 'SetWriter_2', [])";
+
+  // make a logger
+  auto logger = make_shared<pdb::PDBLogger>("log.out");
+
+  // the first time the set is partitioned on the aggregation key, the second time on something else
+  std::vector<std::string> keys = { "myInt", "myString" };
+  for(auto &key : keys) {
+
+    // make the mock client
+    auto catalogClient = std::make_shared<MockCatalog>();
+    ON_CALL(*catalogClient,
+            getSet(testing::An<const std::string &>(),
+                   testing::An<const std::string &>(),
+                   testing::An<std::string &>())).WillByDefault(testing::Invoke(
+        [&](const std::string &, const std::string &, std::string &errMsg) {
+          auto set = std::make_shared<pdb::PDBCatalogSet>("by8_db", "input_set", "Nothing", 10, PDB_CATALOG_SET_NO_CONTAINER);
+          set->setPartitioning(PDB_CATALOG_SET_HASH_PARTITIONING, 16, key, "", "");
+          return set;
+        }));
+
+    EXPECT_CALL(*catalogClient, getSet).Times(testing::Exactly(1));
+
+    // init the optimizer
+    pdb::PDBPhysicalOptimizer optimizer(compID, tcapString, catalogClient, logger);
+    EXPECT_TRUE(optimizer.hasAlgorithmToRun());
+
+    // the aggregation is only local if the set is partitioned on the key
+    Handle<pdb::PDBAggregationPipeAlgorithm> aggAlgorithm = unsafeCast<pdb::PDBAggregationPipeAlgorithm>(optimizer.getNextAlgorithm());
+    EXPECT_EQ(aggAlgorithm->local, key == "myInt");
+  }
+}
+
 TEST(TestPhysicalOptimizer, TestJoin3) {
 
   // 1MB for algorithm and stuff
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <PDBPlanCache.h>
+
+namespace pdb {
+
+// makes a small TCAP that scans the given set and writes it out
+static std::string makeTCAP(const std::string &set) {
+  return "inputData(in0) <= SCAN ('myData', '" + set + "', 'SetScanner_0')\n"
+         "inputData_out( ) <= OUTPUT ( inputData ( in0 ), 'outSet', 'myData', 'SetWriter_1')";
+}
+
+TEST(PlanCacheTest, ParsesOnlyOnce) {
+
+  PDBPlanCache cache(4);
+  std::string error;
+
+  // the first time we have to parse it
+  auto first = cache.getParsedTCAP(makeTCAP("mySetA"), error);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(cache.getNumMisses(), 1);
+  EXPECT_EQ(cache.getNumHits(), 0);
+
+  // the second time we get it from the cache
+  auto second = cache.getParsedTCAP(makeTCAP("mySetA"), error);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(cache.getNumMisses(), 1);
+  EXPECT_EQ(cache.getNumHits(), 1);
+  EXPECT_EQ(cache.getNumPlans(), 1);
+
+  // everyone gets their own list
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_EQ(second->getAllScanSets().size(), 1);
+
+  // changing one list does not change the other ones
+  first->removeConsumer("inputData", first->getConsumingAtomicComputations("inputData").front());
+  EXPECT_EQ(first->getConsumingAtomicComputations("inputData").size(), 0);
+  EXPECT_EQ(second->getConsumingAtomicComputations("inputData").size(), 1);
+  EXPECT_EQ(cache.getParsedTCAP(makeTCAP("mySetA"), error)->getConsumingAtomicComputations("inputData").size(), 1);
+}
+
+TEST(PlanCacheTest, EvictsTheLeastRecentlyUsed) {
+
+  PDBPlanCache cache(2);
+  std::string error;
+
+  cache.getParsedTCAP(makeTCAP("mySetA"), error);
+  cache.getParsedTCAP(makeTCAP("mySetB"), error);
+
+  // A was used last so B is the one that goes
+  cache.getParsedTCAP(makeTCAP("mySetA"), error);
+  cache.getParsedTCAP(makeTCAP("mySetC"), error);
+  EXPECT_EQ(cache.getNumPlans(), 2);
+  EXPECT_EQ(cache.getNumMisses(), 3);
+
+  // A is still there
+  cache.getParsedTCAP(makeTCAP("mySetA"), error);
+  EXPECT_EQ(cache.getNumMisses(), 3);
+
+  // B has to be parsed again
+  cache.getParsedTCAP(makeTCAP("mySetB"), error);
+  EXPECT_EQ(cache.getNumMisses(), 4);
+}
+
+TEST(PlanCacheTest, DoesNotCacheErrors) {
+
+  PDBPlanCache cache(2);
+  std::string error;
+  EXPECT_EQ(cache.getParsedTCAP("this is not TCAP", error), nullptr);
+  EXPECT_FALSE(error.empty());
+  EXPECT_EQ(cache.getNumPlans(), 0);
+}
+
+TEST(PlanCacheTest, KeepsThePipes) {
+
+  PDBPlanCache cache(2);
+  std::string error;
+
+  // we don't have the pipes of a TCAP we never saw, and we don't keep them
+  auto pipes = std::make_shared<const PDBCachedPipes>(PDBCachedPipes{ { 0, { "inputData", "inputData_out" } } });
+  cache.setPipes(makeTCAP("mySetA"), pipes);
+  EXPECT_EQ(cache.getPipes(makeTCAP("mySetA")), nullptr);
+
+  // once it is parsed we get the pipes we set
+  ASSERT_NE(cache.getParsedTCAP(makeTCAP("mySetA"), error), nullptr);
+  EXPECT_EQ(cache.getPipes(makeTCAP("mySetA")), nullptr);
+  cache.setPipes(makeTCAP("mySetA"), pipes);
+  EXPECT_EQ(cache.getPipes(makeTCAP("mySetA")), pipes);
+  EXPECT_EQ(cache.getPipes(makeTCAP("mySetB")), nullptr);
+
+  // they go with the TCAP when it is evicted
+  cache.getParsedTCAP(makeTCAP("mySetB"), error);
+  cache.getParsedTCAP(makeTCAP("mySetC"), error);
+  EXPECT_EQ(cache.getPipes(makeTCAP("mySetA")), nullptr);
+}
+
+}
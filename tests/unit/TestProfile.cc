@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <PDBProfile.h>
+#include <UseTemporaryAllocationBlock.h>
+#include <InterfaceFunctions.h>
+
+namespace pdb {
+
+namespace {
+
+// makes the stats of one instance of an operator
+PDBOperatorStats makeStats(uint64_t wallTime, uint64_t numRowsIn, uint64_t numRowsOut) {
+  PDBOperatorStats stats;
+  stats.numInstances = 1;
+  stats.wallTime = wallTime;
+  stats.maxWallTime = wallTime;
+  stats.cpuTime = wallTime / 2;
+  stats.numRowsIn = numRowsIn;
+  stats.numRowsOut = numRowsOut;
+  stats.numBytes = numRowsOut * 8;
+  stats.numPages = 1;
+  return stats;
+}
+
+// returns the paths of the operators in the order they are in the profile
+std::vector<std::vector<std::string>> getPaths(const PDBProfile &profile) {
+  std::vector<std::vector<std::string>> paths;
+  for(const auto &entry : profile.getEntries()) {
+    paths.emplace_back(entry.path);
+  }
+  return paths;
+}
+
+}
+
+TEST(ProfileTest, TreeOrderAndMerge) {
+
+  PDBProfile profile;
+
+  // add the operators out of order, the parents are made on the way
+  profile.add({ "job 0", "pipeline A -> B", "stage 0: Apply B" }, makeStats(100, 10, 10));
+  profile.add({ "job 1", "aggregation merge" }, makeStats(50, 0, 0));
+  profile.add({ "job 0", "pipeline A -> B", "source" }, makeStats(20, 0, 10));
+  profile.add({ "job 0", "page network sender" }, makeStats(30, 0, 0));
+
+  // each operator is followed by its children
+  std::vector<std::vector<std::string>> expected = {
+      { "job 0" },
+      { "job 0", "pipeline A -> B" },
+      { "job 0", "pipeline A -> B", "stage 0: Apply B" },
+      { "job 0", "pipeline A -> B", "source" },
+      { "job 0", "page network sender" },
+      { "job 1" },
+      { "job 1", "aggregation merge" },
+  };
+  EXPECT_EQ(getPaths(profile), expected);
+
+  // adding another instance of an operator sums the stats and keeps the slowest one
+  profile.add({ "job 0", "pipeline A -> B", "stage 0: Apply B" }, makeStats(300, 20, 5));
+
+  PDBOperatorStats stats;
+  ASSERT_TRUE(profile.getStats({ "job 0", "pipeline A -> B", "stage 0: Apply B" }, stats));
+  EXPECT_EQ(stats.numInstances, 2);
+  EXPECT_EQ(stats.wallTime, 400);
+  EXPECT_EQ(stats.maxWallTime, 300);
+  EXPECT_EQ(stats.cpuTime, 200);
+  EXPECT_EQ(stats.numRowsIn, 30);
+  EXPECT_EQ(stats.numRowsOut, 15);
+  EXPECT_EQ(stats.numPages, 2);
+
+  // the parents that were made on the way have no stats
+  ASSERT_TRUE(profile.getStats({ "job 0" }, stats));
+  EXPECT_EQ(stats.numInstances, 0);
+  EXPECT_FALSE(profile.getStats({ "job 2" }, stats));
+
+  // merging a profile under a prefix puts its roots under it
+  PDBProfile computation;
+  computation.merge(profile, { "computation 0" });
+  computation.merge(profile, { "computation 0" });
+  ASSERT_TRUE(computation.getStats({ "computation 0", "job 1", "aggregation merge" }, stats));
+  EXPECT_EQ(stats.numInstances, 2);
+  EXPECT_EQ(stats.wallTime, 100);
+  EXPECT_EQ(computation.getEntries().size(), profile.getEntries().size() + 1);
+}
+
+TEST(ProfileTest, SendOverTheWire) {
+
+  PDBProfile profile;
+  profile.add({ "pipeline A -> C", "source" }, makeStats(20, 0, 100));
+  profile.add({ "pipeline A -> C", "stage 0: Filter B" }, makeStats(40, 100, 50));
+  profile.add({ "pipeline A -> C", "stage 1: Apply C" }, makeStats(60, 50, 50));
+  profile.add({ "pipeline A -> C", "sink" }, makeStats(10, 50, 0));
+  profile.add({ "page self receiver" }, makeStats(5, 0, 0));
+
+  // put it into a vector like the nodes do
+  const UseTemporaryAllocationBlock tempBlock{profile.getVectorSize()};
+  Handle<Vector<Handle<PDBProfileEntry>>> entries = makeObject<Vector<Handle<PDBProfileEntry>>>();
+  profile.toVector(*entries);
+  ASSERT_EQ(entries->size(), 6);
+  EXPECT_EQ((std::string) (*entries)[0]->name, "pipeline A -> C");
+  EXPECT_EQ((*entries)[0]->depth, 0);
+  EXPECT_EQ((std::string) (*entries)[2]->name, "stage 0: Filter B");
+  EXPECT_EQ((*entries)[2]->depth, 1);
+  EXPECT_EQ((*entries)[2]->numRowsIn, 100);
+  EXPECT_EQ((*entries)[5]->depth, 0);
+
+  // the profile we get back from two nodes is the same tree with the stats summed up
+  PDBProfile received;
+  received.merge(*entries, { "job 0" });
+  received.merge(*entries, { "job 0" });
+  std::vector<std::vector<std::string>> expected = {
+      { "job 0" },
+      { "job 0", "pipeline A -> C" },
+      { "job 0", "pipeline A -> C", "source" },
+      { "job 0", "pipeline A -> C", "stage 0: Filter B" },
+      { "job 0", "pipeline A -> C", "stage 1: Apply C" },
+      { "job 0", "pipeline A -> C", "sink" },
+      { "job 0", "page self receiver" },
+  };
+  EXPECT_EQ(getPaths(received), expected);
+
+  PDBOperatorStats stats;
+  ASSERT_TRUE(received.getStats({ "job 0", "pipeline A -> C", "stage 0: Filter B" }, stats));
+  EXPECT_EQ(stats.numInstances, 2);
+  EXPECT_EQ(stats.wallTime, 80);
+  EXPECT_EQ(stats.maxWallTime, 40);
+  EXPECT_EQ(stats.numRowsIn, 200);
+  EXPECT_EQ(stats.numRowsOut, 100);
+  EXPECT_EQ(stats.numBytes, 800);
+}
+
+TEST(ProfileTest, ToString) {
+
+  PDBProfile profile;
+  profile.add({ "job 0" }, makeStats(2000000000, 0, 0));
+  profile.add({ "job 0", "sink" }, makeStats(1500000, 10, 0));
+  profile.add({ "job 0", "sink" }, makeStats(500000, 20, 0));
+
+  // one line per operator indented by the depth, only the stats the operator has
+  auto text = profile.toString();
+  EXPECT_EQ(text, "job 0 : wall 2.00 s, cpu 1.00 s, 1 pages\n"
+                  "  sink : wall 2.00 ms (max 1.50 ms), cpu 1.00 ms, rows 30 -> 0, 2 pages, x2\n");
+
+  // an empty profile has no lines
+  EXPECT_TRUE(PDBProfile().isEmpty());
+  EXPECT_EQ(PDBProfile().toString(), "");
+}
+
+TEST(ProfileTest, ScanStats) {
+
+  // the sources of two pipelines of two jobs scanned some pages
+  PDBOperatorStats source;
+  source.numPages = 2;
+  source.numBytes = 100;
+  source.numPageBytes = 400;
+
+  PDBProfile profile;
+  profile.add({ "job 0", "pipeline A -> B" }, makeStats(10, 1, 1));
+  profile.add({ "job 0", "pipeline A -> B", "source" }, source);
+  profile.add({ "job 1", "pipeline C -> D", "source" }, source);
+
+  // they are summed up and the other operators are ignored
+  auto stats = profile.getScanStats();
+  EXPECT_EQ(stats.numPages, 4);
+  EXPECT_EQ(stats.numBytes, 200);
+  EXPECT_EQ(stats.numPageBytes, 800);
+  EXPECT_EQ(stats.numRowsIn, 0);
+
+  // the bytes on the pages go over the wire too
+  const UseTemporaryAllocationBlock tempBlock{profile.getVectorSize()};
+  Handle<Vector<Handle<PDBProfileEntry>>> entries = makeObject<Vector<Handle<PDBProfileEntry>>>();
+  profile.toVector(*entries);
+
+  PDBProfile received;
+  received.merge(*entries);
+  ASSERT_TRUE(received.getStats({ "job 1", "pipeline C -> D", "source" }, stats));
+  EXPECT_EQ(stats.numPageBytes, 400);
+  EXPECT_NE(received.toString().find("2 pages of 400 B"), std::string::npos);
+}
+
+TEST(ProfileTest, RetriedTuples) {
+
+  // two threads ran the pipeline and had to process some rows again
+  auto pipeline = makeStats(10, 100, 100);
+  pipeline.numRetries = 2;
+  pipeline.numRetriedTuples = 50;
+
+  PDBProfile profile;
+  profile.add({ "pipeline A -> B" }, pipeline);
+  profile.add({ "pipeline A -> B" }, pipeline);
+
+  // they are summed up
+  PDBOperatorStats stats;
+  ASSERT_TRUE(profile.getStats({ "pipeline A -> B" }, stats));
+  EXPECT_EQ(stats.numRetries, 4);
+  EXPECT_EQ(stats.numRetriedTuples, 100);
+
+  // and go over the wire
+  const UseTemporaryAllocationBlock tempBlock{profile.getVectorSize()};
+  Handle<Vector<Handle<PDBProfileEntry>>> entries = makeObject<Vector<Handle<PDBProfileEntry>>>();
+  profile.toVector(*entries);
+
+  PDBProfile received;
+  received.merge(*entries);
+  ASSERT_TRUE(received.getStats({ "pipeline A -> B" }, stats));
+  EXPECT_EQ(stats.numRetriedTuples, 100);
+  EXPECT_NE(received.toString().find("4 retries of 100 rows"), std::string::npos);
+}
+
+TEST(ProfileTest, TupleSetSizes) {
+
+  // one thread started from the default size and had to go down
+  auto first = makeStats(10, 100, 100);
+  first.numChunks = 10;
+  first.numChunkFailures = 2;
+  first.minChunkSize = 50;
+  first.maxChunkSize = 200;
+  first.initialChunkSize = 200;
+  first.finalChunkSize = 50;
+
+  // the other one started from a learned size and kept it
+  auto second = makeStats(10, 100, 100);
+  second.numChunks = 5;
+  second.minChunkSize = 100;
+  second.maxChunkSize = 100;
+  second.initialChunkSize = 100;
+  second.finalChunkSize = 100;
+  second.numLearnedChunkSizes = 1;
+
+  // a thread that got no rows does not change the smallest size
+  auto third = makeStats(10, 0, 0);
+
+  PDBProfile profile;
+  profile.add({ "pipeline A -> B" }, third);
+  profile.add({ "pipeline A -> B" }, first);
+  profile.add({ "pipeline A -> B" }, second);
+
+  PDBOperatorStats stats;
+  ASSERT_TRUE(profile.getStats({ "pipeline A -> B" }, stats));
+  EXPECT_EQ(stats.numChunks, 15);
+  EXPECT_EQ(stats.numChunkFailures, 2);
+  EXPECT_EQ(stats.minChunkSize, 50);
+  EXPECT_EQ(stats.maxChunkSize, 200);
+  EXPECT_EQ(stats.initialChunkSize, 300);
+  EXPECT_EQ(stats.finalChunkSize, 150);
+  EXPECT_EQ(stats.numLearnedChunkSizes, 1);
+
+  // they go over the wire
+  const UseTemporaryAllocationBlock tempBlock{profile.getVectorSize()};
+  Handle<Vector<Handle<PDBProfileEntry>>> entries = makeObject<Vector<Handle<PDBProfileEntry>>>();
+  profile.toVector(*entries);
+
+  PDBProfile received;
+  received.merge(*entries);
+  ASSERT_TRUE(received.getStats({ "pipeline A -> B" }, stats));
+  EXPECT_EQ(stats.numChunks, 15);
+  EXPECT_EQ(stats.minChunkSize, 50);
+  EXPECT_EQ(stats.numLearnedChunkSizes, 1);
+
+  // the initial and the final sizes are averaged over the threads
+  auto text = received.toString();
+  EXPECT_NE(text.find("15 tuple sets of 50 to 200 rows (initial 100, 1 learned, final 50), 2 failed tuple sets"), std::string::npos);
+}
+
+TEST(ProfileTest, Timer) {
+
+  PDBOperatorStats stats;
+  {
+    PDBOperatorTimer timer(stats);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // we slept so there is some wall time but not a lot of cpu time
+  EXPECT_GE(stats.wallTime, 10000000);
+  EXPECT_LT(stats.cpuTime, stats.wallTime);
+}
+
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <set>
+
+#include "Handle.h"
+#include "PDBString.h"
+#include "PDBVector.h"
+#include "InterfaceFunctions.h"
+#include "UseTemporaryAllocationBlock.h"
+
+using namespace pdb;
+
+TEST(SizeClassAllocatorTest, ReuseSmallChunks) {
+
+  // make an allocation block and use the size class policy
+  const UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+  getAllocator().setPolicy(AllocatorPolicy::sizeClassAllocator);
+
+  // allocate a bunch of chunks of different sizes
+  std::vector<void*> chunks;
+  for (size_t i = 0; i < 100; ++i) {
+    chunks.push_back(getAllocator().getRAM(8 + (i % 10) * 4));
+  }
+  auto freeAtTheEnd = getAllocator().getFreeBytesAtTheEnd();
+
+  // free every other one
+  for (size_t i = 0; i < 100; i += 2) {
+    getAllocator().freeRAM(chunks[i]);
+  }
+
+  // allocating the same sizes again must reuse the exact chunks without touching the end of the block
+  std::set<void*> freed;
+  std::set<void*> reused;
+  for (size_t i = 0; i < 100; i += 2) {
+    freed.insert(chunks[i]);
+    chunks[i] = getAllocator().getRAM(8 + (i % 10) * 4);
+    reused.insert(chunks[i]);
+  }
+  EXPECT_EQ(freed, reused);
+  EXPECT_EQ(getAllocator().getFreeBytesAtTheEnd(), freeAtTheEnd);
+  EXPECT_EQ(getAllocator().getNumObjectsInCurrentAllocatorBlock(), 100);
+
+  // free everything
+  for (size_t i = 0; i < 100; ++i) {
+    getAllocator().freeRAM(chunks[i]);
+  }
+  EXPECT_EQ(getAllocator().getNumObjectsInCurrentAllocatorBlock(), 0);
+
+  getAllocator().setPolicy(AllocatorPolicy::defaultAllocator);
+}
+
+TEST(SizeClassAllocatorTest, CoalesceLargeChunks) {
+
+  // make an allocation block and use the size class policy
+  const UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+  getAllocator().setPolicy(AllocatorPolicy::sizeClassAllocator);
+
+  auto initialFree = getAllocator().getFreeBytesAtTheEnd();
+
+  // allocate three large chunks and a small one after them so they are not at the end
+  void* a = getAllocator().getRAM(1000);
+  void* b = getAllocator().getRAM(1000);
+  void* c = getAllocator().getRAM(1000);
+  void* small = getAllocator().getRAM(16);
+  auto freeAtTheEnd = getAllocator().getFreeBytesAtTheEnd();
+
+  // free them out of order, they should be merged into one chunk
+  getAllocator().freeRAM(a);
+  getAllocator().freeRAM(c);
+  getAllocator().freeRAM(b);
+
+  // a chunk larger than any single one of them has to fit into the merged chunk
+  void* large = getAllocator().getRAM(2900);
+  EXPECT_EQ(large, a);
+  EXPECT_EQ(getAllocator().getFreeBytesAtTheEnd(), freeAtTheEnd);
+
+  // freeing everything gives the memory back to the end of the block
+  getAllocator().freeRAM(large);
+  getAllocator().freeRAM(small);
+  EXPECT_EQ(getAllocator().getFreeBytesAtTheEnd(), initialFree);
+  EXPECT_EQ(getAllocator().getNumObjectsInCurrentAllocatorBlock(), 0);
+
+  getAllocator().setPolicy(AllocatorPolicy::defaultAllocator);
+}
+
+TEST(SizeClassAllocatorTest, CoalesceSmallChunks) {
+
+  // make a small allocation block and use the size class policy
+  const UseTemporaryAllocationBlock tempBlock{64 * 1024};
+  getAllocator().setPolicy(AllocatorPolicy::sizeClassAllocator);
+
+  // allocate a bunch of small chunks next to each other and a small one after them so they are not at the end
+  std::vector<void*> chunks;
+  for (size_t i = 0; i < 40; ++i) {
+    chunks.push_back(getAllocator().getRAM(96));
+  }
+  void* small = getAllocator().getRAM(16);
+
+  // use up the end of the block
+  void* fill = getAllocator().getRAM(getAllocator().getFreeBytesAtTheEnd() - 64);
+
+  // free the small chunks, they only go to their free lists
+  for (auto chunk : chunks) {
+    getAllocator().freeRAM(chunk);
+  }
+
+  // a chunk larger than any of them only fits if they are merged
+  void* large = getAllocator().getRAM(2000);
+  EXPECT_EQ(large, chunks.front());
+
+  getAllocator().freeRAM(large);
+  getAllocator().freeRAM(fill);
+  getAllocator().freeRAM(small);
+  EXPECT_EQ(getAllocator().getNumObjectsInCurrentAllocatorBlock(), 0);
+
+  getAllocator().setPolicy(AllocatorPolicy::defaultAllocator);
+}
+
+TEST(SizeClassAllocatorTest, PolicySwitchForgetsFreeChunks) {
+
+  // make an allocation block and use the size class policy
+  const UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+  getAllocator().setPolicy(AllocatorPolicy::sizeClassAllocator);
+
+  // free a chunk that is not at the end
+  void* a = getAllocator().getRAM(1000);
+  void* small = getAllocator().getRAM(16);
+  getAllocator().freeRAM(a);
+
+  // switching the policy back and forth must forget it, the other policy does not know about it
+  getAllocator().setPolicy(AllocatorPolicy::defaultAllocator);
+  getAllocator().setPolicy(AllocatorPolicy::sizeClassAllocator);
+  void* b = getAllocator().getRAM(1000);
+  EXPECT_NE(a, b);
+
+  getAllocator().freeRAM(b);
+  getAllocator().freeRAM(small);
+
+  getAllocator().setPolicy(AllocatorPolicy::defaultAllocator);
+}
+
+TEST(SizeClassAllocatorTest, ObjectChurn) {
+
+  // make an allocation block and use the size class policy
+  const UseTemporaryAllocationBlock tempBlock{1024 * 1024};
+  getAllocator().setPolicy(AllocatorPolicy::sizeClassAllocator);
+
+  Handle<Vector<Handle<String>>> strings = makeObject<Vector<Handle<String>>>(100);
+  auto freeAtTheEnd = getAllocator().getFreeBytesAtTheEnd();
+
+  // keep replacing the strings, this should not use any more memory since the freed chunks are reused
+  for (int round = 0; round < 100; ++round) {
+
+    strings->clear();
+    for (int i = 0; i < 100; ++i) {
+      strings->push_back(makeObject<String>("string number " + std::to_string(i % 10)));
+    }
+
+    // check the values
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_EQ(std::string((*strings)[i]->c_str()), "string number " + std::to_string(i % 10));
+    }
+
+    // after a few rounds everything should come from the freed chunks
+    if (round == 10) {
+      freeAtTheEnd = getAllocator().getFreeBytesAtTheEnd();
+    }
+  }
+  EXPECT_EQ(getAllocator().getFreeBytesAtTheEnd(), freeAtTheEnd);
+
+  strings = nullptr;
+  getAllocator().setPolicy(AllocatorPolicy::defaultAllocator);
+}
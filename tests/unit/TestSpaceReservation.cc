@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "Handle.h"
+#include "PDBMap.h"
+#include "InterfaceFunctions.h"
+#include "UseTemporaryAllocationBlock.h"
+
+using namespace pdb;
+
+TEST(SpaceReservationTest, FitsInCurrentBlock) {
+
+  // make a small allocation block
+  const UseTemporaryAllocationBlock tempBlock{1024};
+
+  // something small fits but not more than the block
+  EXPECT_TRUE(fitsInCurrentAllocatorBlock(128));
+  EXPECT_FALSE(fitsInCurrentAllocatorBlock(2048));
+
+  // fill up the block until the 128 bytes do not fit anymore
+  std::vector<Handle<Map<int, int>>> maps;
+  while (fitsInCurrentAllocatorBlock(128)) {
+
+    // this must not throw since it fits
+    EXPECT_NO_THROW(maps.push_back(makeObject<Map<int, int>>(2)));
+  }
+}
+
+TEST(SpaceReservationTest, MapInsertEstimate) {
+
+  // make an allocation block
+  const UseTemporaryAllocationBlock tempBlock{1024 * 1024 * 24};
+
+  // make the map
+  Handle<Map<int, int>> myMap = makeObject<Map<int, int>>();
+
+  int key = 0;
+  for (uint32_t numToInsert : {1, 10, 100, 1000, 10000, 100000}) {
+
+    // get the estimate and the free space before the insert
+    auto estimate = myMap->getArray()->bytesNeededToInsert(numToInsert);
+    auto freeBefore = getAllocator().getFreeBytesAtTheEnd();
+
+    // insert the new keys
+    for (uint32_t i = 0; i < numToInsert; ++i, ++key) {
+      (*myMap)[key] = key;
+    }
+
+    // the estimate is an upper bound on what we used
+    EXPECT_LE(freeBefore - getAllocator().getFreeBytesAtTheEnd(), estimate);
+  }
+
+  // inserting nothing needs nothing
+  EXPECT_EQ(myMap->getArray()->bytesNeededToInsert(0), 0);
+}
+
+TEST(SpaceReservationTest, MapReserve) {
+
+  // make an allocation block
+  const UseTemporaryAllocationBlock tempBlock{1024 * 1024 * 24};
+
+  // make the map
+  Handle<Map<int, int>> myMap = makeObject<Map<int, int>>();
+
+  int key = 0;
+  for (uint32_t numToInsert : {1, 10, 100, 1000, 10000, 100000}) {
+
+    // reserving allocates exactly what we estimated
+    auto estimate = myMap->getArray()->bytesNeededToGrowToFit(myMap->size() + numToInsert);
+    auto freeBefore = getAllocator().getFreeBytesAtTheEnd();
+    myMap->reserve(myMap->size() + numToInsert);
+    EXPECT_EQ(freeBefore - getAllocator().getFreeBytesAtTheEnd(), estimate);
+
+    // inserting the keys does not allocate anything after that
+    freeBefore = getAllocator().getFreeBytesAtTheEnd();
+    for (uint32_t i = 0; i < numToInsert; ++i, ++key) {
+      (*myMap)[key] = key;
+    }
+    EXPECT_EQ(freeBefore, getAllocator().getFreeBytesAtTheEnd());
+  }
+
+  // all the keys are still there
+  for (int i = 0; i < key; ++i) {
+    EXPECT_EQ((*myMap)[i], i);
+  }
+
+  // if it already fits nothing happens
+  EXPECT_EQ(myMap->getArray()->bytesNeededToGrowToFit(myMap->size()), 0);
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <cstring>
+#include <PDBCodec.h>
+#include <PDBStoragePageFetcher.h>
+
+namespace pdb {
+
+namespace {
+
+const size_t pageSize = 1024;
+
+// the page of a worker, the first bytes are the index of the page in the set
+std::vector<char> makeFrame(uint64_t index, const PDBCodecPtr &codec) {
+
+  std::vector<char> page(pageSize, (char) index);
+  memcpy(page.data(), &index, sizeof(index));
+
+  std::vector<char> frame(codec->getMaxFrameSize(page.size()));
+  frame.resize(codec->compressFrame(page.data(), page.size(), frame.data(), frame.size()));
+  return frame;
+}
+
+}
+
+/**
+ * A fetcher that gets the pages from workers that are kept in memory, the workers take a while for every page so the
+ * pages are fetched out of order
+ */
+class MockPageFetcher : public PDBStoragePageFetcher {
+ public:
+
+  // how a worker fails
+  enum FailureMode { NO_FAILURE, THROWS, CORRUPTS };
+
+  MockPageFetcher() : PDBStoragePageFetcher("localhost", 8108, 1, "set", "db") {
+
+    // we use the last codec we were built with
+    std::string error;
+    auto codec = PDBCodec::get(PDBCodec::getAvailable().back(), error);
+
+    // the set has ten pages on each of three workers, the manager hands them out in a random order
+    for(uint64_t page = 0; page < 10; ++page) {
+      for(int32_t worker = 0; worker < 3; ++worker) {
+        placement.push_back(PageLocation{ "worker" + std::to_string(worker), 8109 + worker, page });
+      }
+    }
+    std::shuffle(placement.begin(), placement.end(), std::mt19937(42));
+
+    // make the pages, their index is where they are in the placement
+    for(uint64_t i = 0; i < placement.size(); ++i) {
+      frames[std::make_pair(placement[i].address, placement[i].page)] = makeFrame(i, codec);
+    }
+    numFetches = std::vector<std::atomic<int>>(placement.size());
+  }
+
+  ~MockPageFetcher() override {
+    stopFetching();
+  }
+
+  // the pages in the order the manager hands them out
+  std::vector<PageLocation> placement;
+
+  // the frames of the pages on each worker
+  std::map<std::pair<std::string, uint64_t>, std::vector<char>> frames;
+
+  // the worker that fails and how
+  std::string failingWorker;
+  FailureMode failureMode = NO_FAILURE;
+
+  // how many times each page was fetched
+  std::vector<std::atomic<int>> numFetches;
+
+  // how many pages the iterator got, set by the test
+  std::atomic<size_t> numReceived{0};
+
+  // true if a page was fetched further ahead than the window allows
+  std::atomic<bool> outsideWindow{false};
+
+  // how many pages were fetched at the same time
+  std::atomic<int> numInFlight{0};
+  std::atomic<int> maxInFlight{0};
+
+ protected:
+
+  void getPlacement() override {
+    locations = placement;
+  }
+
+  std::unique_ptr<char[]> fetchFrame(const PageLocation &location, size_t &frameSize) override {
+
+    // the pages are fetched from the locations in place
+    auto index = (size_t) (&location - locations.data());
+    numFetches[index]++;
+
+    // the iterator might have moved to the next page before the test counted the last one
+    auto window = 2 * std::min(3 * threadsPerWorker, maxFetchingThreads);
+    if(index >= numReceived + 1 + window) {
+      outsideWindow = true;
+    }
+
+    // the worker takes a while
+    auto inFlight = ++numInFlight;
+    for(auto max = maxInFlight.load(); inFlight > max && !maxInFlight.compare_exchange_weak(max, inFlight);) {}
+    std::this_thread::sleep_for(std::chrono::microseconds((index * 7919) % 1000));
+    numInFlight--;
+
+    // does the worker fail
+    if(location.address == failingWorker && failureMode == THROWS) {
+      throw std::runtime_error("The worker failed");
+    }
+
+    // does the worker still have the page
+    auto it = frames.find(std::make_pair(location.address, location.page));
+    if(it == frames.end()) {
+      return nullptr;
+    }
+
+    // copy the frame, a corrupted one has a broken header
+    frameSize = it->second.size();
+    std::unique_ptr<char[]> frame(new char[frameSize]);
+    memcpy(frame.get(), it->second.data(), frameSize);
+    if(location.address == failingWorker && failureMode == CORRUPTS) {
+      memset(frame.get(), 0, std::min<size_t>(frameSize, 8));
+    }
+    return frame;
+  }
+};
+
+TEST(StoragePageFetcherTest, EveryPageOnceInOrder) {
+
+  MockPageFetcher fetcher;
+
+  // one of the workers does not have a page anymore, it is skipped
+  auto missing = fetcher.placement[5];
+  fetcher.frames.erase(std::make_pair(missing.address, missing.page));
+
+  // grab all the pages
+  std::vector<uint64_t> received;
+  for(auto page = fetcher.getNextPage(); page != nullptr; page = fetcher.getNextPage()) {
+
+    uint64_t index;
+    memcpy(&index, page.get(), sizeof(index));
+    EXPECT_EQ(page[pageSize - 1], (char) index);
+
+    received.emplace_back(index);
+    fetcher.numReceived++;
+  }
+
+  // they come in the order the manager gave us
+  std::vector<uint64_t> expected;
+  for(uint64_t i = 0; i < fetcher.placement.size(); ++i) {
+    if(i != 5) {
+      expected.emplace_back(i);
+    }
+  }
+  EXPECT_EQ(received, expected);
+
+  // every page was fetched once, in parallel and never too far ahead
+  for(auto &numFetches : fetcher.numFetches) {
+    EXPECT_EQ(numFetches, 1);
+  }
+  EXPECT_GT(fetcher.maxInFlight, 1);
+  EXPECT_FALSE(fetcher.outsideWindow);
+}
+
+TEST(StoragePageFetcherTest, WorkerError) {
+
+  for(auto mode : { MockPageFetcher::THROWS, MockPageFetcher::CORRUPTS }) {
+
+    MockPageFetcher fetcher;
+    fetcher.failingWorker = "worker1";
+    fetcher.failureMode = mode;
+
+    // the pages before the first one of the failing worker arrive in order
+    size_t firstFailing = 0;
+    while(fetcher.placement[firstFailing].address != fetcher.failingWorker) {
+      firstFailing++;
+    }
+
+    for(uint64_t i = 0; i < firstFailing; ++i) {
+
+      auto page = fetcher.getNextPage();
+      ASSERT_NE(page, nullptr);
+
+      uint64_t index;
+      memcpy(&index, page.get(), sizeof(index));
+      EXPECT_EQ(index, i);
+      fetcher.numReceived++;
+    }
+
+    // then the error of the worker is thrown
+    EXPECT_THROW(fetcher.getNextPage(), std::runtime_error);
+
+    // no page was fetched twice
+    for(auto &numFetches : fetcher.numFetches) {
+      EXPECT_LE(numFetches, 1);
+    }
+    EXPECT_FALSE(fetcher.outsideWindow);
+  }
+}
+
+}
@@ -0,0 +1,86 @@
+#include <unistd.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <PDBStreamingPageSet.h>
+
+#include "PDBBufferManagerImpl.h"
+#include "PDBPageHandle.h"
+
+namespace pdb {
+
+TEST(StreamingPageSetTest, EveryPageIsReadOnce) {
+
+  const uint64_t numFeeders = 4;
+  const uint64_t numReaders = 4;
+  const uint64_t pagesPerFeeder = 500;
+
+  // create the buffer manager
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", 64, 30, "metadata", ".");
+
+  // the streaming page set
+  auto streamingPageSet = std::make_shared<PDBStreamingPageSet>();
+
+  // the readers start before there is anything to read
+  std::atomic<uint64_t> sum;
+  std::atomic<uint64_t> count;
+  sum = 0;
+  count = 0;
+  std::vector<std::thread> readers;
+  for(uint64_t i = 0; i < numReaders; ++i) {
+    readers.emplace_back([&, i]() {
+
+      PDBPageHandle page;
+      while((page = streamingPageSet->getNextPage(i)) != nullptr) {
+        page->repin();
+        sum += *((uint64_t*) page->getBytes());
+        count++;
+      }
+    });
+  }
+
+  std::vector<std::thread> feeders;
+  for(uint64_t i = 0; i < numFeeders; ++i) {
+    feeders.emplace_back([&, i]() {
+
+      for(uint64_t p = 0; p < pagesPerFeeder; p++) {
+
+        // just so we get more concurency with the readers
+        usleep(50);
+
+        // get the page write something to it
+        auto page = myMgr.getPage();
+        *((uint64_t*) page->getBytes()) = i * pagesPerFeeder + p;
+        page->unpin();
+
+        // feed it into the page set
+        streamingPageSet->feedPage(page);
+      }
+    });
+  }
+
+  // the producer is done once all the feeders are
+  for(auto &feeder : feeders) {
+    feeder.join();
+  }
+  streamingPageSet->finishFeeding();
+
+  for(auto &reader : readers) {
+    reader.join();
+  }
+
+  // every page was read by exactly one reader
+  const uint64_t numPages = numFeeders * pagesPerFeeder;
+  EXPECT_EQ(count, numPages);
+  EXPECT_EQ(sum, numPages * (numPages - 1) / 2);
+  EXPECT_EQ(streamingPageSet->getNumPages(), numPages);
+
+  // we can not feed after we are done, finishing again does nothing
+  EXPECT_THROW(streamingPageSet->feedPage(myMgr.getPage()), std::runtime_error);
+  streamingPageSet->finishFeeding();
+  EXPECT_EQ(streamingPageSet->getNextPage(0), nullptr);
+}
+
+}
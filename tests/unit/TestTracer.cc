@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <atomic>
+#include <thread>
+#include <PDBTracer.h>
+#include <PDBChromeTrace.h>
+#include <PDBTrace.h>
+#include <UseTemporaryAllocationBlock.h>
+#include <InterfaceFunctions.h>
+
+namespace pdb {
+
+TEST(TracerTest, CollectFromThreads) {
+
+  // only the events after this are ours
+  auto since = PDBTracer::now();
+
+  // every thread records a few events
+  const int numThreads = 4;
+  const int numEvents = 100;
+  std::vector<std::thread> threads;
+  for(int t = 0; t < numThreads; ++t) {
+    threads.emplace_back([t]() {
+      for(int i = 0; i < numEvents; ++i) {
+        PDBTraceScope scope("work", t * numEvents + i);
+      }
+    });
+  }
+  for(auto &thread : threads) {
+    thread.join();
+  }
+
+  // grab them
+  auto events = PDBTracer::collect(since);
+  EXPECT_EQ(events.size(), numThreads * numEvents);
+
+  // they have to be ordered and each thread has its own id
+  std::set<uint32_t> threadIDs;
+  std::set<uint64_t> args;
+  for(size_t i = 0; i < events.size(); ++i) {
+    EXPECT_STREQ(events[i].name, "work");
+    EXPECT_LE(events[i].begin, events[i].end);
+    if(i != 0) {
+      EXPECT_LE(events[i - 1].begin, events[i].begin);
+    }
+    threadIDs.insert(events[i].threadID);
+    args.insert(events[i].arg);
+  }
+  EXPECT_EQ(threadIDs.size(), numThreads);
+  EXPECT_EQ(args.size(), numThreads * numEvents);
+
+  // nothing happened after this
+  EXPECT_TRUE(PDBTracer::collect(PDBTracer::now()).empty());
+}
+
+TEST(TracerTest, RingBufferKeepsTheLastEvents) {
+
+  auto since = PDBTracer::now();
+
+  // record more than the buffer can hold
+  std::thread thread([]() {
+    for(uint64_t i = 0; i < PDBTracer::BUFFER_SIZE + 10; ++i) {
+      auto now = PDBTracer::now();
+      PDBTracer::record("overflow", now, now, i);
+    }
+  });
+  thread.join();
+
+  // only the last ones are there
+  auto events = PDBTracer::collect(since);
+  EXPECT_EQ(events.size(), PDBTracer::BUFFER_SIZE);
+  EXPECT_EQ(events.front().arg, 10);
+  EXPECT_EQ(events.back().arg, PDBTracer::BUFFER_SIZE + 9);
+}
+
+TEST(TracerTest, EventsAreTaggedWithTheJob) {
+
+  auto since = PDBTracer::now();
+
+  // two jobs of a computation and one of another one run at the same time, the threads they give work to run it too
+  std::vector<std::thread> threads;
+  for(uint64_t job = 0; job < 3; ++job) {
+    threads.emplace_back([job]() {
+      const PDBTraceJobScope traceScope{job == 2 ? 8 : 7, job};
+      PDBTraceScope scope("job work", job);
+    });
+  }
+  for(auto &thread : threads) {
+    thread.join();
+  }
+
+  // an event that is not part of any job
+  {
+    PDBTraceScope scope("no job");
+  }
+
+  // a job only gets its own events and the ones without a job
+  auto events = PDBTracer::collect(since, 7, 1);
+  ASSERT_EQ(events.size(), 2);
+  for(auto &event : events) {
+    if(event.jobID == PDB_NO_TRACE_JOB) {
+      EXPECT_STREQ(event.name, "no job");
+    } else {
+      EXPECT_EQ(event.computationID, 7);
+      EXPECT_EQ(event.jobID, 1);
+      EXPECT_EQ(event.arg, 1);
+    }
+  }
+
+  // a computation gets the events of all its jobs
+  EXPECT_EQ(PDBTracer::collect(since, 7).size(), 3);
+  EXPECT_EQ(PDBTracer::collect(since).size(), 4);
+
+  // the scope puts back the job the thread had
+  EXPECT_EQ(PDBTracer::getJob(), PDB_NO_TRACE_JOB);
+}
+
+TEST(TracerTest, CollectWhileRecording) {
+
+  auto since = PDBTracer::now();
+
+  // a thread keeps overwriting its ring buffer while we collect, the events we get have to be whole
+  std::atomic<bool> done{false};
+  std::thread thread([&done]() {
+    for(uint64_t i = 0; !done; ++i) {
+      PDBTracer::record("recording", i, i + 1, i);
+    }
+  });
+
+  for(int i = 0; i < 20; ++i) {
+    for(auto &event : PDBTracer::collect(0)) {
+      if(std::string(event.name) == "recording") {
+        EXPECT_EQ(event.end, event.begin + 1);
+        EXPECT_EQ(event.arg, event.begin);
+      }
+    }
+  }
+  done = true;
+  thread.join();
+
+  // the events are not after since, so none of them are ours
+  EXPECT_TRUE(PDBTracer::collect(since).empty());
+}
+
+TEST(TracerTest, ChromeTrace) {
+
+  // make some events
+  std::vector<PDBTraceEvent> events(3);
+  events[0].name = "pipeline iteration";
+  events[0].begin = 1000;
+  events[0].end = 3000;
+  events[0].arg = 7;
+  events[1].name = "heap request";
+  events[1].begin = 2000;
+  events[1].end = 2500;
+  events[1].threadID = 1;
+  events[2].name = "pipeline iteration";
+  events[2].begin = 4000;
+  events[2].end = 4100;
+  events[2].computationID = 1;
+  events[2].jobID = 3;
+
+  // put them into a trace like the execution server does
+  const UseTemporaryAllocationBlock tempBlock{PDBTracer::getTraceSize(events)};
+  Handle<PDBTrace> trace = makeObject<PDBTrace>("backend");
+  PDBTracer::toTrace(events, *trace);
+
+  // the names are not repeated
+  EXPECT_EQ(trace->names.size(), 2);
+  EXPECT_EQ(trace->events.size(), 18);
+
+  // merge it with the events of another process
+  PDBChromeTrace chromeTrace;
+  EXPECT_TRUE(chromeTrace.isEmpty());
+  chromeTrace.addTrace("localhost:8109", *trace);
+  chromeTrace.addEvents("manager", std::vector<PDBTraceEvent>{events[2]});
+  EXPECT_FALSE(chromeTrace.isEmpty());
+
+  // check the json
+  auto json = chromeTrace.toJSON();
+  EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(json.find(R"("args":{"name":"localhost:8109 backend"})"), std::string::npos);
+  EXPECT_NE(json.find(R"("args":{"name":"manager"})"), std::string::npos);
+  EXPECT_NE(json.find(R"("name":"heap request","ph":"X")"), std::string::npos);
+  EXPECT_NE(json.find(R"("dur":2.0,"args":{"arg":7})"), std::string::npos);
+  EXPECT_NE(json.find(R"("dur":0.5,"args":{"arg":0})"), std::string::npos);
+  EXPECT_NE(json.find(R"("dur":0.1,"args":{"arg":0,"job":3})"), std::string::npos);
+
+  // every event is there
+  size_t numEvents = 0;
+  for(auto pos = json.find("\"ph\":\"X\""); pos != std::string::npos; pos = json.find("\"ph\":\"X\"", pos + 1)) {
+    numEvents++;
+  }
+  EXPECT_EQ(numEvents, 4);
+}
+
+}
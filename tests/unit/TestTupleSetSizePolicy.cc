@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <pipeline/PDBTupleSetSizePolicy.h>
+
+namespace pdb {
+
+// simulates running a pipeline where each stage needs bytesPerRow[stage] bytes per row and the sink sinkBytesPerRow
+void simulate(PDBTupleSetSizePolicy &policy, uint64_t pageSize, const std::vector<uint64_t> &bytesPerRow, uint64_t sinkBytesPerRow, int numChunks) {
+
+  for(int i = 0; i < numChunks; ++i) {
+
+    uint64_t numRows = policy.getChunksSize();
+    uint64_t free = pageSize;
+
+    // run the stages, if something does not fit the pipeline fails
+    bool failed = false;
+    for(size_t stage = 0; stage < bytesPerRow.size(); ++stage) {
+
+      if(bytesPerRow[stage] * numRows > free) {
+        failed = true;
+        break;
+      }
+
+      policy.stageSucceeded(stage, numRows, free, free - bytesPerRow[stage] * numRows);
+      free -= bytesPerRow[stage] * numRows;
+    }
+
+    if(failed) {
+      policy.pipelineFailed();
+      continue;
+    }
+
+    policy.pipelineSucceeded(numRows, 0, pageSize, free);
+    policy.writeToPageSucceeded(0, pageSize, pageSize - sinkBytesPerRow * numRows);
+  }
+}
+
+TEST(TupleSetSizePolicyTest, TestFitsPage) {
+
+  PDBTupleSetSizePolicy::forgetLearnedModels();
+
+  const uint64_t pageSize = 16 * 1024;
+
+  // the pipeline needs 100 + 200 + 50 bytes per row so the largest chunk that fits 80% of the page is 37
+  PDBTupleSetSizePolicy policy(pageSize);
+  simulate(policy, pageSize, {100, 200}, 50, 10);
+
+  EXPECT_EQ(policy.getChunksSize(), (int32_t) ((pageSize * 0.8) / 350));
+  EXPECT_EQ(policy.getStats().numFailures, 0);
+  EXPECT_EQ(policy.getStats().numChunks, 10);
+  EXPECT_FALSE(policy.getStats().usedLearnedModel);
+}
+
+TEST(TupleSetSizePolicyTest, TestFailures) {
+
+  PDBTupleSetSizePolicy::forgetLearnedModels();
+
+  // a small page where the default chunk size does not fit
+  const uint64_t pageSize = 1024;
+
+  PDBTupleSetSizePolicy policy(pageSize);
+  simulate(policy, pageSize, {100}, 0, 10);
+
+  // we must have failed and ended up with a size that fits
+  EXPECT_GT(policy.getStats().numFailures, 0);
+  EXPECT_LE(policy.getChunksSize() * 100, pageSize);
+  EXPECT_TRUE(policy.inputWasProcessed());
+
+  // we can not go below one row
+  PDBTupleSetSizePolicy tooLarge(pageSize);
+  EXPECT_THROW(simulate(tooLarge, pageSize, {2 * pageSize}, 0, 100), std::runtime_error);
+}
+
+TEST(TupleSetSizePolicyTest, TestLearnedModel) {
+
+  PDBTupleSetSizePolicy::forgetLearnedModels();
+
+  const uint64_t pageSize = 64 * 1024;
+
+  // learn the model for the signature
+  int32_t learnedSize;
+  {
+    PDBTupleSetSizePolicy policy(pageSize, "signature");
+    simulate(policy, pageSize, {400, 600}, 24, 10);
+    learnedSize = policy.getChunksSize();
+    policy.saveModel();
+  }
+
+  // the same signature starts at the learned size
+  PDBTupleSetSizePolicy same(pageSize, "signature");
+  EXPECT_TRUE(same.getStats().usedLearnedModel);
+  EXPECT_EQ(same.getChunksSize(), learnedSize);
+  EXPECT_EQ(same.getStats().initialChunkSize, learnedSize);
+
+  // a different signature starts from scratch
+  PDBTupleSetSizePolicy other(pageSize, "other");
+  EXPECT_FALSE(other.getStats().usedLearnedModel);
+}
+
+TEST(TupleSetSizePolicyTest, TestLearnedModelsAreBounded) {
+
+  PDBTupleSetSizePolicy::forgetLearnedModels();
+
+  const uint64_t pageSize = 64 * 1024;
+  const size_t maxModels = PDBTupleSetSizePolicy::maxLearnedModels;
+
+  // learn more models than we are allowed to keep
+  for(size_t i = 0; i < maxModels + 10; ++i) {
+
+    PDBTupleSetSizePolicy policy(pageSize, "signature" + std::to_string(i));
+    simulate(policy, pageSize, {400}, 0, 5);
+    policy.saveModel();
+
+    // touch the first signature so that it stays the most recently used one
+    PDBTupleSetSizePolicy first(pageSize, "signature0");
+  }
+
+  // we must not go over the limit
+  EXPECT_EQ(PDBTupleSetSizePolicy::numLearnedModels(), maxModels);
+
+  // the recently used model is kept, the least recently used one is evicted
+  EXPECT_TRUE(PDBTupleSetSizePolicy(pageSize, "signature0").getStats().usedLearnedModel);
+  EXPECT_FALSE(PDBTupleSetSizePolicy(pageSize, "signature1").getStats().usedLearnedModel);
+  EXPECT_TRUE(PDBTupleSetSizePolicy(pageSize, "signature" + std::to_string(maxModels + 9)).getStats().usedLearnedModel);
+}
+
+}